@@ -26,10 +26,9 @@ layout(std140, binding = 1) uniform MaterialConstants
     uint    Padding[3];
 };
 
+// Only the streams every mesh has, the outline is drawn over any material permutation
 layout(location=0) in vec3 Position;
-layout(location=1) in vec4 Tangent;
 layout(location=2) in vec3 Normal;
-layout(location=3) in vec2 TexCoord0;
 
 precision highp float;
 
@@ -0,0 +1,21 @@
+// Keep in sync with MaterialFeatures in Renderer.h
+const uint MaterialFeatures_ColorTexture     = 1 << 0;
+const uint MaterialFeatures_NormalTexture    = 1 << 1;
+const uint MaterialFeatures_RoughnessTexture = 1 << 2;
+const uint MaterialFeatures_OcclusionTexture = 1 << 3;
+const uint MaterialFeatures_EmissiveTexture =  1 << 4;
+const uint MaterialFeatures_TangentVertexAttribute = 1 << 5;
+const uint MaterialFeatures_TexcoordVertexAttribute = 1 << 6;
+
+// Variants are compiled with MATERIAL_PERMUTATION set to the feature bits of the material,
+// the feature checks then fold to constants and the dead branches are stripped.
+// Without it the flags of the material constants are tested at runtime.
+#ifdef MATERIAL_PERMUTATION
+#define HAS_MATERIAL_FEATURE(feature) ((uint(MATERIAL_PERMUTATION) & (feature)) != 0)
+#define HAS_TANGENT_ATTRIBUTE ((MATERIAL_PERMUTATION & (1 << 5)) != 0)
+#define HAS_TEXCOORD_ATTRIBUTE ((MATERIAL_PERMUTATION & (1 << 6)) != 0)
+#else
+#define HAS_MATERIAL_FEATURE(feature) ((Flags & (feature)) != 0)
+#define HAS_TANGENT_ATTRIBUTE 1
+#define HAS_TEXCOORD_ATTRIBUTE 1
+#endif
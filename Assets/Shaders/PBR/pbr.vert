@@ -1,12 +1,8 @@
 #version 450
 
-uint MaterialFeatures_ColorTexture     = 1 << 0;
-uint MaterialFeatures_NormalTexture    = 1 << 1;
-uint MaterialFeatures_RoughnessTexture = 1 << 2;
-uint MaterialFeatures_OcclusionTexture = 1 << 3;
-uint MaterialFeatures_EmissiveTexture =  1 << 4;
-uint MaterialFeatures_TangentVertexAttribute = 1 << 5;
-uint MaterialFeatures_TexcoordVertexAttribute = 1 << 6;
+#extension GL_GOOGLE_include_directive : enable
+
+#include "material_features.glsl"
 
 layout(std140, binding = 0) uniform LocalConstants
 {
@@ -48,9 +44,13 @@ layout(std140, binding = 1) uniform MaterialConstants
 };
 
 layout(location=0) in vec3 Position;
+#if HAS_TANGENT_ATTRIBUTE
 layout(location=1) in vec4 Tangent;
+#endif
 layout(location=2) in vec3 Normal;
+#if HAS_TEXCOORD_ATTRIBUTE
 layout(location=3) in vec2 TexCoord0;
+#endif
 
 layout (location = 0) out vec2 vTexcoord0;
 layout (location = 1) out vec3 vNormal;
@@ -61,12 +61,16 @@ void main() {
     vPosition = vec3(Matrix * ModelMatrix * vec4(Position, 1.0));
     gl_Position = ViewProjection * vec4(vPosition, 1.0);
 
-    if ( ( Flags & MaterialFeatures_TexcoordVertexAttribute ) != 0 ) {
+#if HAS_TEXCOORD_ATTRIBUTE
+    if ( HAS_MATERIAL_FEATURE( MaterialFeatures_TexcoordVertexAttribute ) ) {
         vTexcoord0 = TexCoord0;
     }
+#endif
     vNormal = (ModelInverse * vec4(Normal, 0.0)).xyz;
 
-    if ( ( Flags & MaterialFeatures_TangentVertexAttribute ) != 0 ) {
+#if HAS_TANGENT_ATTRIBUTE
+    if ( HAS_MATERIAL_FEATURE( MaterialFeatures_TangentVertexAttribute ) ) {
         vTangent = vec4(mat3(ModelMatrix) * Tangent.xyz, Tangent.w);
     }
+#endif
 }
\ No newline at end of file
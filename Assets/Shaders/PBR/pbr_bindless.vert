@@ -0,0 +1,76 @@
+#version 450
+
+#extension GL_GOOGLE_include_directive : enable
+
+#include "material_features.glsl"
+
+layout(std140, binding = 0) uniform LocalConstants
+{
+	mat4 Matrix;
+	mat4 ViewProjection;
+	vec4 Eye;
+	vec4 Light;
+};
+
+// Keep in sync with FMaterialData in Renderer.h
+layout(std140, binding = 1) uniform MaterialConstants
+{
+    vec4 BaseColorFactor;
+    mat4 ModelMatrix;
+    mat4 ModelInverse;
+
+    vec3 EmissiveFactor;
+    float    MetallicFactor;
+
+    float    RoughnessFactor;
+    float    OcclusionFactor;
+    float    AlphaMask;
+    float    AlphaMaskCutoff;
+
+    uint    AlbedoIndex;
+    uint    RoughnessIndex;
+    uint    NormalIndex;
+    uint    OcclusionIndex;
+
+    uint    EmissiveIndex;
+    uint    BRDFLutIndex;
+    uint    IrradianceIndex;
+    uint    PrefilterMapIndex;
+
+    uint    Flags;
+    uint    Padding[3];
+};
+
+layout(location=0) in vec3 Position;
+#if HAS_TANGENT_ATTRIBUTE
+layout(location=1) in vec4 Tangent;
+#endif
+layout(location=2) in vec3 Normal;
+#if HAS_TEXCOORD_ATTRIBUTE
+layout(location=3) in vec2 TexCoord0;
+#endif
+
+layout (location = 0) out vec2 vTexcoord0;
+layout (location = 1) out vec3 vNormal;
+layout (location = 2) out vec4 vTangent;
+layout (location = 3) out vec3 vPosition;
+
+void main() {
+    vPosition = vec3(Matrix * ModelMatrix * vec4(Position, 1.0));
+    gl_Position = ViewProjection * vec4(vPosition, 1.0);
+
+    vTexcoord0 = vec2(0.0);
+#if HAS_TEXCOORD_ATTRIBUTE
+    if ( HAS_MATERIAL_FEATURE( MaterialFeatures_TexcoordVertexAttribute ) ) {
+        vTexcoord0 = TexCoord0;
+    }
+#endif
+    vNormal = (ModelInverse * vec4(Normal, 0.0)).xyz;
+
+    vTangent = vec4(0.0);
+#if HAS_TANGENT_ATTRIBUTE
+    if ( HAS_MATERIAL_FEATURE( MaterialFeatures_TangentVertexAttribute ) ) {
+        vTangent = vec4(mat3(ModelMatrix) * Tangent.xyz, Tangent.w);
+    }
+#endif
+}
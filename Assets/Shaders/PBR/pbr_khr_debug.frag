@@ -1,12 +1,8 @@
 #version 450
 
-uint MaterialFeatures_ColorTexture     = 1 << 0;
-uint MaterialFeatures_NormalTexture    = 1 << 1;
-uint MaterialFeatures_RoughnessTexture = 1 << 2;
-uint MaterialFeatures_OcclusionTexture = 1 << 3;
-uint MaterialFeatures_EmissiveTexture =  1 << 4;
-uint MaterialFeatures_TangentVertexAttribute = 1 << 5;
-uint MaterialFeatures_TexcoordVertexAttribute = 1 << 6;
+#extension GL_GOOGLE_include_directive : enable
+
+#include "material_features.glsl"
 
 uint DebugFlags_DisableSRGBConversion = 1 << 0;
 uint DebugFlags_OnlyDiffuseContribution = 1 << 1;
@@ -120,7 +116,7 @@ vec3 CalculateNormal()
 
 	 vec3 Normal = normalize(inNormal);
 
-    if ( ( Flags & MaterialFeatures_TangentVertexAttribute ) != 0 ) {
+    if ( HAS_MATERIAL_FEATURE( MaterialFeatures_TangentVertexAttribute ) ) {
         vec3 tangent = normalize( inTangent.xyz );
         vec3 bitangent = cross( Normal, tangent ) * inTangent.w;
 
@@ -150,7 +146,7 @@ vec3 CalculateNormal()
 
     // NOTE(marco): normal textures are encoded to [0, 1] but need to be mapped to [-1, 1] value
     vec3 N = Normal;
-    if ( ( Flags & MaterialFeatures_NormalTexture ) != 0 ) {
+    if ( HAS_MATERIAL_FEATURE( MaterialFeatures_NormalTexture ) ) {
     
         N = normalize( texture(normalMap, vTexcoord0).rgb * 2.0 - 1.0 );
         N = normalize( TBN * N );
@@ -221,7 +217,7 @@ void main()
 	vec3 f0 = vec3(0.04);
 
 	if (AlphaMask == 1.0f) {
-		if (( Flags & MaterialFeatures_ColorTexture ) != 0 ) {
+		if (HAS_MATERIAL_FEATURE( MaterialFeatures_ColorTexture ) ) {
 			baseColor = SRGBtoLINEAR(texture(colorMap, vTexcoord0)) * BaseColorFactor;
 		} else {
 			baseColor = BaseColorFactor;
@@ -237,7 +233,7 @@ void main()
 	// or from a metallic-roughness map
 	perceptualRoughness = RoughnessFactor; // roughness value, as authored by the model creator (input to shader)
 	metallic = MetallicFactor;
-	if (( Flags & MaterialFeatures_RoughnessTexture ) != 0 ) {
+	if (HAS_MATERIAL_FEATURE( MaterialFeatures_RoughnessTexture ) ) {
 		// Roughness is stored in the 'g' channel, metallic is stored in the 'b' channel.
 		// This layout intentionally reserves the 'r' channel for (optional) occlusion map data
 		vec4 mrSample = texture(physicalDescriptorMap, vTexcoord0);
@@ -252,7 +248,7 @@ void main()
 	// convert to material roughness by squaring the perceptual roughness [2].
 	
 	// The albedo may be defined from a base texture or a flat color
-	if (( ( Flags & MaterialFeatures_ColorTexture ) != 0 )) {
+	if (( HAS_MATERIAL_FEATURE( MaterialFeatures_ColorTexture ) )) {
 		baseColor = SRGBtoLINEAR(texture(colorMap, vTexcoord0)) * BaseColorFactor;
 	} 
 	else {
@@ -321,13 +317,13 @@ void main()
 	vec3 color = Lo + diffuse + specular;
 
 	// Apply optional PBR terms for additional (optional) shading
-	if (( Flags & MaterialFeatures_OcclusionTexture ) != 0 ) {
+	if (HAS_MATERIAL_FEATURE( MaterialFeatures_OcclusionTexture ) ) {
 		float ao = texture(aoMap, vTexcoord0).r;
 		color = mix(color, color * ao, OcclusionFactor);
 	}
 
 	const float u_EmissiveFactor = 1.0f;
-	if (( Flags & MaterialFeatures_EmissiveTexture ) != 0 ) {
+	if (HAS_MATERIAL_FEATURE( MaterialFeatures_EmissiveTexture ) ) {
 		vec3 emissive = SRGBtoLINEAR(texture(emissiveMap, vTexcoord0)).rgb * EmissiveFactor;
 		color += emissive;
 	}
@@ -1,4 +1,14 @@
 #include <Core/VrixicEngine.h>
+#include <Runtime/Graphics/FrameGraph/FrameGraph.h>
+#include <Runtime/Graphics/TextureTools/IBLBaker.h>
+#include <Runtime/Graphics/Renderer.h>
+#include <Runtime/Graphics/Vulkan/VulkanShader.h>
+#include <Runtime/File/DerivedDataCache.h>
+#include <External/enkiTS/Includes/TaskScheduler.h>
+#include <Misc/Defines/StringDefines.h>
+
+#include <chrono>
+#include <string.h>
 
 #if _DEBUG
 #define _CRTDBG_MAP_ALLOC
@@ -20,8 +30,117 @@ public:
 	}
 };
 
-int main()
+/**
+* Bakes the prefiltered and irradiance maps of an environment cubemap on the cpu, writes <prefix>PrefilteredEnvMap.ktx
+* and <prefix>IrradianceMap.ktx (the files the renderer looks for) so they can be shipped instead of baked on first run
+*/
+static bool BakeImageBasedLighting(const std::string& inCubemapPath, const std::string& inOutputPrefix)
 {
+	typedef std::chrono::high_resolution_clock Clock;
+
+	enki::TaskScheduler TaskScheduler;
+	TaskScheduler.Initialize();
+
+	FIBLBakeConfig Config;
+	Config.SupercompressionLevel = 18;
+	Config.TaskScheduler = &TaskScheduler;
+
+	auto Start = Clock::now();
+	FCubemapImage Source;
+	bool bSucceeded = FIBLBaker::LoadCubemapKtx(inCubemapPath, Source, &TaskScheduler);
+	const float LoadTimeMs = std::chrono::duration<float, std::milli>(Clock::now() - Start).count();
+
+	if (bSucceeded)
+	{
+		Start = Clock::now();
+		FCubemapImage IrradianceMap;
+		FIBLBaker::BakeIrradianceMap(FIBLBaker::ProjectIrradiance(Source, Config), IrradianceMap, Config);
+		const float IrradianceTimeMs = std::chrono::duration<float, std::milli>(Clock::now() - Start).count();
+
+		Start = Clock::now();
+		FCubemapImage PrefilteredMap;
+		FIBLBaker::BakePrefilteredMap(Source, PrefilteredMap, Config);
+		const float PrefilterTimeMs = std::chrono::duration<float, std::milli>(Clock::now() - Start).count();
+
+		VE_CORE_LOG_INFO(VE_TEXT("[IBLBaker]: {0}x{0} cubemap loaded in {1} ms, irradiance baked in {2} ms, prefiltered map baked in {3} ms"),
+			Source.Size, LoadTimeMs, IrradianceTimeMs, PrefilterTimeMs);
+
+		bSucceeded = FIBLBaker::WriteCubemapKtx(inOutputPrefix + "IrradianceMap.ktx", IrradianceMap, Config.SupercompressionLevel)
+			&& FIBLBaker::WriteCubemapKtx(inOutputPrefix + "PrefilteredEnvMap.ktx", PrefilteredMap, Config.SupercompressionLevel);
+	}
+
+	TaskScheduler.WaitforAllAndShutdown();
+	return bSucceeded;
+}
+
+/**
+* Compiles the shaders the renderer loads at startup into an empty derived data cache, then compiles them again out of it.
+* The first pass is a first launch, the second one every launch after it. Needs the shaders but no gpu
+*/
+static bool BenchmarkShaderCache(const std::string& inCacheFolder)
+{
+	typedef std::chrono::high_resolution_clock Clock;
+
+	FDerivedDataCacheConfig CacheConfig;
+	CacheConfig.CacheFolder = inCacheFolder;
+	DerivedDataCache::Get().Init(&CacheConfig);
+
+	if (DerivedDataCache::Get().GetSizeInBytes() != 0)
+	{
+		VE_CORE_LOG_ERROR(VE_TEXT("[Benchmark]: '{0}' already has cache entries, the cold pass needs an empty folder"), inCacheFolder);
+		DerivedDataCache::Get().Shutdown();
+		return false;
+	}
+
+	enki::TaskScheduler TaskScheduler;
+	TaskScheduler.Initialize();
+
+	// Precompiling only runs glslang, the factory never touches the device
+	VulkanShaderFactory ShaderFactory(nullptr);
+	ShaderFactory.AddIncludeDirectory(Renderer::MakePathToResource("", 's'));
+
+	std::vector<FShaderConfig> ShaderConfigs;
+	Renderer::GetStartupShaderConfigs(ShaderConfigs);
+
+	auto Start = Clock::now();
+	ShaderFactory.PrecompileShaders(ShaderConfigs.data(), (uint32)ShaderConfigs.size(), &TaskScheduler);
+	const float ColdTimeMs = std::chrono::duration<float, std::milli>(Clock::now() - Start).count();
+
+	Start = Clock::now();
+	ShaderFactory.PrecompileShaders(ShaderConfigs.data(), (uint32)ShaderConfigs.size(), &TaskScheduler);
+	const float WarmTimeMs = std::chrono::duration<float, std::milli>(Clock::now() - Start).count();
+
+	VE_CORE_LOG_INFO(VE_TEXT("[Benchmark]: {0} shaders, cold cache {1} ms, warm cache {2} ms, {3} KiB cached"),
+		ShaderConfigs.size(), ColdTimeMs, WarmTimeMs, (DerivedDataCache::Get().GetSizeInBytes() >> 10));
+
+	TaskScheduler.WaitforAllAndShutdown();
+	DerivedDataCache::Get().Shutdown();
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	// Tool mode: Sandbox -PrecompileFrameGraph <graph.json>, writes graph.vfg next to the json and exits
+	if (argc == 3 && strcmp(argv[1], "-PrecompileFrameGraph") == 0)
+	{
+		Log::Init();
+		return FrameGraph::PrecompileGraph(argv[2]) ? 0 : 1;
+	}
+
+	// Tool mode: Sandbox -BakeImageBasedLighting <cubemap.ktx> <output prefix>, bakes the irradiance and prefiltered maps on the cpu
+	if (argc == 4 && strcmp(argv[1], "-BakeImageBasedLighting") == 0)
+	{
+		Log::Init();
+		return BakeImageBasedLighting(argv[2], argv[3]) ? 0 : 1;
+	}
+
+	// Tool mode: Sandbox -BenchmarkShaderCache <empty folder>, times compiling the startup shaders with a cold and a warm spirv cache
+	if (argc == 3 && strcmp(argv[1], "-BenchmarkShaderCache") == 0)
+	{
+		Log::Init();
+		return BenchmarkShaderCache(argv[2]) ? 0 : 1;
+	}
+
 	// Logging and Memory Output
 #if _DEBUG
 	_CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF | _CRTDBG_LEAK_CHECK_DF);
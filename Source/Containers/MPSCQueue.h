@@ -0,0 +1,112 @@
+/**
+* This file is part of the "Vrixic Engine" project (Copyright (c) 2022-2023 by Vrij Patel)
+* See "LICENSE.txt" for license information.
+*/
+
+#pragma once
+#include <Core/Core.h>
+#include <Misc/Defines/GenericDefines.h>
+
+#include <atomic>
+
+/**
+* A bounded lock-free queue that any number of threads can push to and a single thread pops from
+*
+* | -- Every slot stores a sequence number telling whether it is free to write or ready to read for the current lap around the ring,
+*			producers claim a slot with a single compare exchange on the tail, the consumer never writes to the tail
+* | -- Push fails instead of blocking when the queue is full, the producer is expected to try again later
+* | -- Capacity has to be a power of two
+*/
+template<typename ElementType, uint32 Capacity>
+class VRIXIC_API TMPSCQueue
+{
+	static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "TMPSCQueue: Capacity has to be a power of two");
+
+public:
+	TMPSCQueue()
+		: Head(0), Tail(0)
+	{
+		for (uint32 i = 0; i < Capacity; ++i)
+		{
+			Slots[i].Sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	TMPSCQueue(const TMPSCQueue&) = delete;
+	TMPSCQueue& operator=(const TMPSCQueue&) = delete;
+
+public:
+	/**
+	* Adds an element to the back of the queue, can be called from any thread
+	*
+	* @param inElement - the element to add
+	* @returns bool - false if the queue is full
+	*/
+	bool Push(const ElementType& inElement)
+	{
+		uint64 Position = Tail.load(std::memory_order_relaxed);
+		while (true)
+		{
+			FSlot& Slot = Slots[Position & (Capacity - 1)];
+			const int64 Difference = (int64)Slot.Sequence.load(std::memory_order_acquire) - (int64)Position;
+
+			if (Difference == 0)
+			{
+				// The slot is free for this lap, claim it (on failure Position is reloaded with the current tail)
+				if (Tail.compare_exchange_weak(Position, Position + 1, std::memory_order_relaxed))
+				{
+					Slot.Element = inElement;
+					Slot.Sequence.store(Position + 1, std::memory_order_release);
+					return true;
+				}
+			}
+			else if (Difference < 0)
+			{
+				// The consumer has not popped the element of the last lap yet
+				return false;
+			}
+			else
+			{
+				Position = Tail.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	/**
+	* Removes the element at the front of the queue, only one thread may pop at a time
+	*
+	* @param outElement - the element that was removed
+	* @returns bool - false if the queue is empty (or the next element is still being written)
+	*/
+	bool Pop(ElementType& outElement)
+	{
+		FSlot& Slot = Slots[Head & (Capacity - 1)];
+		if (Slot.Sequence.load(std::memory_order_acquire) != Head + 1)
+		{
+			return false;
+		}
+
+		outElement = Slot.Element;
+
+		// Frees the slot for the producers of the next lap
+		Slot.Sequence.store(Head + Capacity, std::memory_order_release);
+		Head++;
+
+		return true;
+	}
+
+private:
+	struct FSlot
+	{
+		std::atomic<uint64> Sequence;
+		ElementType Element;
+	};
+
+	FSlot Slots[Capacity];
+
+	/** Only touched by the consumer */
+	alignas(64) uint64 Head;
+
+	/** Kept on its own cache line so producers do not invalidate the consumer's */
+	alignas(64) std::atomic<uint64> Tail;
+};
@@ -5,7 +5,10 @@
 
 #pragma once
 
-#ifdef PLATFORM_WINDOWS
+#if defined(VE_BUILD_STANDALONE)
+	// Sources compiled straight into a standalone executable (the portable test targets), nothing is exported
+	#define VRIXIC_API
+#elif defined(PLATFORM_WINDOWS)
 	#ifdef VE_BUILD_DLL
 		#define VRIXIC_API __declspec(dllexport)
 	#else
@@ -1,2 +1,9 @@
+#include <Runtime/Memory/ResourceManager.h>
+
+// Decode straight into the resource manager's texture arena
+#define STBI_MALLOC(inSize) ResourceManager::DecodeMalloc(inSize)
+#define STBI_REALLOC_SIZED(inMemory, inOldSize, inNewSize) ResourceManager::DecodeRealloc(inMemory, inOldSize, inNewSize)
+#define STBI_FREE(inMemory) ResourceManager::DecodeFree(inMemory)
+
 #define STB_IMAGE_IMPLEMENTATION
-#include "stb_image.h"
\ No newline at end of file
+#include "stb_image.h"
@@ -20,10 +20,10 @@
 #if defined(PLATFORM_WINDOWS)
 #define DEBUG_BREAK() __debugbreak()
 #elif defined(PLATFORM_MAC)
-#define DEBUG_BREAK __builting_debugtrap();
+#define DEBUG_BREAK() __builtin_debugtrap()
 //#elif defined(PLATFORM_LINUX)
 #else
-#define DEBUG_BREAK __builting_trap();
+#define DEBUG_BREAK() __builtin_trap()
 #endif
 
 // check the expression and fail if it is false 
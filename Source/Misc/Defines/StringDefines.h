@@ -7,7 +7,7 @@
 #include <Runtime/Core/Strings/StringHash.h>
 
 // User Defining a literal -- _SHID = StringHashID
-inline uint32 operator"" _SHID(const char* inString, size_t inLength)
+inline uint32 operator"" _SHID(const char* inString, size_t /*inLength*/)
 {
 	return StringHash::GetStringHash(inString);
 }
@@ -15,4 +15,9 @@ inline uint32 operator"" _SHID(const char* inString, size_t inLength)
 
 /* VE_CONST_CHAR - work around to get the user defined literal working */
 #define VE_CONST_CHAR(...) __VA_ARGS__
+#if defined(_MSC_VER)
 #define VE_TEXT(...) StringHash::GetStringFromHash(VE_CONST_CHAR(__VA_ARGS__)_SHID)
+#else
+/* gcc and clang do not join a literal and a suffix coming out of a macro, call what the literal operator calls instead */
+#define VE_TEXT(...) StringHash::GetStringFromHash(StringHash::GetStringHash(__VA_ARGS__))
+#endif
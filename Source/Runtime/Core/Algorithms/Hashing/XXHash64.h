@@ -0,0 +1,119 @@
+/**
+* This file is part of the "Vrixic Engine" project (Copyright (c) 2022-2023 by Vrij Patel)
+* See "LICENSE.txt" for license information.
+*/
+
+#pragma once
+#include <Core/Core.h>
+#include <Misc/Defines/GenericDefines.h>
+
+#include <string.h>
+
+/**
+* 64-bit xxHash (XXH64), non cryptographic, a few GB/s on a single core
+* Used where a 32 bit crc collides too easily, ex: content addressed cache keys
+*
+* Hashing several pieces by passing the previous hash as the seed of the next gives a stable combined hash
+*/
+struct VRIXIC_API XXHash64
+{
+public:
+    static constexpr uint64 PRIME_1 = 0x9E3779B185EBCA87ull;
+    static constexpr uint64 PRIME_2 = 0xC2B2AE3D27D4EB4Full;
+    static constexpr uint64 PRIME_3 = 0x165667B19E3779F9ull;
+    static constexpr uint64 PRIME_4 = 0x85EBCA77C2B2AE63ull;
+    static constexpr uint64 PRIME_5 = 0x27D4EB2F165667C5ull;
+
+public:
+    /**
+    * @returns uint64 the hash of inSizeInBytes bytes starting at inData
+    */
+    static uint64 Hash(const void* inData, uint64 inSizeInBytes, uint64 inSeed = 0)
+    {
+        const uint8* Data = (const uint8*)inData;
+        const uint8* End = Data + inSizeInBytes;
+
+        uint64 Result = 0;
+        if (inSizeInBytes >= 32)
+        {
+            uint64 Lanes[4] = { inSeed + PRIME_1 + PRIME_2, inSeed + PRIME_2, inSeed, inSeed - PRIME_1 };
+
+            const uint8* Limit = End - 32;
+            do
+            {
+                Lanes[0] = Round(Lanes[0], Read64(Data));
+                Lanes[1] = Round(Lanes[1], Read64(Data + 8));
+                Lanes[2] = Round(Lanes[2], Read64(Data + 16));
+                Lanes[3] = Round(Lanes[3], Read64(Data + 24));
+                Data += 32;
+            } while (Data <= Limit);
+
+            Result = RotateLeft(Lanes[0], 1) + RotateLeft(Lanes[1], 7) + RotateLeft(Lanes[2], 12) + RotateLeft(Lanes[3], 18);
+            for (uint32 i = 0; i < 4; ++i)
+            {
+                Result = (Result ^ Round(0, Lanes[i])) * PRIME_1 + PRIME_4;
+            }
+        }
+        else
+        {
+            Result = inSeed + PRIME_5;
+        }
+
+        Result += inSizeInBytes;
+
+        for (; Data + 8 <= End; Data += 8)
+        {
+            Result ^= Round(0, Read64(Data));
+            Result = RotateLeft(Result, 27) * PRIME_1 + PRIME_4;
+        }
+
+        if (Data + 4 <= End)
+        {
+            Result ^= (uint64)Read32(Data) * PRIME_1;
+            Result = RotateLeft(Result, 23) * PRIME_2 + PRIME_3;
+            Data += 4;
+        }
+
+        for (; Data < End; ++Data)
+        {
+            Result ^= (*Data) * PRIME_5;
+            Result = RotateLeft(Result, 11) * PRIME_1;
+        }
+
+        // Avalanche
+        Result ^= Result >> 33;
+        Result *= PRIME_2;
+        Result ^= Result >> 29;
+        Result *= PRIME_3;
+        Result ^= Result >> 32;
+
+        return Result;
+    }
+
+private:
+    inline static uint64 RotateLeft(uint64 inValue, uint32 inBits)
+    {
+        return (inValue << inBits) | (inValue >> (64 - inBits));
+    }
+
+    inline static uint64 Round(uint64 inAccumulator, uint64 inInput)
+    {
+        inAccumulator += inInput * PRIME_2;
+        inAccumulator = RotateLeft(inAccumulator, 31);
+        return inAccumulator * PRIME_1;
+    }
+
+    inline static uint64 Read64(const uint8* inData)
+    {
+        uint64 Value;
+        memcpy(&Value, inData, sizeof(uint64));
+        return Value;
+    }
+
+    inline static uint32 Read32(const uint8* inData)
+    {
+        uint32 Value;
+        memcpy(&Value, inData, sizeof(uint32));
+        return Value;
+    }
+};
@@ -6,7 +6,7 @@
 #pragma once
 #include "VrixicMathHelper.h"
 
-#include <corecrt_math.h>
+#include <cmath>
 
 /* Row vector */
 struct VRIXIC_API Vector3D
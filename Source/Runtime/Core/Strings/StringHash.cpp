@@ -5,6 +5,8 @@
 
 #include "StringHash.h"
 
+#include <cstring>
+
 TMap<uint32, const char*> StringHash::StringMap = TMap<uint32, const char*>();
 
 StringHash::StringHash(const char* inString)
@@ -2,155 +2,563 @@
 
 #include <Runtime/Graphics/Renderer.h>
 
-void AsynchronousLoader::Init(enki::TaskScheduler* inTaskScheduler)
+#include <vulkan/vulkan_core.h>
+#include <External/ktx/Includes/ktxvulkan.h>
+
+#include <algorithm>
+
+namespace AsynchronousLoaderHelpers
+{
+    static bool CompareLoadPriority(const TextureLoadRequest& inA, const TextureLoadRequest& inB)
+    {
+        return inA.Priority < inB.Priority;
+    }
+
+    static bool CompareUploadPriority(const TextureUploadRequest& inA, const TextureUploadRequest& inB)
+    {
+        return inA.Priority < inB.Priority;
+    }
+
+    /** KTX 1 and KTX 2 identifiers both start with "\xABKTX " */
+    static bool IsKtxFile(const FFileSpan& inFileSpan)
+    {
+        static const uint8 KtxIdentifier[5] = { 0xAB, 'K', 'T', 'X', ' ' };
+        return inFileSpan.Size >= sizeof(KtxIdentifier) && memcmp(inFileSpan.Data, KtxIdentifier, sizeof(KtxIdentifier)) == 0;
+    }
+
+    static uint64 GetUploadSize(const TextureUploadRequest& inRequest)
+    {
+        return inRequest.KtxTextureHandle != nullptr ? ktxTexture_GetDataSize(inRequest.KtxTextureHandle) : inRequest.CpuHandle.SizeInBytes;
+    }
+
+    /**
+    * Frees the decoded texture of a request that will not be (or has already been) copied to the staging buffer
+    */
+    static void ReleaseDecodedTexture(const TextureUploadRequest& inRequest)
+    {
+        if (inRequest.KtxTextureHandle != nullptr)
+        {
+            ktxTexture_Destroy(inRequest.KtxTextureHandle);
+        }
+        else
+        {
+            ResourceManager::Get().FreeTexture(inRequest.Path);
+        }
+    }
+}
+
+void TextureDecodeTaskSet::ExecuteRange(enki::TaskSetPartition inRange, uint32_t inThreadNum)
 {
+    for (uint32 i = inRange.start; i < inRange.end; ++i)
+    {
+        Loader->DecodeTexture(Loader->DecodeRequests[i]);
+    }
+}
+
+void AsynchronousLoader::Init(enki::TaskScheduler* inTaskScheduler, uint64 inStagingBufferSize)
+{
+    VE_ASSERT((inStagingBufferSize % STAGING_BUFFER_ALIGNMENT) == 0, VE_TEXT("[AsynchronousLoader]: Staging buffer size has to be a multiple of {0}"), STAGING_BUFFER_ALIGNMENT);
+
     TaskScheduler = inTaskScheduler;
 
-    TextureReady = InvalidTextureHandle;
+    NumDecodeRequests = 0;
+    DecodeTaskSet.Loader = this;
 
     FCommandBufferConfig CommandBufferConfig = { };
     CommandBufferConfig.CommandQueue = Renderer::Get().GetRenderInterface().Get()->GetTransferQueue();
     CommandBufferConfig.NumBuffersToAllocate = 1;
     CommandBufferConfig.Flags = FCommandBufferLevelFlags::Primary;
-    CommandBuffers.resize(Renderer::Get().GetSwapchain()->GetImageCount());
+    TransferBatches.resize(Renderer::Get().GetSwapchain()->GetImageCount());
 
-    for (uint32 i = 0; i < CommandBuffers.size(); ++i)
+    for (uint32 i = 0; i < TransferBatches.size(); ++i)
     {
-        ICommandBuffer* Buffer = Renderer::Get().GetRenderInterface().Get()->CreateCommandBuffer(CommandBufferConfig);
-        CommandBuffers[i] = Buffer;
+        TransferBatches[i].CommandBuffer = Renderer::Get().GetRenderInterface().Get()->CreateCommandBuffer(CommandBufferConfig);
+        TransferBatches[i].Fence = Renderer::Get().GetRenderInterface().Get()->CreateFence();
+        TransferBatches[i].Textures.reserve(MAX_UPLOAD_REQUESTS_PER_TICK);
     }
 
+    OldestTransferBatch = 0;
+    NumTransferBatchesInFlight = 0;
+
     FSemaphoreConfig SemaphoreConfig = { 1 };
     TransferCompleteSemaphore = Renderer::Get().GetRenderInterface().Get()->CreateRenderSemaphore(SemaphoreConfig);
 
-    TransferFence = Renderer::Get().GetRenderInterface().Get()->CreateFence();
-
     FBufferConfig BufferConfig = { };
     BufferConfig.InitialData = nullptr;
     BufferConfig.MemoryFlags |= FMemoryFlags::HostCoherent | FMemoryFlags::HostVisible;
-    StagingBufferSize = static_cast<uint64>(512u * 1024u) * 1024u;
-    BufferConfig.Size = StagingBufferSize;
+    BufferConfig.Size = inStagingBufferSize;
     BufferConfig.UsageFlags |= FResourceBindFlags::StagingBuffer | FResourceBindFlags::SrcTransfer;
 
     StagingBuffer = Renderer::Get().GetRenderInterface().Get()->CreateBuffer(BufferConfig);
-    StagingBufferOffset = 0u;
+    StagingBufferAllocater.Init(inStagingBufferSize);
 }
 
 void AsynchronousLoader::Update()
 {
-    // If we have a texture that has been processed and is ready, signal the renderer 
-    if (TextureReady != InvalidTextureHandle)
+    // If we have textures that have been processed and are ready, signal the renderer
+    FlushReadyTextures();
+
+    UploadTextures();
+
+    ReadFiles();
+}
+
+void AsynchronousLoader::ReadFiles()
+{
+    // Wait for the workers to finish the last batch before starting a new one
+    if (!DecodeTaskSet.GetIsComplete())
     {
-        Renderer::Get().AddTextureToUpdate(TextureReady);
+        return;
     }
 
-    TextureReady = InvalidTextureHandle;
+    std::lock_guard<std::mutex> LockGuard(LoadRequestMutex);
 
-    if (TextureUploadRequests.size())
+    // Release the last batch
+    for (uint32 i = 0; i < NumDecodeRequests; ++i)
     {
-        ICommandBuffer* CommandBuffer = CommandBuffers[Renderer::Get().GetCurrentFrame()];
+        DecodeRequests[i].Reader.reset();
+    }
+
+    NumDecodeRequests = 0;
+
+    if (TextureLoadRequests.empty())
+    {
+        return;
+    }
+
+    FFileReaderConfig ReaderConfig = { };
+    ReaderConfig.Mode = EFileReadMode::MemoryMapped;
+    ReaderConfig.AccessHint = EFileAccessHint::WillNeed;
 
-        // Wait for fence 
-        if (!Renderer::Get().GetRenderInterface().Get()->GetTransferQueue()->GetWaitFenceStatus(TransferFence))
+    while (NumDecodeRequests < MAX_DECODE_REQUESTS_PER_TICK && !TextureLoadRequests.empty())
+    {
+        std::pop_heap(TextureLoadRequests.begin(), TextureLoadRequests.end(), AsynchronousLoaderHelpers::CompareLoadPriority);
+        TextureLoadRequest LoadRequest = TextureLoadRequests.back();
+        TextureLoadRequests.pop_back();
+
+        // Map the file and prefetch it so the workers do not stall on disk reads
+        TUniquePtr<FileReader> Reader = CreateUniquePointer<FileReader>(LoadRequest.Path, ReaderConfig);
+        if (!Reader->IsOpen())
         {
-            return;
+            VE_CORE_LOG_ERROR(VE_TEXT("[AsynchronousLoader]: Failed to open texture file: {0}"), LoadRequest.Path);
+            continue;
         }
 
-        // Reset if file requests are present 
-        Renderer::Get().GetRenderInterface().Get()->GetTransferQueue()->ResetWaitFence(TransferFence);
+        TextureDecodeRequest& DecodeRequest = DecodeRequests[NumDecodeRequests++];
+        DecodeRequest.LoadRequest = LoadRequest;
+        DecodeRequest.Reader = std::move(Reader);
+        DecodeRequest.bIsCancelled = false;
+        DecodeRequest.bIsQueued = false;
+    }
+
+    if (NumDecodeRequests == 0)
+    {
+        return;
+    }
+
+    DecodeTaskSet.m_SetSize = NumDecodeRequests;
+    DecodeTaskSet.m_MinRange = 1;
+    TaskScheduler->AddTaskSetToPipe(&DecodeTaskSet);
+}
 
-        TextureUploadRequest Request = TextureUploadRequests.back();
-        TextureUploadRequests.pop_back();
+void AsynchronousLoader::DecodeTexture(TextureDecodeRequest& inDecodeRequest)
+{
+    if (inDecodeRequest.bIsCancelled)
+    {
+        return;
+    }
 
-        CommandBuffer->Begin();
+    const TextureLoadRequest& LoadRequest = inDecodeRequest.LoadRequest;
+    FFileSpan FileSpan = inDecodeRequest.Reader->GetSpan();
 
-        if (Request.Texture != InvalidTextureHandle)
+    TextureUploadRequest URequest = { };
+
+    URequest.Texture = LoadRequest.Texture;
+    URequest.Path = LoadRequest.Path;
+    URequest.Format = LoadRequest.Format;
+    URequest.Priority = LoadRequest.Priority;
+
+    if (AsynchronousLoaderHelpers::IsKtxFile(FileSpan))
+    {
+        if (!DecodeKtxTexture(inDecodeRequest, URequest))
         {
-            TextureResource*& TextureHandle = Renderer::Get().GetTextureResource(Request.Texture);
+            return;
+        }
+    }
+    else
+    {
+        TextureResourceHandle Handle = ResourceManager::Get().LoadTextureFromMemory(LoadRequest.Path, FileSpan.Data, FileSpan.Size, &LoadRequest.MipConfig);
+        if (Handle.GetMemoryHandle() == nullptr)
+        {
+            return;
+        }
+
+        URequest.CpuHandle = Handle;
+    }
+
+    std::lock_guard<std::mutex> LockGuard(UploadRequestMutex);
+
+    // Checked under the lock, CancelTextureRequest() holds it while it flags the request so the texture is either dropped here or found in the upload queue
+    if (inDecodeRequest.bIsCancelled)
+    {
+        AsynchronousLoaderHelpers::ReleaseDecodedTexture(URequest);
+        return;
+    }
 
-            uint64 TextureSize = Request.CpuHandle.SizeInBytes;
-            // Align Memory
-            const uint64 AlignmentMask = 3;
-            uint64 AlignedImageSize = (TextureSize + AlignmentMask) & ~AlignmentMask;
-            const uint64 CurrentOffset = std::atomic_fetch_add(&StagingBufferOffset, AlignedImageSize);
+    TextureUploadRequests.push_back(URequest);
+    std::push_heap(TextureUploadRequests.begin(), TextureUploadRequests.end(), AsynchronousLoaderHelpers::CompareUploadPriority);
+    inDecodeRequest.bIsQueued = true;
+}
 
-            VE_ASSERT(StagingBufferOffset < StagingBufferSize, VE_TEXT("[AsynchronousLoader]: Staging Buffers Size overflow...!"));
+bool AsynchronousLoader::DecodeKtxTexture(const TextureDecodeRequest& inDecodeRequest, TextureUploadRequest& outUploadRequest)
+{
+    FFileSpan FileSpan = inDecodeRequest.Reader->GetSpan();
 
-            // Create the texture resource
-            FTextureConfig Config = FTextureConfig();
-            Config.BindFlags |= FResourceBindFlags::Sampled | FResourceBindFlags::DstTransfer | FResourceBindFlags::SrcTransfer;
-            Config.Extent.Depth = 1;
-            Config.MipLevels = 1;
-            Config.NumArrayLayers = 1;
-            Config.NumSamples = 1;
-            Config.Type = ETextureType::Texture2D;
+    ktxTexture* KtxTextureHandle = nullptr;
+    KTX_error_code KtxResult = ktxTexture_CreateFromMemory(FileSpan.Data, FileSpan.Size, KTX_TEXTURE_CREATE_LOAD_IMAGE_DATA_BIT, &KtxTextureHandle);
+    if (KtxResult != KTX_SUCCESS)
+    {
+        VE_CORE_LOG_ERROR(VE_TEXT("[AsynchronousLoader]: Failed to load ktx texture: {0}, error: {1}"), inDecodeRequest.LoadRequest.Path, ktxErrorString(KtxResult));
+        return false;
+    }
 
-            Config.Extent.Width = Request.CpuHandle.Width;
-            Config.Extent.Height = Request.CpuHandle.Height;
+    if (KtxTextureHandle->numLayers > 1 || KtxTextureHandle->numDimensions != 2)
+    {
+        VE_CORE_LOG_ERROR(VE_TEXT("[AsynchronousLoader]: Only 2d and cubemap ktx textures can be streamed: {0}"), inDecodeRequest.LoadRequest.Path);
+        ktxTexture_Destroy(KtxTextureHandle);
+        return false;
+    }
 
-            Config.Format = Request.Format;
+    outUploadRequest.KtxTextureHandle = KtxTextureHandle;
+    outUploadRequest.Format = (EPixelFormat)ktxTexture_GetVkFormat(KtxTextureHandle);
 
-            TextureHandle = Renderer::Get().GetRenderInterface().Get()->CreateTexture(Config);
+    return true;
+}
 
-            // Copy Texture Data to buffer
-            Renderer::Get().GetRenderInterface().Get()->WriteToBuffer(StagingBuffer, CurrentOffset, Request.CpuHandle.GetMemoryHandle(), AlignedImageSize);
+void AsynchronousLoader::RecordTextureUpload(ICommandBuffer* inCommandBuffer, const TextureUploadRequest& inRequest, uint64 inStagingOffset)
+{
+    TextureResource*& TextureHandle = Renderer::Get().GetTextureResource(inRequest.Texture);
 
-            // Copy Buffer Memory Into Image 
-            FTextureWriteInfo TextureWriteInfo = FTextureWriteInfo();
-            TextureWriteInfo.BufferHandle = StagingBuffer;
-            TextureWriteInfo.Subresource.BaseArrayLayer = 0;
-            TextureWriteInfo.Subresource.NumArrayLayers = 1;
-            TextureWriteInfo.Subresource.BaseMipLevel = 0;
-            TextureWriteInfo.Subresource.NumMipLevels = 1;
-            TextureWriteInfo.InitialBufferOffset = CurrentOffset;
+    FTextureWriteInfo TextureWriteInfo = FTextureWriteInfo();
+    TextureWriteInfo.BufferHandle = StagingBuffer;
+    TextureWriteInfo.Subresource.BaseArrayLayer = 0;
+    TextureWriteInfo.Subresource.BaseMipLevel = 0;
+    TextureWriteInfo.InitialBufferOffset = inStagingOffset;
 
-            TextureWriteInfo.Extent = { (uint32)Request.CpuHandle.Width, (uint32)Request.CpuHandle.Height, 1u };
+    if (inRequest.KtxTextureHandle != nullptr)
+    {
+        ktxTexture* KtxTextureHandle = inRequest.KtxTextureHandle;
+        const bool bIsCubemap = KtxTextureHandle->isCubemap;
+
+        // Texture keeps the ktx texture to look up the offset of each mip and face while the copy is recorded
+        FVulkanTextureConfig Config = FVulkanTextureConfig();
+        Config.BindFlags |= FResourceBindFlags::Sampled | FResourceBindFlags::DstTransfer | FResourceBindFlags::SrcTransfer;
+        Config.CreationFlags = FResourceCreationFlags::KTX | (bIsCubemap ? FResourceCreationFlags::Cube : 0);
+        Config.KtxTextureHandle = KtxTextureHandle;
+        Config.Extent = { KtxTextureHandle->baseWidth, KtxTextureHandle->baseHeight, 1u };
+        Config.MipLevels = KtxTextureHandle->numLevels;
+        Config.NumArrayLayers = KtxTextureHandle->numFaces;
+        Config.NumSamples = 1;
+        Config.Type = bIsCubemap ? ETextureType::TextureCube : ETextureType::Texture2D;
+        Config.Format = inRequest.Format;
+
+        TextureHandle = Renderer::Get().GetRenderInterface().Get()->CreateTexture(Config);
+        TextureHandle->SetPath(inRequest.Path);
+
+        Renderer::Get().GetRenderInterface().Get()->WriteToBuffer(StagingBuffer, inStagingOffset, ktxTexture_GetData(KtxTextureHandle), ktxTexture_GetDataSize(KtxTextureHandle));
+
+        TextureWriteInfo.Subresource.NumArrayLayers = KtxTextureHandle->numFaces;
+        TextureWriteInfo.Subresource.NumMipLevels = KtxTextureHandle->numLevels;
+        TextureWriteInfo.Extent = { KtxTextureHandle->baseWidth, KtxTextureHandle->baseHeight, 1u };
+
+        inCommandBuffer->UploadTextureData(TextureHandle, TextureWriteInfo);
+
+        // Offsets have been recorded into the copy, the image data lives in the staging buffer now
+        ktxTexture_Destroy(KtxTextureHandle);
+        return;
+    }
 
-            CommandBuffer->UploadTextureData(TextureHandle, TextureWriteInfo);
+    // Create the texture resource
+    FTextureConfig Config = FTextureConfig();
+    Config.BindFlags |= FResourceBindFlags::Sampled | FResourceBindFlags::DstTransfer | FResourceBindFlags::SrcTransfer;
+    Config.Extent.Depth = 1;
+    Config.MipLevels = inRequest.CpuHandle.NumMipLevels;
+    Config.NumArrayLayers = 1;
+    Config.NumSamples = 1;
+    Config.Type = ETextureType::Texture2D;
 
-            CommandBuffer->End();
+    Config.Extent.Width = inRequest.CpuHandle.Width;
+    Config.Extent.Height = inRequest.CpuHandle.Height;
+
+    Config.Format = inRequest.Format;
+
+    TextureHandle = Renderer::Get().GetRenderInterface().Get()->CreateTexture(Config);
+
+    // Copy Texture Data to buffer
+    Renderer::Get().GetRenderInterface().Get()->WriteToBuffer(StagingBuffer, inStagingOffset, inRequest.CpuHandle.GetMemoryHandle(), inRequest.CpuHandle.SizeInBytes);
+
+    // The staging buffer holds the pixels until the transfer completes, the decoded texture is no longer needed
+    ResourceManager::Get().FreeTexture(inRequest.Path);
+
+    // Copy Buffer Memory Into Image
+    TextureWriteInfo.Subresource.NumArrayLayers = 1;
+    TextureWriteInfo.Subresource.NumMipLevels = inRequest.CpuHandle.NumMipLevels;
+    TextureWriteInfo.Extent = { (uint32)inRequest.CpuHandle.Width, (uint32)inRequest.CpuHandle.Height, 1u };
+
+    inCommandBuffer->UploadTextureData(TextureHandle, TextureWriteInfo);
+}
+
+void AsynchronousLoader::UploadTextures()
+{
+    RetireTransferBatches();
+
+    // Every command buffer is still in use
+    if (NumTransferBatchesInFlight == TransferBatches.size())
+    {
+        return;
+    }
 
-            Renderer::Get().GetRenderInterface().Get()->GetTransferQueue()->Submit(CommandBuffer, TransferFence);
+    TextureUploadRequest Requests[MAX_UPLOAD_REQUESTS_PER_TICK];
+    uint64 StagingOffsets[MAX_UPLOAD_REQUESTS_PER_TICK];
+    uint32 NumRequests = 0;
+    {
+        std::lock_guard<std::mutex> LockGuard(UploadRequestMutex);
 
-            if (Request.Texture != InvalidTextureHandle) {
-                VE_ASSERT(TextureReady == InvalidTextureHandle, VE_TEXT("[AsynchronousLoader]: 'Bug' - If there is a texture already ready then it should have been already passed to the renderer for update...."));
-                TextureReady = Request.Texture;
+        while (NumRequests < MAX_UPLOAD_REQUESTS_PER_TICK && !TextureUploadRequests.empty())
+        {
+            const TextureUploadRequest& Request = TextureUploadRequests.front();
+            const uint64 TextureSize = AsynchronousLoaderHelpers::GetUploadSize(Request);
+
+            if (TextureSize > MAX_STAGING_BUFFER_SIZE)
+            {
+                VE_CORE_LOG_ERROR(VE_TEXT("[AsynchronousLoader]: {0} needs {1} bytes of staging memory, more than the {2} byte limit, dropping it..."),
+                    Request.Path, TextureSize, MAX_STAGING_BUFFER_SIZE);
+                VE_ASSERT(false, VE_TEXT("[AsynchronousLoader]: {0} can never fit in the staging buffer..."), Request.Path);
+                AsynchronousLoaderHelpers::ReleaseDecodedTexture(Request);
+            }
+            else if (TextureSize > StagingBufferAllocater.GetCapacity())
+            {
+                // The buffer can only be replaced once no submission reads from it, the texture stays queued until then
+                if (NumRequests > 0 || NumTransferBatchesInFlight > 0)
+                {
+                    break;
+                }
+
+                GrowStagingBuffer(TextureSize);
+                continue;
+            }
+            // Staging buffer is full, leave the rest queued until a submission completes
+            else if (!StagingBufferAllocater.Alloc(TextureSize, STAGING_BUFFER_ALIGNMENT, StagingOffsets[NumRequests]))
+            {
+                break;
+            }
+            else
+            {
+                Requests[NumRequests++] = Request;
             }
+
+            std::pop_heap(TextureUploadRequests.begin(), TextureUploadRequests.end(), AsynchronousLoaderHelpers::CompareUploadPriority);
+            TextureUploadRequests.pop_back();
         }
     }
 
-    if (TextureLoadRequests.size())
+    if (NumRequests == 0)
     {
-        TextureLoadRequest LoadRequest = TextureLoadRequests.back();
-        TextureLoadRequests.pop_back();
+        return;
+    }
+
+    ICommandQueue* TransferQueue = Renderer::Get().GetRenderInterface().Get()->GetTransferQueue();
+
+    const uint32 BatchIndex = (OldestTransferBatch + NumTransferBatchesInFlight) % TransferBatches.size();
+    TextureTransferBatch& Batch = TransferBatches[BatchIndex];
+
+    Batch.CommandBuffer->Begin();
+
+    for (uint32 i = 0; i < NumRequests; ++i)
+    {
+        RecordTextureUpload(Batch.CommandBuffer, Requests[i], StagingOffsets[i]);
+        Batch.Textures.push_back(Requests[i].Texture);
+    }
+
+    Batch.CommandBuffer->End();
+
+    // Staging memory up to here is released once this batch's fence signals
+    Batch.StagingMarker = StagingBufferAllocater.GetMarker();
+
+    // One submission for the whole batch
+    TransferQueue->ResetWaitFence(Batch.Fence);
+    TransferQueue->Submit(Batch.CommandBuffer, Batch.Fence);
+
+    NumTransferBatchesInFlight++;
+}
+
+void AsynchronousLoader::GrowStagingBuffer(uint64 inMinSize)
+{
+    VE_ASSERT(NumTransferBatchesInFlight == 0, VE_TEXT("[AsynchronousLoader]: The staging buffer cannot be replaced while {0} transfers read from it"), NumTransferBatchesInFlight);
+
+    uint64 NewSize = MathUtils::Max(StagingBufferAllocater.GetCapacity() * 2, inMinSize);
+    NewSize = MathUtils::Min(FMemoryUtils::AlignAddress(NewSize, STAGING_BUFFER_ALIGNMENT), MAX_STAGING_BUFFER_SIZE);
 
-        TextureResourceHandle Handle = ResourceManager::Get().LoadTexture(LoadRequest.Path);
-        if (Handle.GetMemoryHandle() != nullptr)
+    VE_CORE_LOG_INFO(VE_TEXT("[AsynchronousLoader]: Growing the staging buffer from {0} to {1} bytes"), StagingBufferAllocater.GetCapacity(), NewSize);
+
+    Renderer::Get().GetRenderInterface().Get()->Free(StagingBuffer);
+
+    FBufferConfig BufferConfig = { };
+    BufferConfig.InitialData = nullptr;
+    BufferConfig.MemoryFlags |= FMemoryFlags::HostCoherent | FMemoryFlags::HostVisible;
+    BufferConfig.Size = NewSize;
+    BufferConfig.UsageFlags |= FResourceBindFlags::StagingBuffer | FResourceBindFlags::SrcTransfer;
+
+    StagingBuffer = Renderer::Get().GetRenderInterface().Get()->CreateBuffer(BufferConfig);
+    StagingBufferAllocater.Init(NewSize);
+}
+
+void AsynchronousLoader::RetireTransferBatches()
+{
+    ICommandQueue* TransferQueue = Renderer::Get().GetRenderInterface().Get()->GetTransferQueue();
+
+    // Batches complete in submission order, stop at the first one still in flight
+    while (NumTransferBatchesInFlight > 0)
+    {
+        TextureTransferBatch& Batch = TransferBatches[OldestTransferBatch];
+        if (!TransferQueue->GetWaitFenceStatus(Batch.Fence))
         {
-            TextureUploadRequest URequest = { };
+            break;
+        }
+
+        StagingBufferAllocater.Release(Batch.StagingMarker);
 
-            URequest.Texture = LoadRequest.Texture;
-            URequest.CpuHandle = Handle;
-            URequest.Format = LoadRequest.Format;
+        TexturesReady.insert(TexturesReady.end(), Batch.Textures.begin(), Batch.Textures.end());
+        Batch.Textures.clear();
+
+        OldestTransferBatch = (OldestTransferBatch + 1) % TransferBatches.size();
+        NumTransferBatchesInFlight--;
+    }
+}
 
-            TextureUploadRequests.push_back(URequest);
+void AsynchronousLoader::FlushReadyTextures()
+{
+    uint32 NumTexturesFlushed = 0;
+    for (; NumTexturesFlushed < TexturesReady.size(); ++NumTexturesFlushed)
+    {
+        // Renderer is full for this frame, try again next update
+        if (!Renderer::Get().AddTextureToUpdate(TexturesReady[NumTexturesFlushed]))
+        {
+            break;
         }
     }
+
+    TexturesReady.erase(TexturesReady.begin(), TexturesReady.begin() + NumTexturesFlushed);
 }
 
 void AsynchronousLoader::Shutdown()
 {
+    if (TaskScheduler != nullptr && NumDecodeRequests != 0)
+    {
+        TaskScheduler->WaitforTask(&DecodeTaskSet);
+    }
+
+    for (uint32 i = 0; i < TransferBatches.size(); ++i)
+    {
+        delete TransferBatches[i].Fence;
+    }
+    TransferBatches.clear();
+
     delete TransferCompleteSemaphore;
-    delete TransferFence;
     //delete StagingBuffer;
+
+    TaskScheduler = nullptr;
+    TransferCompleteSemaphore = nullptr;
 }
 
-void AsynchronousLoader::RequestTextureData(const std::string& inFilePath, TextureHandle inTexture, EPixelFormat inTextureFormat)
+void AsynchronousLoader::RequestTextureData(const std::string& inFilePath, TextureHandle inTexture, EPixelFormat inTextureFormat, float inPriority, const FMipGenerationConfig& inMipConfig)
 {
     TextureLoadRequest LoadRequest = { };
     strcpy(LoadRequest.Path, inFilePath.c_str());
     LoadRequest.Texture = inTexture;
     LoadRequest.Format = inTextureFormat;
+    LoadRequest.Priority = inPriority;
+    LoadRequest.MipConfig = inMipConfig;
+
+    // The decode workers can split the mips across the other workers
+    if (LoadRequest.MipConfig.TaskScheduler == nullptr)
+    {
+        LoadRequest.MipConfig.TaskScheduler = TaskScheduler;
+    }
+
+    std::lock_guard<std::mutex> LockGuard(LoadRequestMutex);
 
     TextureLoadRequests.push_back(LoadRequest);
+    std::push_heap(TextureLoadRequests.begin(), TextureLoadRequests.end(), AsynchronousLoaderHelpers::CompareLoadPriority);
+}
+
+void AsynchronousLoader::SetTexturePriority(TextureHandle inTexture, float inPriority)
+{
+    {
+        std::lock_guard<std::mutex> LockGuard(LoadRequestMutex);
+
+        for (uint32 i = 0; i < TextureLoadRequests.size(); ++i)
+        {
+            if (TextureLoadRequests[i].Texture == inTexture)
+            {
+                TextureLoadRequests[i].Priority = inPriority;
+                std::make_heap(TextureLoadRequests.begin(), TextureLoadRequests.end(), AsynchronousLoaderHelpers::CompareLoadPriority);
+                return;
+            }
+        }
+    }
+
+    std::lock_guard<std::mutex> LockGuard(UploadRequestMutex);
+
+    for (uint32 i = 0; i < TextureUploadRequests.size(); ++i)
+    {
+        if (TextureUploadRequests[i].Texture == inTexture)
+        {
+            TextureUploadRequests[i].Priority = inPriority;
+            std::make_heap(TextureUploadRequests.begin(), TextureUploadRequests.end(), AsynchronousLoaderHelpers::CompareUploadPriority);
+            return;
+        }
+    }
+}
+
+bool AsynchronousLoader::CancelTextureRequest(TextureHandle inTexture)
+{
+    std::lock_guard<std::mutex> LoadLockGuard(LoadRequestMutex);
+
+    for (uint32 i = 0; i < TextureLoadRequests.size(); ++i)
+    {
+        if (TextureLoadRequests[i].Texture == inTexture)
+        {
+            TextureLoadRequests.erase(TextureLoadRequests.begin() + i);
+            std::make_heap(TextureLoadRequests.begin(), TextureLoadRequests.end(), AsynchronousLoaderHelpers::CompareLoadPriority);
+            return true;
+        }
+    }
+
+    // Held along with the load mutex: no worker can queue the texture between the searches below, and the next batch cannot reuse the decode requests
+    std::lock_guard<std::mutex> UploadLockGuard(UploadRequestMutex);
+
+    for (uint32 i = 0; i < TextureUploadRequests.size(); ++i)
+    {
+        if (TextureUploadRequests[i].Texture == inTexture)
+        {
+            AsynchronousLoaderHelpers::ReleaseDecodedTexture(TextureUploadRequests[i]);
+            TextureUploadRequests.erase(TextureUploadRequests.begin() + i);
+            std::make_heap(TextureUploadRequests.begin(), TextureUploadRequests.end(), AsynchronousLoaderHelpers::CompareUploadPriority);
+            return true;
+        }
+    }
+
+    // Being decoded right now, the worker sees the flag before it queues the texture and drops it
+    bool bIsCancelled = false;
+    for (uint32 i = 0; i < NumDecodeRequests; ++i)
+    {
+        if (DecodeRequests[i].LoadRequest.Texture == inTexture && !DecodeRequests[i].bIsQueued)
+        {
+            DecodeRequests[i].bIsCancelled = true;
+            bIsCancelled = true;
+        }
+    }
+
+    return bIsCancelled;
 }
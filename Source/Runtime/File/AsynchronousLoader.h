@@ -1,14 +1,28 @@
 #pragma once
 #include <Runtime/Graphics/Renderer.h>
 #include <Runtime/Memory/ResourceManager.h>
+#include <Runtime/File/FileReader.h>
+#include <Runtime/Memory/Core/Allocaters/RingBufferAllocater.h>
 
 #include <TaskScheduler.h>
+#include <External/ktx/Includes/ktx.h>
+
+#include <atomic>
+#include <mutex>
 
 struct TextureLoadRequest
 {
     char Path[512];
     TextureHandle Texture = InvalidTextureHandle;
+
+    /** Ignored for ktx files, they carry their own format */
     EPixelFormat Format = EPixelFormat::Undefined;
+
+    /** Higher priority requests are loaded first (ex: screen size or inverse distance to the camera) */
+    float Priority = 0.0f;
+
+    /** How the mip chain gets generated once decoded */
+    FMipGenerationConfig MipConfig = { };
 };
 
 struct TextureUploadRequest
@@ -16,10 +30,89 @@ struct TextureUploadRequest
     TextureHandle Texture = InvalidTextureHandle;
     EPixelFormat Format = EPixelFormat::Undefined;
     TextureResourceHandle CpuHandle = { };
+
+    /** Set for ktx files in place of CpuHandle, holds the (inflated) image data of every mip and face */
+    ktxTexture* KtxTextureHandle = nullptr;
+
+    /** Used to free the decoded texture once it has been copied to the staging buffer */
+    std::string Path;
+
+    float Priority = 0.0f;
 };
 
+/**
+* A load request whose file has been mapped by the loader thread and is waiting to be decoded by a worker
+*/
+struct TextureDecodeRequest
+{
+    TextureLoadRequest LoadRequest = { };
+
+    /** The memory mapped image file, released once decoded */
+    TUniquePtr<FileReader> Reader;
+
+    /** Set when the request gets cancelled while it is being decoded */
+    std::atomic_bool bIsCancelled { false };
+
+    /** Set (under the upload mutex) once the decoded texture is in the upload queue, from then on cancelling removes it from there */
+    bool bIsQueued = false;
+};
+
+/**
+* One transfer submission, its staging memory is released once its fence signals
+*/
+struct TextureTransferBatch
+{
+    ICommandBuffer* CommandBuffer = nullptr;
+    IFence* Fence = nullptr;
+
+    /** Staging ring position after this batch's allocations */
+    RingBufferAllocater::Marker StagingMarker = 0;
+
+    /** Textures recorded in this batch, ready once the fence signals */
+    std::vector<TextureHandle> Textures;
+};
+
+/**
+* Decodes a batch of mapped texture files across the task scheduler worker threads
+*/
+struct TextureDecodeTaskSet : enki::ITaskSet
+{
+    void ExecuteRange(enki::TaskSetPartition inRange, uint32_t inThreadNum) override;
+
+    class AsynchronousLoader* Loader = nullptr;
+};
+
+/**
+* Streams textures in a staged pipeline:
+*   file read (mapped on the loader thread) -> decode (worker threads) -> batched upload (transfer queue)
+*
+* Images are decoded with stb, ktx/ktx2 files (2d or cubemap) are loaded with libktx,
+* zstd supercompressed ktx2 files are inflated on the worker that decodes them
+*
+* @note RequestTextureData(), SetTexturePriority() and CancelTextureRequest() can be called from any thread
+*/
 class AsynchronousLoader
 {
+    friend struct TextureDecodeTaskSet;
+public:
+    /** Max number of files read and sent to the decode workers at once */
+    static const uint32 MAX_DECODE_REQUESTS_PER_TICK = 32;
+
+    /** Max number of textures recorded into one transfer submission */
+    static const uint32 MAX_UPLOAD_REQUESTS_PER_TICK = 32;
+
+    /** Default size of the staging ring buffer, memory is recycled as transfers complete */
+    static const uint64 DEFAULT_STAGING_BUFFER_SIZE = MEBIBYTES_TO_BYTES(64);
+
+    /**
+    * The staging ring grows (up to this size) when a texture bigger than it arrives, a texture is staged in one piece
+    *   (ex: a 4K RGBA8 texture with its mips is ~85 MiB). Textures bigger than this are dropped with an error
+    */
+    static const uint64 MAX_STAGING_BUFFER_SIZE = MEBIBYTES_TO_BYTES(1024);
+
+    /** Alignment of each texture in the staging buffer, satisfies buffer to image copies of every format we upload */
+    static const uint64 STAGING_BUFFER_ALIGNMENT = 16;
+
 public:
     /**
     * Call Destructor ONLY when you allocate this class dynamically...
@@ -28,27 +121,89 @@ public:
     {
         Shutdown();
     }
-    void Init(enki::TaskScheduler* inTaskScheduler);
+    /**
+    * @param inStagingBufferSize initial size of the staging ring buffer, has to be a multiple of STAGING_BUFFER_ALIGNMENT.
+    *   It grows if a texture does not fit, see MAX_STAGING_BUFFER_SIZE
+    */
+    void Init(enki::TaskScheduler* inTaskScheduler, uint64 inStagingBufferSize = DEFAULT_STAGING_BUFFER_SIZE);
     void Update();
     void Shutdown();
 
-    void RequestTextureData(const std::string& inFilePath, TextureHandle inTexture, EPixelFormat inTextureFormat);
+    /**
+    * Queues a texture to be streamed in
+    *
+    * @param inTextureFormat format of the decoded image, ktx files use the format stored in the file instead
+    * @param inPriority higher priority requests are loaded first
+    * @param inMipConfig how the mip chain is generated, set MaxMipLevels to 1 to only load mip 0
+    */
+    void RequestTextureData(const std::string& inFilePath, TextureHandle inTexture, EPixelFormat inTextureFormat, float inPriority = 0.0f, const FMipGenerationConfig& inMipConfig = FMipGenerationConfig());
+
+    /**
+    * Changes the priority of a texture that has not yet been decoded or uploaded
+    */
+    void SetTexturePriority(TextureHandle inTexture, float inPriority);
+
+    /**
+    * Cancels a pending request, textures already submitted to the transfer queue cannot be cancelled
+    *
+    * @returns bool true if the request was found and cancelled
+    */
+    bool CancelTextureRequest(TextureHandle inTexture);
+
+private:
+    /** Stage 1: map the highest priority files and kick the decode workers */
+    void ReadFiles();
+
+    /** Stage 2: (worker threads) decode a mapped file and queue it for upload */
+    void DecodeTexture(TextureDecodeRequest& inDecodeRequest);
+
+    /** Stage 2 for ktx files, libktx inflates supercompressed mip levels while loading */
+    bool DecodeKtxTexture(const TextureDecodeRequest& inDecodeRequest, TextureUploadRequest& outUploadRequest);
+
+    /** Records the copy of one decoded texture out of the staging buffer */
+    void RecordTextureUpload(ICommandBuffer* inCommandBuffer, const TextureUploadRequest& inRequest, uint64 inStagingOffset);
+
+    /** Stage 3: record all decoded textures (that fit) into one transfer submission */
+    void UploadTextures();
+
+    /** Releases the staging memory of completed submissions, oldest first */
+    void RetireTransferBatches();
+
+    /**
+    * Replaces the staging buffer with a bigger one, nothing can be using the current one
+    *
+    * @param inMinSize size the new buffer needs at least, it at least doubles
+    */
+    void GrowStagingBuffer(uint64 inMinSize);
+
+    /** Passes textures whose transfer has completed to the renderer */
+    void FlushReadyTextures();
 
 private:
     enki::TaskScheduler* TaskScheduler;
 
+    /** Max-heaps ordered by priority */
     std::vector<TextureLoadRequest> TextureLoadRequests;
     std::vector<TextureUploadRequest> TextureUploadRequests;
 
-    std::vector<ICommandBuffer*>  CommandBuffers;
+    std::mutex LoadRequestMutex;
+    std::mutex UploadRequestMutex;
+
+    /** The batch currently being decoded by the workers */
+    TextureDecodeRequest DecodeRequests[MAX_DECODE_REQUESTS_PER_TICK];
+    uint32 NumDecodeRequests;
+    TextureDecodeTaskSet DecodeTaskSet;
+
+    /** Ring of transfer submissions, more than one can be in flight */
+    std::vector<TextureTransferBatch> TransferBatches;
+    uint32 OldestTransferBatch;
+    uint32 NumTransferBatchesInFlight;
 
     ISemaphore* TransferCompleteSemaphore;
-    IFence* TransferFence;
 
     Buffer* StagingBuffer;
-    std::atomic_size_t StagingBufferOffset;
-    uint64 StagingBufferSize;
+    RingBufferAllocater StagingBufferAllocater;
 
     /** Ready Resources */
-    TextureHandle TextureReady;
+    std::vector<TextureHandle> TexturesReady;
 };
@@ -0,0 +1,378 @@
+/**
+* This file is part of the "Vrixic Engine" project (Copyright (c) 2022-2023 by Vrij Patel)
+* See "LICENSE.txt" for license information.
+*/
+
+#include "DerivedDataCache.h"
+#include <Misc/Assert.h>
+#include <Misc/Defines/StringDefines.h>
+
+#include <atomic>
+#include <stdio.h>
+
+#if defined(_WIN64) || defined(_WIN32)
+#include <windows.h>
+#else
+#include <sys/stat.h>
+#endif
+
+namespace DerivedDataCacheHelpers
+{
+    static constexpr uint32 ENTRY_MAGIC = 0x43444456; // 'VDDC'
+    static constexpr uint32 INDEX_MAGIC = 0x49444456; // 'VDDI'
+    static constexpr uint32 FORMAT_VERSION = 1;
+
+    static constexpr const char INDEX_FILE_NAME[] = "Index.ddi";
+
+    /** Key passed to EvictEntries() when no entry has to be kept */
+    static constexpr uint64 NO_KEY_TO_KEEP = UINT64_MAX;
+
+    /**
+    * Written in front of the data of every entry, lets a reader reject files that were
+    * truncated, written by an older format or copied in under the wrong name
+    */
+    struct FEntryHeader
+    {
+        uint32 Magic;
+        uint32 Version;
+        uint64 Key;
+        uint64 DataSizeInBytes;
+        uint64 DataHash;
+    };
+
+    struct FIndexHeader
+    {
+        uint32 Magic;
+        uint32 Version;
+        uint64 NumEntries;
+        uint64 AccessClock;
+    };
+
+    struct FIndexEntry
+    {
+        uint64 Key;
+        uint64 SizeInBytes;
+        uint64 LastAccess;
+    };
+
+    static void CreateFolder(const std::string& inFolderPath)
+    {
+#if defined(_WIN64) || defined(_WIN32)
+        CreateDirectoryA(inFolderPath.c_str(), NULL);
+#else
+        mkdir(inFolderPath.c_str(), 0755);
+#endif
+    }
+
+    /** Replaces inDestination with inSource, both have to be on the same drive */
+    static bool MoveFileOver(const std::string& inSource, const std::string& inDestination)
+    {
+#if defined(_WIN64) || defined(_WIN32)
+        return MoveFileExA(inSource.c_str(), inDestination.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+        return rename(inSource.c_str(), inDestination.c_str()) == 0;
+#endif
+    }
+}
+
+using namespace DerivedDataCacheHelpers;
+
+/* ------------------------------------------------------------------------------- */
+/* ------------------------      FDerivedDataKeyBuilder     ---------------------- */
+/* ------------------------------------------------------------------------------- */
+
+bool FDerivedDataKeyBuilder::AppendFile(const std::string& inFilePath)
+{
+    FFileReaderConfig ReaderConfig = { };
+    ReaderConfig.Mode = EFileReadMode::MemoryMapped;
+    ReaderConfig.AccessHint = EFileAccessHint::Sequential;
+
+    FileReader Reader(inFilePath, ReaderConfig);
+    if (!Reader.IsOpen())
+    {
+        return false;
+    }
+
+    FFileSpan Span = Reader.GetSpan();
+    Append(Span.Data, Span.Size);
+
+    return true;
+}
+
+/* ------------------------------------------------------------------------------- */
+/* --------------------------      DerivedDataCache      ------------------------- */
+/* ------------------------------------------------------------------------------- */
+
+DerivedDataCache::DerivedDataCache()
+    : bIsActive(false), TotalSizeInBytes(0), AccessClock(0) { }
+
+void DerivedDataCache::Init(void* inConfig)
+{
+    VE_ASSERT(!bIsActive, VE_TEXT("[DerivedDataCache]: Derived data cache should only be initialized once..."));
+
+    Config = inConfig != nullptr ? *(FDerivedDataCacheConfig*)inConfig : FDerivedDataCacheConfig();
+    if (Config.CacheFolder.size() > 0 && Config.CacheFolder.back() != '/' && Config.CacheFolder.back() != '\\')
+    {
+        Config.CacheFolder += '/';
+    }
+
+    CreateFolder(Config.CacheFolder);
+    LoadIndex();
+
+    {
+        std::lock_guard<std::mutex> Lock(Mutex);
+        EvictEntries(NO_KEY_TO_KEEP);
+    }
+
+    bIsActive = true;
+
+    VE_CORE_LOG_INFO(VE_TEXT("[DerivedDataCache]: {0} entries, {1} MiB in {2}"), Entries.size(), (TotalSizeInBytes >> 20), Config.CacheFolder);
+}
+
+void DerivedDataCache::Shutdown()
+{
+    if (!bIsActive)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> Lock(Mutex);
+    SaveIndex();
+
+    Entries.clear();
+    AccessOrder.clear();
+    TotalSizeInBytes = 0;
+    bIsActive = false;
+}
+
+bool DerivedDataCache::Get(uint64 inKey, FDerivedData& outData)
+{
+    if (!bIsActive)
+    {
+        return false;
+    }
+
+    const std::string EntryPath = GetEntryPath(inKey);
+
+    FFileReaderConfig ReaderConfig = { };
+    ReaderConfig.Mode = EFileReadMode::MemoryMapped;
+    ReaderConfig.AccessHint = EFileAccessHint::WillNeed;
+
+    std::unique_ptr<FileReader> Reader(new FileReader(EntryPath, ReaderConfig));
+    if (!Reader->IsOpen())
+    {
+        std::lock_guard<std::mutex> Lock(Mutex);
+        RemoveEntry(inKey);
+        return false;
+    }
+
+    FFileSpan Span = Reader->GetSpan();
+
+    FEntryHeader Header = { };
+    bool bIsValid = Span.Size >= sizeof(FEntryHeader);
+    if (bIsValid)
+    {
+        memcpy(&Header, Span.Data, sizeof(FEntryHeader));
+        bIsValid = Header.Magic == ENTRY_MAGIC && Header.Version == FORMAT_VERSION && Header.Key == inKey
+            && Header.DataSizeInBytes == Span.Size - sizeof(FEntryHeader)
+            && Header.DataHash == XXHash64::Hash(Span.Data + sizeof(FEntryHeader), Header.DataSizeInBytes);
+    }
+
+    if (!bIsValid)
+    {
+        VE_CORE_LOG_WARN(VE_TEXT("[DerivedDataCache]: Discarding corrupt entry {0}"), EntryPath);
+
+        Reader->Close();
+        Remove(inKey);
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> Lock(Mutex);
+        TouchEntry(inKey, Span.Size);
+    }
+
+    outData.Data = Reader->GetSpan(sizeof(FEntryHeader), Header.DataSizeInBytes);
+    outData.Reader = std::move(Reader);
+
+    return true;
+}
+
+bool DerivedDataCache::Put(uint64 inKey, const void* inData, uint64 inSizeInBytes)
+{
+    if (!bIsActive)
+    {
+        return false;
+    }
+
+    static std::atomic<uint32> TempFileCounter(0);
+
+    // Written to a temporary file first so that readers (other processes too) never see a half written entry
+    const std::string EntryPath = GetEntryPath(inKey);
+    const std::string TempPath = EntryPath + "." + std::to_string(TempFileCounter.fetch_add(1)) + ".tmp";
+
+    FILE* File = fopen(TempPath.c_str(), "wb");
+    if (File == nullptr)
+    {
+        VE_CORE_LOG_ERROR(VE_TEXT("[DerivedDataCache]: Failed to create {0}"), TempPath);
+        return false;
+    }
+
+    FEntryHeader Header = { };
+    Header.Magic = ENTRY_MAGIC;
+    Header.Version = FORMAT_VERSION;
+    Header.Key = inKey;
+    Header.DataSizeInBytes = inSizeInBytes;
+    Header.DataHash = XXHash64::Hash(inData, inSizeInBytes);
+
+    bool bWasWritten = fwrite(&Header, sizeof(FEntryHeader), 1, File) == 1;
+    bWasWritten &= inSizeInBytes == 0 || fwrite(inData, inSizeInBytes, 1, File) == 1;
+    bWasWritten &= fclose(File) == 0;
+
+    if (!bWasWritten || !MoveFileOver(TempPath, EntryPath))
+    {
+        // The entry is likely mapped by a reader right now, the existing entry stays valid
+        remove(TempPath.c_str());
+        return false;
+    }
+
+    std::lock_guard<std::mutex> Lock(Mutex);
+    TouchEntry(inKey, sizeof(FEntryHeader) + inSizeInBytes);
+    EvictEntries(inKey);
+
+    return true;
+}
+
+void DerivedDataCache::Remove(uint64 inKey)
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    RemoveEntry(inKey);
+    remove(GetEntryPath(inKey).c_str());
+}
+
+std::string DerivedDataCache::GetEntryPath(uint64 inKey) const
+{
+    char FileName[32];
+    snprintf(FileName, sizeof(FileName), "%016llx.ddc", (unsigned long long)inKey);
+
+    return Config.CacheFolder + FileName;
+}
+
+void DerivedDataCache::TouchEntry(uint64 inKey, uint64 inSizeInBytes)
+{
+    RemoveEntry(inKey);
+
+    FEntry Entry = { };
+    Entry.SizeInBytes = inSizeInBytes;
+    Entry.LastAccess = ++AccessClock;
+
+    Entries[inKey] = Entry;
+    AccessOrder[Entry.LastAccess] = inKey;
+    TotalSizeInBytes += inSizeInBytes;
+}
+
+void DerivedDataCache::RemoveEntry(uint64 inKey)
+{
+    auto It = Entries.find(inKey);
+    if (It == Entries.end())
+    {
+        return;
+    }
+
+    TotalSizeInBytes -= It->second.SizeInBytes;
+    AccessOrder.erase(It->second.LastAccess);
+    Entries.erase(It);
+}
+
+void DerivedDataCache::EvictEntries(uint64 inKeyToKeep)
+{
+    auto It = AccessOrder.begin();
+    while (TotalSizeInBytes > Config.MaxSizeInBytes && It != AccessOrder.end())
+    {
+        const uint64 Key = It->second;
+        ++It;
+
+        if (Key == inKeyToKeep)
+        {
+            continue;
+        }
+
+        RemoveEntry(Key);
+        remove(GetEntryPath(Key).c_str());
+    }
+}
+
+void DerivedDataCache::LoadIndex()
+{
+    FFileReaderConfig ReaderConfig = { };
+    ReaderConfig.Mode = EFileReadMode::MemoryMapped;
+
+    FileReader Reader(Config.CacheFolder + INDEX_FILE_NAME, ReaderConfig);
+    if (!Reader.IsOpen())
+    {
+        return;
+    }
+
+    FFileSpan Span = Reader.GetSpan();
+    if (Span.Size < sizeof(FIndexHeader))
+    {
+        return;
+    }
+
+    FIndexHeader Header = { };
+    memcpy(&Header, Span.Data, sizeof(FIndexHeader));
+    if (Header.Magic != INDEX_MAGIC || Header.Version != FORMAT_VERSION
+        || Span.Size < sizeof(FIndexHeader) + Header.NumEntries * sizeof(FIndexEntry))
+    {
+        VE_CORE_LOG_WARN(VE_TEXT("[DerivedDataCache]: Ignoring out of date index in {0}"), Config.CacheFolder);
+        return;
+    }
+
+    std::lock_guard<std::mutex> Lock(Mutex);
+
+    const FIndexEntry* IndexEntries = (const FIndexEntry*)(Span.Data + sizeof(FIndexHeader));
+    for (uint64 i = 0; i < Header.NumEntries; ++i)
+    {
+        FEntry Entry = { };
+        Entry.SizeInBytes = IndexEntries[i].SizeInBytes;
+        Entry.LastAccess = IndexEntries[i].LastAccess;
+
+        Entries[IndexEntries[i].Key] = Entry;
+        AccessOrder[Entry.LastAccess] = IndexEntries[i].Key;
+        TotalSizeInBytes += Entry.SizeInBytes;
+    }
+
+    AccessClock = Header.AccessClock;
+}
+
+void DerivedDataCache::SaveIndex() const
+{
+    const std::string IndexPath = Config.CacheFolder + INDEX_FILE_NAME;
+    const std::string TempPath = IndexPath + ".tmp";
+
+    FILE* File = fopen(TempPath.c_str(), "wb");
+    if (File == nullptr)
+    {
+        VE_CORE_LOG_ERROR(VE_TEXT("[DerivedDataCache]: Failed to write the index to {0}"), IndexPath);
+        return;
+    }
+
+    FIndexHeader Header = { };
+    Header.Magic = INDEX_MAGIC;
+    Header.Version = FORMAT_VERSION;
+    Header.NumEntries = Entries.size();
+    Header.AccessClock = AccessClock;
+    fwrite(&Header, sizeof(FIndexHeader), 1, File);
+
+    for (const auto& It : Entries)
+    {
+        FIndexEntry IndexEntry = { };
+        IndexEntry.Key = It.first;
+        IndexEntry.SizeInBytes = It.second.SizeInBytes;
+        IndexEntry.LastAccess = It.second.LastAccess;
+        fwrite(&IndexEntry, sizeof(FIndexEntry), 1, File);
+    }
+
+    fclose(File);
+    MoveFileOver(TempPath, IndexPath);
+}
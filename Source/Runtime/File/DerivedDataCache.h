@@ -0,0 +1,205 @@
+/**
+* This file is part of the "Vrixic Engine" project (Copyright (c) 2022-2023 by Vrij Patel)
+* See "LICENSE.txt" for license information.
+*/
+
+#pragma once
+#include <Core/Misc/IManager.h>
+#include <Misc/Defines/GenericDefines.h>
+#include <Runtime/Core/Algorithms/Hashing/XXHash64.h>
+#include <Runtime/Memory/Core/MemoryUtils.h>
+#include "FileReader.h"
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+
+struct FDerivedDataCacheConfig
+{
+public:
+    /** Folder the entries are stored in, can be shared between machines (ex: a network drive) */
+    std::string CacheFolder = "../Assets/DerivedDataCache/";
+
+    /** Once the entries take up more than this the least recently used ones are deleted */
+    uint64 MaxSizeInBytes = MEBIBYTES_TO_BYTES(2048);
+};
+
+/**
+* Builds a derived data cache key out of everything that affects the derived data:
+*   the bucket name and version of the tool producing it, the inputs and the options used
+*
+* Bump the version whenever the tool changes its output, old entries then simply stop being hit and age out of the cache
+*/
+class VRIXIC_API FDerivedDataKeyBuilder
+{
+public:
+    /**
+    * @param inBucket - name of the kind of data being cached (ex: "SpirV"), keeps different tools from colliding
+    * @param inVersion - version of the tool producing the data
+    */
+    FDerivedDataKeyBuilder(const char* inBucket, uint32 inVersion)
+    {
+        Key = XXHash64::Hash(inBucket, strlen(inBucket));
+        Key = XXHash64::Hash(&inVersion, sizeof(uint32), Key);
+    }
+
+    FDerivedDataKeyBuilder& Append(const void* inData, uint64 inSizeInBytes)
+    {
+        // Hash the size as well so ("ab", "c") and ("a", "bc") produce different keys
+        Key = XXHash64::Hash(&inSizeInBytes, sizeof(uint64), Key);
+        Key = XXHash64::Hash(inData, inSizeInBytes, Key);
+        return *this;
+    }
+
+    FDerivedDataKeyBuilder& Append(const std::string& inString)
+    {
+        return Append(inString.data(), inString.size());
+    }
+
+    template<typename T>
+    FDerivedDataKeyBuilder& AppendValue(const T& inValue)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "[FDerivedDataKeyBuilder]: Only plain data can be appended by value");
+        return Append(&inValue, sizeof(T));
+    }
+
+    /**
+    * Appends the contents of a file, the file is memory mapped while being hashed
+    *
+    * @returns bool false if the file could not be opened, the key is left untouched
+    */
+    bool AppendFile(const std::string& inFilePath);
+
+    inline uint64 GetKey() const
+    {
+        return Key;
+    }
+
+private:
+    uint64 Key;
+};
+
+/**
+* A read only view of a cache entry, the entry stays mapped until this goes out of scope
+*/
+struct VRIXIC_API FDerivedData
+{
+public:
+    std::unique_ptr<FileReader> Reader;
+
+    /** The cached bytes, does not include the entry header */
+    FFileSpan Data;
+
+public:
+    inline bool IsValid() const
+    {
+        return Reader != nullptr && Data.IsValid();
+    }
+};
+
+/**
+* Content addressed store for expensive derived data (compiled shaders, pipeline caches, baked textures...)
+*
+* Every entry is its own file named after its key, reads memory map the file so cache hits are not copied.
+* Keys are found on disk even if the index does not know about them yet, which lets several machines share the folder.
+* The index only tracks sizes and last access times, used to delete the least recently used entries once over the size limit.
+*
+* @note thread safe
+*/
+class VRIXIC_API DerivedDataCache : public IManager
+{
+public:
+    VRIXIC_STATIC_MANAGER(DerivedDataCache)
+
+public:
+    DerivedDataCache();
+
+    /**
+    * @param inConfig - FDerivedDataCacheConfig*, defaults are used if nullptr
+    */
+    virtual void Init(void* inConfig = nullptr) override;
+
+    /**
+    * Writes out the index, the entries stay on disk
+    */
+    virtual void Shutdown() override;
+
+    /**
+    * Looks up an entry
+    *
+    * @param outData - mapped view of the entry when found
+    * @returns bool true if the entry exists and is not corrupt
+    */
+    bool Get(uint64 inKey, FDerivedData& outData);
+
+    /**
+    * Stores an entry, replacing any previous entry with the same key
+    *
+    * @returns bool false if the entry could not be written
+    */
+    bool Put(uint64 inKey, const void* inData, uint64 inSizeInBytes);
+
+    /**
+    * Deletes an entry if it exists
+    */
+    void Remove(uint64 inKey);
+
+public:
+    inline bool IsActive() const
+    {
+        return bIsActive;
+    }
+
+    /**
+    * @returns uint64 size in bytes of all the entries known by the index
+    */
+    inline uint64 GetSizeInBytes() const
+    {
+        return TotalSizeInBytes;
+    }
+
+private:
+    struct FEntry
+    {
+        /** Size of the entry file including its header */
+        uint64 SizeInBytes;
+
+        /** Value of AccessClock when the entry was last read or written */
+        uint64 LastAccess;
+    };
+
+    std::string GetEntryPath(uint64 inKey) const;
+
+    /** Adds or refreshes an entry in the index, expects the mutex to be held */
+    void TouchEntry(uint64 inKey, uint64 inSizeInBytes);
+
+    /** Removes an entry from the index, expects the mutex to be held */
+    void RemoveEntry(uint64 inKey);
+
+    /** Deletes least recently used entries until under the size limit, never deletes inKeyToKeep. Expects the mutex to be held */
+    void EvictEntries(uint64 inKeyToKeep);
+
+    void LoadIndex();
+    void SaveIndex() const;
+
+private:
+    FDerivedDataCacheConfig Config;
+
+    bool bIsActive;
+
+    /** Key -> Entry */
+    std::unordered_map<uint64, FEntry> Entries;
+
+    /** LastAccess -> Key, oldest first */
+    std::map<uint64, uint64> AccessOrder;
+
+    uint64 TotalSizeInBytes;
+
+    /** Incremented on every access, orders the entries without needing timestamps */
+    uint64 AccessClock;
+
+    std::mutex Mutex;
+};
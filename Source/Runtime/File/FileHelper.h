@@ -8,6 +8,7 @@
 #include <Misc/Assert.h>
 
 #include <string>
+#include <vector>
 
 #if defined(_WIN64)
 #include <windows.h>
@@ -134,6 +135,46 @@ public:
 #endif // _WIN64
     }
 
+    /**
+    * Lists the files inside of a folder[directory] and all of its sub folders, only Window Supported
+    *
+    * @param inFolderPath - path to the folder, has to end with a slash
+    * @param outFilePaths - the paths of the files found are appended to this
+    */
+    static void GetFilesInFolder(const std::string& inFolderPath, std::vector<std::string>& outFilePaths)
+    {
+#if defined(_WIN64)
+        WIN32_FIND_DATAA FindData;
+        HANDLE FindHandle = FindFirstFileA((inFolderPath + "*").c_str(), &FindData);
+        if (FindHandle == INVALID_HANDLE_VALUE)
+        {
+            return;
+        }
+
+        do
+        {
+            if (strcmp(FindData.cFileName, ".") == 0 || strcmp(FindData.cFileName, "..") == 0)
+            {
+                continue;
+            }
+
+            std::string Path = inFolderPath + FindData.cFileName;
+            if (FindData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+            {
+                GetFilesInFolder(Path + "/", outFilePaths);
+            }
+            else
+            {
+                outFilePaths.push_back(Path);
+            }
+        } while (FindNextFileA(FindHandle, &FindData));
+
+        FindClose(FindHandle);
+#else
+        VE_STATIC_ASSERT(false, VE_TEXT("[FileHelper]: Only windows folder supported..."));
+#endif // _WIN64
+    }
+
     /**
     * Deletes a folder[directory], only Window Supported
     */
@@ -0,0 +1,389 @@
+/**
+* This file is part of the "Vrixic Engine" project (Copyright (c) 2022-2023 by Vrij Patel)
+* See "LICENSE.txt" for license information.
+*/
+
+#include "FileReader.h"
+#include <Misc/Assert.h>
+#include <Misc/Defines/StringDefines.h>
+
+#include <algorithm>
+
+#if defined(_WIN64) || defined(_WIN32)
+#include <windows.h>
+#include <malloc.h>
+#else
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+FileReader::FileReader(std::string inPath, const FFileReaderConfig& inConfig)
+    : Path(inPath), SizeInBytes(0), Mode(inConfig.Mode), NativeHandle(-1), MappingHandle(nullptr),
+    MappedData(nullptr), ChunkBuffer(nullptr), ChunkBufferSize(0), StreamOffset(0), Flags(inConfig.Flags)
+{
+    switch (Mode)
+    {
+    case EFileReadMode::MemoryMapped:
+        OpenMapped(inConfig);
+        break;
+    case EFileReadMode::Streamed:
+        OpenStreamed(inConfig);
+        break;
+    case EFileReadMode::Buffered:
+    {
+        Handle = { };
+        Handle.open(inPath);
+
+        // Get the size of the file, tellg() returns -1 if the file could not be opened
+        SeekEnd(0);
+        SizeInBytes = Handle.is_open() ? Tell() : 0;
+        SeekBegin(0);
+        break;
+    }
+    }
+}
+
+uint64 FileReader::GetPageSize()
+{
+    static uint64 PageSize = 0;
+    if (PageSize == 0)
+    {
+#if defined(_WIN64) || defined(_WIN32)
+        SYSTEM_INFO SystemInfo = { };
+        GetSystemInfo(&SystemInfo);
+        PageSize = SystemInfo.dwPageSize;
+#else
+        PageSize = static_cast<uint64>(sysconf(_SC_PAGESIZE));
+#endif
+    }
+
+    return PageSize;
+}
+
+void FileReader::OpenMapped(const FFileReaderConfig& inConfig)
+{
+#if defined(_WIN64) || defined(_WIN32)
+    DWORD FileFlags = FILE_ATTRIBUTE_NORMAL;
+    FileFlags |= inConfig.AccessHint == EFileAccessHint::Random ? FILE_FLAG_RANDOM_ACCESS : FILE_FLAG_SEQUENTIAL_SCAN;
+
+    HANDLE FileHandle = CreateFileA(Path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FileFlags, NULL);
+    if (FileHandle == INVALID_HANDLE_VALUE)
+    {
+        return;
+    }
+
+    NativeHandle = (intptr)FileHandle;
+
+    LARGE_INTEGER FileSize = { };
+    GetFileSizeEx(FileHandle, &FileSize);
+    SizeInBytes = static_cast<uint64>(FileSize.QuadPart);
+
+    // Empty files cannot be mapped, the reader is still considered open
+    if (SizeInBytes == 0)
+    {
+        return;
+    }
+
+    HANDLE Mapping = CreateFileMappingA(FileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (Mapping == NULL)
+    {
+        VE_CORE_LOG_ERROR(VE_TEXT("[FileReader]: Failed to create file mapping for {0}"), Path);
+        return;
+    }
+
+    MappingHandle = Mapping;
+    MappedData = (uint8*)MapViewOfFile(Mapping, FILE_MAP_READ, 0, 0, 0);
+#else
+    int32 FileDescriptor = open(Path.c_str(), O_RDONLY);
+    if (FileDescriptor < 0)
+    {
+        return;
+    }
+
+    NativeHandle = FileDescriptor;
+
+    struct stat FileStats = { };
+    fstat(FileDescriptor, &FileStats);
+    SizeInBytes = static_cast<uint64>(FileStats.st_size);
+
+    if (SizeInBytes == 0)
+    {
+        return;
+    }
+
+    void* Mapping = mmap(nullptr, SizeInBytes, PROT_READ, MAP_PRIVATE, FileDescriptor, 0);
+    MappedData = Mapping != MAP_FAILED ? (uint8*)Mapping : nullptr;
+#endif
+
+    if (MappedData == nullptr)
+    {
+        VE_CORE_LOG_ERROR(VE_TEXT("[FileReader]: Failed to map view of file {0}"), Path);
+        return;
+    }
+
+    SetAccessHint(inConfig.AccessHint);
+}
+
+void FileReader::OpenStreamed(const FFileReaderConfig& inConfig)
+{
+    const uint64 PageSize = GetPageSize();
+
+#if defined(_WIN64) || defined(_WIN32)
+    DWORD FileFlags = FILE_ATTRIBUTE_NORMAL;
+    FileFlags |= inConfig.AccessHint == EFileAccessHint::Random ? FILE_FLAG_RANDOM_ACCESS : FILE_FLAG_SEQUENTIAL_SCAN;
+    if (inConfig.Flags & FFileReadFlags::Unbuffered)
+    {
+        FileFlags |= FILE_FLAG_NO_BUFFERING;
+    }
+
+    HANDLE FileHandle = CreateFileA(Path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FileFlags, NULL);
+    if (FileHandle == INVALID_HANDLE_VALUE)
+    {
+        return;
+    }
+
+    NativeHandle = (intptr)FileHandle;
+
+    LARGE_INTEGER FileSize = { };
+    GetFileSizeEx(FileHandle, &FileSize);
+    SizeInBytes = static_cast<uint64>(FileSize.QuadPart);
+#else
+    int32 OpenFlags = O_RDONLY;
+#if defined(O_DIRECT)
+    if (inConfig.Flags & FFileReadFlags::Unbuffered)
+    {
+        OpenFlags |= O_DIRECT;
+    }
+#endif
+
+    int32 FileDescriptor = open(Path.c_str(), OpenFlags);
+    if (FileDescriptor < 0)
+    {
+        return;
+    }
+
+    NativeHandle = FileDescriptor;
+
+    struct stat FileStats = { };
+    fstat(FileDescriptor, &FileStats);
+    SizeInBytes = static_cast<uint64>(FileStats.st_size);
+#endif
+
+    // Unbuffered reads require the buffer, offsets and sizes to be multiples of the sector size, page size covers that
+    ChunkBufferSize = std::max<uint64>(inConfig.ChunkSize, PageSize);
+    ChunkBufferSize = (ChunkBufferSize + PageSize - 1) & ~(PageSize - 1);
+
+#if defined(_WIN64) || defined(_WIN32)
+    ChunkBuffer = (uint8*)_aligned_malloc(ChunkBufferSize, PageSize);
+#else
+    void* AlignedBuffer = nullptr;
+    ChunkBuffer = posix_memalign(&AlignedBuffer, PageSize, ChunkBufferSize) == 0 ? (uint8*)AlignedBuffer : nullptr;
+#endif
+
+    VE_ASSERT(ChunkBuffer != nullptr, VE_TEXT("[FileReader]: Failed to allocate chunk buffer of size {0}"), ChunkBufferSize);
+
+    SetAccessHint(inConfig.AccessHint);
+}
+
+FFileSpan FileReader::GetSpan(uint64 inOffset, uint64 inSize) const
+{
+    VE_ASSERT(Mode == EFileReadMode::MemoryMapped, VE_TEXT("[FileReader]: GetSpan() is only valid for memory mapped files..."));
+
+    FFileSpan Span = { };
+    if (MappedData == nullptr || inOffset >= SizeInBytes)
+    {
+        return Span;
+    }
+
+    Span.Data = MappedData + inOffset;
+    Span.Size = std::min<uint64>(inSize, SizeInBytes - inOffset);
+    Span.FileOffset = inOffset;
+
+    return Span;
+}
+
+FFileSpan FileReader::ReadChunk()
+{
+    VE_ASSERT(Mode == EFileReadMode::Streamed, VE_TEXT("[FileReader]: ReadChunk() is only valid for streamed files..."));
+
+    FFileSpan Span = { };
+    if (NativeHandle == -1 || ChunkBuffer == nullptr || StreamOffset >= SizeInBytes)
+    {
+        return Span;
+    }
+
+    uint64 BytesRead = 0;
+
+#if defined(_WIN64) || defined(_WIN32)
+    OVERLAPPED Overlapped = { };
+    Overlapped.Offset = static_cast<DWORD>(StreamOffset & 0xffffffff);
+    Overlapped.OffsetHigh = static_cast<DWORD>(StreamOffset >> 32);
+
+    // The full chunk is always requested so unbuffered reads stay sector aligned, the last chunk reads short
+    DWORD NumBytesRead = 0;
+    if (!ReadFile((HANDLE)NativeHandle, ChunkBuffer, static_cast<DWORD>(ChunkBufferSize), &NumBytesRead, &Overlapped))
+    {
+        VE_CORE_LOG_ERROR(VE_TEXT("[FileReader]: Failed to read chunk at offset {0} from {1}"), StreamOffset, Path);
+        return Span;
+    }
+
+    BytesRead = NumBytesRead;
+#else
+    ssize_t NumBytesRead = pread(static_cast<int32>(NativeHandle), ChunkBuffer, ChunkBufferSize, static_cast<off_t>(StreamOffset));
+    if (NumBytesRead < 0)
+    {
+        VE_CORE_LOG_ERROR(VE_TEXT("[FileReader]: Failed to read chunk at offset {0} from {1}"), StreamOffset, Path);
+        return Span;
+    }
+
+    BytesRead = static_cast<uint64>(NumBytesRead);
+#endif
+
+    Span.Data = ChunkBuffer;
+    Span.Size = std::min<uint64>(BytesRead, SizeInBytes - StreamOffset);
+    Span.FileOffset = StreamOffset;
+
+    StreamOffset += Span.Size;
+
+    return Span;
+}
+
+void FileReader::SeekChunk(uint64 inOffset)
+{
+    VE_ASSERT(Mode == EFileReadMode::Streamed, VE_TEXT("[FileReader]: SeekChunk() is only valid for streamed files..."));
+
+    if (Flags & FFileReadFlags::Unbuffered)
+    {
+        inOffset &= ~(GetPageSize() - 1);
+    }
+
+    StreamOffset = std::min<uint64>(inOffset, SizeInBytes);
+}
+
+void FileReader::SetAccessHint(EFileAccessHint inAccessHint, uint64 inOffset, uint64 inSize)
+{
+    if (inSize == 0 || inOffset + inSize > SizeInBytes)
+    {
+        inSize = inOffset < SizeInBytes ? SizeInBytes - inOffset : 0;
+    }
+
+    if (inSize == 0 || inAccessHint == EFileAccessHint::Normal)
+    {
+        return;
+    }
+
+    if (Mode == EFileReadMode::MemoryMapped && MappedData != nullptr)
+    {
+#if defined(_WIN64) || defined(_WIN32)
+        // Windows only supports explicit prefetching of mapped ranges, sequential/random are set on file open
+        if (inAccessHint == EFileAccessHint::WillNeed || inAccessHint == EFileAccessHint::Sequential)
+        {
+            WIN32_MEMORY_RANGE_ENTRY Range = { };
+            Range.VirtualAddress = MappedData + inOffset;
+            Range.NumberOfBytes = static_cast<SIZE_T>(inSize);
+            PrefetchVirtualMemory(GetCurrentProcess(), 1, &Range, 0);
+        }
+#else
+        // madvise requires a page aligned address
+        const uint64 AlignedOffset = inOffset & ~(GetPageSize() - 1);
+        int32 Advice = MADV_NORMAL;
+        switch (inAccessHint)
+        {
+        case EFileAccessHint::Normal:
+            Advice = MADV_NORMAL;
+            break;
+        case EFileAccessHint::Sequential:
+            Advice = MADV_SEQUENTIAL;
+            break;
+        case EFileAccessHint::Random:
+            Advice = MADV_RANDOM;
+            break;
+        case EFileAccessHint::WillNeed:
+            Advice = MADV_WILLNEED;
+            break;
+        }
+
+        madvise(MappedData + AlignedOffset, inSize + (inOffset - AlignedOffset), Advice);
+#endif
+        return;
+    }
+
+#if !defined(_WIN64) && !defined(_WIN32)
+    if (Mode == EFileReadMode::Streamed && NativeHandle != -1)
+    {
+        int32 Advice = POSIX_FADV_NORMAL;
+        switch (inAccessHint)
+        {
+        case EFileAccessHint::Normal:
+            Advice = POSIX_FADV_NORMAL;
+            break;
+        case EFileAccessHint::Sequential:
+            Advice = POSIX_FADV_SEQUENTIAL;
+            break;
+        case EFileAccessHint::Random:
+            Advice = POSIX_FADV_RANDOM;
+            break;
+        case EFileAccessHint::WillNeed:
+            Advice = POSIX_FADV_WILLNEED;
+            break;
+        }
+
+        posix_fadvise(static_cast<int32>(NativeHandle), static_cast<off_t>(inOffset), static_cast<off_t>(inSize), Advice);
+    }
+#endif
+}
+
+void FileReader::Close()
+{
+    if (Mode == EFileReadMode::Buffered)
+    {
+        Handle.close();
+        return;
+    }
+
+#if defined(_WIN64) || defined(_WIN32)
+    if (MappedData != nullptr)
+    {
+        UnmapViewOfFile(MappedData);
+    }
+
+    if (MappingHandle != nullptr)
+    {
+        CloseHandle((HANDLE)MappingHandle);
+    }
+
+    if (ChunkBuffer != nullptr)
+    {
+        _aligned_free(ChunkBuffer);
+    }
+
+    if (NativeHandle != -1)
+    {
+        CloseHandle((HANDLE)NativeHandle);
+    }
+#else
+    if (MappedData != nullptr)
+    {
+        munmap(MappedData, SizeInBytes);
+    }
+
+    if (ChunkBuffer != nullptr)
+    {
+        free(ChunkBuffer);
+    }
+
+    if (NativeHandle != -1)
+    {
+        close(static_cast<int32>(NativeHandle));
+    }
+#endif
+
+    MappedData = nullptr;
+    MappingHandle = nullptr;
+    ChunkBuffer = nullptr;
+    ChunkBufferSize = 0;
+    NativeHandle = -1;
+}
@@ -31,6 +31,75 @@ enum class EFileReadResult
     OutOfBytesToRead
 };
 
+/**
+* How the file contents are accessed by the reader 
+*/
+enum class EFileReadMode
+{
+    Buffered,       // Regular buffered ifstream reads (default)
+    MemoryMapped,   // File is mapped into the address space and accessed through spans, no copies
+    Streamed        // File is read in fixed size chunks into a reusable page aligned buffer
+};
+
+/**
+* Hints passed to the OS about how the file will be accessed (readahead/caching)
+*/
+enum class EFileAccessHint
+{
+    Normal,
+    Sequential,     // Aggressive readahead, pages behind the read position can be dropped
+    Random,         // No readahead
+    WillNeed        // Prefetch the whole range now
+};
+
+/**
+* Flags used for memory mapped and streamed read modes
+*/
+struct FFileReadFlags
+{
+    enum
+    {
+        /** Bypass the OS file cache (O_DIRECT / FILE_FLAG_NO_BUFFERING), only used by streamed reads */
+        Unbuffered = 1 << 0,
+    };
+};
+
+/**
+* A read only view into file memory (mapped or streamed chunk)
+* @note the span is only valid while the reader is open, and for streamed reads until the next ReadChunk()
+*/
+struct VRIXIC_API FFileSpan
+{
+public:
+    const uint8* Data = nullptr;
+    uint64 Size = 0;
+
+    /** Offset of the first byte of the span from the start of the file */
+    uint64 FileOffset = 0;
+
+public:
+    inline bool IsValid() const
+    {
+        return Data != nullptr && Size != 0;
+    }
+};
+
+/**
+* Configuration used for opening a file in a specific read mode
+*/
+struct VRIXIC_API FFileReaderConfig
+{
+public:
+    EFileReadMode Mode = EFileReadMode::Buffered;
+    EFileAccessHint AccessHint = EFileAccessHint::Sequential;
+
+    /** FFileReadFlags */
+    uint32 Flags = 0;
+
+    /** Size of the reusable chunk buffer for streamed reads, rounded up to the page size */
+    uint64 ChunkSize = 4u * 1024u * 1024u;
+};
+
 /**
 * Represents a file, which can be opened, read, writted to, and  closed...
 */
@@ -38,19 +107,27 @@ class VRIXIC_API FileReader
 {
 public:
     FileReader(std::string inPath)
+        : Path(inPath), Mode(EFileReadMode::Buffered), NativeHandle(-1), MappingHandle(nullptr),
+        MappedData(nullptr), ChunkBuffer(nullptr), ChunkBufferSize(0), StreamOffset(0), Flags(0)
     {
         Handle = { };
         Handle.open(inPath);
 
-        // Get the size of the file 
+        // Get the size of the file, tellg() returns -1 if the file could not be opened
         SeekEnd(0);
-        SizeInBytes = Tell();
+        SizeInBytes = Handle.is_open() ? Tell() : 0;
         SeekBegin(0);
     }
 
+    /**
+    * Opens the file using the read mode specified in the config,
+    * Buffered mode behaves exactly the same as FileReader(std::string)
+    */
+    FileReader(std::string inPath, const FFileReaderConfig& inConfig);
+
     ~FileReader()
     {
-        Handle.close();
+        Close();
     }
 
 public:
@@ -67,6 +144,9 @@ public:
         case EFileSeek::Begin:
             Handle.seekg(inOffset, std::ios::beg);
             break;
+        case EFileSeek::Current:
+            Handle.seekg(inOffset, std::ios::cur);
+            break;
         case EFileSeek::End:
             Handle.seekg(inOffset, std::ios::end);
             break;
@@ -138,11 +218,43 @@ public:
         return EFileReadResult::Success;
     }
 
-    inline void Close()
+    /**
+    * Returns a view into the memory mapped file 
+    * @note only valid for EFileReadMode::MemoryMapped
+    *
+    * @param inOffset - byte offset from the beginning of the file 
+    * @param inSize - count of bytes the span should cover, clamped to the end of the file 
+    */
+    FFileSpan GetSpan(uint64 inOffset, uint64 inSize) const;
+
+    /**
+    * @returns FFileSpan - a view of the entire memory mapped file 
+    */
+    inline FFileSpan GetSpan() const
     {
-        Handle.close();
+        return GetSpan(0, SizeInBytes);
     }
 
+    /**
+    * Reads the next chunk of the file into the reusable page aligned chunk buffer 
+    * @note only valid for EFileReadMode::Streamed, the span returned gets overwritten by the next call
+    *
+    * @returns FFileSpan - the chunk that was read, invalid span when there are no more bytes to read 
+    */
+    FFileSpan ReadChunk();
+
+    /**
+    * Moves the streaming read position, rounded down to the page size if the reader is unbuffered
+    */
+    void SeekChunk(uint64 inOffset);
+
+    /**
+    * Passes an access hint to the OS for the range specified (readahead/prefetching)
+    */
+    void SetAccessHint(EFileAccessHint inAccessHint, uint64 inOffset = 0, uint64 inSize = 0);
+
+    void Close();
+
 public:
 
     /**
@@ -160,13 +272,58 @@ public:
 
     inline bool IsOpen() const 
     {
-        return Handle.is_open();
+        switch (Mode)
+        {
+        case EFileReadMode::Buffered:
+            return Handle.is_open();
+        case EFileReadMode::MemoryMapped:
+            return MappedData != nullptr || (NativeHandle != -1 && SizeInBytes == 0);
+        case EFileReadMode::Streamed:
+            return NativeHandle != -1;
+        }
+
+        return false;
     }
 
+    inline EFileReadMode GetReadMode() const
+    {
+        return Mode;
+    }
+
+    /**
+    * @returns uint64 - the page size (and required alignment for unbuffered reads) of the OS
+    */
+    static uint64 GetPageSize();
+
+private:
+    void OpenMapped(const FFileReaderConfig& inConfig);
+    void OpenStreamed(const FFileReaderConfig& inConfig);
+
 private:
     std::string Path;
     std::ifstream Handle;
 
     /** Size of the file in bytes */
     uint64 SizeInBytes;
+
+    EFileReadMode Mode;
+
+    /** OS file handle (HANDLE or file descriptor) used by mapped and streamed modes, -1 when invalid */
+    intptr NativeHandle;
+
+    /** OS mapping object, only used on windows */
+    void* MappingHandle;
+
+    /** Start of the mapped view */
+    uint8* MappedData;
+
+    /** Reusable page aligned buffer used by streamed reads */
+    uint8* ChunkBuffer;
+    uint64 ChunkBufferSize;
+
+    /** Position of the next chunk to be streamed */
+    uint64 StreamOffset;
+
+    /** FFileReadFlags */
+    uint32 Flags;
 };
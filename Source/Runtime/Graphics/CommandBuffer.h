@@ -191,6 +191,12 @@ public:
     */
     virtual void DrawIndexedInstanced(uint32 inNumIndices, uint32 inNumInstances, uint32 inFirstIndex = 0, uint32 inVertexOffset = 0, uint32 inFirstInstanceIndex = 0) = 0;
 
+    /**
+    * @returns uint32 number of draws recorded since the command buffer was created (wraps around),
+    *   the difference between two calls is the number of draws recorded in between
+    */
+    virtual uint32 GetNumDraws() const = 0;
+
     /**
      * Copies the data from the buffer provided and uploads it into the texture
      * @Note: this function only uploads the data and leaves the texture in a non-shader readable layout
@@ -200,6 +206,24 @@ public:
      */
     virtual void UploadTextureData(const TextureResource* inTexture, const FTextureWriteInfo& inTextureWriteInfo) = 0;
 
+    /**
+     * Makes textures uploaded with UploadTextureData on the transfer queue usable by this command buffer,
+     * the barriers of every texture are recorded together (the upload has to have completed before this command buffer is submitted)
+     *
+     * @param inTextures the uploaded textures
+     * @param inNumTextures number of textures in inTextures
+     * @param inNewTextureLayout the layout the textures are used in afterwards
+     */
+    virtual void AcquireUploadedTextures(const TextureResource* const* inTextures, uint32 inNumTextures, ETextureLayout inNewTextureLayout) = 0;
+
+    /**
+     * Records texture barriers, all of them are recorded together as one pipeline barrier
+     *
+     * @param inBarriers the barriers to record
+     * @param inNumBarriers number of barriers in inBarriers
+     */
+    virtual void AddTextureBarriers(const FTextureBarrier* inBarriers, uint32 inNumBarriers) = 0;
+
 public:
     /* ------------------------------------------------------------------------------- */
     /* -------------                 Synchronization               ------------------- */
@@ -7,14 +7,34 @@
 #include <Core/Misc/Interface.h>
 #include "CommandBuffer.h"
 #include "Fence.h"
+#include "Queue.h"
 #include "Semaphore.h"
 
-
-enum class ERenderQueueType
+/**
+* A batch of command buffers submitted to a queue at once
+*/
+struct VRIXIC_API FCommandQueueSubmitInfo
 {
-    Graphics,
-    Compute,
-    Transfer
+public:
+    /** Executed in order */
+    ICommandBuffer* const* CommandBuffers;
+    uint32 NumCommandBuffers;
+
+    /** Every semaphore held by each of these is waited on before the batch starts */
+    ISemaphore* const* WaitSemaphores;
+    uint32 NumWaitSemaphores;
+
+    /** Every semaphore held by each of these is signaled once the batch completes */
+    ISemaphore* const* SignalSemaphores;
+    uint32 NumSignalSemaphores;
+
+    /** Optional, signaled once the batch completes */
+    IFence* Fence;
+
+public:
+    FCommandQueueSubmitInfo()
+        : CommandBuffers(nullptr), NumCommandBuffers(0), WaitSemaphores(nullptr), NumWaitSemaphores(0),
+        SignalSemaphores(nullptr), NumSignalSemaphores(0), Fence(nullptr) { }
 };
 
 class VRIXIC_API ICommandQueue : public Interface
@@ -54,6 +74,13 @@ public:
     */
     virtual void Submit(ICommandBuffer* inCommandBuffer, IFence* inWaitFence) = 0;
 
+    /**
+    * Submits a batch of command buffers, the waits block every stage of the batch
+    *
+    * @param inSubmitInfo the command buffers, semaphores and fence of the batch (can have no command buffers to only wait and signal)
+    */
+    virtual void Submit(const FCommandQueueSubmitInfo& inSubmitInfo) = 0;
+
     /**
     * Sets a wait fence that will block the CPU execution until the fence has been signaled
     *
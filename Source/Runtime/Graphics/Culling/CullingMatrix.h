@@ -0,0 +1,52 @@
+/**
+* This file is part of the "Vrixic Engine" project (Copyright (c) 2022-2023 by Vrij Patel)
+* See "LICENSE.txt" for license information.
+*/
+
+#pragma once
+#include <Misc/Defines/GenericDefines.h>
+
+/**
+* Plain row major 4x4 matrix the culling code takes its transforms as, row vectors with the translation in row 3 like Matrix4D.
+*   Matrix4D is built on DirectXMath, this keeps the culling code (and its tests) free of it
+*/
+struct FFloat4x4
+{
+public:
+    float M[4][4];
+
+public:
+    inline float operator()(uint32 inRow, uint32 inColumn) const
+    {
+        return M[inRow][inColumn];
+    }
+
+    inline float& operator()(uint32 inRow, uint32 inColumn)
+    {
+        return M[inRow][inColumn];
+    }
+
+    /**
+    * @returns FFloat4x4 copy of any matrix readable with operator()(row, column), ex: Matrix4D
+    */
+    template<typename TMatrix>
+    static FFloat4x4 From(const TMatrix& inMatrix)
+    {
+        FFloat4x4 Result;
+        for (uint32 Row = 0; Row < 4; ++Row)
+        {
+            for (uint32 Column = 0; Column < 4; ++Column)
+            {
+                Result.M[Row][Column] = inMatrix(Row, Column);
+            }
+        }
+        return Result;
+    }
+
+    static FFloat4x4 Identity()
+    {
+        FFloat4x4 Result = { };
+        Result.M[0][0] = Result.M[1][1] = Result.M[2][2] = Result.M[3][3] = 1.0f;
+        return Result;
+    }
+};
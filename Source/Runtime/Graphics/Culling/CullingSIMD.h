@@ -0,0 +1,67 @@
+/**
+* This file is part of the "Vrixic Engine" project (Copyright (c) 2022-2023 by Vrij Patel)
+* See "LICENSE.txt" for license information.
+*/
+
+#pragma once
+#include <Misc/Defines/GenericDefines.h>
+
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/** MSVC compiles AVX2 intrinsics in any function, gcc and clang only in functions built for AVX2 */
+#if defined(_MSC_VER)
+#define VE_TARGET_AVX2
+#else
+#define VE_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+/**
+* Cpu feature checks and bit helpers shared by the culling kernels
+*/
+namespace CullingSIMD
+{
+    /**
+    * @returns bool true if the cpu has AVX2 and the OS saves the ymm registers
+    */
+    inline bool IsAVX2Supported()
+    {
+#if defined(_MSC_VER)
+        int Info[4];
+        __cpuid(Info, 0);
+        if (Info[0] < 7)
+        {
+            return false;
+        }
+
+        __cpuid(Info, 1);
+        const bool bHasOSXSave = (Info[2] & (1 << 27)) != 0;
+        const bool bHasAVX = (Info[2] & (1 << 28)) != 0;
+        if (!bHasOSXSave || !bHasAVX || (_xgetbv(0) & 0x6) != 0x6)
+        {
+            return false;
+        }
+
+        __cpuidex(Info, 7, 0);
+        return (Info[1] & (1 << 5)) != 0;
+#else
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+
+    /**
+    * @returns uint32 index of the lowest set bit, inMask cannot be 0
+    */
+    inline uint32 CountTrailingZeros(uint32 inMask)
+    {
+#if defined(_MSC_VER)
+        unsigned long Index;
+        _BitScanForward(&Index, inMask);
+        return (uint32)Index;
+#else
+        return (uint32)__builtin_ctz(inMask);
+#endif
+    }
+}
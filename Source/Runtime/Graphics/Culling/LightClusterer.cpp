@@ -0,0 +1,385 @@
+/**
+* This file is part of the "Vrixic Engine" project (Copyright (c) 2022-2023 by Vrij Patel)
+* See "LICENSE.txt" for license information.
+*/
+
+#include "LightClusterer.h"
+#include "CullingSIMD.h"
+#include <Misc/Assert.h>
+#include <Misc/Defines/StringDefines.h>
+#include <Runtime/Core/Math/VrixicMathHelper.h>
+
+#include <External/enkiTS/Includes/TaskScheduler.h>
+
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <string.h>
+
+namespace LightClustererHelpers
+{
+    /**
+    * Sphere against box tests of the lights, both paths compute the squared distances with the same operations so they hit the same lights
+    */
+    static uint32 IntersectLightsScalar(const float* inX, const float* inY, const float* inZ, const float* inRadiusSq, uint32 inNumLights,
+        const float* inMin, const float* inMax, uint32* outHits)
+    {
+        uint32 NumHits = 0;
+        for (uint32 i = 0; i < inNumLights; ++i)
+        {
+            // Distance from the center to the box along each axis, 0 inside
+            const float DX = MathUtils::Max(MathUtils::Max(inMin[0] - inX[i], inX[i] - inMax[0]), 0.0f);
+            const float DY = MathUtils::Max(MathUtils::Max(inMin[1] - inY[i], inY[i] - inMax[1]), 0.0f);
+            const float DZ = MathUtils::Max(MathUtils::Max(inMin[2] - inZ[i], inZ[i] - inMax[2]), 0.0f);
+
+            const float DistanceSq = DX * DX + DY * DY + DZ * DZ;
+            if (DistanceSq <= inRadiusSq[i])
+            {
+                outHits[NumHits++] = i;
+            }
+        }
+
+        return NumHits;
+    }
+
+    /**
+    * @param inNumLights multiple of 8
+    */
+    VE_TARGET_AVX2 static uint32 IntersectLightsAVX2(const float* inX, const float* inY, const float* inZ, const float* inRadiusSq, uint32 inNumLights,
+        const float* inMin, const float* inMax, uint32* outHits)
+    {
+        const __m256 Zero = _mm256_setzero_ps();
+        const __m256 MinX = _mm256_set1_ps(inMin[0]);
+        const __m256 MinY = _mm256_set1_ps(inMin[1]);
+        const __m256 MinZ = _mm256_set1_ps(inMin[2]);
+        const __m256 MaxX = _mm256_set1_ps(inMax[0]);
+        const __m256 MaxY = _mm256_set1_ps(inMax[1]);
+        const __m256 MaxZ = _mm256_set1_ps(inMax[2]);
+
+        uint32 NumHits = 0;
+        for (uint32 i = 0; i < inNumLights; i += 8)
+        {
+            const __m256 X = _mm256_loadu_ps(inX + i);
+            const __m256 Y = _mm256_loadu_ps(inY + i);
+            const __m256 Z = _mm256_loadu_ps(inZ + i);
+
+            const __m256 DX = _mm256_max_ps(_mm256_max_ps(_mm256_sub_ps(MinX, X), _mm256_sub_ps(X, MaxX)), Zero);
+            const __m256 DY = _mm256_max_ps(_mm256_max_ps(_mm256_sub_ps(MinY, Y), _mm256_sub_ps(Y, MaxY)), Zero);
+            const __m256 DZ = _mm256_max_ps(_mm256_max_ps(_mm256_sub_ps(MinZ, Z), _mm256_sub_ps(Z, MaxZ)), Zero);
+
+            const __m256 DistanceSq = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(DX, DX), _mm256_mul_ps(DY, DY)), _mm256_mul_ps(DZ, DZ));
+
+            uint32 HitMask = (uint32)_mm256_movemask_ps(_mm256_cmp_ps(DistanceSq, _mm256_loadu_ps(inRadiusSq + i), _CMP_LE_OQ));
+            while (HitMask != 0)
+            {
+                outHits[NumHits++] = i + CullingSIMD::CountTrailingZeros(HitMask);
+                HitMask &= HitMask - 1;
+            }
+        }
+
+        return NumHits;
+    }
+
+    /**
+    * Bounds of the piece of the frustum between two view directions (as tangents) and two depths
+    */
+    static void MakeBounds(float inTanMinX, float inTanMaxX, float inTanMinY, float inTanMaxY, float inNearZ, float inFarZ, float* outMin, float* outMax)
+    {
+        // The sides are planes through the eye, so the extremes are on the near or the far face
+        outMin[0] = MathUtils::Min(inTanMinX * inNearZ, inTanMinX * inFarZ);
+        outMax[0] = MathUtils::Max(inTanMaxX * inNearZ, inTanMaxX * inFarZ);
+        outMin[1] = MathUtils::Min(inTanMinY * inNearZ, inTanMinY * inFarZ);
+        outMax[1] = MathUtils::Max(inTanMaxY * inNearZ, inTanMaxY * inFarZ);
+        outMin[2] = inNearZ;
+        outMax[2] = inFarZ;
+    }
+}
+
+struct LightClusterer::FSliceTask : enki::ITaskSet
+{
+    void ExecuteRange(enki::TaskSetPartition inRange, uint32_t /*inThreadNum*/) override
+    {
+        for (uint32 i = inRange.start; i < inRange.end; ++i)
+        {
+            Clusterer->AssignSlice(i);
+        }
+    }
+
+    LightClusterer* Clusterer;
+};
+
+void LightClusterer::FLightSoA::Clear()
+{
+    X.clear();
+    Y.clear();
+    Z.clear();
+    RadiusSq.clear();
+    LightIndex.clear();
+}
+
+void LightClusterer::FLightSoA::Add(float inX, float inY, float inZ, float inRadiusSq, uint32 inLightIndex)
+{
+    X.push_back(inX);
+    Y.push_back(inY);
+    Z.push_back(inZ);
+    RadiusSq.push_back(inRadiusSq);
+    LightIndex.push_back(inLightIndex);
+}
+
+void LightClusterer::FLightSoA::Pad()
+{
+    // A negative squared radius is smaller than any distance, the padding never hits
+    while (LightIndex.size() % 8 != 0)
+    {
+        Add(0.0f, 0.0f, 0.0f, -1.0f, UINT32_MAX);
+    }
+}
+
+LightClusterer::LightClusterer()
+    : bUseAVX2(false), AspectRatio(0.0f), VerticalFOV(0.0f), GridInfo() { }
+
+void LightClusterer::Init(const FLightClustererConfig& inConfig)
+{
+    VE_ASSERT(inConfig.NumClustersX > 0 && inConfig.NumClustersY > 0 && inConfig.NumClustersZ > 0,
+        VE_TEXT("[LightClusterer]: Cannot create a {0}x{1}x{2} cluster grid..."), inConfig.NumClustersX, inConfig.NumClustersY, inConfig.NumClustersZ);
+
+    Config = inConfig;
+    bUseAVX2 = inConfig.bUseSIMD && CullingSIMD::IsAVX2Supported();
+
+    GridInfo = { };
+    GridInfo.NumClustersX = inConfig.NumClustersX;
+    GridInfo.NumClustersY = inConfig.NumClustersY;
+    GridInfo.NumClustersZ = inConfig.NumClustersZ;
+
+    // Forces the next SetProjection() to build the bounds
+    AspectRatio = 0.0f;
+    VerticalFOV = 0.0f;
+
+    const uint32 NumClusters = inConfig.NumClustersX * inConfig.NumClustersY * inConfig.NumClustersZ;
+    ClusterBounds.resize(NumClusters);
+    RowBounds.resize(inConfig.NumClustersY * inConfig.NumClustersZ);
+    SliceDepths.resize(inConfig.NumClustersZ + 1);
+    SliceScratches.resize(inConfig.NumClustersZ);
+
+    Clusters.assign(NumClusters, { 0, 0 });
+    LightIndices.clear();
+    Stats = FLightClustererStats();
+}
+
+void LightClusterer::SetProjection(float inAspectRatio, float inVerticalFOVInDegs, float inNearZ, float inFarZ)
+{
+    if (inAspectRatio == AspectRatio && inVerticalFOVInDegs == VerticalFOV && inNearZ == GridInfo.NearZ && inFarZ == GridInfo.FarZ)
+    {
+        return;
+    }
+
+    VE_ASSERT(inNearZ > 0.0f && inFarZ > inNearZ, VE_TEXT("[LightClusterer]: The depth range [{0}, {1}] cannot be sliced exponentially..."), inNearZ, inFarZ);
+
+    AspectRatio = inAspectRatio;
+    VerticalFOV = inVerticalFOVInDegs;
+    GridInfo.NearZ = inNearZ;
+    GridInfo.FarZ = inFarZ;
+
+    const uint32 NumX = Config.NumClustersX;
+    const uint32 NumY = Config.NumClustersY;
+    const uint32 NumZ = Config.NumClustersZ;
+
+    // Slice k starts at Near * (Far / Near) ^ (k / NumZ), inverted for the shader: k = log(z) * NumZ / log(Far / Near) - NumZ * log(Near) / log(Far / Near)
+    const float LogDepthRange = std::log(inFarZ / inNearZ);
+    GridInfo.SliceScale = (float)NumZ / LogDepthRange;
+    GridInfo.SliceBias = -(float)NumZ * std::log(inNearZ) / LogDepthRange;
+
+    for (uint32 z = 0; z <= NumZ; ++z)
+    {
+        SliceDepths[z] = inNearZ * std::pow(inFarZ / inNearZ, (float)z / (float)NumZ);
+    }
+
+    // The last plane is exactly the far plane, the pow above can round it
+    SliceDepths[NumZ] = inFarZ;
+
+    const float TanY = std::tan(MathUtils::DegreesToRadians(inVerticalFOVInDegs * 0.5f));
+    const float TanX = TanY * inAspectRatio;
+
+    for (uint32 z = 0; z < NumZ; ++z)
+    {
+        for (uint32 y = 0; y < NumY; ++y)
+        {
+            // Row 0 is the top of the screen
+            const float TanMaxY = TanY - 2.0f * TanY * (float)y / (float)NumY;
+            const float TanMinY = TanY - 2.0f * TanY * (float)(y + 1) / (float)NumY;
+
+            FClusterBounds& Row = RowBounds[z * NumY + y];
+            LightClustererHelpers::MakeBounds(-TanX, TanX, TanMinY, TanMaxY, SliceDepths[z], SliceDepths[z + 1], Row.Min, Row.Max);
+
+            for (uint32 x = 0; x < NumX; ++x)
+            {
+                const float TanMinX = -TanX + 2.0f * TanX * (float)x / (float)NumX;
+                const float TanMaxX = -TanX + 2.0f * TanX * (float)(x + 1) / (float)NumX;
+
+                FClusterBounds& Cluster = ClusterBounds[GetClusterIndex(x, y, z)];
+                LightClustererHelpers::MakeBounds(TanMinX, TanMaxX, TanMinY, TanMaxY, SliceDepths[z], SliceDepths[z + 1], Cluster.Min, Cluster.Max);
+            }
+        }
+    }
+}
+
+void LightClusterer::AssignLights(const FPointLight* inLights, uint32 inNumLights, const FFloat4x4& inView)
+{
+    VE_ASSERT(GridInfo.FarZ > 0.0f, VE_TEXT("[LightClusterer]: SetProjection() has to be called before lights can be assigned..."));
+
+    typedef std::chrono::high_resolution_clock Clock;
+    auto Start = Clock::now();
+
+    ViewLights.Clear();
+    for (uint32 i = 0; i < inNumLights; ++i)
+    {
+        const FPointLight& Light = inLights[i];
+        if (Light.Radius <= 0.0f)
+        {
+            continue;
+        }
+
+        const Vector3D& P = Light.Position;
+        ViewLights.Add(
+            P.X * inView(0, 0) + P.Y * inView(1, 0) + P.Z * inView(2, 0) + inView(3, 0),
+            P.X * inView(0, 1) + P.Y * inView(1, 1) + P.Z * inView(2, 1) + inView(3, 1),
+            P.X * inView(0, 2) + P.Y * inView(1, 2) + P.Z * inView(2, 2) + inView(3, 2),
+            Light.Radius * Light.Radius, i);
+    }
+    ViewLights.Pad();
+
+    if (Config.TaskScheduler != nullptr)
+    {
+        FSliceTask Task;
+        Task.Clusterer = this;
+        Task.m_SetSize = Config.NumClustersZ;
+        Task.m_MinRange = 1;
+
+        Config.TaskScheduler->AddTaskSetToPipe(&Task);
+        Config.TaskScheduler->WaitforTask(&Task);
+    }
+    else
+    {
+        for (uint32 z = 0; z < Config.NumClustersZ; ++z)
+        {
+            AssignSlice(z);
+        }
+    }
+
+    // Pack the lists of the slices one after the other
+    const uint32 NumClustersPerSlice = Config.NumClustersX * Config.NumClustersY;
+
+    uint32 NumLightIndices = 0;
+    for (const FSliceScratch& Scratch : SliceScratches)
+    {
+        NumLightIndices += (uint32)Scratch.LightIndices.size();
+    }
+
+    LightIndices.resize(NumLightIndices);
+
+    Stats = FLightClustererStats();
+    Stats.NumLights = inNumLights;
+    Stats.NumLightIndices = NumLightIndices;
+
+    uint32 SliceOffset = 0;
+    for (uint32 z = 0; z < Config.NumClustersZ; ++z)
+    {
+        const FSliceScratch& Scratch = SliceScratches[z];
+        if (!Scratch.LightIndices.empty())
+        {
+            memcpy(LightIndices.data() + SliceOffset, Scratch.LightIndices.data(), Scratch.LightIndices.size() * sizeof(uint32));
+        }
+
+        for (uint32 i = 0; i < NumClustersPerSlice; ++i)
+        {
+            FLightCluster& Cluster = Clusters[z * NumClustersPerSlice + i];
+            Cluster.Offset += SliceOffset;
+            Stats.MaxLightsPerCluster = MathUtils::Max(Stats.MaxLightsPerCluster, Cluster.Count);
+        }
+
+        SliceOffset += (uint32)Scratch.LightIndices.size();
+    }
+
+    GridInfo.NumLights = inNumLights;
+    Stats.AssignTimeMs = std::chrono::duration<float, std::milli>(Clock::now() - Start).count();
+}
+
+void LightClusterer::AssignSlice(uint32 inSlice)
+{
+    const uint32 NumX = Config.NumClustersX;
+    const uint32 NumY = Config.NumClustersY;
+
+    FSliceScratch& Scratch = SliceScratches[inSlice];
+    Scratch.LightIndices.clear();
+    Scratch.Hits.resize(ViewLights.GetNum());
+
+    // Lights touching the slice
+    FClusterBounds SliceBounds = RowBounds[inSlice * NumY];
+    for (uint32 y = 1; y < NumY; ++y)
+    {
+        const FClusterBounds& Row = RowBounds[inSlice * NumY + y];
+        for (uint32 Axis = 0; Axis < 3; ++Axis)
+        {
+            SliceBounds.Min[Axis] = MathUtils::Min(SliceBounds.Min[Axis], Row.Min[Axis]);
+            SliceBounds.Max[Axis] = MathUtils::Max(SliceBounds.Max[Axis], Row.Max[Axis]);
+        }
+    }
+
+    Scratch.SliceLights.Clear();
+    const uint32 NumSliceHits = IntersectLights(ViewLights, SliceBounds, Scratch.Hits.data());
+    for (uint32 i = 0; i < NumSliceHits; ++i)
+    {
+        const uint32 Hit = Scratch.Hits[i];
+        Scratch.SliceLights.Add(ViewLights.X[Hit], ViewLights.Y[Hit], ViewLights.Z[Hit], ViewLights.RadiusSq[Hit], ViewLights.LightIndex[Hit]);
+    }
+    Scratch.SliceLights.Pad();
+
+    for (uint32 y = 0; y < NumY; ++y)
+    {
+        // Lights touching the row
+        Scratch.RowLights.Clear();
+        if (NumSliceHits > 0)
+        {
+            const uint32 NumRowHits = IntersectLights(Scratch.SliceLights, RowBounds[inSlice * NumY + y], Scratch.Hits.data());
+            for (uint32 i = 0; i < NumRowHits; ++i)
+            {
+                const uint32 Hit = Scratch.Hits[i];
+                Scratch.RowLights.Add(Scratch.SliceLights.X[Hit], Scratch.SliceLights.Y[Hit], Scratch.SliceLights.Z[Hit],
+                    Scratch.SliceLights.RadiusSq[Hit], Scratch.SliceLights.LightIndex[Hit]);
+            }
+            Scratch.RowLights.Pad();
+        }
+
+        for (uint32 x = 0; x < NumX; ++x)
+        {
+            const uint32 ClusterIndex = GetClusterIndex(x, y, inSlice);
+
+            uint32 NumHits = 0;
+            if (Scratch.RowLights.GetNum() > 0)
+            {
+                NumHits = IntersectLights(Scratch.RowLights, ClusterBounds[ClusterIndex], Scratch.Hits.data());
+            }
+
+            // Relative to the slice, made absolute once the slices are packed
+            Clusters[ClusterIndex].Offset = (uint32)Scratch.LightIndices.size();
+            Clusters[ClusterIndex].Count = NumHits;
+
+            for (uint32 i = 0; i < NumHits; ++i)
+            {
+                Scratch.LightIndices.push_back(Scratch.RowLights.LightIndex[Scratch.Hits[i]]);
+            }
+        }
+    }
+}
+
+uint32 LightClusterer::IntersectLights(const FLightSoA& inLights, const FClusterBounds& inBounds, uint32* outHits) const
+{
+    if (bUseAVX2)
+    {
+        return LightClustererHelpers::IntersectLightsAVX2(inLights.X.data(), inLights.Y.data(), inLights.Z.data(), inLights.RadiusSq.data(), inLights.GetNum(),
+            inBounds.Min, inBounds.Max, outHits);
+    }
+
+    return LightClustererHelpers::IntersectLightsScalar(inLights.X.data(), inLights.Y.data(), inLights.Z.data(), inLights.RadiusSq.data(), inLights.GetNum(),
+        inBounds.Min, inBounds.Max, outHits);
+}
@@ -0,0 +1,258 @@
+/**
+* This file is part of the "Vrixic Engine" project (Copyright (c) 2022-2023 by Vrij Patel)
+* See "LICENSE.txt" for license information.
+*/
+
+#pragma once
+#include <Core/Core.h>
+#include <Misc/Defines/GenericDefines.h>
+#include <Runtime/Core/Math/Vector3D.h>
+#include "CullingMatrix.h"
+
+#include <vector>
+
+namespace enki
+{
+    class TaskScheduler;
+}
+
+/**
+* A light in the light buffer, laid out to match a std430 array of (vec3, float, vec3, float)
+*/
+struct FPointLight
+{
+public:
+    Vector3D Position;
+
+    /** Distance at which the light stops contributing, the light only lands in the clusters its sphere touches */
+    float Radius;
+
+    Vector3D Color;
+    float Intensity;
+};
+
+struct FLightClustererConfig
+{
+public:
+    /** Clusters across the screen and along the view direction, the depth slices get exponentially thicker with the distance */
+    uint32 NumClustersX = 16;
+    uint32 NumClustersY = 9;
+    uint32 NumClustersZ = 24;
+
+    /** false forces the scalar sphere tests even if the cpu supports AVX2, it is the reference the AVX2 ones are checked against */
+    bool bUseSIMD = true;
+
+    /** Optional, when set the depth slices are assigned across the worker threads */
+    enki::TaskScheduler* TaskScheduler = nullptr;
+};
+
+/**
+* Lets a shader find the cluster of a pixel, laid out to match a std430 block
+*   slice = floor(log(view z) * SliceScale + SliceBias), row 0 is the top of the screen
+*/
+struct FLightClusterGridInfo
+{
+public:
+    uint32 NumClustersX;
+    uint32 NumClustersY;
+    uint32 NumClustersZ;
+    uint32 NumLights;
+
+    float SliceScale;
+    float SliceBias;
+    float NearZ;
+    float FarZ;
+};
+
+/**
+* Lights of a cluster are LightIndices[Offset] to LightIndices[Offset + Count - 1]
+*/
+struct FLightCluster
+{
+public:
+    uint32 Offset;
+    uint32 Count;
+};
+
+struct FLightClustererStats
+{
+public:
+    /** Lights given to the last AssignLights() */
+    uint32 NumLights = 0;
+
+    /** Sum of the lights of every cluster, the size of the index list */
+    uint32 NumLightIndices = 0;
+
+    uint32 MaxLightsPerCluster = 0;
+
+    float AssignTimeMs = 0.0f;
+};
+
+/**
+* Clustered forward light assignment, the view frustum is split in a grid of clusters (froxels) and
+*   every cluster gets the list of point lights whose sphere touches it, a pixel then only shades the lights of its cluster
+*
+* Clusters are boxes in view space bounding their piece of the frustum, the depth slices are exponential so near clusters stay small.
+* Every depth slice is assigned by one task: the lights are first narrowed down to the ones touching the slice, then the row,
+*   then tested against each cluster of the row 8 at a time with AVX2 when the cpu has it, a scalar path computing the same values is the fallback.
+* The per slice lists are then packed into one compact index list, the clusters index into it
+*
+* Usage: Init(), SetProjection() whenever the camera projection changes, AssignLights() every frame
+*/
+class VRIXIC_API LightClusterer
+{
+public:
+    LightClusterer();
+
+    void Init(const FLightClustererConfig& inConfig);
+
+    /**
+    * Builds the bounds of the clusters, does nothing if the projection did not change
+    *
+    * @param inVerticalFOVInDegs, inNearZ, inFarZ same as ProjectionMatrix4D::MakeProjectionVulkanLH()
+    */
+    void SetProjection(float inAspectRatio, float inVerticalFOVInDegs, float inNearZ, float inFarZ);
+
+    /**
+    * Finds the lights of every cluster
+    *
+    * @param inView row vector transform from world space to view space (left handed, +z forward, +y up)
+    */
+    void AssignLights(const FPointLight* inLights, uint32 inNumLights, const FFloat4x4& inView);
+
+public:
+    inline uint32 GetNumClusters() const
+    {
+        return (uint32)Clusters.size();
+    }
+
+    /**
+    * @param inY row, 0 is the top of the screen
+    * @param inZ depth slice, 0 is the nearest
+    */
+    inline uint32 GetClusterIndex(uint32 inX, uint32 inY, uint32 inZ) const
+    {
+        return (inZ * Config.NumClustersY + inY) * Config.NumClustersX + inX;
+    }
+
+    inline const std::vector<FLightCluster>& GetClusters() const
+    {
+        return Clusters;
+    }
+
+    inline const std::vector<uint32>& GetLightIndices() const
+    {
+        return LightIndices;
+    }
+
+    inline const FLightClusterGridInfo& GetGridInfo() const
+    {
+        return GridInfo;
+    }
+
+    /**
+    * @returns bool true if the AVX2 sphere tests are in use
+    */
+    inline bool IsUsingAVX2() const
+    {
+        return bUseAVX2;
+    }
+
+    inline const FLightClustererStats& GetStats() const
+    {
+        return Stats;
+    }
+
+private:
+    /**
+    * View space lights, one array per component so 8 of them can be loaded at once.
+    *   Padded to a multiple of 8 with lights that touch nothing
+    */
+    struct FLightSoA
+    {
+    public:
+        void Clear();
+        void Add(float inX, float inY, float inZ, float inRadiusSq, uint32 inLightIndex);
+        void Pad();
+
+        inline uint32 GetNum() const
+        {
+            return (uint32)LightIndex.size();
+        }
+
+    public:
+        std::vector<float> X;
+        std::vector<float> Y;
+        std::vector<float> Z;
+        std::vector<float> RadiusSq;
+        std::vector<uint32> LightIndex;
+    };
+
+    /**
+    * View space box of a cluster, or of a whole row of clusters
+    */
+    struct FClusterBounds
+    {
+    public:
+        float Min[3];
+        float Max[3];
+    };
+
+    /**
+    * What a task works with, one per depth slice so the tasks never share memory
+    */
+    struct FSliceScratch
+    {
+    public:
+        FLightSoA SliceLights;
+        FLightSoA RowLights;
+        std::vector<uint32> Hits;
+
+        /** Lights of the clusters of the slice, one cluster after the other */
+        std::vector<uint32> LightIndices;
+    };
+
+    /**
+    * Assigns the lights of every cluster of a depth slice into its scratch, the offsets of the clusters are relative to the slice
+    */
+    void AssignSlice(uint32 inSlice);
+
+    /**
+    * Tests the lights against a box
+    *
+    * @param outHits positions (in inLights) of the lights touching the box
+    * @returns uint32 number of hits
+    */
+    uint32 IntersectLights(const FLightSoA& inLights, const FClusterBounds& inBounds, uint32* outHits) const;
+
+private:
+    struct FSliceTask;
+
+    FLightClustererConfig Config;
+
+    bool bUseAVX2;
+
+    /** Parameters of the last SetProjection(), the bounds are only rebuilt if they change */
+    float AspectRatio;
+    float VerticalFOV;
+
+    FLightClusterGridInfo GridInfo;
+
+    /** View space depth of the planes between the slices, NumClustersZ + 1 of them */
+    std::vector<float> SliceDepths;
+
+    std::vector<FClusterBounds> ClusterBounds;
+
+    /** Bounds of every row of every slice, lights are tested against the row before its clusters */
+    std::vector<FClusterBounds> RowBounds;
+
+    /** Lights of the last AssignLights() in view space */
+    FLightSoA ViewLights;
+
+    std::vector<FSliceScratch> SliceScratches;
+
+    std::vector<FLightCluster> Clusters;
+    std::vector<uint32> LightIndices;
+
+    FLightClustererStats Stats;
+};
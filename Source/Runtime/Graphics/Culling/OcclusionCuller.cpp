@@ -0,0 +1,564 @@
+/**
+* This file is part of the "Vrixic Engine" project (Copyright (c) 2022-2023 by Vrij Patel)
+* See "LICENSE.txt" for license information.
+*/
+
+#include "OcclusionCuller.h"
+#include "CullingSIMD.h"
+#include <Misc/Assert.h>
+#include <Misc/Defines/StringDefines.h>
+#include <Runtime/Core/Math/VrixicMathHelper.h>
+
+#include <External/enkiTS/Includes/TaskScheduler.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+
+namespace OcclusionCullerHelpers
+{
+    inline Vector4D TransformPosition(const Vector3D& inPosition, const FFloat4x4& inMatrix)
+    {
+        return Vector4D(
+            inPosition.X * inMatrix(0, 0) + inPosition.Y * inMatrix(1, 0) + inPosition.Z * inMatrix(2, 0) + inMatrix(3, 0),
+            inPosition.X * inMatrix(0, 1) + inPosition.Y * inMatrix(1, 1) + inPosition.Z * inMatrix(2, 1) + inMatrix(3, 1),
+            inPosition.X * inMatrix(0, 2) + inPosition.Y * inMatrix(1, 2) + inPosition.Z * inMatrix(2, 2) + inMatrix(3, 2),
+            inPosition.X * inMatrix(0, 3) + inPosition.Y * inMatrix(1, 3) + inPosition.Z * inMatrix(2, 3) + inMatrix(3, 3));
+    }
+
+    static constexpr uint32 NUM_CLIP_PLANES = 5;
+
+    /**
+    * @returns float distance of a clip space vertex to a clip plane, >= 0 inside: near (z >= 0), then the left, right, bottom and top guard bands
+    */
+    inline float GetClipDistance(const Vector4D& inVertex, uint32 inPlane, float inGuardBand)
+    {
+        switch (inPlane)
+        {
+        case 0:
+            return inVertex.Z;
+        case 1:
+            return inVertex.X + inGuardBand * inVertex.W;
+        case 2:
+            return inGuardBand * inVertex.W - inVertex.X;
+        case 3:
+            return inVertex.Y + inGuardBand * inVertex.W;
+        default:
+            return inGuardBand * inVertex.W - inVertex.Y;
+        }
+    }
+
+    inline uint32 GetClipOutCode(const Vector4D& inVertex, float inGuardBand)
+    {
+        uint32 OutCode = 0;
+        for (uint32 Plane = 0; Plane < NUM_CLIP_PLANES; ++Plane)
+        {
+            OutCode |= GetClipDistance(inVertex, Plane, inGuardBand) < 0.0f ? (1 << Plane) : 0;
+        }
+
+        return OutCode;
+    }
+
+    inline Vector4D LerpVertex(const Vector4D& inA, const Vector4D& inB, float inT)
+    {
+        return Vector4D(
+            inA.X + (inB.X - inA.X) * inT,
+            inA.Y + (inB.Y - inA.Y) * inT,
+            inA.Z + (inB.Z - inA.Z) * inT,
+            inA.W + (inB.W - inA.W) * inT);
+    }
+
+    /**
+    * Writes the triangle into a tile, both paths compute every value with the same operations so they give the same depths
+    *
+    * @param inTileX, inTileY pixel coordinates of the top left pixel of the tile
+    * @returns float farthest depth of the tile after the triangle was written
+    */
+    static float RasterizeTileScalar(float* inOutTileDepth, const FOcclusionTriangle& inTriangle, float inTileX, float inTileY, uint32 inTileWidth, uint32 inTileHeight)
+    {
+        float FarthestDepth = FLT_MAX;
+        for (uint32 y = 0; y < inTileHeight; ++y)
+        {
+            const float PixelY = inTileY + (float)y + 0.5f;
+            float* Row = inOutTileDepth + y * inTileWidth;
+
+            for (uint32 x = 0; x < inTileWidth; ++x)
+            {
+                const float PixelX = inTileX + (float)x + 0.5f;
+
+                const float Edge0 = inTriangle.EdgeA[0] * PixelX + (inTriangle.EdgeB[0] * PixelY + inTriangle.EdgeC[0]);
+                const float Edge1 = inTriangle.EdgeA[1] * PixelX + (inTriangle.EdgeB[1] * PixelY + inTriangle.EdgeC[1]);
+                const float Edge2 = inTriangle.EdgeA[2] * PixelX + (inTriangle.EdgeB[2] * PixelY + inTriangle.EdgeC[2]);
+
+                if (Edge0 >= 0.0f && Edge1 >= 0.0f && Edge2 >= 0.0f)
+                {
+                    const float PixelDepth = inTriangle.DepthA * PixelX + (inTriangle.DepthB * PixelY + inTriangle.DepthC);
+                    Row[x] = Row[x] > PixelDepth ? Row[x] : PixelDepth;
+                }
+
+                FarthestDepth = MathUtils::Min(FarthestDepth, Row[x]);
+            }
+        }
+
+        return FarthestDepth;
+    }
+
+    /**
+    * One row of the tile per register, requires 8 pixel wide tiles
+    */
+    VE_TARGET_AVX2 static float RasterizeTileAVX2(float* inOutTileDepth, const FOcclusionTriangle& inTriangle, float inTileX, float inTileY, uint32 inTileHeight)
+    {
+        const __m256 PixelX = _mm256_add_ps(_mm256_set1_ps(inTileX + 0.5f), _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f));
+        const __m256 Zero = _mm256_setzero_ps();
+
+        __m256 Edge0X = _mm256_mul_ps(_mm256_set1_ps(inTriangle.EdgeA[0]), PixelX);
+        __m256 Edge1X = _mm256_mul_ps(_mm256_set1_ps(inTriangle.EdgeA[1]), PixelX);
+        __m256 Edge2X = _mm256_mul_ps(_mm256_set1_ps(inTriangle.EdgeA[2]), PixelX);
+        __m256 DepthX = _mm256_mul_ps(_mm256_set1_ps(inTriangle.DepthA), PixelX);
+
+        __m256 FarthestDepth = _mm256_set1_ps(FLT_MAX);
+        for (uint32 y = 0; y < inTileHeight; ++y)
+        {
+            const float PixelY = inTileY + (float)y + 0.5f;
+            float* Row = inOutTileDepth + y * 8;
+
+            const __m256 Edge0 = _mm256_add_ps(Edge0X, _mm256_set1_ps(inTriangle.EdgeB[0] * PixelY + inTriangle.EdgeC[0]));
+            const __m256 Edge1 = _mm256_add_ps(Edge1X, _mm256_set1_ps(inTriangle.EdgeB[1] * PixelY + inTriangle.EdgeC[1]));
+            const __m256 Edge2 = _mm256_add_ps(Edge2X, _mm256_set1_ps(inTriangle.EdgeB[2] * PixelY + inTriangle.EdgeC[2]));
+
+            const __m256 Covered = _mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(Edge0, Zero, _CMP_GE_OQ), _mm256_cmp_ps(Edge1, Zero, _CMP_GE_OQ)), _mm256_cmp_ps(Edge2, Zero, _CMP_GE_OQ));
+
+            __m256 RowDepth = _mm256_loadu_ps(Row);
+            if (!_mm256_testz_ps(Covered, Covered))
+            {
+                const __m256 PixelDepth = _mm256_add_ps(DepthX, _mm256_set1_ps(inTriangle.DepthB * PixelY + inTriangle.DepthC));
+                RowDepth = _mm256_blendv_ps(RowDepth, _mm256_max_ps(RowDepth, PixelDepth), Covered);
+                _mm256_storeu_ps(Row, RowDepth);
+            }
+
+            FarthestDepth = _mm256_min_ps(FarthestDepth, RowDepth);
+        }
+
+        // Horizontal min of the 8 lanes
+        __m128 Min = _mm_min_ps(_mm256_castps256_ps128(FarthestDepth), _mm256_extractf128_ps(FarthestDepth, 1));
+        Min = _mm_min_ps(Min, _mm_movehl_ps(Min, Min));
+        Min = _mm_min_ss(Min, _mm_shuffle_ps(Min, Min, 1));
+        return _mm_cvtss_f32(Min);
+    }
+
+    /**
+    * @param inMinX, inMaxX, inMinY, inMaxY pixels of the tile to test, inclusive and relative to the tile
+    * @returns bool true if any of the pixels is not nearer than inDepth
+    */
+    static bool IsAnyPixelVisibleScalar(const float* inTileDepth, uint32 inMinX, uint32 inMaxX, uint32 inMinY, uint32 inMaxY, float inDepth, uint32 inTileWidth)
+    {
+        for (uint32 y = inMinY; y <= inMaxY; ++y)
+        {
+            const float* Row = inTileDepth + y * inTileWidth;
+            for (uint32 x = inMinX; x <= inMaxX; ++x)
+            {
+                if (Row[x] <= inDepth)
+                {
+                    return true;
+                }
+            }
+        }
+
+        return false;
+    }
+
+    VE_TARGET_AVX2 static bool IsAnyPixelVisibleAVX2(const float* inTileDepth, uint32 inMinX, uint32 inMaxX, uint32 inMinY, uint32 inMaxY, float inDepth)
+    {
+        const __m256 Lanes = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+        const __m256 Columns = _mm256_and_ps(
+            _mm256_cmp_ps(Lanes, _mm256_set1_ps((float)inMinX), _CMP_GE_OQ),
+            _mm256_cmp_ps(Lanes, _mm256_set1_ps((float)inMaxX), _CMP_LE_OQ));
+
+        const __m256 Depth = _mm256_set1_ps(inDepth);
+        for (uint32 y = inMinY; y <= inMaxY; ++y)
+        {
+            const __m256 Visible = _mm256_and_ps(_mm256_cmp_ps(_mm256_loadu_ps(inTileDepth + y * 8), Depth, _CMP_LE_OQ), Columns);
+            if (!_mm256_testz_ps(Visible, Visible))
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+}
+
+struct OcclusionCuller::FBinTask : enki::ITaskSet
+{
+    void ExecuteRange(enki::TaskSetPartition inRange, uint32_t /*inThreadNum*/) override
+    {
+        for (uint32 i = inRange.start; i < inRange.end; ++i)
+        {
+            Culler->RasterizeBin(i);
+        }
+    }
+
+    OcclusionCuller* Culler;
+};
+
+OcclusionCuller::OcclusionCuller()
+    : Width(0), Height(0), NumTilesX(0), NumTilesY(0), BinTilesX(1), BinTilesY(1), bUseAVX2(false) { }
+
+void OcclusionCuller::Init(const FOcclusionCullerConfig& inConfig)
+{
+    VE_ASSERT(inConfig.Width > 0 && inConfig.Height > 0, VE_TEXT("[OcclusionCuller]: Cannot create a {0}x{1} depth buffer..."), inConfig.Width, inConfig.Height);
+
+    Config = inConfig;
+
+    NumTilesX = (inConfig.Width + TILE_WIDTH - 1) / TILE_WIDTH;
+    NumTilesY = (inConfig.Height + TILE_HEIGHT - 1) / TILE_HEIGHT;
+    Width = NumTilesX * TILE_WIDTH;
+    Height = NumTilesY * TILE_HEIGHT;
+
+    BinTilesX = (NumTilesX + NUM_BINS_X - 1) / NUM_BINS_X;
+    BinTilesY = (NumTilesY + NUM_BINS_Y - 1) / NUM_BINS_Y;
+
+    bUseAVX2 = inConfig.bUseSIMD && CullingSIMD::IsAVX2Supported();
+
+    Depth.assign((uint64)Width * Height, 0.0f);
+    TileFarthestDepth.assign((uint64)NumTilesX * NumTilesY, 0.0f);
+    Bins.assign(NUM_BINS_X * NUM_BINS_Y, { });
+
+    VE_CORE_LOG_INFO(VE_TEXT("[OcclusionCuller]: {0}x{1} depth buffer, {2} rasterizer"), Width, Height, bUseAVX2 ? "AVX2" : "scalar");
+}
+
+void OcclusionCuller::BeginFrame()
+{
+    std::fill(Depth.begin(), Depth.end(), 0.0f);
+    std::fill(TileFarthestDepth.begin(), TileFarthestDepth.end(), 0.0f);
+
+    Triangles.clear();
+    for (std::vector<uint32>& Bin : Bins)
+    {
+        Bin.clear();
+    }
+
+    Stats = FOcclusionCullerStats();
+}
+
+void OcclusionCuller::AddOccluder(const Vector3D* inPositions, const uint32* inIndices, uint32 inNumIndices, const FFloat4x4& inWorldViewProjection)
+{
+    VE_ASSERT(inNumIndices % 3 == 0, VE_TEXT("[OcclusionCuller]: An occluder needs three indices per triangle, it has {0}"), inNumIndices);
+
+    // Every vertex is transformed once, even if the occluder shares it between triangles
+    uint32 NumVertices = 0;
+    for (uint32 i = 0; i < inNumIndices; ++i)
+    {
+        NumVertices = MathUtils::Max(NumVertices, inIndices[i] + 1);
+    }
+
+    ClipVertices.resize(NumVertices);
+    for (uint32 i = 0; i < NumVertices; ++i)
+    {
+        ClipVertices[i] = OcclusionCullerHelpers::TransformPosition(inPositions[i], inWorldViewProjection);
+    }
+
+    for (uint32 i = 0; i < inNumIndices; i += 3)
+    {
+        AddTriangle(ClipVertices[inIndices[i]], ClipVertices[inIndices[i + 1]], ClipVertices[inIndices[i + 2]]);
+    }
+
+    Stats.NumOccluderTriangles += inNumIndices / 3;
+}
+
+void OcclusionCuller::AddTriangle(const Vector4D& inV0, const Vector4D& inV1, const Vector4D& inV2)
+{
+    using namespace OcclusionCullerHelpers;
+
+    const uint32 OutCode0 = GetClipOutCode(inV0, GUARD_BAND);
+    const uint32 OutCode1 = GetClipOutCode(inV1, GUARD_BAND);
+    const uint32 OutCode2 = GetClipOutCode(inV2, GUARD_BAND);
+
+    // Every vertex outside the same plane
+    if ((OutCode0 & OutCode1 & OutCode2) != 0)
+    {
+        return;
+    }
+
+    if ((OutCode0 | OutCode1 | OutCode2) == 0)
+    {
+        BinTriangle(inV0, inV1, inV2);
+        return;
+    }
+
+    // Sutherland-Hodgman, each plane adds at most one vertex
+    Vector4D Polygons[2][3 + NUM_CLIP_PLANES];
+    uint32 NumVertices = 3;
+    Polygons[0][0] = inV0;
+    Polygons[0][1] = inV1;
+    Polygons[0][2] = inV2;
+
+    uint32 Current = 0;
+    const uint32 OutCodes = OutCode0 | OutCode1 | OutCode2;
+    for (uint32 Plane = 0; Plane < NUM_CLIP_PLANES && NumVertices >= 3; ++Plane)
+    {
+        if ((OutCodes & (1 << Plane)) == 0)
+        {
+            continue;
+        }
+
+        const Vector4D* Input = Polygons[Current];
+        Vector4D* Output = Polygons[Current ^ 1];
+
+        uint32 NumOutputVertices = 0;
+        for (uint32 i = 0; i < NumVertices; ++i)
+        {
+            const Vector4D& Vertex = Input[i];
+            const Vector4D& NextVertex = Input[(i + 1) % NumVertices];
+
+            const float Distance = GetClipDistance(Vertex, Plane, GUARD_BAND);
+            const float NextDistance = GetClipDistance(NextVertex, Plane, GUARD_BAND);
+
+            if (Distance >= 0.0f)
+            {
+                Output[NumOutputVertices++] = Vertex;
+            }
+
+            if ((Distance >= 0.0f) != (NextDistance >= 0.0f))
+            {
+                Output[NumOutputVertices++] = LerpVertex(Vertex, NextVertex, Distance / (Distance - NextDistance));
+            }
+        }
+
+        NumVertices = NumOutputVertices;
+        Current ^= 1;
+    }
+
+    // Fan the convex polygon left
+    for (uint32 i = 2; i < NumVertices; ++i)
+    {
+        BinTriangle(Polygons[Current][0], Polygons[Current][i - 1], Polygons[Current][i]);
+    }
+}
+
+void OcclusionCuller::BinTriangle(const Vector4D& inV0, const Vector4D& inV1, const Vector4D& inV2)
+{
+    const Vector4D* Vertices[3] = { &inV0, &inV1, &inV2 };
+
+    float X[3];
+    float Y[3];
+    float Z[3];
+    for (uint32 i = 0; i < 3; ++i)
+    {
+        // Clipped against the near plane, w > 0
+        const float InvW = 1.0f / Vertices[i]->W;
+        X[i] = (Vertices[i]->X * InvW + 1.0f) * (Width * 0.5f);
+        Y[i] = (Vertices[i]->Y * InvW + 1.0f) * (Height * 0.5f);
+        Z[i] = InvW;
+    }
+
+    float Area = (X[1] - X[0]) * (Y[2] - Y[0]) - (X[2] - X[0]) * (Y[1] - Y[0]);
+    if (Area == 0.0f)
+    {
+        return;
+    }
+
+    FOcclusionTriangle Triangle;
+    Triangle.MinX = MathUtils::Max((int32)floorf(MathUtils::Min(X[0], MathUtils::Min(X[1], X[2]))), 0);
+    Triangle.MinY = MathUtils::Max((int32)floorf(MathUtils::Min(Y[0], MathUtils::Min(Y[1], Y[2]))), 0);
+    Triangle.MaxX = MathUtils::Min((int32)floorf(MathUtils::Max(X[0], MathUtils::Max(X[1], X[2]))), (int32)Width - 1);
+    Triangle.MaxY = MathUtils::Min((int32)floorf(MathUtils::Max(Y[0], MathUtils::Max(Y[1], Y[2]))), (int32)Height - 1);
+    if (Triangle.MinX > Triangle.MaxX || Triangle.MinY > Triangle.MaxY)
+    {
+        return;
+    }
+
+    // Edge i is opposite to vertex i, its function is Area at vertex i and 0 on the edge.
+    // Both windings are rasterized, clockwise triangles are flipped so the inside is always positive
+    const float Sign = Area > 0.0f ? 1.0f : -1.0f;
+    for (uint32 i = 0; i < 3; ++i)
+    {
+        const uint32 j = (i + 1) % 3;
+        const uint32 k = (i + 2) % 3;
+
+        Triangle.EdgeA[i] = Sign * (Y[j] - Y[k]);
+        Triangle.EdgeB[i] = Sign * (X[k] - X[j]);
+        Triangle.EdgeC[i] = Sign * (X[j] * Y[k] - X[k] * Y[j]);
+    }
+
+    // Depth is the barycentric blend of the vertices, the edge functions over the area are the barycentrics
+    const float InvArea = 1.0f / (Sign * Area);
+    Triangle.DepthA = (Z[0] * Triangle.EdgeA[0] + Z[1] * Triangle.EdgeA[1] + Z[2] * Triangle.EdgeA[2]) * InvArea;
+    Triangle.DepthB = (Z[0] * Triangle.EdgeB[0] + Z[1] * Triangle.EdgeB[1] + Z[2] * Triangle.EdgeB[2]) * InvArea;
+    Triangle.DepthC = (Z[0] * Triangle.EdgeC[0] + Z[1] * Triangle.EdgeC[1] + Z[2] * Triangle.EdgeC[2]) * InvArea;
+    Triangle.MaxDepth = MathUtils::Max(Z[0], MathUtils::Max(Z[1], Z[2]));
+
+    const uint32 TriangleIndex = (uint32)Triangles.size();
+    Triangles.push_back(Triangle);
+    Stats.NumBinnedTriangles++;
+
+    const uint32 MinBinX = (Triangle.MinX / TILE_WIDTH) / BinTilesX;
+    const uint32 MaxBinX = (Triangle.MaxX / TILE_WIDTH) / BinTilesX;
+    const uint32 MinBinY = (Triangle.MinY / TILE_HEIGHT) / BinTilesY;
+    const uint32 MaxBinY = (Triangle.MaxY / TILE_HEIGHT) / BinTilesY;
+    for (uint32 BinY = MinBinY; BinY <= MaxBinY; ++BinY)
+    {
+        for (uint32 BinX = MinBinX; BinX <= MaxBinX; ++BinX)
+        {
+            Bins[BinY * NUM_BINS_X + BinX].push_back(TriangleIndex);
+        }
+    }
+}
+
+void OcclusionCuller::Rasterize()
+{
+    typedef std::chrono::high_resolution_clock Clock;
+    auto Start = Clock::now();
+
+    if (Config.TaskScheduler != nullptr)
+    {
+        FBinTask Task;
+        Task.Culler = this;
+        Task.m_SetSize = (uint32)Bins.size();
+        Task.m_MinRange = 1;
+
+        Config.TaskScheduler->AddTaskSetToPipe(&Task);
+        Config.TaskScheduler->WaitforTask(&Task);
+    }
+    else
+    {
+        for (uint32 i = 0; i < Bins.size(); ++i)
+        {
+            RasterizeBin(i);
+        }
+    }
+
+    Stats.RasterizeTimeMs = std::chrono::duration<float, std::milli>(Clock::now() - Start).count();
+}
+
+void OcclusionCuller::RasterizeBin(uint32 inBinIndex)
+{
+    const std::vector<uint32>& Bin = Bins[inBinIndex];
+    if (Bin.empty())
+    {
+        return;
+    }
+
+    const uint32 BinMinTileX = (inBinIndex % NUM_BINS_X) * BinTilesX;
+    const uint32 BinMinTileY = (inBinIndex / NUM_BINS_X) * BinTilesY;
+    const uint32 BinMaxTileX = MathUtils::Min(BinMinTileX + BinTilesX, NumTilesX) - 1;
+    const uint32 BinMaxTileY = MathUtils::Min(BinMinTileY + BinTilesY, NumTilesY) - 1;
+
+    for (uint32 TriangleIndex : Bin)
+    {
+        const FOcclusionTriangle& Triangle = Triangles[TriangleIndex];
+
+        const uint32 MinTileX = MathUtils::Max((uint32)Triangle.MinX / TILE_WIDTH, BinMinTileX);
+        const uint32 MinTileY = MathUtils::Max((uint32)Triangle.MinY / TILE_HEIGHT, BinMinTileY);
+        const uint32 MaxTileX = MathUtils::Min((uint32)Triangle.MaxX / TILE_WIDTH, BinMaxTileX);
+        const uint32 MaxTileY = MathUtils::Min((uint32)Triangle.MaxY / TILE_HEIGHT, BinMaxTileY);
+
+        for (uint32 TileY = MinTileY; TileY <= MaxTileY; ++TileY)
+        {
+            for (uint32 TileX = MinTileX; TileX <= MaxTileX; ++TileX)
+            {
+                const uint32 TileIndex = TileY * NumTilesX + TileX;
+
+                // Every pixel of the tile is already nearer than the whole triangle
+                if (Triangle.MaxDepth <= TileFarthestDepth[TileIndex])
+                {
+                    continue;
+                }
+
+                float* TileDepth = Depth.data() + (uint64)TileIndex * TILE_SIZE;
+                const float TilePixelX = (float)(TileX * TILE_WIDTH);
+                const float TilePixelY = (float)(TileY * TILE_HEIGHT);
+
+                TileFarthestDepth[TileIndex] = bUseAVX2
+                    ? OcclusionCullerHelpers::RasterizeTileAVX2(TileDepth, Triangle, TilePixelX, TilePixelY, TILE_HEIGHT)
+                    : OcclusionCullerHelpers::RasterizeTileScalar(TileDepth, Triangle, TilePixelX, TilePixelY, TILE_WIDTH, TILE_HEIGHT);
+            }
+        }
+    }
+}
+
+bool OcclusionCuller::IsVisible(const Vector3D& inBoundsMin, const Vector3D& inBoundsMax, const FFloat4x4& inWorldViewProjection) const
+{
+    float MinX = FLT_MAX;
+    float MinY = FLT_MAX;
+    float MaxX = -FLT_MAX;
+    float MaxY = -FLT_MAX;
+    float NearestDepth = 0.0f;
+
+    for (uint32 i = 0; i < 8; ++i)
+    {
+        const Vector3D Corner((i & 1) ? inBoundsMax.X : inBoundsMin.X, (i & 2) ? inBoundsMax.Y : inBoundsMin.Y, (i & 4) ? inBoundsMax.Z : inBoundsMin.Z);
+        const Vector4D ClipCorner = OcclusionCullerHelpers::TransformPosition(Corner, inWorldViewProjection);
+
+        // The box reaches the camera, its projection is unbounded
+        if (ClipCorner.Z < 0.0f || ClipCorner.W <= 0.0f)
+        {
+            return true;
+        }
+
+        const float InvW = 1.0f / ClipCorner.W;
+        const float X = (ClipCorner.X * InvW + 1.0f) * (Width * 0.5f);
+        const float Y = (ClipCorner.Y * InvW + 1.0f) * (Height * 0.5f);
+
+        MinX = MathUtils::Min(MinX, X);
+        MinY = MathUtils::Min(MinY, Y);
+        MaxX = MathUtils::Max(MaxX, X);
+        MaxY = MathUtils::Max(MaxY, Y);
+        NearestDepth = MathUtils::Max(NearestDepth, InvW);
+    }
+
+    if (MaxX < 0.0f || MaxY < 0.0f || MinX >= (float)Width || MinY >= (float)Height)
+    {
+        return false;
+    }
+
+    // Every pixel the box touches, the occluders are only sampled at pixel centers so this is the conservative side
+    const uint32 MinPixelX = (uint32)MathUtils::Max(MinX, 0.0f);
+    const uint32 MinPixelY = (uint32)MathUtils::Max(MinY, 0.0f);
+    const uint32 MaxPixelX = (uint32)MathUtils::Min(MaxX, (float)Width - 1.0f);
+    const uint32 MaxPixelY = (uint32)MathUtils::Min(MaxY, (float)Height - 1.0f);
+
+    // A little nearer, so an occluder does not hide its own bounds where both are the same surface
+    NearestDepth *= 1.0001f;
+
+    for (uint32 TileY = MinPixelY / TILE_HEIGHT; TileY <= MaxPixelY / TILE_HEIGHT; ++TileY)
+    {
+        for (uint32 TileX = MinPixelX / TILE_WIDTH; TileX <= MaxPixelX / TILE_WIDTH; ++TileX)
+        {
+            const uint32 TileIndex = TileY * NumTilesX + TileX;
+            if (TileFarthestDepth[TileIndex] > NearestDepth)
+            {
+                continue;
+            }
+
+            const uint32 TilePixelX = TileX * TILE_WIDTH;
+            const uint32 TilePixelY = TileY * TILE_HEIGHT;
+
+            const uint32 TileMinX = MathUtils::Max(MinPixelX, TilePixelX) - TilePixelX;
+            const uint32 TileMinY = MathUtils::Max(MinPixelY, TilePixelY) - TilePixelY;
+            const uint32 TileMaxX = MathUtils::Min(MaxPixelX, TilePixelX + TILE_WIDTH - 1) - TilePixelX;
+            const uint32 TileMaxY = MathUtils::Min(MaxPixelY, TilePixelY + TILE_HEIGHT - 1) - TilePixelY;
+
+            const float* TileDepth = Depth.data() + (uint64)TileIndex * TILE_SIZE;
+            const bool bIsVisible = bUseAVX2
+                ? OcclusionCullerHelpers::IsAnyPixelVisibleAVX2(TileDepth, TileMinX, TileMaxX, TileMinY, TileMaxY, NearestDepth)
+                : OcclusionCullerHelpers::IsAnyPixelVisibleScalar(TileDepth, TileMinX, TileMaxX, TileMinY, TileMaxY, NearestDepth, TILE_WIDTH);
+
+            if (bIsVisible)
+            {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+float OcclusionCuller::GetDepth(uint32 inX, uint32 inY) const
+{
+    VE_ASSERT(inX < Width && inY < Height, VE_TEXT("[OcclusionCuller]: Pixel ({0}, {1}) is outside of the {2}x{3} depth buffer"), inX, inY, Width, Height);
+
+    const uint32 TileIndex = (inY / TILE_HEIGHT) * NumTilesX + (inX / TILE_WIDTH);
+    return Depth[(uint64)TileIndex * TILE_SIZE + (inY % TILE_HEIGHT) * TILE_WIDTH + (inX % TILE_WIDTH)];
+}
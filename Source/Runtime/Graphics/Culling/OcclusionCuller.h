@@ -0,0 +1,200 @@
+/**
+* This file is part of the "Vrixic Engine" project (Copyright (c) 2022-2023 by Vrij Patel)
+* See "LICENSE.txt" for license information.
+*/
+
+#pragma once
+#include <Core/Core.h>
+#include <Misc/Defines/GenericDefines.h>
+#include <Runtime/Core/Math/Vector4D.h>
+#include "CullingMatrix.h"
+
+#include <vector>
+
+namespace enki
+{
+    class TaskScheduler;
+}
+
+struct FOcclusionCullerConfig
+{
+public:
+    /** Resolution of the depth buffer, rounded up to whole tiles. Occluders only need to be coarse, a few hundred pixels wide is enough */
+    uint32 Width = 320;
+    uint32 Height = 192;
+
+    /** false forces the scalar rasterizer even if the cpu supports AVX2, it is the reference the AVX2 one is checked against */
+    bool bUseSIMD = true;
+
+    /** Optional, when set the bins are rasterized across the worker threads */
+    enki::TaskScheduler* TaskScheduler = nullptr;
+};
+
+struct FOcclusionCullerStats
+{
+public:
+    /** Triangles given to AddOccluder() since the last BeginFrame() */
+    uint32 NumOccluderTriangles = 0;
+
+    /** Triangles left after clipping, back of the near plane, off screen and degenerate ones are dropped */
+    uint32 NumBinnedTriangles = 0;
+
+    float RasterizeTimeMs = 0.0f;
+};
+
+/**
+* A triangle ready to be rasterized, in pixels
+*/
+struct FOcclusionTriangle
+{
+public:
+    /** Edge functions E(x, y) = A * x + B * y + C, a pixel center is covered if all three are >= 0 */
+    float EdgeA[3];
+    float EdgeB[3];
+    float EdgeC[3];
+
+    /** 1 / w is linear in screen space, Z(x, y) = DepthA * x + DepthB * y + DepthC */
+    float DepthA;
+    float DepthB;
+    float DepthC;
+
+    /** Nearest depth (biggest 1 / w) of the triangle, the triangle is skipped on tiles already nearer than it */
+    float MaxDepth;
+
+    /** Pixels the triangle can cover, inclusive and clamped to the depth buffer */
+    int32 MinX;
+    int32 MinY;
+    int32 MaxX;
+    int32 MaxY;
+};
+
+/**
+* Software occlusion culling, low poly occluders are rasterized into a coarse depth buffer on the cpu and
+*   the screen space bounds of the meshes are tested against it, meshes hidden behind the occluders are not drawn
+*
+* The depth buffer stores 1 / w (0 is infinitely far, nearer is bigger) so it can be interpolated linearly in screen space.
+* It is split in 8x8 pixel tiles stored one after the other, each tile also keeps its farthest depth (a one level hierarchy):
+*   occluder triangles skip tiles already nearer than them and most bounds tests are answered from the tiles alone.
+* Triangles are binned by screen region when added, every bin is then rasterized by one task so no two tasks write the same tile.
+* The rasterizer and the tests run 8 pixels at a time with AVX2 when the cpu has it, a scalar path computing the same values is the fallback
+*
+* Usage: BeginFrame(), AddOccluder() for every occluder, Rasterize(), then IsVisible() from any number of threads
+*/
+class VRIXIC_API OcclusionCuller
+{
+public:
+    OcclusionCuller();
+
+    void Init(const FOcclusionCullerConfig& inConfig);
+
+    /**
+    * Clears the depth buffer and the occluders of the last frame
+    */
+    void BeginFrame();
+
+    /**
+    * Transforms, clips and bins the triangles of an occluder, they are rasterized by the next Rasterize()
+    *
+    * @param inIndices three per triangle, both windings are rasterized
+    * @param inWorldViewProjection row vector transform from the occluder's local space to clip space (Vulkan, depth in [0, 1])
+    */
+    void AddOccluder(const Vector3D* inPositions, const uint32* inIndices, uint32 inNumIndices, const FFloat4x4& inWorldViewProjection);
+
+    /**
+    * Rasterizes every occluder added since BeginFrame()
+    */
+    void Rasterize();
+
+    /**
+    * Conservative, a box crossing the near plane or that might show through between the occluders is visible
+    *
+    * @returns bool false if the box is hidden by the rasterized occluders or is off screen
+    */
+    bool IsVisible(const Vector3D& inBoundsMin, const Vector3D& inBoundsMax, const FFloat4x4& inWorldViewProjection) const;
+
+public:
+    inline uint32 GetWidth() const
+    {
+        return Width;
+    }
+
+    inline uint32 GetHeight() const
+    {
+        return Height;
+    }
+
+    /**
+    * @returns float 1 / w of the nearest occluder at the pixel, 0 if none covers it. Row 0 is clip space y = -1
+    */
+    float GetDepth(uint32 inX, uint32 inY) const;
+
+    /**
+    * @returns bool true if the AVX2 rasterizer is in use
+    */
+    inline bool IsUsingAVX2() const
+    {
+        return bUseAVX2;
+    }
+
+    inline const FOcclusionCullerStats& GetStats() const
+    {
+        return Stats;
+    }
+
+private:
+    /**
+    * Clips a triangle against the near plane and the guard band, the triangles left are set up and binned
+    */
+    void AddTriangle(const Vector4D& inV0, const Vector4D& inV1, const Vector4D& inV2);
+
+    /**
+    * Sets up the edge and depth equations of a clipped triangle and adds it to the bins it overlaps
+    */
+    void BinTriangle(const Vector4D& inV0, const Vector4D& inV1, const Vector4D& inV2);
+
+    void RasterizeBin(uint32 inBinIndex);
+
+private:
+    struct FBinTask;
+
+    /** Dimensions of a tile in pixels, one AVX2 register holds a row */
+    static constexpr uint32 TILE_WIDTH = 8;
+    static constexpr uint32 TILE_HEIGHT = 8;
+    static constexpr uint32 TILE_SIZE = TILE_WIDTH * TILE_HEIGHT;
+
+    /** The screen is split in NUM_BINS_X * NUM_BINS_Y bins (of whole tiles), the unit of work of the rasterizer */
+    static constexpr uint32 NUM_BINS_X = 4;
+    static constexpr uint32 NUM_BINS_Y = 4;
+
+    /** Triangles are clipped to GUARD_BAND times the screen so their edge equations stay precise */
+    static constexpr float GUARD_BAND = 4.0f;
+
+    FOcclusionCullerConfig Config;
+
+    uint32 Width;
+    uint32 Height;
+    uint32 NumTilesX;
+    uint32 NumTilesY;
+
+    /** Size of a bin in tiles, the last row and column of bins can be smaller */
+    uint32 BinTilesX;
+    uint32 BinTilesY;
+
+    bool bUseAVX2;
+
+    /** 1 / w per pixel, tile after tile, rows of a tile one after the other */
+    std::vector<float> Depth;
+
+    /** Farthest depth of every tile */
+    std::vector<float> TileFarthestDepth;
+
+    std::vector<FOcclusionTriangle> Triangles;
+
+    /** Bin -> triangles overlapping it, in the order they were added */
+    std::vector<std::vector<uint32>> Bins;
+
+    /** Kept around so adding an occluder does not allocate */
+    std::vector<Vector4D> ClipVertices;
+
+    FOcclusionCullerStats Stats;
+};
@@ -18,7 +18,7 @@ class IDescriptorSets;
 struct VRIXIC_API FDescriptorSetsConfig
 {
 public:
-    FDescriptorSetsConfig() : NumSets(1), PipelineLayoutPtr(nullptr), bIsBindlessSet(false){ }
+    FDescriptorSetsConfig() : NumSets(1), PipelineLayoutPtr(nullptr), bIsBindlessSet(false) { }
 
     ~FDescriptorSetsConfig() { }
 
@@ -99,6 +99,15 @@ enum class EPixelFormat
     D24UNormS8UInt,         // depth 24-bit normalized unsigned integer component, and 8-bit unsigned integer stencil 
     D32Float,               // depth 32-bit floating point 
     D32FloatS8X24UInt,      // depth 32-bit floating point component, and 8-bit unsigned integer stencil components (where the remaining 24 bits are unused).
-    S8UInt                  // Stencil only format: 8-bit unsigned integer stencil
+    S8UInt,                 // Stencil only format: 8-bit unsigned integer stencil
+
+    /* Block compressed formats, 4x4 texel blocks */
+    BC1RGBAUNorm,           // red | green | blue | 1-bit alpha, 8 bytes per block
+    BC1RGBAUNorm_sRGB,      // red | green | blue | 1-bit alpha, 8 bytes per block, in non-linear sRGB color space.
+    BC3UNorm,               // red | green | blue | alpha, 16 bytes per block
+    BC3UNorm_sRGB,          // red | green | blue | alpha, 16 bytes per block, in non-linear sRGB color space.
+    BC5UNorm,               // red | green, two channels of 8 bytes each per block (ex: tangent space normal maps)
+    BC7UNorm,               // red | green | blue | alpha, 16 bytes per block, higher quality than BC3
+    BC7UNorm_sRGB           // red | green | blue | alpha, 16 bytes per block, higher quality than BC3, in non-linear sRGB color space.
 
 };
\ No newline at end of file
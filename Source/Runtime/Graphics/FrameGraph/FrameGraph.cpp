@@ -1,10 +1,18 @@
 #include "FrameGraph.h"
 
+#include <Runtime/Core/Algorithms/Hashing/XXHash64.h>
 #include <Runtime/File/FileHelper.h>
+#include <Runtime/File/FileReader.h>
+#include <Runtime/Graphics/ICommandBufferManager.h>
 #include <Runtime/Graphics/Renderer.h>
 
+#include <External/enkiTS/Includes/TaskScheduler.h>
+
 #include <External/json/Includes/nlohmann_json/json.hpp>
 
+#include <algorithm>
+#include <chrono>
+
 namespace FrameGraphHelpers
 {
     static EFrameGraphResourceType StringToResourceType(const std::string& inInputType)
@@ -123,10 +131,178 @@ namespace FrameGraphHelpers
             return EAttachmentLoadOp::Undefined;
     }
 
+    static ERenderQueueType StringToQueueType(const std::string& inInputType)
+    {
+        if (strcmp(inInputType.c_str(), "graphics") == 0)
+        {
+            return ERenderQueueType::Graphics;
+        }
+
+        if (strcmp(inInputType.c_str(), "compute") == 0)
+        {
+            return ERenderQueueType::Compute;
+        }
+
+        if (strcmp(inInputType.c_str(), "transfer") == 0)
+        {
+            return ERenderQueueType::Transfer;
+        }
+
+        VE_ASSERT(false, VE_TEXT("[FrameGraphHelpers]: Error: cannot identify queue type from string..."))
+            return ERenderQueueType::Graphics;
+    }
+
     static bool HasDepthOrStencil(EPixelFormat inFormat)
     {
         return inFormat >= EPixelFormat::D16UNorm && inFormat <= EPixelFormat::D32FloatS8X24UInt;
     }
+
+    /**
+    * @param inUsageBindFlags bind flags for the uses of the attachment other than being rendered to (sampled, storage, transfer)
+    */
+    static FTextureConfig MakeAttachmentConfig(const FFrameGraphResourceInfo& inInfo, uint32 inUsageBindFlags)
+    {
+        FTextureConfig Config = { };
+        Config.Format = inInfo.TextureResourceInfo.Format;
+        Config.Type = ETextureType::Texture2D;
+
+        Config.Extent.Width = inInfo.TextureResourceInfo.Width;
+        Config.Extent.Height = inInfo.TextureResourceInfo.Height;
+        Config.Extent.Depth = inInfo.TextureResourceInfo.Depth;
+
+        Config.BindFlags |= FResourceBindFlags::ColorAttachment;
+
+        if (HasDepthOrStencil(Config.Format))
+        {
+            Config.BindFlags = 0;
+            Config.BindFlags |= FResourceBindFlags::DepthStencilAttachment;
+        }
+
+        Config.BindFlags |= inUsageBindFlags;
+
+        return Config;
+    }
+
+    /**
+    * @returns ETextureLayout the layout a node uses a resource in, sampled for texture inputs and attachment otherwise.
+    *   Compute nodes write to storage images and transfer nodes copy from their inputs to their outputs
+    *
+    * @param inIsOutput true if the node outputs the resource, false if it is one of its inputs
+    */
+    static ETextureLayout GetResourceLayout(const FFrameGraphResource& inResource, bool inIsOutput, ERenderQueueType inQueueType)
+    {
+        if (inQueueType == ERenderQueueType::Transfer)
+        {
+            return inIsOutput ? ETextureLayout::TransferDstOptimal : ETextureLayout::TransferSrcOptimal;
+        }
+
+        if (inQueueType == ERenderQueueType::Compute && (inIsOutput || inResource.Type == EFrameGraphResourceType::Attachment))
+        {
+            return ETextureLayout::General;
+        }
+
+        const bool bIsDepthStencil = HasDepthOrStencil(inResource.ResourceInfo.TextureResourceInfo.Format);
+        if (inResource.Type == EFrameGraphResourceType::Texture)
+        {
+            return bIsDepthStencil ? ETextureLayout::DepthStencilReadOnly : ETextureLayout::ShaderReadOnlyOptimal;
+        }
+
+        return bIsDepthStencil ? ETextureLayout::DepthStencilAttachment : ETextureLayout::ColorAttachment;
+    }
+
+    static bool IsWriteLayout(ETextureLayout inLayout)
+    {
+        return inLayout == ETextureLayout::ColorAttachment || inLayout == ETextureLayout::DepthStencilAttachment || inLayout == ETextureLayout::TransferDstOptimal
+            || inLayout == ETextureLayout::General;
+    }
+
+    /**
+    * @returns uint32 bind flags a node on the queue needs to use the resource, besides rendering to it
+    */
+    static uint32 GetUsageBindFlags(const FFrameGraphResource& inResource, bool inIsOutput, ERenderQueueType inQueueType)
+    {
+        switch (GetResourceLayout(inResource, inIsOutput, inQueueType))
+        {
+        case ETextureLayout::General:
+            return FResourceBindFlags::StorageImage;
+        case ETextureLayout::TransferSrcOptimal:
+            return FResourceBindFlags::SrcTransfer;
+        case ETextureLayout::TransferDstOptimal:
+            return FResourceBindFlags::DstTransfer;
+        case ETextureLayout::ShaderReadOnlyOptimal:
+        case ETextureLayout::DepthStencilReadOnly:
+            return FResourceBindFlags::Sampled;
+        default:
+            return 0;
+        }
+    }
+
+    static uint64 BytesToMebibytes(uint64 inBytes)
+    {
+        return (inBytes + (1024 * 1024) - 1) / (1024 * 1024);
+    }
+
+    static const char* QueueTypeToString(ERenderQueueType inQueueType)
+    {
+        switch (inQueueType)
+        {
+        case ERenderQueueType::Compute:
+            return "compute";
+        case ERenderQueueType::Transfer:
+            return "transfer";
+        default:
+            return "graphics";
+        }
+    }
+
+    static std::string FormatMs(float inMilliseconds)
+    {
+        char Buffer[32];
+        snprintf(Buffer, sizeof(Buffer), "%.3f", inMilliseconds);
+        return Buffer;
+    }
+
+    /**
+    * @returns std::string the path of the json with its extension replaced by .vfg
+    */
+    static std::string GetPrecompiledPath(const std::string& inFilePath)
+    {
+        const uint64 FolderEnd = inFilePath.find_last_of("/\\");
+        const uint64 ExtensionStart = inFilePath.find_last_of('.');
+
+        if (ExtensionStart == std::string::npos || (FolderEnd != std::string::npos && ExtensionStart < FolderEnd))
+        {
+            return inFilePath + ".vfg";
+        }
+
+        return inFilePath.substr(0, ExtensionStart) + ".vfg";
+    }
+
+    /**
+    * @returns bool true if a precompiled plan placed exactly these attachments, alive on the same nodes, with the same memory requirements
+    */
+    static bool IsSamePlan(const FFrameGraphPrecompiled& inPrecompiled, const std::vector<FFrameGraphPrecompiledTransient>& inTransients)
+    {
+        if (!inPrecompiled.bHasPlacements || inPrecompiled.Transients.size() != inTransients.size())
+        {
+            return false;
+        }
+
+        for (uint32 i = 0; i < inTransients.size(); ++i)
+        {
+            const FFrameGraphPrecompiledTransient& A = inPrecompiled.Transients[i];
+            const FFrameGraphPrecompiledTransient& B = inTransients[i];
+
+            if (A.Resource != B.Resource || A.FirstUse != B.FirstUse || A.LastUse != B.LastUse || A.UsageBindFlags != B.UsageBindFlags
+                || A.Requirements.Size != B.Requirements.Size || A.Requirements.Alignment != B.Requirements.Alignment
+                || A.Requirements.MemoryTypeBits != B.Requirements.MemoryTypeBits)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
 }
 
 void FrameGraph::Init(FrameGraphBuilder* inBuilder)
@@ -136,12 +312,28 @@ void FrameGraph::Init(FrameGraphBuilder* inBuilder)
 
 void FrameGraph::Shutdown()
 {
+    std::vector<uint64> EnabledMasks;
+    for (auto It = Compilations.Begin(); It != Compilations.End(); ++It)
+    {
+        ReleaseCompilation(It->second);
+        delete It->second;
+
+        EnabledMasks.push_back(It->first);
+    }
+
+    for (uint64 EnabledMask : EnabledMasks)
+    {
+        Compilations.Remove(EnabledMask);
+    }
+
+    ReleaseRetiredCompilations();
+
+    ActiveCompilation = nullptr;
+    Nodes.clear();
 }
 
 void FrameGraph::Parse(const std::string inFilePath)
 {
-    using json = nlohmann::json;
-
     if (!FileHelper::DoesFileExist(inFilePath))
     {
         VE_CORE_LOG_ERROR(VE_TEXT("[FrameGraph]: Cannot find specified file: {0}"), inFilePath);
@@ -155,21 +347,37 @@ void FrameGraph::Parse(const std::string inFilePath)
         return;
     }
 
-    json GraphData = json::parse(Result);
+    SourceHash = XXHash64::Hash(Result.data(), Result.size());
+    PrecompiledPath = FrameGraphHelpers::GetPrecompiledPath(inFilePath);
+    FirstResourceHandle = GraphBuilder->GetNumResources();
+
+    if (LoadPrecompiled(PrecompiledPath))
+    {
+        return;
+    }
+
+    ParseJson(Result);
+}
+
+void FrameGraph::ParseJson(const std::string& inJson)
+{
+    using json = nlohmann::json;
+
+    json GraphData = json::parse(inJson);
 
     // Get the graph name 
     Name = GraphData.value("name", "");
 
     // get all the render passes
-    json RenderPasses = GraphData["passes"];
+    json& RenderPasses = GraphData["passes"];
 
     // Parse the nodes 
     for (uint64 i = 0; i < RenderPasses.size(); ++i)
     {
-        json RenderPass = RenderPasses[i];
+        json& RenderPass = RenderPasses[i];
 
-        json PassInputs = RenderPass["inputs"];
-        json PassOutputs = RenderPass["outputs"];
+        json& PassInputs = RenderPass["inputs"];
+        json& PassOutputs = RenderPass["outputs"];
 
         FFrameGraphNodeCreation NodeCreation = { };
         NodeCreation.Inputs.resize(PassInputs.size());
@@ -178,7 +386,7 @@ void FrameGraph::Parse(const std::string inFilePath)
         // Parse the inputs
         for (uint64 inputIndex = 0; inputIndex < PassInputs.size(); ++inputIndex)
         {
-            json PassInput = PassInputs[inputIndex];
+            json& PassInput = PassInputs[inputIndex];
 
             FFrameGraphResourceInputCreation InputCreation = { };
 
@@ -193,7 +401,7 @@ void FrameGraph::Parse(const std::string inFilePath)
         // Parse the outputs 
         for (uint64 outputIndex = 0; outputIndex < PassOutputs.size(); ++outputIndex)
         {
-            json PassOutput = PassOutputs[outputIndex];
+            json& PassOutput = PassOutputs[outputIndex];
 
             FFrameGraphResourceOutputCreation OutputCreation = { };
 
@@ -208,7 +416,7 @@ void FrameGraph::Parse(const std::string inFilePath)
                 OutputCreation.ResourceInfo.TextureResourceInfo.Format = FrameGraphHelpers::StringToPixelFormat(PassOutput.value("format", ""));
                 OutputCreation.ResourceInfo.TextureResourceInfo.LoadOp = FrameGraphHelpers::StringToRenderPassOp(PassOutput.value("op", ""));
 
-                json Resolution = PassOutput["resolution"];
+                json& Resolution = PassOutput["resolution"];
                 OutputCreation.ResourceInfo.TextureResourceInfo.Width = Resolution[0];
                 OutputCreation.ResourceInfo.TextureResourceInfo.Height = Resolution[1];
                 OutputCreation.ResourceInfo.TextureResourceInfo.Depth = 1;
@@ -228,370 +436,1635 @@ void FrameGraph::Parse(const std::string inFilePath)
 
         NodeCreation.Name = RenderPass.value("name", "");
         NodeCreation.bIsEnabled = RenderPass.value("enabled", true);
+        NodeCreation.QueueType = FrameGraphHelpers::StringToQueueType(RenderPass.value("queue", "graphics"));
 
-        FFrameGraphNode* Node = GraphBuilder->CreateNode(NodeCreation);
-        Nodes.push_back(Node);
+        ParsedNodes.push_back(GraphBuilder->CreateNode(NodeCreation));
     }
-}
 
-void FrameGraph::Reset()
-{
+    const json GraphOutputNames = GraphData.value("outputs", json::array());
+    for (uint64 i = 0; i < GraphOutputNames.size(); ++i)
+    {
+        MarkOutput(StringHash::GetStringHash(GraphOutputNames[i].get<std::string>().c_str()));
+    }
 }
 
-void FrameGraph::EnableRenderPass(std::string inRenderPassName)
+bool FrameGraph::LoadPrecompiled(const std::string& inFilePath)
 {
-    FFrameGraphNode* Node = GraphBuilder->GetNode(inRenderPassName);
-    Node->bIsEnabled = true;
-}
+    if (!FileHelper::DoesFileExist(inFilePath))
+    {
+        return false;
+    }
 
-void FrameGraph::DisableRenderPass(std::string inRenderPassName)
-{
-    FFrameGraphNode* Node = GraphBuilder->GetNode(inRenderPassName);
-    Node->bIsEnabled = false;
-}
+    FFileReaderConfig ReaderConfig = { };
+    ReaderConfig.Mode = EFileReadMode::MemoryMapped;
+    ReaderConfig.AccessHint = EFileAccessHint::WillNeed;
 
-void FrameGraph::Compile()
-{
-    // @TODO cull inactive nodes 
+    FileReader Reader(inFilePath, ReaderConfig);
+    if (!Reader.IsOpen())
+    {
+        return false;
+    }
 
-    for (uint32 i = 0; i < Nodes.size(); ++i)
+    FFileSpan Span = Reader.GetSpan();
+    if (!Precompiled.Deserialize(Span.Data, Span.Size))
     {
-        FFrameGraphNode* Node = Nodes[i];
-        Node->Edges.clear();
+        VE_CORE_LOG_WARN(VE_TEXT("[FrameGraph]: Precompiled graph {0} is corrupt or was written by another version, parsing the json instead"), inFilePath);
+        Precompiled = FFrameGraphPrecompiled();
+        return false;
     }
 
-    for (uint32 i = 0; i < Nodes.size(); ++i)
+    if (Precompiled.SourceHash != SourceHash)
     {
-        FFrameGraphNode* Node = Nodes[i];
-        if (!Node->bIsEnabled)
+        VE_CORE_LOG_INFO(VE_TEXT("[FrameGraph]: Precompiled graph {0} is out of date, parsing the json instead"), inFilePath);
+        Precompiled = FFrameGraphPrecompiled();
+        return false;
+    }
+
+    Name = Precompiled.GetString(Precompiled.Name);
+
+    for (const FFrameGraphPrecompiledNode& PrecompiledNode : Precompiled.Nodes)
+    {
+        FFrameGraphNodeCreation NodeCreation = { };
+        NodeCreation.Name = Precompiled.GetString(PrecompiledNode.Name);
+        NodeCreation.bIsEnabled = PrecompiledNode.bIsEnabled != 0;
+        NodeCreation.QueueType = (ERenderQueueType)PrecompiledNode.QueueType;
+        NodeCreation.Outputs.resize(PrecompiledNode.NumOutputs);
+        NodeCreation.Inputs.resize(PrecompiledNode.NumInputs);
+
+        for (uint32 outputIndex = 0; outputIndex < PrecompiledNode.NumOutputs; ++outputIndex)
         {
-            continue;
+            const FFrameGraphPrecompiledResource& Resource = Precompiled.Resources[PrecompiledNode.FirstOutput + outputIndex];
+
+            FFrameGraphResourceOutputCreation& OutputCreation = NodeCreation.Outputs[outputIndex];
+            OutputCreation.Name = Precompiled.GetString(Resource.Name);
+            OutputCreation.Type = (EFrameGraphResourceType)Resource.Type;
+            OutputCreation.ResourceInfo.TextureResourceInfo.Format = (EPixelFormat)Resource.Format;
+            OutputCreation.ResourceInfo.TextureResourceInfo.LoadOp = (EAttachmentLoadOp)Resource.LoadOp;
+            OutputCreation.ResourceInfo.TextureResourceInfo.Width = Resource.Width;
+            OutputCreation.ResourceInfo.TextureResourceInfo.Height = Resource.Height;
+            OutputCreation.ResourceInfo.TextureResourceInfo.Depth = Resource.Depth;
+        }
+
+        for (uint32 inputIndex = 0; inputIndex < PrecompiledNode.NumInputs; ++inputIndex)
+        {
+            const FFrameGraphPrecompiledResource& Resource = Precompiled.Resources[PrecompiledNode.FirstInput + inputIndex];
+
+            FFrameGraphResourceInputCreation& InputCreation = NodeCreation.Inputs[inputIndex];
+            InputCreation.Name = Precompiled.GetString(Resource.Name);
+            InputCreation.Type = (EFrameGraphResourceType)Resource.Type;
+            InputCreation.ResourceInfo.bIsExternalResource = false;
         }
 
-        ComputeEdges(this, Node, i);
+        ParsedNodes.push_back(GraphBuilder->CreateNode(NodeCreation));
     }
 
-    std::vector<FFrameGraphNode*> SortedNodes;
-    SortedNodes.resize(Nodes.size());
-    uint32 NodesIndex = 0;
+    for (uint32 GraphOutput : Precompiled.GraphOutputs)
+    {
+        MarkOutput(StringHash::GetStringHash(Precompiled.GetString(GraphOutput)));
+    }
+
+    bIsPrecompiledLoaded = true;
+
+    VE_CORE_LOG_INFO(VE_TEXT("[FrameGraph]: Loaded precompiled graph {0} from {1}, {2} node(s)"), Name, inFilePath, ParsedNodes.size());
+    return true;
+}
 
-    TMap<FFrameGraphNode*, uint8> VisitedMap;
+bool FrameGraph::WritePrecompiled(FFrameGraphPrecompiled& inPlan, uint64 inEnabledMask, const std::string& inFilePath) const
+{
+    inPlan.SourceHash = SourceHash;
+    inPlan.EnabledMask = inEnabledMask;
+    inPlan.Nodes.clear();
+    inPlan.Resources.clear();
+    inPlan.GraphOutputs.clear();
+    inPlan.SortedNodes.clear();
+    inPlan.Strings.clear();
 
-    std::vector<FFrameGraphNode*> Stack;
-    //Stack.resize(Nodes.size());
+    inPlan.Name = inPlan.AddString(Name.c_str());
 
-    // Topological sorting
-    for (uint32 n = 0; n < Nodes.size(); ++n)
+    auto AddResource = [this, &inPlan](FFrameGraphResourceHandle inResourceHandle)
     {
-        FFrameGraphNode* Node = Nodes[n];
-        if (!Node->bIsEnabled)
+        const FFrameGraphResource& Resource = GraphBuilder->AccessResource(inResourceHandle);
+        VE_ASSERT(inResourceHandle.Handle - FirstResourceHandle == inPlan.Resources.size(), VE_TEXT("[FrameGraph]: The resources of the graph were not created one after the other..."));
+
+        FFrameGraphPrecompiledResource PrecompiledResource = { };
+        PrecompiledResource.Name = inPlan.AddString(StringHash::GetStringFromHash(Resource.Name));
+        PrecompiledResource.Type = (int32)Resource.Type;
+        PrecompiledResource.Format = (uint32)Resource.ResourceInfo.TextureResourceInfo.Format;
+        PrecompiledResource.LoadOp = (uint32)Resource.ResourceInfo.TextureResourceInfo.LoadOp;
+        PrecompiledResource.Width = Resource.ResourceInfo.TextureResourceInfo.Width;
+        PrecompiledResource.Height = Resource.ResourceInfo.TextureResourceInfo.Height;
+        PrecompiledResource.Depth = Resource.ResourceInfo.TextureResourceInfo.Depth;
+        PrecompiledResource.Source = UINT32_MAX;
+
+        inPlan.Resources.push_back(PrecompiledResource);
+    };
+
+    for (FFrameGraphNodeHandle NodeHandle : ParsedNodes)
+    {
+        const FFrameGraphNode& Node = GraphBuilder->AccessNode(NodeHandle);
+
+        FFrameGraphPrecompiledNode PrecompiledNode = { };
+        PrecompiledNode.Name = inPlan.AddString(StringHash::GetStringFromHash(Node.Name));
+        PrecompiledNode.QueueType = (uint32)Node.QueueType;
+        PrecompiledNode.bIsEnabled = Node.bIsEnabled ? 1 : 0;
+
+        PrecompiledNode.FirstOutput = (uint32)inPlan.Resources.size();
+        PrecompiledNode.NumOutputs = (uint32)Node.Outputs.size();
+        for (FFrameGraphResourceHandle OutputHandle : Node.Outputs)
         {
-            continue;
+            AddResource(OutputHandle);
         }
 
-        Stack.push_back(Node);
-
-        while (Stack.size() > 0)
+        PrecompiledNode.FirstInput = (uint32)inPlan.Resources.size();
+        PrecompiledNode.NumInputs = (uint32)Node.Inputs.size();
+        for (FFrameGraphResourceHandle InputHandle : Node.Inputs)
         {
-            FFrameGraphNode* NodeHandle = Stack.back();
+            AddResource(InputHandle);
 
-            auto It = VisitedMap.Find(NodeHandle);
-            if (It != VisitedMap.End())
+            // Only the inputs of live nodes were connected by the compile
+            const FFrameGraphResource& InputResource = GraphBuilder->AccessResource(InputHandle);
+            if (InputResource.OutputHandle.IsValid())
             {
-                if (It->second == 2)
-                {
-                    Stack.pop_back();
-                    continue;
-                }
+                inPlan.Resources.back().Source = InputResource.OutputHandle.Handle - FirstResourceHandle;
+            }
+        }
 
-                //if (It->second == 1)
-                //{
-                //    It->second = 2; // added
-                //    SortedNodes[NodesIndex++] = NodeHandle;
-                //    Stack.pop_back();
+        inPlan.Nodes.push_back(PrecompiledNode);
+    }
 
-                //    continue;
-                //}
+    for (uint32 GraphOutput : GraphOutputs)
+    {
+        inPlan.GraphOutputs.push_back(inPlan.AddString(StringHash::GetStringFromHash(GraphOutput)));
+    }
 
-                It->second = 2; // added
-                SortedNodes[NodesIndex++] = NodeHandle;
-                Stack.pop_back();
+    for (FFrameGraphNodeHandle NodeHandle : Nodes)
+    {
+        inPlan.SortedNodes.push_back(NodeHandle.Handle - ParsedNodes[0].Handle);
+    }
 
-                continue;
-            }
+    std::vector<uint8> Blob;
+    inPlan.Serialize(Blob);
+
+    std::string FilePath = inFilePath;
+    if (!FileHelper::WriteBytesToFile((char*)Blob.data(), Blob.size(), FilePath))
+    {
+        VE_CORE_LOG_WARN(VE_TEXT("[FrameGraph]: Could not write precompiled graph {0}"), inFilePath);
+        return false;
+    }
+
+    VE_CORE_LOG_INFO(VE_TEXT("[FrameGraph]: Wrote precompiled graph {0} to {1} ({2} bytes, {3})"), Name, inFilePath, Blob.size(),
+        inPlan.bHasPlacements ? "with its aliasing plan" : "without an aliasing plan");
+    return true;
+}
+
+std::vector<FFrameGraphNodeHandle> FrameGraph::RestorePrecompiledNodes(const FFrameGraphPrecompiled& inPrecompiled)
+{
+    std::vector<FFrameGraphNodeHandle> SortedNodes;
+    SortedNodes.reserve(inPrecompiled.SortedNodes.size());
 
-            VisitedMap.Add(NodeHandle, 1); // Visited
+    for (uint32 NodeIndex : inPrecompiled.SortedNodes)
+    {
+        const FFrameGraphNodeHandle NodeHandle = ParsedNodes[NodeIndex];
+        SortedNodes.push_back(NodeHandle);
 
-            // Leaf Node
-            if (NodeHandle->Edges.size() == 0)
+        const FFrameGraphPrecompiledNode& PrecompiledNode = inPrecompiled.Nodes[NodeIndex];
+        for (uint32 inputIndex = 0; inputIndex < PrecompiledNode.NumInputs; ++inputIndex)
+        {
+            const uint32 Source = inPrecompiled.Resources[PrecompiledNode.FirstInput + inputIndex].Source;
+            if (Source == UINT32_MAX)
             {
                 continue;
             }
 
-            for (uint32 r = 0; r < NodeHandle->Edges.size(); ++r)
-            {
-                FFrameGraphNode* ChildNode = NodeHandle->Edges[r];
-
-                if (VisitedMap.Find(ChildNode) == VisitedMap.End())
-                {
-                    Stack.push_back(ChildNode);
-                }
-            }
+            ConnectInput(NodeHandle, GraphBuilder->AccessNode(NodeHandle).Inputs[inputIndex], { FirstResourceHandle + Source });
         }
     }
 
-    VE_ASSERT(SortedNodes.size() == Nodes.size(), VE_TEXT(""));
+    return SortedNodes;
+}
 
-    Nodes.clear();
-    Nodes.resize(SortedNodes.size());
-    NodesIndex = 0;
-    for (int32 i = SortedNodes.size() - 1; i >= 0; --i)
+bool FrameGraph::PrecompileGraph(const std::string& inFilePath)
+{
+    std::string Source;
+    if (!FileHelper::LoadFileToString(Source, inFilePath))
     {
-        Nodes[NodesIndex++] = SortedNodes[i];
+        VE_CORE_LOG_ERROR(VE_TEXT("[FrameGraph]: Cannot load file: {0}"), inFilePath);
+        return false;
     }
 
-    // Memory aliasing (Resource Aliasing) technique computation
-    // 
-    // @note allocations and deallocations are used for verification purposes only 
-    uint64 ResourceCount = GraphBuilder->ResourceMap.Count();
+    FrameGraphBuilder Builder;
+    Builder.Init();
 
-    // tracks which node a given resource was allocated
-    TMap<FFrameGraphResource*, FFrameGraphNode*> Allocations;
+    FrameGraph Graph;
+    Graph.Init(&Builder);
+    Graph.SourceHash = XXHash64::Hash(Source.data(), Source.size());
+    Graph.ParseJson(Source);
 
-    // tracks the node the resource can be deallocated 
-    TMap<FFrameGraphResource*, FFrameGraphNode*> Deallocations;
+    const uint64 EnabledMask = Graph.GetEnabledMask();
+
+    std::vector<FFrameGraphNodeHandle> LiveNodes = Graph.CullNodes();
+    for (FFrameGraphNodeHandle NodeHandle : LiveNodes)
+    {
+        ComputeEdges(&Graph, NodeHandle);
+    }
 
-    // contains the resources that have been freed and can be reused 
-    std::vector<TextureResource*> FreeList;
+    Graph.Nodes = Graph.SortNodes(LiveNodes);
 
-    uint64 PeakMemory = 0;
-    uint64 InstantMemory = 0;
+    // Placing the attachments needs the memory requirements of a device, only their lifetimes are stored
+    FFrameGraphPrecompiled Plan;
+    Graph.GatherTransients(Plan.Transients);
 
-    // Update resources reference counts each time they are used as inputs 
-    for (uint32 i = 0; i < Nodes.size(); ++i)
-    {
-        FFrameGraphNode* Node = Nodes[i];
-        if (!Node->bIsEnabled)
-        {
-            continue;
-        }
+    const bool bIsWritten = Graph.WritePrecompiled(Plan, EnabledMask, FrameGraphHelpers::GetPrecompiledPath(inFilePath));
 
-        for (uint32 j = 0; j < Node->Inputs.size(); ++j)
-        {
-            FFrameGraphResource* InputResource = Node->Inputs[j];
-            FFrameGraphResource* Resource = InputResource->OutputHandle;
+    Graph.Shutdown();
+    Builder.Shutdown();
 
-            Resource->ReferenceCount++;
-        }
+    return bIsWritten;
+}
+
+void FrameGraph::Reset()
+{
+}
+
+void FrameGraph::EnableRenderPass(uint32 inRenderPassName)
+{
+    FFrameGraphNodeHandle NodeHandle = GraphBuilder->GetNode(inRenderPassName);
+    GraphBuilder->AccessNode(NodeHandle).bIsEnabled = true;
+}
+
+void FrameGraph::DisableRenderPass(uint32 inRenderPassName)
+{
+    FFrameGraphNodeHandle NodeHandle = GraphBuilder->GetNode(inRenderPassName);
+    GraphBuilder->AccessNode(NodeHandle).bIsEnabled = false;
+}
+
+void FrameGraph::MarkOutput(uint32 inResourceName)
+{
+    VE_ASSERT(Compilations.Count() == 0, VE_TEXT("[FrameGraph]: Outputs have to be marked before the graph is compiled, {0} would not change the cached compilations..."), StringHash::GetStringFromHash(inResourceName));
+    GraphOutputs.push_back(inResourceName);
+}
+
+void FrameGraph::Compile()
+{
+    uint64 EnabledMask = GetEnabledMask();
+    if (ActiveCompilation != nullptr && ActiveCompilation->EnabledMask == EnabledMask)
+    {
+        return;
     }
 
-    for (uint32 i = 0; i < Nodes.size(); ++i)
+    auto It = Compilations.Find(EnabledMask);
+    if (It != Compilations.End())
     {
-        FFrameGraphNode* Node = Nodes[i];
-        if (!Node->bIsEnabled)
-        {
-            continue;
-        }
+        ApplyCompilation(It->second);
+        return;
+    }
 
-        for (uint32 j = 0; j < Node->Outputs.size(); ++j)
-        {
-            FFrameGraphResource* Resource = Node->Outputs[j];
+    EvictCompilations();
 
-            auto It = Allocations.Find(Resource);
-            if (!Resource->ResourceInfo.bIsExternalResource && It == Allocations.End())
-            {
-                VE_ASSERT(Deallocations.Find(Resource) == Deallocations.End(), VE_TEXT("Error on frame graph compilation occurred..."));
-                Allocations.Add(Resource, Node);
+    typedef std::chrono::high_resolution_clock Clock;
+    auto Start = Clock::now();
 
-                if (Resource->Type == EFrameGraphResourceType::Attachment)
-                {
-                    FFrameGraphResourceInfo& Info = Resource->ResourceInfo;
-
-                    FTextureConfig Config = { };
-                    {
-                        Config.Format = Info.TextureResourceInfo.Format;
-                        Config.Type = ETextureType::Texture2D;
-
-                        Config.Extent.Width = Info.TextureResourceInfo.Width;
-                        Config.Extent.Height = Info.TextureResourceInfo.Height;
-                        Config.Extent.Depth = Info.TextureResourceInfo.Depth;
-
-                        Config.BindFlags |= FResourceBindFlags::ColorAttachment;
-
-                        if (FrameGraphHelpers::HasDepthOrStencil(Config.Format))
-                        {
-                            Config.BindFlags = 0;
-                            Config.BindFlags |= FResourceBindFlags::DepthStencilAttachment;
-                        }
-                    }
-
-                    if (FreeList.size() > 0)
-                    {
-                        // @TODO: find best fit (currently its greedy)
-                        TextureResource*& AliasTexture = FreeList.back();
-                        FreeList.pop_back();
-
-                        Config.TextureHandle = AliasTexture;
-
-                        Info.TextureResourceInfo.TextureHandle = Renderer::Get().GetRenderInterface().Get()->CreateTexture(Config);
-                    }
-                    else
-                    {
-                        Info.TextureResourceInfo.TextureHandle = Renderer::Get().GetRenderInterface().Get()->CreateTexture(Config);
-                    }
-                }
+    // What the last compilation left in the nodes belongs to it
+    for (FFrameGraphNodeHandle NodeHandle : ParsedNodes)
+    {
+        FFrameGraphNode& Node = GraphBuilder->AccessNode(NodeHandle);
+        Node.Edges.clear();
+        Node.FrameBufferHandle = nullptr;
 
-                VE_CORE_LOG_INFO(VE_TEXT("[FrameGraph]: Renderpass Ouput {0} allocated on node {1}"), Resource->Name, Node->Name);
-            }
+        for (FFrameGraphResourceHandle OutputHandle : Node.Outputs)
+        {
+            GraphBuilder->AccessResource(OutputHandle).ResourceInfo.TextureResourceInfo.TextureHandle = nullptr;
         }
+    }
+
+    // The precompiled file only holds the compilation of the nodes it enables, and only the first compile uses it
+    const bool bIsFirstCompilation = Compilations.Count() == 0;
+    const FFrameGraphPrecompiled* PrecompiledPlan = nullptr;
+    if (bIsFirstCompilation && bIsPrecompiledLoaded && Precompiled.EnabledMask == EnabledMask)
+    {
+        PrecompiledPlan = &Precompiled;
+    }
 
-        for (uint32 j = 0; j < Node->Inputs.size(); ++j)
+    if (PrecompiledPlan != nullptr)
+    {
+        Nodes = RestorePrecompiledNodes(*PrecompiledPlan);
+    }
+    else
+    {
+        std::vector<FFrameGraphNodeHandle> LiveNodes = CullNodes();
+        for (FFrameGraphNodeHandle NodeHandle : LiveNodes)
         {
-            FFrameGraphResource* InputResource = Node->Inputs[j];
-            FFrameGraphResource* Resource = InputResource->OutputHandle;
+            ComputeEdges(this, NodeHandle);
+        }
 
-            Resource->ReferenceCount--;
+        Nodes = SortNodes(LiveNodes);
+    }
 
-            if (!Resource->ResourceInfo.bIsExternalResource && Resource->ReferenceCount == 0)
-            {
-                VE_ASSERT(Deallocations.Find(Resource) == Deallocations.End(), VE_TEXT("error on frame graph compile reference count check post..."));
-                Deallocations.Add(Resource, Node);
+    FFrameGraphCompilation* Compilation = new FFrameGraphCompilation();
+    Compilation->EnabledMask = EnabledMask;
+    Compilation->Nodes = Nodes;
 
-                if (Resource->Type == EFrameGraphResourceType::Attachment || Resource->Type == EFrameGraphResourceType::Texture)
-                {
-                    FreeList.push_back(Resource->ResourceInfo.TextureResourceInfo.TextureHandle);
-                }
+    FFrameGraphPrecompiled Plan;
+    const bool bReusedPlan = PlanTransientMemory(Compilation, PrecompiledPlan, bIsFirstCompilation ? &Plan : nullptr);
 
-                VE_CORE_LOG_INFO(VE_TEXT("[FrameGraph]: Renderpass Ouput {0} deallocated on node {1}"), Resource->Name, Node->Name);
-            }
+    // Written before the compilation is applied, the inputs of the live nodes still point at the outputs they read
+    if (bIsFirstCompilation)
+    {
+        if (!bReusedPlan && !PrecompiledPath.empty())
+        {
+            WritePrecompiled(Plan, EnabledMask, PrecompiledPath);
         }
+
+        Precompiled = FFrameGraphPrecompiled();
+        bIsPrecompiledLoaded = false;
     }
 
-    for (uint32 i = 0; i < Nodes.size(); ++i)
+    for (FFrameGraphNodeHandle NodeHandle : Nodes)
     {
-        FFrameGraphNode* Node = Nodes[i];
-        if (!Node->bIsEnabled)
+        FFrameGraphNode& Node = GraphBuilder->AccessNode(NodeHandle);
+        if (Node.QueueType != ERenderQueueType::Graphics)
         {
             continue;
         }
 
-        if (Node->RenderPassHandle == nullptr)
+        // Render passes only depend on the node, they are shared by every compilation
+        if (Node.RenderPassHandle == nullptr)
         {
             CreateRenderPass(this, Node);
         }
 
-        if (Node->FrameBufferHandle == nullptr)
+        CreateFrameBuffer(this, Node);
+    }
+
+    ComputeBarriers();
+    BuildSubmitBatches(Compilation);
+
+    Compilation->NodeData.resize(Nodes.size());
+    for (uint32 i = 0; i < Nodes.size(); ++i)
+    {
+        const FFrameGraphNode& Node = GraphBuilder->AccessNode(Nodes[i]);
+        FFrameGraphNodeCompilation& NodeData = Compilation->NodeData[i];
+
+        NodeData.FrameBufferHandle = Node.FrameBufferHandle;
+        NodeData.Edges = Node.Edges;
+        NodeData.Barriers = Node.Barriers;
+        NodeData.ReleaseBarriers = Node.ReleaseBarriers;
+        NodeData.QueueWaits = Node.QueueWaits;
+
+        for (FFrameGraphResourceHandle OutputHandle : Node.Outputs)
         {
-            CreateFrameBuffer(this, Node);
+            NodeData.OutputTextures.push_back(GraphBuilder->AccessResource(OutputHandle).ResourceInfo.TextureResourceInfo.TextureHandle);
         }
     }
-}
 
-FFrameGraphNode* FrameGraph::GetNode(std::string& inName)
-{
-    return GraphBuilder->GetNode(inName);
+    Compilations.Add(EnabledMask, Compilation);
+    ApplyCompilation(Compilation);
+
+    uint32 NumEnabledNodes = 0;
+    for (FFrameGraphNodeHandle NodeHandle : ParsedNodes)
+    {
+        NumEnabledNodes += GraphBuilder->AccessNode(NodeHandle).bIsEnabled ? 1 : 0;
+    }
+
+    InitNodeStats(Compilation);
+    Compilation->Stats.NumCulledNodes = NumEnabledNodes - (uint32)Nodes.size();
+    Compilation->Stats.NumSubmitBatches = (uint32)Compilation->SubmitBatches.size();
+    Compilation->Stats.CompileTimeMs = std::chrono::duration<float, std::milli>(Clock::now() - Start).count();
+
+    VE_CORE_LOG_INFO(VE_TEXT("[FrameGraph]: Compiled graph {0} with {1} live node(s), {2} enabled node(s) culled, {3} compilation(s) cached in {4} ms"),
+        Name, Nodes.size(), Compilation->Stats.NumCulledNodes, Compilations.Count(), Compilation->Stats.CompileTimeMs);
 }
 
-FFrameGraphResource* FrameGraph::GetResource(std::string& inName)
+void FrameGraph::InitNodeStats(FFrameGraphCompilation* inCompilation)
 {
-    return GraphBuilder->GetResource(inName);
+    FFrameGraphStats& Stats = inCompilation->Stats;
+    Stats.Nodes.assign(inCompilation->Nodes.size(), FFrameGraphNodeStats());
+    Stats.NumBarriers = 0;
+    Stats.NumQueueTransfers = 0;
+
+    for (uint32 i = 0; i < inCompilation->Nodes.size(); ++i)
+    {
+        const FFrameGraphNode& Node = GraphBuilder->AccessNode(inCompilation->Nodes[i]);
+        const FFrameGraphNodeCompilation& NodeData = inCompilation->NodeData[i];
+
+        FFrameGraphNodeStats& NodeStats = Stats.Nodes[i];
+        NodeStats.Name = Node.Name;
+        NodeStats.QueueType = Node.QueueType;
+        NodeStats.NumBarriers = (uint32)NodeData.Barriers.size();
+        NodeStats.NumReleaseBarriers = (uint32)NodeData.ReleaseBarriers.size();
+
+        // Every queue transfer is one release on the node giving the texture away
+        Stats.NumBarriers += NodeStats.NumBarriers + NodeStats.NumReleaseBarriers;
+        Stats.NumQueueTransfers += NodeStats.NumReleaseBarriers;
+    }
 }
 
-void FrameGraph::ComputeEdges(FrameGraph* inFrameGraph, FFrameGraphNode* inNode, uint32 inNodeIndex)
+uint64 FrameGraph::GetEnabledMask() const
 {
-    for (uint32 resourceIndex = 0; resourceIndex < inNode->Inputs.size(); ++resourceIndex)
+    VE_ASSERT(ParsedNodes.size() <= 64, VE_TEXT("[FrameGraph]: A graph can have at most 64 nodes, {0} were parsed..."), ParsedNodes.size());
+
+    uint64 EnabledMask = 0;
+    for (uint32 i = 0; i < ParsedNodes.size(); ++i)
     {
-        FFrameGraphResource* Resource = inNode->Inputs[resourceIndex];
-        FFrameGraphResource* OutputResource = inFrameGraph->GetResource(Resource->Name);
-        if (OutputResource == nullptr && !Resource->ResourceInfo.bIsExternalResource)
+        if (GraphBuilder->AccessNode(ParsedNodes[i]).bIsEnabled)
         {
-            VE_ASSERT(false, VE_TEXT("[FrameGraphHelpers]: Requested resource is not produced by any node and is not external..."));
-            continue;
+            EnabledMask |= (uint64)1 << i;
         }
-
-        Resource->Producer = OutputResource->Producer;
-        Resource->ResourceInfo = OutputResource->ResourceInfo;
-        Resource->OutputHandle = OutputResource->OutputHandle;
-
-        FFrameGraphNode* ParentNode = Resource->Producer;
-        ParentNode->Edges.push_back(inFrameGraph->Nodes[inNodeIndex]);
     }
+
+    return EnabledMask;
 }
 
-void FrameGraph::CreateRenderPass(FrameGraph* inFrameGraph, FFrameGraphNode* inNode)
+std::vector<FFrameGraphNodeHandle> FrameGraph::CullNodes()
 {
-    FRenderPassConfig RenderPassConfig = { };
+    // Indexed by node handle
+    std::vector<uint8> IsLive(GraphBuilder->GetNumNodes(), 0);
+    std::vector<FFrameGraphNodeHandle> Stack;
 
-    // @note firstly we want to create the outputs
-    for (uint64 i = 0; i < inNode->Outputs.size(); ++i)
+    // Roots: nodes producing an output of the graph or writing to a resource outside of it
+    for (FFrameGraphNodeHandle NodeHandle : ParsedNodes)
     {
-        FFrameGraphResource* OutputResource = inNode->Outputs[i];
-        FFrameGraphResourceInfo& Info = OutputResource->ResourceInfo;
+        const FFrameGraphNode& Node = GraphBuilder->AccessNode(NodeHandle);
+        if (!Node.bIsEnabled)
+        {
+            continue;
+        }
 
-        if (OutputResource->Type == EFrameGraphResourceType::Attachment)
+        for (FFrameGraphResourceHandle OutputHandle : Node.Outputs)
         {
-            if (Info.TextureResourceInfo.Format == EPixelFormat::D24UNormS8UInt)
-            {
-                RenderPassConfig.DepthStencilAttachment.Format = EPixelFormat::D24UNormS8UInt;
-                RenderPassConfig.DepthStencilAttachment.FinalLayout = ETextureLayout::DepthStencilAttachment;
-                RenderPassConfig.DepthStencilAttachment.LoadOp = EAttachmentLoadOp::Clear;
+            const FFrameGraphResource& OutputResource = GraphBuilder->AccessResource(OutputHandle);
 
-                continue;
+            const bool bIsGraphOutput = std::find(GraphOutputs.begin(), GraphOutputs.end(), OutputResource.Name) != GraphOutputs.end();
+            if (bIsGraphOutput || OutputResource.Type == EFrameGraphResourceType::Reference)
+            {
+                IsLive[NodeHandle.Handle] = 1;
+                Stack.push_back(NodeHandle);
+                break;
+            }
+        }
+    }
+
+    // Without roots there is nothing to tell which nodes are dead
+    if (Stack.empty())
+    {
+        std::vector<FFrameGraphNodeHandle> EnabledNodes;
+        for (FFrameGraphNodeHandle NodeHandle : ParsedNodes)
+        {
+            if (GraphBuilder->AccessNode(NodeHandle).bIsEnabled)
+            {
+                EnabledNodes.push_back(NodeHandle);
+            }
+        }
+
+        return EnabledNodes;
+    }
+
+    while (Stack.size() > 0)
+    {
+        FFrameGraphNodeHandle NodeHandle = Stack.back();
+        Stack.pop_back();
+
+        const FFrameGraphNode& Node = GraphBuilder->AccessNode(NodeHandle);
+        for (FFrameGraphResourceHandle InputHandle : Node.Inputs)
+        {
+            const FFrameGraphResource& InputResource = GraphBuilder->AccessResource(InputHandle);
+
+            FFrameGraphResourceHandle OutputHandle = GraphBuilder->GetResource(InputResource.Name);
+            if (!OutputHandle.IsValid())
+            {
+                continue;
+            }
+
+            FFrameGraphNodeHandle Producer = GraphBuilder->AccessResource(OutputHandle).Producer;
+            VE_ASSERT(GraphBuilder->AccessNode(Producer).bIsEnabled, VE_TEXT("[FrameGraph]: Node {0} reads {1}, which is produced by the disabled node {2}..."),
+                StringHash::GetStringFromHash(Node.Name), StringHash::GetStringFromHash(InputResource.Name), StringHash::GetStringFromHash(GraphBuilder->AccessNode(Producer).Name));
+
+            if (IsLive[Producer.Handle] == 0)
+            {
+                IsLive[Producer.Handle] = 1;
+                Stack.push_back(Producer);
+            }
+        }
+    }
+
+    // Kept in the parsed order so the sort does not depend on the walk
+    std::vector<FFrameGraphNodeHandle> LiveNodes;
+    for (FFrameGraphNodeHandle NodeHandle : ParsedNodes)
+    {
+        if (IsLive[NodeHandle.Handle] != 0)
+        {
+            LiveNodes.push_back(NodeHandle);
+        }
+    }
+
+    return LiveNodes;
+}
+
+std::vector<FFrameGraphNodeHandle> FrameGraph::SortNodes(const std::vector<FFrameGraphNodeHandle>& inLiveNodes)
+{
+    // Depth first, a node is added once every node reading from it is added, then the order is reversed
+    std::vector<FFrameGraphNodeHandle> SortedNodes;
+    SortedNodes.reserve(inLiveNodes.size());
+
+    // Indexed by node handle: 0 not visited, 1 visited, 2 added
+    std::vector<uint8> VisitStates(GraphBuilder->GetNumNodes(), 0);
+    std::vector<FFrameGraphNodeHandle> Stack;
+
+    for (FFrameGraphNodeHandle NodeHandle : inLiveNodes)
+    {
+        Stack.push_back(NodeHandle);
+
+        while (Stack.size() > 0)
+        {
+            FFrameGraphNodeHandle CurrentHandle = Stack.back();
+
+            uint8& VisitState = VisitStates[CurrentHandle.Handle];
+            if (VisitState != 0)
+            {
+                if (VisitState == 1)
+                {
+                    VisitState = 2; // added
+                    SortedNodes.push_back(CurrentHandle);
+                }
+
+                Stack.pop_back();
+                continue;
+            }
+
+            VisitState = 1; // Visited
+
+            for (FFrameGraphNodeHandle ChildHandle : GraphBuilder->AccessNode(CurrentHandle).Edges)
+            {
+                if (VisitStates[ChildHandle.Handle] == 0)
+                {
+                    Stack.push_back(ChildHandle);
+                }
+            }
+        }
+    }
+
+    VE_ASSERT(SortedNodes.size() == inLiveNodes.size(), VE_TEXT("[FrameGraph]: Sorting kept {0} of {1} live nodes..."), SortedNodes.size(), inLiveNodes.size());
+
+    return std::vector<FFrameGraphNodeHandle>(SortedNodes.rbegin(), SortedNodes.rend());
+}
+
+void FrameGraph::ApplyCompilation(FFrameGraphCompilation* inCompilation)
+{
+    for (FFrameGraphNodeHandle NodeHandle : ParsedNodes)
+    {
+        FFrameGraphNode& Node = GraphBuilder->AccessNode(NodeHandle);
+        Node.Edges.clear();
+        Node.Barriers.clear();
+        Node.ReleaseBarriers.clear();
+        Node.QueueWaits.clear();
+        Node.FrameBufferHandle = nullptr;
+
+        for (FFrameGraphResourceHandle OutputHandle : Node.Outputs)
+        {
+            GraphBuilder->AccessResource(OutputHandle).ResourceInfo.TextureResourceInfo.TextureHandle = nullptr;
+        }
+    }
+
+    Nodes = inCompilation->Nodes;
+    for (uint32 i = 0; i < Nodes.size(); ++i)
+    {
+        FFrameGraphNode& Node = GraphBuilder->AccessNode(Nodes[i]);
+        const FFrameGraphNodeCompilation& NodeData = inCompilation->NodeData[i];
+
+        Node.FrameBufferHandle = NodeData.FrameBufferHandle;
+        Node.Edges = NodeData.Edges;
+        Node.Barriers = NodeData.Barriers;
+        Node.ReleaseBarriers = NodeData.ReleaseBarriers;
+        Node.QueueWaits = NodeData.QueueWaits;
+
+        for (uint32 outputIndex = 0; outputIndex < Node.Outputs.size(); ++outputIndex)
+        {
+            GraphBuilder->AccessResource(Node.Outputs[outputIndex]).ResourceInfo.TextureResourceInfo.TextureHandle = NodeData.OutputTextures[outputIndex];
+        }
+    }
+
+    // Inputs see the textures of the outputs they read, once every output is set
+    for (FFrameGraphNodeHandle NodeHandle : Nodes)
+    {
+        for (FFrameGraphResourceHandle InputHandle : GraphBuilder->AccessNode(NodeHandle).Inputs)
+        {
+            FFrameGraphResource& InputResource = GraphBuilder->AccessResource(InputHandle);
+            if (InputResource.OutputHandle.IsValid())
+            {
+                InputResource.ResourceInfo.TextureResourceInfo.TextureHandle = GraphBuilder->AccessResource(InputResource.OutputHandle).ResourceInfo.TextureResourceInfo.TextureHandle;
+            }
+        }
+    }
+
+    ActiveCompilation = inCompilation;
+    ActiveCompilation->LastApplied = ++CompilationClock;
+}
+
+void FrameGraph::EvictCompilations()
+{
+    while (Compilations.Count() >= MAX_CACHED_COMPILATIONS)
+    {
+        FFrameGraphCompilation* Oldest = nullptr;
+        for (auto It = Compilations.Begin(); It != Compilations.End(); ++It)
+        {
+            if (It->second != ActiveCompilation && (Oldest == nullptr || It->second->LastApplied < Oldest->LastApplied))
+            {
+                Oldest = It->second;
+            }
+        }
+
+        if (Oldest == nullptr)
+        {
+            return;
+        }
+
+        VE_CORE_LOG_INFO(VE_TEXT("[FrameGraph]: Evicted the compilation of graph {0} for enabled mask {1}, {2} compilation(s) are cached at most"),
+            Name, Oldest->EnabledMask, (uint32)MAX_CACHED_COMPILATIONS);
+
+        Compilations.Remove(Oldest->EnabledMask);
+        RetiredCompilations.push_back(Oldest);
+    }
+}
+
+void FrameGraph::ReleaseRetiredCompilations()
+{
+    for (FFrameGraphCompilation* Compilation : RetiredCompilations)
+    {
+        ReleaseCompilation(Compilation);
+        delete Compilation;
+    }
+
+    RetiredCompilations.clear();
+}
+
+void FrameGraph::ReleaseCompilation(FFrameGraphCompilation* inCompilation)
+{
+    IRenderInterface* RenderInterface = Renderer::Get().GetRenderInterface().Get();
+
+    for (const FFrameGraphNodeCompilation& NodeData : inCompilation->NodeData)
+    {
+        if (NodeData.FrameBufferHandle != nullptr)
+        {
+            RenderInterface->Free(NodeData.FrameBufferHandle);
+        }
+    }
+
+    // Textures first, they are placed in the heaps
+    for (TextureResource* Texture : inCompilation->TransientTextures)
+    {
+        RenderInterface->Free(Texture);
+    }
+
+    for (ITransientHeap* Heap : inCompilation->TransientHeaps)
+    {
+        RenderInterface->Free(Heap);
+    }
+
+    // Every semaphore is signaled by exactly one batch
+    for (const FFrameGraphSubmitBatch& Batch : inCompilation->SubmitBatches)
+    {
+        for (ISemaphore* Semaphore : Batch.SignalSemaphores)
+        {
+            RenderInterface->Free(Semaphore);
+        }
+    }
+
+    inCompilation->NodeData.clear();
+    inCompilation->TransientTextures.clear();
+    inCompilation->TransientHeaps.clear();
+    inCompilation->SubmitBatches.clear();
+}
+
+void FrameGraph::Execute(ICommandBuffer* inCommandBuffer)
+{
+    // The renderer waited on the last frame before recording this one, nothing uses the evicted compilations anymore
+    ReleaseRetiredCompilations();
+
+    typedef std::chrono::high_resolution_clock Clock;
+    auto Start = Clock::now();
+
+    for (uint32 i = 0; i < Nodes.size(); ++i)
+    {
+        const FFrameGraphNode& Node = GraphBuilder->AccessNode(Nodes[i]);
+        VE_ASSERT(Node.QueueType == ERenderQueueType::Graphics, VE_TEXT("[FrameGraph]: Node {0} runs on another queue, the graph has to be submitted instead of executed..."), StringHash::GetStringFromHash(Node.Name));
+        RecordNode(i, inCommandBuffer);
+    }
+
+    if (ActiveCompilation != nullptr)
+    {
+        ActiveCompilation->Stats.RecordTimeMs = std::chrono::duration<float, std::milli>(Clock::now() - Start).count();
+    }
+}
+
+/**
+* Records a node on the worker thread running the task, it is only started once the tasks of the nodes it reads from are done
+*/
+struct FrameGraph::FNodeTask : enki::ITaskSet
+{
+    void ExecuteRange(enki::TaskSetPartition inRange, uint32_t inThreadNum) override
+    {
+        FFrameGraphNode& Node = Graph->GraphBuilder->AccessNode(Graph->Nodes[NodeIndex]);
+        ICommandBuffer* CommandBuffer = CommandBufferManager::Get().AcquireCommandBuffer(FrameIndex, inThreadNum, Node.QueueType);
+
+        CommandBuffer->Begin();
+        Graph->RecordNode(NodeIndex, CommandBuffer);
+        CommandBuffer->End();
+
+        Node.CommandBuffer = CommandBuffer;
+    }
+
+    FrameGraph* Graph = nullptr;
+
+    /** Index of the node in the sorted nodes */
+    uint32 NodeIndex = 0;
+    uint32 FrameIndex = 0;
+
+    /** One per node this node reads from */
+    std::vector<enki::Dependency> Dependencies;
+};
+
+void FrameGraph::Submit(uint32 inFrameIndex, enki::TaskScheduler* inTaskScheduler)
+{
+    VE_ASSERT(ActiveCompilation != nullptr, VE_TEXT("[FrameGraph]: The graph has to be compiled before it is submitted..."));
+
+    // Same as Execute(), the last use of the frame in flight is finished
+    ReleaseRetiredCompilations();
+
+    CommandBufferManager::Get().ResetAcquiredCommandBuffers(inFrameIndex);
+
+    typedef std::chrono::high_resolution_clock Clock;
+    auto Start = Clock::now();
+
+    if (inTaskScheduler == nullptr)
+    {
+        for (uint32 i = 0; i < Nodes.size(); ++i)
+        {
+            FFrameGraphNode& Node = GraphBuilder->AccessNode(Nodes[i]);
+
+            Node.CommandBuffer = CommandBufferManager::Get().AcquireCommandBuffer(inFrameIndex, 0, Node.QueueType);
+            Node.CommandBuffer->Begin();
+            RecordNode(i, Node.CommandBuffer);
+            Node.CommandBuffer->End();
+        }
+    }
+    else
+    {
+        std::vector<FNodeTask> Tasks(Nodes.size());
+
+        // Indexed by node handle
+        std::vector<uint32> TaskIndices(GraphBuilder->GetNumNodes(), UINT32_MAX);
+
+        for (uint32 i = 0; i < Nodes.size(); ++i)
+        {
+            Tasks[i].Graph = this;
+            Tasks[i].NodeIndex = i;
+            Tasks[i].FrameIndex = inFrameIndex;
+
+            TaskIndices[Nodes[i].Handle] = i;
+        }
+
+        // The edges point from a producer to the nodes reading its outputs, each reader depends on the producer's task
+        for (uint32 i = 0; i < Nodes.size(); ++i)
+        {
+            for (FFrameGraphNodeHandle ChildHandle : GraphBuilder->AccessNode(Nodes[i]).Edges)
+            {
+                FNodeTask& ChildTask = Tasks[TaskIndices[ChildHandle.Handle]];
+                ChildTask.Dependencies.emplace_back();
+                ChildTask.SetDependency(ChildTask.Dependencies.back(), &Tasks[i]);
+            }
+        }
+
+        // Completes once every leaf (a node nothing reads from) is done, so once every node is. Waiting on each task instead is not safe,
+        //  a task shows as complete before the scheduler has started its dependents and a worker can still be walking its dependents when
+        //  the wait returns, after which Tasks is gone
+        enki::ICompletable NodesDone;
+        std::vector<enki::Dependency> NodesDoneDependencies;
+        NodesDoneDependencies.reserve(Nodes.size());
+
+        for (uint32 i = 0; i < Nodes.size(); ++i)
+        {
+            if (GraphBuilder->AccessNode(Nodes[i]).Edges.empty())
+            {
+                NodesDoneDependencies.emplace_back();
+                NodesDone.SetDependency(NodesDoneDependencies.back(), &Tasks[i]);
+            }
+        }
+
+        // Dependent tasks are started by the scheduler once their dependencies complete, only the roots are added
+        for (uint32 i = 0; i < Nodes.size(); ++i)
+        {
+            if (Tasks[i].Dependencies.empty())
+            {
+                inTaskScheduler->AddTaskSetToPipe(&Tasks[i]);
+            }
+        }
+
+        inTaskScheduler->WaitforTask(&NodesDone);
+    }
+
+    ActiveCompilation->Stats.RecordTimeMs = std::chrono::duration<float, std::milli>(Clock::now() - Start).count();
+
+    // Submitted in the sorted order whatever order the nodes were recorded in
+    IRenderInterface* RenderInterface = Renderer::Get().GetRenderInterface().Get();
+    std::vector<ICommandBuffer*> CommandBuffers;
+
+    for (const FFrameGraphSubmitBatch& Batch : ActiveCompilation->SubmitBatches)
+    {
+        CommandBuffers.clear();
+        for (uint32 NodeIndex : Batch.NodeIndices)
+        {
+            CommandBuffers.push_back(GraphBuilder->AccessNode(Nodes[NodeIndex]).CommandBuffer);
+        }
+
+        FCommandQueueSubmitInfo SubmitInfo;
+        SubmitInfo.CommandBuffers = CommandBuffers.data();
+        SubmitInfo.NumCommandBuffers = (uint32)CommandBuffers.size();
+        SubmitInfo.WaitSemaphores = Batch.WaitSemaphores.data();
+        SubmitInfo.NumWaitSemaphores = (uint32)Batch.WaitSemaphores.size();
+        SubmitInfo.SignalSemaphores = Batch.SignalSemaphores.data();
+        SubmitInfo.NumSignalSemaphores = (uint32)Batch.SignalSemaphores.size();
+
+        switch (Batch.QueueType)
+        {
+        case ERenderQueueType::Compute:
+            RenderInterface->GetComputeQueue()->Submit(SubmitInfo);
+            break;
+        case ERenderQueueType::Transfer:
+            RenderInterface->GetTransferQueue()->Submit(SubmitInfo);
+            break;
+        default:
+            RenderInterface->GetCommandQueue()->Submit(SubmitInfo);
+            break;
+        }
+    }
+}
+
+void FrameGraph::RecordNode(uint32 inNodeIndex, ICommandBuffer* inCommandBuffer)
+{
+    typedef std::chrono::high_resolution_clock Clock;
+    auto Start = Clock::now();
+
+    FFrameGraphNode& Node = GraphBuilder->AccessNode(Nodes[inNodeIndex]);
+    const uint32 NumDrawsBefore = inCommandBuffer->GetNumDraws();
+
+    inCommandBuffer->AddTextureBarriers(Node.Barriers.data(), (uint32)Node.Barriers.size());
+
+    if (Node.QueueType == ERenderQueueType::Graphics)
+    {
+        FRenderPassBeginInfo RPBeginInfo = { };
+        RPBeginInfo.RenderPassPtr = Node.RenderPassHandle;
+        RPBeginInfo.FrameBuffer = Node.FrameBufferHandle;
+        RPBeginInfo.ClearValues = Node.ClearValues.data();
+        RPBeginInfo.NumClearValues = (uint32)Node.ClearValues.size();
+
+        inCommandBuffer->BeginRenderPass(RPBeginInfo);
+
+        if (Node.GraphRenderPass != nullptr)
+        {
+            Node.GraphRenderPass->Render(inCommandBuffer);
+        }
+
+        inCommandBuffer->EndRenderPass();
+    }
+    else if (Node.GraphRenderPass != nullptr)
+    {
+        Node.GraphRenderPass->Render(inCommandBuffer);
+    }
+
+    inCommandBuffer->AddTextureBarriers(Node.ReleaseBarriers.data(), (uint32)Node.ReleaseBarriers.size());
+
+    // Each node only writes its own stats, so nodes recorded on different threads do not race
+    FFrameGraphNodeStats& NodeStats = ActiveCompilation->Stats.Nodes[inNodeIndex];
+    NodeStats.RecordTimeMs = std::chrono::duration<float, std::milli>(Clock::now() - Start).count();
+    NodeStats.AverageRecordTimeMs = NodeStats.NumRecords == 0 ? NodeStats.RecordTimeMs
+        : NodeStats.AverageRecordTimeMs + (NodeStats.RecordTimeMs - NodeStats.AverageRecordTimeMs) * 0.05f;
+    NodeStats.NumDraws = inCommandBuffer->GetNumDraws() - NumDrawsBefore;
+    NodeStats.NumRecords++;
+}
+
+void FrameGraph::ComputeBarriers()
+{
+    /** How the last node to use a resource left it */
+    struct FResourceState
+    {
+        bool bIsUsed = false;
+        ETextureLayout Layout = ETextureLayout::Undefined;
+        ERenderQueueType QueueType = ERenderQueueType::Graphics;
+        FFrameGraphNodeHandle LastNode;
+    };
+
+    // Indexed by the handle of the output that produces the resource
+    std::vector<FResourceState> States(GraphBuilder->GetNumResources());
+
+    // Releases are added to earlier nodes, so everything is cleared up front
+    for (FFrameGraphNodeHandle NodeHandle : Nodes)
+    {
+        FFrameGraphNode& Node = GraphBuilder->AccessNode(NodeHandle);
+        Node.Barriers.clear();
+        Node.ReleaseBarriers.clear();
+        Node.QueueWaits.clear();
+    }
+
+    uint32 NumBarriers = 0;
+    uint32 NumQueueTransfers = 0;
+    for (uint32 i = 0; i < Nodes.size(); ++i)
+    {
+        const FFrameGraphNodeHandle NodeHandle = Nodes[i];
+        FFrameGraphNode& Node = GraphBuilder->AccessNode(NodeHandle);
+
+        auto UseResource = [this, &States, &NumQueueTransfers, &Node, NodeHandle](FFrameGraphResourceHandle inResourceHandle, ETextureLayout inLayout)
+        {
+            if (!inResourceHandle.IsValid())
+            {
+                return;
+            }
+
+            const FFrameGraphResource& Resource = GraphBuilder->AccessResource(inResourceHandle);
+            if (Resource.ResourceInfo.bIsExternalResource || Resource.ResourceInfo.TextureResourceInfo.TextureHandle == nullptr)
+            {
+                return;
+            }
+
+            const TextureResource* Texture = Resource.ResourceInfo.TextureResourceInfo.TextureHandle;
+
+            FResourceState& State = States[inResourceHandle.Handle];
+            if (!State.bIsUsed)
+            {
+                // Nothing used the resource yet this frame, its contents (or the ones of a resource aliasing its memory) are discarded
+                State = FResourceState{ true, inLayout, Node.QueueType, NodeHandle };
+                Node.Barriers.push_back(FTextureBarrier(Texture, ETextureLayout::Undefined, inLayout, Node.QueueType, Node.QueueType));
+                return;
+            }
+
+            const bool bChangesQueue = State.QueueType != Node.QueueType;
+
+            // Reading again what was only read before on the same queue does not need a barrier
+            if (!bChangesQueue && State.Layout == inLayout && !FrameGraphHelpers::IsWriteLayout(State.Layout))
+            {
+                State.LastNode = NodeHandle;
+                return;
+            }
+
+            const FTextureBarrier Barrier(Texture, State.Layout, inLayout, State.QueueType, Node.QueueType);
+            Node.Barriers.push_back(Barrier);
+
+            // The last user releases the resource to this node's queue, which waits for it before acquiring
+            if (bChangesQueue)
+            {
+                GraphBuilder->AccessNode(State.LastNode).ReleaseBarriers.push_back(Barrier);
+                if (std::find(Node.QueueWaits.begin(), Node.QueueWaits.end(), State.LastNode) == Node.QueueWaits.end())
+                {
+                    Node.QueueWaits.push_back(State.LastNode);
+                }
+
+                NumQueueTransfers++;
+            }
+
+            State = FResourceState{ true, inLayout, Node.QueueType, NodeHandle };
+        };
+
+        for (FFrameGraphResourceHandle OutputHandle : Node.Outputs)
+        {
+            const FFrameGraphResource& OutputResource = GraphBuilder->AccessResource(OutputHandle);
+            if (OutputResource.Type == EFrameGraphResourceType::Attachment)
+            {
+                UseResource(OutputHandle, FrameGraphHelpers::GetResourceLayout(OutputResource, true, Node.QueueType));
+            }
+        }
+
+        for (FFrameGraphResourceHandle InputHandle : Node.Inputs)
+        {
+            const FFrameGraphResource& InputResource = GraphBuilder->AccessResource(InputHandle);
+            if (InputResource.Type == EFrameGraphResourceType::Attachment || InputResource.Type == EFrameGraphResourceType::Texture)
+            {
+                UseResource(InputResource.OutputHandle, FrameGraphHelpers::GetResourceLayout(InputResource, false, Node.QueueType));
+            }
+        }
+
+        NumBarriers += (uint32)Node.Barriers.size();
+    }
+
+    VE_CORE_LOG_INFO(VE_TEXT("[FrameGraph]: {0} texture barriers derived for the graph, {1} of them move a texture between queues"), NumBarriers, NumQueueTransfers);
+}
+
+void FrameGraph::BuildSubmitBatches(FFrameGraphCompilation* inCompilation)
+{
+    std::vector<FFrameGraphSubmitBatch>& SubmitBatches = inCompilation->SubmitBatches;
+
+    IRenderInterface* RenderInterface = Renderer::Get().GetRenderInterface().Get();
+
+    // Indexed by node handle, batch the node is submitted in
+    std::vector<uint32> NodeBatches(GraphBuilder->GetNumNodes(), UINT32_MAX);
+
+    // Batches each batch waits for, a semaphore is created per pair once the batches are known
+    std::vector<std::vector<uint32>> BatchWaits;
+
+    for (uint32 i = 0; i < Nodes.size(); ++i)
+    {
+        const FFrameGraphNode& Node = GraphBuilder->AccessNode(Nodes[i]);
+
+        bool bNeedsNewBatch = SubmitBatches.empty() || SubmitBatches.back().QueueType != Node.QueueType;
+        if (!bNeedsNewBatch)
+        {
+            // Semaphores are only waited on at the start of a batch
+            const std::vector<uint32>& CurrentWaits = BatchWaits.back();
+            for (FFrameGraphNodeHandle WaitNode : Node.QueueWaits)
+            {
+                const uint32 WaitBatch = NodeBatches[WaitNode.Handle];
+                if (std::find(CurrentWaits.begin(), CurrentWaits.end(), WaitBatch) == CurrentWaits.end())
+                {
+                    bNeedsNewBatch = true;
+                    break;
+                }
             }
+        }
 
-            FAttachmentDescription Desc = { };
-            Desc.Format = Info.TextureResourceInfo.Format;
-            Desc.FinalLayout = ETextureLayout::ColorAttachment;
-            Desc.LoadOp = Info.TextureResourceInfo.LoadOp;
+        if (bNeedsNewBatch)
+        {
+            FFrameGraphSubmitBatch Batch;
+            Batch.QueueType = Node.QueueType;
 
-            RenderPassConfig.ColorAttachments.push_back(Desc);
+            SubmitBatches.push_back(Batch);
+            BatchWaits.push_back({ });
+        }
+
+        const uint32 BatchIndex = (uint32)SubmitBatches.size() - 1;
+        SubmitBatches.back().NodeIndices.push_back(i);
+        NodeBatches[Nodes[i].Handle] = BatchIndex;
+
+        for (FFrameGraphNodeHandle WaitNode : Node.QueueWaits)
+        {
+            const uint32 WaitBatch = NodeBatches[WaitNode.Handle];
+            if (std::find(BatchWaits.back().begin(), BatchWaits.back().end(), WaitBatch) == BatchWaits.back().end())
+            {
+                BatchWaits.back().push_back(WaitBatch);
+            }
+        }
+    }
+
+    // Work left on another queue at the end of the graph is joined by the graphics queue, the frame's fence only covers that queue
+    std::vector<bool> IsWaitedOn(SubmitBatches.size(), false);
+    for (const std::vector<uint32>& Waits : BatchWaits)
+    {
+        for (uint32 WaitBatch : Waits)
+        {
+            IsWaitedOn[WaitBatch] = true;
+        }
+    }
+
+    std::vector<uint32> JoinWaits;
+    for (uint32 i = 0; i < SubmitBatches.size(); ++i)
+    {
+        if (!IsWaitedOn[i] && SubmitBatches[i].QueueType != ERenderQueueType::Graphics)
+        {
+            JoinWaits.push_back(i);
+        }
+    }
+
+    if (!JoinWaits.empty())
+    {
+        FFrameGraphSubmitBatch JoinBatch;
+        JoinBatch.QueueType = ERenderQueueType::Graphics;
+
+        SubmitBatches.push_back(JoinBatch);
+        BatchWaits.push_back(JoinWaits);
+    }
+
+    for (uint32 i = 0; i < SubmitBatches.size(); ++i)
+    {
+        for (uint32 WaitBatch : BatchWaits[i])
+        {
+            ISemaphore* Semaphore = RenderInterface->CreateRenderSemaphore(FSemaphoreConfig(1));
+            SubmitBatches[WaitBatch].SignalSemaphores.push_back(Semaphore);
+            SubmitBatches[i].WaitSemaphores.push_back(Semaphore);
+        }
+    }
+
+    VE_CORE_LOG_INFO(VE_TEXT("[FrameGraph]: Graph {0} is submitted in {1} batch(es)"), Name, SubmitBatches.size());
+}
+
+void FrameGraph::GatherTransients(std::vector<FFrameGraphPrecompiledTransient>& outTransients)
+{
+    // Lifetime of every attachment produced in the graph: from the node that outputs it to the last node that reads it
+    outTransients.clear();
+
+    // Indexed by resource handle
+    std::vector<uint32> TransientIndices(GraphBuilder->GetNumResources(), UINT32_MAX);
+
+    for (uint32 i = 0; i < Nodes.size(); ++i)
+    {
+        const FFrameGraphNode& Node = GraphBuilder->AccessNode(Nodes[i]);
+        for (FFrameGraphResourceHandle OutputHandle : Node.Outputs)
+        {
+            const FFrameGraphResource& Resource = GraphBuilder->AccessResource(OutputHandle);
+            if (Resource.Type != EFrameGraphResourceType::Attachment || Resource.ResourceInfo.bIsExternalResource)
+            {
+                continue;
+            }
+
+            FFrameGraphPrecompiledTransient Transient = { };
+            Transient.Resource = OutputHandle.Handle - FirstResourceHandle;
+            Transient.FirstUse = i;
+            Transient.LastUse = i;
+            Transient.UsageBindFlags = FrameGraphHelpers::GetUsageBindFlags(Resource, true, Node.QueueType);
+
+            TransientIndices[OutputHandle.Handle] = (uint32)outTransients.size();
+            outTransients.push_back(Transient);
+        }
+
+        for (FFrameGraphResourceHandle InputHandle : Node.Inputs)
+        {
+            const FFrameGraphResource& InputResource = GraphBuilder->AccessResource(InputHandle);
+            if (!InputResource.OutputHandle.IsValid())
+            {
+                continue;
+            }
+
+            const uint32 TransientIndex = TransientIndices[InputResource.OutputHandle.Handle];
+            if (TransientIndex != UINT32_MAX)
+            {
+                outTransients[TransientIndex].LastUse = i;
+                outTransients[TransientIndex].UsageBindFlags |= FrameGraphHelpers::GetUsageBindFlags(InputResource, false, Node.QueueType);
+            }
+        }
+    }
+}
+
+bool FrameGraph::PlanTransientMemory(FFrameGraphCompilation* inCompilation, const FFrameGraphPrecompiled* inPrecompiledPlan, FFrameGraphPrecompiled* outPlan)
+{
+    IRenderInterface* RenderInterface = Renderer::Get().GetRenderInterface().Get();
+
+    std::vector<ITransientHeap*>& TransientHeaps = inCompilation->TransientHeaps;
+    std::vector<TextureResource*>& TransientTextures = inCompilation->TransientTextures;
+
+    std::vector<FFrameGraphPrecompiledTransient> Transients;
+    GatherTransients(Transients);
+
+    std::vector<FTextureConfig> Configs(Transients.size());
+    for (uint32 i = 0; i < Transients.size(); ++i)
+    {
+        const FFrameGraphResourceHandle ResourceHandle = { FirstResourceHandle + Transients[i].Resource };
+        Configs[i] = FrameGraphHelpers::MakeAttachmentConfig(GraphBuilder->AccessResource(ResourceHandle).ResourceInfo, Transients[i].UsageBindFlags);
+        Transients[i].Requirements = RenderInterface->GetTextureMemoryRequirements(Configs[i]);
+    }
+
+    // The precompiled placements only hold if the device still reports the requirements they were made for
+    const bool bReusePlan = inPrecompiledPlan != nullptr && FrameGraphHelpers::IsSamePlan(*inPrecompiledPlan, Transients);
+
+    MemoryPlanner.Reset();
+    for (const FFrameGraphPrecompiledTransient& Transient : Transients)
+    {
+        MemoryPlanner.AddRequest(Transient.Requirements, Transient.FirstUse, Transient.LastUse);
+    }
+
+    if (bReusePlan)
+    {
+        std::vector<FFrameGraphMemoryPlacement> Placements(Transients.size());
+        for (uint32 i = 0; i < Transients.size(); ++i)
+        {
+            Placements[i].HeapIndex = inPrecompiledPlan->Transients[i].HeapIndex;
+            Placements[i].Offset = inPrecompiledPlan->Transients[i].Offset;
+        }
+
+        MemoryPlanner.ApplyPlan(inPrecompiledPlan->Heaps, Placements);
+    }
+    else
+    {
+        MemoryPlanner.Plan();
+    }
+
+    const std::vector<FFrameGraphMemoryHeap>& Heaps = MemoryPlanner.GetHeaps();
+    for (uint32 i = 0; i < Transients.size(); ++i)
+    {
+        const FFrameGraphMemoryPlacement& Placement = MemoryPlanner.GetPlacement(i);
+        Transients[i].HeapIndex = Placement.HeapIndex;
+        Transients[i].Offset = Placement.Offset;
+    }
+
+    for (const FFrameGraphMemoryHeap& PlannedHeap : Heaps)
+    {
+        FTransientHeapConfig HeapConfig;
+        HeapConfig.Size = PlannedHeap.Size;
+        HeapConfig.MemoryTypeBits = PlannedHeap.MemoryTypeBits;
+
+        TransientHeaps.push_back(RenderInterface->CreateTransientHeap(HeapConfig));
+    }
+
+    for (uint32 i = 0; i < Transients.size(); ++i)
+    {
+        const FFrameGraphPrecompiledTransient& Transient = Transients[i];
+        Configs[i].TransientHeap = TransientHeaps[Transient.HeapIndex];
+        Configs[i].TransientHeapOffset = Transient.Offset;
+
+        FFrameGraphResource& Resource = GraphBuilder->AccessResource({ FirstResourceHandle + Transient.Resource });
+        Resource.ResourceInfo.TextureResourceInfo.TextureHandle = RenderInterface->CreateTexture(Configs[i]);
+        TransientTextures.push_back(Resource.ResourceInfo.TextureResourceInfo.TextureHandle);
+
+        VE_CORE_LOG_INFO(VE_TEXT("[FrameGraph]: Renderpass Ouput {0} alive on nodes [{1}, {2}], placed in heap {3} at offset {4}"),
+            StringHash::GetStringFromHash(Resource.Name), Transient.FirstUse, Transient.LastUse, Transient.HeapIndex, Transient.Offset);
+    }
+
+    FFrameGraphStats& Stats = inCompilation->Stats;
+    Stats.Memory = MemoryPlanner.GetStats();
+    Stats.Resources.resize(Transients.size());
+
+    for (uint32 i = 0; i < Transients.size(); ++i)
+    {
+        const FFrameGraphPrecompiledTransient& Transient = Transients[i];
+        const FFrameGraphResource& Resource = GraphBuilder->AccessResource({ FirstResourceHandle + Transient.Resource });
+
+        FFrameGraphResourceStats& ResourceStats = Stats.Resources[i];
+        ResourceStats.Name = Resource.Name;
+        ResourceStats.Width = Resource.ResourceInfo.TextureResourceInfo.Width;
+        ResourceStats.Height = Resource.ResourceInfo.TextureResourceInfo.Height;
+        ResourceStats.Format = Resource.ResourceInfo.TextureResourceInfo.Format;
+        ResourceStats.SizeInBytes = Transient.Requirements.Size;
+        ResourceStats.HeapIndex = Transient.HeapIndex;
+        ResourceStats.Offset = Transient.Offset;
+        ResourceStats.FirstUse = Transient.FirstUse;
+        ResourceStats.LastUse = Transient.LastUse;
+
+        // The planner never overlaps the memory of attachments alive at the same time
+        for (uint32 j = 0; j < Transients.size(); ++j)
+        {
+            const FFrameGraphPrecompiledTransient& Other = Transients[j];
+            if (j != i && Other.HeapIndex == Transient.HeapIndex
+                && Other.Offset < Transient.Offset + Transient.Requirements.Size && Transient.Offset < Other.Offset + Other.Requirements.Size)
+            {
+                ResourceStats.NumAliases++;
+            }
+        }
+    }
+
+    VE_CORE_LOG_INFO(VE_TEXT("[FrameGraph]: {0} transient attachments use {1} MiB in {2} heap(s), {3} MiB without aliasing ({4} MiB alive at peak){5}"),
+        Transients.size(), FrameGraphHelpers::BytesToMebibytes(Stats.Memory.HeapMemory), TransientHeaps.size(),
+        FrameGraphHelpers::BytesToMebibytes(Stats.Memory.NaiveMemory), FrameGraphHelpers::BytesToMebibytes(Stats.Memory.PeakLiveMemory),
+        bReusePlan ? ", placed by the precompiled plan" : "");
+
+    if (outPlan != nullptr)
+    {
+        outPlan->bHasPlacements = true;
+        outPlan->Transients = Transients;
+        outPlan->Heaps = Heaps;
+    }
+
+    return bReusePlan;
+}
+
+FFrameGraphNodeHandle FrameGraph::GetNode(uint32 inName)
+{
+    return GraphBuilder->GetNode(inName);
+}
+
+FFrameGraphResourceHandle FrameGraph::GetResource(uint32 inName)
+{
+    return GraphBuilder->GetResource(inName);
+}
+
+FFrameGraphStats FrameGraph::GetStats() const
+{
+    if (ActiveCompilation == nullptr)
+    {
+        return FFrameGraphStats();
+    }
+
+    return ActiveCompilation->Stats;
+}
+
+bool FrameGraph::DumpGraphviz(const std::string& inFilePath) const
+{
+    using namespace FrameGraphHelpers;
+
+    const FFrameGraphStats Stats = GetStats();
+
+    // Indexed by node handle, index of the node in the sorted nodes
+    std::vector<uint32> SortedIndices(GraphBuilder->GetNumNodes(), UINT32_MAX);
+    for (uint32 i = 0; i < Nodes.size(); ++i)
+    {
+        SortedIndices[Nodes[i].Handle] = i;
+    }
+
+    // Indexed by resource handle, index of the transient in the stats
+    std::vector<uint32> TransientIndices(GraphBuilder->GetNumResources(), UINT32_MAX);
+    for (uint32 i = 0; i < Stats.Resources.size(); ++i)
+    {
+        const FFrameGraphResourceHandle OutputHandle = GraphBuilder->GetResource(Stats.Resources[i].Name);
+        if (OutputHandle.IsValid())
+        {
+            TransientIndices[OutputHandle.Handle] = i;
+        }
+    }
+
+    std::string Dot = "digraph \"" + Name + "\"\n{\n";
+    Dot += "    rankdir=LR;\n";
+    Dot += "    node [shape=box, style=\"rounded,filled\", fontname=\"Consolas\"];\n";
+    Dot += "    edge [fontname=\"Consolas\", fontsize=10];\n";
+    Dot += "    label=\"" + Name + ": compiled in " + FormatMs(Stats.CompileTimeMs) + " ms, recorded in " + FormatMs(Stats.RecordTimeMs) + " ms\\n"
+        + std::to_string(BytesToMebibytes(Stats.Memory.HeapMemory)) + " MiB of transient memory, "
+        + std::to_string(BytesToMebibytes(Stats.Memory.NaiveMemory - Stats.Memory.HeapMemory)) + " MiB saved by aliasing\";\n\n";
+
+    for (FFrameGraphNodeHandle NodeHandle : ParsedNodes)
+    {
+        const FFrameGraphNode& Node = GraphBuilder->AccessNode(NodeHandle);
+        const std::string NodeName = StringHash::GetStringFromHash(Node.Name);
+
+        const uint32 SortedIndex = SortedIndices[NodeHandle.Handle];
+        if (SortedIndex == UINT32_MAX)
+        {
+            Dot += "    \"" + NodeName + "\" [label=\"" + NodeName + "\\n" + (Node.bIsEnabled ? "culled" : "disabled")
+                + "\", style=\"rounded,dashed\", color=gray, fontcolor=gray];\n";
+            continue;
+        }
+
+        const FFrameGraphNodeStats& NodeStats = Stats.Nodes[SortedIndex];
+        const char* FillColor = Node.QueueType == ERenderQueueType::Graphics ? "lightblue" : (Node.QueueType == ERenderQueueType::Compute ? "khaki" : "lightgray");
+
+        Dot += "    \"" + NodeName + "\" [label=\"#" + std::to_string(SortedIndex) + " " + NodeName + " (" + QueueTypeToString(Node.QueueType) + ")\\n"
+            + FormatMs(NodeStats.RecordTimeMs) + " ms, avg " + FormatMs(NodeStats.AverageRecordTimeMs) + " ms\\n"
+            + std::to_string(NodeStats.NumDraws) + " draw(s), " + std::to_string(NodeStats.NumBarriers) + " barrier(s), "
+            + std::to_string(NodeStats.NumReleaseBarriers) + " release(s)\", fillcolor=" + FillColor + "];\n";
+    }
+
+    Dot += "\n";
+
+    // One edge per input of a live node, labeled with the resource it carries
+    for (FFrameGraphNodeHandle NodeHandle : Nodes)
+    {
+        const FFrameGraphNode& Node = GraphBuilder->AccessNode(NodeHandle);
+        for (FFrameGraphResourceHandle InputHandle : Node.Inputs)
+        {
+            const FFrameGraphResource& InputResource = GraphBuilder->AccessResource(InputHandle);
+            if (!InputResource.OutputHandle.IsValid())
+            {
+                continue;
+            }
+
+            std::string Label = StringHash::GetStringFromHash(InputResource.Name);
+
+            const uint32 TransientIndex = TransientIndices[InputResource.OutputHandle.Handle];
+            if (TransientIndex != UINT32_MAX)
+            {
+                const FFrameGraphResourceStats& ResourceStats = Stats.Resources[TransientIndex];
+                Label += "\\n" + std::to_string(BytesToMebibytes(ResourceStats.SizeInBytes)) + " MiB, heap " + std::to_string(ResourceStats.HeapIndex)
+                    + " @ " + std::to_string(ResourceStats.Offset) + ", " + std::to_string(ResourceStats.NumAliases) + " alias(es)";
+            }
+
+            Dot += "    \"" + std::string(StringHash::GetStringFromHash(GraphBuilder->AccessNode(InputResource.Producer).Name)) + "\" -> \""
+                + StringHash::GetStringFromHash(Node.Name) + "\" [label=\"" + Label + "\"];\n";
+        }
+    }
+
+    Dot += "}\n";
+
+    std::string FilePath = inFilePath;
+    if (!FileHelper::WriteBytesToFile((char*)Dot.data(), Dot.size(), FilePath))
+    {
+        VE_CORE_LOG_WARN(VE_TEXT("[FrameGraph]: Could not write the graphviz dump of graph {0} to {1}"), Name, inFilePath);
+        return false;
+    }
+
+    return true;
+}
+
+bool FrameGraph::DumpJson(const std::string& inFilePath) const
+{
+    using json = nlohmann::json;
+
+    const FFrameGraphStats Stats = GetStats();
+
+    std::vector<uint32> SortedIndices(GraphBuilder->GetNumNodes(), UINT32_MAX);
+    for (uint32 i = 0; i < Nodes.size(); ++i)
+    {
+        SortedIndices[Nodes[i].Handle] = i;
+    }
+
+    json GraphData;
+    GraphData["name"] = Name;
+    GraphData["compileTimeMs"] = Stats.CompileTimeMs;
+    GraphData["recordTimeMs"] = Stats.RecordTimeMs;
+    GraphData["culledNodes"] = Stats.NumCulledNodes;
+    GraphData["barriers"] = Stats.NumBarriers;
+    GraphData["queueTransfers"] = Stats.NumQueueTransfers;
+    GraphData["submitBatches"] = Stats.NumSubmitBatches;
+    GraphData["memory"] = {
+        { "heapBytes", Stats.Memory.HeapMemory },
+        { "naiveBytes", Stats.Memory.NaiveMemory },
+        { "peakLiveBytes", Stats.Memory.PeakLiveMemory },
+        { "savedBytes", Stats.Memory.NaiveMemory - Stats.Memory.HeapMemory }
+    };
+
+    json NodesData = json::array();
+    for (FFrameGraphNodeHandle NodeHandle : ParsedNodes)
+    {
+        const FFrameGraphNode& Node = GraphBuilder->AccessNode(NodeHandle);
+        const uint32 SortedIndex = SortedIndices[NodeHandle.Handle];
+
+        json NodeData;
+        NodeData["name"] = StringHash::GetStringFromHash(Node.Name);
+        NodeData["queue"] = FrameGraphHelpers::QueueTypeToString(Node.QueueType);
+        NodeData["state"] = SortedIndex != UINT32_MAX ? "live" : (Node.bIsEnabled ? "culled" : "disabled");
+
+        json Inputs = json::array();
+        for (FFrameGraphResourceHandle InputHandle : Node.Inputs)
+        {
+            Inputs.push_back(StringHash::GetStringFromHash(GraphBuilder->AccessResource(InputHandle).Name));
+        }
+
+        json Outputs = json::array();
+        for (FFrameGraphResourceHandle OutputHandle : Node.Outputs)
+        {
+            Outputs.push_back(StringHash::GetStringFromHash(GraphBuilder->AccessResource(OutputHandle).Name));
+        }
+
+        NodeData["inputs"] = Inputs;
+        NodeData["outputs"] = Outputs;
+
+        if (SortedIndex != UINT32_MAX)
+        {
+            const FFrameGraphNodeStats& NodeStats = Stats.Nodes[SortedIndex];
+            NodeData["order"] = SortedIndex;
+            NodeData["recordTimeMs"] = NodeStats.RecordTimeMs;
+            NodeData["averageRecordTimeMs"] = NodeStats.AverageRecordTimeMs;
+            NodeData["draws"] = NodeStats.NumDraws;
+            NodeData["barriers"] = NodeStats.NumBarriers;
+            NodeData["releaseBarriers"] = NodeStats.NumReleaseBarriers;
+            NodeData["records"] = NodeStats.NumRecords;
+        }
+
+        NodesData.push_back(NodeData);
+    }
+
+    json EdgesData = json::array();
+    for (FFrameGraphNodeHandle NodeHandle : Nodes)
+    {
+        const FFrameGraphNode& Node = GraphBuilder->AccessNode(NodeHandle);
+        for (FFrameGraphResourceHandle InputHandle : Node.Inputs)
+        {
+            const FFrameGraphResource& InputResource = GraphBuilder->AccessResource(InputHandle);
+            if (!InputResource.OutputHandle.IsValid())
+            {
+                continue;
+            }
+
+            EdgesData.push_back({
+                { "from", StringHash::GetStringFromHash(GraphBuilder->AccessNode(InputResource.Producer).Name) },
+                { "to", StringHash::GetStringFromHash(Node.Name) },
+                { "resource", StringHash::GetStringFromHash(InputResource.Name) }
+            });
+        }
+    }
+
+    json ResourcesData = json::array();
+    for (const FFrameGraphResourceStats& ResourceStats : Stats.Resources)
+    {
+        ResourcesData.push_back({
+            { "name", StringHash::GetStringFromHash(ResourceStats.Name) },
+            { "width", ResourceStats.Width },
+            { "height", ResourceStats.Height },
+            { "format", (uint32)ResourceStats.Format },
+            { "bytes", ResourceStats.SizeInBytes },
+            { "heap", ResourceStats.HeapIndex },
+            { "offset", ResourceStats.Offset },
+            { "firstUse", ResourceStats.FirstUse },
+            { "lastUse", ResourceStats.LastUse },
+            { "aliases", ResourceStats.NumAliases }
+        });
+    }
+
+    GraphData["nodes"] = NodesData;
+    GraphData["edges"] = EdgesData;
+    GraphData["resources"] = ResourcesData;
+
+    std::string Result = GraphData.dump(4);
+    std::string FilePath = inFilePath;
+    if (!FileHelper::WriteBytesToFile((char*)Result.data(), Result.size(), FilePath))
+    {
+        VE_CORE_LOG_WARN(VE_TEXT("[FrameGraph]: Could not write the json dump of graph {0} to {1}"), Name, inFilePath);
+        return false;
+    }
+
+    return true;
+}
+
+void FrameGraph::ComputeEdges(FrameGraph* inFrameGraph, FFrameGraphNodeHandle inNodeHandle)
+{
+    FrameGraphBuilder* Builder = inFrameGraph->GraphBuilder;
+    FFrameGraphNode& Node = Builder->AccessNode(inNodeHandle);
+
+    for (uint32 resourceIndex = 0; resourceIndex < Node.Inputs.size(); ++resourceIndex)
+    {
+        const FFrameGraphResource& Resource = Builder->AccessResource(Node.Inputs[resourceIndex]);
+        FFrameGraphResourceHandle OutputHandle = inFrameGraph->GetResource(Resource.Name);
+        if (!OutputHandle.IsValid())
+        {
+            VE_ASSERT(Resource.ResourceInfo.bIsExternalResource, VE_TEXT("[FrameGraphHelpers]: Requested resource {0} is not produced by any node and is not external..."), StringHash::GetStringFromHash(Resource.Name));
+            continue;
         }
+
+        inFrameGraph->ConnectInput(inNodeHandle, Node.Inputs[resourceIndex], OutputHandle);
     }
+}
+
+void FrameGraph::ConnectInput(FFrameGraphNodeHandle inNodeHandle, FFrameGraphResourceHandle inInputHandle, FFrameGraphResourceHandle inOutputHandle)
+{
+    FFrameGraphResource& InputResource = GraphBuilder->AccessResource(inInputHandle);
+    const FFrameGraphResource& OutputResource = GraphBuilder->AccessResource(inOutputHandle);
+
+    InputResource.Producer = OutputResource.Producer;
+    InputResource.ResourceInfo = OutputResource.ResourceInfo;
+    InputResource.OutputHandle = OutputResource.OutputHandle;
+
+    GraphBuilder->AccessNode(InputResource.Producer).Edges.push_back(inNodeHandle);
+}
 
-    for (uint64 i = 0; i < inNode->Inputs.size(); ++i)
+void FrameGraph::CreateRenderPass(FrameGraph* inFrameGraph, FFrameGraphNode& inNode)
+{
+    FrameGraphBuilder* Builder = inFrameGraph->GraphBuilder;
+    FRenderPassConfig RenderPassConfig = { };
+
+    // @note firstly we want to create the outputs
+    for (uint64 i = 0; i < inNode.Outputs.size(); ++i)
     {
-        FFrameGraphResource* InputResource = inNode->Inputs[i];
-        FFrameGraphResourceInfo& Info = InputResource->ResourceInfo;
+        const FFrameGraphResource& OutputResource = Builder->AccessResource(inNode.Outputs[i]);
+        const FFrameGraphResourceInfo& Info = OutputResource.ResourceInfo;
 
-        if (InputResource->Type == EFrameGraphResourceType::Attachment)
+        if (OutputResource.Type == EFrameGraphResourceType::Attachment)
         {
-            if (Info.TextureResourceInfo.Format == EPixelFormat::D24UNormS8UInt)
+            // The barriers of the node already moved the attachment to its layout, the render pass keeps it there
+            FAttachmentDescription Desc = { };
+            Desc.Format = Info.TextureResourceInfo.Format;
+            Desc.InitialLayout = FrameGraphHelpers::GetResourceLayout(OutputResource, true, inNode.QueueType);
+            Desc.FinalLayout = Desc.InitialLayout;
+            Desc.StoreOp = EAttachmentStoreOp::Store;
+
+            if (FrameGraphHelpers::HasDepthOrStencil(Info.TextureResourceInfo.Format))
             {
-                RenderPassConfig.DepthStencilAttachment.Format = EPixelFormat::D24UNormS8UInt;
-                RenderPassConfig.DepthStencilAttachment.FinalLayout = ETextureLayout::DepthStencilAttachment;
-                RenderPassConfig.DepthStencilAttachment.LoadOp = EAttachmentLoadOp::Load;
+                Desc.LoadOp = EAttachmentLoadOp::Clear;
+                RenderPassConfig.DepthStencilAttachment = Desc;
 
                 continue;
             }
 
+            Desc.LoadOp = Info.TextureResourceInfo.LoadOp;
+            RenderPassConfig.ColorAttachments.push_back(Desc);
+        }
+    }
+
+    for (uint64 i = 0; i < inNode.Inputs.size(); ++i)
+    {
+        const FFrameGraphResource& InputResource = Builder->AccessResource(inNode.Inputs[i]);
+        const FFrameGraphResourceInfo& Info = InputResource.ResourceInfo;
+
+        if (InputResource.Type == EFrameGraphResourceType::Attachment)
+        {
             FAttachmentDescription Desc = { };
             Desc.Format = Info.TextureResourceInfo.Format;
-            Desc.FinalLayout = ETextureLayout::ColorAttachment;
+            Desc.InitialLayout = FrameGraphHelpers::GetResourceLayout(InputResource, false, inNode.QueueType);
+            Desc.FinalLayout = Desc.InitialLayout;
             Desc.LoadOp = EAttachmentLoadOp::Load;
+            Desc.StoreOp = EAttachmentStoreOp::Store;
+
+            if (FrameGraphHelpers::HasDepthOrStencil(Info.TextureResourceInfo.Format))
+            {
+                RenderPassConfig.DepthStencilAttachment = Desc;
+                continue;
+            }
 
             RenderPassConfig.ColorAttachments.push_back(Desc);
         }
     }
 
+    // The depth stencil attachment comes after the color attachments
+    const bool bHasDepthStencil = RenderPassConfig.DepthStencilAttachment.Format != EPixelFormat::Undefined;
+    inNode.ClearValues.assign(RenderPassConfig.GetNumColorAttachments() + (bHasDepthStencil ? 1 : 0), FRenderClearValues());
+    if (bHasDepthStencil)
+    {
+        inNode.ClearValues.back().Depth = 1.0f;
+    }
+
     // @TODO: insure formats are valid for attachments 
-    inNode->RenderPassHandle = Renderer::Get().GetRenderInterface().Get()->CreateRenderPass(RenderPassConfig);
+    inNode.RenderPassHandle = Renderer::Get().GetRenderInterface().Get()->CreateRenderPass(RenderPassConfig);
 }
 
-void FrameGraph::CreateFrameBuffer(FrameGraph* inFrameGraph, FFrameGraphNode* inNode)
+void FrameGraph::CreateFrameBuffer(FrameGraph* inFrameGraph, FFrameGraphNode& inNode)
 {
+    FrameGraphBuilder* Builder = inFrameGraph->GraphBuilder;
     FFrameBufferConfig FrameBufferConfig = { };
 
-    FrameBufferConfig.RenderPass = inNode->RenderPassHandle;
+    FrameBufferConfig.RenderPass = inNode.RenderPassHandle;
 
     uint32 Width = 0;
     uint32 Height = 0;
 
-    for (uint32 resourceIndex = 0; resourceIndex < inNode->Outputs.size(); ++resourceIndex)
+    // Kept for last to match the order of the render pass attachments
+    FFrameBufferAttachment DepthStencilAttachment = { };
+
+    for (uint32 resourceIndex = 0; resourceIndex < inNode.Outputs.size(); ++resourceIndex)
     {
-        FFrameGraphResource* Resource = inNode->Outputs[resourceIndex];
-        FFrameGraphResourceInfo& Info = Resource->ResourceInfo;
+        const FFrameGraphResource& Resource = Builder->AccessResource(inNode.Outputs[resourceIndex]);
+        const FFrameGraphResourceInfo& Info = Resource.ResourceInfo;
 
-        if (Resource->Type == EFrameGraphResourceType::Buffer || Resource->Type == EFrameGraphResourceType::Reference)
+        if (Resource.Type == EFrameGraphResourceType::Buffer || Resource.Type == EFrameGraphResourceType::Reference)
         {
             continue;
         }
@@ -616,22 +2089,28 @@ void FrameGraph::CreateFrameBuffer(FrameGraph* inFrameGraph, FFrameGraphNode* in
 
         FFrameBufferAttachment Attachment = { };
         Attachment.Attachment = Info.TextureResourceInfo.TextureHandle;
+
+        if (FrameGraphHelpers::HasDepthOrStencil(Info.TextureResourceInfo.Format))
+        {
+            DepthStencilAttachment = Attachment;
+            continue;
+        }
+
         FrameBufferConfig.Attachments.push_back(Attachment);
     }
 
-    for (uint32 resourceIndex = 0; resourceIndex < inNode->Inputs.size(); ++resourceIndex)
+    for (uint32 resourceIndex = 0; resourceIndex < inNode.Inputs.size(); ++resourceIndex)
     {
-        FFrameGraphResource* InputResource = inNode->Inputs[resourceIndex];
+        FFrameGraphResource& InputResource = Builder->AccessResource(inNode.Inputs[resourceIndex]);
 
-        if (InputResource->Type == EFrameGraphResourceType::Buffer || InputResource->Type == EFrameGraphResourceType::Reference)
+        if (InputResource.Type == EFrameGraphResourceType::Buffer || InputResource.Type == EFrameGraphResourceType::Reference || !InputResource.OutputHandle.IsValid())
         {
             continue;
         }
 
-        FFrameGraphResource* Resource = inFrameGraph->GetResource(InputResource->Name);
-        FFrameGraphResourceInfo& Info = Resource->ResourceInfo;
+        const FFrameGraphResourceInfo& Info = Builder->AccessResource(InputResource.OutputHandle).ResourceInfo;
 
-        InputResource->ResourceInfo.TextureResourceInfo.TextureHandle = Info.TextureResourceInfo.TextureHandle;
+        InputResource.ResourceInfo.TextureResourceInfo.TextureHandle = Info.TextureResourceInfo.TextureHandle;
 
         if (Width == 0)
         {
@@ -651,18 +2130,30 @@ void FrameGraph::CreateFrameBuffer(FrameGraph* inFrameGraph, FFrameGraphNode* in
             VE_ASSERT(Height == Info.TextureResourceInfo.Height, VE_TEXT(""));
         }
 
-        if (InputResource->Type == EFrameGraphResourceType::Texture)
+        if (InputResource.Type == EFrameGraphResourceType::Texture)
         {
             continue;
         }
 
         FFrameBufferAttachment Attachment = { };
         Attachment.Attachment = Info.TextureResourceInfo.TextureHandle;
+
+        if (FrameGraphHelpers::HasDepthOrStencil(Info.TextureResourceInfo.Format))
+        {
+            DepthStencilAttachment = Attachment;
+            continue;
+        }
+
         FrameBufferConfig.Attachments.push_back(Attachment);
     }
 
+    if (DepthStencilAttachment.Attachment != nullptr)
+    {
+        FrameBufferConfig.Attachments.push_back(DepthStencilAttachment);
+    }
+
     FrameBufferConfig.Resolution.Width = Width;
     FrameBufferConfig.Resolution.Height = Height;
 
-    inNode->FrameBufferHandle = Renderer::Get().GetRenderInterface().Get()->CreateFrameBuffer(FrameBufferConfig);
+    inNode.FrameBufferHandle = Renderer::Get().GetRenderInterface().Get()->CreateFrameBuffer(FrameBufferConfig);
 }
@@ -1,27 +1,241 @@
 #pragma once
 
 #include "FrameGraphBuilder.h"
+#include "FrameGraphMemoryPlanner.h"
+#include "FrameGraphPrecompiled.h"
 
 #include <Misc/Assert.h>
 #include <Misc/Logging/Log.h>
 #include <Misc/Defines/StringDefines.h>
 
+class ISemaphore;
+
+namespace enki
+{
+    class TaskScheduler;
+}
+
+/**
+* A run of consecutive sorted nodes submitted to the same queue in one go
+*/
+struct VRIXIC_API FFrameGraphSubmitBatch
+{
+public:
+    ERenderQueueType QueueType = ERenderQueueType::Graphics;
+
+    /** Indices of the sorted nodes submitted by the batch, in order */
+    std::vector<uint32> NodeIndices;
+
+    /** Signaled by the batches on other queues this batch waits for */
+    std::vector<ISemaphore*> WaitSemaphores;
+
+    /** One per batch waiting on this one, as a semaphore is only waited on once */
+    std::vector<ISemaphore*> SignalSemaphores;
+};
+
+/**
+* What one live node costs, the record numbers are updated every time the node is recorded
+*/
+struct VRIXIC_API FFrameGraphNodeStats
+{
+public:
+    /** Name of the node (StringHash) */
+    uint32 Name = 0;
+
+    ERenderQueueType QueueType = ERenderQueueType::Graphics;
+
+    /** CPU time spent recording the node the last time, and smoothed over the frames */
+    float RecordTimeMs = 0.0f;
+    float AverageRecordTimeMs = 0.0f;
+
+    /** Draws recorded by the node's FFrameGraphRenderPass the last time */
+    uint32 NumDraws = 0;
+
+    uint32 NumBarriers = 0;
+
+    /** Barriers handing a texture over to another queue after the node */
+    uint32 NumReleaseBarriers = 0;
+
+    uint32 NumRecords = 0;
+};
+
+/**
+* Memory one transient attachment takes and where it was placed
+*/
+struct VRIXIC_API FFrameGraphResourceStats
+{
+public:
+    /** Name of the output (StringHash) */
+    uint32 Name = 0;
+
+    uint32 Width = 0;
+    uint32 Height = 0;
+    EPixelFormat Format = EPixelFormat::Undefined;
+
+    uint64 SizeInBytes = 0;
+
+    uint32 HeapIndex = 0;
+    uint64 Offset = 0;
+
+    /** Sorted nodes the attachment is alive on, inclusive */
+    uint32 FirstUse = 0;
+    uint32 LastUse = 0;
+
+    /** Other attachments whose memory overlaps this one's in the heap, never alive at the same time */
+    uint32 NumAliases = 0;
+};
+
+/**
+* Snapshot of what compiling and recording a graph costs, see FrameGraph::GetStats
+*/
+struct VRIXIC_API FFrameGraphStats
+{
+public:
+    /** One per live node, in topological order */
+    std::vector<FFrameGraphNodeStats> Nodes;
+
+    /** One per transient attachment */
+    std::vector<FFrameGraphResourceStats> Resources;
+
+    /** Heap memory, memory without aliasing and memory alive at peak, aliasing saves NaiveMemory - HeapMemory */
+    FFrameGraphMemoryStats Memory;
+
+    float CompileTimeMs = 0.0f;
+
+    /** Wall time of the last Execute or Submit, only the recording, nodes recorded in parallel overlap */
+    float RecordTimeMs = 0.0f;
+
+    uint32 NumCulledNodes = 0;
+    uint32 NumBarriers = 0;
+    uint32 NumQueueTransfers = 0;
+    uint32 NumSubmitBatches = 0;
+};
+
+/**
+* What a compilation derived for one live node, copied back into the node when the compilation is reused
+*/
+struct VRIXIC_API FFrameGraphNodeCompilation
+{
+public:
+    IFrameBuffer* FrameBufferHandle = nullptr;
+
+    std::vector<FFrameGraphNodeHandle> Edges;
+    std::vector<FTextureBarrier> Barriers;
+    std::vector<FTextureBarrier> ReleaseBarriers;
+    std::vector<FFrameGraphNodeHandle> QueueWaits;
+
+    /** Texture of each output, in the order of the node's outputs */
+    std::vector<TextureResource*> OutputTextures;
+};
+
+/**
+* Everything compiling the graph derives for one set of enabled nodes.
+* Compilations are kept (and own their GPU objects) so going back to a set of enabled nodes compiled before only swaps the compilation in,
+*   up to FrameGraph::MAX_CACHED_COMPILATIONS of them
+*/
+struct VRIXIC_API FFrameGraphCompilation
+{
+public:
+    /** Bit i is set if the i-th parsed node was enabled */
+    uint64 EnabledMask = 0;
+
+    /** Value of FrameGraph::CompilationClock when the compilation was last applied, the oldest one is evicted first */
+    uint64 LastApplied = 0;
+
+    /** Live nodes (enabled and contributing to an output of the graph) in topological order */
+    std::vector<FFrameGraphNodeHandle> Nodes;
+
+    /** One per live node, in the same order */
+    std::vector<FFrameGraphNodeCompilation> NodeData;
+
+    std::vector<ITransientHeap*> TransientHeaps;
+    std::vector<TextureResource*> TransientTextures;
+
+    std::vector<FFrameGraphSubmitBatch> SubmitBatches;
+
+    FFrameGraphStats Stats;
+};
+
 class VRIXIC_API FrameGraph
 {
 public:
     void Init(FrameGraphBuilder* inBuilder);
     void Shutdown();
 
+    /**
+    * Parses the nodes of the graph, the optional "outputs" array names the resources the graph is evaluated for (see MarkOutput).
+    * If the precompiled file next to the json (same name, .vfg) was made from the same json it is loaded instead,
+    *   and the first compile reuses the compilation stored in it
+    */
     void Parse(const std::string inFilePath);
 
     void Reset();
-    void EnableRenderPass(std::string inRenderPassName);
-    void DisableRenderPass(std::string inRenderPassName);
 
+    /**
+    * @param inRenderPassName name of the node hashed with StringHash (ex: "DepthPrePass"_SHID)
+    */
+    void EnableRenderPass(uint32 inRenderPassName);
+    void DisableRenderPass(uint32 inRenderPassName);
+
+    /**
+    * Marks a resource as a final output of the graph, has to be done before the first compile.
+    * Nodes producing a marked resource (or a reference to an outside resource) are kept along with every node they read from,
+    *   other enabled nodes are culled. Without any such node nothing is culled
+    */
+    void MarkOutput(uint32 inResourceName);
+
+    /**
+    * Culls, sorts and plans the enabled nodes, the result is cached by the set of enabled nodes:
+    *   compiling a set that was compiled before only swaps the cached compilation back in.
+    * Once MAX_CACHED_COMPILATIONS are cached the least recently applied one is evicted, its GPU objects are freed by the next Execute()/Submit()
+    */
     void Compile();
 
-    FFrameGraphNode* GetNode(std::string& inName);
-    FFrameGraphResource* GetResource(std::string& inName);
+    /**
+    * Records every live node in topological order: its barriers, then its render pass with the registered FFrameGraphRenderPass
+    *
+    * @param inCommandBuffer the command buffer to record to, has to have begun and be outside of a render pass
+    */
+    void Execute(ICommandBuffer* inCommandBuffer);
+
+    /**
+    * Records every live node into its own command buffer, a node is recorded as a task once the nodes it reads from are recorded,
+    *   then submits the command buffers to the queue of each node in the sorted order with semaphores between the queues
+    *
+    * @param inFrameIndex the frame in flight the command buffers are acquired for, its last use has to be finished on the GPU
+    * @param inTaskScheduler records the nodes on the calling thread if null
+    *
+    * @note FFrameGraphRenderPass::Render can be called from any worker thread, and the submission comes before the one of the
+    *   frame's main command buffer, which runs after the graph on the graphics queue
+    */
+    void Submit(uint32 inFrameIndex, enki::TaskScheduler* inTaskScheduler);
+
+    FFrameGraphNodeHandle GetNode(uint32 inName);
+    FFrameGraphResourceHandle GetResource(uint32 inName);
+
+    /**
+    * @returns FFrameGraphStats copy of the stats of the active compilation, empty if the graph was not compiled
+    */
+    FFrameGraphStats GetStats() const;
+
+    /**
+    * Writes the graph as a Graphviz dot file: every parsed node (culled and disabled ones greyed out),
+    *   the live ones annotated with their stats and the edges with the resources they carry
+    */
+    bool DumpGraphviz(const std::string& inFilePath) const;
+
+    /**
+    * Writes the graph and the stats of the active compilation as json
+    */
+    bool DumpJson(const std::string& inFilePath) const;
+
+    /**
+    * Tool mode: parses a graph json, culls and sorts the nodes it enables and writes the precompiled file next to it.
+    * Does not need a render interface, the aliasing plan is added by the engine the first time it compiles the graph
+    *
+    * @returns bool false if the json could not be loaded or the file could not be written
+    */
+    static bool PrecompileGraph(const std::string& inFilePath);
 
     inline const FrameGraphBuilder* GetBuilder()
     {
@@ -29,18 +243,158 @@ public:
     }
 
 private:
-    static void ComputeEdges(FrameGraph* inFrameGraph, FFrameGraphNode* inNode, uint32 inNodeIndex);
+    /**
+    * Creates the nodes described by the json of a graph
+    */
+    void ParseJson(const std::string& inJson);
+
+    /**
+    * Creates the nodes stored in a precompiled file
+    *
+    * @returns bool false if the file is missing, corrupt or was made from another json (SourceHash)
+    */
+    bool LoadPrecompiled(const std::string& inFilePath);
+
+    /**
+    * Writes the parsed nodes, the sorted live nodes, their edges and the transients of inPlan to a precompiled file
+    */
+    bool WritePrecompiled(FFrameGraphPrecompiled& inPlan, uint64 inEnabledMask, const std::string& inFilePath) const;
+
+    /**
+    * Connects the inputs of the precompiled live nodes to the outputs they read without looking them up by name
+    *
+    * @returns std::vector<FFrameGraphNodeHandle> the live nodes in topological order
+    */
+    std::vector<FFrameGraphNodeHandle> RestorePrecompiledNodes(const FFrameGraphPrecompiled& inPrecompiled);
+
+    /**
+    * @returns uint64 bit i set if the i-th parsed node is enabled, the key of the cached compilations
+    */
+    uint64 GetEnabledMask() const;
+
+    /**
+    * @returns std::vector<FFrameGraphNodeHandle> the enabled nodes reachable backwards (through their inputs) from the nodes producing the graph outputs
+    */
+    std::vector<FFrameGraphNodeHandle> CullNodes();
+
+    /**
+    * Sorts the live nodes topologically, the nodes producing a resource come before the ones reading it
+    */
+    std::vector<FFrameGraphNodeHandle> SortNodes(const std::vector<FFrameGraphNodeHandle>& inLiveNodes);
+
+    /**
+    * Copies what a compilation derived for its nodes back into them and makes it the one executed
+    */
+    void ApplyCompilation(FFrameGraphCompilation* inCompilation);
+
+    /**
+    * Frees the framebuffers, attachments, heaps and semaphores owned by a compilation
+    */
+    void ReleaseCompilation(FFrameGraphCompilation* inCompilation);
+
+    /**
+    * Retires the least recently applied compilations (never the active one) until a new one fits in the cache
+    */
+    void EvictCompilations();
 
-    static void CreateRenderPass(FrameGraph* inFrameGraph, FFrameGraphNode* inNode);
+    /**
+    * Frees the evicted compilations, called once the renderer has waited on the frames that could still use them
+    */
+    void ReleaseRetiredCompilations();
 
-    static void CreateFrameBuffer(FrameGraph* inFrameGraph, FFrameGraphNode* inNode);
+    static void ComputeEdges(FrameGraph* inFrameGraph, FFrameGraphNodeHandle inNodeHandle);
+
+    /**
+    * Makes an input read an output: copies its resource info and adds an edge from the producer of the output to the node
+    */
+    void ConnectInput(FFrameGraphNodeHandle inNodeHandle, FFrameGraphResourceHandle inInputHandle, FFrameGraphResourceHandle inOutputHandle);
+
+    static void CreateRenderPass(FrameGraph* inFrameGraph, FFrameGraphNode& inNode);
+
+    static void CreateFrameBuffer(FrameGraph* inFrameGraph, FFrameGraphNode& inNode);
+
+    /**
+    * Finds the attachments produced in the graph and their lifetimes over the sorted nodes, the requirements and placements are left empty
+    */
+    void GatherTransients(std::vector<FFrameGraphPrecompiledTransient>& outTransients);
+
+    /**
+    * Creates the attachments produced in the graph, placed in shared heaps by the lifetime of each one over the sorted nodes
+    *
+    * @param inPrecompiledPlan placements reused if they are for the same attachments with the same memory requirements, can be null
+    * @param outPlan receives the transients and heaps used, can be null
+    * @returns bool true if the placements of inPrecompiledPlan were reused
+    */
+    bool PlanTransientMemory(FFrameGraphCompilation* inCompilation, const FFrameGraphPrecompiled* inPrecompiledPlan, FFrameGraphPrecompiled* outPlan);
+
+    /**
+    * Derives the barriers of every live node from the layout each resource is used in, walking the sorted nodes.
+    * A barrier is only added when the layout changes or the previous use wrote to the resource
+    */
+    void ComputeBarriers();
+
+    /**
+    * Splits the sorted nodes into submit batches: a new batch starts when the queue changes or a node waits on a batch the current one does not.
+    * Every non graphics batch nothing waits on is joined by the graphics queue at the end, so the frame's fence covers it
+    */
+    void BuildSubmitBatches(FFrameGraphCompilation* inCompilation);
+
+    /**
+    * Records the barriers of the node, its render pass (graphics nodes only) and the ownership releases that follow it,
+    *   then updates the node's stats
+    *
+    * @param inNodeIndex index of the node in the sorted nodes
+    */
+    void RecordNode(uint32 inNodeIndex, ICommandBuffer* inCommandBuffer);
+
+    /**
+    * Fills the node stats of a new compilation from what it derived, the record numbers start at 0
+    */
+    void InitNodeStats(FFrameGraphCompilation* inCompilation);
+
+    /** Records one node in the command buffer acquired for the worker thread running it */
+    struct FNodeTask;
 
 private:
 
-    /** Nodes stored in topological order */
-    std::vector<FFrameGraphNode*> Nodes;
+    /** Nodes in the order they were parsed, the bits of the enabled masks */
+    std::vector<FFrameGraphNodeHandle> ParsedNodes;
+
+    /** Live nodes of the active compilation stored in topological order */
+    std::vector<FFrameGraphNodeHandle> Nodes;
+
+    /** Names (hashed) of the resources marked as outputs of the graph */
+    std::vector<uint32> GraphOutputs;
 
     FrameGraphBuilder* GraphBuilder;
 
+    FrameGraphMemoryPlanner MemoryPlanner;
+
+    /** Enabled mask -> compilation, owned by the graph */
+    TMap<uint64, FFrameGraphCompilation*> Compilations;
+    FFrameGraphCompilation* ActiveCompilation = nullptr;
+
+    /** Every compilation owns its own heaps and attachments, the cache is capped so toggling nodes cannot grow GPU memory without bound */
+    static constexpr uint32 MAX_CACHED_COMPILATIONS = 8;
+
+    /** Bumped every time a compilation is applied */
+    uint64 CompilationClock = 0;
+
+    /** Evicted compilations, the GPU may still be using them until the next frame is recorded */
+    std::vector<FFrameGraphCompilation*> RetiredCompilations;
+
     std::string Name;
+
+    /** XXHash64 of the json the graph was parsed from */
+    uint64 SourceHash = 0;
+
+    /** Where the precompiled form of the graph is read from and written to */
+    std::string PrecompiledPath;
+
+    /** Handle of the first resource of the graph, the builder creates the resources of the parsed nodes one after the other */
+    FrameGraphHandle FirstResourceHandle = 0;
+
+    /** Loaded by Parse, only used by the first compile */
+    FFrameGraphPrecompiled Precompiled;
+    bool bIsPrecompiledLoaded = false;
 };
\ No newline at end of file
@@ -8,133 +8,146 @@ void FrameGraphBuilder::Init()
 
 void FrameGraphBuilder::Shutdown()
 {
-    for (auto It = NodeMap.Begin(); It != NodeMap.End(); ++It)
-    {
-        delete It->second;
-    }
-
-    for (auto It = ResourceMap.Begin(); It != ResourceMap.End(); ++It)
-    {
-        delete It->second;
-    }
-
     for (auto It = RenderPassMap.Begin(); It != RenderPassMap.End(); ++It)
     {
         delete It->second;
     }
+
+    Nodes.clear();
+    Resources.clear();
 }
 
-void FrameGraphBuilder::RegisterRenderPass(std::string& inName, FFrameGraphRenderPass* inRenderPass)
+void FrameGraphBuilder::RegisterRenderPass(const char* inName, FFrameGraphRenderPass* inRenderPass)
 {
+    uint32 Name = StringHash::GetStringHash(inName);
+
     {
-        auto It = RenderPassMap.Find(inName);
+        auto It = RenderPassMap.Find(Name);
         if (It != RenderPassMap.End())
         {
             return;
         }
     }
 
-    RenderPassMap.Add(inName, inRenderPass);
+    RenderPassMap.Add(Name, inRenderPass);
 
-    auto It = NodeMap.Find(inName);
-    VE_ASSERT(It != NodeMap.End(), VE_TEXT("[FrameGraphBuilder]: error..."));
+    FFrameGraphNodeHandle NodeHandle = GetNode(Name);
+    VE_ASSERT(NodeHandle.IsValid(), VE_TEXT("[FrameGraphBuilder]: Cannot register render pass {0}, no node has its name..."), inName);
 
-    FFrameGraphNode* Node = It->second;
-    Node->GraphRenderPass = inRenderPass;
+    AccessNode(NodeHandle).GraphRenderPass = inRenderPass;
 }
 
-FFrameGraphResource* FrameGraphBuilder::CreateNodeOutput(const FFrameGraphResourceOutputCreation& inCreation, FFrameGraphNode* inProducer)
+FFrameGraphResourceHandle FrameGraphBuilder::CreateNodeOutput(const FFrameGraphResourceOutputCreation& inCreation, FFrameGraphNodeHandle inProducer)
 {
-    FFrameGraphResource* Resource = new FFrameGraphResource();
-    Resource->Type = inCreation.Type;
-    Resource->Name = inCreation.Name;
+    FFrameGraphResourceHandle Handle = { (FrameGraphHandle)Resources.size() };
+    Resources.emplace_back();
+
+    FFrameGraphResource& Resource = Resources.back();
+    Resource.Type = inCreation.Type;
+    Resource.Name = StringHash::GetStringHash(inCreation.Name.c_str());
 
     if (inCreation.Type != EFrameGraphResourceType::Reference)
     {
-        Resource->ResourceInfo = inCreation.ResourceInfo;
-        Resource->OutputHandle = Resource;
-        Resource->Producer = inProducer;
-        Resource->ReferenceCount = 0;
+        Resource.ResourceInfo = inCreation.ResourceInfo;
+        Resource.OutputHandle = Handle;
+        Resource.Producer = inProducer;
+        Resource.ReferenceCount = 0;
 
-        ResourceMap.Add(Resource->Name, Resource);
+        ResourceMap.Add(Resource.Name, Handle.Handle);
     }
 
-    return Resource;
+    return Handle;
 }
 
-FFrameGraphResource* FrameGraphBuilder::CreateNodeInput(const FFrameGraphResourceInputCreation& inCreation)
+FFrameGraphResourceHandle FrameGraphBuilder::CreateNodeInput(const FFrameGraphResourceInputCreation& inCreation)
 {
-    FFrameGraphResource* Resource = new FFrameGraphResource();
+    FFrameGraphResourceHandle Handle = { (FrameGraphHandle)Resources.size() };
+    Resources.emplace_back();
 
-    Resource->ResourceInfo = { };
-    Resource->Producer = nullptr;
-    Resource->OutputHandle = nullptr;
-    Resource->Type = inCreation.Type;
-    Resource->Name = inCreation.Name;
-    Resource->ReferenceCount = 0;
+    // The producer and output are resolved by name once the graph is compiled
+    FFrameGraphResource& Resource = Resources.back();
+    Resource.ResourceInfo = { };
+    Resource.Type = inCreation.Type;
+    Resource.Name = StringHash::GetStringHash(inCreation.Name.c_str());
+    Resource.ReferenceCount = 0;
 
-    return Resource;
+    return Handle;
 }
 
-FFrameGraphNode* FrameGraphBuilder::CreateNode(const FFrameGraphNodeCreation& inCreation)
+FFrameGraphNodeHandle FrameGraphBuilder::CreateNode(const FFrameGraphNodeCreation& inCreation)
 {
-    FFrameGraphNode* Node = new FFrameGraphNode();
-    Node->Name = inCreation.Name;
-    Node->bIsEnabled = inCreation.bIsEnabled;
-    Node->Inputs.resize(inCreation.Inputs.size());
-    Node->Outputs.resize(inCreation.Outputs.size());
-    Node->Edges.resize(inCreation.Outputs.size());
-    Node->FrameBufferHandle = nullptr;
-    Node->RenderPassHandle = nullptr;
+    FFrameGraphNodeHandle Handle = { (FrameGraphHandle)Nodes.size() };
+    Nodes.emplace_back();
+
+    FFrameGraphNode& Node = Nodes.back();
+    Node.Name = StringHash::GetStringHash(inCreation.Name.c_str());
+    Node.bIsEnabled = inCreation.bIsEnabled;
+    Node.QueueType = inCreation.QueueType;
+    Node.Inputs.resize(inCreation.Inputs.size());
+    Node.Outputs.resize(inCreation.Outputs.size());
+    Node.FrameBufferHandle = nullptr;
+    Node.RenderPassHandle = nullptr;
 
-    NodeMap.Add(inCreation.Name, Node);
+    NodeMap.Add(Node.Name, Handle.Handle);
 
     // Firstly create the outputs, then we match the input resource with the right handles
     for (uint64 i = 0; i < inCreation.Outputs.size(); ++i)
     {
-        const FFrameGraphResourceOutputCreation& OutputCreation = inCreation.Outputs[i];
-        FFrameGraphResource* Output = CreateNodeOutput(OutputCreation, Node);
-        Node->Outputs[i] = Output;
+        Node.Outputs[i] = CreateNodeOutput(inCreation.Outputs[i], Handle);
     }
 
     for (uint64 i = 0; i < inCreation.Inputs.size(); ++i)
     {
-        const FFrameGraphResourceInputCreation& InputCreation = inCreation.Inputs[i];
-        FFrameGraphResource* Input = CreateNodeInput(InputCreation);
-        Node->Inputs[i] = Input;
+        Node.Inputs[i] = CreateNodeInput(inCreation.Inputs[i]);
     }
 
-    return Node;
+    return Handle;
 }
 
-FFrameGraphNode* FrameGraphBuilder::GetNode(std::string& inNodeName)
+FFrameGraphNodeHandle FrameGraphBuilder::GetNode(uint32 inNodeName)
 {
+    FFrameGraphNodeHandle Handle;
+
     auto It = NodeMap.Find(inNodeName);
-    if (It == NodeMap.End())
+    if (It != NodeMap.End())
     {
-        return nullptr;
+        Handle.Handle = It->second;
     }
 
-    return It->second;
+    return Handle;
+}
+
+FFrameGraphNodeHandle FrameGraphBuilder::GetNode(const char* inNodeName)
+{
+    return GetNode(StringHash::GetStringHash(inNodeName));
 }
 
-FFrameGraphNode* FrameGraphBuilder::AccessNode(FFrameGraphNodeHandle inNodeHandle)
+FFrameGraphNode& FrameGraphBuilder::AccessNode(FFrameGraphNodeHandle inNodeHandle)
 {
-    return nullptr;
+    VE_ASSERT(inNodeHandle.Handle < Nodes.size(), VE_TEXT("[FrameGraphBuilder]: Node handle {0} is out of range..."), inNodeHandle.Handle);
+    return Nodes[inNodeHandle.Handle];
 }
 
-FFrameGraphResource* FrameGraphBuilder::GetResource(std::string& inResourceName)
+FFrameGraphResourceHandle FrameGraphBuilder::GetResource(uint32 inResourceName)
 {
+    FFrameGraphResourceHandle Handle;
+
     auto It = ResourceMap.Find(inResourceName);
-    if (It == ResourceMap.End())
+    if (It != ResourceMap.End())
     {
-        return nullptr;
+        Handle.Handle = It->second;
     }
 
-    return It->second;
+    return Handle;
+}
+
+FFrameGraphResourceHandle FrameGraphBuilder::GetResource(const char* inResourceName)
+{
+    return GetResource(StringHash::GetStringHash(inResourceName));
 }
 
-FFrameGraphResource* FrameGraphBuilder::AccessResource(FFrameGraphResourceHandle inResourceHandle)
+FFrameGraphResource& FrameGraphBuilder::AccessResource(FFrameGraphResourceHandle inResourceHandle)
 {
-    return nullptr;
+    VE_ASSERT(inResourceHandle.Handle < Resources.size(), VE_TEXT("[FrameGraphBuilder]: Resource handle {0} is out of range..."), inResourceHandle.Handle);
+    return Resources[inResourceHandle.Handle];
 }
@@ -3,6 +3,7 @@
 #include "FrameGraphGenerics.h"
 
 #include <Containers/Map.h>
+#include <Runtime/Core/Strings/StringHash.h>
 
 struct VRIXIC_API FFrameGraphResourceOutputCreation 
 {
@@ -25,11 +26,17 @@ struct VRIXIC_API FFrameGraphNodeCreation
     std::vector<FFrameGraphResourceInputCreation>  Inputs;
     std::vector<FFrameGraphResourceOutputCreation> Outputs;
 
+    ERenderQueueType QueueType = ERenderQueueType::Graphics;
+
     bool bIsEnabled = true;
 
     std::string Name;
 };
 
+/**
+* Stores the nodes and resources of frame graphs in contiguous arrays, handles are indices into them.
+* Names are interned with StringHash, lookups by name only hash the string once
+*/
 class VRIXIC_API FrameGraphBuilder
 {
     friend class FrameGraph;
@@ -38,21 +45,52 @@ public:
 
     void Shutdown();
 
-    void RegisterRenderPass(std::string& inName, FFrameGraphRenderPass* inRenderPass);
+    void RegisterRenderPass(const char* inName, FFrameGraphRenderPass* inRenderPass);
+
+    FFrameGraphResourceHandle CreateNodeOutput(const FFrameGraphResourceOutputCreation& inCreation, FFrameGraphNodeHandle inProducer);
+    FFrameGraphResourceHandle CreateNodeInput(const FFrameGraphResourceInputCreation& inCreation);
+    FFrameGraphNodeHandle CreateNode(const FFrameGraphNodeCreation& inCreation);
+
+    /**
+    * @returns FFrameGraphNodeHandle the node with the name (hashed with StringHash), invalid if there is none
+    */
+    FFrameGraphNodeHandle GetNode(uint32 inNodeName);
+    FFrameGraphNodeHandle GetNode(const char* inNodeName);
 
-    FFrameGraphResource* CreateNodeOutput(const FFrameGraphResourceOutputCreation& inCreation, FFrameGraphNode* inProducer);
-    FFrameGraphResource* CreateNodeInput(const FFrameGraphResourceInputCreation& inCreation);
-    FFrameGraphNode* CreateNode(const FFrameGraphNodeCreation& inCreation);
+    /**
+    * @note the reference is only valid until the next node is created
+    */
+    FFrameGraphNode& AccessNode(FFrameGraphNodeHandle inNodeHandle);
 
-    FFrameGraphNode* GetNode(std::string& inNodeName);
-    FFrameGraphNode* AccessNode(FFrameGraphNodeHandle inNodeHandle);
+    /**
+    * @returns FFrameGraphResourceHandle the output with the name (hashed with StringHash), invalid if no node outputs it
+    */
+    FFrameGraphResourceHandle GetResource(uint32 inResourceName);
+    FFrameGraphResourceHandle GetResource(const char* inResourceName);
 
-    FFrameGraphResource* GetResource(std::string& inResourceName);
-    FFrameGraphResource* AccessResource(FFrameGraphResourceHandle inResourceHandle);
+    /**
+    * @note the reference is only valid until the next resource is created
+    */
+    FFrameGraphResource& AccessResource(FFrameGraphResourceHandle inResourceHandle);
+
+public:
+    inline uint32 GetNumNodes() const
+    {
+        return (uint32)Nodes.size();
+    }
+
+    inline uint32 GetNumResources() const
+    {
+        return (uint32)Resources.size();
+    }
 
 private:
-    TMap<std::string, FFrameGraphRenderPass*> RenderPassMap;
-    TMap<std::string, FFrameGraphResource*> ResourceMap;
-    TMap<std::string, FFrameGraphNode*> NodeMap;
-};
+    std::vector<FFrameGraphNode> Nodes;
+    std::vector<FFrameGraphResource> Resources;
 
+    /** Name -> handle, only outputs are named resources */
+    TMap<uint32, FrameGraphHandle> NodeMap;
+    TMap<uint32, FrameGraphHandle> ResourceMap;
+
+    TMap<uint32, FFrameGraphRenderPass*> RenderPassMap;
+};
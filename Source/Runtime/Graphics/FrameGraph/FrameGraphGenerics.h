@@ -26,14 +26,43 @@ enum class EFrameGraphResourceType
 
 typedef uint32 FrameGraphHandle;
 
+/** Handle of a node or resource that does not exist */
+static const FrameGraphHandle INVALID_FRAME_GRAPH_HANDLE = UINT32_MAX;
+
+/**
+* Index of a node in the builder's node array
+*/
 struct VRIXIC_API FFrameGraphNodeHandle
 {
-    FrameGraphHandle Handle;
+    FrameGraphHandle Handle = INVALID_FRAME_GRAPH_HANDLE;
+
+    inline bool IsValid() const
+    {
+        return Handle != INVALID_FRAME_GRAPH_HANDLE;
+    }
+
+    inline bool operator==(const FFrameGraphNodeHandle& inOther) const
+    {
+        return Handle == inOther.Handle;
+    }
 };
 
+/**
+* Index of a resource in the builder's resource array
+*/
 struct VRIXIC_API FFrameGraphResourceHandle
 {
-    FrameGraphHandle Handle;
+    FrameGraphHandle Handle = INVALID_FRAME_GRAPH_HANDLE;
+
+    inline bool IsValid() const
+    {
+        return Handle != INVALID_FRAME_GRAPH_HANDLE;
+    }
+
+    inline bool operator==(const FFrameGraphResourceHandle& inOther) const
+    {
+        return Handle == inOther.Handle;
+    }
 };
 
 /**
@@ -99,19 +128,17 @@ public:
     /** Provides information of the resource in use based in the type */
     FFrameGraphResourceInfo      ResourceInfo = { };
 
-    /** Reference to the node that outputs the resource. (Determines the edges in the graph) */
-    struct FFrameGraphNode*        Producer = nullptr;
-    //FrameGraphNodeHandle        Producer = { 0 };
+    /** The node that outputs the resource. (Determines the edges in the graph) */
+    FFrameGraphNodeHandle       Producer;
 
-    /** Stores the parent resource */
-    struct FFrameGraphResource*    OutputHandle = nullptr;
-    //FrameGraphResourceHandle    OutputHandle = { 0 };
+    /** The output this resource is (outputs point to themselves), resolved by name for inputs */
+    FFrameGraphResourceHandle   OutputHandle;
 
     /** Used for keeping reference counts for aliasing technique (allows usage of multiple resources to share the same memory) */
     int32                       ReferenceCount = 0;
 
-    /** Name of the resource */
-    std::string                 Name;
+    /** Name of the resource, interned with StringHash */
+    uint32                      Name = 0;
 
 public:
     FFrameGraphResource() { }
@@ -138,20 +165,36 @@ public:
     FFrameGraphRenderPass* GraphRenderPass = nullptr;
 
     /** Lists of inputs for this node */
-    std::vector<FFrameGraphResource*> Inputs;
-    //std::vector<FrameGraphResourceHandle> Inputs;
+    std::vector<FFrameGraphResourceHandle> Inputs;
 
     /** List of outputs from this node */
-    std::vector<FFrameGraphResource*> Outputs;
-    //std::vector<FrameGraphResourceHandle> Outputs;
+    std::vector<FFrameGraphResourceHandle> Outputs;
 
     /** All of the nodes this node is connected to */
-    std::vector<FFrameGraphNode*> Edges;
-    //std::vector<FrameGraphNodeHandle> Edges;
+    std::vector<FFrameGraphNodeHandle> Edges;
+
+    /** Queue the node is recorded for and submitted to, a non graphics node has no render pass */
+    ERenderQueueType QueueType = ERenderQueueType::Graphics;
+
+    /** Layout transitions (and write to read dependencies) recorded before the render pass begins, derived by FrameGraph::Compile */
+    std::vector<FTextureBarrier> Barriers;
+
+    /** Queue ownership releases recorded after the node, for resources the next node to use them runs on another queue */
+    std::vector<FTextureBarrier> ReleaseBarriers;
+
+    /** Nodes on other queues that have to finish before this node starts (they release resources it acquires) */
+    std::vector<FFrameGraphNodeHandle> QueueWaits;
+
+    /** Command buffer the node was recorded in by FrameGraph::Submit, only valid for the frame being submitted */
+    ICommandBuffer* CommandBuffer = nullptr;
+
+    /** One per attachment, in the order of the render pass attachments */
+    std::vector<FRenderClearValues> ClearValues;
 
     bool bIsEnabled = true;
 
-    std::string Name;
+    /** Name of the node, interned with StringHash */
+    uint32 Name = 0;
 
 public:
     FFrameGraphNode() { } 
@@ -0,0 +1,233 @@
+/**
+* This file is part of the "Vrixic Engine" project (Copyright (c) 2022-2023 by Vrij Patel)
+* See "LICENSE.txt" for license information.
+*/
+
+#include "FrameGraphMemoryPlanner.h"
+#include <Misc/Assert.h>
+#include <Misc/Defines/StringDefines.h>
+#include <Runtime/Core/Math/VrixicMathHelper.h>
+
+#include <algorithm>
+
+static uint64 AlignUp(uint64 inValue, uint64 inAlignment)
+{
+    return ((inValue + inAlignment - 1) / inAlignment) * inAlignment;
+}
+
+uint32 FrameGraphMemoryPlanner::AddRequest(const FMemoryRequirements& inRequirements, uint32 inFirstUse, uint32 inLastUse)
+{
+    VE_ASSERT(inFirstUse <= inLastUse, VE_TEXT("[FrameGraphMemoryPlanner]: A resource cannot be last used (node {0}) before it is first used (node {1})"), inLastUse, inFirstUse);
+    VE_ASSERT(inRequirements.Alignment > 0, VE_TEXT("[FrameGraphMemoryPlanner]: A resource needs an alignment of at least 1"));
+
+    FFrameGraphMemoryRequest Request;
+    Request.Requirements = inRequirements;
+    Request.FirstUse = inFirstUse;
+    Request.LastUse = inLastUse;
+
+    Requests.push_back(Request);
+    return (uint32)Requests.size() - 1;
+}
+
+void FrameGraphMemoryPlanner::Plan()
+{
+    Placements.assign(Requests.size(), FFrameGraphMemoryPlacement());
+    Heaps.clear();
+    HeapRequests.clear();
+
+    // Biggest first, the small ones then fill the gaps left between them
+    std::vector<uint32> Order(Requests.size());
+    for (uint32 i = 0; i < Order.size(); ++i)
+    {
+        Order[i] = i;
+    }
+
+    std::sort(Order.begin(), Order.end(), [this](uint32 inA, uint32 inB)
+    {
+        const FFrameGraphMemoryRequest& A = Requests[inA];
+        const FFrameGraphMemoryRequest& B = Requests[inB];
+        if (A.Requirements.Size != B.Requirements.Size)
+        {
+            return A.Requirements.Size > B.Requirements.Size;
+        }
+
+        if (A.FirstUse != B.FirstUse)
+        {
+            return A.FirstUse < B.FirstUse;
+        }
+
+        return inA < inB;
+    });
+
+    for (uint32 RequestIndex : Order)
+    {
+        PlaceRequest(RequestIndex);
+    }
+
+    ComputeStats();
+}
+
+void FrameGraphMemoryPlanner::ApplyPlan(const std::vector<FFrameGraphMemoryHeap>& inHeaps, const std::vector<FFrameGraphMemoryPlacement>& inPlacements)
+{
+    VE_ASSERT(inPlacements.size() == Requests.size(), VE_TEXT("[FrameGraphMemoryPlanner]: {0} placements were given for {1} requests"), inPlacements.size(), Requests.size());
+
+    Heaps = inHeaps;
+    Placements = inPlacements;
+
+    HeapRequests.assign(Heaps.size(), { });
+    for (uint32 i = 0; i < Placements.size(); ++i)
+    {
+        VE_ASSERT(Placements[i].HeapIndex < Heaps.size(), VE_TEXT("[FrameGraphMemoryPlanner]: Request {0} is placed in heap {1}, there are only {2}"), i, Placements[i].HeapIndex, Heaps.size());
+        HeapRequests[Placements[i].HeapIndex].push_back(i);
+    }
+
+    ComputeStats();
+}
+
+void FrameGraphMemoryPlanner::Reset()
+{
+    Requests.clear();
+    Placements.clear();
+    Heaps.clear();
+    HeapRequests.clear();
+    Stats = FFrameGraphMemoryStats();
+}
+
+bool FrameGraphMemoryPlanner::DoLifetimesOverlap(uint32 inRequestA, uint32 inRequestB) const
+{
+    const FFrameGraphMemoryRequest& A = Requests[inRequestA];
+    const FFrameGraphMemoryRequest& B = Requests[inRequestB];
+    return A.FirstUse <= B.LastUse && B.FirstUse <= A.LastUse;
+}
+
+void FrameGraphMemoryPlanner::PlaceRequest(uint32 inRequestIndex)
+{
+    const FFrameGraphMemoryRequest& Request = Requests[inRequestIndex];
+    const uint64 Size = Request.Requirements.Size;
+    const uint64 Alignment = Request.Requirements.Alignment;
+
+    // Best gap that fits without growing a heap, otherwise the placement that grows a heap the least
+    uint32 BestHeap = UINT32_MAX;
+    uint64 BestOffset = 0;
+    uint64 BestGap = UINT64_MAX;
+
+    uint32 BestGrowHeap = UINT32_MAX;
+    uint64 BestGrowOffset = 0;
+    uint64 BestGrowth = UINT64_MAX;
+
+    std::vector<uint32> AliveRequests;
+    for (uint32 HeapIndex = 0; HeapIndex < Heaps.size(); ++HeapIndex)
+    {
+        const FFrameGraphMemoryHeap& Heap = Heaps[HeapIndex];
+        if ((Heap.MemoryTypeBits & Request.Requirements.MemoryTypeBits) == 0)
+        {
+            continue;
+        }
+
+        // Only the resources alive at the same time block memory, the rest of the heap is free for this request
+        AliveRequests.clear();
+        for (uint32 PlacedRequest : HeapRequests[HeapIndex])
+        {
+            if (DoLifetimesOverlap(inRequestIndex, PlacedRequest))
+            {
+                AliveRequests.push_back(PlacedRequest);
+            }
+        }
+
+        std::sort(AliveRequests.begin(), AliveRequests.end(), [this](uint32 inA, uint32 inB)
+        {
+            return Placements[inA].Offset < Placements[inB].Offset;
+        });
+
+        uint64 Cursor = 0;
+        for (uint32 AliveRequest : AliveRequests)
+        {
+            const uint64 AliveOffset = Placements[AliveRequest].Offset;
+
+            const uint64 Candidate = AlignUp(Cursor, Alignment);
+            if (AliveOffset > Cursor && Candidate + Size <= AliveOffset && AliveOffset - Cursor < BestGap)
+            {
+                BestHeap = HeapIndex;
+                BestOffset = Candidate;
+                BestGap = AliveOffset - Cursor;
+            }
+
+            Cursor = MathUtils::Max(Cursor, AliveOffset + Requests[AliveRequest].Requirements.Size);
+        }
+
+        // Space after the last alive resource, can be grown into
+        const uint64 Candidate = AlignUp(Cursor, Alignment);
+        if (Candidate + Size <= Heap.Size)
+        {
+            if (Heap.Size - Cursor < BestGap)
+            {
+                BestHeap = HeapIndex;
+                BestOffset = Candidate;
+                BestGap = Heap.Size - Cursor;
+            }
+        }
+        else if (Candidate + Size - Heap.Size < BestGrowth)
+        {
+            BestGrowHeap = HeapIndex;
+            BestGrowOffset = Candidate;
+            BestGrowth = Candidate + Size - Heap.Size;
+        }
+    }
+
+    if (BestHeap == UINT32_MAX && BestGrowHeap != UINT32_MAX)
+    {
+        BestHeap = BestGrowHeap;
+        BestOffset = BestGrowOffset;
+        Heaps[BestHeap].Size += BestGrowth;
+    }
+
+    if (BestHeap == UINT32_MAX)
+    {
+        FFrameGraphMemoryHeap Heap;
+        Heap.Size = Size;
+        Heap.MemoryTypeBits = Request.Requirements.MemoryTypeBits;
+
+        Heaps.push_back(Heap);
+        HeapRequests.push_back({ });
+
+        BestHeap = (uint32)Heaps.size() - 1;
+        BestOffset = 0;
+    }
+
+    // The heap can only use the memory types every request placed in it accepts
+    Heaps[BestHeap].MemoryTypeBits &= Request.Requirements.MemoryTypeBits;
+    HeapRequests[BestHeap].push_back(inRequestIndex);
+
+    Placements[inRequestIndex].HeapIndex = BestHeap;
+    Placements[inRequestIndex].Offset = BestOffset;
+}
+
+void FrameGraphMemoryPlanner::ComputeStats()
+{
+    Stats = FFrameGraphMemoryStats();
+
+    for (const FFrameGraphMemoryHeap& Heap : Heaps)
+    {
+        Stats.HeapMemory += Heap.Size;
+    }
+
+    // Sweep the use intervals, memory comes alive at the first use and is released after the last one
+    std::vector<std::pair<uint64, int64>> Events;
+    Events.reserve(Requests.size() * 2);
+    for (const FFrameGraphMemoryRequest& Request : Requests)
+    {
+        Stats.NaiveMemory += Request.Requirements.Size;
+
+        Events.push_back({ (uint64)Request.FirstUse * 2, (int64)Request.Requirements.Size });
+        Events.push_back({ (uint64)Request.LastUse * 2 + 1, -(int64)Request.Requirements.Size });
+    }
+
+    std::sort(Events.begin(), Events.end());
+
+    int64 LiveMemory = 0;
+    for (const std::pair<uint64, int64>& Event : Events)
+    {
+        LiveMemory += Event.second;
+        Stats.PeakLiveMemory = MathUtils::Max(Stats.PeakLiveMemory, (uint64)LiveMemory);
+    }
+}
@@ -0,0 +1,140 @@
+/**
+* This file is part of the "Vrixic Engine" project (Copyright (c) 2022-2023 by Vrij Patel)
+* See "LICENSE.txt" for license information.
+*/
+
+#pragma once
+#include <Core/Core.h>
+#include <Misc/Defines/GenericDefines.h>
+#include <Runtime/Graphics/TransientHeap.h>
+
+#include <vector>
+
+/**
+* A transient resource the planner has to find memory for
+*/
+struct VRIXIC_API FFrameGraphMemoryRequest
+{
+public:
+    FMemoryRequirements Requirements;
+
+    /** Index of the first and last (sorted) node that uses the resource, inclusive */
+    uint32 FirstUse = 0;
+    uint32 LastUse = 0;
+};
+
+/**
+* Where a request was placed
+*/
+struct VRIXIC_API FFrameGraphMemoryPlacement
+{
+public:
+    uint32 HeapIndex = 0;
+    uint64 Offset = 0;
+};
+
+/**
+* A heap the planner decided to use, has to be created with (at least) this size
+*/
+struct VRIXIC_API FFrameGraphMemoryHeap
+{
+public:
+    uint64 Size = 0;
+
+    /** Memory types every request placed in the heap accepts */
+    uint32 MemoryTypeBits = 0;
+};
+
+struct VRIXIC_API FFrameGraphMemoryStats
+{
+public:
+    /** Sum of the sizes of the heaps, the memory actually allocated */
+    uint64 HeapMemory = 0;
+
+    /** Memory the requests would need if each got its own allocation */
+    uint64 NaiveMemory = 0;
+
+    /** Most memory alive at any node, no placement can use less (ignoring alignment) */
+    uint64 PeakLiveMemory = 0;
+};
+
+/**
+* Packs the transient resources of a frame graph into a few heaps, resources whose lifetimes do not overlap share memory
+*
+* Requests are placed from biggest to smallest, each one goes in the smallest free gap (best fit) among the resources it is alive with,
+*   if none is big enough it goes at the end of the heap that has to grow the least.
+* Resources only share a heap if their memory types are compatible.
+* Only works on sizes and use intervals, so it does not need a render interface
+*/
+class VRIXIC_API FrameGraphMemoryPlanner
+{
+public:
+    /**
+    * Adds a resource to place
+    *
+    * @returns uint32 index of the request, its placement is stored at the same index
+    */
+    uint32 AddRequest(const FMemoryRequirements& inRequirements, uint32 inFirstUse, uint32 inLastUse);
+
+    /**
+    * Places every request added since the last reset
+    */
+    void Plan();
+
+    /**
+    * Uses placements made before (ex: by a precompiled graph) for the requests added since the last reset instead of planning them,
+    *   only the stats are computed
+    *
+    * @param inPlacements one per request, in the order they were added
+    */
+    void ApplyPlan(const std::vector<FFrameGraphMemoryHeap>& inHeaps, const std::vector<FFrameGraphMemoryPlacement>& inPlacements);
+
+    /**
+    * Removes the requests and the results of the last plan
+    */
+    void Reset();
+
+public:
+    inline uint32 GetNumRequests() const
+    {
+        return (uint32)Requests.size();
+    }
+
+    inline const FFrameGraphMemoryPlacement& GetPlacement(uint32 inRequestIndex) const
+    {
+        return Placements[inRequestIndex];
+    }
+
+    inline const std::vector<FFrameGraphMemoryHeap>& GetHeaps() const
+    {
+        return Heaps;
+    }
+
+    inline const FFrameGraphMemoryStats& GetStats() const
+    {
+        return Stats;
+    }
+
+private:
+    /**
+    * @returns bool true if both requests are alive at the same time (at least one node uses both)
+    */
+    bool DoLifetimesOverlap(uint32 inRequestA, uint32 inRequestB) const;
+
+    /**
+    * Places a request in the heap that fits it best, adds a new heap if no heap can hold its memory type
+    */
+    void PlaceRequest(uint32 inRequestIndex);
+
+    void ComputeStats();
+
+private:
+    std::vector<FFrameGraphMemoryRequest> Requests;
+    std::vector<FFrameGraphMemoryPlacement> Placements;
+    std::vector<FFrameGraphMemoryHeap> Heaps;
+
+    /** Heap -> requests already placed in it */
+    std::vector<std::vector<uint32>> HeapRequests;
+
+    FFrameGraphMemoryStats Stats;
+};
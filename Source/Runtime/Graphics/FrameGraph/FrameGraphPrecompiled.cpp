@@ -0,0 +1,182 @@
+/**
+* This file is part of the "Vrixic Engine" project (Copyright (c) 2022-2023 by Vrij Patel)
+* See "LICENSE.txt" for license information.
+*/
+
+#include "FrameGraphPrecompiled.h"
+
+#include <string.h>
+
+namespace FrameGraphPrecompiledHelpers
+{
+    template<typename T>
+    static void WriteArray(uint8*& outData, const std::vector<T>& inArray)
+    {
+        const uint64 Size = inArray.size() * sizeof(T);
+        if (Size > 0)
+        {
+            memcpy(outData, inArray.data(), Size);
+            outData += Size;
+        }
+    }
+
+    template<typename T>
+    static void ReadArray(const uint8*& outData, uint32 inCount, std::vector<T>& outArray)
+    {
+        outArray.resize(inCount);
+
+        const uint64 Size = (uint64)inCount * sizeof(T);
+        if (Size > 0)
+        {
+            memcpy(outArray.data(), outData, Size);
+            outData += Size;
+        }
+    }
+}
+
+uint32 FFrameGraphPrecompiled::AddString(const char* inString)
+{
+    const uint32 Offset = (uint32)Strings.size();
+    Strings.insert(Strings.end(), inString, inString + strlen(inString) + 1);
+
+    return Offset;
+}
+
+void FFrameGraphPrecompiled::Serialize(std::vector<uint8>& outBlob) const
+{
+    FHeader Header = { };
+    Header.Magic = BLOB_MAGIC;
+    Header.Version = BLOB_VERSION;
+    Header.SourceHash = SourceHash;
+    Header.EnabledMask = EnabledMask;
+    Header.Name = Name;
+    Header.bHasPlacements = bHasPlacements ? 1 : 0;
+    Header.NumNodes = (uint32)Nodes.size();
+    Header.NumResources = (uint32)Resources.size();
+    Header.NumGraphOutputs = (uint32)GraphOutputs.size();
+    Header.NumSortedNodes = (uint32)SortedNodes.size();
+    Header.NumTransients = (uint32)Transients.size();
+    Header.NumHeaps = (uint32)Heaps.size();
+    Header.StringsSize = (uint32)Strings.size();
+
+    outBlob.resize(sizeof(FHeader)
+        + Nodes.size() * sizeof(FFrameGraphPrecompiledNode)
+        + Resources.size() * sizeof(FFrameGraphPrecompiledResource)
+        + GraphOutputs.size() * sizeof(uint32)
+        + SortedNodes.size() * sizeof(uint32)
+        + Transients.size() * sizeof(FFrameGraphPrecompiledTransient)
+        + Heaps.size() * sizeof(FFrameGraphMemoryHeap)
+        + Strings.size());
+
+    uint8* Data = outBlob.data();
+    memcpy(Data, &Header, sizeof(FHeader));
+    Data += sizeof(FHeader);
+
+    FrameGraphPrecompiledHelpers::WriteArray(Data, Nodes);
+    FrameGraphPrecompiledHelpers::WriteArray(Data, Resources);
+    FrameGraphPrecompiledHelpers::WriteArray(Data, GraphOutputs);
+    FrameGraphPrecompiledHelpers::WriteArray(Data, SortedNodes);
+    FrameGraphPrecompiledHelpers::WriteArray(Data, Transients);
+    FrameGraphPrecompiledHelpers::WriteArray(Data, Heaps);
+    FrameGraphPrecompiledHelpers::WriteArray(Data, Strings);
+}
+
+bool FFrameGraphPrecompiled::Deserialize(const uint8* inBlob, uint64 inBlobSize)
+{
+    if (inBlobSize < sizeof(FHeader))
+    {
+        return false;
+    }
+
+    FHeader Header;
+    memcpy(&Header, inBlob, sizeof(FHeader));
+
+    if (Header.Magic != BLOB_MAGIC || Header.Version != BLOB_VERSION)
+    {
+        return false;
+    }
+
+    const uint64 ExpectedSize = sizeof(FHeader)
+        + (uint64)Header.NumNodes * sizeof(FFrameGraphPrecompiledNode)
+        + (uint64)Header.NumResources * sizeof(FFrameGraphPrecompiledResource)
+        + (uint64)Header.NumGraphOutputs * sizeof(uint32)
+        + (uint64)Header.NumSortedNodes * sizeof(uint32)
+        + (uint64)Header.NumTransients * sizeof(FFrameGraphPrecompiledTransient)
+        + (uint64)Header.NumHeaps * sizeof(FFrameGraphMemoryHeap)
+        + (uint64)Header.StringsSize;
+
+    if (inBlobSize != ExpectedSize)
+    {
+        return false;
+    }
+
+    const uint8* Data = inBlob + sizeof(FHeader);
+
+    SourceHash = Header.SourceHash;
+    EnabledMask = Header.EnabledMask;
+    Name = Header.Name;
+    bHasPlacements = Header.bHasPlacements != 0;
+
+    FrameGraphPrecompiledHelpers::ReadArray(Data, Header.NumNodes, Nodes);
+    FrameGraphPrecompiledHelpers::ReadArray(Data, Header.NumResources, Resources);
+    FrameGraphPrecompiledHelpers::ReadArray(Data, Header.NumGraphOutputs, GraphOutputs);
+    FrameGraphPrecompiledHelpers::ReadArray(Data, Header.NumSortedNodes, SortedNodes);
+    FrameGraphPrecompiledHelpers::ReadArray(Data, Header.NumTransients, Transients);
+    FrameGraphPrecompiledHelpers::ReadArray(Data, Header.NumHeaps, Heaps);
+    FrameGraphPrecompiledHelpers::ReadArray(Data, Header.StringsSize, Strings);
+
+    return IsValid();
+}
+
+bool FFrameGraphPrecompiled::IsValid() const
+{
+    if (Strings.empty() || Strings.back() != '\0' || Name >= Strings.size())
+    {
+        return false;
+    }
+
+    for (const FFrameGraphPrecompiledNode& Node : Nodes)
+    {
+        if (Node.Name >= Strings.size()
+            || (uint64)Node.FirstOutput + Node.NumOutputs > Resources.size()
+            || (uint64)Node.FirstInput + Node.NumInputs > Resources.size())
+        {
+            return false;
+        }
+    }
+
+    for (const FFrameGraphPrecompiledResource& Resource : Resources)
+    {
+        if (Resource.Name >= Strings.size() || (Resource.Source != UINT32_MAX && Resource.Source >= Resources.size()))
+        {
+            return false;
+        }
+    }
+
+    for (uint32 GraphOutput : GraphOutputs)
+    {
+        if (GraphOutput >= Strings.size())
+        {
+            return false;
+        }
+    }
+
+    for (uint32 NodeIndex : SortedNodes)
+    {
+        if (NodeIndex >= Nodes.size())
+        {
+            return false;
+        }
+    }
+
+    for (const FFrameGraphPrecompiledTransient& Transient : Transients)
+    {
+        if (Transient.Resource >= Resources.size() || Transient.FirstUse > Transient.LastUse || Transient.LastUse >= SortedNodes.size()
+            || (bHasPlacements && Transient.HeapIndex >= Heaps.size()))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
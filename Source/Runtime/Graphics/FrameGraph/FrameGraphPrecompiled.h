@@ -0,0 +1,164 @@
+/**
+* This file is part of the "Vrixic Engine" project (Copyright (c) 2022-2023 by Vrij Patel)
+* See "LICENSE.txt" for license information.
+*/
+
+#pragma once
+#include <Core/Core.h>
+#include <Misc/Defines/GenericDefines.h>
+#include <Runtime/Graphics/TransientHeap.h>
+#include "FrameGraphMemoryPlanner.h"
+
+#include <vector>
+
+/**
+* A parsed node, its resources are ranges of the resource table: outputs first, then inputs (the order the builder creates them in)
+*/
+struct FFrameGraphPrecompiledNode
+{
+public:
+    /** Offset of the name in the string table */
+    uint32 Name;
+
+    /** ERenderQueueType */
+    uint32 QueueType;
+
+    uint32 bIsEnabled;
+
+    uint32 FirstOutput;
+    uint32 NumOutputs;
+    uint32 FirstInput;
+    uint32 NumInputs;
+};
+
+/**
+* An input or output of a parsed node
+*/
+struct FFrameGraphPrecompiledResource
+{
+public:
+    /** Offset of the name in the string table */
+    uint32 Name;
+
+    /** EFrameGraphResourceType */
+    int32 Type;
+
+    /** Texture outputs only, EPixelFormat and EAttachmentLoadOp */
+    uint32 Format;
+    uint32 LoadOp;
+    uint32 Width;
+    uint32 Height;
+    uint32 Depth;
+
+    /** Inputs of live nodes only: index (in the resource table) of the output read, UINT32_MAX if none. These are the edges of the graph */
+    uint32 Source;
+};
+
+/**
+* An attachment of the compiled graph and where the aliasing plan placed it
+*/
+struct FFrameGraphPrecompiledTransient
+{
+public:
+    /** Index of the output in the resource table */
+    uint32 Resource;
+
+    /** Sorted nodes the attachment is alive on, inclusive */
+    uint32 FirstUse;
+    uint32 LastUse;
+
+    /** FResourceBindFlags of every use */
+    uint32 UsageBindFlags;
+
+    /** What the device reported when the plan was made, the plan is only reused if it still reports the same */
+    FMemoryRequirements Requirements;
+
+    uint32 HeapIndex;
+    uint64 Offset;
+};
+
+/**
+* Binary form of a parsed frame graph and of its compilation for the nodes it enables, stored next to the json (.vfg).
+* Loading it skips parsing the json, and the first compile skips culling, sorting and resolving the inputs by name.
+* The aliasing plan depends on the memory requirements of the device, it is only present if the graph was compiled with one
+*   (a graph precompiled offline only has the lifetimes) and is planned again if the device reports other requirements
+*
+*   FHeader | nodes | resources | graph outputs | sorted nodes | transients | heaps | strings
+*/
+struct VRIXIC_API FFrameGraphPrecompiled
+{
+public:
+    /** XXHash64 of the json the graph was parsed from, the file is stale if it does not match */
+    uint64 SourceHash;
+
+    /** The enabled nodes the compilation is for (see FrameGraph::GetEnabledMask) */
+    uint64 EnabledMask;
+
+    /** Offset of the graph name in the string table */
+    uint32 Name;
+
+    /** false if the transients only have their lifetimes, without requirements or placements */
+    bool bHasPlacements;
+
+    std::vector<FFrameGraphPrecompiledNode> Nodes;
+    std::vector<FFrameGraphPrecompiledResource> Resources;
+
+    /** Offsets of the names of the resources marked as outputs */
+    std::vector<uint32> GraphOutputs;
+
+    /** Indices of the live nodes in topological order */
+    std::vector<uint32> SortedNodes;
+
+    std::vector<FFrameGraphPrecompiledTransient> Transients;
+    std::vector<FFrameGraphMemoryHeap> Heaps;
+
+    /** Null terminated names */
+    std::vector<char> Strings;
+
+public:
+    FFrameGraphPrecompiled()
+        : SourceHash(0), EnabledMask(0), Name(0), bHasPlacements(false) { }
+
+    /**
+    * @returns uint32 offset of the copy of the string in the string table
+    */
+    uint32 AddString(const char* inString);
+
+    inline const char* GetString(uint32 inOffset) const
+    {
+        return Strings.data() + inOffset;
+    }
+
+    void Serialize(std::vector<uint8>& outBlob) const;
+
+    /**
+    * @returns bool false if the blob is truncated, was written by another version or indexes out of its tables
+    */
+    bool Deserialize(const uint8* inBlob, uint64 inBlobSize);
+
+private:
+    /** Checks every index and string offset, so a corrupt file cannot be read out of bounds */
+    bool IsValid() const;
+
+private:
+    struct FHeader
+    {
+        uint32 Magic;
+        uint32 Version;
+        uint64 SourceHash;
+        uint64 EnabledMask;
+        uint32 Name;
+        uint32 bHasPlacements;
+        uint32 NumNodes;
+        uint32 NumResources;
+        uint32 NumGraphOutputs;
+        uint32 NumSortedNodes;
+        uint32 NumTransients;
+        uint32 NumHeaps;
+        uint32 StringsSize;
+        uint32 Padding;
+    };
+
+    static constexpr uint32 BLOB_MAGIC = 0x42474656; // 'VFGB'
+    static constexpr uint32 BLOB_VERSION = 1;
+};
@@ -18,6 +18,19 @@ public:
     virtual void ResetCommandPools(uint32 inFrameIndex) = 0;
     virtual ICommandBuffer* GetCommandBuffer(uint32 inFrameIndex, uint32 inThreadIndex) = 0;
     virtual ICommandBuffer* GetSecondaryCommandBuffer(uint32 inFrameIndex, uint32 inThreadIndex) = 0;
+
+    /**
+    * Hands out a new primary command buffer every call (until the frame's buffers are reset), created on demand
+    *
+    * @param inThreadIndex - only this thread may acquire from the same (frame, thread) at a time
+    * @param inQueueType - the queue the command buffer will be submitted to
+    */
+    virtual ICommandBuffer* AcquireCommandBuffer(uint32 inFrameIndex, uint32 inThreadIndex, ERenderQueueType inQueueType) = 0;
+
+    /**
+    * Makes every command buffer acquired for the frame available again, the frame's work has to be finished on the GPU
+    */
+    virtual void ResetAcquiredCommandBuffers(uint32 inFrameIndex) = 0;
 };
 
 /**
@@ -35,6 +48,7 @@ class CommandBufferManager : public IManager
 private:
     friend class Renderer;
     friend class VulkanRenderInterface;
+    friend class FrameGraph;
 
     VRIXIC_STATIC_MANAGER(CommandBufferManager)
 
@@ -68,6 +82,16 @@ private:
         return Manager->GetSecondaryCommandBuffer(inFrameIndex, inThreadIndex);
     }
 
+    ICommandBuffer* AcquireCommandBuffer(uint32 inFrameIndex, uint32 inThreadIndex, ERenderQueueType inQueueType)
+    {
+        return Manager->AcquireCommandBuffer(inFrameIndex, inThreadIndex, inQueueType);
+    }
+
+    void ResetAcquiredCommandBuffers(uint32 inFrameIndex)
+    {
+        Manager->ResetAcquiredCommandBuffers(inFrameIndex);
+    }
+
 private:
     ICommandBufferManager* Manager = nullptr;
 };
@@ -24,9 +24,15 @@
 #include "Shader.h"
 #include "SwapChain.h"
 #include "Texture.h"
+#include "TransientHeap.h"
 
 #include <vector>
 
+namespace enki
+{
+    class TaskScheduler;
+}
+
 /**
 * IMGUI SECTION INFO
 * Vrixic Engines editor will be made using ImGui, and so to make it simple to inject and use ImGui
@@ -166,6 +172,29 @@ public:
     */
     virtual void Free(TextureResource* inTexture) = 0;
 
+    /**
+    * @returns FMemoryRequirements the memory a texture created with inTextureConfig needs when placed in a transient heap
+    */
+    virtual FMemoryRequirements GetTextureMemoryRequirements(const FTextureConfig& inTextureConfig) = 0;
+
+    /* ------------------------------------------------------------------------------- */
+    /* -------------                Transient Heaps                ------------------- */
+    /* ------------------------------------------------------------------------------- */
+
+    /**
+    * Creates a new heap resources can be placed in (FTextureConfig::TransientHeap)
+    *
+    * @param inTransientHeapConfig info used to create the heap
+    */
+    virtual ITransientHeap* CreateTransientHeap(const FTransientHeapConfig& inTransientHeapConfig) = 0;
+
+    /**
+    * Releases/Destroys the heap passed in, the resources placed in it have to be freed first
+    *
+    * @param inTransientHeap the heap to free
+    */
+    virtual void Free(ITransientHeap* inTransientHeap) = 0;
+
     /* ------------------------------------------------------------------------------- */
     /* -------------                  Frame Buffers                ------------------- */
     /* ------------------------------------------------------------------------------- */
@@ -216,6 +245,7 @@ public:
     /**
     * Creates a pipeline layout from all the shaders passed in 
     * @note: the shaders being passed in should be all the shaders the pipeline layout might be using
+    * @note: the layout may be shared with other shaders that reflect the same bindings, it still has to be freed once per call
     * 
     * @param inShaders the shaders that will be used to create the pipeline layout
     * @param inNumShaders the number of shaders being passed in 'inShaders'
@@ -235,6 +265,7 @@ public:
 
     /**
     * Creates a new graphics pipeline with the specified configurations
+    * Configs hashing the same (shaders, fixed function state, layout and render pass) return the same pipeline, each call has to be matched by a Free
     *
     * @param inGraphicsPipelineConfig info used to create the graphics pipeline
     */
@@ -244,12 +275,23 @@ public:
     * Creates a new graphics pipeline with the specified configurations and with a pipeline cache 
     *
     * @param inGraphicsPipelineConfig info used to create the graphics pipeline
-    * @param inPipelineCachePath the path to the pipeline cache 
+    * @param inPipelineCachePath only names the pipeline, every pipeline is created against one pipeline cache shared by the render interface
     */
     virtual IPipeline* CreatePipelineWithCache(const FGraphicsPipelineConfig& inGraphicsPipelineConfig, const std::string& inPipelineCachePath) = 0;
 
     /**
-    * Releases/Destroys the pipeline passed in
+    * Same as CreatePipeline but a pipeline that does not exist yet is compiled on a worker thread,
+    * the returned pipeline cannot be bound until IPipeline::IsReady() returns true
+    *
+    * @param inGraphicsPipelineConfig info used to create the graphics pipeline, copied so it does not have to outlive the call
+    *   (the shaders, layout and render pass it points to do)
+    * @param inTaskScheduler the pipeline is compiled on this scheduler, compiled on the calling thread if nullptr
+    */
+    virtual IPipeline* CreatePipelineAsync(const FGraphicsPipelineConfig& inGraphicsPipelineConfig, enki::TaskScheduler* inTaskScheduler) = 0;
+
+    /**
+    * Releases/Destroys the pipeline passed in, shared pipelines are destroyed once every user freed them
+    * Waits for the pipeline to finish compiling if it was created asynchronously
     *
     * @param inPipeline the pipeline to free
     */
@@ -300,6 +342,27 @@ public:
   */
     virtual Shader* CreateShader(const FShaderConfig& inShaderConfig) = 0;
 
+    /**
+    * Compiles shaders ahead of time so that creating them later does not have to wait on the compiler
+    *
+    * @param inShaderConfigs configs of the shaders that will be created later
+    * @param inTaskScheduler optional, when set the shaders are compiled in parallel
+    */
+    virtual void PrecompileShaders(const FShaderConfig* inShaderConfigs, uint32 inNumShaderConfigs, enki::TaskScheduler* inTaskScheduler) = 0;
+
+    /**
+    * Adds a directory shaders can #include files from, has to be called before any shader is compiled
+    */
+    virtual void AddShaderIncludeDirectory(const std::string& inDirectoryPath) = 0;
+
+    /**
+    * Collects the shaders that include a file, directly or through other includes, so only those have to be recompiled when it changes
+    *
+    * @param inFilePath the changed file
+    * @param outShaderPaths the paths of the shaders depending on the file are appended to this
+    */
+    virtual void GetDependentShaders(const std::string& inFilePath, std::vector<std::string>& outShaderPaths) const = 0;
+
     /**
     * Releases/Destroys the shader passed in
     *
@@ -343,6 +406,13 @@ public:
     */
     virtual void Free(IDescriptorSets* inDescriptorSets) = 0;
 
+    /**
+    * Recycles the per frame resources of a frame in flight (ex: descriptor sets that were relinked or freed during the last frames)
+    *
+    * @param inFrameIndex the frame in flight that begins, the GPU has to be done with the last frame that used it
+    */
+    virtual void BeginFrame(uint32 inFrameIndex) = 0;
+
     /**
     * @returns bool true if the graphics card supports bindless texturing, false otherwise
     */
@@ -396,4 +466,9 @@ public:
     virtual ICommandQueue* GetCommandQueue() = 0;
 
     virtual ICommandQueue* GetTransferQueue() = 0;
+
+    /**
+    * @returns ICommandQueue* the queue async compute work is submitted to, can be the graphics queue if the device has no dedicated one
+    */
+    virtual ICommandQueue* GetComputeQueue() = 0;
 };
\ No newline at end of file
@@ -17,4 +17,9 @@ public:
     * @returns EPipelineBindPoint the bindpoint for this pipeline, ex. Graphics, Compute, etc...
     */
     inline virtual EPipelineBindPoint GetBindPoint() const = 0;
+
+    /**
+    * @returns bool false while a pipeline created asynchronously is still compiling, it cannot be bound until then
+    */
+    inline virtual bool IsReady() const = 0;
 };
\ No newline at end of file
@@ -5,6 +5,9 @@
 
 #pragma once
 #include <Core/Misc/Interface.h>
+#include <Misc/Assert.h>
+#include <Misc/Defines/StringDefines.h>
+#include <Runtime/Core/Math/VrixicMathHelper.h>
 #include "RenderResourceGenerics.h"
 
 #include <vector>
@@ -13,6 +16,7 @@
 
 static const uint8 MAX_BINDINGS_PER_DESCRIPTOR = 16u;
 static const uint8 MAX_DESCRIPTORS_PER_LAYOUT = 8u;
+static const uint8 MAX_PUSH_CONSTANT_RANGES_PER_LAYOUT = 4u;
 
 /**-------------------- Constants -----------------------*/
 
@@ -118,6 +122,26 @@ public:
     }
 };
 
+/**
+* Defines a range of push constants accessible by a set of shader stages
+*/
+struct VRIXIC_API FPushConstantRange
+{
+public:
+    /** Specifies the shader stages that can access this range */
+    uint32 StageFlags;
+
+    /** Offset and size of the range in bytes, both multiples of 4 */
+    uint32 Offset;
+    uint32 Size;
+
+public:
+    FPushConstantRange()
+        : StageFlags(0), Offset(0), Size(0) { }
+
+    FPushConstantRange(const FPushConstantRange&) = default;
+};
+
 /**
 * Defines a pipeline layout 
 */
@@ -127,6 +151,10 @@ public:
     /** Consists of all sets with their bindings */
     FPipelineBindingDescriptor BindingDescriptors[MAX_DESCRIPTORS_PER_LAYOUT];
 
+    /** Push constant ranges, a range used by several stages is listed once */
+    FPushConstantRange PushConstantRanges[MAX_PUSH_CONSTANT_RANGES_PER_LAYOUT];
+    uint32 NumPushConstantRanges;
+
     /** Consists of all the bindings */
     //std::vector<FPipelineBindingDescriptor> Bindings;
 
@@ -139,7 +167,7 @@ public:
     uint32 NumSets;
 
 public:
-    FPipelineLayoutConfig() : NumSets(0) { }
+    FPipelineLayoutConfig() : NumPushConstantRanges(0), NumSets(0) { }
 
     /**
     * Adds a binding descriptor to the set index specified
@@ -164,6 +192,37 @@ public:
     {
         return BindingDescriptors[inSetIndex];
     }
+
+    /**
+    * Adds a push constant range, a range matching an existing one only adds its stage flags to it.
+    *   Once the ranges are full the range is merged into the last one, which grows to cover both
+    */
+    void AddPushConstantRange(const FPushConstantRange& inRange)
+    {
+        for (uint32 i = 0; i < NumPushConstantRanges; ++i)
+        {
+            if (PushConstantRanges[i].Offset == inRange.Offset && PushConstantRanges[i].Size == inRange.Size)
+            {
+                PushConstantRanges[i].StageFlags |= inRange.StageFlags;
+                return;
+            }
+        }
+
+        VE_ASSERT(NumPushConstantRanges < MAX_PUSH_CONSTANT_RANGES_PER_LAYOUT, VE_TEXT("[FPipelineLayoutConfig]: Cannot add more than {0} push constant ranges to a layout..."), (uint32)MAX_PUSH_CONSTANT_RANGES_PER_LAYOUT);
+        if (NumPushConstantRanges == MAX_PUSH_CONSTANT_RANGES_PER_LAYOUT)
+        {
+            VE_CORE_LOG_WARN(VE_TEXT("[FPipelineLayoutConfig]: Cannot add more than {0} push constant ranges to a layout, merging the range into the last one..."), (uint32)MAX_PUSH_CONSTANT_RANGES_PER_LAYOUT);
+
+            FPushConstantRange& LastRange = PushConstantRanges[NumPushConstantRanges - 1];
+            const uint32 End = MathUtils::Max(LastRange.Offset + LastRange.Size, inRange.Offset + inRange.Size);
+            LastRange.Offset = MathUtils::Min(LastRange.Offset, inRange.Offset);
+            LastRange.Size = End - LastRange.Offset;
+            LastRange.StageFlags |= inRange.StageFlags;
+            return;
+        }
+
+        PushConstantRanges[NumPushConstantRanges++] = inRange;
+    }
 };
 
 /**
@@ -6,3 +6,12 @@
 #pragma once
 #include <Core/Misc/Interface.h>
 
+/**
+* The kind of work a queue accepts
+*/
+enum class ERenderQueueType
+{
+    Graphics,
+    Compute,
+    Transfer
+};
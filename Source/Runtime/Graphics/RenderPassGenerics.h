@@ -44,6 +44,7 @@ enum class EAttachmentStoreOp
 enum class ETextureLayout
 {
    Undefined                = 0,
+   General                  = 1, // read and written by shaders (storage images)
    ColorAttachment          = 2,
    DepthStencilAttachment   = 3,
    DepthStencilReadOnly     = 4,
@@ -63,6 +63,9 @@ public:
         // The texture will get sampled 
         Sampled                     = BIT(10),
 
+        // The texture will get read and written by shaders as a storage image
+        StorageImage                = BIT(11),
+
         /** ADDITIVE FLAGS */
         SrcTransfer                 = BIT(15), 
         DstTransfer                 = BIT(16),
@@ -9,6 +9,7 @@
 #include <Runtime/Memory/Core/MemoryManager.h>
 
 #include <Runtime/Graphics/Vulkan/VulkanRenderInterface.h>
+#include <External/ktx/Includes/ktxvulkan.h>
 
 #include <Core/Application.h>
 #include <Core/Platform/Windows/GLFWWindowsWindow.h>
@@ -18,10 +19,16 @@
 #include <Runtime/Memory/ResourceManager.h>
 #include <Runtime/File/GLTFLoader.h>
 #include <Runtime/File/AsynchronousLoader.h>
+#include <Runtime/File/DerivedDataCache.h>
+#include <Runtime/File/FileReader.h>
+#include <Runtime/Graphics/TextureTools/IBLBaker.h>
 
 #include <External/glfw/Includes/GLFW/glfw3.h>
 #include <Runtime/Core/Math/Quat.h>
 #include <stack>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
 #include <Runtime/Core/Math/ProjectionMatrix4D.h>
 #include <Runtime/Core/Math/Vector2D.h>
 
@@ -36,6 +43,7 @@ static constexpr const char FilePathToTextures[] = "../Assets/Textures/";
 static constexpr const char FilePathToModels[] = "../Assets/Models/";
 static constexpr const char FilePathToShaders[] = "../Assets/Shaders/";
 static constexpr const char FilePathToPipelineCaches[] = "../Assets/PipelineCaches/";
+static constexpr const char FilePathToDerivedDataCache[] = "../Assets/DerivedDataCache/";
 
 std::string Renderer::MakePathToResource(const std::string& inResourceName, char inResourceType)
 {
@@ -65,6 +73,82 @@ int32 GetAttributeAccessorIndex(std::vector<GLTF::FMeshPrimitiveAttribute>& attr
     return -1;
 }
 
+/** Bump when the image based lighting bakers change their output */
+static constexpr uint32 IBL_DERIVED_DATA_VERSION = 2;
+
+/**
+* @param inSourcePath - the hdr image the map is baked from, empty if the map does not depend on one (ex: brdf lut)
+* @param inBakeConfig - the config of the cpu bakers, null for maps they do not bake
+* @returns uint64 derived data key of a baked image based lighting map
+*/
+static uint64 MakeImageBasedLightingKey(const char* inMapName, uint32 inSize, const std::string& inSourcePath, const FIBLBakeConfig* inBakeConfig = nullptr)
+{
+    FDerivedDataKeyBuilder KeyBuilder("ImageBasedLighting", IBL_DERIVED_DATA_VERSION);
+    KeyBuilder.Append(std::string(inMapName));
+    KeyBuilder.AppendValue(inSize);
+
+    // Everything that changes the baked texels or the file, the task scheduler only changes how fast it is baked
+    if (inBakeConfig != nullptr)
+    {
+        KeyBuilder.AppendValue(inBakeConfig->IrradianceSize);
+        KeyBuilder.AppendValue(inBakeConfig->PrefilterSize);
+        KeyBuilder.AppendValue(inBakeConfig->NumPrefilterSamples);
+        KeyBuilder.AppendValue(inBakeConfig->SupercompressionLevel);
+    }
+
+    if (inSourcePath.size() > 0)
+    {
+        KeyBuilder.AppendFile(inSourcePath);
+    }
+
+    return KeyBuilder.GetKey();
+}
+
+/**
+* Restores a baked texture file from the derived data cache
+* @returns bool false if the cache does not have it, the texture has to be baked
+*/
+static bool FetchDerivedTexture(uint64 inKey, const std::string& inFilePath)
+{
+    FDerivedData CachedTexture;
+    if (!DerivedDataCache::Get().Get(inKey, CachedTexture))
+    {
+        return false;
+    }
+
+    FILE* File = fopen(inFilePath.c_str(), "wb");
+    if (File == nullptr)
+    {
+        return false;
+    }
+
+    const bool bWasWritten = fwrite(CachedTexture.Data.Data, CachedTexture.Data.Size, 1, File) == 1;
+    fclose(File);
+
+    return bWasWritten;
+}
+
+/**
+* Stores a freshly baked texture file in the derived data cache
+*/
+static void StoreDerivedTexture(uint64 inKey, const std::string& inFilePath)
+{
+    FFileReaderConfig ReaderConfig = { };
+    ReaderConfig.Mode = EFileReadMode::MemoryMapped;
+
+    FileReader Reader(inFilePath, ReaderConfig);
+    if (!Reader.IsOpen())
+    {
+        return;
+    }
+
+    FFileSpan Span = Reader.GetSpan();
+    if (Span.IsValid())
+    {
+        DerivedDataCache::Get().Put(inKey, Span.Data, Span.Size);
+    }
+}
+
 static uint8* GetBufferData(GLTF::FBufferView* buffer_views, uint32 buffer_index, std::vector<uint8*>& buffers_data, uint32* buffer_size = nullptr)
 {
     GLTF::FBufferView& BufferView = buffer_views[buffer_index];
@@ -82,9 +166,32 @@ static uint8* GetBufferData(GLTF::FBufferView* buffer_views, uint32 buffer_index
     return Data;
 }
 
+/**
+* @returns uint32 index inIndex of a gltf index accessor, whatever its component type
+*/
+static uint32 ReadIndex(const uint8* inIndexData, GLTF::FAccessor::EComponentType inComponentType, uint32 inIndex)
+{
+    switch (inComponentType)
+    {
+    case GLTF::FAccessor::EComponentType::UnsignedInt:
+        return ((const uint32*)inIndexData)[inIndex];
+    case GLTF::FAccessor::EComponentType::UnsignedShort:
+    case GLTF::FAccessor::EComponentType::Short:
+        return ((const uint16*)inIndexData)[inIndex];
+    default:
+        return inIndexData[inIndex];
+    }
+}
+
 void Renderer::Init(const FRendererConfig& inRendererConfig)
 {
     ResourceManager::Get().Init();
+
+    // Initialized before the render interface, the shaders and pipelines it creates go through the cache
+    FDerivedDataCacheConfig DerivedDataCacheConfig = { };
+    DerivedDataCacheConfig.CacheFolder = FilePathToDerivedDataCache;
+    DerivedDataCache::Get().Init(&DerivedDataCacheConfig);
+
     // Create the RenderInterface
     switch (inRendererConfig.RenderInterfaceType)
     {
@@ -99,6 +206,9 @@ void Renderer::Init(const FRendererConfig& inRendererConfig)
         break;
     }
 
+    RenderInterface.Get()->AddShaderIncludeDirectory(FilePathToShaders);
+    PrecompileShaders();
+
     CameraTranslation.Z = -5.0f;
     ViewMatrixWorld = Matrix4D::Identity();
     ViewMatrixWorld.SetTranslation(Vector3D(0.0f, 0.0f, 0.0f));
@@ -106,8 +216,6 @@ void Renderer::Init(const FRendererConfig& inRendererConfig)
     LightPosition = Vector4D(-10.0f, 10.0f, 10.0f, 1.0f);
     DebugFlags = 0;
 
-    NumTexturesToUpdate = 0;
-
     GraphBuilder = new FrameGraphBuilder();
     GraphBuilder->Init();
 
@@ -117,6 +225,14 @@ void Renderer::Init(const FRendererConfig& inRendererConfig)
     RenderGraph->Parse("../Sandbox/Configuration/RenderFrameGraph.json");
     RenderGraph->Compile();
 
+    FOcclusionCullerConfig OcclusionCullerConfig;
+    OcclusionCullerConfig.TaskScheduler = &VGameEngine::Get()->GetTaskScheduler();
+    MeshOcclusionCuller.Init(OcclusionCullerConfig);
+
+    FLightClustererConfig LightClustererConfig;
+    LightClustererConfig.TaskScheduler = &VGameEngine::Get()->GetTaskScheduler();
+    SceneLightClusterer.Init(LightClustererConfig);
+
     /**
     * @note try to implement everything in forms of data and tranforms (Data oriend design)
     * @TODO: Create a pipeline JSON format type to easily parse and create render pipelines 
@@ -218,12 +334,17 @@ void Renderer::Shutdown()
             delete StaticMeshes[i];
         }
 
-        RenderInterface.Get()->Free(PBRVertexShader);
+        for (auto& Permutation : PBRPermutations)
+        {
+            RenderInterface.Get()->Free(Permutation.second.StencilPipeline);
+            RenderInterface.Get()->Free(Permutation.second.Pipeline);
+            RenderInterface.Get()->Free(Permutation.second.VertexShader);
+            RenderInterface.Get()->Free(Permutation.second.FragmentShader);
+        }
+        PBRPermutations.clear();
+
         RenderInterface.Get()->Free(PBRTexturePipelineLayout);
-        RenderInterface.Get()->Free(PBRTexturePipelineStencil);
         RenderInterface.Get()->Free(PBRTexturePipelineOutline);
-        RenderInterface.Get()->Free(PBRTexturePipeline);
-        RenderInterface.Get()->Free(PBRTextureFragmentShader);
 
         RenderInterface.Get()->Free(PrefilterEnvMapPipelineLayout);
         RenderInterface.Get()->Free(PrefilterEnvMapPipeline);
@@ -277,9 +398,10 @@ void Renderer::Shutdown()
     }
 
     ResourceManager::Get().Shutdown();
+    DerivedDataCache::Get().Shutdown();
 }
 
-void Renderer::RenderStaticMesh(ICommandBuffer* inCurrentCommandBuffer, CStaticMesh* inStaticMesh)
+void Renderer::RenderStaticMesh(ICommandBuffer* inCurrentCommandBuffer, CStaticMesh* inStaticMesh, EPBRPipelineType inPipelineType)
 {
     const FRenderAssetData& RenderData = inStaticMesh->GetRenderAssetData();
     for (uint32 SectionIndex = 0; SectionIndex < RenderData.RenderAssetSections.size(); ++SectionIndex)
@@ -289,6 +411,25 @@ void Renderer::RenderStaticMesh(ICommandBuffer* inCurrentCommandBuffer, CStaticM
 
         if (!Material.IsValid()) continue;
 
+        const IPipeline* Pipeline = PBRTexturePipelineOutline;
+        if (inPipelineType != EPBRPipelineType::Outline)
+        {
+            const FPBRPermutation* Permutation = &GetPBRPermutation(Material.Flags);
+            if (!Permutation->Pipeline->IsReady() || !Permutation->StencilPipeline->IsReady())
+            {
+                Permutation = &PBRPermutations[0];
+            }
+
+            Pipeline = inPipelineType == EPBRPipelineType::Stencil ? Permutation->StencilPipeline : Permutation->Pipeline;
+        }
+
+        // Every variant shares the pipeline layout, the bound descriptor sets stay valid when switching between them
+        if (Pipeline != BoundPBRPipeline)
+        {
+            inCurrentCommandBuffer->BindPipeline(Pipeline);
+            BoundPBRPipeline = Pipeline;
+        }
+
         Material.ModelInv = (inStaticMesh->GetWorldTransform() * Material.Model).Inverse();
 
         // Update the inverse matrix 
@@ -298,13 +439,10 @@ void Renderer::RenderStaticMesh(ICommandBuffer* inCurrentCommandBuffer, CStaticM
         inCurrentCommandBuffer->SetIndexBuffer(*RenderData.IndexBuffer, Section.IndexOffset, Section.IndexType);
         inCurrentCommandBuffer->SetVertexBuffer(*RenderData.NormalBuffer, 2, 1, Section.NormalOffset);
 
+        // The variants without tangents or texcoords do not read those bindings
         if (Material.Flags & MaterialFeatures_TangentVertexAttribute) {
             inCurrentCommandBuffer->SetVertexBuffer(*RenderData.TangentBuffer, 1, 1, Section.TangentOffset);
         }
-        else
-        {
-            inCurrentCommandBuffer->SetVertexBuffer(*RenderData.NormalBuffer, 1, 1, Section.NormalOffset);
-        }
 
         if (Material.Flags & MaterialFeatures_TexcoordVertexAttribute) {
             inCurrentCommandBuffer->SetVertexBuffer(*RenderData.TexCoordBuffer, 3, 1, Section.TexCoordOffset);
@@ -428,6 +566,19 @@ void Renderer::Render()
     // Upload to buffer
     RenderInterface.Get()->WriteToBuffer(LocalConstantsBuffer, 0, &UniformData, UniformBufferLocalConstants::GetStaticSize());
 
+    NumOccludedMeshes = 0;
+    if (bEnableOcclusionCulling)
+    {
+        CullOccludedMeshes(UniformData.ViewProjection);
+    }
+
+    if (bEnableLightClustering)
+    {
+        // Same frustum as the projection above
+        SceneLightClusterer.SetProjection(AspectRatio, 60.0f, 0.01f, 1000.0f);
+        AssignClusteredLights(ViewMatrix);
+    }
+
     {
         // The the newest command buffer we will draw to 
         ICommandBuffer* CurrentCommandBuffer = CommandBufferManager::Get().GetCommandBuffer(CurrentImageIndex, 0); // CommandBuffers[CurrentImageIndex];
@@ -435,6 +586,9 @@ void Renderer::Render()
         // Being encoding command to this command buffer
         CurrentCommandBuffer->Begin();
 
+        // Textures streamed in since the last frame, transitioned before the render pass samples them
+        AddTextureUpdateCommands(CurrentCommandBuffer);
+
         // Set the main render viewport
         CurrentCommandBuffer->SetRenderViewports(&MainRenderViewport, 1);
         CurrentCommandBuffer->SetRenderScissors(&MainRenderScissor, 1);
@@ -443,8 +597,8 @@ void Renderer::Render()
         FRenderPassBeginInfo RPBeginInfo = { };
         FRenderClearValues ClearValues[2];
         ClearValues[0].Color = { 0.0f, 0.0f, 0.2f,  1.0f };
-        ClearValues[0].Depth = { 1.0f };
-        ClearValues[0].Stencil = { 0u };
+        ClearValues[1].Depth = { 1.0f };
+        ClearValues[1].Stencil = { 0u };
 
         RPBeginInfo.ClearValues = ClearValues;
         RPBeginInfo.NumClearValues = 2;
@@ -456,9 +610,9 @@ void Renderer::Render()
 
         //PBR
         {
-            // Render Meshes 
+            // Render Meshes, each section binds the pipeline of its material permutation
             //CurrentCommandBuffer->BindPipeline(PBRPipeline);
-            CurrentCommandBuffer->BindPipeline(PBRTexturePipeline);
+            BoundPBRPipeline = nullptr;
 
             FDescriptorSetsBindInfo BindInfo = { };
             BindInfo.DescriptorSets = BindlessDescriptorSet;
@@ -485,7 +639,7 @@ void Renderer::Render()
 
         // PBR Again for transparent models 
         // Blend Models 
-        CurrentCommandBuffer->BindPipeline(PBRTexturePipeline);
+        BoundPBRPipeline = nullptr;
 
         FDescriptorSetsBindInfo BindInfo = { };
         BindInfo.DescriptorSets = BindlessDescriptorSet;
@@ -519,11 +673,8 @@ void Renderer::Render()
 
         if (SelectedStaticMesh != -1)
         {
-            CurrentCommandBuffer->BindPipeline(PBRTexturePipelineStencil);
-            RenderStaticMesh(CurrentCommandBuffer, StaticMeshes[SelectedStaticMesh]);
-
-            CurrentCommandBuffer->BindPipeline(PBRTexturePipelineOutline);
-            RenderStaticMesh(CurrentCommandBuffer, StaticMeshes[SelectedStaticMesh]);
+            RenderStaticMesh(CurrentCommandBuffer, StaticMeshes[SelectedStaticMesh], EPBRPipelineType::Stencil);
+            RenderStaticMesh(CurrentCommandBuffer, StaticMeshes[SelectedStaticMesh], EPBRPipelineType::Outline);
         }
 
         // End the render pas
@@ -538,6 +689,68 @@ void Renderer::Render()
     Present();
 }
 
+void Renderer::CullOccludedMeshes(const Matrix4D& inViewProjection)
+{
+    // Sections of a loaded mesh share the transform of its node, the first material holds it
+    auto GetWorldViewProjection = [this, &inViewProjection](CStaticMesh* inStaticMesh)
+    {
+        return FFloat4x4::From(inStaticMesh->GetMaterial(0).Model * GlobalMatrix * inViewProjection);
+    };
+
+    MeshOcclusionCuller.BeginFrame();
+    for (CStaticMesh* StaticMesh : OpaqueStaticMeshes)
+    {
+        if (StaticMesh->IsOccluder())
+        {
+            const std::vector<uint32>& Indices = StaticMesh->GetOccluderIndices();
+            MeshOcclusionCuller.AddOccluder(StaticMesh->GetOccluderPositions().data(), Indices.data(), (uint32)Indices.size(), GetWorldViewProjection(StaticMesh));
+        }
+    }
+
+    MeshOcclusionCuller.Rasterize();
+
+    uint32 NumVisibleMeshes = 0;
+    for (CStaticMesh* StaticMesh : OpaqueStaticMeshes)
+    {
+        if (StaticMesh->HasLocalBounds() && StaticMesh->GetNumMaterials() > 0
+            && !MeshOcclusionCuller.IsVisible(StaticMesh->GetLocalBoundsMin(), StaticMesh->GetLocalBoundsMax(), GetWorldViewProjection(StaticMesh)))
+        {
+            continue;
+        }
+
+        OpaqueStaticMeshes[NumVisibleMeshes++] = StaticMesh;
+    }
+
+    NumOccludedMeshes = (uint32)OpaqueStaticMeshes.size() - NumVisibleMeshes;
+    OpaqueStaticMeshes.resize(NumVisibleMeshes);
+}
+
+void Renderer::AssignClusteredLights(const Matrix4D& inView)
+{
+    PointLights.clear();
+    for (CStaticMesh* LightStaticMesh : LightStaticMeshes)
+    {
+        if (LightStaticMesh == nullptr)
+        {
+            continue;
+        }
+
+        FPointLight Light;
+        Light.Position = LightStaticMesh->GetWorldTransform()[3].ToVector3D();
+        Light.Color = LightStaticMesh->GetMaterial(0).BaseColorFactor.ToVector3D();
+        Light.Intensity = 1.0f;
+
+        // The shader attenuates by 1 / d^2, past this radius the light adds less than LIGHT_CUTOFF to any channel
+        const float LIGHT_CUTOFF = 1.0f / 256.0f;
+        const float MaxChannel = MathUtils::Max(Light.Color.X, MathUtils::Max(Light.Color.Y, Light.Color.Z)) * Light.Intensity;
+        Light.Radius = std::sqrt(MaxChannel / LIGHT_CUTOFF);
+
+        PointLights.push_back(Light);
+    }
+
+    SceneLightClusterer.AssignLights(PointLights.data(), (uint32)PointLights.size(), FFloat4x4::From(inView));
+}
+
 TextureHandle Renderer::CreateTexture2D(const std::string& inTexturePath, Buffer*& outTextureBuffer, EPixelFormat inFormat)
 {
     std::string Extension = inTexturePath.substr(inTexturePath.length() - 4);
@@ -556,16 +769,21 @@ TextureHandle Renderer::CreateTexture2D(const std::string& inTexturePath, Buffer
     FTextureConfig Config = FTextureConfig();
     Config.BindFlags |= FResourceBindFlags::Sampled | FResourceBindFlags::DstTransfer;
     Config.Extent.Depth = 1;
-    Config.MipLevels = 1;
     Config.NumArrayLayers = 1;
     Config.NumSamples = 1;
     Config.Type = ETextureType::Texture2D;
     //Config.Layout = ETextureLayout::Undefined;
 
-    TextureResourceHandle& TexHandle = ResourceManager::Get().LoadTexture(inTexturePath);
+    // Generate the mip chain on import, sRGB textures are averaged in linear space 
+    FMipGenerationConfig MipConfig = { };
+    MipConfig.bIsSRGB = inFormat == EPixelFormat::RGBA8UNorm_sRGB;
+    MipConfig.TaskScheduler = &VGameEngine::Get()->GetTaskScheduler();
+
+    TextureResourceHandle TexHandle = ResourceManager::Get().LoadTexture(inTexturePath, &MipConfig);
 
     Config.Extent.Width = TexHandle.Width;
     Config.Extent.Height = TexHandle.Height;
+    Config.MipLevels = TexHandle.NumMipLevels;
 
     Config.Format = inFormat;
 
@@ -588,16 +806,18 @@ TextureHandle Renderer::CreateTexture2D(const std::string& inTexturePath, Buffer
     TextureWriteInfo.Subresource.BaseArrayLayer = 0;
     TextureWriteInfo.Subresource.NumArrayLayers = 1;
     TextureWriteInfo.Subresource.BaseMipLevel = 0;
-    TextureWriteInfo.Subresource.NumMipLevels = 1;
+    TextureWriteInfo.Subresource.NumMipLevels = TexHandle.NumMipLevels;
 
     TextureWriteInfo.Extent = { (uint32)TexHandle.Width, (uint32)TexHandle.Height, 1u };
 
+    // Pixels live in the buffer now, give the memory back to the texture arena 
+    ResourceManager::Get().FreeTexture(inTexturePath);
+
     RenderInterface.Get()->WriteToTexture(NewTextureHandle, TextureWriteInfo);
 
     Buffers.push_back(outTextureBuffer);
 
-    TexturesArray.push_back(NewTextureHandle);
-    TextureHandle Handle = TexturesArray.size() - 1;
+    TextureHandle Handle = AllocateTextureHandle(NewTextureHandle);
 
     TextureMap.Add(TextureName, Handle);
 
@@ -616,9 +836,19 @@ TextureHandle Renderer::CreateTexture2DKtx(const std::string& inTexturePath, Buf
     ktxResult Result;
     ktxTexture* KtxTextureHandle;
 
-    Result = ktxTexture_CreateFromNamedFile(inTexturePath.c_str(), KTX_TEXTURE_CREATE_LOAD_IMAGE_DATA_BIT, &KtxTextureHandle);
+    // Map the ktx file so its image data is only copied once (into the ktx texture) 
+    FFileReaderConfig ReaderConfig = { };
+    ReaderConfig.Mode = EFileReadMode::MemoryMapped;
+    ReaderConfig.AccessHint = EFileAccessHint::Sequential;
+
+    FileReader Reader(inTexturePath, ReaderConfig);
+    FFileSpan FileSpan = Reader.GetSpan();
+
+    Result = ktxTexture_CreateFromMemory(FileSpan.Data, FileSpan.Size, KTX_TEXTURE_CREATE_LOAD_IMAGE_DATA_BIT, &KtxTextureHandle);
     VE_ASSERT(Result == KTX_SUCCESS, VE_TEXT("Could not create a texture from the KTX file passed in: %s"), inTexturePath);
 
+    Reader.Close();
+
     uint32 TexWidth, TexHeight, TexMipLevels;
 
     // Get properties required for using and upload texture data from the ktx texture object
@@ -640,7 +870,7 @@ TextureHandle Renderer::CreateTexture2DKtx(const std::string& inTexturePath, Buf
     Config.Extent.Width = TexWidth;
     Config.Extent.Height = TexHeight;
 
-    Config.Format = (EPixelFormat)((ktxTexture2*)(KtxTextureHandle))->vkFormat;
+    Config.Format = (EPixelFormat)ktxTexture_GetVkFormat(KtxTextureHandle);
 
     TextureResource* NewTextureHandle = RenderInterface.Get()->CreateTexture(Config);
     NewTextureHandle->SetPath(inTexturePath);
@@ -670,8 +900,7 @@ TextureHandle Renderer::CreateTexture2DKtx(const std::string& inTexturePath, Buf
     RenderInterface.Get()->WriteToTexture(NewTextureHandle, TextureWriteInfo);
 
     Buffers.push_back(outTextureBuffer);
-    TexturesArray.push_back(NewTextureHandle);
-    TextureHandle Handle = TexturesArray.size() - 1;
+    TextureHandle Handle = AllocateTextureHandle(NewTextureHandle);
 
     TextureMap.Add(TextureName, Handle);
 
@@ -732,13 +961,21 @@ TextureHandle Renderer::CreateTextureCubemap(const std::string& inTexturePath, B
     CubemapTexture->SetPath(inTexturePath);
 
     FBufferConfig BufferConfig;
-    BufferConfig.InitialData = CubemapTextureHandles[0].GetMemoryHandle();
+    BufferConfig.InitialData = nullptr;
     BufferConfig.Size = ((TextureWidth * 6) * TextureHeight) * 4;
     BufferConfig.UsageFlags = FResourceBindFlags::UniformBuffer | FResourceBindFlags::SrcTransfer;
     BufferConfig.MemoryFlags |= FMemoryFlags::HostCoherent | FMemoryFlags::HostVisible;
 
     outTextureBuffer = RenderInterface.Get()->CreateBuffer(BufferConfig);
 
+    // Faces are not guaranteed to be next to each other in the texture arena, copy them one by one 
+    const uint64 FaceSizeInBytes = (TextureWidth * TextureHeight) * 4;
+    for (uint32 i = 0; i < 6; ++i)
+    {
+        RenderInterface.Get()->WriteToBuffer(outTextureBuffer, FaceSizeInBytes * i, CubemapTextureHandles[i].GetMemoryHandle(), FaceSizeInBytes);
+        ResourceManager::Get().FreeTexture(inTexturePath + TextureNames[i]);
+    }
+
     // Copy Buffer Memory Into Image 
     FTextureWriteInfo TextureWriteInfo = FTextureWriteInfo();
     TextureWriteInfo.BufferHandle = outTextureBuffer;
@@ -753,10 +990,9 @@ TextureHandle Renderer::CreateTextureCubemap(const std::string& inTexturePath, B
     TextureWriteInfo.Extent = { (uint32)TextureWidth, (uint32)TextureWidth, 1u };
     RenderInterface.Get()->WriteToTexture(CubemapTexture, TextureWriteInfo);
 
-    TexturesArray.push_back(CubemapTexture);
+    TextureHandle Handle = AllocateTextureHandle(CubemapTexture);
     Buffers.push_back(outTextureBuffer);
 
-    TextureHandle Handle = TexturesArray.size() - 1;
     TextureMap.Add(TextureName, Handle);
 
     return Handle;
@@ -774,9 +1010,19 @@ TextureHandle Renderer::CreateTextureCubemapKtx(const std::string& inTexturePath
     ktxResult Result;
     ktxTexture* KtxTextureHandle;
 
-    Result = ktxTexture_CreateFromNamedFile(inTexturePath.c_str(), KTX_TEXTURE_CREATE_LOAD_IMAGE_DATA_BIT, &KtxTextureHandle);
+    // Map the ktx file so its image data is only copied once (into the ktx texture) 
+    FFileReaderConfig ReaderConfig = { };
+    ReaderConfig.Mode = EFileReadMode::MemoryMapped;
+    ReaderConfig.AccessHint = EFileAccessHint::Sequential;
+
+    FileReader Reader(inTexturePath, ReaderConfig);
+    FFileSpan FileSpan = Reader.GetSpan();
+
+    Result = ktxTexture_CreateFromMemory(FileSpan.Data, FileSpan.Size, KTX_TEXTURE_CREATE_LOAD_IMAGE_DATA_BIT, &KtxTextureHandle);
     VE_ASSERT(Result == KTX_SUCCESS, VE_TEXT("Could not create a texture from the KTX file passed in: ${0}"), inTexturePath);
 
+    Reader.Close();
+
     uint32 CubemapWidth, CubemapHeight, CubemapMipLevels;
 
     // Get properties required for using and upload texture data from the ktx texture object
@@ -803,7 +1049,7 @@ TextureHandle Renderer::CreateTextureCubemapKtx(const std::string& inTexturePath
     TextureConfig.Extent.Width = CubemapWidth;
     TextureConfig.Extent.Height = CubemapHeight;
     TextureConfig.Extent.Depth = 1;
-    TextureConfig.Format = (EPixelFormat)((ktxTexture2*)(KtxTextureHandle))->vkFormat;
+    TextureConfig.Format = (EPixelFormat)ktxTexture_GetVkFormat(KtxTextureHandle);
     TextureConfig.MipLevels = CubemapMipLevels;
     TextureConfig.NumArrayLayers = 6;
     TextureConfig.KtxTextureHandle = KtxTextureHandle;
@@ -824,10 +1070,9 @@ TextureHandle Renderer::CreateTextureCubemapKtx(const std::string& inTexturePath
     TextureWriteInfo.Extent = { (uint32)CubemapWidth, (uint32)CubemapHeight, 1u };
     RenderInterface.Get()->WriteToTexture(NewTexture, TextureWriteInfo);
 
-    TexturesArray.push_back(NewTexture);
+    TextureHandle Handle = AllocateTextureHandle(NewTexture);
     Buffers.push_back(outTextureBuffer);
 
-    TextureHandle Handle = TexturesArray.size() - 1;
     TextureMap.Add(TextureName, Handle);
 
     // Clean up staging resources
@@ -838,6 +1083,20 @@ TextureHandle Renderer::CreateTextureCubemapKtx(const std::string& inTexturePath
     return Handle;
 }
 
+void Renderer::PrecompileShaders()
+{
+    std::vector<FShaderConfig> ShaderConfigs;
+    GetStartupShaderConfigs(ShaderConfigs);
+
+    typedef std::chrono::high_resolution_clock Clock;
+    auto Start = Clock::now();
+
+    RenderInterface.Get()->PrecompileShaders(ShaderConfigs.data(), (uint32)ShaderConfigs.size(), &VGameEngine::Get()->GetTaskScheduler());
+
+    float PrecompileTime = std::chrono::duration<float, std::milli>(Clock::now() - Start).count();
+    VE_CORE_LOG_INFO(VE_TEXT("[Renderer]: Precompiled {0} shaders in {1} ms"), ShaderConfigs.size(), PrecompileTime);
+}
+
 Shader* Renderer::LoadShader(FShaderConfig& inShaderConfig)
 {
     /*if (inShaderConfig.SourceType != EShaderSourceType::String)
@@ -991,230 +1250,332 @@ bool Renderer::OnKeyReleased(KeyReleasedEvent& inKeyReleasedEvent)
     return false;
 }
 
+/**
+* Adds a per vertex binding with a single attribute, the location of the attribute matches its binding
+*/
+static void AddVertexStream(uint32 inBindingNum, uint32 inStride, EPixelFormat inFormat, FShaderConfig& outShaderConfig)
+{
+    FVertexInputDescription Binding;
+    Binding.BindingNum = inBindingNum;
+    Binding.Stride = inStride;
+    Binding.InputRate = EInputRate::Vertex;
+
+    FVertexInputAttribute Attribute = { };
+    Attribute.Location = inBindingNum;
+    Attribute.BindingNum = inBindingNum;
+    Attribute.Offset = 0;
+    Attribute.Format = inFormat;
+    Binding.AddVertexAttribute(Attribute);
+
+    outShaderConfig.VertexBindings.push_back(Binding);
+}
+
+/**
+* Every feature the pbr shaders test for (see PBR/material_features.glsl), materials only pay for the ones they use
+*/
+static FShaderPermutationDomain MakePBRPermutationDomain()
+{
+    return FShaderPermutationDomain("MATERIAL_PERMUTATION",
+        MaterialFeatures_ColorTexture | MaterialFeatures_NormalTexture | MaterialFeatures_RoughnessTexture | MaterialFeatures_OcclusionTexture |
+        MaterialFeatures_EmissiveTexture | MaterialFeatures_TangentVertexAttribute | MaterialFeatures_TexcoordVertexAttribute);
+}
+
+/**
+* Fills in the shader configs of a pbr variant, the vertex shader only gets the streams the variant reads
+*/
+static void MakePBRShaderConfigs(const FShaderPermutationDomain& inDomain, uint32 inPermutation, FShaderConfig& outVertexConfig, FShaderConfig& outFragmentConfig)
+{
+    outVertexConfig = { };
+    outVertexConfig.Flags |= FShaderFlags::GLSL | FShaderFlags::OutputBinary;
+    outVertexConfig.EntryPoint = "main";
+    outVertexConfig.SourceCode = Renderer::MakePathToResource("PBR/pbr_bindless.vert", 's');
+    outVertexConfig.SourceType = EShaderSourceType::Filepath;
+    outVertexConfig.Type = EShaderType::Vertex;
+
+    // Position and normal are always there, tangent and texcoord only when the variant reads them.
+    // A stream the domain does not declare is always read
+    const uint32 VertexStreams = inPermutation | (~inDomain.FeatureMask & (MaterialFeatures_TangentVertexAttribute | MaterialFeatures_TexcoordVertexAttribute));
+    AddVertexStream(0, 12, EPixelFormat::RGB32Float, outVertexConfig);
+    if (VertexStreams & MaterialFeatures_TangentVertexAttribute)
+    {
+        AddVertexStream(1, 16, EPixelFormat::RGBA32Float, outVertexConfig);
+    }
+    AddVertexStream(2, 12, EPixelFormat::RGB32Float, outVertexConfig);
+    if (VertexStreams & MaterialFeatures_TexcoordVertexAttribute)
+    {
+        AddVertexStream(3, 8, EPixelFormat::RG32Float, outVertexConfig);
+    }
+
+    outFragmentConfig = { };
+    outFragmentConfig.Flags |= FShaderFlags::GLSL;
+    outFragmentConfig.EntryPoint = "main";
+    outFragmentConfig.SourceCode = Renderer::MakePathToResource("PBR/pbr_khr_debug_bindless.frag", 's');
+    outFragmentConfig.SourceType = EShaderSourceType::Filepath;
+    outFragmentConfig.Type = EShaderType::Fragment;
+
+    // Without declared features the shaders keep testing the material flags at runtime
+    if (inDomain.FeatureMask != 0)
+    {
+        inDomain.ApplyPermutation(inPermutation, outVertexConfig);
+        inDomain.ApplyPermutation(inPermutation, outFragmentConfig);
+    }
+}
+
+/**
+* Fills in the fixed function state shared by every pbr pipeline
+*/
+static void MakePBRPipelineState(FGraphicsPipelineConfig& outConfig)
+{
+    outConfig.PrimitiveTopology = EPrimitiveTopology::TriangleList;
+
+    // Rasterization
+    outConfig.RasterizerState.bRasterizerDiscardEnabled = false;
+    outConfig.RasterizerState.PolygonMode = EPolygonMode::Fill;
+    outConfig.RasterizerState.LineWidth = 1.0f;
+    outConfig.RasterizerState.CullMode = ECullMode::None;
+    outConfig.RasterizerState.FrontFace = EFrontFace::CounterClockwise;
+    outConfig.RasterizerState.bDepthClampEnabled = false;
+    outConfig.RasterizerState.bDepthBiasEnabled = false;
+    outConfig.RasterizerState.DepthBias.Clamp = 0.0f;
+    outConfig.RasterizerState.DepthBias.ConstantFactor = 0.0f;
+    outConfig.RasterizerState.DepthBias.SlopeFactor = 0.0f;
+
+    // Color blend state
+    outConfig.BlendState.LogicOp = ELogicOp::Disabled;
+
+    FBlendOpConfig BOConfig = { };
+    BOConfig.ColorWriteMask = 0xF;
+    BOConfig.bIsBlendEnabled = true;
+    BOConfig.SrcColorBlendFactor = EBlendFactor::SrcAlpha;
+    BOConfig.DstColorBlendFactor = EBlendFactor::OneMinusSrcAlpha;
+    BOConfig.ColorBlendOp = EBlendOp::Add;
+    BOConfig.SrcAlphaBlendFactor = EBlendFactor::OneMinusSrcAlpha;
+    BOConfig.DstAlphaBlendFactor = EBlendFactor::Zero;
+    BOConfig.AlphaBlendOp = EBlendOp::Add;
+
+    outConfig.BlendState.BlendOpConfigs.push_back(BOConfig);
+
+    // Depth stencil state
+    outConfig.DepthState.bIsTestingEnabled = true;
+    outConfig.DepthState.bIsWritingEnabled = true;
+    outConfig.DepthState.CompareOp = ECompareOp::Less;
+}
+
+/**
+* Switches a pbr pipeline state over to writing the stencil buffer, the outline pass then only draws where it was not written
+*/
+static void MakePBRStencilState(FGraphicsPipelineConfig& outConfig)
+{
+    outConfig.DepthState.CompareOp = ECompareOp::LessOrEqual;
+
+    outConfig.StencilState.bIsTestingEnabled = true;
+    outConfig.StencilState.Back.CompareOp = ECompareOp::Always;
+    outConfig.StencilState.Back.StencilFailOp = EStencilOp::Replace;
+    outConfig.StencilState.Back.DepthFailOp = EStencilOp::Replace;
+    outConfig.StencilState.Back.StencilPassOp = EStencilOp::Replace;
+    outConfig.StencilState.Back.CompareMask = 0xFF;
+    outConfig.StencilState.Back.WriteMask = 0xFF;
+    outConfig.StencilState.Back.ReferenceValue = 1;
+    outConfig.StencilState.Front = outConfig.StencilState.Back;
+}
+
+/**
+* Fills in a glsl shader config the same way the pipelines loading it do, vertex bindings are left out as they are not part of the cache key
+*/
+static FShaderConfig MakeStartupShaderConfig(const char* inShaderName, EShaderType inType, uint32 inFlags = FShaderFlags::GLSL)
+{
+    FShaderConfig Config = { };
+    Config.Flags |= inFlags;
+    Config.EntryPoint = "main";
+    Config.SourceCode = Renderer::MakePathToResource(inShaderName, 's');
+    Config.SourceType = EShaderSourceType::Filepath;
+    Config.Type = inType;
+    return Config;
+}
+
+void Renderer::GetStartupShaderConfigs(std::vector<FShaderConfig>& outShaderConfigs)
+{
+    // Full pbr variant, its layout is shared by all of them. The variants of the loaded materials are precompiled once they are known
+    {
+        FShaderConfig VSConfig;
+        FShaderConfig FragmentSConfig;
+        const FShaderPermutationDomain Domain = MakePBRPermutationDomain();
+        MakePBRShaderConfigs(Domain, Domain.FeatureMask, VSConfig, FragmentSConfig);
+
+        outShaderConfigs.push_back(VSConfig);
+        outShaderConfigs.push_back(FragmentSConfig);
+    }
+
+    outShaderConfigs.push_back(MakeStartupShaderConfig("EdgeDetection/outline.vert", EShaderType::Vertex));
+    outShaderConfigs.push_back(MakeStartupShaderConfig("EdgeDetection/outline.frag", EShaderType::Fragment));
+
+    outShaderConfigs.push_back(MakeStartupShaderConfig("Skybox/Skybox.vert", EShaderType::Vertex));
+    outShaderConfigs.push_back(MakeStartupShaderConfig("Skybox/Skybox.frag", EShaderType::Fragment));
+
+    outShaderConfigs.push_back(MakeStartupShaderConfig("Skybox/hdr_khronos.vert", EShaderType::Vertex, FShaderFlags::GLSL | FShaderFlags::InvertY | FShaderFlags::OutputBinary));
+    outShaderConfigs.push_back(MakeStartupShaderConfig("Skybox/hdr_khronos.frag", EShaderType::Fragment, FShaderFlags::GLSL | FShaderFlags::OutputBinary));
+
+    // Image based lighting
+    outShaderConfigs.push_back(MakeStartupShaderConfig("Skybox/irridiance.vert", EShaderType::Vertex));
+    outShaderConfigs.push_back(MakeStartupShaderConfig("Skybox/irridiance.frag", EShaderType::Fragment));
+    outShaderConfigs.push_back(MakeStartupShaderConfig("Skybox/prefilter_envmap.vert", EShaderType::Vertex));
+    outShaderConfigs.push_back(MakeStartupShaderConfig("Skybox/prefilter_envmap.frag", EShaderType::Fragment));
+    outShaderConfigs.push_back(MakeStartupShaderConfig("Skybox/brdf_integration.vert", EShaderType::Vertex));
+    outShaderConfigs.push_back(MakeStartupShaderConfig("Skybox/brdf_integration.frag", EShaderType::Fragment));
+}
+
 void Renderer::CreatePBRPipeline()
 {
-    // Create The PBR Pipelines
+    PBRPermutationDomain = MakePBRPermutationDomain();
+
+    // The variant using every feature also uses every binding, its layout is shared by all of the variants
     {
-        FGraphicsPipelineConfig GPConfig;
-        {
-            // Create a generic vertex shader as it is mandatory to have a vertex shader 
-            FShaderConfig VSConfig = { };
-            VSConfig.Flags |= FShaderFlags::GLSL;
-            VSConfig.EntryPoint = "main";
-            VSConfig.SourceCode = MakePathToResource("PBR/pbr_bindless.vert", 's');
-            VSConfig.SourceType = EShaderSourceType::Filepath;
-            VSConfig.Type = EShaderType::Vertex;
-
-            // Add a vertex bindings
-            VSConfig.VertexBindings.resize(4);
-
-            // Add a vertex attribute to the vertex binding 
-            FVertexInputAttribute Attribute = { };
-
-            // Position
-            VSConfig.VertexBindings[0].BindingNum = 0;
-            VSConfig.VertexBindings[0].Stride = 12;
-            VSConfig.VertexBindings[0].InputRate = EInputRate::Vertex;
-            Attribute.Location = 0;
-            Attribute.BindingNum = 0;
-            Attribute.Offset = 0;
-            Attribute.Format = EPixelFormat::RGB32Float;
-            VSConfig.VertexBindings[0].AddVertexAttribute(Attribute);
-
-            // Tangent 
-            VSConfig.VertexBindings[1].BindingNum = 1;
-            VSConfig.VertexBindings[1].Stride = 16;
-            VSConfig.VertexBindings[1].InputRate = EInputRate::Vertex;
-            Attribute.Location = 1;
-            Attribute.BindingNum = 1;
-            Attribute.Format = EPixelFormat::RGBA32Float;
-            VSConfig.VertexBindings[1].AddVertexAttribute(Attribute);
-
-            // Normal
-            VSConfig.VertexBindings[2].BindingNum = 2;
-            VSConfig.VertexBindings[2].Stride = 12;
-            VSConfig.VertexBindings[2].InputRate = EInputRate::Vertex;
-            Attribute.Location = 2;
-            Attribute.BindingNum = 2;
-            Attribute.Format = EPixelFormat::RGB32Float;
-            VSConfig.VertexBindings[2].AddVertexAttribute(Attribute);
-
-            // Texcoord
-            VSConfig.VertexBindings[3].BindingNum = 3;
-            VSConfig.VertexBindings[3].Stride = 8;
-            VSConfig.VertexBindings[3].InputRate = EInputRate::Vertex;
-            Attribute.Location = 3;
-            Attribute.BindingNum = 3;
-            Attribute.Format = EPixelFormat::RG32Float;
-            VSConfig.VertexBindings[3].AddVertexAttribute(Attribute);
-
-            VSConfig.Flags |= FShaderFlags::OutputBinary;
-
-            PBRVertexShader = LoadShader(VSConfig);
-
-            // Create a fragment shaders as well
-            {
-                FShaderConfig FragmentSConfig = { };
-                FragmentSConfig.Flags |= FShaderFlags::GLSL;
-                FragmentSConfig.EntryPoint = "main";
-                FragmentSConfig.SourceCode = MakePathToResource("PBR/pbr_khr_debug_bindless.frag", 's');
-                FragmentSConfig.SourceType = EShaderSourceType::Filepath;
-                FragmentSConfig.Type = EShaderType::Fragment;
+        FShaderConfig VSConfig;
+        FShaderConfig FragmentSConfig;
+        MakePBRShaderConfigs(PBRPermutationDomain, PBRPermutationDomain.FeatureMask, VSConfig, FragmentSConfig);
 
-                PBRTextureFragmentShader = LoadShader(FragmentSConfig);
-            }
-        }
+        FPBRPermutation Permutation = { };
+        Permutation.VertexShader = LoadShader(VSConfig);
+        Permutation.FragmentShader = LoadShader(FragmentSConfig);
+        PBRPermutations[PBRPermutationDomain.FeatureMask] = Permutation;
 
-        PBRTexturePipelineLayout = CreatePipelineLayoutFromShaders(PBRVertexShader, PBRTextureFragmentShader);
+        PBRTexturePipelineLayout = CreatePipelineLayoutFromShaders(Permutation.VertexShader, Permutation.FragmentShader);
+    }
 
-        {
-            FDescriptorSetsConfig SetsConfig = { };
-            SetsConfig.NumSets = 1;
-            SetsConfig.PipelineLayoutPtr = PBRTexturePipelineLayout;
-            SetsConfig.bIsBindlessSet = true;
+    {
+        FDescriptorSetsConfig SetsConfig = { };
+        SetsConfig.NumSets = 1;
+        SetsConfig.PipelineLayoutPtr = PBRTexturePipelineLayout;
+        SetsConfig.bIsBindlessSet = true;
 
-            BindlessDescriptorSet = RenderInterface.Get()->CreateDescriptorSet(SetsConfig);
-        }
+        BindlessDescriptorSet = RenderInterface.Get()->CreateDescriptorSet(SetsConfig);
+    }
+
+    // Outline pipeline, reads positions and normals only so it can draw every material
+    {
+        FShaderConfig VSConfig = { };
+        VSConfig.Flags |= FShaderFlags::GLSL;
+        VSConfig.EntryPoint = "main";
+        VSConfig.SourceCode = MakePathToResource("EdgeDetection/outline.vert", 's');
+        VSConfig.SourceType = EShaderSourceType::Filepath;
+        VSConfig.Type = EShaderType::Vertex;
+
+        AddVertexStream(0, 12, EPixelFormat::RGB32Float, VSConfig);
+        AddVertexStream(2, 12, EPixelFormat::RGB32Float, VSConfig);
+
+        PBRVertexShaderOutline = LoadShader(VSConfig);
 
+        FShaderConfig FragmentSConfig = { };
+        FragmentSConfig.Flags |= FShaderFlags::GLSL;
+        FragmentSConfig.EntryPoint = "main";
+        FragmentSConfig.SourceCode = MakePathToResource("EdgeDetection/outline.frag", 's');
+        FragmentSConfig.SourceType = EShaderSourceType::Filepath;
+        FragmentSConfig.Type = EShaderType::Fragment;
+
+        PBRTextureFragmentShaderOutline = LoadShader(FragmentSConfig);
+
+        FGraphicsPipelineConfig GPConfig;
+        GPConfig.RenderPassPtr = RenderPass;
+        GPConfig.PipelineLayoutPtr = PBRTexturePipelineLayout;
+        MakePBRPipelineState(GPConfig);
+        MakePBRStencilState(GPConfig);
+
+        GPConfig.StencilState.Back.CompareOp = ECompareOp::NotEqual;
+        GPConfig.StencilState.Back.StencilFailOp = EStencilOp::Keep;
+        GPConfig.StencilState.Back.DepthFailOp = EStencilOp::Keep;
+        GPConfig.StencilState.Back.StencilPassOp = EStencilOp::Replace;
+        GPConfig.StencilState.Front = GPConfig.StencilState.Back;
+        GPConfig.DepthState.bIsTestingEnabled = false;
+
+        GPConfig.FragmentShader = PBRTextureFragmentShaderOutline;
+        GPConfig.VertexShader = PBRVertexShaderOutline;
+
+        PBRTexturePipelineOutline = RenderInterface.Get()->CreatePipelineWithCache(GPConfig, MakePathToResource("PBROutlinePipelineCache", 'p'));
+    }
+
+    // Creates the pipelines of the full variant
+    // The variant without features reads positions and normals only, it draws any material until the pipeline of its own variant is ready
+    GetPBRPermutation(0, false);
+    GetPBRPermutation(PBRPermutationDomain.FeatureMask);
+}
+
+void Renderer::PrecompilePBRPermutations()
+{
+    std::vector<uint32> Permutations;
+    for (CStaticMesh* StaticMesh : StaticMeshes)
+    {
+        const uint32 NumSections = (uint32)StaticMesh->GetRenderAssetData().RenderAssetSections.size();
+        for (uint32 SectionIndex = 0; SectionIndex < NumSections; ++SectionIndex)
         {
-            // Create a generic vertex shader as it is mandatory to have a vertex shader 
-            FShaderConfig VSConfig = { };
-            VSConfig.Flags |= FShaderFlags::GLSL;
-            VSConfig.EntryPoint = "main";
-            VSConfig.SourceCode = MakePathToResource("EdgeDetection/outline.vert", 's');
-            VSConfig.SourceType = EShaderSourceType::Filepath;
-            VSConfig.Type = EShaderType::Vertex;
-
-            // Add a vertex bindings
-            VSConfig.VertexBindings.resize(4);
-
-            // Add a vertex attribute to the vertex binding 
-            FVertexInputAttribute Attribute = { };
-
-            // Position
-            VSConfig.VertexBindings[0].BindingNum = 0;
-            VSConfig.VertexBindings[0].Stride = 12;
-            VSConfig.VertexBindings[0].InputRate = EInputRate::Vertex;
-            Attribute.Location = 0;
-            Attribute.BindingNum = 0;
-            Attribute.Offset = 0;
-            Attribute.Format = EPixelFormat::RGB32Float;
-            VSConfig.VertexBindings[0].AddVertexAttribute(Attribute);
-
-            // Tangent 
-            VSConfig.VertexBindings[1].BindingNum = 1;
-            VSConfig.VertexBindings[1].Stride = 16;
-            VSConfig.VertexBindings[1].InputRate = EInputRate::Vertex;
-            Attribute.Location = 1;
-            Attribute.BindingNum = 1;
-            Attribute.Format = EPixelFormat::RGBA32Float;
-            VSConfig.VertexBindings[1].AddVertexAttribute(Attribute);
-
-            // Normal
-            VSConfig.VertexBindings[2].BindingNum = 2;
-            VSConfig.VertexBindings[2].Stride = 12;
-            VSConfig.VertexBindings[2].InputRate = EInputRate::Vertex;
-            Attribute.Location = 2;
-            Attribute.BindingNum = 2;
-            Attribute.Format = EPixelFormat::RGB32Float;
-            VSConfig.VertexBindings[2].AddVertexAttribute(Attribute);
-
-            // Texcoord
-            VSConfig.VertexBindings[3].BindingNum = 3;
-            VSConfig.VertexBindings[3].Stride = 8;
-            VSConfig.VertexBindings[3].InputRate = EInputRate::Vertex;
-            Attribute.Location = 3;
-            Attribute.BindingNum = 3;
-            Attribute.Format = EPixelFormat::RG32Float;
-            VSConfig.VertexBindings[3].AddVertexAttribute(Attribute);
-
-            PBRVertexShaderOutline = LoadShader(VSConfig);
-
-            // Create a fragment shaders as well
+            // Textures are still streaming in at this point, every material is counted even if it cannot be drawn yet
+            const uint32 Permutation = PBRPermutationDomain.GetPermutation(StaticMesh->GetMaterial(SectionIndex).Flags);
+            if (PBRPermutations.find(Permutation) == PBRPermutations.end() && std::find(Permutations.begin(), Permutations.end(), Permutation) == Permutations.end())
             {
-                FShaderConfig FragmentSConfig = { };
-                FragmentSConfig.Flags |= FShaderFlags::GLSL;
-                FragmentSConfig.EntryPoint = "main";
-                FragmentSConfig.SourceCode = MakePathToResource("EdgeDetection/outline.frag", 's');
-                FragmentSConfig.SourceType = EShaderSourceType::Filepath;
-                FragmentSConfig.Type = EShaderType::Fragment;
-
-                PBRTextureFragmentShaderOutline = LoadShader(FragmentSConfig);
+                Permutations.push_back(Permutation);
             }
         }
+    }
 
-        {
-            GPConfig.RenderPassPtr = RenderPass;
-            GPConfig.PipelineLayoutPtr = PBRTexturePipelineLayout;
-            GPConfig.FragmentShader = PBRTextureFragmentShader;
-            GPConfig.VertexShader = PBRVertexShader;
-            GPConfig.PrimitiveTopology = EPrimitiveTopology::TriangleList;
+    if (Permutations.size() == 0)
+    {
+        return;
+    }
 
-            // Rasterization
-            GPConfig.RasterizerState.bRasterizerDiscardEnabled = false;
-            GPConfig.RasterizerState.PolygonMode = EPolygonMode::Fill;
-            GPConfig.RasterizerState.LineWidth = 1.0f;
-            GPConfig.RasterizerState.CullMode = ECullMode::None;
-            GPConfig.RasterizerState.FrontFace = EFrontFace::CounterClockwise;
-            GPConfig.RasterizerState.bDepthClampEnabled = false;
-            GPConfig.RasterizerState.bDepthBiasEnabled = false;
-            GPConfig.RasterizerState.DepthBias.Clamp = 0.0f;
-            GPConfig.RasterizerState.DepthBias.ConstantFactor = 0.0f;
-            GPConfig.RasterizerState.DepthBias.SlopeFactor = 0.0f;
+    std::vector<FShaderConfig> ShaderConfigs(Permutations.size() * 2);
+    for (uint32 i = 0; i < Permutations.size(); ++i)
+    {
+        MakePBRShaderConfigs(PBRPermutationDomain, Permutations[i], ShaderConfigs[i * 2], ShaderConfigs[i * 2 + 1]);
+    }
 
-            // Color blend state
-            GPConfig.BlendState.LogicOp = ELogicOp::Disabled;
+    typedef std::chrono::high_resolution_clock Clock;
+    auto Start = Clock::now();
 
-            FBlendOpConfig BOConfig = { };
-            BOConfig.ColorWriteMask = 0xF;
-            BOConfig.bIsBlendEnabled = true;
-            BOConfig.SrcColorBlendFactor = EBlendFactor::SrcAlpha;
-            BOConfig.DstColorBlendFactor = EBlendFactor::OneMinusSrcAlpha;
-            BOConfig.ColorBlendOp = EBlendOp::Add;
-            BOConfig.SrcAlphaBlendFactor = EBlendFactor::OneMinusSrcAlpha;
-            BOConfig.DstAlphaBlendFactor = EBlendFactor::Zero;
-            BOConfig.AlphaBlendOp = EBlendOp::Add;
+    // Fills the spirv cache, the loads below are then cache hits
+    RenderInterface.Get()->PrecompileShaders(ShaderConfigs.data(), (uint32)ShaderConfigs.size(), &VGameEngine::Get()->GetTaskScheduler());
 
-            GPConfig.BlendState.BlendOpConfigs.push_back(BOConfig);
+    for (uint32 Permutation : Permutations)
+    {
+        GetPBRPermutation(Permutation);
+    }
 
-            // Depth stencil state
-            GPConfig.DepthState.bIsTestingEnabled = true;
-            GPConfig.DepthState.bIsWritingEnabled = true;
-            GPConfig.DepthState.CompareOp = ECompareOp::Less;
+    float PrecompileTime = std::chrono::duration<float, std::milli>(Clock::now() - Start).count();
+    VE_CORE_LOG_INFO(VE_TEXT("[Renderer]: Compiled {0} of {1} pbr permutations in {2} ms, their pipelines finish in the background"), PBRPermutations.size(), PBRPermutationDomain.GetNumPermutations(), PrecompileTime);
+}
 
-            PBRTexturePipeline = RenderInterface.Get()->CreatePipelineWithCache(GPConfig, MakePathToResource("PBRPipelineCache", 'p'));
+const FPBRPermutation& Renderer::GetPBRPermutation(uint32 inMaterialFlags, bool inCompileAsync)
+{
+    const uint32 Permutation = PBRPermutationDomain.GetPermutation(inMaterialFlags);
 
-            // Depth stencil state
-            //GPConfig.DepthState.bIsTestingEnabled = true;
-            //GPConfig.DepthState.bIsWritingEnabled = true;
-            GPConfig.DepthState.CompareOp = ECompareOp::LessOrEqual;
-
-            GPConfig.StencilState.bIsTestingEnabled = true;
-            GPConfig.StencilState.Back.CompareOp = ECompareOp::Always;
-            GPConfig.StencilState.Back.StencilFailOp = EStencilOp::Replace;
-            GPConfig.StencilState.Back.DepthFailOp = EStencilOp::Replace;
-            GPConfig.StencilState.Back.StencilPassOp = EStencilOp::Replace;
-            GPConfig.StencilState.Back.CompareMask = 0xFF;
-            GPConfig.StencilState.Back.WriteMask = 0xFF;
-            GPConfig.StencilState.Back.ReferenceValue = 1;
-            GPConfig.StencilState.Front = GPConfig.StencilState.Back;
-
-            PBRTexturePipelineStencil = RenderInterface.Get()->CreatePipelineWithCache(GPConfig, MakePathToResource("PBRStencilPipelineCache", 'p'));
-
-            // Outline Pipeline Pass
-            GPConfig.StencilState.Back.CompareOp = ECompareOp::NotEqual;
-            GPConfig.StencilState.Back.StencilFailOp = EStencilOp::Keep;
-            GPConfig.StencilState.Back.DepthFailOp = EStencilOp::Keep;
-            GPConfig.StencilState.Back.StencilPassOp = EStencilOp::Replace;
-            GPConfig.StencilState.Front = GPConfig.StencilState.Back;
-            GPConfig.DepthState.bIsTestingEnabled = false;
-
-            GPConfig.FragmentShader = PBRTextureFragmentShaderOutline;
-            GPConfig.VertexShader = PBRVertexShaderOutline;
-
-            PBRTexturePipelineOutline = RenderInterface.Get()->CreatePipelineWithCache(GPConfig, MakePathToResource("PBROutlinePipelineCache", 'p'));
-        }
+    FPBRPermutation& Result = PBRPermutations[Permutation];
+    if (Result.Pipeline != nullptr)
+    {
+        return Result;
+    }
+
+    if (Result.VertexShader == nullptr)
+    {
+        FShaderConfig VSConfig;
+        FShaderConfig FragmentSConfig;
+        MakePBRShaderConfigs(PBRPermutationDomain, Permutation, VSConfig, FragmentSConfig);
+
+        Result.VertexShader = LoadShader(VSConfig);
+        Result.FragmentShader = LoadShader(FragmentSConfig);
     }
+
+    FGraphicsPipelineConfig GPConfig;
+    GPConfig.RenderPassPtr = RenderPass;
+    GPConfig.PipelineLayoutPtr = PBRTexturePipelineLayout;
+    GPConfig.VertexShader = Result.VertexShader;
+    GPConfig.FragmentShader = Result.FragmentShader;
+    MakePBRPipelineState(GPConfig);
+
+    enki::TaskScheduler* TaskScheduler = inCompileAsync ? &VGameEngine::Get()->GetTaskScheduler() : nullptr;
+    Result.Pipeline = RenderInterface.Get()->CreatePipelineAsync(GPConfig, TaskScheduler);
+
+    MakePBRStencilState(GPConfig);
+    Result.StencilPipeline = RenderInterface.Get()->CreatePipelineAsync(GPConfig, TaskScheduler);
+
+    return Result;
 }
 
 void Renderer::CreateSkyboxPipeline()
@@ -1236,7 +1597,12 @@ void Renderer::CreateSkyboxPipeline()
     GetFileAttributes(WCubemapPath.c_str()); // from winbase.h
     if (INVALID_FILE_ATTRIBUTES == GetFileAttributes(WCubemapPath.c_str()) && GetLastError() == ERROR_FILE_NOT_FOUND)
     {
-        CreateCubemapFromHighDynamicImage("NewportLoftCubemap", 512);
+        const uint64 CubemapKey = MakeImageBasedLightingKey("Cubemap", 512, HDRPath);
+        if (!FetchDerivedTexture(CubemapKey, CubemapPath))
+        {
+            CreateCubemapFromHighDynamicImage("NewportLoftCubemap", 512);
+            StoreDerivedTexture(CubemapKey, CubemapPath);
+        }
     }
 
     SkyboxAsset = new CSkybox(RenderPass, CubeVertexBuffer, LocalConstantsBuffer, MakePathToResource("NewportLoftCubemap.ktx", 't'));
@@ -1637,16 +2003,36 @@ void Renderer::CreateSkyboxPipeline()
     GetFileAttributes(WPath.c_str()); // from winbase.h
     if (INVALID_FILE_ATTRIBUTES == GetFileAttributes(WPath.c_str()) && GetLastError() == ERROR_FILE_NOT_FOUND)
     {
-        CreateBrdfIntegration("NewportLoft", 512); // Create BRDF Lut
+        const uint64 BRDFIntegrationKey = MakeImageBasedLightingKey("BRDFIntegration", 512, std::string());
+        if (!FetchDerivedTexture(BRDFIntegrationKey, Path))
+        {
+            CreateBrdfIntegration("NewportLoft", 512); // Create BRDF Lut
+            StoreDerivedTexture(BRDFIntegrationKey, Path);
+        }
     }
 
+    FIBLBakeConfig IBLBakeConfig = { };
+    IBLBakeConfig.IrradianceSize = 32;
+    IBLBakeConfig.PrefilterSize = 512;
+    IBLBakeConfig.SupercompressionLevel = KTX_ZSTD_COMPRESSION_LEVEL;
+    IBLBakeConfig.TaskScheduler = &VGameEngine::Get()->GetTaskScheduler();
+
     Path = MakePathToResource("NewportLoftPrefilteredEnvMap.ktx", 't');
     WPath = std::wstring(Path.begin(), Path.end());
 
     GetFileAttributes(WPath.c_str()); // from winbase.h
     if (INVALID_FILE_ATTRIBUTES == GetFileAttributes(WPath.c_str()) && GetLastError() == ERROR_FILE_NOT_FOUND)
     {
-        CreatePrefilterEnvMap("NewportLoft", 512); // Create Prefiltered env map
+        const uint64 PrefilteredEnvMapKey = MakeImageBasedLightingKey("PrefilteredEnvMap", IBLBakeConfig.PrefilterSize, HDRPath, &IBLBakeConfig);
+        if (!FetchDerivedTexture(PrefilteredEnvMapKey, Path))
+        {
+            // Baked on the cpu from the cubemap, the gpu bake is the fallback if the cubemap cannot be read
+            if (!FIBLBaker::BakePrefilteredMapFile(CubemapPath, Path, IBLBakeConfig))
+            {
+                CreatePrefilterEnvMap("NewportLoft", 512); // Create Prefiltered env map
+            }
+            StoreDerivedTexture(PrefilteredEnvMapKey, Path);
+        }
     }
 
     Path = MakePathToResource("NewportLoftIrradianceMap.ktx", 't');
@@ -1655,7 +2041,15 @@ void Renderer::CreateSkyboxPipeline()
     GetFileAttributes(WPath.c_str()); // from winbase.h
     if (INVALID_FILE_ATTRIBUTES == GetFileAttributes(WPath.c_str()) && GetLastError() == ERROR_FILE_NOT_FOUND)
     {
-        CreateIrradianceMap("NewportLoft", 32); // Create Irradiance Map 
+        const uint64 IrradianceMapKey = MakeImageBasedLightingKey("IrradianceMap", IBLBakeConfig.IrradianceSize, HDRPath, &IBLBakeConfig);
+        if (!FetchDerivedTexture(IrradianceMapKey, Path))
+        {
+            if (!FIBLBaker::BakeIrradianceMapFile(CubemapPath, Path, IBLBakeConfig))
+            {
+                CreateIrradianceMap("NewportLoft", 32); // Create Irradiance Map 
+            }
+            StoreDerivedTexture(IrradianceMapKey, Path);
+        }
     }
 
     {
@@ -1697,6 +2091,7 @@ void Renderer::CreateSkyboxPipeline()
         //}
     }
 
+    // Loaded synchronously, every lit material samples these from its first frame and a streamed map would leave the bindless slots unwritten
     Buffer* BrdfLutBuffer = nullptr;
     BRDFLutTexture = CreateTexture2D(MakePathToResource("NewportLoft_BRDFIntegration.ktx", 't'), BrdfLutBuffer, EPixelFormat::RG16UNorm);
 
@@ -1727,10 +2122,36 @@ void Renderer::LoadModels()
                 FWorld World = FGLTFLoader::LoadFromFile(BusterDroneModelPath.data());
 
                 TextureHandle* TextureHandles = new TextureHandle[World.Images.size()];
-                uint32 TexHandleStart = TexturesArray.size();
 
                 // Parsing the World Data 
                 {
+                    // Color textures are stored in sRGB and averaged in linear space when generating mips, 
+                    // masked base colors keep their alpha test coverage across the mips 
+                    std::vector<FMipGenerationConfig> ImageMipConfigs(World.Images.size());
+                    for (uint32 i = 0; i < World.Materials.size(); ++i)
+                    {
+                        const FMaterial& Material = World.Materials[i];
+
+                        const int32 BaseColorIndex = Material.PBRMetallicRoughnessInfo.BaseColorTexture.Index;
+                        if (BaseColorIndex != -1 && World.Textures[BaseColorIndex].ImageIndex != -1)
+                        {
+                            FMipGenerationConfig& MipConfig = ImageMipConfigs[World.Textures[BaseColorIndex].ImageIndex];
+                            MipConfig.bIsSRGB = true;
+
+                            if (Material.AlphaMode == FMaterial::EAlphaMode::Mask)
+                            {
+                                MipConfig.bPreserveAlphaCoverage = true;
+                                MipConfig.AlphaCutoff = Material.AlphaCutoff;
+                            }
+                        }
+
+                        const int32 EmissiveIndex = Material.EmissiveTexture.Index;
+                        if (EmissiveIndex != -1 && World.Textures[EmissiveIndex].ImageIndex != -1)
+                        {
+                            ImageMipConfigs[World.Textures[EmissiveIndex].ImageIndex].bIsSRGB = true;
+                        }
+                    }
+
                     // Load All Textures
                     TextureBuffers.resize(World.Images.size());
 
@@ -1738,9 +2159,8 @@ void Renderer::LoadModels()
                     {
                         FImage Image = World.Images[i];
                         //TextureHandles[i] = CreateTexture2D(MakePathToResource("buster_drone/" + Image.Uri, 't').c_str(), TextureBuffers[i]);
-                        TexturesArray.push_back(nullptr);
-                        TextureHandles[i] = TexturesArray.size()-1;
-                        VGameEngine::Get()->GetAsyncLoader().RequestTextureData(MakePathToResource("buster_drone/" + Image.Uri, 't'), TextureHandles[i], EPixelFormat::RGBA8UNorm);
+                        TextureHandles[i] = AllocateTextureHandle(nullptr);
+                        VGameEngine::Get()->GetAsyncLoader().RequestTextureData(MakePathToResource("buster_drone/" + Image.Uri, 't'), TextureHandles[i], EPixelFormat::RGBA8UNorm, 0.0f, ImageMipConfigs[i]);
                         //TexturesToUpdate[NumTexturesToUpdate++] = TextureHandles[i];
                         Buffers.pop_back();
                     }
@@ -1756,6 +2176,7 @@ void Renderer::LoadModels()
                     {
                         Config.MagFilter = World.Samplers[i].MagFilter == GLTF::FSampler::EFilter::Linear ? ESamplerFilter::Linear : ESamplerFilter::Nearest;
                         Config.MinFilter = World.Samplers[i].MinFilter == GLTF::FSampler::EFilter::Linear ? ESamplerFilter::Linear : ESamplerFilter::Nearest;
+                        Config.MaxLod = MAX_TEXTURE_MIP_LEVELS;
 
                         Samplers[i] = RenderInterface.Get()->CreateSampler(Config);
                     }
@@ -1928,6 +2349,14 @@ void Renderer::LoadModels()
 
                         bool bIsStaticMeshBlendable = false;
 
+                        // Read from the cpu copy of the buffers: the bounds the mesh is occlusion tested with and,
+                        // if the mesh is opaque and low poly enough, the triangles it hides other meshes with
+                        Vector3D LocalBoundsMin(FLT_MAX);
+                        Vector3D LocalBoundsMax(-FLT_MAX);
+                        std::vector<Vector3D> OccluderPositions;
+                        std::vector<uint32> OccluderIndices;
+                        bool bIsOccluder = true;
+
                         for (uint32 i = 0; i < Mesh.Primitives.size(); ++i)
                         {
                             FRenderAssetSection Section = { };
@@ -2305,6 +2734,38 @@ void Renderer::LoadModels()
                                 bIsStaticMeshBlendable = true;
                             }
 
+                            {
+                                FAccessor& PositionAccessor = World.Accessors[PositionAccessorIndex];
+                                FBufferView& PositionBufferView = World.BufferViews[PositionAccessor.BufferView];
+
+                                const uint8* PositionData = GetBufferData(World.BufferViews.data(), PositionAccessor.BufferView, BufferDatas) + PositionAccessor.ByteOffset;
+                                const uint64 PositionStride = PositionBufferView.ByteStride != 0 ? PositionBufferView.ByteStride : sizeof(Vector3D);
+
+                                for (uint32 Vertex = 0; Vertex < vertex_count; ++Vertex)
+                                {
+                                    const Vector3D& Position = *(const Vector3D*)(PositionData + Vertex * PositionStride);
+                                    LocalBoundsMin = Vector3D(MathUtils::Min(LocalBoundsMin.X, Position.X), MathUtils::Min(LocalBoundsMin.Y, Position.Y), MathUtils::Min(LocalBoundsMin.Z, Position.Z));
+                                    LocalBoundsMax = Vector3D(MathUtils::Max(LocalBoundsMax.X, Position.X), MathUtils::Max(LocalBoundsMax.Y, Position.Y), MathUtils::Max(LocalBoundsMax.Z, Position.Z));
+                                }
+
+                                // Alpha tested surfaces have holes, they cannot hide anything
+                                bIsOccluder &= material.AlphaMode == GLTF::FMaterial::EAlphaMode::Opaque && OccluderIndices.size() + Section.Count <= MAX_OCCLUDER_TRIANGLES * 3;
+                                if (bIsOccluder)
+                                {
+                                    const uint32 FirstVertex = (uint32)OccluderPositions.size();
+                                    for (uint32 Vertex = 0; Vertex < vertex_count; ++Vertex)
+                                    {
+                                        OccluderPositions.push_back(*(const Vector3D*)(PositionData + Vertex * PositionStride));
+                                    }
+
+                                    const uint8* IndexData = index_data_8 + IndicesAccessor.ByteOffset;
+                                    for (uint32 Index = 0; Index < Section.Count; ++Index)
+                                    {
+                                        OccluderIndices.push_back(FirstVertex + ReadIndex(IndexData, IndicesAccessor.ComponentType, Index));
+                                    }
+                                }
+                            }
+
                             // Link to Irridiance cube map
                             LinkInfo.ArrayElementStart = IrridianceTexture;
                             LinkInfo.TextureSampler = SamplerHandle;
@@ -2369,6 +2830,12 @@ void Renderer::LoadModels()
 
                         StaticMesh->SetName(Mesh.Name);
                         StaticMesh->SetIsTransparent(bIsStaticMeshBlendable);
+                        StaticMesh->SetLocalBounds(LocalBoundsMin, LocalBoundsMax);
+
+                        if (bIsOccluder && !bIsStaticMeshBlendable)
+                        {
+                            StaticMesh->SetOccluder(OccluderPositions, OccluderIndices);
+                        }
                         StaticMeshes.push_back(StaticMesh);
                     }
                 }
@@ -2377,6 +2844,8 @@ void Renderer::LoadModels()
     }
 
     CreateSphereModels();
+
+    PrecompilePBRPermutations();
 }
 
 void Renderer::CreateSphereMeshData(float inRadius, uint32 inNumStacks, uint32 inNumSectors, std::vector<float>& outVerts, std::vector<float>& outNormals, std::vector<uint32>& outIndices, std::vector<float>& outTexCoords)
@@ -2972,6 +3441,7 @@ void Renderer::CreateCubemap(const char* inCubeMapName, const IPipeline* inPipel
         FilePath += inCubeMapName;
         FilePath += ".ktx";
 
+        ktxTexture2_DeflateZstd(KtxTextureHandle, KTX_ZSTD_COMPRESSION_LEVEL);
         ktxTexture_WriteToNamedFile(ktxTexture(KtxTextureHandle), FilePath.c_str());
         ktxTexture_Destroy(ktxTexture(KtxTextureHandle));
 
@@ -3179,6 +3649,7 @@ void Renderer::CreateIrradianceMap(const char* inCubeMapName, float inViewportSi
         FilePath += inCubeMapName;
         FilePath += "IrradianceMap.ktx";
 
+        ktxTexture2_DeflateZstd(KtxTextureHandle, KTX_ZSTD_COMPRESSION_LEVEL);
         ktxTexture_WriteToNamedFile(ktxTexture(KtxTextureHandle), FilePath.c_str());
         ktxTexture_Destroy(ktxTexture(KtxTextureHandle));
 
@@ -3402,6 +3873,7 @@ void Renderer::CreateCubemapFromHighDynamicImage(const char* inCubeMapName, floa
         FilePath += inCubeMapName;
         FilePath += ".ktx";
 
+        ktxTexture2_DeflateZstd(KtxTextureHandle, KTX_ZSTD_COMPRESSION_LEVEL);
         ktxTexture_WriteToNamedFile(ktxTexture(KtxTextureHandle), FilePath.c_str());
         ktxTexture_Destroy(ktxTexture(KtxTextureHandle));
 
@@ -3653,6 +4125,7 @@ void Renderer::CreatePrefilterEnvMap(const char* inCubeMapName, float inViewport
             }
         }
 
+        ktxTexture2_DeflateZstd(KtxTextureHandle, KTX_ZSTD_COMPRESSION_LEVEL);
         ktxTexture_WriteToNamedFile(ktxTexture(KtxTextureHandle), FilePath.c_str());
         ktxTexture_Destroy(ktxTexture(KtxTextureHandle));
 
@@ -3884,6 +4357,7 @@ void Renderer::CreateBrdfIntegration(const char* inCubeMapName, float inViewport
             ktxTexture_SetImageFromMemory(ktxTexture(KtxTextureHandle), mipLevel, 0, 0, (const uint8*)TextureReadInfo.Data, TextureReadInfo.SizeInByte);
         }
 
+        ktxTexture2_DeflateZstd(KtxTextureHandle, KTX_ZSTD_COMPRESSION_LEVEL);
         ktxTexture_WriteToNamedFile(ktxTexture(KtxTextureHandle), FilePath.c_str());
         ktxTexture_Destroy(ktxTexture(KtxTextureHandle));
 
@@ -3903,37 +4377,78 @@ PipelineLayout* Renderer::CreatePipelineLayoutFromShaders(Shader* inVertexShader
     return RenderInterface.Get()->CreatePipelineLayoutFromShaders((const Shader**)Shaders, 2);
 }
 
-void Renderer::AddTextureToUpdate(const TextureHandle& inTextureHandle)
+bool Renderer::AddTextureToUpdate(const TextureHandle& inTextureHandle)
 {
-    std::lock_guard<std::mutex> LockGaurd(TextureUpdateMutex);
-
-    TexturesToUpdate[NumTexturesToUpdate++] = inTextureHandle;
+    return TexturesToUpdate.Push(inTextureHandle);
 }
 
-void Renderer::AddTextureUpdateCommands(uint32 inThreadIndex)
+void Renderer::AddTextureUpdateCommands(ICommandBuffer* inCommandBuffer)
 {
-    std::lock_guard<std::mutex> LockGaurd(TextureUpdateMutex);
+    TextureHandlesToLink.clear();
+    TexturesToAcquire.clear();
+
+    TextureHandle Handle;
+    while (TexturesToUpdate.Pop(Handle))
+    {
+        TextureHandlesToLink.push_back(Handle);
+        TexturesToAcquire.push_back(GetTextureResource(Handle));
+    }
 
-    if (NumTexturesToUpdate == 0)
+    if (TextureHandlesToLink.empty())
     {
         return;
     }
 
+    inCommandBuffer->AcquireUploadedTextures(TexturesToAcquire.data(), (uint32)TexturesToAcquire.size(), ETextureLayout::ShaderReadOnlyOptimal);
+
     FDescriptorSetsLinkInfo LinkInfo = { };
 
     LinkInfo.DescriptorCount = 1;
     LinkInfo.BindingStart = BINDLESS_TEXTURE_BINDING;
     LinkInfo.TextureSampler = SamplerHandle;
 
-    for (uint32 i = 0; i < NumTexturesToUpdate; ++i)
+    // Only queued, every link is written at once the next time the bindless set is bound
+    for (uint32 i = 0; i < TextureHandlesToLink.size(); ++i)
     {
-        LinkInfo.ArrayElementStart = TexturesToUpdate[i];
-        LinkInfo.ResourceHandle.TextureHandle = GetTextureResource(TexturesToUpdate[i]);
-        RenderInterface.Get()->SetTextureLayout(LinkInfo.ResourceHandle.TextureHandle, ETextureLayout::ShaderReadOnlyOptimal);
+        LinkInfo.ArrayElementStart = TextureHandlesToLink[i];
+        LinkInfo.ResourceHandle.TextureHandle = GetTextureResource(TextureHandlesToLink[i]);
         BindlessDescriptorSet->LinkToTexture(0, LinkInfo);
     }
+}
+
+TextureHandle Renderer::AllocateTextureHandle(TextureResource* inTexture)
+{
+    if (!FreeTextureHandles.empty())
+    {
+        TextureHandle Handle = FreeTextureHandles.back();
+        FreeTextureHandles.pop_back();
+
+        TexturesArray[Handle] = inTexture;
+        return Handle;
+    }
+
+    VE_ASSERT(TexturesArray.size() < MAX_BINDLESS_TEXTURES, VE_TEXT("[Renderer]: Ran out of bindless texture slots, max is {0}"), MAX_BINDLESS_TEXTURES);
+
+    TexturesArray.push_back(inTexture);
+    return (TextureHandle)TexturesArray.size() - 1;
+}
+
+void Renderer::FreeTexture(TextureHandle inTextureHandle)
+{
+    VE_ASSERT(inTextureHandle < TexturesArray.size(), VE_TEXT("[Renderer]: Invalid texture handle {0}"), inTextureHandle);
+
+    // Loading the same path again has to create a new texture
+    for (auto It = TextureMap.Begin(); It != TextureMap.End(); ++It)
+    {
+        if (It->second == inTextureHandle)
+        {
+            const std::string TextureName = It->first;
+            TextureMap.Remove(TextureName);
+            break;
+        }
+    }
 
-    NumTexturesToUpdate = 0;
+    RetiredTextureHandles.push_back(inTextureHandle);
 }
 
 void Renderer::BeginFrame()
@@ -3947,18 +4462,25 @@ void Renderer::BeginFrame()
 
     // Get the new image index
     SwapChainMain->AcquireNextImageIndex(PresentationCompleteSemaphore, &CurrentImageIndex);
+
+    // The wait above covers every earlier submission, the per frame resources of the new image index are free to reuse
+    RenderInterface.Get()->BeginFrame(CurrentImageIndex);
+
+    // Same for the textures freed before this frame, their bindless slots can be handed out again
+    // (the slots stay linked to the old textures until reused, nothing samples them anymore)
+    for (TextureHandle Handle : RetiredTextureHandles)
+    {
+        RenderInterface.Get()->Free(TexturesArray[Handle]);
+        TexturesArray[Handle] = nullptr;
+        FreeTextureHandles.push_back(Handle);
+    }
+    RetiredTextureHandles.clear();
 }
 
 void Renderer::Present()
 {
     ICommandBuffer* CurrentCommandBuffer = CommandBufferManager::Get().GetCommandBuffer(CurrentImageIndex, 0); //CommandBuffers[CurrentImageIndex];
 
-    // ------------------------------------------ 
-    // This function does not do what it is supposed to, this is just temporary fucntionality
-    // added for testing multithreading and creation of asynchronous textures 
-    // ------------------------------------------ 
-    AddTextureUpdateCommands(0);
-
     // Reset our current command buffer wait fence 
     // so that when it is used next it will already be resetted 
     RenderInterface.Get()->GetCommandQueue()->ResetWaitFence(CurrentCommandBuffer->GetWaitFence());
@@ -4069,6 +4591,9 @@ void Renderer::DrawEditorTools()
             ImGui::Text("Frame Rate: %u", VGameEngine::Get()->GetFrameRate());
             ImGui::Text("Render Time: %.0001f ms", VGameEngine::Get()->GetRenderTime());
             ImGui::Text("Tick Time: %.0001f ms", VGameEngine::Get()->GetTickTime());
+            ImGui::Text("Occluded Meshes: %u (%.3f ms)", NumOccludedMeshes, MeshOcclusionCuller.GetStats().RasterizeTimeMs);
+            ImGui::Text("Clustered Lights: %u, %u indices (%.3f ms)", SceneLightClusterer.GetStats().NumLights, SceneLightClusterer.GetStats().NumLightIndices,
+                SceneLightClusterer.GetStats().AssignTimeMs);
         }
         ImGui::End();
     }
@@ -4082,6 +4607,9 @@ void Renderer::DrawEditorTools()
             ImGui::EndMenu();
         }
 
+        ImGui::Checkbox("Occlusion Culling", &bEnableOcclusionCulling);
+        ImGui::Checkbox("Light Clustering", &bEnableLightClustering);
+
         {
             //if (ImGui::Button("Select Cubemap", ImVec2(128, 128)))
             //{
@@ -4729,8 +5257,11 @@ void Renderer::CreateVulkanRenderInterface(bool inEnableRenderDoc)
         SamplerConfig.AddressModeV = ESamplerAddressMode::ClampToEdge;
         SamplerConfig.AddressModeW = ESamplerAddressMode::ClampToEdge;
 
+        // Bindless textures are streamed in with their full mip chain
+        SamplerConfig.MaxLod = MAX_TEXTURE_MIP_LEVELS;
         SamplerHandle = RenderInterface.Get()->CreateSampler(SamplerConfig);
 
+        SamplerConfig.MaxLod = 1;
         BRDFSamplerHandle = RenderInterface.Get()->CreateSampler(SamplerConfig);
 
         SamplerConfig.MinLod = 0;
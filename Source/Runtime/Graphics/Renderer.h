@@ -13,10 +13,15 @@
 
 #include "ICommandBufferManager.h"
 #include "FrameGraph/FrameGraph.h"
+#include "ShaderPermutation.h"
+#include "Culling/OcclusionCuller.h"
+#include "Culling/LightClusterer.h"
 
 #include <Containers/Map.h>
+#include <Containers/MPSCQueue.h>
 
 #include <mutex>
+#include <unordered_map>
 
 static const uint32 UINT32InvalidIndex = 0xffffffff;
 typedef uint32 TextureHandle;
@@ -75,6 +80,33 @@ enum MaterialFeatures {
     MaterialFeatures_TexcoordVertexAttribute = 1 << 6,
 };
 
+/**
+* The pbr shaders compiled for one set of material features
+*/
+struct FPBRPermutation
+{
+public:
+    Shader* VertexShader;
+    Shader* FragmentShader;
+
+    IPipeline* Pipeline;
+
+    /** Same as Pipeline but also writes the stencil buffer, used to outline the selected mesh */
+    IPipeline* StencilPipeline;
+};
+
+/**
+* Which pipeline of a material RenderStaticMesh() draws with
+*/
+enum class EPBRPipelineType
+{
+    Default,
+    Stencil,
+
+    /** Every material uses the same outline pipeline, it only reads positions and normals */
+    Outline
+};
+
 class CStaticMesh;
 
 struct FDepthPrePass : public FFrameGraphRenderPass
@@ -138,7 +170,10 @@ public:
     }
 
 public:
-    void RenderStaticMesh(ICommandBuffer* CurrentCommandBuffer, CStaticMesh* inStaticMesh);
+    /**
+    * Draws every section of a mesh with the pipeline of its material permutation, only the vertex streams the mesh has are bound
+    */
+    void RenderStaticMesh(ICommandBuffer* CurrentCommandBuffer, CStaticMesh* inStaticMesh, EPBRPipelineType inPipelineType = EPBRPipelineType::Default);
     void Render();
 
     /**
@@ -173,8 +208,24 @@ public:
     bool OnKeyReleased(KeyReleasedEvent& inKeyReleasedEvent);
 
     /** Helper Functions */
+
+    /** Compiles the shaders from GetStartupShaderConfigs() across the worker threads, LoadShader() then only reads them from the derived data cache */
+    void PrecompileShaders();
+
     void CreatePBRPipeline();
 
+    /**
+    * Compiles the pbr variants used by the loaded materials across the worker threads, their pipelines then compile in the background
+    * Variants that show up later are created on demand by GetPBRPermutation()
+    */
+    void PrecompilePBRPermutations();
+
+    /**
+    * @param inCompileAsync if true the pipelines of a new variant are compiled on the worker threads, check IPipeline::IsReady() before using them
+    * @returns const FPBRPermutation& the smallest pbr variant supporting every feature of inMaterialFlags, created if needed
+    */
+    const FPBRPermutation& GetPBRPermutation(uint32 inMaterialFlags, bool inCompileAsync = true);
+
     void CreateSkyboxPipeline();
 
     void LoadModels();
@@ -202,9 +253,30 @@ public:
 
     PipelineLayout* CreatePipelineLayoutFromShaders(Shader* inVertexShader, Shader* inFragmentShader);
 
-    void AddTextureToUpdate(const TextureHandle& inTextureHandle);
+    /**
+    * Queues a texture whose upload completed to be linked to its bindless slot, can be called from any thread
+    *
+    * @returns bool false if the update queue is full, the texture should be added again later
+    */
+    bool AddTextureToUpdate(const TextureHandle& inTextureHandle);
 
-    void AddTextureUpdateCommands(uint32 inThreadIndex);
+    /**
+    * Records the barriers of every queued texture into the frame's command buffer and links them to the bindless set,
+    * the links are written together in one descriptor update when the set is bound
+    */
+    void AddTextureUpdateCommands(ICommandBuffer* inCommandBuffer);
+
+    /**
+    * Reserves a texture handle (bindless slot), handles of freed textures are reused first
+    *
+    * @param inTexture the texture stored at the handle, can be null for textures that are streamed in later
+    */
+    TextureHandle AllocateTextureHandle(TextureResource* inTexture);
+
+    /**
+    * Frees a texture and gives its handle back once the GPU is done with the frames that might still sample it
+    */
+    void FreeTexture(TextureHandle inTextureHandle);
 
     TextureResource*& GetTextureResource(const TextureHandle inHandle)
     {
@@ -213,6 +285,12 @@ public:
 
     static std::string MakePathToResource(const std::string& inResourceName, char inResourceType);
 
+    /**
+    * Collects the configs of the shaders the renderer loads at startup, only what the spirv cache key depends on is filled in
+    *   (source, type, flags and defines). Has to be kept in sync with the LoadShader() calls
+    */
+    static void GetStartupShaderConfigs(std::vector<FShaderConfig>& outShaderConfigs);
+
     inline SwapChain* GetSwapchain() const
     {
         return SwapChainMain;
@@ -227,6 +305,17 @@ private:
     void BeginFrame();
     void Present();
 
+    /**
+    * Rasterizes the occluders among the opaque meshes and removes the opaque meshes they hide, so they are not drawn this frame
+    */
+    void CullOccludedMeshes(const Matrix4D& inViewProjection);
+
+    /**
+    * Bins the point lights of the scene into the view space clusters.
+    *   The lists stay on the cpu until a shader reads them, the buffer holding them (one per frame in flight) is added with that shader
+    */
+    void AssignClusteredLights(const Matrix4D& inView);
+
     void DrawEditorTools();
 
     void CreateVulkanRenderInterface(bool inEnableRenderDoc);
@@ -292,15 +381,21 @@ private:
     std::vector<uint8*> BufferDatas;
 
     // Includes texture mapping: normals, tangent, ....
+    /** Shared by every pbr variant, created from the variant using every feature */
     PipelineLayout* PBRTexturePipelineLayout;
-    IPipeline* PBRTexturePipeline;
-    IPipeline* PBRTexturePipelineStencil;
     IPipeline* PBRTexturePipelineOutline;
-    Shader* PBRVertexShader;
-    Shader* PBRTextureFragmentShader;
     Shader* PBRVertexShaderOutline;
     Shader* PBRTextureFragmentShaderOutline;
 
+    /** Material feature bits the pbr shaders are compiled in variants of */
+    FShaderPermutationDomain PBRPermutationDomain;
+
+    /** Permutation -> pbr variant */
+    std::unordered_map<uint32, FPBRPermutation> PBRPermutations;
+
+    /** Last pipeline RenderStaticMesh() bound, reset whenever another pipeline gets bound in between */
+    const IPipeline* BoundPBRPipeline;
+
     Buffer* CubeVertexBuffer;
     Buffer* CubeVertexTexcoordBuffer;
     Buffer* CubeIndexBuffer;
@@ -395,16 +490,48 @@ private:
     int32 SelectedStaticMesh = -1;
     int32 SelectedMaterial = -1;
 
+    /** Opaque meshes hidden behind the low poly ones are skipped, see CullOccludedMeshes() */
+    OcclusionCuller MeshOcclusionCuller;
+    bool bEnableOcclusionCulling = true;
+    uint32 NumOccludedMeshes = 0;
+
+    /** Opaque meshes with at most this many triangles are kept on the cpu and rasterized as occluders */
+    static const uint32 MAX_OCCLUDER_TRIANGLES = 1024;
+
+    /** Point lights gathered every frame and binned into clusters, see AssignClusteredLights() */
+    LightClusterer SceneLightClusterer;
+    std::vector<FPointLight> PointLights;
+
+    /** Off until a shader reads the cluster lists, nothing uses them yet. The editor can still turn it on to profile the clustering */
+    bool bEnableLightClustering = false;
+
     // Bindless Texturing
     static const uint32 BINDLESS_TEXTURE_BINDING = 10;
     static const uint32 MAX_BINDLESS_TEXTURES = 1024;
     static const uint32 INVALID_TEXTURE_INDEX = -1;
 
+    /** Upper bound of the sampler lod range for mipmapped textures (16k x 16k) */
+    static const uint32 MAX_TEXTURE_MIP_LEVELS = 15;
+
+    /** Zstd level used to supercompress the ktx2 files we write (ex: generated IBL maps), higher is smaller but slower to write */
+    static const uint32 KTX_ZSTD_COMPRESSION_LEVEL = 18;
+
     IDescriptorSets* BindlessDescriptorSet;
 
-    TextureHandle TexturesToUpdate[128];
-    uint32 NumTexturesToUpdate;
-    std::mutex TextureUpdateMutex;
+    static const uint32 MAX_TEXTURES_TO_UPDATE = 256;
+
+    /** Textures finished by the loader threads, drained once per frame by the render thread */
+    TMPSCQueue<TextureHandle, MAX_TEXTURES_TO_UPDATE> TexturesToUpdate;
+
+    /** Kept around so draining the queue does not allocate every frame */
+    std::vector<TextureHandle> TextureHandlesToLink;
+    std::vector<const TextureResource*> TexturesToAcquire;
+
+    /** Handles of freed textures, reused before the textures array grows */
+    std::vector<TextureHandle> FreeTextureHandles;
+
+    /** Freed textures the GPU might still be using, released on the next BeginFrame */
+    std::vector<TextureHandle> RetiredTextureHandles;
 
     // Command Buffer ready to be updated
     std::vector<ICommandBuffer*> QueuedCommandBuffers;
@@ -584,6 +711,7 @@ public:
     {
         WorldTransform = Matrix4D::Identity();
         bIsTransparent = false;
+        bHasLocalBounds = false;
     }
 
     virtual ~CStaticMesh()
@@ -643,6 +771,55 @@ public:
         return Name;
     }
 
+    /**
+    * Bounds of the vertices before the model matrix of the materials is applied
+    */
+    void SetLocalBounds(const Vector3D& inMin, const Vector3D& inMax)
+    {
+        LocalBoundsMin = inMin;
+        LocalBoundsMax = inMax;
+        bHasLocalBounds = true;
+    }
+
+    bool HasLocalBounds() const
+    {
+        return bHasLocalBounds;
+    }
+
+    const Vector3D& GetLocalBoundsMin() const
+    {
+        return LocalBoundsMin;
+    }
+
+    const Vector3D& GetLocalBoundsMax() const
+    {
+        return LocalBoundsMax;
+    }
+
+    /**
+    * Keeps a cpu copy of the triangles of the mesh so it can hide other meshes (see OcclusionCuller), the vectors are moved from
+    */
+    void SetOccluder(std::vector<Vector3D>& inPositions, std::vector<uint32>& inIndices)
+    {
+        OccluderPositions.swap(inPositions);
+        OccluderIndices.swap(inIndices);
+    }
+
+    bool IsOccluder() const
+    {
+        return !OccluderIndices.empty();
+    }
+
+    const std::vector<Vector3D>& GetOccluderPositions() const
+    {
+        return OccluderPositions;
+    }
+
+    const std::vector<uint32>& GetOccluderIndices() const
+    {
+        return OccluderIndices;
+    }
+
 private:
     FRenderAssetData RenderAssetData;
     std::vector<FMaterialData> MaterialDatas;
@@ -652,6 +829,14 @@ private:
 
     bool bIsTransparent;
 
+    Vector3D LocalBoundsMin;
+    Vector3D LocalBoundsMax;
+    bool bHasLocalBounds;
+
+    /** Empty if the mesh is not an occluder */
+    std::vector<Vector3D> OccluderPositions;
+    std::vector<uint32> OccluderIndices;
+
     friend class Renderer;
 };
 
@@ -0,0 +1,501 @@
+/**
+* This file is part of the "Vrixic Engine" project (Copyright (c) 2022-2023 by Vrij Patel)
+* See "LICENSE.txt" for license information.
+*/
+
+#include "ShaderCompiler.h"
+#include <Misc/Assert.h>
+#include <Misc/Defines/StringDefines.h>
+#include <Runtime/File/DerivedDataCache.h>
+#include <Runtime/File/FileReader.h>
+
+#include <External/glslang/Include/glslang/SPIRV/GlslangToSpv.h>
+#include <External/glslang/Include/glslang/build_info.h>
+
+#include <algorithm>
+#include <string.h>
+
+/** Bump when the compile options change in a way the derived data key does not capture */
+static constexpr uint32 SPIRV_DERIVED_DATA_VERSION = 1;
+
+/**
+* Collapses "./" and "folder/../" out of a path and uses forward slashes, so the same file included
+* through different relative paths ends up with the same name in the dependency lists
+*/
+static std::string NormalizeShaderPath(const std::string& inPath)
+{
+    std::string Path = inPath;
+    std::replace(Path.begin(), Path.end(), '\\', '/');
+
+    std::vector<std::string> Parts;
+    uint64 PartStart = 0;
+    while (PartStart <= Path.size())
+    {
+        uint64 PartEnd = Path.find('/', PartStart);
+        if (PartEnd == std::string::npos)
+        {
+            PartEnd = Path.size();
+        }
+
+        std::string Part = Path.substr(PartStart, PartEnd - PartStart);
+        if (Part == ".." && Parts.size() > 0 && Parts.back() != "..")
+        {
+            Parts.pop_back();
+        }
+        else if (Part != "." && (Part.size() > 0 || Parts.size() == 0))
+        {
+            Parts.push_back(Part);
+        }
+
+        PartStart = PartEnd + 1;
+    }
+
+    std::string Result;
+    for (uint64 i = 0; i < Parts.size(); ++i)
+    {
+        Result += i > 0 ? "/" + Parts[i] : Parts[i];
+    }
+
+    return Result;
+}
+
+/**
+* Resolves #include "file" relative to the including file first and then the include directories,
+* #include <file> only searches the include directories. Every file it opens is recorded as a dependency
+*/
+class ShaderIncluder : public glslang::TShader::Includer
+{
+public:
+    ShaderIncluder(const std::vector<std::string>& inIncludeDirectories)
+        : IncludeDirectories(inIncludeDirectories) { }
+
+    virtual IncludeResult* includeLocal(const char* inHeaderName, const char* inIncluderName, size_t inInclusionDepth) override
+    {
+        const std::string IncluderPath = inIncluderName;
+        const uint64 LastSlashIndex = IncluderPath.find_last_of("/\\");
+        const std::string IncluderFolder = LastSlashIndex != std::string::npos ? IncluderPath.substr(0, LastSlashIndex + 1) : std::string();
+
+        IncludeResult* Result = TryInclude(IncluderFolder + inHeaderName);
+        return Result != nullptr ? Result : includeSystem(inHeaderName, inIncluderName, inInclusionDepth);
+    }
+
+    virtual IncludeResult* includeSystem(const char* inHeaderName, const char* inIncluderName, size_t inInclusionDepth) override
+    {
+        for (const std::string& IncludeDirectory : IncludeDirectories)
+        {
+            IncludeResult* Result = TryInclude(IncludeDirectory + inHeaderName);
+            if (Result != nullptr)
+            {
+                return Result;
+            }
+        }
+
+        return nullptr;
+    }
+
+    virtual void releaseInclude(IncludeResult* inResult) override
+    {
+        if (inResult != nullptr)
+        {
+            delete (std::string*)inResult->userData;
+            delete inResult;
+        }
+    }
+
+    /**
+    * @returns the normalized paths of every file included while preprocessing, each listed once
+    */
+    inline const std::vector<std::string>& GetDependencies() const
+    {
+        return Dependencies;
+    }
+
+private:
+    IncludeResult* TryInclude(const std::string& inPath)
+    {
+        const std::string Path = NormalizeShaderPath(inPath);
+
+        std::string* Source = new std::string();
+        if (!ShaderCompiler::LoadSourceFile(Path, *Source))
+        {
+            delete Source;
+            return nullptr;
+        }
+
+        if (std::find(Dependencies.begin(), Dependencies.end(), Path) == Dependencies.end())
+        {
+            Dependencies.push_back(Path);
+        }
+
+        return new IncludeResult(Path, Source->c_str(), Source->size(), Source);
+    }
+
+private:
+    const std::vector<std::string>& IncludeDirectories;
+
+    std::vector<std::string> Dependencies;
+};
+
+ShaderCompiler::ShaderCompiler()
+{
+    // Reference counted by glslang, compiling afterwards is safe from any thread
+    glslang::InitializeProcess();
+
+    {
+        BuiltInResources.maxLights = 32;
+        BuiltInResources.maxClipPlanes = 6;
+        BuiltInResources.maxTextureUnits = 32;
+        BuiltInResources.maxTextureCoords = 32;
+        BuiltInResources.maxVertexAttribs = 64;
+        BuiltInResources.maxVertexUniformComponents = 4096;
+        BuiltInResources.maxVaryingFloats = 64;
+        BuiltInResources.maxVertexTextureImageUnits = 32;
+        BuiltInResources.maxCombinedTextureImageUnits = 80;
+        BuiltInResources.maxTextureImageUnits = 32;
+        BuiltInResources.maxFragmentUniformComponents = 4096;
+        BuiltInResources.maxDrawBuffers = 32;
+        BuiltInResources.maxVertexUniformVectors = 128;
+        BuiltInResources.maxVaryingVectors = 8;
+        BuiltInResources.maxFragmentUniformVectors = 16;
+        BuiltInResources.maxVertexOutputVectors = 16;
+        BuiltInResources.maxFragmentInputVectors = 15;
+        BuiltInResources.minProgramTexelOffset = -8;
+        BuiltInResources.maxProgramTexelOffset = 7;
+        BuiltInResources.maxClipDistances = 8;
+        BuiltInResources.maxComputeWorkGroupCountX = 65535;
+        BuiltInResources.maxComputeWorkGroupCountY = 65535;
+        BuiltInResources.maxComputeWorkGroupCountZ = 65535;
+        BuiltInResources.maxComputeWorkGroupSizeX = 1024;
+        BuiltInResources.maxComputeWorkGroupSizeY = 1024;
+        BuiltInResources.maxComputeWorkGroupSizeZ = 64;
+        BuiltInResources.maxComputeUniformComponents = 1024;
+        BuiltInResources.maxComputeTextureImageUnits = 16;
+        BuiltInResources.maxComputeImageUniforms = 8;
+        BuiltInResources.maxComputeAtomicCounters = 8;
+        BuiltInResources.maxComputeAtomicCounterBuffers = 1;
+        BuiltInResources.maxVaryingComponents = 60;
+        BuiltInResources.maxVertexOutputComponents = 64;
+        BuiltInResources.maxGeometryInputComponents = 64;
+        BuiltInResources.maxGeometryOutputComponents = 128;
+        BuiltInResources.maxFragmentInputComponents = 128;
+        BuiltInResources.maxImageUnits = 8;
+        BuiltInResources.maxCombinedImageUnitsAndFragmentOutputs = 8;
+        BuiltInResources.maxCombinedShaderOutputResources = 8;
+        BuiltInResources.maxImageSamples = 0;
+        BuiltInResources.maxVertexImageUniforms = 0;
+        BuiltInResources.maxTessControlImageUniforms = 0;
+        BuiltInResources.maxTessEvaluationImageUniforms = 0;
+        BuiltInResources.maxGeometryImageUniforms = 0;
+        BuiltInResources.maxFragmentImageUniforms = 8;
+        BuiltInResources.maxCombinedImageUniforms = 8;
+        BuiltInResources.maxGeometryTextureImageUnits = 16;
+        BuiltInResources.maxGeometryOutputVertices = 256;
+        BuiltInResources.maxGeometryTotalOutputComponents = 1024;
+        BuiltInResources.maxGeometryUniformComponents = 1024;
+        BuiltInResources.maxGeometryVaryingComponents = 64;
+        BuiltInResources.maxTessControlInputComponents = 128;
+        BuiltInResources.maxTessControlOutputComponents = 128;
+        BuiltInResources.maxTessControlTextureImageUnits = 16;
+        BuiltInResources.maxTessControlUniformComponents = 1024;
+        BuiltInResources.maxTessControlTotalOutputComponents = 4096;
+        BuiltInResources.maxTessEvaluationInputComponents = 128;
+        BuiltInResources.maxTessEvaluationOutputComponents = 128;
+        BuiltInResources.maxTessEvaluationTextureImageUnits = 16;
+        BuiltInResources.maxTessEvaluationUniformComponents = 1024;
+        BuiltInResources.maxTessPatchComponents = 120;
+        BuiltInResources.maxPatchVertices = 32;
+        BuiltInResources.maxTessGenLevel = 64;
+        BuiltInResources.maxViewports = 16;
+        BuiltInResources.maxVertexAtomicCounters = 0;
+        BuiltInResources.maxTessControlAtomicCounters = 0;
+        BuiltInResources.maxTessEvaluationAtomicCounters = 0;
+        BuiltInResources.maxGeometryAtomicCounters = 0;
+        BuiltInResources.maxFragmentAtomicCounters = 8;
+        BuiltInResources.maxCombinedAtomicCounters = 8;
+        BuiltInResources.maxAtomicCounterBindings = 1;
+        BuiltInResources.maxVertexAtomicCounterBuffers = 0;
+        BuiltInResources.maxTessControlAtomicCounterBuffers = 0;
+        BuiltInResources.maxTessEvaluationAtomicCounterBuffers = 0;
+        BuiltInResources.maxGeometryAtomicCounterBuffers = 0;
+        BuiltInResources.maxFragmentAtomicCounterBuffers = 1;
+        BuiltInResources.maxCombinedAtomicCounterBuffers = 1;
+        BuiltInResources.maxAtomicCounterBufferSize = 16384;
+        BuiltInResources.maxTransformFeedbackBuffers = 4;
+        BuiltInResources.maxTransformFeedbackInterleavedComponents = 64;
+        BuiltInResources.maxCullDistances = 8;
+        BuiltInResources.maxCombinedClipAndCullDistances = 8;
+        BuiltInResources.maxSamples = 4;
+        BuiltInResources.maxMeshOutputVerticesNV = 256;
+        BuiltInResources.maxMeshOutputPrimitivesNV = 512;
+        BuiltInResources.maxMeshWorkGroupSizeX_NV = 32;
+        BuiltInResources.maxMeshWorkGroupSizeY_NV = 1;
+        BuiltInResources.maxMeshWorkGroupSizeZ_NV = 1;
+        BuiltInResources.maxTaskWorkGroupSizeX_NV = 32;
+        BuiltInResources.maxTaskWorkGroupSizeY_NV = 1;
+        BuiltInResources.maxTaskWorkGroupSizeZ_NV = 1;
+        BuiltInResources.maxMeshViewCountNV = 4;
+
+        BuiltInResources.limits.nonInductiveForLoops = 1;
+        BuiltInResources.limits.whileLoops = 1;
+        BuiltInResources.limits.doWhileLoops = 1;
+        BuiltInResources.limits.generalUniformIndexing = 1;
+        BuiltInResources.limits.generalAttributeMatrixVectorIndexing = 1;
+        BuiltInResources.limits.generalVaryingIndexing = 1;
+        BuiltInResources.limits.generalSamplerIndexing = 1;
+        BuiltInResources.limits.generalVariableIndexing = 1;
+        BuiltInResources.limits.generalConstantMatrixVectorIndexing = 1;
+    }
+}
+
+ShaderCompiler::~ShaderCompiler()
+{
+    glslang::FinalizeProcess();
+}
+
+bool ShaderCompiler::Compile(const FShaderConfig& inConfig, const std::string& inSourcePath, uint8*& outCode, uint64* outCodeSize, uint64& outSpirVKey) const
+{
+    EShLanguage ShaderStage = ConvertShaderType(inConfig.Type);
+    glslang::EShSource ShaderSourceLanguage = glslang::EShSourceHlsl;
+
+    if (inConfig.Flags & FShaderFlags::GLSL)
+    {
+        ShaderSourceLanguage = glslang::EShSourceGlsl;
+    }
+
+    int ClientInputSemanticsVersion = 100;
+    glslang::EShTargetClientVersion VulkanClientVersion = glslang::EShTargetVulkan_1_0;
+    glslang::EShTargetLanguageVersion TargetVersion = glslang::EShTargetSpv_1_0;
+
+    // Glsl only resolves #include with the extension enabled, this way shaders do not have to enable it themselves
+    std::string Preamble;
+    if (ShaderSourceLanguage == glslang::EShSourceGlsl)
+    {
+        Preamble += "#extension GL_GOOGLE_include_directive : enable\n";
+    }
+
+    for (const std::string& Define : inConfig.Defines)
+    {
+        const uint64 EqualsIndex = Define.find('=');
+        Preamble += "#define ";
+        Preamble += EqualsIndex == std::string::npos ? Define : Define.substr(0, EqualsIndex) + " " + Define.substr(EqualsIndex + 1);
+        Preamble += "\n";
+    }
+
+    const std::string SourcePath = NormalizeShaderPath(inSourcePath);
+
+    // Everything except the included files, the includes are only known after preprocessing
+    FDerivedDataKeyBuilder KeyBuilder("SpirVDependencies", SPIRV_DERIVED_DATA_VERSION);
+    KeyBuilder.Append(inConfig.SourceCode);
+    KeyBuilder.Append(SourcePath);
+    KeyBuilder.Append(Preamble);
+    KeyBuilder.AppendValue(ShaderStage);
+    KeyBuilder.AppendValue(ShaderSourceLanguage);
+    KeyBuilder.AppendValue(ClientInputSemanticsVersion);
+    KeyBuilder.AppendValue(VulkanClientVersion);
+    KeyBuilder.AppendValue(TargetVersion);
+    KeyBuilder.AppendValue(GLSLANG_VERSION_MAJOR);
+    KeyBuilder.AppendValue(GLSLANG_VERSION_MINOR);
+    KeyBuilder.AppendValue(GLSLANG_VERSION_PATCH);
+
+    for (const std::string& IncludeDirectory : IncludeDirectories)
+    {
+        KeyBuilder.Append(IncludeDirectory);
+    }
+
+    const uint64 DependenciesKey = KeyBuilder.GetKey();
+
+    // The dependencies recorded by the last compile decide which spirv entry to look for, editing
+    // an included file changes the spirv key of only the shaders that include it
+    std::vector<std::string> Dependencies;
+    FDerivedData CachedDependencies;
+    if (DerivedDataCache::Get().Get(DependenciesKey, CachedDependencies))
+    {
+        const char* DependencyList = (const char*)CachedDependencies.Data.Data;
+        for (uint64 Offset = 0; Offset < CachedDependencies.Data.Size; Offset += Dependencies.back().size() + 1)
+        {
+            Dependencies.push_back(std::string(DependencyList + Offset, strnlen(DependencyList + Offset, CachedDependencies.Data.Size - Offset)));
+        }
+
+        uint64 SpirVKey = 0;
+        FDerivedData CachedSpirV;
+        if (MakeSpirVKey(DependenciesKey, Dependencies, SpirVKey) && DerivedDataCache::Get().Get(SpirVKey, CachedSpirV))
+        {
+            *outCodeSize = CachedSpirV.Data.Size;
+            outCode = new uint8[*outCodeSize];
+            memcpy(outCode, CachedSpirV.Data.Data, *outCodeSize);
+
+            outSpirVKey = SpirVKey;
+            RecordDependencies(SourcePath, Dependencies);
+            return true;
+        }
+    }
+
+    glslang::TShader RawShader(ShaderStage);
+
+    // The name is what the includer resolves relative includes of the shader against
+    const char* RawInput = inConfig.SourceCode.c_str();
+    const char* SourceName = SourcePath.c_str();
+    RawShader.setStringsWithLengthsAndNames(&RawInput, nullptr, &SourceName, 1);
+    RawShader.setPreamble(Preamble.c_str());
+
+    RawShader.setEnvInput(ShaderSourceLanguage, ShaderStage, glslang::EShClientVulkan, ClientInputSemanticsVersion);
+    RawShader.setEnvClient(glslang::EShClientVulkan, VulkanClientVersion);
+    RawShader.setEnvTarget(glslang::EShTargetSpv, TargetVersion);
+
+    // Since DefaultTBuiltInResource get reinterpert casted to glslang_resource_t* we can just do some 
+    // pointer casting to get the original values back 
+    EShMessages messages = EShMsgDefault;
+
+    const int DefaultVersion = 100;
+
+    // preprocessing of the glsl shader (includes all files into the actual glsl string)
+    ShaderIncluder Includer(IncludeDirectories);
+    std::string preprocessedGLSL;
+    if (!RawShader.preprocess(&BuiltInResources, DefaultVersion, ENoProfile, false, false, messages, &preprocessedGLSL, Includer)) {
+        VE_ASSERT(false, "Shader Preprocessing Failed \n Log: {0}\n DebugLog: {1}", RawShader.getInfoLog(), RawShader.getInfoDebugLog());
+    }
+
+    //updates shader strings with preprocessed glsl file
+    const char* preprocessedCStr = preprocessedGLSL.c_str();
+    RawShader.setStrings(&preprocessedCStr, 1);
+
+    //parses the shader
+    if (!RawShader.parse(&BuiltInResources, 100, false, messages)) {
+        VE_ASSERT(false, "Shader Parsing Failed \n Log: {0}\n DebugLog: {1}", RawShader.getInfoLog(), RawShader.getInfoDebugLog());
+    }
+
+    glslang::TProgram program;
+    program.addShader(&RawShader);
+
+    //links program with shader
+    if (!program.link(messages)) {
+        VE_ASSERT(false, "Shader Linking \n Log: {0}\n DebugLog: {1}", RawShader.getInfoLog(), RawShader.getInfoDebugLog());
+    }
+
+    //converts glslang program to spirv format
+    std::vector<uint32> SpirV;
+    spv::SpvBuildLogger logger;
+    glslang::SpvOptions spvOptions;
+    spvOptions.validate = true;
+    glslang::GlslangToSpv(*program.getIntermediate(ShaderStage), SpirV, &logger, &spvOptions);
+
+    if (logger.getAllMessages().size() > 0)
+    {
+        VE_CORE_LOG_WARN("[ShaderCompiler]: Spirv Messages: \n {0}", logger.getAllMessages());
+    }
+
+    *outCodeSize = SpirV.size() * 4;
+    outCode = new uint8[*outCodeSize];
+    memcpy(outCode, SpirV.data(), *outCodeSize);
+
+    // Dependency list is stored as null terminated paths back to back
+    std::string DependencyList;
+    for (const std::string& Dependency : Includer.GetDependencies())
+    {
+        DependencyList += Dependency;
+        DependencyList += '\0';
+    }
+
+    uint64 SpirVKey = 0;
+    if (MakeSpirVKey(DependenciesKey, Includer.GetDependencies(), SpirVKey))
+    {
+        DerivedDataCache::Get().Put(DependenciesKey, DependencyList.data(), DependencyList.size());
+        DerivedDataCache::Get().Put(SpirVKey, outCode, *outCodeSize);
+    }
+    else
+    {
+        SpirVKey = 0;
+    }
+
+    outSpirVKey = SpirVKey;
+    RecordDependencies(SourcePath, Includer.GetDependencies());
+    return false;
+}
+
+bool ShaderCompiler::MakeSpirVKey(uint64 inDependenciesKey, const std::vector<std::string>& inDependencies, uint64& outSpirVKey) const
+{
+    FDerivedDataKeyBuilder KeyBuilder("SpirV", SPIRV_DERIVED_DATA_VERSION);
+    KeyBuilder.AppendValue(inDependenciesKey);
+
+    for (const std::string& Dependency : inDependencies)
+    {
+        KeyBuilder.Append(Dependency);
+        if (!KeyBuilder.AppendFile(Dependency))
+        {
+            return false;
+        }
+    }
+
+    outSpirVKey = KeyBuilder.GetKey();
+    return true;
+}
+
+void ShaderCompiler::RecordDependencies(const std::string& inSourcePath, const std::vector<std::string>& inDependencies) const
+{
+    if (inSourcePath.size() == 0)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> Lock(DependencyMutex);
+    ShaderDependencies[inSourcePath] = inDependencies;
+}
+
+void ShaderCompiler::AddIncludeDirectory(const std::string& inDirectoryPath)
+{
+    std::string DirectoryPath = NormalizeShaderPath(inDirectoryPath);
+    if (DirectoryPath.size() > 0 && DirectoryPath.back() != '/')
+    {
+        DirectoryPath += '/';
+    }
+
+    IncludeDirectories.push_back(DirectoryPath);
+}
+
+void ShaderCompiler::GetDependentShaders(const std::string& inFilePath, std::vector<std::string>& outShaderPaths) const
+{
+    const std::string FilePath = NormalizeShaderPath(inFilePath);
+
+    std::lock_guard<std::mutex> Lock(DependencyMutex);
+    for (const auto& It : ShaderDependencies)
+    {
+        if (It.first == FilePath || std::find(It.second.begin(), It.second.end(), FilePath) != It.second.end())
+        {
+            outShaderPaths.push_back(It.first);
+        }
+    }
+}
+
+EShLanguage ShaderCompiler::ConvertShaderType(EShaderType inShaderType) const
+{
+    switch (inShaderType)
+    {
+    case EShaderType::Vertex:
+        return EShLangVertex;
+    case EShaderType::Fragment:
+        return EShLangFragment;
+    }
+
+    VE_ASSERT(false, VE_TEXT("[ShaderCompiler]: Shader type currently not supported or is undefined: {0}"), (int32)inShaderType);
+    return EShLangVertex;
+}
+
+bool ShaderCompiler::LoadSourceFile(const std::string& inFilePath, std::string& outSource)
+{
+    FileReader Reader(inFilePath);
+    if (!Reader.IsOpen())
+    {
+        return false;
+    }
+
+    const uint64 Size = Reader.Size();
+    if (Size == 0)
+    {
+        return false;
+    }
+
+    outSource.resize(Size);
+    Reader.Read(&outSource[0], Size);
+    Reader.Close();
+    return true;
+}
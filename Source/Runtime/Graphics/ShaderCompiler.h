@@ -0,0 +1,82 @@
+/**
+* This file is part of the "Vrixic Engine" project (Copyright (c) 2022-2023 by Vrij Patel)
+* See "LICENSE.txt" for license information.
+*/
+
+#pragma once
+#include <Core/Core.h>
+#include <Misc/Defines/GenericDefines.h>
+#include "ShaderGenerics.h"
+
+#include <External/glslang/Include/glslang/Public/ShaderLang.h>
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+* Compiles shader source code into spirv with glslang and caches the result in the derived data cache,
+* keyed on the source, its defines and the contents of every file it includes.
+* Knows nothing about any graphics api so tools and tests can fill the cache without a device
+*/
+class VRIXIC_API ShaderCompiler
+{
+public:
+    ShaderCompiler();
+    ~ShaderCompiler();
+
+    ShaderCompiler(const ShaderCompiler& other) = delete;
+    ShaderCompiler operator=(const ShaderCompiler& other) = delete;
+
+public:
+    /**
+    * Compiles the source code of the config, or loads it from the derived data cache when neither the source nor any file it includes changed
+    *
+    * @param inSourcePath - path of the file the source was loaded from, relative includes are resolved against it. Empty for string shaders
+    * @param outCode - allocated with new[], the caller owns it
+    * @param outSpirVKey - derived data key of the spirv, 0 if one of its includes disappeared and it was not cached
+    * @returns bool true if the spirv was loaded from the derived data cache
+    */
+    bool Compile(const FShaderConfig& inConfig, const std::string& inSourcePath, uint8*& outCode, uint64* outCodeSize, uint64& outSpirVKey) const;
+
+    /**
+    * Adds a directory #include searches after the folder of the including file, has to be called before shaders are compiled
+    */
+    void AddIncludeDirectory(const std::string& inDirectoryPath);
+
+    /**
+    * Collects the shaders that include a file, directly or through other includes, as of their last compile
+    *
+    * @param inFilePath - an included file, shaders passed in are returned as well
+    * @param outShaderPaths - the paths of the shaders that have to be recompiled when the file changes are appended to this
+    */
+    void GetDependentShaders(const std::string& inFilePath, std::vector<std::string>& outShaderPaths) const;
+
+    /**
+    * Loads a text file without the null terminator FileHelper::LoadFileToString() leaves at the end
+    */
+    static bool LoadSourceFile(const std::string& inFilePath, std::string& outSource);
+
+private:
+    /**
+    * Builds the key of the spirv out of the key of everything but the includes and the contents of every included file
+    *
+    * @returns bool false if one of the included files no longer exists
+    */
+    bool MakeSpirVKey(uint64 inDependenciesKey, const std::vector<std::string>& inDependencies, uint64& outSpirVKey) const;
+
+    void RecordDependencies(const std::string& inSourcePath, const std::vector<std::string>& inDependencies) const;
+
+    EShLanguage ConvertShaderType(EShaderType inShaderType) const;
+
+private:
+    /** Searched in order by #include, each ends with a slash */
+    std::vector<std::string> IncludeDirectories;
+
+    /** Shader path -> every file it included the last time it was compiled */
+    mutable std::unordered_map<std::string, std::vector<std::string>> ShaderDependencies;
+    mutable std::mutex DependencyMutex;
+
+    TBuiltInResource BuiltInResources;
+};
@@ -137,6 +137,9 @@ public:
     /** Shader compilation flags */
     uint32 Flags;
 
+    /** Preprocessor definitions the shader is compiled with, either "NAME" or "NAME=VALUE" */
+    std::vector<std::string> Defines;
+
     /** All of the vertex shader bindings */
     std::vector<FVertexInputDescription> VertexBindings;
 
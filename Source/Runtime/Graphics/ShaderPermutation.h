@@ -0,0 +1,74 @@
+/**
+* This file is part of the "Vrixic Engine" project (Copyright (c) 2022-2023 by Vrij Patel)
+* See "LICENSE.txt" for license information.
+*/
+
+#pragma once
+#include <Core/Core.h>
+#include <Misc/Assert.h>
+#include <Misc/Defines/GenericDefines.h>
+#include <Misc/Defines/StringDefines.h>
+#include "ShaderGenerics.h"
+
+#include <string>
+#include <vector>
+
+/**
+* Declares the feature bits a shader is compiled in variants of
+*
+* The variant of a flags value keeps only the declared bits, it is passed to the shader as a single define
+*   (ex: "MATERIAL_PERMUTATION=33") so the shader can strip its inputs with #if and fold its feature checks to constants.
+* Variants compile through the regular shader path, the define is part of the config so each one gets its own spirv cache entry.
+*/
+struct VRIXIC_API FShaderPermutationDomain
+{
+public:
+    /** Name of the define the variant bits are passed to the shader with */
+    std::string Define;
+
+    /** Bits that select a variant, every other bit of a flags value is ignored */
+    uint32 FeatureMask;
+
+public:
+    FShaderPermutationDomain()
+        : FeatureMask(0) { }
+
+    FShaderPermutationDomain(const std::string& inDefine, uint32 inFeatureMask)
+        : Define(inDefine), FeatureMask(inFeatureMask) { }
+
+    /**
+    * @returns uint32 the smallest variant that supports every declared feature of inFlags
+    */
+    inline uint32 GetPermutation(uint32 inFlags) const
+    {
+        return inFlags & FeatureMask;
+    }
+
+    /**
+    * Adds the define selecting inPermutation to a shader config
+    */
+    void ApplyPermutation(uint32 inPermutation, FShaderConfig& outShaderConfig) const
+    {
+        VE_ASSERT((inPermutation & ~FeatureMask) == 0, VE_TEXT("[FShaderPermutationDomain]: Permutation {0} uses undeclared feature bits"), inPermutation);
+        outShaderConfig.Defines.push_back(Define + "=" + std::to_string(inPermutation));
+    }
+
+    /**
+    * @returns uint32 number of variants of the domain, every subset of the feature bits is one
+    */
+    inline uint32 GetNumPermutations() const
+    {
+        return 1u << CountBits(FeatureMask);
+    }
+
+private:
+    inline static uint32 CountBits(uint32 inValue)
+    {
+        uint32 Count = 0;
+        for (; inValue != 0; inValue &= inValue - 1)
+        {
+            ++Count;
+        }
+        return Count;
+    }
+};
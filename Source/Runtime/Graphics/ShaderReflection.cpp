@@ -0,0 +1,140 @@
+/**
+* This file is part of the "Vrixic Engine" project (Copyright (c) 2022-2023 by Vrij Patel)
+* See "LICENSE.txt" for license information.
+*/
+
+#include "ShaderReflection.h"
+#include <Runtime/Core/Math/VrixicMathHelper.h>
+
+#include <string.h>
+
+void FShaderReflection::AddToPipelineLayoutConfig(FPipelineLayoutConfig& outLayoutConfig) const
+{
+    for (const FShaderReflectedBinding& ReflectedBinding : Bindings)
+    {
+        // Since the layout information gets aggregated by the render interface, no need to worry here about creating
+        // a new Pipeline Binding Descriptor for the bindless set
+        if (ReflectedBinding.bIsBindless)
+        {
+            outLayoutConfig.AddBindingDescriptorAt({ }, ReflectedBinding.SetIndex);
+            continue;
+        }
+
+        FPipelineBinding Binding = { };
+        Binding.BindingIndex = (uint16)ReflectedBinding.BindingIndex;
+        Binding.NumResources = (uint16)ReflectedBinding.NumResources;
+        Binding.ResourceType = (EResourceType)ReflectedBinding.ResourceType;
+        Binding.BindFlags = ReflectedBinding.BindFlags;
+        Binding.StageFlags = StageFlags;
+
+        FPipelineBindingDescriptor& BindingDescriptor = outLayoutConfig.GetBindingDescriptorAt(ReflectedBinding.SetIndex);
+
+        // Another shader already declared the same binding, only the stage flags have to be combined
+        if (BindingDescriptor.Bindings[Binding.BindingIndex].ResourceType != EResourceType::Undefined)
+        {
+            Binding.StageFlags |= BindingDescriptor.Bindings[Binding.BindingIndex].StageFlags;
+        }
+
+        BindingDescriptor.AddBindingAt(Binding, Binding.BindingIndex);
+        outLayoutConfig.NumSets = MathUtils::Max(ReflectedBinding.SetIndex + 1, outLayoutConfig.NumSets);
+    }
+
+    for (const FShaderReflectedPushConstant& PushConstant : PushConstants)
+    {
+        FPushConstantRange Range;
+        Range.StageFlags = StageFlags;
+        Range.Offset = PushConstant.Offset;
+        Range.Size = PushConstant.Size;
+
+        outLayoutConfig.AddPushConstantRange(Range);
+    }
+}
+
+void FShaderReflection::Serialize(std::vector<uint8>& outBlob) const
+{
+    FHeader Header = { };
+    Header.Magic = BLOB_MAGIC;
+    Header.Version = BLOB_VERSION;
+    Header.StageFlags = StageFlags;
+    Header.NumBindings = (uint32)Bindings.size();
+    Header.NumPushConstants = (uint32)PushConstants.size();
+    Header.NumVertexInputs = (uint32)VertexInputs.size();
+
+    const uint64 BindingsSize = Bindings.size() * sizeof(FShaderReflectedBinding);
+    const uint64 PushConstantsSize = PushConstants.size() * sizeof(FShaderReflectedPushConstant);
+    const uint64 VertexInputsSize = VertexInputs.size() * sizeof(FShaderReflectedVertexInput);
+
+    outBlob.resize(sizeof(FHeader) + BindingsSize + PushConstantsSize + VertexInputsSize);
+
+    uint8* Data = outBlob.data();
+    memcpy(Data, &Header, sizeof(FHeader));
+    Data += sizeof(FHeader);
+
+    if (BindingsSize > 0)
+    {
+        memcpy(Data, Bindings.data(), BindingsSize);
+        Data += BindingsSize;
+    }
+
+    if (PushConstantsSize > 0)
+    {
+        memcpy(Data, PushConstants.data(), PushConstantsSize);
+        Data += PushConstantsSize;
+    }
+
+    if (VertexInputsSize > 0)
+    {
+        memcpy(Data, VertexInputs.data(), VertexInputsSize);
+    }
+}
+
+bool FShaderReflection::Deserialize(const uint8* inBlob, uint64 inBlobSize)
+{
+    if (inBlobSize < sizeof(FHeader))
+    {
+        return false;
+    }
+
+    FHeader Header;
+    memcpy(&Header, inBlob, sizeof(FHeader));
+
+    if (Header.Magic != BLOB_MAGIC || Header.Version != BLOB_VERSION)
+    {
+        return false;
+    }
+
+    const uint64 BindingsSize = (uint64)Header.NumBindings * sizeof(FShaderReflectedBinding);
+    const uint64 PushConstantsSize = (uint64)Header.NumPushConstants * sizeof(FShaderReflectedPushConstant);
+    const uint64 VertexInputsSize = (uint64)Header.NumVertexInputs * sizeof(FShaderReflectedVertexInput);
+
+    if (inBlobSize != sizeof(FHeader) + BindingsSize + PushConstantsSize + VertexInputsSize)
+    {
+        return false;
+    }
+
+    const uint8* Data = inBlob + sizeof(FHeader);
+
+    StageFlags = Header.StageFlags;
+
+    Bindings.resize(Header.NumBindings);
+    if (BindingsSize > 0)
+    {
+        memcpy(Bindings.data(), Data, BindingsSize);
+        Data += BindingsSize;
+    }
+
+    PushConstants.resize(Header.NumPushConstants);
+    if (PushConstantsSize > 0)
+    {
+        memcpy(PushConstants.data(), Data, PushConstantsSize);
+        Data += PushConstantsSize;
+    }
+
+    VertexInputs.resize(Header.NumVertexInputs);
+    if (VertexInputsSize > 0)
+    {
+        memcpy(VertexInputs.data(), Data, VertexInputsSize);
+    }
+
+    return true;
+}
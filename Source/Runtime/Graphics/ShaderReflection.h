@@ -0,0 +1,101 @@
+/**
+* This file is part of the "Vrixic Engine" project (Copyright (c) 2022-2023 by Vrij Patel)
+* See "LICENSE.txt" for license information.
+*/
+
+#pragma once
+#include <Core/Core.h>
+#include <Misc/Defines/GenericDefines.h>
+#include "Format.h"
+#include "PipelineLayout.h"
+
+#include <vector>
+
+/**
+* A resource binding a shader declares
+*/
+struct FShaderReflectedBinding
+{
+public:
+    uint32 SetIndex;
+    uint32 BindingIndex;
+
+    /** EResourceType */
+    uint32 ResourceType;
+
+    /** FResourceBindFlags */
+    uint32 BindFlags;
+
+    uint32 NumResources;
+
+    /** Bindless bindings are owned by the render interface, only their set is reserved in the layout */
+    uint32 bIsBindless;
+};
+
+/**
+* A push constant block a shader declares
+*/
+struct FShaderReflectedPushConstant
+{
+public:
+    uint32 Offset;
+    uint32 Size;
+};
+
+/**
+* A vertex attribute a vertex shader reads
+*/
+struct FShaderReflectedVertexInput
+{
+public:
+    uint32 Location;
+
+    /** EPixelFormat matching the type of the input (ex: vec3 -> RGB32Float) */
+    uint32 Format;
+};
+
+/**
+* Everything a pipeline needs to know about a compiled shader, extracted from the shader binary once
+* and stored next to it in the derived data cache as a compact blob:
+*   FHeader | bindings | push constants | vertex inputs
+*/
+struct VRIXIC_API FShaderReflection
+{
+public:
+    /** FShaderStageFlags of the shader */
+    uint32 StageFlags;
+
+    std::vector<FShaderReflectedBinding> Bindings;
+    std::vector<FShaderReflectedPushConstant> PushConstants;
+    std::vector<FShaderReflectedVertexInput> VertexInputs;
+
+public:
+    FShaderReflection()
+        : StageFlags(0) { }
+
+    /**
+    * Merges the bindings and push constants into a layout config, bindings already added by another stage get this stage added to them
+    */
+    void AddToPipelineLayoutConfig(FPipelineLayoutConfig& outLayoutConfig) const;
+
+    void Serialize(std::vector<uint8>& outBlob) const;
+
+    /**
+    * @returns bool false if the blob is truncated or was written by another version
+    */
+    bool Deserialize(const uint8* inBlob, uint64 inBlobSize);
+
+private:
+    struct FHeader
+    {
+        uint32 Magic;
+        uint32 Version;
+        uint32 StageFlags;
+        uint32 NumBindings;
+        uint32 NumPushConstants;
+        uint32 NumVertexInputs;
+    };
+
+    static constexpr uint32 BLOB_MAGIC = 0x46455256; // 'VREF'
+    static constexpr uint32 BLOB_VERSION = 1;
+};
@@ -7,10 +7,12 @@
 #include <Core/Core.h>
 #include "Extents.h"
 #include "Format.h"
+#include "Queue.h"
 #include <Misc/Defines/GenericDefines.h>
 #include "RenderPassGenerics.h"
 
 class Buffer;
+class TextureResource;
 
 /**
 * Texture type : in vulkan -> ImageViewType
@@ -99,9 +101,14 @@ public:
     /** Number of samplers to take per texel */
     uint32 NumSamples;
 
+    /** If not nullptr the texture is placed in this heap at TransientHeapOffset instead of getting its own memory */
+    class ITransientHeap* TransientHeap;
+    uint64 TransientHeapOffset;
+
 public:
     FTextureConfig()
-        : TextureHandle(nullptr), Type(ETextureType::Texture2D), InitialLayout(ETextureLayout::Undefined), BindFlags(0), CreationFlags(0), Format(EPixelFormat::Undefined), Extent(0u, 0u, 0u), MipLevels(1), NumArrayLayers(1), NumSamples(1) { }
+        : TextureHandle(nullptr), Type(ETextureType::Texture2D), InitialLayout(ETextureLayout::Undefined), BindFlags(0), CreationFlags(0), Format(EPixelFormat::Undefined), Extent(0u, 0u, 0u), MipLevels(1), NumArrayLayers(1), NumSamples(1),
+        TransientHeap(nullptr), TransientHeapOffset(0) { }
 };
 
 struct VRIXIC_API FVulkanTextureConfig : public FTextureConfig
@@ -134,6 +141,40 @@ public:
         : Type(ETextureType::Texture2D), Format(EPixelFormat::Undefined) { }
 };
 
+/**
+* Moves a texture from the layout of its last use to the layout of its next use,
+* the writes of the last use are made visible to the next one even if the layout stays the same
+*
+* A texture moving to another queue has to be recorded twice, once on each queue:
+*   the command buffer of the source queue releases it and the one of the destination queue acquires it (only the acquire does anything if both share a family)
+*/
+struct VRIXIC_API FTextureBarrier
+{
+public:
+    const TextureResource* Texture;
+
+    /** Layout the texture was last used in, undefined if its contents can be discarded */
+    ETextureLayout OldLayout;
+
+    /** Layout the texture is used in next */
+    ETextureLayout NewLayout;
+
+    /** Queue the texture was last used on */
+    ERenderQueueType SrcQueueType;
+
+    /** Queue the texture is used on next */
+    ERenderQueueType DstQueueType;
+
+public:
+    FTextureBarrier()
+        : Texture(nullptr), OldLayout(ETextureLayout::Undefined), NewLayout(ETextureLayout::Undefined),
+        SrcQueueType(ERenderQueueType::Graphics), DstQueueType(ERenderQueueType::Graphics) { }
+
+    FTextureBarrier(const TextureResource* inTexture, ETextureLayout inOldLayout, ETextureLayout inNewLayout,
+        ERenderQueueType inSrcQueueType = ERenderQueueType::Graphics, ERenderQueueType inDstQueueType = ERenderQueueType::Graphics)
+        : Texture(inTexture), OldLayout(inOldLayout), NewLayout(inNewLayout), SrcQueueType(inSrcQueueType), DstQueueType(inDstQueueType) { }
+};
+
 /**
 * Contains information for copying buffer to a texture
 */
@@ -0,0 +1,856 @@
+/**
+* This file is part of the "Vrixic Engine" project (Copyright (c) 2022-2023 by Vrij Patel)
+* See "LICENSE.txt" for license information.
+*/
+
+#include "BlockCompressor.h"
+#include <Misc/Assert.h>
+#include <Misc/Defines/StringDefines.h>
+#include <Runtime/Core/Math/VrixicMathHelper.h>
+
+#include <External/enkiTS/Includes/TaskScheduler.h>
+
+#include <emmintrin.h>
+
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+namespace BlockCompressorHelpers
+{
+    static const uint32 BYTES_PER_TEXEL = 4;
+    static const uint32 BLOCK_DIMENSION = 4;
+    static const uint32 TEXELS_PER_BLOCK = 16;
+
+    /** Roughly how many blocks each worker task encodes */
+    static const uint32 BLOCKS_PER_TASK = 1024;
+
+    /** Power iterations used to find the principal axis of a block */
+    static const uint32 NUM_POWER_ITERATIONS = 8;
+
+    /** BC1 texels with alpha below this are encoded as transparent */
+    static const uint8 BC1_ALPHA_THRESHOLD = 128;
+
+    /** BC7 4-bit index interpolation weights (out of 64) */
+    static const int32 BC7_WEIGHTS[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+    /**
+    * One 4x4 block, the float channels are stored SoA so 4 texels are processed per SSE register
+    */
+    struct FTexelBlock
+    {
+    public:
+        alignas(16) float Channels[4][TEXELS_PER_BLOCK];
+        alignas(16) uint8 Texels[TEXELS_PER_BLOCK * BYTES_PER_TEXEL];
+    };
+
+    /**
+    * Writes bit fields into a 128-bit block, least significant bit first
+    */
+    struct FBitWriter
+    {
+    public:
+        uint64 Bits[2] = { 0, 0 };
+        uint32 Position = 0;
+
+    public:
+        void Write(uint32 inValue, uint32 inNumBits)
+        {
+            for (uint32 i = 0; i < inNumBits; ++i, ++Position)
+            {
+                Bits[Position >> 6] |= (uint64)((inValue >> i) & 1) << (Position & 63);
+            }
+        }
+    };
+
+    static void LoadBlock(FTexelBlock& outBlock, const uint8* inTexels, uint32 inWidth, uint32 inHeight, uint32 inBlockX, uint32 inBlockY)
+    {
+        for (uint32 y = 0; y < BLOCK_DIMENSION; ++y)
+        {
+            // Repeat the edge texels for blocks that hang over the side of the image
+            const uint32 SourceY = MathUtils::Min(inBlockY * BLOCK_DIMENSION + y, inHeight - 1);
+            for (uint32 x = 0; x < BLOCK_DIMENSION; ++x)
+            {
+                const uint32 SourceX = MathUtils::Min(inBlockX * BLOCK_DIMENSION + x, inWidth - 1);
+                memcpy(&outBlock.Texels[(y * BLOCK_DIMENSION + x) * BYTES_PER_TEXEL], &inTexels[((uint64)SourceY * inWidth + SourceX) * BYTES_PER_TEXEL], BYTES_PER_TEXEL);
+            }
+        }
+
+        for (uint32 i = 0; i < TEXELS_PER_BLOCK; ++i)
+        {
+            for (uint32 Channel = 0; Channel < 4; ++Channel)
+            {
+                outBlock.Channels[Channel][i] = outBlock.Texels[i * BYTES_PER_TEXEL + Channel];
+            }
+        }
+    }
+
+    inline float HorizontalSum(__m128 inValue)
+    {
+        __m128 Shuffled = _mm_shuffle_ps(inValue, inValue, _MM_SHUFFLE(2, 3, 0, 1));
+        __m128 Sum = _mm_add_ps(inValue, Shuffled);
+        Shuffled = _mm_shuffle_ps(Sum, Sum, _MM_SHUFFLE(1, 0, 3, 2));
+        return _mm_cvtss_f32(_mm_add_ss(Sum, Shuffled));
+    }
+
+    inline float HorizontalMin(__m128 inValue)
+    {
+        __m128 Shuffled = _mm_shuffle_ps(inValue, inValue, _MM_SHUFFLE(2, 3, 0, 1));
+        __m128 Min = _mm_min_ps(inValue, Shuffled);
+        Shuffled = _mm_shuffle_ps(Min, Min, _MM_SHUFFLE(1, 0, 3, 2));
+        return _mm_cvtss_f32(_mm_min_ss(Min, Shuffled));
+    }
+
+    inline float HorizontalMax(__m128 inValue)
+    {
+        __m128 Shuffled = _mm_shuffle_ps(inValue, inValue, _MM_SHUFFLE(2, 3, 0, 1));
+        __m128 Max = _mm_max_ps(inValue, Shuffled);
+        Shuffled = _mm_shuffle_ps(Max, Max, _MM_SHUFFLE(1, 0, 3, 2));
+        return _mm_cvtss_f32(_mm_max_ss(Max, Shuffled));
+    }
+
+    /**
+    * Principal axis fit of the masked texels of a block
+    */
+    struct FBlockAxis
+    {
+    public:
+        float Mean[4];
+        float Axis[4];
+        float MinProjection;
+        float MaxProjection;
+    };
+
+    /**
+    * Finds the line through the block colors with the most variance (power iteration on the covariance matrix),
+    * then the range of the colors projected onto it
+    *
+    * @param inNumChannels 3 for RGB, 4 for RGBA
+    * @param inMask one float per texel, 1 to include the texel or 0 to skip it
+    */
+    static void FitAxis(const FTexelBlock& inBlock, uint32 inNumChannels, const float* inMask, FBlockAxis& outAxis)
+    {
+        __m128 Count = _mm_setzero_ps();
+        for (uint32 i = 0; i < TEXELS_PER_BLOCK; i += 4)
+        {
+            Count = _mm_add_ps(Count, _mm_load_ps(&inMask[i]));
+        }
+        const float NumTexels = MathUtils::Max(HorizontalSum(Count), 1.0f);
+
+        for (uint32 Channel = 0; Channel < 4; ++Channel)
+        {
+            __m128 Sum = _mm_setzero_ps();
+            for (uint32 i = 0; i < TEXELS_PER_BLOCK; i += 4)
+            {
+                Sum = _mm_add_ps(Sum, _mm_mul_ps(_mm_load_ps(&inBlock.Channels[Channel][i]), _mm_load_ps(&inMask[i])));
+            }
+            outAxis.Mean[Channel] = Channel < inNumChannels ? HorizontalSum(Sum) / NumTexels : 0.0f;
+        }
+
+        // Covariance, only the upper triangle is accumulated
+        float Covariance[4][4] = { };
+        for (uint32 Row = 0; Row < inNumChannels; ++Row)
+        {
+            for (uint32 Column = Row; Column < inNumChannels; ++Column)
+            {
+                const __m128 RowMean = _mm_set1_ps(outAxis.Mean[Row]);
+                const __m128 ColumnMean = _mm_set1_ps(outAxis.Mean[Column]);
+
+                __m128 Sum = _mm_setzero_ps();
+                for (uint32 i = 0; i < TEXELS_PER_BLOCK; i += 4)
+                {
+                    const __m128 RowDelta = _mm_sub_ps(_mm_load_ps(&inBlock.Channels[Row][i]), RowMean);
+                    const __m128 ColumnDelta = _mm_sub_ps(_mm_load_ps(&inBlock.Channels[Column][i]), ColumnMean);
+                    Sum = _mm_add_ps(Sum, _mm_mul_ps(_mm_mul_ps(RowDelta, ColumnDelta), _mm_load_ps(&inMask[i])));
+                }
+
+                Covariance[Row][Column] = HorizontalSum(Sum);
+                Covariance[Column][Row] = Covariance[Row][Column];
+            }
+        }
+
+        // Start from the luminance direction, it is close to the answer for most natural images
+        float Axis[4] = { 1.0f, 1.0f, 1.0f, inNumChannels == 4 ? 1.0f : 0.0f };
+        for (uint32 Iteration = 0; Iteration < NUM_POWER_ITERATIONS; ++Iteration)
+        {
+            float NewAxis[4] = { };
+            float LargestComponent = 0.0f;
+            for (uint32 Row = 0; Row < inNumChannels; ++Row)
+            {
+                for (uint32 Column = 0; Column < inNumChannels; ++Column)
+                {
+                    NewAxis[Row] += Covariance[Row][Column] * Axis[Column];
+                }
+                LargestComponent = MathUtils::Max(LargestComponent, fabsf(NewAxis[Row]));
+            }
+
+            // Flat block, keep the starting axis
+            if (LargestComponent < 1e-6f)
+            {
+                break;
+            }
+
+            for (uint32 Channel = 0; Channel < 4; ++Channel)
+            {
+                Axis[Channel] = NewAxis[Channel] / LargestComponent;
+            }
+        }
+
+        float LengthSquared = 0.0f;
+        for (uint32 Channel = 0; Channel < 4; ++Channel)
+        {
+            LengthSquared += Axis[Channel] * Axis[Channel];
+        }
+
+        const float InverseLength = 1.0f / sqrtf(LengthSquared);
+        for (uint32 Channel = 0; Channel < 4; ++Channel)
+        {
+            outAxis.Axis[Channel] = Axis[Channel] * InverseLength;
+        }
+
+        // Project the texels onto the axis 4 at a time, masked out texels do not extend the range
+        __m128 MinProjection = _mm_set1_ps(FLT_MAX);
+        __m128 MaxProjection = _mm_set1_ps(-FLT_MAX);
+        for (uint32 i = 0; i < TEXELS_PER_BLOCK; i += 4)
+        {
+            __m128 Projection = _mm_setzero_ps();
+            for (uint32 Channel = 0; Channel < inNumChannels; ++Channel)
+            {
+                const __m128 Delta = _mm_sub_ps(_mm_load_ps(&inBlock.Channels[Channel][i]), _mm_set1_ps(outAxis.Mean[Channel]));
+                Projection = _mm_add_ps(Projection, _mm_mul_ps(Delta, _mm_set1_ps(outAxis.Axis[Channel])));
+            }
+
+            const __m128 Included = _mm_cmpgt_ps(_mm_load_ps(&inMask[i]), _mm_setzero_ps());
+            MinProjection = _mm_min_ps(MinProjection, _mm_or_ps(_mm_and_ps(Included, Projection), _mm_andnot_ps(Included, _mm_set1_ps(FLT_MAX))));
+            MaxProjection = _mm_max_ps(MaxProjection, _mm_or_ps(_mm_and_ps(Included, Projection), _mm_andnot_ps(Included, _mm_set1_ps(-FLT_MAX))));
+        }
+
+        outAxis.MinProjection = HorizontalMin(MinProjection);
+        outAxis.MaxProjection = HorizontalMax(MaxProjection);
+
+        if (outAxis.MinProjection > outAxis.MaxProjection)
+        {
+            outAxis.MinProjection = outAxis.MaxProjection = 0.0f;
+        }
+    }
+
+    /**
+    * Least squares fit of two endpoints given each texel's interpolation weight toward the second endpoint
+    *
+    * @returns bool false if the system is singular (ex: every texel picked the same index)
+    */
+    static bool RefitEndpoints(const FTexelBlock& inBlock, uint32 inNumChannels, const float* inWeights, const float* inMask, float* outEndpoint0, float* outEndpoint1)
+    {
+        float A = 0.0f, B = 0.0f, C = 0.0f;
+        float X0[4] = { }, X1[4] = { };
+        for (uint32 i = 0; i < TEXELS_PER_BLOCK; ++i)
+        {
+            const float Weight = inWeights[i];
+            const float InverseWeight = 1.0f - Weight;
+
+            A += InverseWeight * InverseWeight * inMask[i];
+            B += InverseWeight * Weight * inMask[i];
+            C += Weight * Weight * inMask[i];
+
+            for (uint32 Channel = 0; Channel < inNumChannels; ++Channel)
+            {
+                X0[Channel] += InverseWeight * inBlock.Channels[Channel][i] * inMask[i];
+                X1[Channel] += Weight * inBlock.Channels[Channel][i] * inMask[i];
+            }
+        }
+
+        const float Determinant = A * C - B * B;
+        if (fabsf(Determinant) < 1e-6f)
+        {
+            return false;
+        }
+
+        const float InverseDeterminant = 1.0f / Determinant;
+        for (uint32 Channel = 0; Channel < inNumChannels; ++Channel)
+        {
+            outEndpoint0[Channel] = MathUtils::Clamp(0.0f, 255.0f, (C * X0[Channel] - B * X1[Channel]) * InverseDeterminant);
+            outEndpoint1[Channel] = MathUtils::Clamp(0.0f, 255.0f, (A * X1[Channel] - B * X0[Channel]) * InverseDeterminant);
+        }
+
+        return true;
+    }
+
+    /* ---------------------------------------- BC1 ---------------------------------------- */
+
+    inline uint16 PackRGB565(const float* inColor)
+    {
+        const uint32 R = (uint32)MathUtils::Clamp(0.0f, 31.0f, inColor[0] * (31.0f / 255.0f) + 0.5f);
+        const uint32 G = (uint32)MathUtils::Clamp(0.0f, 63.0f, inColor[1] * (63.0f / 255.0f) + 0.5f);
+        const uint32 B = (uint32)MathUtils::Clamp(0.0f, 31.0f, inColor[2] * (31.0f / 255.0f) + 0.5f);
+        return (uint16)((R << 11) | (G << 5) | B);
+    }
+
+    inline void UnpackRGB565(uint16 inColor, float* outColor)
+    {
+        const uint32 R = (inColor >> 11) & 31;
+        const uint32 G = (inColor >> 5) & 63;
+        const uint32 B = inColor & 31;
+        outColor[0] = (float)((R << 3) | (R >> 2));
+        outColor[1] = (float)((G << 2) | (G >> 4));
+        outColor[2] = (float)((B << 3) | (B >> 2));
+    }
+
+    /**
+    * A BC1 color block candidate, indices are in palette order: 0 = Color0, 1 = Color1, then the interpolated colors
+    */
+    struct FBC1Candidate
+    {
+    public:
+        uint16 Color0;
+        uint16 Color1;
+        uint8 Indices[TEXELS_PER_BLOCK];
+        float Error;
+    };
+
+    /**
+    * Picks the closest palette entry for every texel, 4 texels per iteration
+    *
+    * @param inThreeColorMode palette is Color0, Color1, midpoint (+ transparent black which is only used for masked out texels)
+    */
+    static void FindBC1Indices(const FTexelBlock& inBlock, const float* inMask, bool inThreeColorMode, FBC1Candidate& inOutCandidate)
+    {
+        float Palette[4][3];
+        UnpackRGB565(inOutCandidate.Color0, Palette[0]);
+        UnpackRGB565(inOutCandidate.Color1, Palette[1]);
+
+        const uint32 NumPaletteColors = inThreeColorMode ? 3 : 4;
+        for (uint32 Channel = 0; Channel < 3; ++Channel)
+        {
+            if (inThreeColorMode)
+            {
+                Palette[2][Channel] = (Palette[0][Channel] + Palette[1][Channel]) * 0.5f;
+            }
+            else
+            {
+                Palette[2][Channel] = (2.0f * Palette[0][Channel] + Palette[1][Channel]) / 3.0f;
+                Palette[3][Channel] = (Palette[0][Channel] + 2.0f * Palette[1][Channel]) / 3.0f;
+            }
+        }
+
+        __m128 TotalError = _mm_setzero_ps();
+        for (uint32 i = 0; i < TEXELS_PER_BLOCK; i += 4)
+        {
+            const __m128 R = _mm_load_ps(&inBlock.Channels[0][i]);
+            const __m128 G = _mm_load_ps(&inBlock.Channels[1][i]);
+            const __m128 B = _mm_load_ps(&inBlock.Channels[2][i]);
+
+            __m128 BestError = _mm_set1_ps(FLT_MAX);
+            __m128i BestIndex = _mm_setzero_si128();
+            for (uint32 Entry = 0; Entry < NumPaletteColors; ++Entry)
+            {
+                const __m128 DeltaR = _mm_sub_ps(R, _mm_set1_ps(Palette[Entry][0]));
+                const __m128 DeltaG = _mm_sub_ps(G, _mm_set1_ps(Palette[Entry][1]));
+                const __m128 DeltaB = _mm_sub_ps(B, _mm_set1_ps(Palette[Entry][2]));
+                const __m128 Error = _mm_add_ps(_mm_add_ps(_mm_mul_ps(DeltaR, DeltaR), _mm_mul_ps(DeltaG, DeltaG)), _mm_mul_ps(DeltaB, DeltaB));
+
+                const __m128i IsBetter = _mm_castps_si128(_mm_cmplt_ps(Error, BestError));
+                BestError = _mm_min_ps(Error, BestError);
+                BestIndex = _mm_or_si128(_mm_and_si128(IsBetter, _mm_set1_epi32(Entry)), _mm_andnot_si128(IsBetter, BestIndex));
+            }
+
+            const __m128 Mask = _mm_load_ps(&inMask[i]);
+            TotalError = _mm_add_ps(TotalError, _mm_mul_ps(BestError, Mask));
+
+            alignas(16) int32 Indices[4];
+            _mm_store_si128((__m128i*)Indices, BestIndex);
+            for (uint32 Lane = 0; Lane < 4; ++Lane)
+            {
+                inOutCandidate.Indices[i + Lane] = inMask[i + Lane] > 0.0f ? (uint8)Indices[Lane] : 3;
+            }
+        }
+
+        inOutCandidate.Error = HorizontalSum(TotalError);
+    }
+
+    /**
+    * @param inAllowTransparency BC1 textures with cutout alpha use the 3 color mode for blocks that have transparent texels,
+    *                            the color block of BC3 is always 4 color mode
+    */
+    static void EncodeBC1Block(const FTexelBlock& inBlock, bool inAllowTransparency, bool inRefineEndpoints, uint8* outBlock)
+    {
+        alignas(16) float Mask[TEXELS_PER_BLOCK];
+        bool bHasTransparency = false;
+        for (uint32 i = 0; i < TEXELS_PER_BLOCK; ++i)
+        {
+            const bool bIsTransparent = inAllowTransparency && inBlock.Texels[i * BYTES_PER_TEXEL + 3] < BC1_ALPHA_THRESHOLD;
+            Mask[i] = bIsTransparent ? 0.0f : 1.0f;
+            bHasTransparency |= bIsTransparent;
+        }
+
+        FBlockAxis Fit;
+        FitAxis(inBlock, 3, Mask, Fit);
+
+        // Pull the endpoints in slightly, the extremes are usually outliers and the interpolated colors matter more
+        const float Inset = (Fit.MaxProjection - Fit.MinProjection) / 16.0f;
+        float Endpoint0[3], Endpoint1[3];
+        for (uint32 Channel = 0; Channel < 3; ++Channel)
+        {
+            Endpoint0[Channel] = MathUtils::Clamp(0.0f, 255.0f, Fit.Mean[Channel] + Fit.Axis[Channel] * (Fit.MaxProjection - Inset));
+            Endpoint1[Channel] = MathUtils::Clamp(0.0f, 255.0f, Fit.Mean[Channel] + Fit.Axis[Channel] * (Fit.MinProjection + Inset));
+        }
+
+        FBC1Candidate Best;
+        Best.Color0 = PackRGB565(Endpoint0);
+        Best.Color1 = PackRGB565(Endpoint1);
+        FindBC1Indices(inBlock, Mask, bHasTransparency, Best);
+
+        if (inRefineEndpoints && Best.Error > 0.0f)
+        {
+            // Weight of each palette entry toward Color1
+            static const float FourColorWeights[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+            static const float ThreeColorWeights[4] = { 0.0f, 1.0f, 0.5f, 0.0f };
+            const float* PaletteWeights = bHasTransparency ? ThreeColorWeights : FourColorWeights;
+
+            float Weights[TEXELS_PER_BLOCK];
+            for (uint32 i = 0; i < TEXELS_PER_BLOCK; ++i)
+            {
+                Weights[i] = PaletteWeights[Best.Indices[i]];
+            }
+
+            if (RefitEndpoints(inBlock, 3, Weights, Mask, Endpoint0, Endpoint1))
+            {
+                FBC1Candidate Refined;
+                Refined.Color0 = PackRGB565(Endpoint0);
+                Refined.Color1 = PackRGB565(Endpoint1);
+                FindBC1Indices(inBlock, Mask, bHasTransparency, Refined);
+
+                if (Refined.Error < Best.Error)
+                {
+                    Best = Refined;
+                }
+            }
+        }
+
+        // The order of the endpoints selects the mode: Color0 > Color1 is 4 color mode, Color0 <= Color1 is 3 color mode
+        bool bSwapEndpoints = bHasTransparency ? (Best.Color0 > Best.Color1) : (Best.Color0 < Best.Color1);
+        if (!bHasTransparency && Best.Color0 == Best.Color1)
+        {
+            // Every palette entry is the same color, index 0 decodes the same in either mode
+            memset(Best.Indices, 0, sizeof(Best.Indices));
+            bSwapEndpoints = false;
+        }
+
+        if (bSwapEndpoints)
+        {
+            const uint16 Temp = Best.Color0;
+            Best.Color0 = Best.Color1;
+            Best.Color1 = Temp;
+
+            for (uint32 i = 0; i < TEXELS_PER_BLOCK; ++i)
+            {
+                // 4 color mode: 0 <-> 1, 2 <-> 3, 3 color mode: 0 <-> 1 (midpoint and transparent stay)
+                if (!bHasTransparency || Best.Indices[i] < 2)
+                {
+                    Best.Indices[i] ^= 1;
+                }
+            }
+        }
+
+        uint32 PackedIndices = 0;
+        for (uint32 i = 0; i < TEXELS_PER_BLOCK; ++i)
+        {
+            PackedIndices |= (uint32)Best.Indices[i] << (i * 2);
+        }
+
+        memcpy(outBlock, &Best.Color0, sizeof(uint16));
+        memcpy(outBlock + 2, &Best.Color1, sizeof(uint16));
+        memcpy(outBlock + 4, &PackedIndices, sizeof(uint32));
+    }
+
+    /* ---------------------------------------- BC4 (BC3 alpha, BC5 channels) ---------------------------------------- */
+
+    /**
+    * Encodes one channel of the block using the 8 value mode (Value0 > Value1)
+    */
+    static void EncodeBC4Block(const FTexelBlock& inBlock, uint32 inChannel, uint8* outBlock)
+    {
+        uint8 MinValue = 255, MaxValue = 0;
+        for (uint32 i = 0; i < TEXELS_PER_BLOCK; ++i)
+        {
+            const uint8 Value = inBlock.Texels[i * BYTES_PER_TEXEL + inChannel];
+            MinValue = MathUtils::Min(MinValue, Value);
+            MaxValue = MathUtils::Max(MaxValue, Value);
+        }
+
+        uint64 Block = (uint64)MaxValue | ((uint64)MinValue << 8);
+        if (MaxValue == MinValue)
+        {
+            // All indices 0
+            memcpy(outBlock, &Block, sizeof(uint64));
+            return;
+        }
+
+        // Palette in index order: Value0, Value1, then 6 interpolated values from Value0 toward Value1
+        alignas(16) int16 Palette[8];
+        Palette[0] = MaxValue;
+        Palette[1] = MinValue;
+        for (int32 i = 1; i < 7; ++i)
+        {
+            Palette[i + 1] = (int16)(((7 - i) * MaxValue + i * MinValue) / 7);
+        }
+
+        // 8 texels per register, every palette entry is tested and the closest one is kept
+        alignas(16) int16 Values[TEXELS_PER_BLOCK];
+        for (uint32 i = 0; i < TEXELS_PER_BLOCK; ++i)
+        {
+            Values[i] = inBlock.Texels[i * BYTES_PER_TEXEL + inChannel];
+        }
+
+        alignas(16) int16 Indices[TEXELS_PER_BLOCK];
+        for (uint32 i = 0; i < TEXELS_PER_BLOCK; i += 8)
+        {
+            const __m128i Texels = _mm_load_si128((const __m128i*)&Values[i]);
+
+            __m128i BestError = _mm_set1_epi16(0x7fff);
+            __m128i BestIndex = _mm_setzero_si128();
+            for (int16 Entry = 0; Entry < 8; ++Entry)
+            {
+                const __m128i Delta = _mm_sub_epi16(Texels, _mm_set1_epi16(Palette[Entry]));
+                const __m128i Error = _mm_max_epi16(Delta, _mm_sub_epi16(_mm_setzero_si128(), Delta));
+
+                const __m128i IsBetter = _mm_cmplt_epi16(Error, BestError);
+                BestError = _mm_min_epi16(Error, BestError);
+                BestIndex = _mm_or_si128(_mm_and_si128(IsBetter, _mm_set1_epi16(Entry)), _mm_andnot_si128(IsBetter, BestIndex));
+            }
+
+            _mm_store_si128((__m128i*)&Indices[i], BestIndex);
+        }
+
+        for (uint32 i = 0; i < TEXELS_PER_BLOCK; ++i)
+        {
+            Block |= (uint64)Indices[i] << (16 + i * 3);
+        }
+
+        memcpy(outBlock, &Block, sizeof(uint64));
+    }
+
+    /* ---------------------------------------- BC7 ---------------------------------------- */
+
+    /**
+    * Mode 6 endpoint: 7 bits per channel plus a shared p-bit, which gives a full 8 bit value per channel
+    */
+    struct FBC7Endpoint
+    {
+    public:
+        uint32 Channels[4];
+        uint32 PBit;
+
+    public:
+        int32 GetValue(uint32 inChannel) const
+        {
+            return (int32)((Channels[inChannel] << 1) | PBit);
+        }
+    };
+
+    static FBC7Endpoint QuantizeBC7Endpoint(const float* inColor)
+    {
+        FBC7Endpoint Best = { };
+        float BestError = FLT_MAX;
+        for (uint32 PBit = 0; PBit < 2; ++PBit)
+        {
+            FBC7Endpoint Candidate;
+            Candidate.PBit = PBit;
+
+            float Error = 0.0f;
+            for (uint32 Channel = 0; Channel < 4; ++Channel)
+            {
+                Candidate.Channels[Channel] = (uint32)MathUtils::Clamp(0.0f, 127.0f, (inColor[Channel] - PBit) * 0.5f + 0.5f);
+                const float Delta = (float)Candidate.GetValue(Channel) - inColor[Channel];
+                Error += Delta * Delta;
+            }
+
+            if (Error < BestError)
+            {
+                BestError = Error;
+                Best = Candidate;
+            }
+        }
+
+        return Best;
+    }
+
+    struct FBC7Candidate
+    {
+    public:
+        FBC7Endpoint Endpoints[2];
+        uint8 Indices[TEXELS_PER_BLOCK];
+        float Error;
+    };
+
+    /**
+    * Projects every texel onto the endpoint line to get a starting index, then tests it and its neighbours against the real palette
+    */
+    static void FindBC7Indices(const FTexelBlock& inBlock, FBC7Candidate& inOutCandidate)
+    {
+        alignas(16) float Palette[16][4];
+        for (uint32 Entry = 0; Entry < 16; ++Entry)
+        {
+            for (uint32 Channel = 0; Channel < 4; ++Channel)
+            {
+                const int32 Value0 = inOutCandidate.Endpoints[0].GetValue(Channel);
+                const int32 Value1 = inOutCandidate.Endpoints[1].GetValue(Channel);
+                Palette[Entry][Channel] = (float)(((64 - BC7_WEIGHTS[Entry]) * Value0 + BC7_WEIGHTS[Entry] * Value1 + 32) >> 6);
+            }
+        }
+
+        const __m128 Start = _mm_load_ps(Palette[0]);
+        const __m128 Direction = _mm_sub_ps(_mm_load_ps(Palette[15]), Start);
+        const float DirectionLengthSquared = HorizontalSum(_mm_mul_ps(Direction, Direction));
+        const float ProjectionScale = DirectionLengthSquared > 0.0f ? 15.0f / DirectionLengthSquared : 0.0f;
+
+        float TotalError = 0.0f;
+        for (uint32 i = 0; i < TEXELS_PER_BLOCK; ++i)
+        {
+            const __m128 Texel = _mm_setr_ps(inBlock.Channels[0][i], inBlock.Channels[1][i], inBlock.Channels[2][i], inBlock.Channels[3][i]);
+            const float Projection = HorizontalSum(_mm_mul_ps(_mm_sub_ps(Texel, Start), Direction)) * ProjectionScale;
+            const int32 Guess = (int32)MathUtils::Clamp(0.0f, 15.0f, Projection + 0.5f);
+
+            float BestError = FLT_MAX;
+            int32 BestIndex = Guess;
+            for (int32 Entry = MathUtils::Max(Guess - 1, 0); Entry <= MathUtils::Min(Guess + 1, 15); ++Entry)
+            {
+                const __m128 Delta = _mm_sub_ps(Texel, _mm_load_ps(Palette[Entry]));
+                const float Error = HorizontalSum(_mm_mul_ps(Delta, Delta));
+                if (Error < BestError)
+                {
+                    BestError = Error;
+                    BestIndex = Entry;
+                }
+            }
+
+            inOutCandidate.Indices[i] = (uint8)BestIndex;
+            TotalError += BestError;
+        }
+
+        inOutCandidate.Error = TotalError;
+    }
+
+    /**
+    * Encodes the block as BC7 mode 6 (one subset, RGBA endpoints, 4 bit indices)
+    */
+    static void EncodeBC7Block(const FTexelBlock& inBlock, bool inRefineEndpoints, uint8* outBlock)
+    {
+        alignas(16) static const float FullMask[TEXELS_PER_BLOCK] = { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 };
+
+        FBlockAxis Fit;
+        FitAxis(inBlock, 4, FullMask, Fit);
+
+        float Endpoint0[4], Endpoint1[4];
+        for (uint32 Channel = 0; Channel < 4; ++Channel)
+        {
+            Endpoint0[Channel] = MathUtils::Clamp(0.0f, 255.0f, Fit.Mean[Channel] + Fit.Axis[Channel] * Fit.MinProjection);
+            Endpoint1[Channel] = MathUtils::Clamp(0.0f, 255.0f, Fit.Mean[Channel] + Fit.Axis[Channel] * Fit.MaxProjection);
+        }
+
+        FBC7Candidate Best;
+        Best.Endpoints[0] = QuantizeBC7Endpoint(Endpoint0);
+        Best.Endpoints[1] = QuantizeBC7Endpoint(Endpoint1);
+        FindBC7Indices(inBlock, Best);
+
+        if (inRefineEndpoints && Best.Error > 0.0f)
+        {
+            float Weights[TEXELS_PER_BLOCK];
+            for (uint32 i = 0; i < TEXELS_PER_BLOCK; ++i)
+            {
+                Weights[i] = BC7_WEIGHTS[Best.Indices[i]] / 64.0f;
+            }
+
+            if (RefitEndpoints(inBlock, 4, Weights, FullMask, Endpoint0, Endpoint1))
+            {
+                FBC7Candidate Refined;
+                Refined.Endpoints[0] = QuantizeBC7Endpoint(Endpoint0);
+                Refined.Endpoints[1] = QuantizeBC7Endpoint(Endpoint1);
+                FindBC7Indices(inBlock, Refined);
+
+                if (Refined.Error < Best.Error)
+                {
+                    Best = Refined;
+                }
+            }
+        }
+
+        // The most significant index bit of the first texel is implied to be 0, flip the palette if it is not
+        if (Best.Indices[0] >= 8)
+        {
+            const FBC7Endpoint Temp = Best.Endpoints[0];
+            Best.Endpoints[0] = Best.Endpoints[1];
+            Best.Endpoints[1] = Temp;
+
+            for (uint32 i = 0; i < TEXELS_PER_BLOCK; ++i)
+            {
+                Best.Indices[i] = 15 - Best.Indices[i];
+            }
+        }
+
+        FBitWriter Writer;
+        Writer.Write(1 << 6, 7);
+
+        for (uint32 Channel = 0; Channel < 4; ++Channel)
+        {
+            Writer.Write(Best.Endpoints[0].Channels[Channel], 7);
+            Writer.Write(Best.Endpoints[1].Channels[Channel], 7);
+        }
+
+        Writer.Write(Best.Endpoints[0].PBit, 1);
+        Writer.Write(Best.Endpoints[1].PBit, 1);
+
+        Writer.Write(Best.Indices[0], 3);
+        for (uint32 i = 1; i < TEXELS_PER_BLOCK; ++i)
+        {
+            Writer.Write(Best.Indices[i], 4);
+        }
+
+        memcpy(outBlock, Writer.Bits, sizeof(Writer.Bits));
+    }
+
+    /**
+    * Describes one image being compressed
+    */
+    struct FCompressionInfo
+    {
+    public:
+        const FBlockCompressionConfig* Config;
+
+        const uint8* Source;
+        uint32 Width;
+        uint32 Height;
+
+        uint8* Destination;
+        uint32 NumBlocksX;
+    };
+
+    static void CompressBlockRows(const FCompressionInfo& inInfo, uint32 inRowStart, uint32 inRowEnd)
+    {
+        const bool bRefineEndpoints = inInfo.Config->bRefineEndpoints;
+        const uint32 BlockSize = FBlockCompressor::GetBlockSize(inInfo.Config->Format);
+
+        FTexelBlock Block;
+        for (uint32 BlockY = inRowStart; BlockY < inRowEnd; ++BlockY)
+        {
+            uint8* Destination = inInfo.Destination + (uint64)BlockY * inInfo.NumBlocksX * BlockSize;
+            for (uint32 BlockX = 0; BlockX < inInfo.NumBlocksX; ++BlockX, Destination += BlockSize)
+            {
+                LoadBlock(Block, inInfo.Source, inInfo.Width, inInfo.Height, BlockX, BlockY);
+
+                switch (inInfo.Config->Format)
+                {
+                case EBlockCompressionFormat::BC1:
+                    EncodeBC1Block(Block, true, bRefineEndpoints, Destination);
+                    break;
+                case EBlockCompressionFormat::BC3:
+                    EncodeBC4Block(Block, 3, Destination);
+                    EncodeBC1Block(Block, false, bRefineEndpoints, Destination + 8);
+                    break;
+                case EBlockCompressionFormat::BC5:
+                    EncodeBC4Block(Block, 0, Destination);
+                    EncodeBC4Block(Block, 1, Destination + 8);
+                    break;
+                case EBlockCompressionFormat::BC7:
+                    EncodeBC7Block(Block, bRefineEndpoints, Destination);
+                    break;
+                }
+            }
+        }
+    }
+
+    /**
+    * Encodes the block rows of one image across the task scheduler workers
+    */
+    struct FBlockRowsTaskSet : enki::ITaskSet
+    {
+        void ExecuteRange(enki::TaskSetPartition inRange, uint32_t /*inThreadNum*/) override
+        {
+            CompressBlockRows(Info, inRange.start, inRange.end);
+        }
+
+        FCompressionInfo Info;
+    };
+}
+
+uint32 FBlockCompressor::GetBlockSize(EBlockCompressionFormat inFormat)
+{
+    return inFormat == EBlockCompressionFormat::BC1 ? 8 : 16;
+}
+
+EPixelFormat FBlockCompressor::GetPixelFormat(const FBlockCompressionConfig& inConfig)
+{
+    switch (inConfig.Format)
+    {
+    case EBlockCompressionFormat::BC1:  return inConfig.bIsSRGB ? EPixelFormat::BC1RGBAUNorm_sRGB : EPixelFormat::BC1RGBAUNorm;
+    case EBlockCompressionFormat::BC3:  return inConfig.bIsSRGB ? EPixelFormat::BC3UNorm_sRGB : EPixelFormat::BC3UNorm;
+    case EBlockCompressionFormat::BC5:  return EPixelFormat::BC5UNorm;
+    case EBlockCompressionFormat::BC7:  return inConfig.bIsSRGB ? EPixelFormat::BC7UNorm_sRGB : EPixelFormat::BC7UNorm;
+    }
+
+    return EPixelFormat::Undefined;
+}
+
+uint64 FBlockCompressor::GetCompressedSize(uint32 inWidth, uint32 inHeight, uint32 inNumMipLevels, EBlockCompressionFormat inFormat)
+{
+    using namespace BlockCompressorHelpers;
+
+    uint64 Size = 0;
+    for (uint32 i = 0; i < inNumMipLevels; ++i)
+    {
+        const uint64 NumBlocksX = (MathUtils::Max(inWidth >> i, 1u) + BLOCK_DIMENSION - 1) / BLOCK_DIMENSION;
+        const uint64 NumBlocksY = (MathUtils::Max(inHeight >> i, 1u) + BLOCK_DIMENSION - 1) / BLOCK_DIMENSION;
+        Size += NumBlocksX * NumBlocksY * GetBlockSize(inFormat);
+    }
+
+    return Size;
+}
+
+void FBlockCompressor::Compress(const uint8* inTexels, uint32 inWidth, uint32 inHeight, uint8* outBlocks, const FBlockCompressionConfig& inConfig)
+{
+    using namespace BlockCompressorHelpers;
+
+    VE_ASSERT(inTexels != nullptr && outBlocks != nullptr, VE_TEXT("[BlockCompressor]: Cannot compress a null texture..."));
+
+    FBlockRowsTaskSet TaskSet;
+    FCompressionInfo& Info = TaskSet.Info;
+    Info.Config = &inConfig;
+    Info.Source = inTexels;
+    Info.Width = inWidth;
+    Info.Height = inHeight;
+    Info.Destination = outBlocks;
+    Info.NumBlocksX = (inWidth + BLOCK_DIMENSION - 1) / BLOCK_DIMENSION;
+
+    const uint32 NumBlocksY = (inHeight + BLOCK_DIMENSION - 1) / BLOCK_DIMENSION;
+
+    // Every block is independent, so rows of blocks are spread across the workers
+    if (inConfig.TaskScheduler != nullptr && (Info.NumBlocksX * NumBlocksY) > BLOCKS_PER_TASK)
+    {
+        TaskSet.m_SetSize = NumBlocksY;
+        TaskSet.m_MinRange = MathUtils::Max(BLOCKS_PER_TASK / Info.NumBlocksX, 1u);
+
+        inConfig.TaskScheduler->AddTaskSetToPipe(&TaskSet);
+        inConfig.TaskScheduler->WaitforTask(&TaskSet);
+    }
+    else
+    {
+        CompressBlockRows(Info, 0, NumBlocksY);
+    }
+}
+
+void FBlockCompressor::CompressMipChain(const uint8* inMipChain, uint32 inWidth, uint32 inHeight, uint32 inNumMipLevels, uint8* outBlocks, const FBlockCompressionConfig& inConfig)
+{
+    using namespace BlockCompressorHelpers;
+
+    const uint8* Source = inMipChain;
+    uint8* Destination = outBlocks;
+    for (uint32 MipLevel = 0; MipLevel < inNumMipLevels; ++MipLevel)
+    {
+        const uint32 MipWidth = MathUtils::Max(inWidth >> MipLevel, 1u);
+        const uint32 MipHeight = MathUtils::Max(inHeight >> MipLevel, 1u);
+
+        Compress(Source, MipWidth, MipHeight, Destination, inConfig);
+
+        Source += (uint64)MipWidth * MipHeight * BYTES_PER_TEXEL;
+        Destination += GetCompressedSize(MipWidth, MipHeight, 1, inConfig.Format);
+    }
+}
@@ -0,0 +1,96 @@
+/**
+* This file is part of the "Vrixic Engine" project (Copyright (c) 2022-2023 by Vrij Patel)
+* See "LICENSE.txt" for license information.
+*/
+
+#pragma once
+#include <Core/Core.h>
+#include <Misc/Defines/GenericDefines.h>
+#include <Runtime/Graphics/Format.h>
+
+#include <string>
+
+namespace enki
+{
+    class TaskScheduler;
+}
+
+enum class EBlockCompressionFormat
+{
+    /** RGB + 1-bit alpha, 8 bytes per block (ex: opaque or cutout base color) */
+    BC1,
+
+    /** RGB + smooth alpha, 16 bytes per block (ex: blended base color) */
+    BC3,
+
+    /** Two independent channels (red, green), 16 bytes per block (ex: tangent space normal maps) */
+    BC5,
+
+    /** RGBA, 16 bytes per block, best quality of the four and the slowest to encode */
+    BC7
+};
+
+struct FBlockCompressionConfig
+{
+public:
+    EBlockCompressionFormat Format = EBlockCompressionFormat::BC1;
+
+    /** Tags the output format as sRGB, the endpoints are fit on the encoded values as they are stored. Ignored for BC5 */
+    bool bIsSRGB = false;
+
+    /** Refits the endpoints to the chosen indices with least squares, slower but lowers the error of most blocks */
+    bool bRefineEndpoints = true;
+
+    /** Zstd level WriteKtx() supercompresses the mip levels with, 0 writes them uncompressed */
+    uint32 SupercompressionLevel = 0;
+
+    /** Optional, when set the block rows of each mip are encoded across the worker threads */
+    enki::TaskScheduler* TaskScheduler = nullptr;
+};
+
+/**
+* Encodes RGBA8 textures into BCn blocks on the cpu
+*
+* Blocks are 4x4 texels stored row by row, textures whose size is not a multiple of 4 have their edge texels repeated.
+* Mip chains use the same tightly packed layout as FMipGenerator:
+*   mip 0 blocks | mip 1 blocks | ...
+*/
+struct VRIXIC_API FBlockCompressor
+{
+public:
+    /**
+    * @returns uint32 size in bytes of a single 4x4 block
+    */
+    static uint32 GetBlockSize(EBlockCompressionFormat inFormat);
+
+    /**
+    * @returns EPixelFormat the texture format the gpu should sample the blocks with
+    */
+    static EPixelFormat GetPixelFormat(const FBlockCompressionConfig& inConfig);
+
+    /**
+    * @returns uint64 size in bytes of the compressed mip chain
+    */
+    static uint64 GetCompressedSize(uint32 inWidth, uint32 inHeight, uint32 inNumMipLevels, EBlockCompressionFormat inFormat);
+
+    /**
+    * Compresses a single RGBA8 image
+    *
+    * @param outBlocks memory receiving the blocks, has to be at least GetCompressedSize(inWidth, inHeight, 1) bytes
+    */
+    static void Compress(const uint8* inTexels, uint32 inWidth, uint32 inHeight, uint8* outBlocks, const FBlockCompressionConfig& inConfig);
+
+    /**
+    * Compresses every mip of a RGBA8 mip chain (ex: one filled in by FMipGenerator::Generate())
+    *
+    * @param outBlocks memory receiving the blocks, has to be at least GetCompressedSize(inWidth, inHeight, inNumMipLevels) bytes
+    */
+    static void CompressMipChain(const uint8* inMipChain, uint32 inWidth, uint32 inHeight, uint32 inNumMipLevels, uint8* outBlocks, const FBlockCompressionConfig& inConfig);
+
+    /**
+    * Writes compressed blocks out as a KTX2 file that Renderer::CreateTexture2DKtx() can load
+    *
+    * @returns bool false if the ktx texture could not be created or written
+    */
+    static bool WriteKtx(const std::string& inFilePath, const uint8* inBlocks, uint32 inWidth, uint32 inHeight, uint32 inNumMipLevels, const FBlockCompressionConfig& inConfig);
+};
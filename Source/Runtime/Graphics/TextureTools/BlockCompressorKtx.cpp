@@ -0,0 +1,67 @@
+/**
+* This file is part of the "Vrixic Engine" project (Copyright (c) 2022-2023 by Vrij Patel)
+* See "LICENSE.txt" for license information.
+*/
+
+/**
+* FBlockCompressor::WriteKtx() lives apart from the encoder, it needs libktx and the vulkan format table while the encoder itself
+*   only needs the cpu (and builds into the tests without either)
+*/
+
+#include "BlockCompressor.h"
+#include <Misc/Defines/StringDefines.h>
+#include <Runtime/Core/Math/VrixicMathHelper.h>
+#include <Runtime/Graphics/Vulkan/VulkanTypeConverter.h>
+
+#include <External/ktx/Includes/ktx.h>
+
+bool FBlockCompressor::WriteKtx(const std::string& inFilePath, const uint8* inBlocks, uint32 inWidth, uint32 inHeight, uint32 inNumMipLevels, const FBlockCompressionConfig& inConfig)
+{
+    ktxTextureCreateInfo KtxTextureCreateInfo = { };
+    KtxTextureCreateInfo.vkFormat = VulkanTypeConverter::Convert(GetPixelFormat(inConfig));
+    KtxTextureCreateInfo.baseWidth = inWidth;
+    KtxTextureCreateInfo.baseHeight = inHeight;
+    KtxTextureCreateInfo.baseDepth = 1;
+    KtxTextureCreateInfo.numDimensions = 2;
+    KtxTextureCreateInfo.numLevels = inNumMipLevels;
+    KtxTextureCreateInfo.numLayers = 1;
+    KtxTextureCreateInfo.numFaces = 1;
+    KtxTextureCreateInfo.isArray = KTX_FALSE;
+    KtxTextureCreateInfo.generateMipmaps = KTX_FALSE;
+
+    ktxTexture2* KtxTextureHandle = nullptr;
+    KTX_error_code KtxResult = ktxTexture2_Create(&KtxTextureCreateInfo, KTX_TEXTURE_CREATE_ALLOC_STORAGE, &KtxTextureHandle);
+    if (KtxResult != KTX_SUCCESS)
+    {
+        VE_CORE_LOG_ERROR(VE_TEXT("[BlockCompressor]: Failed to create a ktx texture for {0}, error: {1}"), inFilePath, ktxErrorString(KtxResult));
+        return false;
+    }
+
+    const uint8* MipBlocks = inBlocks;
+    for (uint32 MipLevel = 0; MipLevel < inNumMipLevels && KtxResult == KTX_SUCCESS; ++MipLevel)
+    {
+        const uint64 MipSize = GetCompressedSize(MathUtils::Max(inWidth >> MipLevel, 1u), MathUtils::Max(inHeight >> MipLevel, 1u), 1, inConfig.Format);
+        KtxResult = ktxTexture_SetImageFromMemory(ktxTexture(KtxTextureHandle), MipLevel, 0, 0, MipBlocks, MipSize);
+        MipBlocks += MipSize;
+    }
+
+    if (KtxResult == KTX_SUCCESS && inConfig.SupercompressionLevel > 0)
+    {
+        KtxResult = ktxTexture2_DeflateZstd(KtxTextureHandle, inConfig.SupercompressionLevel);
+    }
+
+    if (KtxResult == KTX_SUCCESS)
+    {
+        KtxResult = ktxTexture_WriteToNamedFile(ktxTexture(KtxTextureHandle), inFilePath.c_str());
+    }
+
+    ktxTexture_Destroy(ktxTexture(KtxTextureHandle));
+
+    if (KtxResult != KTX_SUCCESS)
+    {
+        VE_CORE_LOG_ERROR(VE_TEXT("[BlockCompressor]: Failed to write {0}, error: {1}"), inFilePath, ktxErrorString(KtxResult));
+        return false;
+    }
+
+    return true;
+}
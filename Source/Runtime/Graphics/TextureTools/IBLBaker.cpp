@@ -0,0 +1,730 @@
+/**
+* This file is part of the "Vrixic Engine" project (Copyright (c) 2022-2023 by Vrij Patel)
+* See "LICENSE.txt" for license information.
+*/
+
+#include "IBLBaker.h"
+#include <Misc/Assert.h>
+#include <Misc/Defines/StringDefines.h>
+#include <Runtime/Core/Math/VrixicMathHelper.h>
+
+#include <External/enkiTS/Includes/TaskScheduler.h>
+
+#include <emmintrin.h>
+
+#include <cmath>
+#include <cstring>
+
+namespace IBLBakerHelpers
+{
+    static const uint32 FLOATS_PER_TEXEL = 4;
+    static const uint32 NUM_FACES = 6;
+    static const uint32 NUM_SH_COEFFICIENTS = 9;
+
+    /** Per row sums of the projection: 9 rgb coefficients then the total solid angle */
+    static const uint32 NUM_ROW_SUMS = NUM_SH_COEFFICIENTS * 3 + 1;
+
+    /** Roughly how many texel samples each worker task takes */
+    static const uint32 SAMPLES_PER_TASK = 64 * 1024;
+
+    /**
+    * Direction of a face texel = Forward + u * Right + v * Down, with u and v in [-1, 1] going along the row and down the rows.
+    *   Matches the Vulkan cubemap face selection, so a baked map samples like its source
+    */
+    static const float FACE_FORWARD[6][3] = { { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 } };
+    static const float FACE_RIGHT[6][3] = { { 0, 0, -1 }, { 0, 0, 1 }, { 1, 0, 0 }, { 1, 0, 0 }, { 1, 0, 0 }, { -1, 0, 0 } };
+    static const float FACE_DOWN[6][3] = { { 0, -1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 }, { 0, -1, 0 }, { 0, -1, 0 } };
+
+    /** Order 2 real spherical harmonics basis constants */
+    static const float SH_Y0 = 0.282095f;
+    static const float SH_Y1 = 0.488603f;
+    static const float SH_Y2 = 1.092548f;
+    static const float SH_Y20 = 0.315392f;
+    static const float SH_Y22 = 0.546274f;
+
+    /** Convolution of each band with the clamped cosine lobe (Ramamoorthi and Hanrahan) */
+    static const float SH_A0 = PI;
+    static const float SH_A1 = 2.0f * PI / 3.0f;
+    static const float SH_A2 = PI / 4.0f;
+
+    /**
+    * Runs a function over rows of work across the task scheduler workers, or inline if there is too little work
+    */
+    typedef void (*FRowsFunction)(const void* inContext, uint32 inBeginRow, uint32 inEndRow);
+
+    struct FRowsTaskSet : enki::ITaskSet
+    {
+        void ExecuteRange(enki::TaskSetPartition inRange, uint32_t /*inThreadNum*/) override
+        {
+            Function(Context, inRange.start, inRange.end);
+        }
+
+        FRowsFunction Function;
+        const void* Context;
+    };
+
+    static void ForEachRow(uint32 inNumRows, uint32 inSamplesPerRow, enki::TaskScheduler* inTaskScheduler, FRowsFunction inFunction, const void* inContext)
+    {
+        if (inTaskScheduler != nullptr && (uint64)inNumRows * inSamplesPerRow > SAMPLES_PER_TASK)
+        {
+            FRowsTaskSet TaskSet;
+            TaskSet.Function = inFunction;
+            TaskSet.Context = inContext;
+            TaskSet.m_SetSize = inNumRows;
+            TaskSet.m_MinRange = MathUtils::Max(SAMPLES_PER_TASK / MathUtils::Max(inSamplesPerRow, 1u), 1u);
+
+            inTaskScheduler->AddTaskSetToPipe(&TaskSet);
+            inTaskScheduler->WaitforTask(&TaskSet);
+        }
+        else
+        {
+            inFunction(inContext, 0, inNumRows);
+        }
+    }
+
+    /**
+    * @returns float position of the texel center along a face, in [-1, 1]
+    */
+    inline float TexelToFace(uint32 inTexel, uint32 inSize)
+    {
+        return 2.0f * ((float)inTexel + 0.5f) / (float)inSize - 1.0f;
+    }
+
+    /**
+    * @returns Vector3D normalized direction through the center of a face texel
+    */
+    inline Vector3D TexelToDirection(uint32 inFace, uint32 inX, uint32 inY, uint32 inSize)
+    {
+        const float U = TexelToFace(inX, inSize);
+        const float V = TexelToFace(inY, inSize);
+
+        const float X = FACE_FORWARD[inFace][0] + U * FACE_RIGHT[inFace][0] + V * FACE_DOWN[inFace][0];
+        const float Y = FACE_FORWARD[inFace][1] + U * FACE_RIGHT[inFace][1] + V * FACE_DOWN[inFace][1];
+        const float Z = FACE_FORWARD[inFace][2] + U * FACE_RIGHT[inFace][2] + V * FACE_DOWN[inFace][2];
+
+        const float InvLength = 1.0f / std::sqrt(X * X + Y * Y + Z * Z);
+        return Vector3D(X * InvLength, Y * InvLength, Z * InvLength);
+    }
+
+    inline __m128 Select(__m128 inMask, __m128 inA, __m128 inB)
+    {
+        return _mm_or_ps(_mm_and_ps(inMask, inA), _mm_andnot_ps(inMask, inB));
+    }
+
+    /**
+    * Picks the face 4 directions point at (the major axis) and where they land on it, like the gpu does when sampling a cubemap
+    *
+    * @param outU, outV texture coordinates on the face in [0, 1]
+    */
+    static void DirectionsToFaces(__m128 inX, __m128 inY, __m128 inZ, int32* outFaces, __m128& outU, __m128& outV)
+    {
+        const __m128 Zero = _mm_setzero_ps();
+        const __m128 SignMask = _mm_set1_ps(-0.0f);
+
+        const __m128 AbsX = _mm_andnot_ps(SignMask, inX);
+        const __m128 AbsY = _mm_andnot_ps(SignMask, inY);
+        const __m128 AbsZ = _mm_andnot_ps(SignMask, inZ);
+
+        const __m128 IsMajorX = _mm_and_ps(_mm_cmpge_ps(AbsX, AbsY), _mm_cmpge_ps(AbsX, AbsZ));
+        const __m128 IsMajorY = _mm_andnot_ps(IsMajorX, _mm_cmpge_ps(AbsY, AbsZ));
+
+        const __m128 IsPositiveX = _mm_cmpge_ps(inX, Zero);
+        const __m128 IsPositiveY = _mm_cmpge_ps(inY, Zero);
+        const __m128 IsPositiveZ = _mm_cmpge_ps(inZ, Zero);
+
+        const __m128 NegX = _mm_xor_ps(inX, SignMask);
+        const __m128 NegY = _mm_xor_ps(inY, SignMask);
+        const __m128 NegZ = _mm_xor_ps(inZ, SignMask);
+
+        // +X: (-z, -y), -X: (z, -y), +Y: (x, z), -Y: (x, -z), +Z: (x, -y), -Z: (-x, -y)
+        const __m128 MajorAxis = Select(IsMajorX, AbsX, Select(IsMajorY, AbsY, AbsZ));
+        const __m128 S = Select(IsMajorX, Select(IsPositiveX, NegZ, inZ), Select(IsMajorY, inX, Select(IsPositiveZ, inX, NegX)));
+        const __m128 T = Select(IsMajorY, Select(IsPositiveY, inZ, NegZ), NegY);
+
+        const __m128 Face = Select(IsMajorX, Select(IsPositiveX, _mm_set1_ps(0.0f), _mm_set1_ps(1.0f)),
+            Select(IsMajorY, Select(IsPositiveY, _mm_set1_ps(2.0f), _mm_set1_ps(3.0f)), Select(IsPositiveZ, _mm_set1_ps(4.0f), _mm_set1_ps(5.0f))));
+        _mm_storeu_si128((__m128i*)outFaces, _mm_cvttps_epi32(Face));
+
+        const __m128 Half = _mm_set1_ps(0.5f);
+        const __m128 InvMajorAxis = _mm_div_ps(Half, MajorAxis);
+        outU = _mm_add_ps(_mm_mul_ps(S, InvMajorAxis), Half);
+        outV = _mm_add_ps(_mm_mul_ps(T, InvMajorAxis), Half);
+    }
+
+    /**
+    * Bilinear fetch inside a face, the edges are clamped
+    */
+    static __m128 SampleFace(const float* inFace, uint32 inSize, float inU, float inV)
+    {
+        const float X = inU * (float)inSize - 0.5f;
+        const float Y = inV * (float)inSize - 0.5f;
+        const float FloorX = std::floor(X);
+        const float FloorY = std::floor(Y);
+
+        const int32 MaxTexel = (int32)inSize - 1;
+        const int32 X0 = MathUtils::Clamp(0, MaxTexel, (int32)FloorX);
+        const int32 Y0 = MathUtils::Clamp(0, MaxTexel, (int32)FloorY);
+        const int32 X1 = MathUtils::Clamp(0, MaxTexel, (int32)FloorX + 1);
+        const int32 Y1 = MathUtils::Clamp(0, MaxTexel, (int32)FloorY + 1);
+
+        const __m128 FracX = _mm_set1_ps(X - FloorX);
+        const __m128 FracY = _mm_set1_ps(Y - FloorY);
+
+        const __m128 Texel00 = _mm_loadu_ps(inFace + (Y0 * inSize + X0) * FLOATS_PER_TEXEL);
+        const __m128 Texel10 = _mm_loadu_ps(inFace + (Y0 * inSize + X1) * FLOATS_PER_TEXEL);
+        const __m128 Texel01 = _mm_loadu_ps(inFace + (Y1 * inSize + X0) * FLOATS_PER_TEXEL);
+        const __m128 Texel11 = _mm_loadu_ps(inFace + (Y1 * inSize + X1) * FLOATS_PER_TEXEL);
+
+        const __m128 Top = _mm_add_ps(Texel00, _mm_mul_ps(_mm_sub_ps(Texel10, Texel00), FracX));
+        const __m128 Bottom = _mm_add_ps(Texel01, _mm_mul_ps(_mm_sub_ps(Texel11, Texel01), FracX));
+        return _mm_add_ps(Top, _mm_mul_ps(_mm_sub_ps(Bottom, Top), FracY));
+    }
+
+    /**
+    * Trilinear fetch, inLod is clamped to the mips of the cubemap
+    */
+    static __m128 SampleCubemap(const FCubemapImage& inCubemap, uint32 inFace, float inU, float inV, float inLod)
+    {
+        const float Lod = MathUtils::Clamp(0.0f, (float)(inCubemap.NumMipLevels - 1), inLod);
+        const uint32 Mip = (uint32)Lod;
+        const float MipFrac = Lod - (float)Mip;
+
+        const __m128 Color = SampleFace(inCubemap.GetFace(Mip, inFace), inCubemap.GetMipSize(Mip), inU, inV);
+        if (MipFrac <= 0.0f || Mip + 1 >= inCubemap.NumMipLevels)
+        {
+            return Color;
+        }
+
+        const __m128 NextColor = SampleFace(inCubemap.GetFace(Mip + 1, inFace), inCubemap.GetMipSize(Mip + 1), inU, inV);
+        return _mm_add_ps(Color, _mm_mul_ps(_mm_sub_ps(NextColor, Color), _mm_set1_ps(MipFrac)));
+    }
+
+    inline float RadicalInverse(uint32 inBits)
+    {
+        inBits = (inBits << 16u) | (inBits >> 16u);
+        inBits = ((inBits & 0x55555555u) << 1u) | ((inBits & 0xAAAAAAAAu) >> 1u);
+        inBits = ((inBits & 0x33333333u) << 2u) | ((inBits & 0xCCCCCCCCu) >> 2u);
+        inBits = ((inBits & 0x0F0F0F0Fu) << 4u) | ((inBits & 0xF0F0F0F0u) >> 4u);
+        inBits = ((inBits & 0x00FF00FFu) << 8u) | ((inBits & 0xFF00FF00u) >> 8u);
+        return (float)inBits * 2.3283064365386963e-10f;
+    }
+
+    /**
+    * GGX samples of one mip in the tangent space of the texel normal (+Z), 4 per SSE register.
+    *   With V = N every sample only depends on the roughness, so they are shared by all the texels of the mip
+    */
+    struct FPrefilterSamples
+    {
+    public:
+        std::vector<float> X;
+        std::vector<float> Y;
+        std::vector<float> Z;
+        std::vector<float> Lod;
+        std::vector<float> Weight;
+        float TotalWeight = 0.0f;
+    };
+
+    /**
+    * Same estimator as the prefilter shader: Hammersley points, GGX importance sampled half vectors weighted by N.L,
+    *   each read from the source mip whose texel solid angle matches the solid angle of the sample
+    */
+    static void MakePrefilterSamples(float inRoughness, uint32 inNumSamples, uint32 inSourceSize, FPrefilterSamples& outSamples)
+    {
+        outSamples = FPrefilterSamples();
+
+        const float Alpha = inRoughness * inRoughness;
+        const float Alpha2 = Alpha * Alpha;
+        const float TexelSolidAngle = 4.0f * PI / (6.0f * (float)inSourceSize * (float)inSourceSize);
+
+        for (uint32 i = 0; i < inNumSamples; ++i)
+        {
+            const float Phi = 2.0f * PI * (float)i / (float)inNumSamples;
+            const float Xi = RadicalInverse(i);
+
+            const float CosTheta = std::sqrt((1.0f - Xi) / (1.0f + (Alpha2 - 1.0f) * Xi));
+            const float SinTheta = std::sqrt(1.0f - CosTheta * CosTheta);
+
+            // Reflect V = N around H
+            const float HX = std::cos(Phi) * SinTheta;
+            const float HY = std::sin(Phi) * SinTheta;
+            const float HZ = CosTheta;
+
+            const float NdotL = 2.0f * HZ * HZ - 1.0f;
+            if (NdotL <= 0.0f)
+            {
+                continue;
+            }
+
+            // pdf = D * NdotH / (4 * HdotV), NdotH == HdotV here
+            const float Denominator = HZ * HZ * (Alpha2 - 1.0f) + 1.0f;
+            const float D = Alpha2 / (PI * Denominator * Denominator);
+            const float Pdf = D / 4.0f + 0.0001f;
+
+            const float SampleSolidAngle = 1.0f / ((float)inNumSamples * Pdf + 0.0001f);
+            const float Lod = inRoughness == 0.0f ? 0.0f : MathUtils::Max(0.5f * std::log2(SampleSolidAngle / TexelSolidAngle), 0.0f);
+
+            outSamples.X.push_back(2.0f * HZ * HX);
+            outSamples.Y.push_back(2.0f * HZ * HY);
+            outSamples.Z.push_back(NdotL);
+            outSamples.Lod.push_back(Lod);
+            outSamples.Weight.push_back(NdotL);
+            outSamples.TotalWeight += NdotL;
+        }
+
+        // Padding samples weigh nothing
+        while (outSamples.X.size() % 4 != 0)
+        {
+            outSamples.X.push_back(0.0f);
+            outSamples.Y.push_back(0.0f);
+            outSamples.Z.push_back(1.0f);
+            outSamples.Lod.push_back(0.0f);
+            outSamples.Weight.push_back(0.0f);
+        }
+    }
+
+    struct FMipContext
+    {
+    public:
+        FCubemapImage* Cubemap;
+        uint32 MipLevel;
+    };
+
+    static void DownsampleRows(const void* inContext, uint32 inBeginRow, uint32 inEndRow)
+    {
+        const FMipContext& Context = *(const FMipContext*)inContext;
+        FCubemapImage& Cubemap = *Context.Cubemap;
+
+        const uint32 SourceSize = Cubemap.GetMipSize(Context.MipLevel - 1);
+        const uint32 Size = Cubemap.GetMipSize(Context.MipLevel);
+        const __m128 Quarter = _mm_set1_ps(0.25f);
+
+        for (uint32 Row = inBeginRow; Row < inEndRow; ++Row)
+        {
+            const uint32 Face = Row / Size;
+            const uint32 Y = Row % Size;
+
+            const float* Source = Cubemap.GetFace(Context.MipLevel - 1, Face);
+            float* Destination = Cubemap.GetFace(Context.MipLevel, Face) + (uint64)Y * Size * FLOATS_PER_TEXEL;
+
+            const uint32 Y0 = MathUtils::Min(Y * 2, SourceSize - 1);
+            const uint32 Y1 = MathUtils::Min(Y * 2 + 1, SourceSize - 1);
+            for (uint32 X = 0; X < Size; ++X)
+            {
+                const uint32 X0 = MathUtils::Min(X * 2, SourceSize - 1);
+                const uint32 X1 = MathUtils::Min(X * 2 + 1, SourceSize - 1);
+
+                const __m128 Sum = _mm_add_ps(
+                    _mm_add_ps(_mm_loadu_ps(Source + (Y0 * SourceSize + X0) * FLOATS_PER_TEXEL), _mm_loadu_ps(Source + (Y0 * SourceSize + X1) * FLOATS_PER_TEXEL)),
+                    _mm_add_ps(_mm_loadu_ps(Source + (Y1 * SourceSize + X0) * FLOATS_PER_TEXEL), _mm_loadu_ps(Source + (Y1 * SourceSize + X1) * FLOATS_PER_TEXEL)));
+                _mm_storeu_ps(Destination + X * FLOATS_PER_TEXEL, _mm_mul_ps(Sum, Quarter));
+            }
+        }
+    }
+
+    struct FProjectionContext
+    {
+    public:
+        const FCubemapImage* Source;
+
+        /** NUM_ROW_SUMS per row of every face */
+        float* RowSums;
+    };
+
+    /**
+    * Adds the contribution of one texel to the sums, for the texels left over after the 4 wide loop
+    */
+    static void ProjectTexel(const float* inTexel, float inX, float inY, float inZ, float inSolidAngle, float* inOutSums)
+    {
+        const float Basis[NUM_SH_COEFFICIENTS] =
+        {
+            SH_Y0,
+            SH_Y1 * inY, SH_Y1 * inZ, SH_Y1 * inX,
+            SH_Y2 * inX * inY, SH_Y2 * inY * inZ, SH_Y20 * (3.0f * inZ * inZ - 1.0f), SH_Y2 * inX * inZ, SH_Y22 * (inX * inX - inY * inY)
+        };
+
+        for (uint32 i = 0; i < NUM_SH_COEFFICIENTS; ++i)
+        {
+            for (uint32 Channel = 0; Channel < 3; ++Channel)
+            {
+                inOutSums[i * 3 + Channel] += inTexel[Channel] * Basis[i] * inSolidAngle;
+            }
+        }
+
+        inOutSums[NUM_SH_COEFFICIENTS * 3] += inSolidAngle;
+    }
+
+    static void ProjectRows(const void* inContext, uint32 inBeginRow, uint32 inEndRow)
+    {
+        const FProjectionContext& Context = *(const FProjectionContext*)inContext;
+        const FCubemapImage& Source = *Context.Source;
+        const uint32 Size = Source.Size;
+
+        // Solid angle of a texel is its area (2 / Size)^2 projected on the unit sphere: dA / (1 + u^2 + v^2)^(3/2)
+        const float TexelArea = (2.0f / (float)Size) * (2.0f / (float)Size);
+
+        const __m128 One = _mm_set1_ps(1.0f);
+        const __m128 Three = _mm_set1_ps(3.0f);
+        const __m128 Step = _mm_set1_ps(2.0f / (float)Size);
+
+        for (uint32 Row = inBeginRow; Row < inEndRow; ++Row)
+        {
+            const uint32 Face = Row / Size;
+            const uint32 Y = Row % Size;
+
+            const float* Texels = Source.GetFace(0, Face) + (uint64)Y * Size * FLOATS_PER_TEXEL;
+            const float V = TexelToFace(Y, Size);
+
+            const __m128 VV = _mm_set1_ps(V);
+            const __m128 ForwardX = _mm_set1_ps(FACE_FORWARD[Face][0] + V * FACE_DOWN[Face][0]);
+            const __m128 ForwardY = _mm_set1_ps(FACE_FORWARD[Face][1] + V * FACE_DOWN[Face][1]);
+            const __m128 ForwardZ = _mm_set1_ps(FACE_FORWARD[Face][2] + V * FACE_DOWN[Face][2]);
+            const __m128 RightX = _mm_set1_ps(FACE_RIGHT[Face][0]);
+            const __m128 RightY = _mm_set1_ps(FACE_RIGHT[Face][1]);
+            const __m128 RightZ = _mm_set1_ps(FACE_RIGHT[Face][2]);
+
+            __m128 Sums[NUM_ROW_SUMS];
+            for (uint32 i = 0; i < NUM_ROW_SUMS; ++i)
+            {
+                Sums[i] = _mm_setzero_ps();
+            }
+
+            uint32 X = 0;
+            for (; X + 4 <= Size; X += 4)
+            {
+                const __m128 U = _mm_add_ps(_mm_set1_ps(TexelToFace(X, Size)), _mm_mul_ps(_mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f), Step));
+
+                // 1 / |(u, v, 1)|, it normalizes the direction and gives the solid angle
+                const __m128 InvLength = _mm_div_ps(One, _mm_sqrt_ps(_mm_add_ps(One, _mm_add_ps(_mm_mul_ps(U, U), _mm_mul_ps(VV, VV)))));
+                const __m128 SolidAngle = _mm_mul_ps(_mm_set1_ps(TexelArea), _mm_mul_ps(InvLength, _mm_mul_ps(InvLength, InvLength)));
+
+                const __m128 DX = _mm_mul_ps(_mm_add_ps(ForwardX, _mm_mul_ps(U, RightX)), InvLength);
+                const __m128 DY = _mm_mul_ps(_mm_add_ps(ForwardY, _mm_mul_ps(U, RightY)), InvLength);
+                const __m128 DZ = _mm_mul_ps(_mm_add_ps(ForwardZ, _mm_mul_ps(U, RightZ)), InvLength);
+
+                const __m128 Basis[NUM_SH_COEFFICIENTS] =
+                {
+                    _mm_set1_ps(SH_Y0),
+                    _mm_mul_ps(_mm_set1_ps(SH_Y1), DY),
+                    _mm_mul_ps(_mm_set1_ps(SH_Y1), DZ),
+                    _mm_mul_ps(_mm_set1_ps(SH_Y1), DX),
+                    _mm_mul_ps(_mm_set1_ps(SH_Y2), _mm_mul_ps(DX, DY)),
+                    _mm_mul_ps(_mm_set1_ps(SH_Y2), _mm_mul_ps(DY, DZ)),
+                    _mm_mul_ps(_mm_set1_ps(SH_Y20), _mm_sub_ps(_mm_mul_ps(Three, _mm_mul_ps(DZ, DZ)), One)),
+                    _mm_mul_ps(_mm_set1_ps(SH_Y2), _mm_mul_ps(DX, DZ)),
+                    _mm_mul_ps(_mm_set1_ps(SH_Y22), _mm_sub_ps(_mm_mul_ps(DX, DX), _mm_mul_ps(DY, DY)))
+                };
+
+                // 4 RGBA texels to one register per channel
+                __m128 R = _mm_loadu_ps(Texels + (X + 0) * FLOATS_PER_TEXEL);
+                __m128 G = _mm_loadu_ps(Texels + (X + 1) * FLOATS_PER_TEXEL);
+                __m128 B = _mm_loadu_ps(Texels + (X + 2) * FLOATS_PER_TEXEL);
+                __m128 A = _mm_loadu_ps(Texels + (X + 3) * FLOATS_PER_TEXEL);
+                _MM_TRANSPOSE4_PS(R, G, B, A);
+
+                const __m128 WeightedR = _mm_mul_ps(R, SolidAngle);
+                const __m128 WeightedG = _mm_mul_ps(G, SolidAngle);
+                const __m128 WeightedB = _mm_mul_ps(B, SolidAngle);
+
+                for (uint32 i = 0; i < NUM_SH_COEFFICIENTS; ++i)
+                {
+                    Sums[i * 3 + 0] = _mm_add_ps(Sums[i * 3 + 0], _mm_mul_ps(WeightedR, Basis[i]));
+                    Sums[i * 3 + 1] = _mm_add_ps(Sums[i * 3 + 1], _mm_mul_ps(WeightedG, Basis[i]));
+                    Sums[i * 3 + 2] = _mm_add_ps(Sums[i * 3 + 2], _mm_mul_ps(WeightedB, Basis[i]));
+                }
+                Sums[NUM_SH_COEFFICIENTS * 3] = _mm_add_ps(Sums[NUM_SH_COEFFICIENTS * 3], SolidAngle);
+            }
+
+            float* RowSums = Context.RowSums + (uint64)Row * NUM_ROW_SUMS;
+            for (uint32 i = 0; i < NUM_ROW_SUMS; ++i)
+            {
+                float Lanes[4];
+                _mm_storeu_ps(Lanes, Sums[i]);
+                RowSums[i] = (Lanes[0] + Lanes[1]) + (Lanes[2] + Lanes[3]);
+            }
+
+            for (; X < Size; ++X)
+            {
+                const float U = TexelToFace(X, Size);
+                const float InvLength = 1.0f / std::sqrt(1.0f + U * U + V * V);
+                const Vector3D Direction = TexelToDirection(Face, X, Y, Size);
+
+                ProjectTexel(Texels + X * FLOATS_PER_TEXEL, Direction.X, Direction.Y, Direction.Z, TexelArea * InvLength * InvLength * InvLength, RowSums);
+            }
+        }
+    }
+
+    struct FIrradianceContext
+    {
+    public:
+        const FSHIrradiance* Irradiance;
+        FCubemapImage* Destination;
+    };
+
+    static void EvaluateIrradianceRows(const void* inContext, uint32 inBeginRow, uint32 inEndRow)
+    {
+        const FIrradianceContext& Context = *(const FIrradianceContext*)inContext;
+        const uint32 Size = Context.Destination->Size;
+
+        for (uint32 Row = inBeginRow; Row < inEndRow; ++Row)
+        {
+            const uint32 Face = Row / Size;
+            const uint32 Y = Row % Size;
+
+            float* Texels = Context.Destination->GetFace(0, Face) + (uint64)Y * Size * FLOATS_PER_TEXEL;
+            for (uint32 X = 0; X < Size; ++X)
+            {
+                const Vector3D Irradiance = FIBLBaker::EvaluateIrradiance(*Context.Irradiance, TexelToDirection(Face, X, Y, Size));
+
+                Texels[X * FLOATS_PER_TEXEL + 0] = Irradiance.X;
+                Texels[X * FLOATS_PER_TEXEL + 1] = Irradiance.Y;
+                Texels[X * FLOATS_PER_TEXEL + 2] = Irradiance.Z;
+                Texels[X * FLOATS_PER_TEXEL + 3] = 1.0f;
+            }
+        }
+    }
+
+    struct FPrefilterContext
+    {
+    public:
+        const FCubemapImage* Source;
+        FCubemapImage* Destination;
+        uint32 MipLevel;
+        const FPrefilterSamples* Samples;
+    };
+
+    static void PrefilterRows(const void* inContext, uint32 inBeginRow, uint32 inEndRow)
+    {
+        const FPrefilterContext& Context = *(const FPrefilterContext*)inContext;
+        const FPrefilterSamples& Samples = *Context.Samples;
+        const uint32 Size = Context.Destination->GetMipSize(Context.MipLevel);
+        const uint32 NumSamples = (uint32)Samples.X.size();
+        const __m128 InvTotalWeight = _mm_set1_ps(Samples.TotalWeight > 0.0f ? 1.0f / Samples.TotalWeight : 0.0f);
+
+        for (uint32 Row = inBeginRow; Row < inEndRow; ++Row)
+        {
+            const uint32 Face = Row / Size;
+            const uint32 Y = Row % Size;
+
+            float* Texels = Context.Destination->GetFace(Context.MipLevel, Face) + (uint64)Y * Size * FLOATS_PER_TEXEL;
+            for (uint32 X = 0; X < Size; ++X)
+            {
+                const Vector3D N = TexelToDirection(Face, X, Y, Size);
+
+                // Same tangent frame as the prefilter shader
+                const Vector3D Up = std::fabs(N.Z) < 0.999f ? Vector3D(0.0f, 0.0f, 1.0f) : Vector3D(1.0f, 0.0f, 0.0f);
+                Vector3D Tangent(Up.Y * N.Z - Up.Z * N.Y, Up.Z * N.X - Up.X * N.Z, Up.X * N.Y - Up.Y * N.X);
+                const float InvTangentLength = 1.0f / std::sqrt(Tangent.X * Tangent.X + Tangent.Y * Tangent.Y + Tangent.Z * Tangent.Z);
+                Tangent = Vector3D(Tangent.X * InvTangentLength, Tangent.Y * InvTangentLength, Tangent.Z * InvTangentLength);
+                const Vector3D Bitangent(N.Y * Tangent.Z - N.Z * Tangent.Y, N.Z * Tangent.X - N.X * Tangent.Z, N.X * Tangent.Y - N.Y * Tangent.X);
+
+                __m128 Color = _mm_setzero_ps();
+                for (uint32 i = 0; i < NumSamples; i += 4)
+                {
+                    const __m128 SX = _mm_loadu_ps(&Samples.X[i]);
+                    const __m128 SY = _mm_loadu_ps(&Samples.Y[i]);
+                    const __m128 SZ = _mm_loadu_ps(&Samples.Z[i]);
+
+                    // Tangent space to world space
+                    const __m128 LX = _mm_add_ps(_mm_add_ps(_mm_mul_ps(SX, _mm_set1_ps(Tangent.X)), _mm_mul_ps(SY, _mm_set1_ps(Bitangent.X))), _mm_mul_ps(SZ, _mm_set1_ps(N.X)));
+                    const __m128 LY = _mm_add_ps(_mm_add_ps(_mm_mul_ps(SX, _mm_set1_ps(Tangent.Y)), _mm_mul_ps(SY, _mm_set1_ps(Bitangent.Y))), _mm_mul_ps(SZ, _mm_set1_ps(N.Y)));
+                    const __m128 LZ = _mm_add_ps(_mm_add_ps(_mm_mul_ps(SX, _mm_set1_ps(Tangent.Z)), _mm_mul_ps(SY, _mm_set1_ps(Bitangent.Z))), _mm_mul_ps(SZ, _mm_set1_ps(N.Z)));
+
+                    int32 Faces[4];
+                    __m128 U;
+                    __m128 V;
+                    DirectionsToFaces(LX, LY, LZ, Faces, U, V);
+
+                    float Us[4];
+                    float Vs[4];
+                    _mm_storeu_ps(Us, U);
+                    _mm_storeu_ps(Vs, V);
+
+                    for (uint32 Lane = 0; Lane < 4; ++Lane)
+                    {
+                        const __m128 Sample = SampleCubemap(*Context.Source, (uint32)Faces[Lane], Us[Lane], Vs[Lane], Samples.Lod[i + Lane]);
+                        Color = _mm_add_ps(Color, _mm_mul_ps(Sample, _mm_set1_ps(Samples.Weight[i + Lane])));
+                    }
+                }
+
+                Color = _mm_mul_ps(Color, InvTotalWeight);
+                _mm_storeu_ps(Texels + X * FLOATS_PER_TEXEL, Color);
+                Texels[X * FLOATS_PER_TEXEL + 3] = 1.0f;
+            }
+        }
+    }
+
+    /**
+    * Roughness 0 only reflects the direction itself, the source is resampled instead of importance sampled
+    */
+    static void ResampleRows(const void* inContext, uint32 inBeginRow, uint32 inEndRow)
+    {
+        const FPrefilterContext& Context = *(const FPrefilterContext*)inContext;
+        const uint32 Size = Context.Destination->GetMipSize(Context.MipLevel);
+
+        for (uint32 Row = inBeginRow; Row < inEndRow; ++Row)
+        {
+            const uint32 Face = Row / Size;
+            const uint32 Y = Row % Size;
+
+            float* Texels = Context.Destination->GetFace(Context.MipLevel, Face) + (uint64)Y * Size * FLOATS_PER_TEXEL;
+            for (uint32 X = 0; X < Size; ++X)
+            {
+                const float U = ((float)X + 0.5f) / (float)Size;
+                const float V = ((float)Y + 0.5f) / (float)Size;
+
+                // The source mip whose texels are the size of the destination ones
+                const float Lod = MathUtils::Max(std::log2((float)Context.Source->Size / (float)Size), 0.0f);
+                _mm_storeu_ps(Texels + X * FLOATS_PER_TEXEL, SampleCubemap(*Context.Source, Face, U, V, Lod));
+                Texels[X * FLOATS_PER_TEXEL + 3] = 1.0f;
+            }
+        }
+    }
+}
+
+void FCubemapImage::Allocate(uint32 inSize, uint32 inNumMipLevels)
+{
+    Size = inSize;
+    NumMipLevels = inNumMipLevels;
+    Texels.resize(GetFaceOffset(inNumMipLevels, 0));
+}
+
+uint64 FCubemapImage::GetFaceOffset(uint32 inMipLevel, uint32 inFace) const
+{
+    using namespace IBLBakerHelpers;
+
+    uint64 Offset = 0;
+    for (uint32 MipLevel = 0; MipLevel < inMipLevel; ++MipLevel)
+    {
+        Offset += (uint64)GetMipSize(MipLevel) * GetMipSize(MipLevel) * NUM_FACES * FLOATS_PER_TEXEL;
+    }
+
+    return Offset + (uint64)inFace * GetMipSize(inMipLevel) * GetMipSize(inMipLevel) * FLOATS_PER_TEXEL;
+}
+
+void FIBLBaker::GenerateMips(FCubemapImage& inOutCubemap, enki::TaskScheduler* inTaskScheduler)
+{
+    using namespace IBLBakerHelpers;
+
+    // Each mip is averaged from the previous one, so the levels are done in order and the rows of a level in parallel
+    for (uint32 MipLevel = 1; MipLevel < inOutCubemap.NumMipLevels; ++MipLevel)
+    {
+        FMipContext Context;
+        Context.Cubemap = &inOutCubemap;
+        Context.MipLevel = MipLevel;
+
+        const uint32 Size = inOutCubemap.GetMipSize(MipLevel);
+        ForEachRow(NUM_FACES * Size, Size * 4, inTaskScheduler, DownsampleRows, &Context);
+    }
+}
+
+FSHIrradiance FIBLBaker::ProjectIrradiance(const FCubemapImage& inSource, const FIBLBakeConfig& inConfig)
+{
+    using namespace IBLBakerHelpers;
+
+    VE_ASSERT(inSource.Size > 0, VE_TEXT("[IBLBaker]: Cannot project an empty cubemap..."));
+
+    const uint32 NumRows = NUM_FACES * inSource.Size;
+    std::vector<float> RowSums((uint64)NumRows * NUM_ROW_SUMS, 0.0f);
+
+    FProjectionContext Context;
+    Context.Source = &inSource;
+    Context.RowSums = RowSums.data();
+    ForEachRow(NumRows, inSource.Size, inConfig.TaskScheduler, ProjectRows, &Context);
+
+    // Rows are summed in order so the result does not depend on how the rows were split between the workers
+    double Sums[NUM_ROW_SUMS] = { };
+    for (uint32 Row = 0; Row < NumRows; ++Row)
+    {
+        for (uint32 i = 0; i < NUM_ROW_SUMS; ++i)
+        {
+            Sums[i] += RowSums[(uint64)Row * NUM_ROW_SUMS + i];
+        }
+    }
+
+    // The texel solid angles add up to about 4 PI, renormalize so a constant environment projects exactly
+    const double Normalization = Sums[NUM_SH_COEFFICIENTS * 3] > 0.0 ? 4.0 * PI / Sums[NUM_SH_COEFFICIENTS * 3] : 0.0;
+
+    FSHIrradiance Result;
+    for (uint32 i = 0; i < NUM_SH_COEFFICIENTS; ++i)
+    {
+        Result.Coefficients[i] = Vector3D((float)(Sums[i * 3 + 0] * Normalization), (float)(Sums[i * 3 + 1] * Normalization), (float)(Sums[i * 3 + 2] * Normalization));
+    }
+
+    return Result;
+}
+
+Vector3D FIBLBaker::EvaluateIrradiance(const FSHIrradiance& inIrradiance, const Vector3D& inNormal)
+{
+    using namespace IBLBakerHelpers;
+
+    const float X = inNormal.X;
+    const float Y = inNormal.Y;
+    const float Z = inNormal.Z;
+
+    const float Weights[NUM_SH_COEFFICIENTS] =
+    {
+        SH_A0 * SH_Y0,
+        SH_A1 * SH_Y1 * Y, SH_A1 * SH_Y1 * Z, SH_A1 * SH_Y1 * X,
+        SH_A2 * SH_Y2 * X * Y, SH_A2 * SH_Y2 * Y * Z, SH_A2 * SH_Y20 * (3.0f * Z * Z - 1.0f), SH_A2 * SH_Y2 * X * Z, SH_A2 * SH_Y22 * (X * X - Y * Y)
+    };
+
+    float Irradiance[3] = { };
+    for (uint32 i = 0; i < NUM_SH_COEFFICIENTS; ++i)
+    {
+        Irradiance[0] += inIrradiance.Coefficients[i].X * Weights[i];
+        Irradiance[1] += inIrradiance.Coefficients[i].Y * Weights[i];
+        Irradiance[2] += inIrradiance.Coefficients[i].Z * Weights[i];
+    }
+
+    // Ringing can push the dark side of strong lights below 0
+    return Vector3D(MathUtils::Max(Irradiance[0] / PI, 0.0f), MathUtils::Max(Irradiance[1] / PI, 0.0f), MathUtils::Max(Irradiance[2] / PI, 0.0f));
+}
+
+void FIBLBaker::BakeIrradianceMap(const FSHIrradiance& inIrradiance, FCubemapImage& outIrradianceMap, const FIBLBakeConfig& inConfig)
+{
+    using namespace IBLBakerHelpers;
+
+    outIrradianceMap.Allocate(inConfig.IrradianceSize, 1);
+
+    FIrradianceContext Context;
+    Context.Irradiance = &inIrradiance;
+    Context.Destination = &outIrradianceMap;
+    ForEachRow(NUM_FACES * inConfig.IrradianceSize, inConfig.IrradianceSize, inConfig.TaskScheduler, EvaluateIrradianceRows, &Context);
+}
+
+void FIBLBaker::BakePrefilteredMap(const FCubemapImage& inSource, FCubemapImage& outPrefilteredMap, const FIBLBakeConfig& inConfig)
+{
+    using namespace IBLBakerHelpers;
+
+    VE_ASSERT(inSource.Size > 0 && (inSource.Size >> (inSource.NumMipLevels - 1)) <= 1,
+        VE_TEXT("[IBLBaker]: The source cubemap needs its full mip chain to be prefiltered, see GenerateMips()..."));
+
+    uint32 NumMipLevels = 1;
+    while ((inConfig.PrefilterSize >> NumMipLevels) > 0)
+    {
+        NumMipLevels++;
+    }
+
+    outPrefilteredMap.Allocate(inConfig.PrefilterSize, NumMipLevels);
+
+    FPrefilterSamples Samples;
+    for (uint32 MipLevel = 0; MipLevel < NumMipLevels; ++MipLevel)
+    {
+        FPrefilterContext Context;
+        Context.Source = &inSource;
+        Context.Destination = &outPrefilteredMap;
+        Context.MipLevel = MipLevel;
+        Context.Samples = &Samples;
+
+        const uint32 Size = outPrefilteredMap.GetMipSize(MipLevel);
+        const float Roughness = NumMipLevels > 1 ? (float)MipLevel / (float)(NumMipLevels - 1) : 0.0f;
+        if (Roughness == 0.0f)
+        {
+            ForEachRow(NUM_FACES * Size, Size, inConfig.TaskScheduler, ResampleRows, &Context);
+            continue;
+        }
+
+        MakePrefilterSamples(Roughness, inConfig.NumPrefilterSamples, inSource.Size, Samples);
+        ForEachRow(NUM_FACES * Size, Size * inConfig.NumPrefilterSamples, inConfig.TaskScheduler, PrefilterRows, &Context);
+    }
+}
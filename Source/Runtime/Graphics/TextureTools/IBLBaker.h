@@ -0,0 +1,141 @@
+/**
+* This file is part of the "Vrixic Engine" project (Copyright (c) 2022-2023 by Vrij Patel)
+* See "LICENSE.txt" for license information.
+*/
+
+#pragma once
+#include <Core/Core.h>
+#include <Misc/Defines/GenericDefines.h>
+#include <Runtime/Core/Math/Vector3D.h>
+
+#include <string>
+#include <vector>
+
+namespace enki
+{
+    class TaskScheduler;
+}
+
+struct FIBLBakeConfig
+{
+public:
+    /** Size of a face of the irradiance map, irradiance is smooth so a few texels are enough */
+    uint32 IrradianceSize = 32;
+
+    /** Size of a face of mip 0 of the prefiltered map, the roughness goes from 0 at mip 0 to 1 at the 1x1 mip */
+    uint32 PrefilterSize = 512;
+
+    /** GGX samples per prefiltered texel, each one reads the source mip matching its footprint so a few dozen are enough */
+    uint32 NumPrefilterSamples = 64;
+
+    /** Zstd level the ktx files are supercompressed with, 0 writes them uncompressed */
+    uint32 SupercompressionLevel = 0;
+
+    /** Optional, when set the rows of the faces are baked across the worker threads */
+    enki::TaskScheduler* TaskScheduler = nullptr;
+};
+
+/**
+* Irradiance of an environment as order 2 spherical harmonics, 9 rgb coefficients
+*/
+struct FSHIrradiance
+{
+public:
+    Vector3D Coefficients[9];
+};
+
+/**
+* An RGBA32F cubemap with its mips on the cpu
+*
+* Texels are stored mip after mip, the 6 faces of a mip one after the other (+X, -X, +Y, -Y, +Z, -Z), rows top to bottom:
+*   mip 0 (6 * Size * Size) | mip 1 (6 * (Size >> 1) * (Size >> 1)) | ...
+*/
+struct VRIXIC_API FCubemapImage
+{
+public:
+    void Allocate(uint32 inSize, uint32 inNumMipLevels);
+
+    /**
+    * @returns uint64 index (in floats) of the first texel of a face
+    */
+    uint64 GetFaceOffset(uint32 inMipLevel, uint32 inFace) const;
+
+    inline uint32 GetMipSize(uint32 inMipLevel) const
+    {
+        return Size >> inMipLevel > 0 ? Size >> inMipLevel : 1;
+    }
+
+    inline float* GetFace(uint32 inMipLevel, uint32 inFace)
+    {
+        return Texels.data() + GetFaceOffset(inMipLevel, inFace);
+    }
+
+    inline const float* GetFace(uint32 inMipLevel, uint32 inFace) const
+    {
+        return Texels.data() + GetFaceOffset(inMipLevel, inFace);
+    }
+
+public:
+    uint32 Size = 0;
+    uint32 NumMipLevels = 0;
+    std::vector<float> Texels;
+};
+
+/**
+* Bakes the image based lighting maps of an environment cubemap on the cpu, the gpu does not have to be up and nothing is read back
+*
+* Irradiance: the environment is projected onto order 2 spherical harmonics (weighted by the solid angle of every texel)
+*   and the irradiance map is evaluated from the 9 coefficients.
+* Prefiltered map: every texel of every mip averages GGX importance samples around its direction, the same estimator the
+*   prefilter shader uses. Each sample reads the source mip whose texels cover its solid angle, so few samples are needed.
+* Rows of the faces are processed across the task scheduler workers, texels are processed 4 channels (or 4 samples) per SSE register.
+* Directions follow the Vulkan cubemap face layout, the maps sample the same as the source they were baked from
+*/
+struct VRIXIC_API FIBLBaker
+{
+public:
+    /**
+    * Loads an 8 bit RGBA or BGRA cubemap ktx file, the mips are generated from mip 0 with a box filter
+    *
+    * @returns bool false if the file cannot be read or is not a cubemap in a supported format
+    */
+    static bool LoadCubemapKtx(const std::string& inFilePath, FCubemapImage& outCubemap, enki::TaskScheduler* inTaskScheduler = nullptr);
+
+    /**
+    * Writes a cubemap out as a R8G8B8A8 ktx file, values are clamped to [0, 1]
+    *
+    * @returns bool false if the ktx texture could not be created or written
+    */
+    static bool WriteCubemapKtx(const std::string& inFilePath, const FCubemapImage& inCubemap, uint32 inSupercompressionLevel);
+
+    /**
+    * Fills in mip 1 and down by averaging 2x2 texels of the mip above
+    */
+    static void GenerateMips(FCubemapImage& inOutCubemap, enki::TaskScheduler* inTaskScheduler = nullptr);
+
+    static FSHIrradiance ProjectIrradiance(const FCubemapImage& inSource, const FIBLBakeConfig& inConfig);
+
+    /**
+    * @returns Vector3D irradiance divided by PI, what a white lambertian surface facing inNormal reflects
+    */
+    static Vector3D EvaluateIrradiance(const FSHIrradiance& inIrradiance, const Vector3D& inNormal);
+
+    /**
+    * @param outIrradianceMap IrradianceSize cubemap with a single mip
+    */
+    static void BakeIrradianceMap(const FSHIrradiance& inIrradiance, FCubemapImage& outIrradianceMap, const FIBLBakeConfig& inConfig);
+
+    /**
+    * @param inSource needs its full mip chain
+    * @param outPrefilteredMap PrefilterSize cubemap with the full mip chain
+    */
+    static void BakePrefilteredMap(const FCubemapImage& inSource, FCubemapImage& outPrefilteredMap, const FIBLBakeConfig& inConfig);
+
+    /**
+    * Loads the environment cubemap, bakes the map and writes it out, what the renderer and the offline tool call
+    *
+    * @returns bool false if the source could not be loaded or the map could not be written
+    */
+    static bool BakeIrradianceMapFile(const std::string& inSourcePath, const std::string& inFilePath, const FIBLBakeConfig& inConfig);
+    static bool BakePrefilteredMapFile(const std::string& inSourcePath, const std::string& inFilePath, const FIBLBakeConfig& inConfig);
+};
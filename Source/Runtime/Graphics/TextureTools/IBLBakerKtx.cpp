@@ -0,0 +1,188 @@
+/**
+* This file is part of the "Vrixic Engine" project (Copyright (c) 2022-2023 by Vrij Patel)
+* See "LICENSE.txt" for license information.
+*/
+
+/**
+* The ktx loading and writing of FIBLBaker lives apart from the bakers, it needs libktx, the file reader and the vulkan format table
+*   while the bakers only need the cpu (and build into the tests without any of them)
+*/
+
+#include "IBLBaker.h"
+#include <Misc/Defines/StringDefines.h>
+#include <Runtime/Core/Math/VrixicMathHelper.h>
+#include <Runtime/File/FileReader.h>
+#include <Runtime/Graphics/Vulkan/VulkanTypeConverter.h>
+
+#include <External/ktx/Includes/ktx.h>
+#include <External/ktx/Includes/ktxvulkan.h>
+
+#include <cmath>
+
+static const uint32 NUM_CUBEMAP_FACES = 6;
+
+bool FIBLBaker::LoadCubemapKtx(const std::string& inFilePath, FCubemapImage& outCubemap, enki::TaskScheduler* inTaskScheduler)
+{
+    FFileReaderConfig ReaderConfig = { };
+    ReaderConfig.Mode = EFileReadMode::MemoryMapped;
+    ReaderConfig.AccessHint = EFileAccessHint::Sequential;
+
+    FileReader Reader(inFilePath, ReaderConfig);
+    if (!Reader.IsOpen())
+    {
+        VE_CORE_LOG_ERROR(VE_TEXT("[IBLBaker]: Could not open {0}"), inFilePath);
+        return false;
+    }
+
+    FFileSpan FileSpan = Reader.GetSpan();
+
+    ktxTexture* KtxTextureHandle = nullptr;
+    KTX_error_code KtxResult = ktxTexture_CreateFromMemory(FileSpan.Data, FileSpan.Size, KTX_TEXTURE_CREATE_LOAD_IMAGE_DATA_BIT, &KtxTextureHandle);
+    Reader.Close();
+
+    if (KtxResult != KTX_SUCCESS)
+    {
+        VE_CORE_LOG_ERROR(VE_TEXT("[IBLBaker]: Failed to load ktx texture: {0}, error: {1}"), inFilePath, ktxErrorString(KtxResult));
+        return false;
+    }
+
+    const VkFormat Format = ktxTexture_GetVkFormat(KtxTextureHandle);
+    const bool bIsBGRA = Format == VulkanTypeConverter::Convert(EPixelFormat::BGRA8UNorm) || Format == VulkanTypeConverter::Convert(EPixelFormat::BGRA8UNorm_sRGB);
+    const bool bIsRGBA = Format == VulkanTypeConverter::Convert(EPixelFormat::RGBA8UNorm) || Format == VulkanTypeConverter::Convert(EPixelFormat::RGBA8UNorm_sRGB);
+    const bool bIsSRGB = Format == VulkanTypeConverter::Convert(EPixelFormat::BGRA8UNorm_sRGB) || Format == VulkanTypeConverter::Convert(EPixelFormat::RGBA8UNorm_sRGB);
+
+    if (!KtxTextureHandle->isCubemap || KtxTextureHandle->baseWidth != KtxTextureHandle->baseHeight || (!bIsBGRA && !bIsRGBA))
+    {
+        VE_CORE_LOG_ERROR(VE_TEXT("[IBLBaker]: {0} is not an 8 bit rgba cubemap"), inFilePath);
+        ktxTexture_Destroy(KtxTextureHandle);
+        return false;
+    }
+
+    const uint32 Size = KtxTextureHandle->baseWidth;
+    uint32 NumMipLevels = 1;
+    while ((Size >> NumMipLevels) > 0)
+    {
+        NumMipLevels++;
+    }
+
+    outCubemap.Allocate(Size, NumMipLevels);
+
+    // The gpu decodes sRGB when sampling, the bakers work on what the shaders see
+    float UNormToFloat[256];
+    for (uint32 i = 0; i < 256; ++i)
+    {
+        const float Value = (float)i / 255.0f;
+        UNormToFloat[i] = !bIsSRGB ? Value : (Value <= 0.04045f ? Value / 12.92f : std::pow((Value + 0.055f) / 1.055f, 2.4f));
+    }
+
+    const uint8* Data = ktxTexture_GetData(KtxTextureHandle);
+    for (uint32 Face = 0; Face < NUM_CUBEMAP_FACES; ++Face)
+    {
+        ktx_size_t ImageOffset = 0;
+        ktxTexture_GetImageOffset(KtxTextureHandle, 0, 0, Face, &ImageOffset);
+
+        const uint8* Source = Data + ImageOffset;
+        float* Destination = outCubemap.GetFace(0, Face);
+        for (uint64 Texel = 0; Texel < (uint64)Size * Size; ++Texel)
+        {
+            Destination[Texel * 4 + 0] = UNormToFloat[Source[Texel * 4 + (bIsBGRA ? 2 : 0)]];
+            Destination[Texel * 4 + 1] = UNormToFloat[Source[Texel * 4 + 1]];
+            Destination[Texel * 4 + 2] = UNormToFloat[Source[Texel * 4 + (bIsBGRA ? 0 : 2)]];
+            Destination[Texel * 4 + 3] = (float)Source[Texel * 4 + 3] / 255.0f;
+        }
+    }
+
+    ktxTexture_Destroy(KtxTextureHandle);
+
+    GenerateMips(outCubemap, inTaskScheduler);
+    return true;
+}
+
+bool FIBLBaker::WriteCubemapKtx(const std::string& inFilePath, const FCubemapImage& inCubemap, uint32 inSupercompressionLevel)
+{
+    ktxTextureCreateInfo KtxTextureCreateInfo = { };
+    KtxTextureCreateInfo.vkFormat = VulkanTypeConverter::Convert(EPixelFormat::RGBA8UNorm);
+    KtxTextureCreateInfo.baseWidth = inCubemap.Size;
+    KtxTextureCreateInfo.baseHeight = inCubemap.Size;
+    KtxTextureCreateInfo.baseDepth = 1;
+    KtxTextureCreateInfo.numDimensions = 2;
+    KtxTextureCreateInfo.numLevels = inCubemap.NumMipLevels;
+    KtxTextureCreateInfo.numLayers = 1;
+    KtxTextureCreateInfo.numFaces = NUM_CUBEMAP_FACES;
+    KtxTextureCreateInfo.isArray = KTX_FALSE;
+    KtxTextureCreateInfo.generateMipmaps = KTX_FALSE;
+
+    ktxTexture2* KtxTextureHandle = nullptr;
+    KTX_error_code KtxResult = ktxTexture2_Create(&KtxTextureCreateInfo, KTX_TEXTURE_CREATE_ALLOC_STORAGE, &KtxTextureHandle);
+    if (KtxResult != KTX_SUCCESS)
+    {
+        VE_CORE_LOG_ERROR(VE_TEXT("[IBLBaker]: Failed to create a ktx texture for {0}, error: {1}"), inFilePath, ktxErrorString(KtxResult));
+        return false;
+    }
+
+    std::vector<uint8> FaceTexels;
+    for (uint32 MipLevel = 0; MipLevel < inCubemap.NumMipLevels && KtxResult == KTX_SUCCESS; ++MipLevel)
+    {
+        const uint64 NumTexels = (uint64)inCubemap.GetMipSize(MipLevel) * inCubemap.GetMipSize(MipLevel);
+        FaceTexels.resize(NumTexels * 4);
+
+        for (uint32 Face = 0; Face < NUM_CUBEMAP_FACES && KtxResult == KTX_SUCCESS; ++Face)
+        {
+            const float* Texels = inCubemap.GetFace(MipLevel, Face);
+            for (uint64 i = 0; i < NumTexels * 4; ++i)
+            {
+                FaceTexels[i] = (uint8)(MathUtils::Clamp(0.0f, 1.0f, Texels[i]) * 255.0f + 0.5f);
+            }
+
+            KtxResult = ktxTexture_SetImageFromMemory(ktxTexture(KtxTextureHandle), MipLevel, 0, Face, FaceTexels.data(), FaceTexels.size());
+        }
+    }
+
+    if (KtxResult == KTX_SUCCESS && inSupercompressionLevel > 0)
+    {
+        KtxResult = ktxTexture2_DeflateZstd(KtxTextureHandle, inSupercompressionLevel);
+    }
+
+    if (KtxResult == KTX_SUCCESS)
+    {
+        KtxResult = ktxTexture_WriteToNamedFile(ktxTexture(KtxTextureHandle), inFilePath.c_str());
+    }
+
+    ktxTexture_Destroy(ktxTexture(KtxTextureHandle));
+
+    if (KtxResult != KTX_SUCCESS)
+    {
+        VE_CORE_LOG_ERROR(VE_TEXT("[IBLBaker]: Failed to write {0}, error: {1}"), inFilePath, ktxErrorString(KtxResult));
+        return false;
+    }
+
+    return true;
+}
+
+bool FIBLBaker::BakeIrradianceMapFile(const std::string& inSourcePath, const std::string& inFilePath, const FIBLBakeConfig& inConfig)
+{
+    FCubemapImage Source;
+    if (!LoadCubemapKtx(inSourcePath, Source, inConfig.TaskScheduler))
+    {
+        return false;
+    }
+
+    FCubemapImage IrradianceMap;
+    BakeIrradianceMap(ProjectIrradiance(Source, inConfig), IrradianceMap, inConfig);
+
+    return WriteCubemapKtx(inFilePath, IrradianceMap, inConfig.SupercompressionLevel);
+}
+
+bool FIBLBaker::BakePrefilteredMapFile(const std::string& inSourcePath, const std::string& inFilePath, const FIBLBakeConfig& inConfig)
+{
+    FCubemapImage Source;
+    if (!LoadCubemapKtx(inSourcePath, Source, inConfig.TaskScheduler))
+    {
+        return false;
+    }
+
+    FCubemapImage PrefilteredMap;
+    BakePrefilteredMap(Source, PrefilteredMap, inConfig);
+
+    return WriteCubemapKtx(inFilePath, PrefilteredMap, inConfig.SupercompressionLevel);
+}
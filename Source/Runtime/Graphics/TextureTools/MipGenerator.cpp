@@ -0,0 +1,458 @@
+/**
+* This file is part of the "Vrixic Engine" project (Copyright (c) 2022-2023 by Vrij Patel)
+* See "LICENSE.txt" for license information.
+*/
+
+#include "MipGenerator.h"
+#include <Misc/Assert.h>
+#include <Misc/Defines/StringDefines.h>
+#include <Runtime/Core/Math/VrixicMathHelper.h>
+
+#include <External/enkiTS/Includes/TaskScheduler.h>
+
+#include <emmintrin.h>
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace MipGeneratorHelpers
+{
+    static const uint32 BYTES_PER_TEXEL = 4;
+
+    /** Kaiser filter taps per axis, for a 2:1 downsample the taps are centered between the two source texels */
+    static const uint32 KAISER_NUM_TAPS = 8;
+
+    /** Roughly how many destination texels each worker task filters */
+    static const uint32 TEXELS_PER_TASK = 64 * 1024;
+
+    /**
+    * Lookup tables to move between 8-bit texels and linear floats
+    */
+    struct FColorTables
+    {
+    public:
+        static const uint32 LINEAR_TO_SRGB_TABLE_SIZE = 4096;
+
+        float UNormToFloat[256];
+        float SRGBToLinear[256];
+        uint8 LinearToSRGB[LINEAR_TO_SRGB_TABLE_SIZE];
+
+        float KaiserWeights[KAISER_NUM_TAPS];
+
+    public:
+        static const FColorTables& Get()
+        {
+            static FColorTables Tables;
+            return Tables;
+        }
+
+    private:
+        FColorTables()
+        {
+            for (uint32 i = 0; i < 256; ++i)
+            {
+                const float Value = i / 255.0f;
+                UNormToFloat[i] = Value;
+                SRGBToLinear[i] = Value <= 0.04045f ? Value / 12.92f : powf((Value + 0.055f) / 1.055f, 2.4f);
+            }
+
+            for (uint32 i = 0; i < LINEAR_TO_SRGB_TABLE_SIZE; ++i)
+            {
+                const float Value = i / float(LINEAR_TO_SRGB_TABLE_SIZE - 1);
+                const float Encoded = Value <= 0.0031308f ? Value * 12.92f : 1.055f * powf(Value, 1.0f / 2.4f) - 0.055f;
+                LinearToSRGB[i] = uint8(Encoded * 255.0f + 0.5f);
+            }
+
+            // Kaiser windowed sinc, 2 destination texels wide with alpha = 4
+            const float Width = 2.0f;
+            const float Alpha = 4.0f;
+            float WeightSum = 0.0f;
+            for (uint32 i = 0; i < KAISER_NUM_TAPS; ++i)
+            {
+                // Distance in destination texels from the destination texel center
+                const float Distance = ((float)i - (KAISER_NUM_TAPS / 2) + 0.5f) * 0.5f;
+                const float Ratio = Distance / Width;
+
+                KaiserWeights[i] = Sinc(Distance) * BesselI0(Alpha * sqrtf(1.0f - Ratio * Ratio)) / BesselI0(Alpha);
+                WeightSum += KaiserWeights[i];
+            }
+
+            for (uint32 i = 0; i < KAISER_NUM_TAPS; ++i)
+            {
+                KaiserWeights[i] /= WeightSum;
+            }
+        }
+
+        static float Sinc(float inX)
+        {
+            const float PiX = PI * inX;
+            return fabsf(inX) < 1e-4f ? 1.0f : sinf(PiX) / PiX;
+        }
+
+        /** Modified bessel function of the first kind, order 0 */
+        static float BesselI0(float inX)
+        {
+            float Sum = 1.0f;
+            float Term = 1.0f;
+            const float HalfX = inX * 0.5f;
+            for (uint32 k = 1; k < 32; ++k)
+            {
+                Term *= HalfX / k;
+                Sum += Term * Term;
+            }
+            return Sum;
+        }
+    };
+
+    inline __m128 LoadTexel(const uint8* inTexel, const float* inColorTable, const FColorTables& inTables)
+    {
+        return _mm_set_ps(inTables.UNormToFloat[inTexel[3]], inColorTable[inTexel[2]], inColorTable[inTexel[1]], inColorTable[inTexel[0]]);
+    }
+
+    inline void StoreTexel(uint8* outTexel, __m128 inColor, bool inIsSRGB, const FColorTables& inTables)
+    {
+        inColor = _mm_min_ps(_mm_max_ps(inColor, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+
+        // Rounds to nearest, then packs the 4 channels down to bytes
+        __m128i Texel = _mm_cvtps_epi32(_mm_mul_ps(inColor, _mm_set1_ps(255.0f)));
+        Texel = _mm_packs_epi32(Texel, Texel);
+        Texel = _mm_packus_epi16(Texel, Texel);
+
+        const int32 PackedTexel = _mm_cvtsi128_si32(Texel);
+        memcpy(outTexel, &PackedTexel, BYTES_PER_TEXEL);
+
+        if (inIsSRGB)
+        {
+            alignas(16) int32 Indices[4];
+            _mm_store_si128((__m128i*)Indices, _mm_cvtps_epi32(_mm_mul_ps(inColor, _mm_set1_ps(FColorTables::LINEAR_TO_SRGB_TABLE_SIZE - 1.0f))));
+
+            outTexel[0] = inTables.LinearToSRGB[Indices[0]];
+            outTexel[1] = inTables.LinearToSRGB[Indices[1]];
+            outTexel[2] = inTables.LinearToSRGB[Indices[2]];
+        }
+    }
+
+    /**
+    * Describes one downsample from the source mip into the destination mip
+    */
+    struct FMipLevelInfo
+    {
+        const uint8* Source;
+        uint8* Destination;
+
+        uint32 SourceWidth;
+        uint32 SourceHeight;
+        uint32 DestinationWidth;
+        uint32 DestinationHeight;
+
+        const FMipGenerationConfig* Config;
+    };
+
+    /**
+    * 2x2 average on bytes, no color space conversion; two destination texels per iteration
+    */
+    static void BoxFilterRowsUNorm(const FMipLevelInfo& inLevel, uint32 inRowStart, uint32 inRowEnd)
+    {
+        const __m128i Zero = _mm_setzero_si128();
+        const __m128i Rounding = _mm_set1_epi16(2);
+
+        for (uint32 y = inRowStart; y < inRowEnd; ++y)
+        {
+            const uint32 SourceY0 = MathUtils::Min(y * 2, inLevel.SourceHeight - 1);
+            const uint32 SourceY1 = MathUtils::Min(y * 2 + 1, inLevel.SourceHeight - 1);
+
+            const uint8* Row0 = inLevel.Source + (uint64)SourceY0 * inLevel.SourceWidth * BYTES_PER_TEXEL;
+            const uint8* Row1 = inLevel.Source + (uint64)SourceY1 * inLevel.SourceWidth * BYTES_PER_TEXEL;
+            uint8* DestinationRow = inLevel.Destination + (uint64)y * inLevel.DestinationWidth * BYTES_PER_TEXEL;
+
+            uint32 x = 0;
+            for (; x + 1 < inLevel.DestinationWidth && (x * 2 + 3) < inLevel.SourceWidth; x += 2)
+            {
+                // 4 source texels from each row
+                const __m128i Texels0 = _mm_loadu_si128((const __m128i*)(Row0 + x * 2 * BYTES_PER_TEXEL));
+                const __m128i Texels1 = _mm_loadu_si128((const __m128i*)(Row1 + x * 2 * BYTES_PER_TEXEL));
+
+                // Vertical sum in 16-bit
+                const __m128i SumLow = _mm_add_epi16(_mm_unpacklo_epi8(Texels0, Zero), _mm_unpacklo_epi8(Texels1, Zero));
+                const __m128i SumHigh = _mm_add_epi16(_mm_unpackhi_epi8(Texels0, Zero), _mm_unpackhi_epi8(Texels1, Zero));
+
+                // Horizontal sum of each texel pair
+                __m128i Sum = _mm_add_epi16(_mm_unpacklo_epi64(SumLow, SumHigh), _mm_unpackhi_epi64(SumLow, SumHigh));
+                Sum = _mm_srli_epi16(_mm_add_epi16(Sum, Rounding), 2);
+
+                _mm_storel_epi64((__m128i*)(DestinationRow + x * BYTES_PER_TEXEL), _mm_packus_epi16(Sum, Zero));
+            }
+
+            // Odd widths and the right edge
+            for (; x < inLevel.DestinationWidth; ++x)
+            {
+                const uint32 SourceX0 = MathUtils::Min(x * 2, inLevel.SourceWidth - 1) * BYTES_PER_TEXEL;
+                const uint32 SourceX1 = MathUtils::Min(x * 2 + 1, inLevel.SourceWidth - 1) * BYTES_PER_TEXEL;
+
+                for (uint32 c = 0; c < BYTES_PER_TEXEL; ++c)
+                {
+                    DestinationRow[x * BYTES_PER_TEXEL + c] = uint8((Row0[SourceX0 + c] + Row0[SourceX1 + c] + Row1[SourceX0 + c] + Row1[SourceX1 + c] + 2) >> 2);
+                }
+            }
+        }
+    }
+
+    /**
+    * 2x2 average in linear space
+    */
+    static void BoxFilterRowsSRGB(const FMipLevelInfo& inLevel, uint32 inRowStart, uint32 inRowEnd)
+    {
+        const FColorTables& Tables = FColorTables::Get();
+        const __m128 Quarter = _mm_set1_ps(0.25f);
+
+        for (uint32 y = inRowStart; y < inRowEnd; ++y)
+        {
+            const uint32 SourceY0 = MathUtils::Min(y * 2, inLevel.SourceHeight - 1);
+            const uint32 SourceY1 = MathUtils::Min(y * 2 + 1, inLevel.SourceHeight - 1);
+
+            const uint8* Row0 = inLevel.Source + (uint64)SourceY0 * inLevel.SourceWidth * BYTES_PER_TEXEL;
+            const uint8* Row1 = inLevel.Source + (uint64)SourceY1 * inLevel.SourceWidth * BYTES_PER_TEXEL;
+            uint8* DestinationRow = inLevel.Destination + (uint64)y * inLevel.DestinationWidth * BYTES_PER_TEXEL;
+
+            for (uint32 x = 0; x < inLevel.DestinationWidth; ++x)
+            {
+                const uint32 SourceX0 = MathUtils::Min(x * 2, inLevel.SourceWidth - 1) * BYTES_PER_TEXEL;
+                const uint32 SourceX1 = MathUtils::Min(x * 2 + 1, inLevel.SourceWidth - 1) * BYTES_PER_TEXEL;
+
+                __m128 Sum = LoadTexel(Row0 + SourceX0, Tables.SRGBToLinear, Tables);
+                Sum = _mm_add_ps(Sum, LoadTexel(Row0 + SourceX1, Tables.SRGBToLinear, Tables));
+                Sum = _mm_add_ps(Sum, LoadTexel(Row1 + SourceX0, Tables.SRGBToLinear, Tables));
+                Sum = _mm_add_ps(Sum, LoadTexel(Row1 + SourceX1, Tables.SRGBToLinear, Tables));
+
+                StoreTexel(DestinationRow + x * BYTES_PER_TEXEL, _mm_mul_ps(Sum, Quarter), true, Tables);
+            }
+        }
+    }
+
+    /**
+    * Separable kaiser filter, each destination row is filtered vertically into a float row then horizontally
+    */
+    static void KaiserFilterRows(const FMipLevelInfo& inLevel, uint32 inRowStart, uint32 inRowEnd)
+    {
+        const FColorTables& Tables = FColorTables::Get();
+        const float* ColorTable = inLevel.Config->bIsSRGB ? Tables.SRGBToLinear : Tables.UNormToFloat;
+
+        const int32 HalfTaps = KAISER_NUM_TAPS / 2;
+        const int32 SourceWidth = inLevel.SourceWidth;
+        const int32 SourceHeight = inLevel.SourceHeight;
+
+        __m128 Weights[KAISER_NUM_TAPS];
+        for (uint32 i = 0; i < KAISER_NUM_TAPS; ++i)
+        {
+            Weights[i] = _mm_set1_ps(Tables.KaiserWeights[i]);
+        }
+
+        std::vector<float> FilteredRow(inLevel.SourceWidth * BYTES_PER_TEXEL);
+
+        for (uint32 y = inRowStart; y < inRowEnd; ++y)
+        {
+            const uint8* SourceRows[KAISER_NUM_TAPS];
+            for (int32 i = 0; i < (int32)KAISER_NUM_TAPS; ++i)
+            {
+                const int32 SourceY = MathUtils::Min(MathUtils::Max((int32)y * 2 - HalfTaps + 1 + i, 0), SourceHeight - 1);
+                SourceRows[i] = inLevel.Source + (uint64)SourceY * inLevel.SourceWidth * BYTES_PER_TEXEL;
+            }
+
+            // Vertical pass
+            for (int32 x = 0; x < SourceWidth; ++x)
+            {
+                __m128 Sum = _mm_setzero_ps();
+                for (uint32 i = 0; i < KAISER_NUM_TAPS; ++i)
+                {
+                    Sum = _mm_add_ps(Sum, _mm_mul_ps(Weights[i], LoadTexel(SourceRows[i] + x * BYTES_PER_TEXEL, ColorTable, Tables)));
+                }
+                _mm_storeu_ps(&FilteredRow[x * BYTES_PER_TEXEL], Sum);
+            }
+
+            // Horizontal pass
+            uint8* DestinationRow = inLevel.Destination + (uint64)y * inLevel.DestinationWidth * BYTES_PER_TEXEL;
+            for (int32 x = 0; x < (int32)inLevel.DestinationWidth; ++x)
+            {
+                __m128 Sum = _mm_setzero_ps();
+                for (int32 i = 0; i < (int32)KAISER_NUM_TAPS; ++i)
+                {
+                    const int32 SourceX = MathUtils::Min(MathUtils::Max(x * 2 - HalfTaps + 1 + i, 0), SourceWidth - 1);
+                    Sum = _mm_add_ps(Sum, _mm_mul_ps(Weights[i], _mm_loadu_ps(&FilteredRow[SourceX * BYTES_PER_TEXEL])));
+                }
+
+                StoreTexel(DestinationRow + x * BYTES_PER_TEXEL, Sum, inLevel.Config->bIsSRGB, Tables);
+            }
+        }
+    }
+
+    static void FilterRows(const FMipLevelInfo& inLevel, uint32 inRowStart, uint32 inRowEnd)
+    {
+        if (inLevel.Config->Filter == EMipFilter::Kaiser)
+        {
+            KaiserFilterRows(inLevel, inRowStart, inRowEnd);
+        }
+        else if (inLevel.Config->bIsSRGB)
+        {
+            BoxFilterRowsSRGB(inLevel, inRowStart, inRowEnd);
+        }
+        else
+        {
+            BoxFilterRowsUNorm(inLevel, inRowStart, inRowEnd);
+        }
+    }
+
+    /**
+    * Filters the rows of one mip level across the task scheduler workers
+    */
+    struct FMipLevelTaskSet : enki::ITaskSet
+    {
+        void ExecuteRange(enki::TaskSetPartition inRange, uint32_t /*inThreadNum*/) override
+        {
+            FilterRows(Level, inRange.start, inRange.end);
+        }
+
+        FMipLevelInfo Level;
+    };
+
+    /**
+    * @returns float fraction of texels whose scaled alpha passes the alpha test
+    */
+    static float ComputeAlphaCoverage(const uint8* inTexels, uint64 inNumTexels, float inAlphaCutoff, float inAlphaScale)
+    {
+        // alpha * scale > cutoff * 255  <=>  alpha > (cutoff * 255) / scale
+        const float Threshold = (inAlphaCutoff * 255.0f) / MathUtils::Max(inAlphaScale, 1e-6f);
+
+        uint64 NumCovered = 0;
+        for (uint64 i = 0; i < inNumTexels; ++i)
+        {
+            NumCovered += inTexels[i * BYTES_PER_TEXEL + 3] > Threshold ? 1 : 0;
+        }
+
+        return (float)NumCovered / (float)inNumTexels;
+    }
+
+    /**
+    * Finds the alpha scale that matches the target coverage then applies it to the mip
+    */
+    static void ScaleAlphaToCoverage(uint8* inOutTexels, uint64 inNumTexels, float inTargetCoverage, float inAlphaCutoff)
+    {
+        float MinScale = 0.0f;
+        float MaxScale = 4.0f;
+        float Scale = 1.0f;
+
+        // Small mips have few texels so coverage moves in steps and the search may never land on the target, keep the closest scale seen
+        float BestScale = Scale;
+        float BestError = 2.0f;
+
+        for (uint32 i = 0; i < 10; ++i)
+        {
+            const float Coverage = ComputeAlphaCoverage(inOutTexels, inNumTexels, inAlphaCutoff, Scale);
+            if (fabsf(Coverage - inTargetCoverage) < BestError)
+            {
+                BestScale = Scale;
+                BestError = fabsf(Coverage - inTargetCoverage);
+            }
+
+            if (Coverage < inTargetCoverage)
+            {
+                MinScale = Scale;
+            }
+            else if (Coverage > inTargetCoverage)
+            {
+                MaxScale = Scale;
+            }
+            else
+            {
+                break;
+            }
+
+            Scale = (MinScale + MaxScale) * 0.5f;
+        }
+
+        Scale = BestScale;
+        for (uint64 i = 0; i < inNumTexels; ++i)
+        {
+            uint8& Alpha = inOutTexels[i * BYTES_PER_TEXEL + 3];
+            Alpha = (uint8)MathUtils::Min(Alpha * Scale + 0.5f, 255.0f);
+        }
+    }
+}
+
+uint32 FMipGenerator::GetNumMipLevels(uint32 inWidth, uint32 inHeight, uint32 inMaxMipLevels)
+{
+    uint32 NumMipLevels = 1;
+    uint32 LargestExtent = MathUtils::Max(inWidth, inHeight);
+    while (LargestExtent > 1)
+    {
+        LargestExtent >>= 1;
+        NumMipLevels++;
+    }
+
+    return inMaxMipLevels != 0 ? MathUtils::Min(NumMipLevels, inMaxMipLevels) : NumMipLevels;
+}
+
+uint64 FMipGenerator::GetMipChainSize(uint32 inWidth, uint32 inHeight, uint32 inNumMipLevels)
+{
+    uint64 Size = 0;
+    for (uint32 i = 0; i < inNumMipLevels; ++i)
+    {
+        Size += (uint64)MathUtils::Max(inWidth >> i, 1u) * MathUtils::Max(inHeight >> i, 1u) * MipGeneratorHelpers::BYTES_PER_TEXEL;
+    }
+
+    return Size;
+}
+
+uint32 FMipGenerator::Generate(uint8* inOutMipChain, uint32 inWidth, uint32 inHeight, const FMipGenerationConfig& inConfig)
+{
+    using namespace MipGeneratorHelpers;
+
+    VE_ASSERT(inOutMipChain != nullptr, VE_TEXT("[MipGenerator]: Cannot generate mips for a null texture..."));
+
+    const uint32 NumMipLevels = GetNumMipLevels(inWidth, inHeight, inConfig.MaxMipLevels);
+
+    float TargetCoverage = 0.0f;
+    if (inConfig.bPreserveAlphaCoverage)
+    {
+        TargetCoverage = ComputeAlphaCoverage(inOutMipChain, (uint64)inWidth * inHeight, inConfig.AlphaCutoff, 1.0f);
+    }
+
+    FMipLevelTaskSet TaskSet;
+    TaskSet.Level.Config = &inConfig;
+    TaskSet.Level.Source = inOutMipChain;
+    TaskSet.Level.SourceWidth = inWidth;
+    TaskSet.Level.SourceHeight = inHeight;
+
+    // Each mip is filtered from the previous one, so the levels are done in order and the rows of a level in parallel
+    for (uint32 MipLevel = 1; MipLevel < NumMipLevels; ++MipLevel)
+    {
+        FMipLevelInfo& Level = TaskSet.Level;
+        Level.Destination = const_cast<uint8*>(Level.Source) + (uint64)Level.SourceWidth * Level.SourceHeight * BYTES_PER_TEXEL;
+        Level.DestinationWidth = MathUtils::Max(Level.SourceWidth >> 1, 1u);
+        Level.DestinationHeight = MathUtils::Max(Level.SourceHeight >> 1, 1u);
+
+        if (inConfig.TaskScheduler != nullptr && (Level.DestinationWidth * Level.DestinationHeight) > TEXELS_PER_TASK)
+        {
+            TaskSet.m_SetSize = Level.DestinationHeight;
+            TaskSet.m_MinRange = MathUtils::Max(TEXELS_PER_TASK / Level.DestinationWidth, 1u);
+
+            inConfig.TaskScheduler->AddTaskSetToPipe(&TaskSet);
+            inConfig.TaskScheduler->WaitforTask(&TaskSet);
+        }
+        else
+        {
+            FilterRows(Level, 0, Level.DestinationHeight);
+        }
+
+        if (inConfig.bPreserveAlphaCoverage)
+        {
+            ScaleAlphaToCoverage(Level.Destination, (uint64)Level.DestinationWidth * Level.DestinationHeight, TargetCoverage, inConfig.AlphaCutoff);
+        }
+
+        Level.Source = Level.Destination;
+        Level.SourceWidth = Level.DestinationWidth;
+        Level.SourceHeight = Level.DestinationHeight;
+    }
+
+    return NumMipLevels;
+}
@@ -0,0 +1,69 @@
+/**
+* This file is part of the "Vrixic Engine" project (Copyright (c) 2022-2023 by Vrij Patel)
+* See "LICENSE.txt" for license information.
+*/
+
+#pragma once
+#include <Core/Core.h>
+#include <Misc/Defines/GenericDefines.h>
+
+namespace enki
+{
+    class TaskScheduler;
+}
+
+enum class EMipFilter
+{
+    /** 2x2 average, fastest */
+    Box,
+
+    /** Kaiser windowed sinc, keeps mips sharper with less aliasing */
+    Kaiser
+};
+
+struct FMipGenerationConfig
+{
+public:
+    EMipFilter Filter = EMipFilter::Box;
+
+    /** Average the color channels in linear space, set for textures holding sRGB encoded color (ex: base color, emissive) */
+    bool bIsSRGB = false;
+
+    /** Scales the alpha of every mip so the same fraction of texels passes the alpha test as mip 0, for masked materials */
+    bool bPreserveAlphaCoverage = false;
+    float AlphaCutoff = 0.5f;
+
+    /** 0 generates the full chain down to 1x1 */
+    uint32 MaxMipLevels = 0;
+
+    /** Optional, when set the rows of each mip are filtered across the worker threads */
+    enki::TaskScheduler* TaskScheduler = nullptr;
+};
+
+/**
+* Generates mip chains for RGBA8 textures on the cpu
+*
+* Mips are tightly packed one after the other, the same layout the texture upload expects:
+*   mip 0 (W * H) | mip 1 (max(W >> 1, 1) * max(H >> 1, 1)) | ...
+*/
+struct VRIXIC_API FMipGenerator
+{
+public:
+    /**
+    * @returns uint32 number of mip levels down to 1x1, clamped to inMaxMipLevels (if not 0)
+    */
+    static uint32 GetNumMipLevels(uint32 inWidth, uint32 inHeight, uint32 inMaxMipLevels = 0);
+
+    /**
+    * @returns uint64 size in bytes of a RGBA8 mip chain
+    */
+    static uint64 GetMipChainSize(uint32 inWidth, uint32 inHeight, uint32 inNumMipLevels);
+
+    /**
+    * Fills in the mip chain, mip 0 is read and every other mip is written
+    *
+    * @param inOutMipChain memory holding the mip chain, has to be at least GetMipChainSize() bytes
+    * @returns uint32 number of mip levels in the chain
+    */
+    static uint32 Generate(uint8* inOutMipChain, uint32 inWidth, uint32 inHeight, const FMipGenerationConfig& inConfig);
+};
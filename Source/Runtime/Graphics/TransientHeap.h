@@ -0,0 +1,55 @@
+/**
+* This file is part of the "Vrixic Engine" project (Copyright (c) 2022-2023 by Vrij Patel)
+* See "LICENSE.txt" for license information.
+*/
+
+#pragma once
+#include <Core/Core.h>
+#include <Core/Misc/Interface.h>
+#include <Misc/Defines/GenericDefines.h>
+
+/**
+* Memory a resource needs to be placed in a transient heap
+*/
+struct VRIXIC_API FMemoryRequirements
+{
+public:
+    uint64 Size;
+    uint64 Alignment;
+
+    /** Bit i is set if the resource can live in memory type i, only resources sharing a bit can share a heap */
+    uint32 MemoryTypeBits;
+
+public:
+    FMemoryRequirements()
+        : Size(0), Alignment(1), MemoryTypeBits(0) { }
+};
+
+/**
+* Configuration used to create a transient heap
+*/
+struct VRIXIC_API FTransientHeapConfig
+{
+public:
+    uint64 Size;
+
+    /** Memory types the resources placed in the heap accept (FMemoryRequirements::MemoryTypeBits) */
+    uint32 MemoryTypeBits;
+
+public:
+    FTransientHeapConfig()
+        : Size(0), MemoryTypeBits(0) { }
+};
+
+/**
+* A block of device memory resources are placed in at explicit offsets instead of each getting their own allocation,
+* resources that are never used at the same time can overlap (ex: frame graph attachments)
+*/
+class VRIXIC_API ITransientHeap : public Interface
+{
+public:
+    /**
+    * @returns uint64 size of the heap in bytes
+    */
+    virtual uint64 GetSize() const = 0;
+};
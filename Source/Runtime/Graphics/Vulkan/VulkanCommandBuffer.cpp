@@ -14,11 +14,44 @@
 #include "VulkanTextureView.h"
 #include "VulkanSemaphore.h"
 
+/**
+* Memory accesses a texture is used with in a layout
+*
+* @param inIsSource true if the layout is the one the texture leaves, an undefined source layout still has to wait on
+*   whatever wrote the memory before (ex: an attachment aliasing the same heap memory)
+*/
+static VkAccessFlags GetLayoutAccessFlags(VkImageLayout inLayout, bool inIsSource)
+{
+    switch (inLayout)
+    {
+    case VK_IMAGE_LAYOUT_UNDEFINED:
+        return inIsSource ? (VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT) : 0;
+    case VK_IMAGE_LAYOUT_GENERAL:
+        return VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    case VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL:
+        return VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    case VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL:
+        return VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    case VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL:
+        return VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+    case VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL:
+        return VK_ACCESS_SHADER_READ_BIT;
+    case VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL:
+        return VK_ACCESS_TRANSFER_READ_BIT;
+    case VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL:
+        return VK_ACCESS_TRANSFER_WRITE_BIT;
+    case VK_IMAGE_LAYOUT_PRESENT_SRC_KHR:
+        return 0;
+    default:
+        return VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+    }
+}
+
 /* ------------------------------------------------------------------------------- */
 /* -----------------------         Command Buffer         ------------------------ */
 /* ------------------------------------------------------------------------------- */
 VulkanCommandBuffer::VulkanCommandBuffer(VulkanDevice* device, VulkanCommandPool* commandPool, uint32 imageIndex)
-    : Device(device), CommandPool(commandPool), ImageIndex(imageIndex), CommandBufferHandle(VK_NULL_HANDLE), WaitFence(nullptr)
+    : Device(device), CommandPool(commandPool), ImageIndex(imageIndex), CommandBufferHandle(VK_NULL_HANDLE), WaitFence(nullptr), NumDraws(0)
 {
     CreateWaitFence();
 }
@@ -124,8 +157,29 @@ void VulkanCommandBuffer::BeginRenderPass(const FRenderPassBeginInfo& inRenderPa
     RenderPassBeginInfo.renderArea.extent.width = RenderArea->extent.width;
     RenderPassBeginInfo.renderArea.extent.height = RenderArea->extent.height;
 
+    // FRenderClearValues holds both the color and the depth stencil value, so it cannot be passed as a VkClearValue array
+    VkClearValue ClearValues[MAX_RENDER_PASS_CLEAR_VALUES];
+    VE_ASSERT(inRenderPassBeginInfo.NumClearValues <= MAX_RENDER_PASS_CLEAR_VALUES, VE_TEXT("[VulkanCommandBuffer]: A render pass can be begun with at most {0} clear values..."), MAX_RENDER_PASS_CLEAR_VALUES);
+
+    for (uint32 i = 0; i < inRenderPassBeginInfo.NumClearValues; ++i)
+    {
+        const FRenderClearValues& ClearValue = inRenderPassBeginInfo.ClearValues[i];
+        if (i == RenderPass->GetDepthStencilAttachmentIndex())
+        {
+            ClearValues[i].depthStencil.depth = ClearValue.Depth;
+            ClearValues[i].depthStencil.stencil = ClearValue.Stencil;
+        }
+        else
+        {
+            ClearValues[i].color.float32[0] = ClearValue.Color.X;
+            ClearValues[i].color.float32[1] = ClearValue.Color.Y;
+            ClearValues[i].color.float32[2] = ClearValue.Color.Z;
+            ClearValues[i].color.float32[3] = ClearValue.Color.W;
+        }
+    }
+
     RenderPassBeginInfo.clearValueCount = inRenderPassBeginInfo.NumClearValues;
-    RenderPassBeginInfo.pClearValues = reinterpret_cast<VkClearValue*>(inRenderPassBeginInfo.ClearValues);
+    RenderPassBeginInfo.pClearValues = ClearValues;
 
     RenderPassBeginInfo.framebuffer = FrameBuffer->GetFrameBufferHandle();
 
@@ -175,21 +229,25 @@ void VulkanCommandBuffer::BindDescriptorSets(const FDescriptorSetsBindInfo& inDe
 void VulkanCommandBuffer::Draw(uint32 inNumVertices, uint32 inFirstVertexIndex)
 {
     vkCmdDraw(CommandBufferHandle, inNumVertices, 1, inFirstVertexIndex, 0);
+    NumDraws++;
 }
 
 void VulkanCommandBuffer::DrawIndexed(uint32 inNumIndices, uint32 inFirstIndex, int32 inVertexOffset)
 {
     vkCmdDrawIndexed(CommandBufferHandle, inNumIndices, 1, inFirstIndex, inVertexOffset, 0);
+    NumDraws++;
 }
 
 void VulkanCommandBuffer::DrawInstanced(uint32 inNumVertices, uint32 inNumInstances, uint32 inFirstVertexIndex, uint32 inFirstInstanceIndex)
 {
     vkCmdDraw(CommandBufferHandle, inNumVertices, inNumInstances, inFirstVertexIndex, inFirstInstanceIndex);
+    NumDraws++;
 }
 
 void VulkanCommandBuffer::DrawIndexedInstanced(uint32 inNumIndices, uint32 inNumInstances, uint32 inFirstIndex, uint32 inVertexOffset, uint32 inFirstInstanceIndex)
 {
     vkCmdDrawIndexed(CommandBufferHandle, inNumIndices, inNumInstances, inFirstIndex, inVertexOffset, inFirstInstanceIndex);
+    NumDraws++;
 }
 
 void VulkanCommandBuffer::UploadTextureData(const TextureResource* inTexture, const FTextureWriteInfo& inTextureWriteInfo)
@@ -248,6 +306,161 @@ void VulkanCommandBuffer::UploadTextureData(const TextureResource* inTexture, co
     VulkanTexture->SetImageLayout(VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
 }
 
+void VulkanCommandBuffer::AcquireUploadedTextures(const TextureResource* const* inTextures, uint32 inNumTextures, ETextureLayout inNewTextureLayout)
+{
+    if (inNumTextures == 0)
+    {
+        return;
+    }
+
+    const uint32 TransferFamilyIndex = Device->GetTransferQueue()->GetFamilyIndex();
+    const uint32 GraphicsFamilyIndex = Device->GetGraphicsQueue()->GetFamilyIndex();
+    const bool bNeedsOwnershipTransfer = TransferFamilyIndex != GraphicsFamilyIndex;
+
+    const VkImageLayout NewLayout = VulkanTypeConverter::ConvertTextureLayoutToVk(inNewTextureLayout);
+
+    std::vector<VkImageMemoryBarrier> AcquireBarriers;
+    std::vector<VkImageMemoryBarrier> LayoutBarriers(inNumTextures);
+    if (bNeedsOwnershipTransfer)
+    {
+        AcquireBarriers.resize(inNumTextures);
+    }
+
+    for (uint32 i = 0; i < inNumTextures; ++i)
+    {
+        VulkanTextureView* VulkanTexture = (VulkanTextureView*)inTextures[i];
+        VE_ASSERT(VulkanTexture != nullptr, VE_TEXT("[VulkanCommandBuffer]: Cannot acquire a null texture..."));
+
+        VkImageMemoryBarrier& LayoutBarrier = LayoutBarriers[i];
+        LayoutBarrier = VulkanUtils::Initializers::ImageMemoryBarrier();
+        LayoutBarrier.image = *VulkanTexture->GetImageHandle();
+        LayoutBarrier.subresourceRange.aspectMask = VulkanTexture->GetAspectFlags();
+        LayoutBarrier.subresourceRange.baseMipLevel = 0;
+        LayoutBarrier.subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
+        LayoutBarrier.subresourceRange.baseArrayLayer = 0;
+        LayoutBarrier.subresourceRange.layerCount = VK_REMAINING_ARRAY_LAYERS;
+        LayoutBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        LayoutBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        LayoutBarrier.oldLayout = VulkanTexture->GetImageLayout();
+        LayoutBarrier.newLayout = NewLayout;
+        LayoutBarrier.srcAccessMask = 0;
+        LayoutBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+        if (bNeedsOwnershipTransfer)
+        {
+            // Has to match the release barrier recorded by UploadTextureData on the transfer queue
+            VkImageMemoryBarrier& AcquireBarrier = AcquireBarriers[i];
+            AcquireBarrier = LayoutBarrier;
+            AcquireBarrier.srcQueueFamilyIndex = TransferFamilyIndex;
+            AcquireBarrier.dstQueueFamilyIndex = GraphicsFamilyIndex;
+            AcquireBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            AcquireBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+            AcquireBarrier.srcAccessMask = 0;
+            AcquireBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        }
+
+        VulkanTexture->SetImageLayout(NewLayout);
+    }
+
+    if (bNeedsOwnershipTransfer)
+    {
+        vkCmdPipelineBarrier(CommandBufferHandle, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+            0, 0, nullptr, 0, nullptr, (uint32)AcquireBarriers.size(), AcquireBarriers.data());
+    }
+
+    vkCmdPipelineBarrier(CommandBufferHandle, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+        0, 0, nullptr, 0, nullptr, (uint32)LayoutBarriers.size(), LayoutBarriers.data());
+}
+
+void VulkanCommandBuffer::AddTextureBarriers(const FTextureBarrier* inBarriers, uint32 inNumBarriers)
+{
+    const ERenderQueueType QueueType = GetQueueType();
+
+    VkPipelineStageFlags SrcStages = 0;
+    VkPipelineStageFlags DstStages = 0;
+
+    std::vector<VkImageMemoryBarrier> ImageBarriers;
+    ImageBarriers.reserve(inNumBarriers);
+
+    for (uint32 i = 0; i < inNumBarriers; ++i)
+    {
+        const FTextureBarrier& Barrier = inBarriers[i];
+
+        VulkanTextureView* VulkanTexture = (VulkanTextureView*)Barrier.Texture;
+        VE_ASSERT(VulkanTexture != nullptr, VE_TEXT("[VulkanCommandBuffer]: Cannot add a barrier for a null texture..."));
+
+        const bool bIsQueueTransfer = Barrier.SrcQueueType != Barrier.DstQueueType;
+        const bool bIsRelease = bIsQueueTransfer && Barrier.SrcQueueType == QueueType;
+        VE_ASSERT(!bIsQueueTransfer || bIsRelease || Barrier.DstQueueType == QueueType, VE_TEXT("[VulkanCommandBuffer]: A queue ownership transfer has to be recorded for its source or destination queue..."));
+
+        const uint32 SrcFamilyIndex = Device->GetQueue(Barrier.SrcQueueType)->GetFamilyIndex();
+        const uint32 DstFamilyIndex = Device->GetQueue(Barrier.DstQueueType)->GetFamilyIndex();
+
+        // Within a family no ownership moves, the acquire alone transitions the texture
+        if (bIsRelease && SrcFamilyIndex == DstFamilyIndex)
+        {
+            continue;
+        }
+
+        VkImageMemoryBarrier ImageBarrier = VulkanUtils::Initializers::ImageMemoryBarrier();
+        ImageBarrier.image = *VulkanTexture->GetImageHandle();
+        ImageBarrier.subresourceRange.aspectMask = VulkanTexture->GetAspectFlags();
+        ImageBarrier.subresourceRange.baseMipLevel = 0;
+        ImageBarrier.subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
+        ImageBarrier.subresourceRange.baseArrayLayer = 0;
+        ImageBarrier.subresourceRange.layerCount = VK_REMAINING_ARRAY_LAYERS;
+        ImageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        ImageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        ImageBarrier.oldLayout = VulkanTypeConverter::ConvertTextureLayoutToVk(Barrier.OldLayout);
+        ImageBarrier.newLayout = VulkanTypeConverter::ConvertTextureLayoutToVk(Barrier.NewLayout);
+
+        const VkAccessFlags OldAccess = GetLayoutAccessFlags(ImageBarrier.oldLayout, true);
+        ImageBarrier.dstAccessMask = GetLayoutAccessFlags(ImageBarrier.newLayout, false);
+
+        // A read in the old layout still has to finish before the transition, but only writes have to be made available
+        VkPipelineStageFlags SrcStage = VulkanDevice::GetPipelineStageFlags(OldAccess, QueueType);
+        VkPipelineStageFlags DstStage = VulkanDevice::GetPipelineStageFlags(ImageBarrier.dstAccessMask, QueueType);
+        ImageBarrier.srcAccessMask = OldAccess & (VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT
+            | VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_MEMORY_WRITE_BIT);
+
+        if (bIsQueueTransfer && SrcFamilyIndex != DstFamilyIndex)
+        {
+            ImageBarrier.srcQueueFamilyIndex = SrcFamilyIndex;
+            ImageBarrier.dstQueueFamilyIndex = DstFamilyIndex;
+
+            // Each half only synchronizes with the work of its own queue, the semaphore between the submissions orders the two halves
+            if (bIsRelease)
+            {
+                ImageBarrier.dstAccessMask = 0;
+                DstStage = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+            }
+            else
+            {
+                ImageBarrier.srcAccessMask = 0;
+                SrcStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+            }
+        }
+
+        SrcStages |= SrcStage;
+        DstStages |= DstStage;
+
+        ImageBarriers.push_back(ImageBarrier);
+        VulkanTexture->SetImageLayout(ImageBarrier.newLayout);
+    }
+
+    if (ImageBarriers.empty())
+    {
+        return;
+    }
+
+    vkCmdPipelineBarrier(CommandBufferHandle, SrcStages, DstStages, 0, 0, nullptr, 0, nullptr, (uint32)ImageBarriers.size(), ImageBarriers.data());
+}
+
+ERenderQueueType VulkanCommandBuffer::GetQueueType() const
+{
+    return CommandPool->GetQueueType();
+}
+
 void VulkanCommandBuffer::CreateWaitFence()
 {
     VE_ASSERT(WaitFence == nullptr, VE_TEXT("[VulkanCommandBuffer]: Potential GPU Memory Leak!! Cannot create a wait fence twice!!"));
@@ -361,7 +574,7 @@ void VulkanCommandBuffer::ResetWaitFence() const
 /* ------------------------------------------------------------------------------- */
 
 VulkanCommandPool::VulkanCommandPool(VulkanDevice* device)
-    : Device(device), CommandPoolHandle(VK_NULL_HANDLE) { }
+    : Device(device), CommandPoolHandle(VK_NULL_HANDLE), QueueFamilyIndex(UINT32_MAX), QueueType(ERenderQueueType::Graphics) { }
 
 VulkanCommandPool::~VulkanCommandPool()
 {
@@ -379,7 +592,7 @@ VulkanCommandBuffer* VulkanCommandPool::CreateCommandBuffer(uint32 imageIndex)
     return CommandBuffer;
 }
 
-void VulkanCommandPool::CreateCommandPool(uint32 queueFamilyIndex)
+void VulkanCommandPool::CreateCommandPool(uint32 queueFamilyIndex, ERenderQueueType inQueueType)
 {
     VE_ASSERT(CommandPoolHandle == VK_NULL_HANDLE, VE_TEXT("[VulkanCommandPool]: Potential GPU Memory Leak! A vulkan command pool can only be created once!!"));
 
@@ -387,6 +600,8 @@ void VulkanCommandPool::CreateCommandPool(uint32 queueFamilyIndex)
         queueFamilyIndex, nullptr);
 
     VK_CHECK_RESULT(vkCreateCommandPool(*Device->GetDeviceHandle(), &CommandPoolInfo, nullptr, &CommandPoolHandle), "[VulkanCommandPool]: Failed to create a command pool!");
+    QueueFamilyIndex = queueFamilyIndex;
+    QueueType = inQueueType;
 }
 
 void VulkanCommandPool::EraseCommandBuffer(VulkanCommandBuffer* inCmdBuffer)
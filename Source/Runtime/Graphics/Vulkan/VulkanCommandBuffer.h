@@ -205,6 +205,14 @@ public:
     */
     virtual void DrawIndexedInstanced(uint32 inNumIndices, uint32 inNumInstances, uint32 inFirstIndex = 0, uint32 inVertexOffset = 0, uint32 inFirstInstanceIndex = 0) override;
 
+    /**
+    * @returns uint32 number of draws recorded since the command buffer was created (wraps around)
+    */
+    virtual uint32 GetNumDraws() const override
+    {
+        return NumDraws;
+    }
+
     /**
      * Copies the data from the buffer provided and uploads it into the texture
      * @Note: this function only uploads the data and leaves the texture in a non-shader readable layout
@@ -214,8 +222,26 @@ public:
      */
     virtual void UploadTextureData(const TextureResource* inTexture, const FTextureWriteInfo& inTextureWriteInfo) override;
 
+    /**
+     * Acquires the ownership of the textures from the transfer queue (when it is a different family) then transitions them,
+     * each step is one pipeline barrier for every texture
+     */
+    virtual void AcquireUploadedTextures(const TextureResource* const* inTextures, uint32 inNumTextures, ETextureLayout inNewTextureLayout) override;
+
+    /**
+     * The stages and accesses waited on and made visible are derived from the old and new layout of each barrier,
+     * a barrier between two queues is a release if this command buffer is recorded for the source queue and an acquire otherwise.
+     * When both queues share a family the release does nothing and the acquire is a plain barrier
+     */
+    virtual void AddTextureBarriers(const FTextureBarrier* inBarriers, uint32 inNumBarriers) override;
+
     /*-- End ICommandBuffer Interface --*/
 
+    /**
+    * @returns ERenderQueueType the queue the command buffer is recorded for
+    */
+    ERenderQueueType GetQueueType() const;
+
     /**
     * Creates a wait fence for this command buffer 
     */
@@ -316,6 +342,9 @@ public:
     }
 
 private:
+    /** Eight color attachments, their resolve attachments and a depth stencil attachment */
+    static const uint32 MAX_RENDER_PASS_CLEAR_VALUES = 17;
+
     VulkanDevice* Device;
     VulkanCommandPool* CommandPool;
     VkCommandBuffer CommandBufferHandle;
@@ -326,6 +355,9 @@ private:
     uint32 ImageIndex;
 
     uint32 AllocatedBufferCount;
+
+    /** Incremented by every draw, read by the frame graph stats */
+    uint32 NumDraws;
 };
 
 /**
@@ -360,8 +392,9 @@ public:
     * Creates a command pool
     *
     * @param inQueueFamilyIndex - an index into the queue family used to create the command pool
+    * @param inQueueType - the queue the command buffers will be submitted to, several queue types can share a family
     */
-    void CreateCommandPool(uint32 inQueueFamilyIndex);
+    void CreateCommandPool(uint32 inQueueFamilyIndex, ERenderQueueType inQueueType = ERenderQueueType::Graphics);
 
     /**
     * Erases the command buffer 
@@ -387,10 +420,31 @@ public:
         return CommandBuffers[bufferIndex];
     }
 
+    inline uint32 GetNumCommandBuffers() const
+    {
+        return (uint32)CommandBuffers.size();
+    }
+
+    /**
+    * @returns uint32 the queue family the command buffers of this pool can be submitted to
+    */
+    inline uint32 GetQueueFamilyIndex() const
+    {
+        return QueueFamilyIndex;
+    }
+
+    inline ERenderQueueType GetQueueType() const
+    {
+        return QueueType;
+    }
+
 private:
     VulkanDevice* Device;
     VkCommandPool CommandPoolHandle;
 
+    uint32 QueueFamilyIndex;
+    ERenderQueueType QueueType;
+
     /** All of the Command buffers associated with this pool */
     std::vector<VulkanCommandBuffer*> CommandBuffers;
 };
@@ -60,6 +60,10 @@ private:
             UsedSecondaryCommandBuffers[i] = 0;
         }
 
+        // Pools of the acquired command buffers are only created once a queue type is used on a thread
+        AcquirePools.assign(NumPools * NumQueueTypes, nullptr);
+        UsedAcquiredCommandBuffers.assign(NumPools * NumQueueTypes, 0);
+
         // Create Command Buffers: number of command pools * number of command buffers per pool
         const uint32 NumBuffers = NumPools * NumCommandBuffersPerThread;
         CommandBuffers.resize(NumBuffers);
@@ -105,6 +109,13 @@ private:
         }
 
         VulkanCommandPools.clear();
+
+        for (uint32 i = 0; i < AcquirePools.size(); ++i)
+        {
+            delete AcquirePools[i];
+        }
+
+        AcquirePools.clear();
     }
 
     void ResetCommandPools(uint32 inFrameIndex) override
@@ -141,6 +152,42 @@ private:
         return CommandBuffer;
     }
 
+    VulkanCommandBuffer* AcquireCommandBuffer(uint32 inFrameIndex, uint32 inThreadIndex, ERenderQueueType inQueueType) override
+    {
+        const uint32 PoolIndex = (CalcPoolIndex(inFrameIndex, inThreadIndex) * NumQueueTypes) + (uint32)inQueueType;
+
+        VulkanCommandPool*& CommandPool = AcquirePools[PoolIndex];
+        if (CommandPool == nullptr)
+        {
+            CommandPool = new VulkanCommandPool(Device);
+            CommandPool->CreateCommandPool(Device->GetQueue(inQueueType)->GetFamilyIndex(), inQueueType);
+        }
+
+        // Grows on demand, only the thread passed in uses the pool so no locking is needed
+        uint32& UsedBuffers = UsedAcquiredCommandBuffers[PoolIndex];
+        if (UsedBuffers == CommandPool->GetNumCommandBuffers())
+        {
+            VulkanCommandBuffer* CommandBuffer = CommandPool->CreateCommandBuffer(inFrameIndex);
+            CommandBuffer->AllocateCommandBuffer();
+        }
+
+        return CommandPool->GetCommandBuffer(UsedBuffers++);
+    }
+
+    void ResetAcquiredCommandBuffers(uint32 inFrameIndex) override
+    {
+        for (uint32 i = 0; i < NumPoolsPerFrame * NumQueueTypes; ++i)
+        {
+            const uint32 PoolIndex = (CalcPoolIndex(inFrameIndex, 0) * NumQueueTypes) + i;
+            if (AcquirePools[PoolIndex] != nullptr)
+            {
+                AcquirePools[PoolIndex]->Reset();
+            }
+
+            UsedAcquiredCommandBuffers[PoolIndex] = 0;
+        }
+    }
+
     uint32 CalcPoolIndex(uint32 inFrameIndex, uint32 inThreadIndex) const
     {
         return (inFrameIndex * NumPoolsPerFrame) + inThreadIndex;
@@ -159,4 +206,10 @@ private:
 
     std::vector<uint8> UsedCommandBuffers; // per-frame used command buffers per thread 
     std::vector<uint8> UsedSecondaryCommandBuffers; // per-frame used command buffers per thread 
+
+    /** Number of ERenderQueueType values, each (frame, thread) gets a pool per queue type for acquired command buffers */
+    static const uint32 NumQueueTypes = 3;
+
+    std::vector<VulkanCommandPool*> AcquirePools;
+    std::vector<uint32> UsedAcquiredCommandBuffers; // per-frame acquired command buffers per thread and queue type
 };
\ No newline at end of file
@@ -0,0 +1,308 @@
+/**
+* This file is part of the "Vrixic Engine" project (Copyright (c) 2022-2023 by Vrij Patel)
+* See "LICENSE.txt" for license information.
+*/
+
+#include "VulkanDescriptorAllocator.h"
+#include <Misc/Defines/StringDefines.h>
+#include <Runtime/Core/Math/VrixicMathHelper.h>
+
+#include <algorithm>
+
+VulkanDescriptorAllocator::VulkanDescriptorAllocator(VulkanDevice* inDevice)
+    : Device(inDevice), NumCacheHits(0), NumCacheMisses(0) { }
+
+VulkanDescriptorAllocator::~VulkanDescriptorAllocator()
+{
+    Device->WaitUntilIdle();
+
+    VE_CORE_LOG_INFO(VE_TEXT("[VulkanDescriptorAllocator]: {0} descriptor sets were shared out of the cache, {1} were allocated"), NumCacheHits, NumCacheMisses);
+
+    for (auto& Pools : LayoutPools)
+    {
+        for (VkDescriptorPool Pool : Pools.second.Pools)
+        {
+            vkDestroyDescriptorPool(*Device->GetDeviceHandle(), Pool, nullptr);
+        }
+    }
+}
+
+void VulkanDescriptorAllocator::Register(VulkanDescriptorSets* outDescriptorSets, const VulkanDescriptorSetsLayout* inSetsLayout, EVulkanDescriptorSetAllocation inAllocationType)
+{
+    VE_ASSERT(inAllocationType != EVulkanDescriptorSetAllocation::InPlace || inSetsLayout == nullptr, VE_TEXT("[VulkanDescriptorAllocator]: In place descriptor sets are allocated by their owner"));
+
+    outDescriptorSets->Allocator = this;
+    outDescriptorSets->SetsLayout = inSetsLayout;
+    outDescriptorSets->AllocationType = inAllocationType;
+}
+
+void VulkanDescriptorAllocator::QueueWrite(VulkanDescriptorSets* inDescriptorSets, uint32 inIndex, const FVulkanDescriptorWrite& inWrite)
+{
+    VE_ASSERT(inIndex < inDescriptorSets->DescriptorSetHandles.size(), VE_TEXT("[VulkanDescriptorAllocator]: Invalid descriptor set index provided -> {0}"), inIndex);
+
+    std::lock_guard<std::mutex> Lock(Mutex);
+
+    if (inDescriptorSets->AllocationType == EVulkanDescriptorSetAllocation::InPlace)
+    {
+        inDescriptorSets->PendingWrites[inIndex].push_back(inWrite);
+    }
+    else
+    {
+        // Kept sorted with one write per descriptor so the same links hash the same no matter the order they were made in
+        std::vector<FVulkanDescriptorWrite>& Writes = inDescriptorSets->Writes[inIndex];
+        auto Position = std::lower_bound(Writes.begin(), Writes.end(), inWrite, [](const FVulkanDescriptorWrite& inA, const FVulkanDescriptorWrite& inB)
+        {
+            return inA.Binding < inB.Binding || (inA.Binding == inB.Binding && inA.ArrayElement < inB.ArrayElement);
+        });
+
+        if (Position != Writes.end() && Position->Binding == inWrite.Binding && Position->ArrayElement == inWrite.ArrayElement)
+        {
+            *Position = inWrite;
+        }
+        else
+        {
+            Writes.insert(Position, inWrite);
+        }
+
+        // Gets a new handle on flush, the old one is left untouched as the GPU may still be using it
+        ReleaseHandle(inDescriptorSets->DescriptorSetHandles[inIndex]);
+        inDescriptorSets->DescriptorSetHandles[inIndex] = VK_NULL_HANDLE;
+    }
+
+    if (!inDescriptorSets->bHasPendingWrites.exchange(true))
+    {
+        PendingSets.push_back(inDescriptorSets);
+    }
+}
+
+void VulkanDescriptorAllocator::FlushWrites()
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+
+    if (PendingSets.empty())
+    {
+        return;
+    }
+
+    std::vector<VkWriteDescriptorSet> VkWrites;
+    for (VulkanDescriptorSets* DescriptorSets : PendingSets)
+    {
+        for (uint32 SetIndex = 0; SetIndex < DescriptorSets->DescriptorSetHandles.size(); ++SetIndex)
+        {
+            VkDescriptorSet& SetHandle = DescriptorSets->DescriptorSetHandles[SetIndex];
+
+            if (DescriptorSets->AllocationType == EVulkanDescriptorSetAllocation::InPlace)
+            {
+                AppendWrites(SetHandle, DescriptorSets->PendingWrites[SetIndex], VkWrites);
+                continue;
+            }
+
+            // Sets that were not linked since their last flush keep their handle
+            if (SetHandle != VK_NULL_HANDLE)
+            {
+                continue;
+            }
+
+            const std::vector<FVulkanDescriptorWrite>& Writes = DescriptorSets->Writes[SetIndex];
+            const VulkanDescriptorSetsLayout::FLayoutInfo& LayoutInfo = DescriptorSets->SetsLayout->GetLayoutInfo(0);
+
+            const uint64 SetKey = HashWrites(LayoutInfo.Hash, Writes);
+
+            auto CachedSet = CachedSets.find(SetKey);
+            if (CachedSet != CachedSets.end())
+            {
+                SetHandle = CachedSet->second;
+                SetUsages[SetHandle].NumUsers++;
+                NumCacheHits++;
+                continue;
+            }
+
+            SetHandle = Allocate(LayoutPools[LayoutInfo.Hash], DescriptorSets->SetsLayout);
+            CachedSets[SetKey] = SetHandle;
+            SetUsages[SetHandle] = { LayoutInfo.Hash, SetKey, 1 };
+            NumCacheMisses++;
+
+            AppendWrites(SetHandle, Writes, VkWrites);
+        }
+    }
+
+    if (VkWrites.size() > 0)
+    {
+        vkUpdateDescriptorSets(*Device->GetDeviceHandle(), (uint32)VkWrites.size(), VkWrites.data(), 0, nullptr);
+    }
+
+    // The vulkan writes point into the pending writes, only cleared once they were consumed
+    for (VulkanDescriptorSets* DescriptorSets : PendingSets)
+    {
+        for (std::vector<FVulkanDescriptorWrite>& PendingWrites : DescriptorSets->PendingWrites)
+        {
+            PendingWrites.clear();
+        }
+
+        DescriptorSets->bHasPendingWrites.store(false, std::memory_order_release);
+    }
+
+    PendingSets.clear();
+}
+
+void VulkanDescriptorAllocator::BeginFrame(uint32 inFrameIndex)
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+
+    // Sets retired while this frame was recorded are only handed back when the next one begins
+    for (const std::pair<uint64, VkDescriptorSet>& RetiredSet : RetiredSets)
+    {
+        LayoutPools[RetiredSet.first].FreeSets.push_back(RetiredSet.second);
+    }
+
+    RetiredSets.clear();
+}
+
+void VulkanDescriptorAllocator::InvalidateCache()
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    CachedSets.clear();
+}
+
+void VulkanDescriptorAllocator::Release(VulkanDescriptorSets* inDescriptorSets)
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+
+    auto PendingSet = std::find(PendingSets.begin(), PendingSets.end(), inDescriptorSets);
+    if (PendingSet != PendingSets.end())
+    {
+        PendingSets.erase(PendingSet);
+    }
+
+    if (inDescriptorSets->AllocationType == EVulkanDescriptorSetAllocation::Cached)
+    {
+        for (VkDescriptorSet SetHandle : inDescriptorSets->DescriptorSetHandles)
+        {
+            ReleaseHandle(SetHandle);
+        }
+    }
+}
+
+void VulkanDescriptorAllocator::ReleaseHandle(VkDescriptorSet inSetHandle)
+{
+    auto Usage = SetUsages.find(inSetHandle);
+    if (Usage == SetUsages.end() || --Usage->second.NumUsers > 0)
+    {
+        return;
+    }
+
+    // The cache may already hand out another set for the key (after InvalidateCache())
+    auto CachedSet = CachedSets.find(Usage->second.Key);
+    if (CachedSet != CachedSets.end() && CachedSet->second == inSetHandle)
+    {
+        CachedSets.erase(CachedSet);
+    }
+
+    RetiredSets.push_back({ Usage->second.LayoutHash, inSetHandle });
+    SetUsages.erase(Usage);
+}
+
+VkDescriptorSet VulkanDescriptorAllocator::Allocate(FLayoutPools& inLayoutPools, const VulkanDescriptorSetsLayout* inSetsLayout)
+{
+    // Rewritten by the flush, the GPU is done with it
+    if (inLayoutPools.FreeSets.size() > 0)
+    {
+        VkDescriptorSet SetHandle = inLayoutPools.FreeSets.back();
+        inLayoutPools.FreeSets.pop_back();
+        return SetHandle;
+    }
+
+    VkDescriptorSetAllocateInfo DescriptorSetAllocateInfo = VulkanUtils::Initializers::DescriptorSetAllocateInfo();
+    DescriptorSetAllocateInfo.descriptorSetCount = 1;
+    DescriptorSetAllocateInfo.pSetLayouts = inSetsLayout->GetLayoutHandle(0);
+
+    VkDescriptorSet SetHandle = VK_NULL_HANDLE;
+    for (; inLayoutPools.CurrentPool < inLayoutPools.Pools.size(); ++inLayoutPools.CurrentPool)
+    {
+        DescriptorSetAllocateInfo.descriptorPool = inLayoutPools.Pools[inLayoutPools.CurrentPool];
+
+        VkResult Result = vkAllocateDescriptorSets(*Device->GetDeviceHandle(), &DescriptorSetAllocateInfo, &SetHandle);
+        if (Result == VK_SUCCESS)
+        {
+            return SetHandle;
+        }
+
+        VE_ASSERT(Result == VK_ERROR_OUT_OF_POOL_MEMORY || Result == VK_ERROR_FRAGMENTED_POOL, VE_TEXT("[VulkanDescriptorAllocator]: Failed to allocate a descriptor set -> {0}"), (int32)Result);
+    }
+
+    // Every pool is full, the new one holds twice as many sets as the last
+    const uint32 NumSets = MathUtils::Min(MIN_SETS_PER_POOL << MathUtils::Min((uint32)inLayoutPools.Pools.size(), 5u), MAX_SETS_PER_POOL);
+    inLayoutPools.Pools.push_back(CreatePool(inSetsLayout->GetLayoutInfo(0), NumSets));
+    inLayoutPools.CurrentPool = (uint32)inLayoutPools.Pools.size() - 1;
+
+    DescriptorSetAllocateInfo.descriptorPool = inLayoutPools.Pools.back();
+    VK_CHECK_RESULT(vkAllocateDescriptorSets(*Device->GetDeviceHandle(), &DescriptorSetAllocateInfo, &SetHandle), "[VulkanDescriptorAllocator]: Failed to allocate a descriptor set from a new pool!");
+
+    return SetHandle;
+}
+
+VkDescriptorPool VulkanDescriptorAllocator::CreatePool(const VulkanDescriptorSetsLayout::FLayoutInfo& inLayoutInfo, uint32 inNumSets)
+{
+    std::vector<VkDescriptorPoolSize> PoolSizes = inLayoutInfo.PoolSizes;
+    for (VkDescriptorPoolSize& PoolSize : PoolSizes)
+    {
+        PoolSize.descriptorCount *= inNumSets;
+    }
+
+    VkDescriptorPoolCreateInfo DescriptorPoolCreateInfo = VulkanUtils::Initializers::DescriptorPoolCreateInfo();
+    DescriptorPoolCreateInfo.flags = 0;
+    DescriptorPoolCreateInfo.maxSets = inNumSets;
+    DescriptorPoolCreateInfo.pPoolSizes = PoolSizes.data();
+    DescriptorPoolCreateInfo.poolSizeCount = (uint32)PoolSizes.size();
+
+    VkDescriptorPool Pool = VK_NULL_HANDLE;
+    VK_CHECK_RESULT(vkCreateDescriptorPool(*Device->GetDeviceHandle(), &DescriptorPoolCreateInfo, nullptr, &Pool), "[VulkanDescriptorAllocator]: Failed to create a descriptor pool!");
+
+    return Pool;
+}
+
+uint64 VulkanDescriptorAllocator::HashWrites(uint64 inLayoutHash, const std::vector<FVulkanDescriptorWrite>& inWrites)
+{
+    uint64 Hash = inLayoutHash;
+    for (const FVulkanDescriptorWrite& Write : inWrites)
+    {
+        // Field by field, the structs have padding on some platforms and only one of the infos is used
+        const uint32 Fields[4] = { Write.Binding, Write.ArrayElement, Write.DescriptorCount, (uint32)Write.DescriptorType };
+        Hash = XXHash64::Hash(Fields, sizeof(Fields), Hash);
+
+        if (Write.BufferInfo.buffer != VK_NULL_HANDLE)
+        {
+            Hash = XXHash64::Hash(&Write.BufferInfo.buffer, sizeof(VkBuffer), Hash);
+            Hash = XXHash64::Hash(&Write.BufferInfo.offset, sizeof(VkDeviceSize), Hash);
+            Hash = XXHash64::Hash(&Write.BufferInfo.range, sizeof(VkDeviceSize), Hash);
+        }
+        else
+        {
+            Hash = XXHash64::Hash(&Write.ImageInfo.sampler, sizeof(VkSampler), Hash);
+            Hash = XXHash64::Hash(&Write.ImageInfo.imageView, sizeof(VkImageView), Hash);
+            Hash = XXHash64::Hash(&Write.ImageInfo.imageLayout, sizeof(VkImageLayout), Hash);
+        }
+    }
+
+    return Hash;
+}
+
+void VulkanDescriptorAllocator::AppendWrites(VkDescriptorSet inSetHandle, const std::vector<FVulkanDescriptorWrite>& inWrites, std::vector<VkWriteDescriptorSet>& outWrites)
+{
+    for (const FVulkanDescriptorWrite& Write : inWrites)
+    {
+        VkWriteDescriptorSet WriteDescriptorSet = VulkanUtils::Initializers::WriteDescriptorSet();
+        WriteDescriptorSet.dstSet = inSetHandle;
+        WriteDescriptorSet.dstBinding = Write.Binding;
+        WriteDescriptorSet.dstArrayElement = Write.ArrayElement;
+        WriteDescriptorSet.descriptorCount = Write.DescriptorCount;
+        WriteDescriptorSet.descriptorType = Write.DescriptorType;
+
+        const bool bIsBuffer = Write.BufferInfo.buffer != VK_NULL_HANDLE;
+        WriteDescriptorSet.pBufferInfo = bIsBuffer ? &Write.BufferInfo : nullptr;
+        WriteDescriptorSet.pImageInfo = bIsBuffer ? nullptr : &Write.ImageInfo;
+        WriteDescriptorSet.pTexelBufferView = nullptr;
+
+        outWrites.push_back(WriteDescriptorSet);
+    }
+}
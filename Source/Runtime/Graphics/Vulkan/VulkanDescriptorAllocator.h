@@ -0,0 +1,136 @@
+/**
+* This file is part of the "Vrixic Engine" project (Copyright (c) 2022-2023 by Vrij Patel)
+* See "LICENSE.txt" for license information.
+*/
+
+#pragma once
+#include "VulkanDescriptorSet.h"
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/**
+* Allocates the descriptor sets of the render interface and writes their links
+*
+* Pools are kept per layout hash and grow by adding pools once the last one is full, so nothing has to be sized up front.
+* Links are recorded by the sets and flushed together in a single vkUpdateDescriptorSets call, cached sets with the same
+*   layout and links share one VkDescriptorSet (ex: materials using the same buffers and textures) and skip the writes entirely.
+* A VkDescriptorSet no set uses anymore (relinked or freed) is retired, once the GPU is done with it the next set of its layout reuses it.
+*
+* @note thread safe
+*/
+class VRIXIC_API VulkanDescriptorAllocator
+{
+public:
+    VulkanDescriptorAllocator(VulkanDevice* inDevice);
+    ~VulkanDescriptorAllocator();
+
+    VulkanDescriptorAllocator(const VulkanDescriptorAllocator& other) = delete;
+    VulkanDescriptorAllocator operator=(const VulkanDescriptorAllocator& other) = delete;
+
+public:
+    /**
+    * Sets up descriptor sets to be allocated by this allocator
+    *
+    * @param inSetsLayout the layout the sets are allocated with (layout id 0)
+    * @param inAllocationType in place sets are allocated by their owner
+    */
+    void Register(VulkanDescriptorSets* outDescriptorSets, const VulkanDescriptorSetsLayout* inSetsLayout, EVulkanDescriptorSetAllocation inAllocationType);
+
+    /**
+    * Records a link of one of the sets, it is written on the next flush
+    */
+    void QueueWrite(VulkanDescriptorSets* inDescriptorSets, uint32 inIndex, const FVulkanDescriptorWrite& inWrite);
+
+    /**
+    * Allocates (or finds in the cache) the sets with pending links and writes all of the links at once
+    */
+    void FlushWrites();
+
+    /**
+    * Hands the retired sets back to their pools, the GPU has to be done with every frame submitted before
+    */
+    void BeginFrame(uint32 inFrameIndex);
+
+    /**
+    * Stops handing out cached sets, has to be called when a resource that might be linked to them is destroyed
+    * as a new resource could reuse its handle. The sets stay valid for the ones already using them
+    */
+    void InvalidateCache();
+
+    /**
+    * Forgets about a set that is being deleted, retires its handles if no other set shares them
+    */
+    void Release(VulkanDescriptorSets* inDescriptorSets);
+
+private:
+    /** The pools allocating sets of one layout */
+    struct FLayoutPools
+    {
+        std::vector<VkDescriptorPool> Pools;
+
+        /** Pool sets are being allocated from, the ones before it are full */
+        uint32 CurrentPool = 0;
+
+        /** Retired sets the GPU is done with, handed out before allocating from the pools */
+        std::vector<VkDescriptorSet> FreeSets;
+    };
+
+    /** A VkDescriptorSet handed out to sets */
+    struct FSetUsage
+    {
+        /** Hash of the layout the set was allocated with */
+        uint64 LayoutHash;
+
+        /** Hash of the layout and links, the key of the set in CachedSets */
+        uint64 Key;
+
+        /** Number of sets using the handle */
+        uint32 NumUsers;
+    };
+
+    /** Allocates a set from inLayoutPools, reusing a free set if there is one and adding a pool if they are all full. Expects the mutex to be held */
+    VkDescriptorSet Allocate(FLayoutPools& inLayoutPools, const VulkanDescriptorSetsLayout* inSetsLayout);
+
+    /** Drops one user of a handle, the handle is retired once it has none. Expects the mutex to be held */
+    void ReleaseHandle(VkDescriptorSet inSetHandle);
+
+    /** Expects the mutex to be held */
+    VkDescriptorPool CreatePool(const VulkanDescriptorSetsLayout::FLayoutInfo& inLayoutInfo, uint32 inNumSets);
+
+    /**
+    * @returns uint64 hash of the layout and every link of a set, sets with the same hash hold the same descriptors
+    */
+    static uint64 HashWrites(uint64 inLayoutHash, const std::vector<FVulkanDescriptorWrite>& inWrites);
+
+    /** Adds every write of inWrites for inSetHandle to outWrites */
+    static void AppendWrites(VkDescriptorSet inSetHandle, const std::vector<FVulkanDescriptorWrite>& inWrites, std::vector<VkWriteDescriptorSet>& outWrites);
+
+private:
+    /** Sets the first pool of a layout can hold, every pool added after holds twice as many as the last up to MAX_SETS_PER_POOL */
+    static constexpr uint32 MIN_SETS_PER_POOL = 32;
+    static constexpr uint32 MAX_SETS_PER_POOL = 1024;
+
+    VulkanDevice* Device;
+
+    /** Layout hash -> pools of the sets */
+    std::unordered_map<uint64, FLayoutPools> LayoutPools;
+
+    /** Hash of a layout and links -> set holding those links */
+    std::unordered_map<uint64, VkDescriptorSet> CachedSets;
+
+    /** Handle -> its users, for every handle a set is using */
+    std::unordered_map<VkDescriptorSet, FSetUsage> SetUsages;
+
+    /** Handles without users since the last BeginFrame(), the GPU may still be using them */
+    std::vector<std::pair<uint64, VkDescriptorSet>> RetiredSets;
+
+    /** Sets with links that were not written yet */
+    std::vector<VulkanDescriptorSets*> PendingSets;
+
+    uint64 NumCacheHits;
+    uint64 NumCacheMisses;
+
+    std::mutex Mutex;
+};
@@ -4,6 +4,7 @@
 */
 
 #include "VulkanDescriptorSet.h"
+#include "VulkanDescriptorAllocator.h"
 #include "VulkanSampler.h"
 #include "VulkanTextureView.h"
 
@@ -13,25 +14,18 @@ void VulkanDescriptorSets::LinkToBuffer(uint32 inIndex, const FDescriptorSetsLin
 
     VE_ASSERT(BufferHandle != nullptr, VE_TEXT("[VulkanDescriptorSets]: Cannot update a descriptor set if the buffer is invalid!"));
 
-    VkDescriptorBufferInfo DescriptorBufferInfo = { };
-    DescriptorBufferInfo.buffer = *BufferHandle->GetBufferHandle();
-    DescriptorBufferInfo.offset = 0;
-    DescriptorBufferInfo.range = BufferHandle->GetBufferSize();
+    FVulkanDescriptorWrite Write = { };
+    Write.Binding = inDescriptorSetsLinkInfo.BindingStart;
+    Write.ArrayElement = inDescriptorSetsLinkInfo.ArrayElementStart;
+    Write.DescriptorCount = inDescriptorSetsLinkInfo.DescriptorCount;
+    Write.DescriptorType = VulkanTypeConverter::ConvertBindFlagsToVkDescriptorType(EResourceType::Buffer, BufferHandle->GetUsageFlags());
 
-    VkWriteDescriptorSet WriteDescriptorSet = VulkanUtils::Initializers::WriteDescriptorSet();
-    WriteDescriptorSet.dstBinding = inDescriptorSetsLinkInfo.BindingStart;
-    WriteDescriptorSet.dstSet = DescriptorSetHandles[inIndex];
-    WriteDescriptorSet.dstArrayElement = inDescriptorSetsLinkInfo.ArrayElementStart;
-    WriteDescriptorSet.descriptorCount = inDescriptorSetsLinkInfo.DescriptorCount;
+    Write.BufferInfo.buffer = *BufferHandle->GetBufferHandle();
+    Write.BufferInfo.offset = 0;
+    Write.BufferInfo.range = BufferHandle->GetBufferSize();
 
-    WriteDescriptorSet.descriptorType = VulkanTypeConverter::ConvertBindFlagsToVkDescriptorType(EResourceType::Buffer, BufferHandle->GetUsageFlags());
-
-    WriteDescriptorSet.pImageInfo = nullptr;
-    WriteDescriptorSet.pBufferInfo = &DescriptorBufferInfo;
-    WriteDescriptorSet.pTexelBufferView = nullptr;
-
-    // Link 
-    vkUpdateDescriptorSets(*Device->GetDeviceHandle(), 1, &WriteDescriptorSet, 0, nullptr);
+    // Written out along with every other pending link the next time the allocator flushes
+    Allocator->QueueWrite(this, inIndex, Write);
 }
 
 void VulkanDescriptorSets::LinkToTexture(uint32 inIndex, const FDescriptorSetsLinkInfo& inDescriptorSetsLinkInfo)
@@ -42,23 +36,23 @@ void VulkanDescriptorSets::LinkToTexture(uint32 inIndex, const FDescriptorSetsLi
     VulkanSampler* SamplerVk = (VulkanSampler*)inDescriptorSetsLinkInfo.TextureSampler;
     VE_ASSERT(SamplerVk != nullptr, VE_TEXT("[VulkanDescriptorSets]: Cannot update a descriptor set if the sampler for the texture is invalid..!"));
 
-    VkDescriptorImageInfo  DescriptorImageInfo = { };
-    DescriptorImageInfo.sampler = SamplerVk->GetSamplerHandle();
-    DescriptorImageInfo.imageView = *TextureHandle->GetImageViewHandle();
-    DescriptorImageInfo.imageLayout = TextureHandle->GetImageLayout();
-
-    VkWriteDescriptorSet WriteDescriptorSet = VulkanUtils::Initializers::WriteDescriptorSet();
-    WriteDescriptorSet.dstBinding = inDescriptorSetsLinkInfo.BindingStart;
-    WriteDescriptorSet.dstSet = DescriptorSetHandles[inIndex];
-    WriteDescriptorSet.dstArrayElement = inDescriptorSetsLinkInfo.ArrayElementStart;
-    WriteDescriptorSet.descriptorCount = inDescriptorSetsLinkInfo.DescriptorCount;
+    FVulkanDescriptorWrite Write = { };
+    Write.Binding = inDescriptorSetsLinkInfo.BindingStart;
+    Write.ArrayElement = inDescriptorSetsLinkInfo.ArrayElementStart;
+    Write.DescriptorCount = inDescriptorSetsLinkInfo.DescriptorCount;
+    Write.DescriptorType = VulkanTypeConverter::ConvertBindFlagsToVkDescriptorType(EResourceType::Texture, TextureHandle->GetBindFlags());
 
-    WriteDescriptorSet.descriptorType = VulkanTypeConverter::ConvertBindFlagsToVkDescriptorType(EResourceType::Texture, TextureHandle->GetBindFlags());
+    Write.ImageInfo.sampler = SamplerVk->GetSamplerHandle();
+    Write.ImageInfo.imageView = *TextureHandle->GetImageViewHandle();
+    Write.ImageInfo.imageLayout = TextureHandle->GetImageLayout();
 
-    WriteDescriptorSet.pImageInfo = &DescriptorImageInfo;
-    WriteDescriptorSet.pBufferInfo = nullptr;
-    WriteDescriptorSet.pTexelBufferView = nullptr;
+    Allocator->QueueWrite(this, inIndex, Write);
+}
 
-    // Link 
-    vkUpdateDescriptorSets(*Device->GetDeviceHandle(), 1, &WriteDescriptorSet, 0, nullptr);
+void VulkanDescriptorSets::ResolvePendingWrites() const
+{
+    if (bHasPendingWrites.load(std::memory_order_acquire))
+    {
+        Allocator->FlushWrites();
+    }
 }
@@ -5,8 +5,13 @@
 
 #pragma once
 #include "VulkanBuffer.h"
+#include <Runtime/Core/Algorithms/Hashing/XXHash64.h>
 #include <Runtime/Graphics/DescriptorSet.h>
 
+#include <atomic>
+
+class VulkanDescriptorAllocator;
+
 /**
 * Representation of a VkDescriptorSetLayout, except it can hold multiple layouts
 */
@@ -70,6 +75,7 @@ public:
         VK_CHECK_RESULT(vkCreateDescriptorSetLayout(*Device->GetDeviceHandle(), &DescriptorSetLayoutCreateInfo, nullptr, &NewLayout), "[VulkanDescriptorSetsLayout]: Failed to create a descriptor set layout!");
 
         DescriptorSetLayoutHandles.push_back(NewLayout);
+        AddLayoutInfo(DescriptorSetLayoutCreateInfo);
 
         return DescriptorSetLayoutHandles.size() - 1;
     }
@@ -122,6 +128,7 @@ public:
         VK_CHECK_RESULT(vkCreateDescriptorSetLayout(*Device->GetDeviceHandle(), &DescriptorSetLayoutCreateInfo, nullptr, &NewLayout), "[VulkanDescriptorSetsLayout]: Failed to create a descriptor set layout!");
 
         DescriptorSetLayoutHandles.push_back(NewLayout);
+        AddLayoutInfo(DescriptorSetLayoutCreateInfo);
 
         delete[] DescriptorSetLayoutBindings;
 
@@ -139,6 +146,7 @@ public:
         VK_CHECK_RESULT(vkCreateDescriptorSetLayout(*Device->GetDeviceHandle(), &DescriptorSetLayoutCreateInfo, nullptr, &NewLayout), "[VulkanDescriptorSetsLayout]: Failed to create a descriptor set layout!");
 
         DescriptorSetLayoutHandles.push_back(NewLayout);
+        AddLayoutInfo(DescriptorSetLayoutCreateInfo);
 
         return DescriptorSetLayoutHandles.size() - 1;
     }
@@ -156,12 +164,92 @@ public:
         return &DescriptorSetLayoutHandles[inLayoutId];
     }
 
+    /**
+    * What the descriptor allocator needs to know about a layout to size pools for it
+    */
+    struct FLayoutInfo
+    {
+        /** Hash of the bindings and flags, layouts with the same hash are identically defined and their sets interchangeable */
+        uint64 Hash;
+
+        /** Descriptors one set of the layout takes up per descriptor type */
+        std::vector<VkDescriptorPoolSize> PoolSizes;
+    };
+
+    const FLayoutInfo& GetLayoutInfo(uint32 inLayoutId) const
+    {
+        return LayoutInfos[inLayoutId];
+    }
+
+private:
+    void AddLayoutInfo(const VkDescriptorSetLayoutCreateInfo& inCreateInfo)
+    {
+        FLayoutInfo Info;
+        Info.Hash = XXHash64::Hash(&inCreateInfo.flags, sizeof(VkDescriptorSetLayoutCreateFlags));
+
+        for (uint32 i = 0; i < inCreateInfo.bindingCount; ++i)
+        {
+            const VkDescriptorSetLayoutBinding& Binding = inCreateInfo.pBindings[i];
+            const uint32 Fields[4] = { Binding.binding, (uint32)Binding.descriptorType, Binding.descriptorCount, Binding.stageFlags };
+            Info.Hash = XXHash64::Hash(Fields, sizeof(Fields), Info.Hash);
+
+            bool bFoundType = false;
+            for (VkDescriptorPoolSize& PoolSize : Info.PoolSizes)
+            {
+                if (PoolSize.type == Binding.descriptorType)
+                {
+                    PoolSize.descriptorCount += Binding.descriptorCount;
+                    bFoundType = true;
+                    break;
+                }
+            }
+
+            if (!bFoundType)
+            {
+                Info.PoolSizes.push_back({ Binding.descriptorType, Binding.descriptorCount });
+            }
+        }
+
+        LayoutInfos.push_back(Info);
+    }
+
 private:
     friend class VulkanPipelineLayout;
     friend class VulkanRenderInterface;
 
     VulkanDevice* Device;
     std::vector<VkDescriptorSetLayout> DescriptorSetLayoutHandles;
+
+    /** Parallel to DescriptorSetLayoutHandles */
+    std::vector<FLayoutInfo> LayoutInfos;
+};
+
+/**
+* How the handles of a VulkanDescriptorSets are allocated
+*/
+enum class EVulkanDescriptorSetAllocation
+{
+    /** Allocated up front and written to in place (ex: the bindless set) */
+    InPlace,
+
+    /** Allocated once its writes are flushed, sets with the same layout and writes share one handle */
+    Cached,
+};
+
+/**
+* One descriptor linked by LinkToBuffer/LinkToTexture, kept until the descriptor allocator flushes it
+*/
+struct FVulkanDescriptorWrite
+{
+public:
+    uint32 Binding;
+    uint32 ArrayElement;
+    uint32 DescriptorCount;
+    VkDescriptorType DescriptorType;
+
+    /** Only one of these is used depending on the descriptor type */
+    VkDescriptorBufferInfo BufferInfo;
+    VkDescriptorImageInfo ImageInfo;
 };
 
 /**
@@ -172,8 +260,11 @@ private:
 class VRIXIC_API VulkanDescriptorSets final : public IDescriptorSets
 {
     friend class VulkanDescriptorPool;
+    friend class VulkanDescriptorAllocator;
 public:
-    VulkanDescriptorSets(VulkanDevice* inDevice, uint32 inNumSets) : Device(inDevice), DescriptorSetHandles(inNumSets)
+    VulkanDescriptorSets(VulkanDevice* inDevice, uint32 inNumSets) 
+        : Device(inDevice), Allocator(nullptr), AllocationType(EVulkanDescriptorSetAllocation::InPlace), SetsLayout(nullptr), 
+        DescriptorSetHandles(inNumSets, VK_NULL_HANDLE), Writes(inNumSets), PendingWrites(inNumSets), bHasPendingWrites(false)
     {
         NumSets = inNumSets;
     }
@@ -196,6 +287,12 @@ public:
     */
     virtual void LinkToTexture(uint32 inIndex, const FDescriptorSetsLinkInfo& inDescriptorSetsLinkInfo) override;
 
+    /**
+    * Links are only recorded, this flushes every set with pending links (not just this one) so the handles are up to date
+    * Called before the handles are bound
+    */
+    void ResolvePendingWrites() const;
+
 public:
     /**
     * Gets a specific descriptor set handle by index
@@ -205,8 +302,10 @@ public:
     */
     VkDescriptorSet GetDescriptorSetHandle(uint32 inHandleIndex) const
     {
-        VE_ASSERT(inHandleIndex < DescriptorSetHandles.size(), VE_TEXT("[VulkanDescriptorSets]: Invalid descriptor set handle index provided -> {0}"), inHandleIndex)
-            return DescriptorSetHandles[inHandleIndex];
+        VE_ASSERT(inHandleIndex < DescriptorSetHandles.size(), VE_TEXT("[VulkanDescriptorSets]: Invalid descriptor set handle index provided -> {0}"), inHandleIndex);
+
+        ResolvePendingWrites();
+        return DescriptorSetHandles[inHandleIndex];
     }
 
     /**
@@ -214,8 +313,10 @@ public:
     */
     inline virtual void* GetRawDescriptorSetHandle(uint32 inIndex) const override final
     {
-        VE_ASSERT(inIndex < DescriptorSetHandles.size(), VE_TEXT("[VulkanDescriptorSets]: Invalid descriptor set handle index provided -> {0}"), inIndex)
-            return DescriptorSetHandles[inIndex];
+        VE_ASSERT(inIndex < DescriptorSetHandles.size(), VE_TEXT("[VulkanDescriptorSets]: Invalid descriptor set handle index provided -> {0}"), inIndex);
+
+        ResolvePendingWrites();
+        return DescriptorSetHandles[inIndex];
     }
 
     /**
@@ -228,7 +329,23 @@ public:
 
 private:
     VulkanDevice* Device;
+
+    /** Flushes the links, set by the render interface */
+    VulkanDescriptorAllocator* Allocator;
+    EVulkanDescriptorSetAllocation AllocationType;
+
+    /** Layout the sets are allocated with (layout id 0), unused by in place sets */
+    const VulkanDescriptorSetsLayout* SetsLayout;
+
     std::vector<VkDescriptorSet> DescriptorSetHandles;
+
+    /** Per set, every link sorted by binding and array element, identifies cached sets */
+    std::vector<std::vector<FVulkanDescriptorWrite>> Writes;
+
+    /** Per set, links not flushed yet for in place sets */
+    std::vector<std::vector<FVulkanDescriptorWrite>> PendingWrites;
+
+    std::atomic<bool> bHasPendingWrites;
 };
 
 /**
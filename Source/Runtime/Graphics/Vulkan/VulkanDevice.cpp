@@ -7,6 +7,7 @@
 #include "VulkanBuffer.h"
 #include <Misc/Defines/VulkanProfilerDefines.h>
 #include <Misc/Defines/StringDefines.h>
+#include <Runtime/Core/Math/VrixicMathHelper.h>
 
 #include <Runtime/Graphics/Vulkan/VulkanFence.h>
 #include <Runtime/Graphics/Vulkan/VulkanSemaphore.h>
@@ -396,7 +397,7 @@ void VulkanDevice::CopyBufferToTexture(const HCopyBufferTextureInfo& inCopyBuffe
 
     for (uint32 i = 0; i < inCopyBufferToTexture.Subresource->NumMipLevels; ++i)
     {
-        TotalFaceSize += ((inCopyBufferToTexture.Extent.width >> i) * (inCopyBufferToTexture.Extent.height >> i));
+        TotalFaceSize += (MathUtils::Max(inCopyBufferToTexture.Extent.width >> i, 1u) * MathUtils::Max(inCopyBufferToTexture.Extent.height >> i, 1u));
     }
     TotalFaceSize *= 4;
 
@@ -408,8 +409,8 @@ void VulkanDevice::CopyBufferToTexture(const HCopyBufferTextureInfo& inCopyBuffe
         for (uint32 mipLevel = 0; mipLevel < inCopyBufferToTexture.Subresource->NumMipLevels; ++mipLevel)
         {
             uint32 CurrentBufferCopyIndex = BufferImageCopyBaseIndex + mipLevel;
-            BufferImageCopies[CurrentBufferCopyIndex].imageExtent.width = inCopyBufferToTexture.Extent.width >> mipLevel;
-            BufferImageCopies[CurrentBufferCopyIndex].imageExtent.height = inCopyBufferToTexture.Extent.height >> mipLevel;
+            BufferImageCopies[CurrentBufferCopyIndex].imageExtent.width = MathUtils::Max(inCopyBufferToTexture.Extent.width >> mipLevel, 1u);
+            BufferImageCopies[CurrentBufferCopyIndex].imageExtent.height = MathUtils::Max(inCopyBufferToTexture.Extent.height >> mipLevel, 1u);
             BufferImageCopies[CurrentBufferCopyIndex].imageExtent.depth = inCopyBufferToTexture.Extent.depth;
 
             BufferImageCopies[CurrentBufferCopyIndex].bufferOffset = inCopyBufferToTexture.InitialBufferOffset + OffsetImage + BufferOffset; // (mipLevel * BufferImageCopies[i].imageExtent.width)
@@ -422,7 +423,7 @@ void VulkanDevice::CopyBufferToTexture(const HCopyBufferTextureInfo& inCopyBuffe
             BufferImageCopies[CurrentBufferCopyIndex].imageSubresource.baseArrayLayer = faceIndex;
             BufferImageCopies[CurrentBufferCopyIndex].imageSubresource.layerCount = 1;
 
-            BufferOffset += (BufferImageCopies[faceIndex].imageExtent.width * BufferImageCopies[faceIndex].imageExtent.height * 4);
+            BufferOffset += (BufferImageCopies[CurrentBufferCopyIndex].imageExtent.width * BufferImageCopies[CurrentBufferCopyIndex].imageExtent.height * 4);
         }
     }
 
@@ -449,14 +450,14 @@ void VulkanDevice::CopyBufferToTextureKtx(const HCopyBufferTextureInfo& inCopyBu
         for (uint32 mipLevel = 0; mipLevel < inCopyBufferToTexture.Subresource->NumMipLevels; ++mipLevel)
         {
             uint32 CurrentBufferCopyIndex = BufferImageCopyBaseIndex + mipLevel;
-            BufferImageCopies[CurrentBufferCopyIndex].imageExtent.width = inCopyBufferToTexture.Extent.width >> mipLevel;
-            BufferImageCopies[CurrentBufferCopyIndex].imageExtent.height = inCopyBufferToTexture.Extent.height >> mipLevel;
+            BufferImageCopies[CurrentBufferCopyIndex].imageExtent.width = MathUtils::Max(inCopyBufferToTexture.Extent.width >> mipLevel, 1u);
+            BufferImageCopies[CurrentBufferCopyIndex].imageExtent.height = MathUtils::Max(inCopyBufferToTexture.Extent.height >> mipLevel, 1u);
             BufferImageCopies[CurrentBufferCopyIndex].imageExtent.depth = inCopyBufferToTexture.Extent.depth;
 
             uint64 BufferOffset = 0;
             VE_FUNC_ASSERT(ktxTexture_GetImageOffset(KtxTextureHandle, mipLevel, 0, faceIndex, &BufferOffset), KTX_SUCCESS, VE_TEXT("KTX Texture: Failed to retreive image offset.."));
 
-            BufferImageCopies[CurrentBufferCopyIndex].bufferOffset = BufferOffset;
+            BufferImageCopies[CurrentBufferCopyIndex].bufferOffset = inCopyBufferToTexture.InitialBufferOffset + BufferOffset;
             BufferImageCopies[CurrentBufferCopyIndex].bufferRowLength = 0;
             BufferImageCopies[CurrentBufferCopyIndex].bufferImageHeight = 0;
 
@@ -612,7 +613,7 @@ VulkanQueue::VulkanQueue(VulkanDevice* device, uint32 queueFamilyIndex, uint32 q
 
     // Create the Command Pool associated with this queue
     CommandPool = new VulkanCommandPool(device);
-    CommandPool->CreateCommandPool(FamilyIndex);
+    CommandPool->CreateCommandPool(FamilyIndex, inQueueType);
 
     WaitStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
     if (inQueueType == ERenderQueueType::Transfer)
@@ -699,6 +700,48 @@ void VulkanQueue::Submit(ICommandBuffer* inCommandBuffer, IFence* inWaitFence)
     VK_CHECK_RESULT(vkQueueSubmit(Queue, 1, &SubmitInfo, WaitFence->GetFenceHandle()), "[VulkanQueue]: Failed to submit a command buffer to graphics queue!");
 }
 
+void VulkanQueue::Submit(const FCommandQueueSubmitInfo& inSubmitInfo)
+{
+    VE_PROFILE_VULKAN_FUNCTION();
+
+    std::vector<VkCommandBuffer> CommandBufferHandles(inSubmitInfo.NumCommandBuffers);
+    for (uint32 i = 0; i < inSubmitInfo.NumCommandBuffers; ++i)
+    {
+        CommandBufferHandles[i] = *((VulkanCommandBuffer*)inSubmitInfo.CommandBuffers[i])->GetCommandBufferHandle();
+    }
+
+    // Each semaphore object can hold more than one vulkan semaphore
+    std::vector<VkSemaphore> WaitSemaphoreHandles;
+    for (uint32 i = 0; i < inSubmitInfo.NumWaitSemaphores; ++i)
+    {
+        VulkanSemaphore* Semaphore = (VulkanSemaphore*)inSubmitInfo.WaitSemaphores[i];
+        WaitSemaphoreHandles.insert(WaitSemaphoreHandles.end(), Semaphore->GetSemaphoresHandle(), Semaphore->GetSemaphoresHandle() + Semaphore->GetSemaphoresCount());
+    }
+
+    std::vector<VkSemaphore> SignalSemaphoreHandles;
+    for (uint32 i = 0; i < inSubmitInfo.NumSignalSemaphores; ++i)
+    {
+        VulkanSemaphore* Semaphore = (VulkanSemaphore*)inSubmitInfo.SignalSemaphores[i];
+        SignalSemaphoreHandles.insert(SignalSemaphoreHandles.end(), Semaphore->GetSemaphoresHandle(), Semaphore->GetSemaphoresHandle() + Semaphore->GetSemaphoresCount());
+    }
+
+    // The queue a batch waits on can have produced anything, so nothing in the batch starts before the wait
+    std::vector<VkPipelineStageFlags> WaitStageMasks(WaitSemaphoreHandles.size(), VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+
+    VkSubmitInfo SubmitInfo = VulkanUtils::Initializers::SubmitInfo();
+    SubmitInfo.commandBufferCount = (uint32)CommandBufferHandles.size();
+    SubmitInfo.pCommandBuffers = CommandBufferHandles.data();
+    SubmitInfo.waitSemaphoreCount = (uint32)WaitSemaphoreHandles.size();
+    SubmitInfo.pWaitSemaphores = WaitSemaphoreHandles.data();
+    SubmitInfo.pWaitDstStageMask = WaitStageMasks.data();
+    SubmitInfo.signalSemaphoreCount = (uint32)SignalSemaphoreHandles.size();
+    SubmitInfo.pSignalSemaphores = SignalSemaphoreHandles.data();
+
+    VkFence FenceHandle = inSubmitInfo.Fence != nullptr ? ((VulkanFence*)inSubmitInfo.Fence)->GetFenceHandle() : VK_NULL_HANDLE;
+
+    VK_CHECK_RESULT(vkQueueSubmit(Queue, 1, &SubmitInfo, FenceHandle), "[VulkanQueue]: Failed to submit a batch of command buffers!");
+}
+
 void VulkanQueue::SetWaitFence(IFence* inWaitFence, uint64 inTimeout) const
 {
     VulkanFence* Fence = (VulkanFence*)inWaitFence;
@@ -180,6 +180,19 @@ public:
         return TransferQueue;
     }
 
+    inline VulkanQueue* GetQueue(ERenderQueueType inQueueType) const
+    {
+        switch (inQueueType)
+        {
+        case ERenderQueueType::Compute:
+            return ComputeQueue;
+        case ERenderQueueType::Transfer:
+            return TransferQueue;
+        default:
+            return GraphicsQueue;
+        }
+    }
+
     inline VulkanQueue* GetPresentQueue() const
     {
         return GraphicsQueue;
@@ -223,7 +236,9 @@ public:
     */
     uint32_t GetMemoryTypeIndex(uint32_t inTypeBits, VkMemoryPropertyFlags inProperties, VkBool32* outMemTypeFound) const;
 
-private:
+    /**
+    * @returns VkPipelineStageFlags the stages that can perform the accesses on a queue of the type passed in
+    */
     static VkPipelineStageFlags GetPipelineStageFlags(VkAccessFlags inAccessFlags, ERenderQueueType inQueueType);
 
 private:
@@ -314,6 +329,13 @@ public:
     */
     virtual void Submit(ICommandBuffer* inCommandBuffer, IFence* inWaitFence) override;
 
+    /**
+    * Submits a batch of command buffers with a single vkQueueSubmit, the waits block every stage of the batch
+    *
+    * @param inSubmitInfo the command buffers, semaphores and fence of the batch
+    */
+    virtual void Submit(const FCommandQueueSubmitInfo& inSubmitInfo) override;
+
     /**
     * Sets a wait fence that will block the CPU execution until the fence has been signaled
     *
@@ -12,6 +12,8 @@
 
 #include "VulkanTypeConverter.h"
 
+#include <atomic>
+
 /* ------------------------------------------------------------------------------- */
 /**
 * @TODO: Complete vulkan pipeline creation
@@ -175,11 +177,6 @@ public:
         {
             vkDestroyPipeline(*Device->GetDeviceHandle(), PipelineHandle, nullptr);
         }
-
-        if (PipelineCacheHandle != VK_NULL_HANDLE)
-        {
-            vkDestroyPipelineCache(*Device->GetDeviceHandle(), PipelineCacheHandle, nullptr);
-        }
     }
 
     VulkanPipeline(const VulkanPipeline& other) = delete;
@@ -191,6 +188,11 @@ public:
         return EPipelineBindPoint::Undefined;
     }
 
+    inline virtual bool IsReady() const override
+    {
+        return bIsReady.load(std::memory_order_acquire);
+    }
+
     inline const VkPipeline* GetPipelineHandle() const
     {
         return &PipelineHandle;
@@ -204,14 +206,19 @@ public:
 protected:
     VulkanDevice* Device;
     VkPipeline PipelineHandle;
+
+    /** Cache the pipeline was created with, not owned by the pipeline (pipelines created by the render interface share one) */
     VkPipelineCache PipelineCacheHandle;
 
     VulkanPipelineLayout* PipelineLayoutPtr;
 
+    /** Set once the pipeline handle is created, pipelines created asynchronously are not ready until their task finished */
+    std::atomic<bool> bIsReady;
+
 protected:
     VulkanPipeline(VulkanDevice* inDevice)
         : Device(inDevice), PipelineLayoutPtr(VK_NULL_HANDLE), 
-        PipelineHandle(VK_NULL_HANDLE), PipelineCacheHandle(VK_NULL_HANDLE){}
+        PipelineHandle(VK_NULL_HANDLE), PipelineCacheHandle(VK_NULL_HANDLE), bIsReady(false) {}
 };
 
 /**
@@ -232,6 +239,7 @@ public:
     void Create(VkGraphicsPipelineCreateInfo& inCreateInfo)
     {
         vkCreateGraphicsPipelines(*Device->GetDeviceHandle(), VK_NULL_HANDLE, 1, &inCreateInfo, nullptr, &PipelineHandle);
+        bIsReady.store(true, std::memory_order_release);
     }
 
     void Create(const FGraphicsPipelineConfig& inConfig, const char* inPipelineCachePath = nullptr)
@@ -332,6 +340,8 @@ public:
 
             delete[] CacheData;
         }
+
+        bIsReady.store(true, std::memory_order_release);
     }
 
 public:
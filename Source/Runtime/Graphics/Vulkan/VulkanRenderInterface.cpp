@@ -14,15 +14,24 @@
 #include <Runtime/Graphics/Vulkan/VulkanSampler.h>
 #include <Runtime/Graphics/Vulkan/VulkanSemaphore.h>
 #include <Runtime/Graphics/Vulkan/VulkanTextureView.h>
+#include <Runtime/Graphics/Vulkan/VulkanTransientHeap.h>
+#include <Runtime/File/DerivedDataCache.h>
 #include "VulkanCommandBufferManager.h"
+#include "VulkanDescriptorAllocator.h"
 
 #include <External/imgui/Includes/imgui.h>
 #include <External/imgui/Includes/imgui_impl_glfw.h>
 
 #include <External/glfw/Includes/GLFW/glfw3.h>
+#include <External/enkiTS/Includes/TaskScheduler.h>
+
+#include <thread>
 
 VulkanRenderInterface::HImGuiData VulkanRenderInterface::ImGuiData = { };
 
+/** Bump when the pipeline cache derived data changes in a way the key does not capture */
+static constexpr uint32 PIPELINE_CACHE_DERIVED_DATA_VERSION = 2;
+
 VulkanRenderInterface::VulkanRenderInterface(const FVulkanRendererConfig& inVulkanRendererConfig)
 {
     VE_FUNC_ASSERT(CreateVulkanInstance(inVulkanRendererConfig), true, "[VulkanRenderInterface]: failed to create a vulkan instance object..");
@@ -67,29 +76,13 @@ void VulkanRenderInterface::Initialize()
 
         // allocate 1 gibibytes of memory -> 1024 mebibytes = 1 gib
         VulkanMemoryHeapMain = new VulkanMemoryHeap(Device, 1024);
+
+        LoadPipelineCache();
     }
 
     // Create Descriptor Pools
     {
-        static const uint32 MAX_GLOBAL_POOL_ELEMENTS = 128;
-        VkDescriptorPoolSize DescriptorPoolSizes[] =
-        {
-            { VK_DESCRIPTOR_TYPE_SAMPLER, MAX_GLOBAL_POOL_ELEMENTS },
-            { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, MAX_GLOBAL_POOL_ELEMENTS },
-            { VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, MAX_GLOBAL_POOL_ELEMENTS },
-            { VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, MAX_GLOBAL_POOL_ELEMENTS },
-            { VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER, MAX_GLOBAL_POOL_ELEMENTS },
-            { VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER, MAX_GLOBAL_POOL_ELEMENTS },
-            { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, MAX_GLOBAL_POOL_ELEMENTS },
-            { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, MAX_GLOBAL_POOL_ELEMENTS },
-            { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, MAX_GLOBAL_POOL_ELEMENTS },
-            { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, MAX_GLOBAL_POOL_ELEMENTS },
-            { VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, MAX_GLOBAL_POOL_ELEMENTS}
-        };
-        uint32 ArraySize = (sizeof(DescriptorPoolSizes) / sizeof((DescriptorPoolSizes)[0]));
-        uint32 MaxSets = MAX_GLOBAL_POOL_ELEMENTS * ArraySize;
-
-        GlobalDescriptorPool = new VulkanDescriptorPool(Device, MaxSets, DescriptorPoolSizes, ArraySize);
+        DescriptorAllocator = new VulkanDescriptorAllocator(Device);
     }
     {
         BindlessDescriptorPool = nullptr;
@@ -152,9 +145,22 @@ void VulkanRenderInterface::Shutdown()
 {
     Device->WaitUntilIdle();
 
+    // Pipelines that were never freed may still be compiling into the pipeline cache
+    for (auto& SharedPipeline : SharedPipelines)
+    {
+        if (SharedPipeline.second.Task != nullptr)
+        {
+            SharedPipeline.second.Task->TaskScheduler->WaitforTask(SharedPipeline.second.Task);
+            delete SharedPipeline.second.Task;
+            SharedPipeline.second.Task = nullptr;
+        }
+    }
+
+    SavePipelineCache();
+
     delete CommandBufferManager;
 
-    delete GlobalDescriptorPool;
+    delete DescriptorAllocator;
     delete BindlessDescriptorPool;
 
     vkDestroyDescriptorSetLayout(*Device->GetDeviceHandle(), BindlessDescriptorSetLayout, nullptr);
@@ -226,6 +232,9 @@ void VulkanRenderInterface::ReadFromBuffer(Buffer* inBuffer, uint64 inOffset, vo
 
 void VulkanRenderInterface::Free(Buffer* inBuffer)
 {
+    // Cached descriptor sets are looked up by buffer handle, a new buffer could get the same one
+    DescriptorAllocator->InvalidateCache();
+
     // this is already handled in the memory heap side, but we can still clean up here 
     // bad should start using MemoryManager
     delete inBuffer;
@@ -368,10 +377,35 @@ void VulkanRenderInterface::SetTextureLayout(const TextureResource* inTexture, c
 
 void VulkanRenderInterface::Free(TextureResource* inTexture)
 {
+    DescriptorAllocator->InvalidateCache();
+
     // Just delete the texture
     delete inTexture;
 }
 
+FMemoryRequirements VulkanRenderInterface::GetTextureMemoryRequirements(const FTextureConfig& inTextureConfig)
+{
+    VkMemoryRequirements VkRequirements = VulkanTextureView::GetMemoryRequirements(Device, inTextureConfig);
+
+    FMemoryRequirements Requirements;
+    Requirements.Size = VkRequirements.size;
+    Requirements.Alignment = VkRequirements.alignment;
+    Requirements.MemoryTypeBits = VkRequirements.memoryTypeBits;
+
+    return Requirements;
+}
+
+ITransientHeap* VulkanRenderInterface::CreateTransientHeap(const FTransientHeapConfig& inTransientHeapConfig)
+{
+    return new VulkanTransientHeap(Device, inTransientHeapConfig);
+}
+
+void VulkanRenderInterface::Free(ITransientHeap* inTransientHeap)
+{
+    // Just delete the heap
+    delete inTransientHeap;
+}
+
 IFrameBuffer* VulkanRenderInterface::CreateFrameBuffer(const FFrameBufferConfig& inFrameBufferConfig)
 {
     VulkanFrameBuffer* FrameBuffer = new VulkanFrameBuffer(Device);
@@ -410,106 +444,442 @@ PipelineLayout* VulkanRenderInterface::CreatePipelineLayout(const FPipelineLayou
 {
     VulkanPipelineLayout* Layout = new VulkanPipelineLayout(Device, inPipelineLayoutConfig);
 
+    std::vector<VkPushConstantRange> PushConstantRanges(inPipelineLayoutConfig.NumPushConstantRanges);
+    for (uint32 i = 0; i < inPipelineLayoutConfig.NumPushConstantRanges; ++i)
+    {
+        const FPushConstantRange& Range = inPipelineLayoutConfig.PushConstantRanges[i];
+        PushConstantRanges[i].stageFlags = VulkanTypeConverter::ConvertShaderFlagsToVk(Range.StageFlags);
+        PushConstantRanges[i].offset = Range.Offset;
+        PushConstantRanges[i].size = Range.Size;
+    }
+
+    std::vector<VkPushConstantRange>* PushConstants = PushConstantRanges.size() > 0 ? &PushConstantRanges : nullptr;
+
     // meaning we have bindless set 
     if (inPipelineLayoutConfig.NumSets > 1)
     {
         Layout->GetDescriptorSetsLayoutHandle()->DescriptorSetLayoutHandles.push_back(BindlessDescriptorSetLayout);
-        Layout->Create(nullptr);
+        Layout->Create(PushConstants);
         Layout->GetDescriptorSetsLayoutHandle()->DescriptorSetLayoutHandles.pop_back();
 
         return Layout;
     }
 
-    Layout->Create(nullptr);
+    Layout->Create(PushConstants);
 
     return Layout;
 }
 
+/**
+* @returns uint64 hash of everything a pipeline layout is created from, the unused bindings and padding of the config are skipped
+*/
+static uint64 HashPipelineLayoutConfig(const FPipelineLayoutConfig& inConfig)
+{
+    uint64 Hash = XXHash64::Hash(&inConfig.NumSets, sizeof(uint32));
+    for (uint32 SetIndex = 0; SetIndex < inConfig.NumSets; ++SetIndex)
+    {
+        const FPipelineBindingDescriptor& BindingDescriptor = inConfig.BindingDescriptors[SetIndex];
+        for (uint32 BindingIndex = 0; BindingIndex < BindingDescriptor.NumBindings; ++BindingIndex)
+        {
+            const FPipelineBinding& Binding = BindingDescriptor.Bindings[BindingIndex];
+            const uint32 Fields[6] = { SetIndex, (uint32)Binding.ResourceType, Binding.BindFlags, Binding.StageFlags, Binding.NumResources, Binding.BindingIndex };
+            Hash = XXHash64::Hash(Fields, sizeof(Fields), Hash);
+        }
+    }
+
+    for (uint32 i = 0; i < inConfig.NumPushConstantRanges; ++i)
+    {
+        const FPushConstantRange& Range = inConfig.PushConstantRanges[i];
+        const uint32 Fields[3] = { Range.StageFlags, Range.Offset, Range.Size };
+        Hash = XXHash64::Hash(Fields, sizeof(Fields), Hash);
+    }
+
+    return Hash;
+}
+
 PipelineLayout* VulkanRenderInterface::CreatePipelineLayoutFromShaders(const Shader** inShaders, uint8 inNumShaders) const
 {
     FPipelineLayoutConfig LayoutConfig = { };
 
+    // The shaders were reflected when they were compiled, building the config is only a few copies
     for (uint8 shaderIndex = 0; shaderIndex < inNumShaders; ++shaderIndex)
     {
         VulkanShader* VulkShader = (VulkanShader*)inShaders[shaderIndex];
         VulkShader->ParseSpirvCodeIntoPipelineLayoutConfig(LayoutConfig);
     }
 
-    return CreatePipelineLayout(LayoutConfig);
+    const uint64 LayoutHash = HashPipelineLayoutConfig(LayoutConfig);
+
+    std::lock_guard<std::mutex> Lock(SharedPipelineLayoutMutex);
+
+    auto SharedLayout = SharedPipelineLayouts.find(LayoutHash);
+    if (SharedLayout != SharedPipelineLayouts.end())
+    {
+        SharedLayout->second.NumReferences++;
+        return SharedLayout->second.Layout;
+    }
+
+    PipelineLayout* Layout = CreatePipelineLayout(LayoutConfig);
+    SharedPipelineLayouts[LayoutHash] = { Layout, 1 };
+    SharedPipelineLayoutHashes[Layout] = LayoutHash;
+
+    return Layout;
 }
 
 void VulkanRenderInterface::Free(PipelineLayout* inPipelineLayout)
 {
+    {
+        std::lock_guard<std::mutex> Lock(SharedPipelineLayoutMutex);
+
+        auto LayoutHash = SharedPipelineLayoutHashes.find(inPipelineLayout);
+        if (LayoutHash != SharedPipelineLayoutHashes.end())
+        {
+            FSharedPipelineLayout& SharedLayout = SharedPipelineLayouts[LayoutHash->second];
+            if (--SharedLayout.NumReferences > 0)
+            {
+                return;
+            }
+
+            SharedPipelineLayouts.erase(LayoutHash->second);
+            SharedPipelineLayoutHashes.erase(LayoutHash);
+        }
+    }
+
     // Just delete the pipeline layout
     delete inPipelineLayout;
 }
 
-IPipeline* VulkanRenderInterface::CreatePipeline(const FGraphicsPipelineConfig& inGraphicsPipelineConfig)
+/**
+* Appends the bytes of inData to the pipeline key
+*/
+static void AppendToPipelineKey(std::vector<uint8>& outKey, const void* inData, size_t inSize)
 {
-    VulkanGraphicsPipeline* Pipeline = new VulkanGraphicsPipeline(Device);
-    Pipeline->Create(inGraphicsPipelineConfig);
-    return Pipeline;
+    const uint8* Bytes = (const uint8*)inData;
+    outKey.insert(outKey.end(), Bytes, Bytes + inSize);
 }
 
-IPipeline* VulkanRenderInterface::CreatePipelineWithCache(const FGraphicsPipelineConfig& inGraphicsPipelineConfig, const std::string& inPipelineCachePath)
+/**
+* Builds the key of everything a graphics pipeline is created from, two configs with equal keys create the same pipeline
+*   shaders are keyed by their binary and vertex input so equal shaders loaded twice still share pipelines,
+*   the render pass by its compatibility key so any compatible render pass shares them as well
+*
+* @param inLayoutKey identifies the pipeline layout, see GetPipelineLayoutKey()
+*/
+static void BuildGraphicsPipelineKey(const FGraphicsPipelineConfig& inConfig, uint64 inLayoutKey, std::vector<uint8>& outKey)
 {
-    VulkanGraphicsPipeline* Pipeline = new VulkanGraphicsPipeline(Device);
+    VulkanShader* VertexShader = (VulkanShader*)inConfig.VertexShader;
+    VulkanShader* FragmentShader = (VulkanShader*)inConfig.FragmentShader;
+
+    const uint32 ShaderSizes[2] = { (uint32)VertexShader->GetCompiledShaderBinarySize(), (uint32)FragmentShader->GetCompiledShaderBinarySize() };
+    AppendToPipelineKey(outKey, ShaderSizes, sizeof(ShaderSizes));
+    AppendToPipelineKey(outKey, VertexShader->GetCompiledShaderBinary(), ShaderSizes[0]);
+    AppendToPipelineKey(outKey, FragmentShader->GetCompiledShaderBinary(), ShaderSizes[1]);
+
+    const std::vector<VkVertexInputBindingDescription>& InputBindings = VertexShader->GetVertexInputBindings();
+    const std::vector<VkVertexInputAttributeDescription>& InputAttributes = VertexShader->GetVertexInputAttributes();
+    const uint32 NumInputs[2] = { (uint32)InputBindings.size(), (uint32)InputAttributes.size() };
+    AppendToPipelineKey(outKey, NumInputs, sizeof(NumInputs));
+    AppendToPipelineKey(outKey, InputBindings.data(), InputBindings.size() * sizeof(VkVertexInputBindingDescription));
+    AppendToPipelineKey(outKey, InputAttributes.data(), InputAttributes.size() * sizeof(VkVertexInputAttributeDescription));
+
+    // Pipelines can be used with any render pass compatible with the one they were created with
+    const std::vector<uint32>& RenderPassKey = ((const VulkanRenderPass*)inConfig.RenderPassPtr)->GetCompatibilityKey();
+    const uint32 RenderPassKeySize = (uint32)RenderPassKey.size();
+    AppendToPipelineKey(outKey, &RenderPassKeySize, sizeof(uint32));
+    AppendToPipelineKey(outKey, RenderPassKey.data(), RenderPassKey.size() * sizeof(uint32));
+    AppendToPipelineKey(outKey, &inLayoutKey, sizeof(uint64));
+
+    // Fixed function state, copied field by field so the padding of the configs is not part of the key
+    const FRasterizerConfig& Raster = inConfig.RasterizerState;
+    const FDepthConfig& Depth = inConfig.DepthState;
+    const FStencilStateConfig& Stencil = inConfig.StencilState;
+    const FBlendStateConfig& Blend = inConfig.BlendState;
+
+    const uint32 State[] =
+    {
+        (uint32)inConfig.PrimitiveTopology, (uint32)inConfig.Viewports.size(), (uint32)inConfig.Scissors.size(),
+        (uint32)Raster.PolygonMode, (uint32)Raster.CullMode, (uint32)Raster.FrontFace,
+        Raster.bDepthClampEnabled, Raster.bRasterizerDiscardEnabled, Raster.bDepthBiasEnabled,
+        Depth.bIsTestingEnabled, Depth.bIsWritingEnabled, (uint32)Depth.CompareOp,
+        Stencil.bIsTestingEnabled, Stencil.bIsReferenceValueDynamic,
+        (uint32)Stencil.Front.StencilFailOp, (uint32)Stencil.Front.StencilPassOp, (uint32)Stencil.Front.DepthFailOp, (uint32)Stencil.Front.CompareOp,
+        Stencil.Front.CompareMask, Stencil.Front.WriteMask, Stencil.Front.ReferenceValue,
+        (uint32)Stencil.Back.StencilFailOp, (uint32)Stencil.Back.StencilPassOp, (uint32)Stencil.Back.DepthFailOp, (uint32)Stencil.Back.CompareOp,
+        Stencil.Back.CompareMask, Stencil.Back.WriteMask, Stencil.Back.ReferenceValue,
+        Blend.bAlphaToCoverageEnabled, Blend.bIndependentBlendEnabled, Blend.SampleMask, (uint32)Blend.LogicOp, Blend.bIsBlendFactorDynamic,
+        Blend.GetNumBlendOpConfigs()
+    };
+    AppendToPipelineKey(outKey, State, sizeof(State));
+
+    const float FloatState[] =
+    {
+        Raster.DepthBias.ConstantFactor, Raster.DepthBias.Clamp, Raster.DepthBias.SlopeFactor, Raster.LineWidth,
+        Blend.BlendConstants[0], Blend.BlendConstants[1], Blend.BlendConstants[2], Blend.BlendConstants[3]
+    };
+    AppendToPipelineKey(outKey, FloatState, sizeof(FloatState));
 
-    VkPipelineCache PipelineCache = VK_NULL_HANDLE;
-    VkPipelineCacheCreateInfo PipelineCacheCreateInfo{ VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO };
+    for (const FBlendOpConfig& BlendOp : Blend.BlendOpConfigs)
+    {
+        const uint32 BlendOpState[8] =
+        {
+            BlendOp.bIsBlendEnabled, (uint32)BlendOp.SrcColorBlendFactor, (uint32)BlendOp.DstColorBlendFactor, (uint32)BlendOp.ColorBlendOp,
+            (uint32)BlendOp.SrcAlphaBlendFactor, (uint32)BlendOp.DstAlphaBlendFactor, (uint32)BlendOp.AlphaBlendOp, BlendOp.ColorWriteMask
+        };
+        AppendToPipelineKey(outKey, BlendOpState, sizeof(BlendOpState));
+    }
+
+    // Empty viewports and scissors make them dynamic, the counts above already tell those apart
+    AppendToPipelineKey(outKey, inConfig.Viewports.data(), inConfig.Viewports.size() * sizeof(FRenderViewport));
+    AppendToPipelineKey(outKey, inConfig.Scissors.data(), inConfig.Scissors.size() * sizeof(FRenderScissor));
+}
 
-    WIN32_FILE_ATTRIBUTE_DATA FileInformation;
-    bool bShouldCreateNewCache = GetFileAttributesExA(inPipelineCachePath.c_str(), GetFileExInfoStandard, &FileInformation);
-    if (bShouldCreateNewCache)
+uint64 VulkanRenderInterface::GetPipelineLayoutKey(const PipelineLayout* inPipelineLayout) const
+{
+    std::lock_guard<std::mutex> Lock(SharedPipelineLayoutMutex);
+
+    auto LayoutHash = SharedPipelineLayoutHashes.find(inPipelineLayout);
+    if (LayoutHash != SharedPipelineLayoutHashes.end())
     {
-        FILE* FileHandle = fopen(inPipelineCachePath.c_str(), "rb");
+        return LayoutHash->second;
+    }
 
-        uint8* Data = nullptr;
-        uint64 DataSize = 0;
-        if (FileHandle) {
+    // Layouts not created from shaders are not shared, the layout itself is all there is to tell them apart
+    return (uint64)(uintptr_t)inPipelineLayout;
+}
 
-            fseek(FileHandle, 0, SEEK_END);
-            DataSize = ftell(FileHandle);
-            fseek(FileHandle, 0, SEEK_SET);
+/**
+* Compiles one pipeline on a worker thread, owns a copy of the config as the caller's one may be gone by then
+*/
+struct FPipelineCompileTaskSet : enki::ITaskSet
+{
+    enki::TaskScheduler* TaskScheduler;
+    VulkanGraphicsPipeline* Pipeline;
+    VkPipelineCache PipelineCache;
+    FGraphicsPipelineConfig Config;
 
-            Data = (uint8*)new uint8[DataSize];
-            fread(Data, DataSize, 1, FileHandle);
+    void ExecuteRange(enki::TaskSetPartition inRange, uint32_t /*inThreadNum*/) override
+    {
+        // The pipeline cache is internally synchronized, any number of pipelines can be created against it at once
+        Pipeline->Create(Config, PipelineCache);
+    }
+};
 
-            fclose(FileHandle);
-        }
+VulkanGraphicsPipeline* VulkanRenderInterface::AcquirePipeline(const FGraphicsPipelineConfig& inConfig, bool& outIsNew, FPipelineCompileTaskSet*& outTask)
+{
+    std::vector<uint8> PipelineKey;
+    BuildGraphicsPipelineKey(inConfig, GetPipelineLayoutKey(inConfig.PipelineLayoutPtr), PipelineKey);
+    const uint64 PipelineHash = XXHash64::Hash(PipelineKey.data(), PipelineKey.size());
 
-        VkPipelineCacheHeaderVersionOne* PipelineCacheHeader = (VkPipelineCacheHeaderVersionOne*)Data;
+    std::lock_guard<std::mutex> Lock(SharedPipelineMutex);
 
-        if (PipelineCacheHeader->deviceID == Device->GetPhysicalDeviceProperties()->deviceID &&
-            PipelineCacheHeader->vendorID == Device->GetPhysicalDeviceProperties()->vendorID &&
-            memcmp(PipelineCacheHeader->pipelineCacheUUID, Device->GetPhysicalDeviceProperties()->pipelineCacheUUID, VK_UUID_SIZE) == 0)
+    auto SharedPipeline = SharedPipelines.find(PipelineHash);
+    if (SharedPipeline != SharedPipelines.end())
+    {
+        if (SharedPipeline->second.Key == PipelineKey)
         {
-            PipelineCacheCreateInfo.initialDataSize = DataSize;
-            PipelineCacheCreateInfo.pInitialData = Data;
+            SharedPipeline->second.NumReferences++;
 
-            bShouldCreateNewCache = false;
+            outIsNew = false;
+            outTask = SharedPipeline->second.Task;
+            return SharedPipeline->second.Pipeline;
         }
 
-        vkCreatePipelineCache(*Device->GetDeviceHandle(), &PipelineCacheCreateInfo, nullptr, &PipelineCache);
+        // Hash collision with a different config, the pipeline is still created but not shared
+        VE_CORE_LOG_WARN(VE_TEXT("[VulkanRenderInterface]: Pipeline hash {0} collides with a different config, creating an unshared pipeline"), PipelineHash);
+
+        outIsNew = true;
+        outTask = nullptr;
+        return new VulkanGraphicsPipeline(Device);
+    }
+
+    // Added before it is created so other threads asking for the same pipeline wait for it instead of creating it again
+    VulkanGraphicsPipeline* Pipeline = new VulkanGraphicsPipeline(Device);
+    SharedPipelines[PipelineHash] = { Pipeline, 1, nullptr, std::move(PipelineKey) };
+    SharedPipelineHashes[Pipeline] = PipelineHash;
+
+    outIsNew = true;
+    outTask = nullptr;
+    return Pipeline;
+}
+
+IPipeline* VulkanRenderInterface::CreatePipeline(const FGraphicsPipelineConfig& inGraphicsPipelineConfig)
+{
+    bool bIsNew = false;
+    FPipelineCompileTaskSet* Task = nullptr;
+    VulkanGraphicsPipeline* Pipeline = AcquirePipeline(inGraphicsPipelineConfig, bIsNew, Task);
+
+    if (bIsNew)
+    {
+        Pipeline->Create(inGraphicsPipelineConfig, SharedPipelineCache);
+        return Pipeline;
+    }
 
-        delete[] Data;
+    // Callers of the synchronous path expect a pipeline they can bind right away
+    if (Task != nullptr)
+    {
+        Task->TaskScheduler->WaitforTask(Task);
     }
-    else
+
+    // Being created by another thread
+    while (!Pipeline->IsReady())
     {
-        vkCreatePipelineCache(*Device->GetDeviceHandle(), &PipelineCacheCreateInfo, nullptr, &PipelineCache);
-        bShouldCreateNewCache = true;
+        std::this_thread::yield();
     }
 
-    Pipeline->Create(inGraphicsPipelineConfig, PipelineCache, bShouldCreateNewCache ? inPipelineCachePath.c_str() : nullptr);
+    return Pipeline;
+}
+
+IPipeline* VulkanRenderInterface::CreatePipelineWithCache(const FGraphicsPipelineConfig& inGraphicsPipelineConfig, const std::string& inPipelineCachePath)
+{
+    // Every pipeline goes through the shared pipeline cache now, one cache entry holds all of them
+    return CreatePipeline(inGraphicsPipelineConfig);
+}
+
+IPipeline* VulkanRenderInterface::CreatePipelineAsync(const FGraphicsPipelineConfig& inGraphicsPipelineConfig, enki::TaskScheduler* inTaskScheduler)
+{
+    if (inTaskScheduler == nullptr)
+    {
+        return CreatePipeline(inGraphicsPipelineConfig);
+    }
+
+    bool bIsNew = false;
+    FPipelineCompileTaskSet* Task = nullptr;
+    VulkanGraphicsPipeline* Pipeline = AcquirePipeline(inGraphicsPipelineConfig, bIsNew, Task);
+
+    if (!bIsNew)
+    {
+        return Pipeline;
+    }
+
+    // Unshared pipelines have no entry to publish a task under, those few are created right away
+    bool bIsShared = false;
+    {
+        std::lock_guard<std::mutex> Lock(SharedPipelineMutex);
+        bIsShared = SharedPipelineHashes.find(Pipeline) != SharedPipelineHashes.end();
+    }
+
+    if (!bIsShared)
+    {
+        Pipeline->Create(inGraphicsPipelineConfig, SharedPipelineCache);
+        return Pipeline;
+    }
+
+    Task = new FPipelineCompileTaskSet();
+    Task->TaskScheduler = inTaskScheduler;
+    Task->Pipeline = Pipeline;
+    Task->PipelineCache = SharedPipelineCache;
+    Task->Config = inGraphicsPipelineConfig;
+
+    {
+        // Published before the task starts so anyone else acquiring the pipeline can wait on it
+        std::lock_guard<std::mutex> Lock(SharedPipelineMutex);
+        SharedPipelines[SharedPipelineHashes[Pipeline]].Task = Task;
+    }
+
+    inTaskScheduler->AddTaskSetToPipe(Task);
+
     return Pipeline;
 }
 
 void VulkanRenderInterface::Free(IPipeline* inPipeline)
 {
-    // Just delete the pipeline
+    FPipelineCompileTaskSet* Task = nullptr;
+    {
+        std::lock_guard<std::mutex> Lock(SharedPipelineMutex);
+
+        auto PipelineHash = SharedPipelineHashes.find(inPipeline);
+        if (PipelineHash != SharedPipelineHashes.end())
+        {
+            FSharedPipeline& SharedPipeline = SharedPipelines[PipelineHash->second];
+            if (--SharedPipeline.NumReferences > 0)
+            {
+                return;
+            }
+
+            Task = SharedPipeline.Task;
+
+            SharedPipelines.erase(PipelineHash->second);
+            SharedPipelineHashes.erase(PipelineHash);
+        }
+    }
+
+    // The worker could still be creating the pipeline
+    if (Task != nullptr)
+    {
+        Task->TaskScheduler->WaitforTask(Task);
+        delete Task;
+    }
+
     delete inPipeline;
 }
 
+uint64 VulkanRenderInterface::GetPipelineCacheDerivedDataKey() const
+{
+    const VkPhysicalDeviceProperties* DeviceProperties = Device->GetPhysicalDeviceProperties();
+
+    FDerivedDataKeyBuilder KeyBuilder("PipelineCache", PIPELINE_CACHE_DERIVED_DATA_VERSION);
+    KeyBuilder.AppendValue(DeviceProperties->vendorID);
+    KeyBuilder.AppendValue(DeviceProperties->deviceID);
+    KeyBuilder.AppendValue(DeviceProperties->driverVersion);
+    KeyBuilder.Append(DeviceProperties->pipelineCacheUUID, VK_UUID_SIZE);
+
+    return KeyBuilder.GetKey();
+}
+
+void VulkanRenderInterface::LoadPipelineCache()
+{
+    const VkPhysicalDeviceProperties* DeviceProperties = Device->GetPhysicalDeviceProperties();
+
+    VkPipelineCacheCreateInfo PipelineCacheCreateInfo{ VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO };
+    SharedPipelineCacheLoadedSize = 0;
+
+    FDerivedData CachedData;
+    if (DerivedDataCache::Get().Get(GetPipelineCacheDerivedDataKey(), CachedData) && CachedData.Data.Size >= sizeof(VkPipelineCacheHeaderVersionOne))
+    {
+        VkPipelineCacheHeaderVersionOne PipelineCacheHeader;
+        memcpy(&PipelineCacheHeader, CachedData.Data.Data, sizeof(VkPipelineCacheHeaderVersionOne));
+
+        if (PipelineCacheHeader.deviceID == DeviceProperties->deviceID &&
+            PipelineCacheHeader.vendorID == DeviceProperties->vendorID &&
+            memcmp(PipelineCacheHeader.pipelineCacheUUID, DeviceProperties->pipelineCacheUUID, VK_UUID_SIZE) == 0)
+        {
+            // The driver copies the data, the mapped entry does not have to outlive the cache
+            PipelineCacheCreateInfo.initialDataSize = CachedData.Data.Size;
+            PipelineCacheCreateInfo.pInitialData = CachedData.Data.Data;
+
+            SharedPipelineCacheLoadedSize = CachedData.Data.Size;
+        }
+    }
+
+    SharedPipelineCache = VK_NULL_HANDLE;
+    VK_CHECK_RESULT(vkCreatePipelineCache(*Device->GetDeviceHandle(), &PipelineCacheCreateInfo, nullptr, &SharedPipelineCache), VE_TEXT("[VulkanRenderInterface]: Failed to create the pipeline cache!!"));
+
+    VE_CORE_LOG_INFO(VE_TEXT("[VulkanRenderInterface]: Pipeline cache seeded with {0} bytes"), SharedPipelineCacheLoadedSize);
+}
+
+void VulkanRenderInterface::SavePipelineCache()
+{
+    if (SharedPipelineCache == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    uint64 CacheSize = 0;
+    vkGetPipelineCacheData(*Device->GetDeviceHandle(), SharedPipelineCache, &CacheSize, nullptr);
+
+    // Nothing was compiled that the cache did not already have
+    if (CacheSize != SharedPipelineCacheLoadedSize)
+    {
+        std::vector<uint8> CacheData(CacheSize);
+        vkGetPipelineCacheData(*Device->GetDeviceHandle(), SharedPipelineCache, &CacheSize, CacheData.data());
+
+        DerivedDataCache::Get().Put(GetPipelineCacheDerivedDataKey(), CacheData.data(), CacheSize);
+    }
+
+    vkDestroyPipelineCache(*Device->GetDeviceHandle(), SharedPipelineCache, nullptr);
+    SharedPipelineCache = VK_NULL_HANDLE;
+}
+
 ISemaphore* VulkanRenderInterface::CreateRenderSemaphore(const FSemaphoreConfig& inSemaphoreConfig)
 {
     VulkanSemaphore* Semaphore = new VulkanSemaphore(Device);
@@ -541,6 +911,21 @@ Shader* VulkanRenderInterface::CreateShader(const FShaderConfig& inShaderConfig)
     return ShaderPtr;
 }
 
+void VulkanRenderInterface::PrecompileShaders(const FShaderConfig* inShaderConfigs, uint32 inNumShaderConfigs, enki::TaskScheduler* inTaskScheduler)
+{
+    ShaderFactoryMain->PrecompileShaders(inShaderConfigs, inNumShaderConfigs, inTaskScheduler);
+}
+
+void VulkanRenderInterface::AddShaderIncludeDirectory(const std::string& inDirectoryPath)
+{
+    ShaderFactoryMain->AddIncludeDirectory(inDirectoryPath);
+}
+
+void VulkanRenderInterface::GetDependentShaders(const std::string& inFilePath, std::vector<std::string>& outShaderPaths) const
+{
+    ShaderFactoryMain->GetDependentShaders(inFilePath, outShaderPaths);
+}
+
 void VulkanRenderInterface::Free(Shader* inShader)
 {
     // Just delete the shader
@@ -557,6 +942,8 @@ Sampler* VulkanRenderInterface::CreateSampler(const FSamplerConfig& inSamplerCon
 
 void VulkanRenderInterface::Free(Sampler* inSampler)
 {
+    DescriptorAllocator->InvalidateCache();
+
     // Just delete the sampler
     delete inSampler;
 }
@@ -568,21 +955,30 @@ IDescriptorSets* VulkanRenderInterface::CreateDescriptorSet(FDescriptorSetsConfi
     if (inDescriptorSetConfig.bIsBindlessSet)
     {
         VE_ASSERT(BindlessDescriptorPool->AllocateDescriptorSets(DescriptorSet, &BindlessDescriptorSetLayout), VE_TEXT("[VulkanRenderInterface]: Failed to allocate a descriptor set that is bindless..."));
+        DescriptorAllocator->Register(DescriptorSet, nullptr, EVulkanDescriptorSetAllocation::InPlace);
         return DescriptorSet;
     }
 
+    // The sets are allocated once they are first bound, by then their links are known and identical sets can be shared
     VulkanPipelineLayout* VPipelineLayout = (VulkanPipelineLayout*)inDescriptorSetConfig.PipelineLayoutPtr;
-    VE_ASSERT(GlobalDescriptorPool->AllocateDescriptorSets(DescriptorSet, VPipelineLayout->GetDescriptorSetsLayoutHandle(), 0), VE_TEXT("[VulkanRenderInterface]: Failed to allocate a descriptor set that is bindless..."));
+    DescriptorAllocator->Register(DescriptorSet, VPipelineLayout->GetDescriptorSetsLayoutHandle(), EVulkanDescriptorSetAllocation::Cached);
 
     return DescriptorSet;
 }
 
 void VulkanRenderInterface::Free(IDescriptorSets* inDescriptorSets)
 {
+    DescriptorAllocator->Release((VulkanDescriptorSets*)inDescriptorSets);
+
     // Just delete the descriptor set(s)
     delete inDescriptorSets;
 }
 
+void VulkanRenderInterface::BeginFrame(uint32 inFrameIndex)
+{
+    DescriptorAllocator->BeginFrame(inFrameIndex);
+}
+
 bool VulkanRenderInterface::SupportsBindlessTexturing() const
 {
     return Device->SupportsBindlessTexturing();
@@ -11,10 +11,15 @@
 
 #include <imgui_impl_vulkan.h>
 
+#include <mutex>
+#include <unordered_map>
+
 class VulkanFrameBuffer;
+class VulkanGraphicsPipeline;
 class VulkanMemoryHeap;
 class VulkanRenderLayout;
 class VulkanRenderPass;
+struct FPipelineCompileTaskSet;
 
 /**
 * Vulkans implementation of the render interface
@@ -167,6 +172,29 @@ public:
     */
     virtual void Free(TextureResource* inTexture) override;
 
+    /**
+    * @returns FMemoryRequirements the memory a texture created with inTextureConfig needs when placed in a transient heap
+    */
+    virtual FMemoryRequirements GetTextureMemoryRequirements(const FTextureConfig& inTextureConfig) override;
+
+    /* ------------------------------------------------------------------------------- */
+    /* -------------                Transient Heaps                ------------------- */
+    /* ------------------------------------------------------------------------------- */
+
+    /**
+    * Creates a new heap resources can be placed in (FTextureConfig::TransientHeap)
+    *
+    * @param inTransientHeapConfig info used to create the heap
+    */
+    virtual ITransientHeap* CreateTransientHeap(const FTransientHeapConfig& inTransientHeapConfig) override;
+
+    /**
+    * Releases/Destroys the heap passed in, the resources placed in it have to be freed first
+    *
+    * @param inTransientHeap the heap to free
+    */
+    virtual void Free(ITransientHeap* inTransientHeap) override;
+
     /* ------------------------------------------------------------------------------- */
     /* -------------                  Frame Buffers                ------------------- */
     /* ------------------------------------------------------------------------------- */
@@ -222,7 +250,7 @@ public:
     virtual PipelineLayout* CreatePipelineLayout(const FPipelineLayoutConfig& inPipelineLayoutConfig) const override;
 
     /**
-    * Creates a pipeline layout from all the shaders passed in
+    * Creates a pipeline layout from all the shaders passed in, shaders with the same reflected bindings and push constants share one layout
     * @note: the shaders being passed in should be all the shaders the pipeline layout might be using
     *
     * @param inShaders the shaders that will be used to create the pipeline layout
@@ -231,7 +259,7 @@ public:
     virtual PipelineLayout* CreatePipelineLayoutFromShaders(const Shader** inShaders, uint8 inNumShaders) const override;
 
     /**
-    * Releases/Destroys the pipeline layout passed in
+    * Releases/Destroys the pipeline layout passed in, shared layouts are destroyed once every user freed them
     *
     * @param inPipelineLayout the pipeline layout to free
     */
@@ -241,7 +269,7 @@ public:
     /* ------------------------------------------------------------------------------- */
 
     /**
-    * Creates a new graphics pipeline with the specified configurations
+    * Creates a new graphics pipeline with the specified configurations, configs with the same hash share one pipeline
     *
     * @param inGraphicsPipelineConfig info used to create the graphics pipeline
     */
@@ -251,12 +279,20 @@ public:
     * Creates a new graphics pipeline with the specified configurations and with a pipeline cache
     *
     * @param inGraphicsPipelineConfig info used to create the graphics pipeline
-    * @param inPipelineCachePath the path to the pipeline cache
+    * @param inPipelineCachePath only names the pipeline, the shared pipeline cache is used
     */
     virtual IPipeline* CreatePipelineWithCache(const FGraphicsPipelineConfig& inGraphicsPipelineConfig, const std::string& inPipelineCachePath) override;
 
     /**
-    * Releases/Destroys the pipeline passed in
+    * Creates a new graphics pipeline on a worker thread, IPipeline::IsReady() tells when it can be bound
+    *
+    * @param inGraphicsPipelineConfig info used to create the graphics pipeline
+    * @param inTaskScheduler scheduler the pipeline is compiled on, compiled on the calling thread if nullptr
+    */
+    virtual IPipeline* CreatePipelineAsync(const FGraphicsPipelineConfig& inGraphicsPipelineConfig, enki::TaskScheduler* inTaskScheduler) override;
+
+    /**
+    * Releases/Destroys the pipeline passed in, shared pipelines are destroyed once every user freed them
     *
     * @param inPipeline the pipeline to free
     */
@@ -307,6 +343,27 @@ public:
   */
     virtual Shader* CreateShader(const FShaderConfig& inShaderConfig) override;
 
+    /**
+    * Compiles shaders ahead of time so that creating them later does not have to wait on the compiler
+    *
+    * @param inShaderConfigs configs of the shaders that will be created later
+    * @param inTaskScheduler optional, when set the shaders are compiled in parallel
+    */
+    virtual void PrecompileShaders(const FShaderConfig* inShaderConfigs, uint32 inNumShaderConfigs, enki::TaskScheduler* inTaskScheduler) override;
+
+    /**
+    * Adds a directory shaders can #include files from, has to be called before any shader is compiled
+    */
+    virtual void AddShaderIncludeDirectory(const std::string& inDirectoryPath) override;
+
+    /**
+    * Collects the shaders that include a file, directly or through other includes, so only those have to be recompiled when it changes
+    *
+    * @param inFilePath the changed file
+    * @param outShaderPaths the paths of the shaders depending on the file are appended to this
+    */
+    virtual void GetDependentShaders(const std::string& inFilePath, std::vector<std::string>& outShaderPaths) const override;
+
     /**
     * Releases/Destroys the shader passed in
     *
@@ -350,6 +407,8 @@ public:
     */
     virtual void Free(IDescriptorSets* inDescriptorSets) override;
 
+    virtual void BeginFrame(uint32 inFrameIndex) override;
+
     /**
     * @returns bool true if the graphics card supports bindless texturing, false otherwise
     */
@@ -426,6 +485,11 @@ public:
         return Device->GetTransferQueue();
     }
 
+    virtual ICommandQueue* GetComputeQueue()
+    {
+        return Device->GetComputeQueue();
+    }
+
     /** --  IRenderInterface End -- */
 
     VkInstance GetVulkanInstance() const
@@ -455,6 +519,35 @@ private:
     */
     VkPhysicalDeviceFeatures Convert(const FPhysicalDeviceFeatures& inFeatures);
 
+    /**
+    * Creates the pipeline cache every pipeline is created against, seeded from the derived data cache when the driver can use the cached data
+    */
+    void LoadPipelineCache();
+
+    /**
+    * Writes the pipeline cache to the derived data cache if pipelines were added to it, then destroys it
+    */
+    void SavePipelineCache();
+
+    /**
+    * @returns uint64 derived data key of the pipeline cache, the data is only valid for one device and driver
+    */
+    uint64 GetPipelineCacheDerivedDataKey() const;
+
+    /**
+    * Finds the pipeline created from an equal config or adds a new pipeline that still has to be created
+    * Either way the pipeline gets one more reference, a config whose hash collides with a different one gets a new unshared pipeline
+    *
+    * @param outIsNew true if the caller has to create the pipeline
+    * @param outTask the task compiling the pipeline if it was created asynchronously, stays valid as long as the reference
+    */
+    VulkanGraphicsPipeline* AcquirePipeline(const FGraphicsPipelineConfig& inConfig, bool& outIsNew, FPipelineCompileTaskSet*& outTask);
+
+    /**
+    * @returns uint64 hash of the layout config for layouts shared through CreatePipelineLayoutFromShaders(), the address for any other layout
+    */
+    uint64 GetPipelineLayoutKey(const PipelineLayout* inPipelineLayout) const;
+
 private:
     /** The vulkan instance */
     VkInstance VulkanInstance;
@@ -493,10 +586,52 @@ private:
     /** Main memory heap for all vulkan allocation, (Index, Vertex, storage buffers, etc...) */
     VulkanMemoryHeap* VulkanMemoryHeapMain;
 
+    /** A layout created from shaders along with how many CreatePipelineLayoutFromShaders() calls returned it */
+    struct FSharedPipelineLayout
+    {
+        PipelineLayout* Layout;
+        uint32 NumReferences;
+    };
+
+    /** Hash of the layout config -> layout, lets pipelines built from shaders with the same signature share their layout */
+    mutable std::unordered_map<uint64, FSharedPipelineLayout> SharedPipelineLayouts;
+
+    /** Layout -> hash it is stored under in SharedPipelineLayouts */
+    mutable std::unordered_map<const PipelineLayout*, uint64> SharedPipelineLayoutHashes;
+    mutable std::mutex SharedPipelineLayoutMutex;
+
+    /** A pipeline along with how many create calls returned it */
+    struct FSharedPipeline
+    {
+        VulkanGraphicsPipeline* Pipeline;
+        uint32 NumReferences;
+
+        /** Set if the pipeline is (or was) compiled asynchronously, deleted along with the pipeline */
+        FPipelineCompileTaskSet* Task;
+
+        /** Everything the pipeline was created from, compared on a hash hit so a collision never shares the wrong pipeline */
+        std::vector<uint8> Key;
+    };
+
+    /** Hash of the graphics pipeline key -> pipeline */
+    std::unordered_map<uint64, FSharedPipeline> SharedPipelines;
+
+    /** Pipeline -> hash it is stored under in SharedPipelines */
+    std::unordered_map<const IPipeline*, uint64> SharedPipelineHashes;
+    std::mutex SharedPipelineMutex;
+
+    /** Every pipeline is created against this cache, written to the derived data cache once on shutdown */
+    VkPipelineCache SharedPipelineCache;
+
+    /** Size of the data the pipeline cache was seeded with, the cache is only written back if it grew */
+    uint64 SharedPipelineCacheLoadedSize;
+
     /** Used when bindless is available for texture bindings */
     VkDescriptorSetLayout BindlessDescriptorSetLayout;
     class VulkanDescriptorPool* BindlessDescriptorPool;
-    class VulkanDescriptorPool* GlobalDescriptorPool;
+
+    /** Allocates and writes every descriptor set that is not bindless */
+    class VulkanDescriptorAllocator* DescriptorAllocator;
 
     class VulkanCommandBufferManager* CommandBufferManager;
 
@@ -133,6 +133,8 @@ VulkanRenderPass::VulkanRenderPass(VulkanDevice* inDevice, VulkanRenderLayout& i
 
     VK_CHECK_RESULT(vkCreateRenderPass(*Device->GetDeviceHandle(), &RenderPassInfo, nullptr, &RenderPassHandle), "[VulkanRenderPass]: Failed to create a render pass!");
 
+    BuildCompatibilityKey(AttachmentDescs, RenderPassInfo.attachmentCount, SubpassDesc);
+
     delete[] AttachmentDescs;
 }
 
@@ -212,6 +214,36 @@ void VulkanRenderPass::Create(std::vector<VkSubpassDependency>& inSubpassDepende
 	RenderPassInfo.pDependencies = inSubpassDependencies.data();
 
 	VK_CHECK_RESULT(vkCreateRenderPass(*Device->GetDeviceHandle(), &RenderPassInfo, nullptr, &RenderPassHandle), "[VulkanRenderPass]: Failed to create a render pass!");
+
+	BuildCompatibilityKey(RenderLayout.GetAttachments(), RenderLayout.GetNumAttachments(), SubpassDescription);
+}
+
+void VulkanRenderPass::BuildCompatibilityKey(const VkAttachmentDescription* inAttachments, uint32 inNumAttachments, const VkSubpassDescription& inSubpass)
+{
+    CompatibilityKey.clear();
+
+    CompatibilityKey.push_back(inNumAttachments);
+    for (uint32 i = 0; i < inNumAttachments; i++)
+    {
+        CompatibilityKey.push_back((uint32)inAttachments[i].format);
+        CompatibilityKey.push_back((uint32)inAttachments[i].samples);
+    }
+
+    // Pipelines are always created for subpass 0, the only subpass these render passes have
+    CompatibilityKey.push_back(inSubpass.colorAttachmentCount);
+    for (uint32 i = 0; i < inSubpass.colorAttachmentCount; i++)
+    {
+        CompatibilityKey.push_back(inSubpass.pColorAttachments[i].attachment);
+        CompatibilityKey.push_back(inSubpass.pResolveAttachments != nullptr ? inSubpass.pResolveAttachments[i].attachment : VK_ATTACHMENT_UNUSED);
+    }
+
+    CompatibilityKey.push_back(inSubpass.pDepthStencilAttachment != nullptr ? inSubpass.pDepthStencilAttachment->attachment : VK_ATTACHMENT_UNUSED);
+
+    CompatibilityKey.push_back(inSubpass.inputAttachmentCount);
+    for (uint32 i = 0; i < inSubpass.inputAttachmentCount; i++)
+    {
+        CompatibilityKey.push_back(inSubpass.pInputAttachments[i].attachment);
+    }
 }
 
 void VulkanRenderPass::UpdateRenderArea(const FRect2D& inNewRenderArea)
@@ -83,6 +83,29 @@ public:
         return NumColorAttachments;
     }
 
+    /**
+    * @returns uint32 index of the depth stencil attachment, UINT32_MAX if the render pass has none
+    */
+    inline uint32 GetDepthStencilAttachmentIndex() const
+    {
+        return DepthStencilAttachmentIndex;
+    }
+
+    /**
+    * @returns the attachment formats, sample counts and subpass references of this render pass, 
+    *   pipelines created against a render pass can be used with any other that has an equal key
+    */
+    inline const std::vector<uint32>& GetCompatibilityKey() const
+    {
+        return CompatibilityKey;
+    }
+
+private:
+    /**
+    * Fills the compatibility key from what the render pass is created with, load/store ops and layouts are left out as they do not affect compatibility
+    */
+    void BuildCompatibilityKey(const VkAttachmentDescription* inAttachments, uint32 inNumAttachments, const VkSubpassDescription& inSubpass);
+
 private:
     VulkanDevice* Device;
     VkRenderPass RenderPassHandle;
@@ -93,5 +116,7 @@ private:
     uint32 DepthStencilAttachmentIndex;
 
     uint32 NumColorAttachments;
+
+    std::vector<uint32> CompatibilityKey;
 };
 
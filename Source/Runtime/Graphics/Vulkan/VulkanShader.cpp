@@ -6,11 +6,17 @@
 #include "VulkanShader.h"
 #include <Misc/Defines/VulkanProfilerDefines.h>
 #include <Runtime/Graphics/VertexInputDescription.h>
+#include <Runtime/File/DerivedDataCache.h>
 #include <Runtime/File/FileHelper.h>
 #include "VulkanDevice.h"
 #include "VulkanTypeConverter.h"
 
-#include <External/glslang/Include/glslang/SPIRV/GlslangToSpv.h>
+#include <External/enkiTS/Includes/TaskScheduler.h>
+
+#include <algorithm>
+
+/** Bump when VulkanShader::ReflectSpirvCode() changes what it extracts */
+static constexpr uint32 SPIRV_REFLECTION_DERIVED_DATA_VERSION = 1;
 
 /* ------------------------------------------------------------------------------- */
 /* -----------------------          VulkanShader         ------------------------- */
@@ -77,8 +83,13 @@ void VulkanShader::CreateVertexInputStateCreateInfo(VkPipelineVertexInputStateCr
 
 void VulkanShader::ParseSpirvCodeIntoPipelineLayoutConfig(FPipelineLayoutConfig& outLayoutConfig) const
 {
-    uint32* SpirvCode = (uint32*)CompiledShaderBinary;
-    uint32 SpirvCodeSize = CompiledShaderBinarySize / 4;
+    Reflection.AddToPipelineLayoutConfig(outLayoutConfig);
+}
+
+void VulkanShader::ReflectSpirvCode(const uint32* inSpirvCode, uint64 inNumWords, FShaderReflection& outReflection)
+{
+    const uint32* SpirvCode = inSpirvCode;
+    uint32 SpirvCodeSize = (uint32)inNumWords;
 
     uint32 MagicNumber = SpirvCode[0];
     VE_ASSERT(MagicNumber == spv::MagicNumber, VE_TEXT("[VulkanShader]: Cannot parse shader as its compiled binary code is corrupted..."));
@@ -97,7 +108,7 @@ void VulkanShader::ParseSpirvCodeIntoPipelineLayoutConfig(FPipelineLayoutConfig&
     {
         // Each ID definition starts with an Op type and the number of words it is
         // composed of [ OpType stored in bottom 16 bits while the word count is top 16 bits]
-        spv::Op SpvOp = (spv::Op)(SpirvCode[WordIndex] & 0xFF);
+        spv::Op SpvOp = (spv::Op)(SpirvCode[WordIndex] & 0xFFFF);
         uint16 WordCount = (uint16)(SpirvCode[WordIndex] >> 16);
 
         switch (SpvOp)
@@ -110,7 +121,6 @@ void VulkanShader::ParseSpirvCodeIntoPipelineLayoutConfig(FPipelineLayoutConfig&
             spv::ExecutionModel ExecutionModel = (spv::ExecutionModel)SpirvCode[WordIndex + 1];
 
             ShaderStageFlag = ParseSpvExecutionModel(ExecutionModel);
-            VE_ASSERT(ShaderType != EShaderType::Undefined, "[VulkanShader]: Invalid shader type was parsed from a compiled shader binary....");
 
             break;
         }
@@ -143,6 +153,19 @@ void VulkanShader::ParseSpirvCodeIntoPipelineLayoutConfig(FPipelineLayoutConfig&
                 break;
             }
 
+            case (spv::DecorationLocation):
+            {
+                IdData.Location = SpirvCode[WordIndex + 3];
+                IdData.bHasLocation = true;
+                break;
+            }
+
+            case (spv::DecorationArrayStride):
+            {
+                IdData.ArrayStride = SpirvCode[WordIndex + 3];
+                break;
+            }
+
             }
 
             break;
@@ -185,6 +208,12 @@ void VulkanShader::ParseSpirvCodeIntoPipelineLayoutConfig(FPipelineLayoutConfig&
                 MemberField.Offset = SpirvCode[WordIndex + 4];
                 break;
             }
+
+            case (spv::DecorationMatrixStride):
+            {
+                MemberField.MatrixStride = SpirvCode[WordIndex + 4];
+                break;
+            }
             }
 
             break;
@@ -368,6 +397,12 @@ void VulkanShader::ParseSpirvCodeIntoPipelineLayoutConfig(FPipelineLayoutConfig&
 
             FSpirvIdData& IdData = IdDatas[IdIndex];
             IdData.SpvOp = SpvOp;
+            IdData.NumMembers = WordCount - 2;
+
+            // Structs without any names or decorations did not get their members allocated yet
+            if (IdData.Members.size() < IdData.NumMembers) {
+                IdData.Members.resize(IdData.NumMembers);
+            }
 
             if (WordCount > 2) {
                 for (uint16 memberIndex = 0; memberIndex < WordCount - 2; ++memberIndex) {
@@ -427,6 +462,8 @@ void VulkanShader::ParseSpirvCodeIntoPipelineLayoutConfig(FPipelineLayoutConfig&
         WordIndex += WordCount;
     }
 
+    outReflection.StageFlags = ShaderStageFlag;
+
     for (uint32 idIndex = 0; idIndex < IdDatas.size(); ++idIndex)
     {
         FSpirvIdData& IdData = IdDatas[idIndex];
@@ -438,58 +475,82 @@ void VulkanShader::ParseSpirvCodeIntoPipelineLayoutConfig(FPipelineLayoutConfig&
             case spv::StorageClassUniform:
             case spv::StorageClassUniformConstant:
             {
+                FShaderReflectedBinding Binding = { };
+                Binding.SetIndex = IdData.Set;
+                Binding.BindingIndex = IdData.Binding;
+                Binding.NumResources = 1;
+
                 // Bindless bindings are handled by the renderer internally 
                 // so we do not need to handle them here 
                 if (IdData.Set == 1 && (IdData.Binding == 10 || IdData.Binding == 11))
                 {
-                    // Since the layout information gets aggregated by the render interface, no need to worry here about creating
-                    // a new Pipeline Binding Descriptor 
-                    outLayoutConfig.AddBindingDescriptorAt({ }, 1);
-                    outLayoutConfig.NumSets = MathUtils::Max(IdData.Set + 1, outLayoutConfig.NumSets);
+                    Binding.bIsBindless = true;
+                    outReflection.Bindings.push_back(Binding);
                     continue;
                 }
 
                 // Get the actual type here
                 FSpirvIdData& UniformTypeData = IdDatas[IdDatas[IdData.TypeIndex].TypeIndex];
 
-                FPipelineBinding Binding = { };
-                Binding.BindingIndex = IdData.Binding;
-                Binding.NumResources = 1;
-
+                Binding.ResourceType = (uint32)EResourceType::Undefined;
                 switch (UniformTypeData.SpvOp)
                 {
 
                 case spv::OpTypeStruct:
                 {
-                    Binding.ResourceType = EResourceType::Buffer;
+                    Binding.ResourceType = (uint32)EResourceType::Buffer;
                     Binding.BindFlags = FResourceBindFlags::UniformBuffer;
                     break;
                 }
 
                 case spv::OpTypeSampledImage:
                 {
-                    Binding.ResourceType = EResourceType::Texture;
+                    Binding.ResourceType = (uint32)EResourceType::Texture;
                     Binding.BindFlags = FResourceBindFlags::Sampled;
                     break;
                 }
 
                 }
 
-                // Get the binding descriptor were going to edit 
-                FPipelineBindingDescriptor& BindingDescriptor = outLayoutConfig.GetBindingDescriptorAt(IdData.Set);
+                outReflection.Bindings.push_back(Binding);
+            }
+            break;
+
+            case spv::StorageClassPushConstant:
+            {
+                const uint32 BlockTypeIndex = IdDatas[IdData.TypeIndex].TypeIndex;
+                const FSpirvIdData& BlockTypeData = IdDatas[BlockTypeIndex];
+
+                // The range only has to cover the members the stage declares, other stages may use the rest of the block
+                FShaderReflectedPushConstant PushConstant = { };
+                PushConstant.Offset = UINT32_MAX;
+                for (uint32 memberIndex = 0; memberIndex < BlockTypeData.NumMembers; ++memberIndex)
+                {
+                    PushConstant.Offset = MathUtils::Min(BlockTypeData.Members[memberIndex].Offset, PushConstant.Offset);
+                }
+
+                if (PushConstant.Offset == UINT32_MAX)
+                {
+                    break;
+                }
 
-                // Set default stage flags to the one we parsed from current shader
-                Binding.StageFlags = ShaderStageFlag;
+                PushConstant.Size = GetSpirvTypeSize(IdDatas, BlockTypeIndex) - PushConstant.Offset;
+                outReflection.PushConstants.push_back(PushConstant);
+            }
+            break;
 
-                // Check if any other shader if parsed before this one has possibly had the same binding, if so just adjust 
-                // the stage flags 
-                if (BindingDescriptor.Bindings[Binding.BindingIndex].ResourceType != EResourceType::Undefined)
+            case spv::StorageClassInput:
+            {
+                // Built ins (ex: gl_VertexIndex) do not have a location
+                if (ShaderStageFlag != FShaderStageFlags::VertexStage || !IdData.bHasLocation)
                 {
-                    Binding.StageFlags |= BindingDescriptor.Bindings[Binding.BindingIndex].StageFlags;
+                    break;
                 }
 
-                BindingDescriptor.AddBindingAt(Binding, Binding.BindingIndex);
-                outLayoutConfig.NumSets = MathUtils::Max(IdData.Set + 1, outLayoutConfig.NumSets);
+                FShaderReflectedVertexInput VertexInput = { };
+                VertexInput.Location = IdData.Location;
+                VertexInput.Format = (uint32)GetSpirvVertexInputFormat(IdDatas, IdDatas[IdData.TypeIndex].TypeIndex);
+                outReflection.VertexInputs.push_back(VertexInput);
             }
             break;
             }
@@ -497,7 +558,89 @@ void VulkanShader::ParseSpirvCodeIntoPipelineLayoutConfig(FPipelineLayoutConfig&
     }
 }
 
-uint32 VulkanShader::ParseSpvExecutionModel(spv::ExecutionModel inModel) const
+uint32 VulkanShader::GetSpirvTypeSize(const std::vector<FSpirvIdData>& inIdDatas, uint32 inTypeIndex)
+{
+    const FSpirvIdData& TypeData = inIdDatas[inTypeIndex];
+    switch (TypeData.SpvOp)
+    {
+    case spv::OpTypeInt:
+    case spv::OpTypeFloat:
+        return TypeData.Width / 8;
+
+    case spv::OpTypeVector:
+        return TypeData.Count * GetSpirvTypeSize(inIdDatas, TypeData.TypeIndex);
+
+    case spv::OpTypeMatrix:
+        return TypeData.Count * GetSpirvTypeSize(inIdDatas, TypeData.TypeIndex);
+
+    case spv::OpTypeArray:
+    {
+        // The length of an array is the id of a constant
+        const uint32 NumElements = inIdDatas[TypeData.Count].Value;
+        const uint32 Stride = TypeData.ArrayStride != 0 ? TypeData.ArrayStride : GetSpirvTypeSize(inIdDatas, TypeData.TypeIndex);
+        return NumElements * Stride;
+    }
+
+    case spv::OpTypeStruct:
+    {
+        uint32 Size = 0;
+        for (uint32 memberIndex = 0; memberIndex < TypeData.NumMembers; ++memberIndex)
+        {
+            const FMemberField& Member = TypeData.Members[memberIndex];
+            const FSpirvIdData& MemberTypeData = inIdDatas[Member.IdIndex];
+
+            // Matrix columns are padded out to the stride in blocks
+            uint32 MemberSize = MemberTypeData.SpvOp == spv::OpTypeMatrix && Member.MatrixStride != 0 ?
+                MemberTypeData.Count * Member.MatrixStride : GetSpirvTypeSize(inIdDatas, Member.IdIndex);
+
+            Size = MathUtils::Max(Member.Offset + MemberSize, Size);
+        }
+        return Size;
+    }
+    }
+
+    // Runtime arrays, images and samplers do not take up space in a block
+    return 0;
+}
+
+EPixelFormat VulkanShader::GetSpirvVertexInputFormat(const std::vector<FSpirvIdData>& inIdDatas, uint32 inTypeIndex)
+{
+    const FSpirvIdData& TypeData = inIdDatas[inTypeIndex];
+
+    uint32 NumComponents = 1;
+    const FSpirvIdData* ComponentData = &TypeData;
+    if (TypeData.SpvOp == spv::OpTypeVector)
+    {
+        NumComponents = TypeData.Count;
+        ComponentData = &inIdDatas[TypeData.TypeIndex];
+    }
+
+    if (ComponentData->Width != 32)
+    {
+        return EPixelFormat::Undefined;
+    }
+
+    static const EPixelFormat FloatFormats[4] = { EPixelFormat::R32Float, EPixelFormat::RG32Float, EPixelFormat::RGB32Float, EPixelFormat::RGBA32Float };
+    static const EPixelFormat SIntFormats[4] = { EPixelFormat::R32SInt, EPixelFormat::RG32SInt, EPixelFormat::RGB32SInt, EPixelFormat::RGBA32SInt };
+    static const EPixelFormat UIntFormats[4] = { EPixelFormat::R32UInt, EPixelFormat::RG32UInt, EPixelFormat::RGB32UInt, EPixelFormat::RGBA32UInt };
+
+    if (NumComponents < 1 || NumComponents > 4)
+    {
+        return EPixelFormat::Undefined;
+    }
+
+    switch (ComponentData->SpvOp)
+    {
+    case spv::OpTypeFloat:
+        return FloatFormats[NumComponents - 1];
+    case spv::OpTypeInt:
+        return ComponentData->Sign ? SIntFormats[NumComponents - 1] : UIntFormats[NumComponents - 1];
+    }
+
+    return EPixelFormat::Undefined;
+}
+
+uint32 VulkanShader::ParseSpvExecutionModel(spv::ExecutionModel inModel)
 {
     switch (inModel)
     {
@@ -522,119 +665,68 @@ TVulkanShader<TShaderType>::TVulkanShader(VulkanDevice* inDevice)
 /* -----------------------      VulkanShaderFactory      ------------------------- */
 /* ------------------------------------------------------------------------------- */
 
-TBuiltInResource VulkanShaderFactory::BuiltInResources;
-
 VulkanShaderFactory::VulkanShaderFactory(VulkanDevice* inDevice)
 {
     Device = inDevice;
+}
+
+VulkanShaderFactory::~VulkanShaderFactory() { }
+
+struct VulkanShaderFactory::FPrecompileTaskSet : enki::ITaskSet
+{
+    const VulkanShaderFactory* Factory;
+    const FShaderConfig* Configs;
 
+    void ExecuteRange(enki::TaskSetPartition inRange, uint32_t inThreadNum) override
     {
-        BuiltInResources.maxLights = 32;
-        BuiltInResources.maxClipPlanes = 6;
-        BuiltInResources.maxTextureUnits = 32;
-        BuiltInResources.maxTextureCoords = 32;
-        BuiltInResources.maxVertexAttribs = 64;
-        BuiltInResources.maxVertexUniformComponents = 4096;
-        BuiltInResources.maxVaryingFloats = 64;
-        BuiltInResources.maxVertexTextureImageUnits = 32;
-        BuiltInResources.maxCombinedTextureImageUnits = 80;
-        BuiltInResources.maxTextureImageUnits = 32;
-        BuiltInResources.maxFragmentUniformComponents = 4096;
-        BuiltInResources.maxDrawBuffers = 32;
-        BuiltInResources.maxVertexUniformVectors = 128;
-        BuiltInResources.maxVaryingVectors = 8;
-        BuiltInResources.maxFragmentUniformVectors = 16;
-        BuiltInResources.maxVertexOutputVectors = 16;
-        BuiltInResources.maxFragmentInputVectors = 15;
-        BuiltInResources.minProgramTexelOffset = -8;
-        BuiltInResources.maxProgramTexelOffset = 7;
-        BuiltInResources.maxClipDistances = 8;
-        BuiltInResources.maxComputeWorkGroupCountX = 65535;
-        BuiltInResources.maxComputeWorkGroupCountY = 65535;
-        BuiltInResources.maxComputeWorkGroupCountZ = 65535;
-        BuiltInResources.maxComputeWorkGroupSizeX = 1024;
-        BuiltInResources.maxComputeWorkGroupSizeY = 1024;
-        BuiltInResources.maxComputeWorkGroupSizeZ = 64;
-        BuiltInResources.maxComputeUniformComponents = 1024;
-        BuiltInResources.maxComputeTextureImageUnits = 16;
-        BuiltInResources.maxComputeImageUniforms = 8;
-        BuiltInResources.maxComputeAtomicCounters = 8;
-        BuiltInResources.maxComputeAtomicCounterBuffers = 1;
-        BuiltInResources.maxVaryingComponents = 60;
-        BuiltInResources.maxVertexOutputComponents = 64;
-        BuiltInResources.maxGeometryInputComponents = 64;
-        BuiltInResources.maxGeometryOutputComponents = 128;
-        BuiltInResources.maxFragmentInputComponents = 128;
-        BuiltInResources.maxImageUnits = 8;
-        BuiltInResources.maxCombinedImageUnitsAndFragmentOutputs = 8;
-        BuiltInResources.maxCombinedShaderOutputResources = 8;
-        BuiltInResources.maxImageSamples = 0;
-        BuiltInResources.maxVertexImageUniforms = 0;
-        BuiltInResources.maxTessControlImageUniforms = 0;
-        BuiltInResources.maxTessEvaluationImageUniforms = 0;
-        BuiltInResources.maxGeometryImageUniforms = 0;
-        BuiltInResources.maxFragmentImageUniforms = 8;
-        BuiltInResources.maxCombinedImageUniforms = 8;
-        BuiltInResources.maxGeometryTextureImageUnits = 16;
-        BuiltInResources.maxGeometryOutputVertices = 256;
-        BuiltInResources.maxGeometryTotalOutputComponents = 1024;
-        BuiltInResources.maxGeometryUniformComponents = 1024;
-        BuiltInResources.maxGeometryVaryingComponents = 64;
-        BuiltInResources.maxTessControlInputComponents = 128;
-        BuiltInResources.maxTessControlOutputComponents = 128;
-        BuiltInResources.maxTessControlTextureImageUnits = 16;
-        BuiltInResources.maxTessControlUniformComponents = 1024;
-        BuiltInResources.maxTessControlTotalOutputComponents = 4096;
-        BuiltInResources.maxTessEvaluationInputComponents = 128;
-        BuiltInResources.maxTessEvaluationOutputComponents = 128;
-        BuiltInResources.maxTessEvaluationTextureImageUnits = 16;
-        BuiltInResources.maxTessEvaluationUniformComponents = 1024;
-        BuiltInResources.maxTessPatchComponents = 120;
-        BuiltInResources.maxPatchVertices = 32;
-        BuiltInResources.maxTessGenLevel = 64;
-        BuiltInResources.maxViewports = 16;
-        BuiltInResources.maxVertexAtomicCounters = 0;
-        BuiltInResources.maxTessControlAtomicCounters = 0;
-        BuiltInResources.maxTessEvaluationAtomicCounters = 0;
-        BuiltInResources.maxGeometryAtomicCounters = 0;
-        BuiltInResources.maxFragmentAtomicCounters = 8;
-        BuiltInResources.maxCombinedAtomicCounters = 8;
-        BuiltInResources.maxAtomicCounterBindings = 1;
-        BuiltInResources.maxVertexAtomicCounterBuffers = 0;
-        BuiltInResources.maxTessControlAtomicCounterBuffers = 0;
-        BuiltInResources.maxTessEvaluationAtomicCounterBuffers = 0;
-        BuiltInResources.maxGeometryAtomicCounterBuffers = 0;
-        BuiltInResources.maxFragmentAtomicCounterBuffers = 1;
-        BuiltInResources.maxCombinedAtomicCounterBuffers = 1;
-        BuiltInResources.maxAtomicCounterBufferSize = 16384;
-        BuiltInResources.maxTransformFeedbackBuffers = 4;
-        BuiltInResources.maxTransformFeedbackInterleavedComponents = 64;
-        BuiltInResources.maxCullDistances = 8;
-        BuiltInResources.maxCombinedClipAndCullDistances = 8;
-        BuiltInResources.maxSamples = 4;
-        BuiltInResources.maxMeshOutputVerticesNV = 256;
-        BuiltInResources.maxMeshOutputPrimitivesNV = 512;
-        BuiltInResources.maxMeshWorkGroupSizeX_NV = 32;
-        BuiltInResources.maxMeshWorkGroupSizeY_NV = 1;
-        BuiltInResources.maxMeshWorkGroupSizeZ_NV = 1;
-        BuiltInResources.maxTaskWorkGroupSizeX_NV = 32;
-        BuiltInResources.maxTaskWorkGroupSizeY_NV = 1;
-        BuiltInResources.maxTaskWorkGroupSizeZ_NV = 1;
-        BuiltInResources.maxMeshViewCountNV = 4;
-
-        BuiltInResources.limits.nonInductiveForLoops = 1;
-        BuiltInResources.limits.whileLoops = 1;
-        BuiltInResources.limits.doWhileLoops = 1;
-        BuiltInResources.limits.generalUniformIndexing = 1;
-        BuiltInResources.limits.generalAttributeMatrixVectorIndexing = 1;
-        BuiltInResources.limits.generalVaryingIndexing = 1;
-        BuiltInResources.limits.generalSamplerIndexing = 1;
-        BuiltInResources.limits.generalVariableIndexing = 1;
-        BuiltInResources.limits.generalConstantMatrixVectorIndexing = 1;
+        for (uint32 i = inRange.start; i < inRange.end; ++i)
+        {
+            Factory->PrecompileShader(Configs[i]);
+        }
+    }
+};
+
+void VulkanShaderFactory::PrecompileShaders(const FShaderConfig* inConfigs, uint32 inNumConfigs, enki::TaskScheduler* inTaskScheduler) const
+{
+    if (inTaskScheduler == nullptr)
+    {
+        for (uint32 i = 0; i < inNumConfigs; ++i)
+        {
+            PrecompileShader(inConfigs[i]);
+        }
+        return;
     }
+
+    // One shader per task, compile times differ too much between shaders for larger ranges to balance well
+    FPrecompileTaskSet TaskSet;
+    TaskSet.Factory = this;
+    TaskSet.Configs = inConfigs;
+    TaskSet.m_SetSize = inNumConfigs;
+    TaskSet.m_MinRange = 1;
+
+    inTaskScheduler->AddTaskSetToPipe(&TaskSet);
+    inTaskScheduler->WaitforTask(&TaskSet);
 }
 
-VulkanShaderFactory::~VulkanShaderFactory() { }
+void VulkanShaderFactory::PrecompileShader(const FShaderConfig& inConfig) const
+{
+    FShaderConfig Config = inConfig;
+    std::string FilePath;
+    if (Config.SourceType == EShaderSourceType::Filepath)
+    {
+        LoadShaderSourceFromFilePath(inConfig, Config.SourceCode);
+        Config.SourceType = EShaderSourceType::String;
+        FilePath = inConfig.SourceCode;
+    }
+
+    // Compiling stores the spirv and its reflection in the derived data cache, only the cache entries are wanted here
+    uint8* CompiledSourceCode = nullptr;
+    uint64 CompiledSourceCodeSize = 0;
+    FShaderReflection Reflection;
+    CompileSourceCode(Config, FilePath, CompiledSourceCode, &CompiledSourceCodeSize, Reflection);
+
+    delete[] CompiledSourceCode;
+}
 
 VulkanShader* VulkanShaderFactory::CreateShader(VulkanShaderPool* inShaderPool, const FShaderConfig& inConfig) const
 {
@@ -675,7 +767,26 @@ VulkanVertexShader* VulkanShaderFactory::CreateVertexShader(VulkanShaderPool* in
         // Then we have to compile the shader only
         uint8* CompiledSourceCode = nullptr;
         uint64 CompiledSourceCodeSize = 0;
-        CompileSourceCode(inConfig, CompiledSourceCode, &CompiledSourceCodeSize);
+        FShaderReflection Reflection;
+        CompileSourceCode(inConfig, FilePath, CompiledSourceCode, &CompiledSourceCodeSize, Reflection);
+
+        // A vertex input without a matching attribute reads undefined data
+        for (const FShaderReflectedVertexInput& VertexInput : Reflection.VertexInputs)
+        {
+            bool bIsProvided = false;
+            for (const FVertexInputDescription& VertexBinding : inConfig.VertexBindings)
+            {
+                for (const FVertexInputAttribute& Attribute : VertexBinding.GetVertexAttributes())
+                {
+                    bIsProvided |= Attribute.Location == VertexInput.Location;
+                }
+            }
+
+            if (!bIsProvided)
+            {
+                VE_CORE_LOG_WARN(VE_TEXT("[VulkanShaderFactory]: Vertex shader '{0}' reads location {1} which none of its vertex bindings provide"), FilePath, VertexInput.Location);
+            }
+        }
 
         VertexShader = new VulkanVertexShader(inShaderPool->Device);
         VertexShader->ShaderKey = inShaderPool->ShaderModuleHandles.size();
@@ -690,6 +801,7 @@ VulkanVertexShader* VulkanShaderFactory::CreateVertexShader(VulkanShaderPool* in
         // Free Resource -> 
         VertexShader->CompiledShaderBinary = CompiledSourceCode;
         VertexShader->CompiledShaderBinarySize = CompiledSourceCodeSize;
+        VertexShader->Reflection = std::move(Reflection);
         VertexShader->Path = FilePath;
 
         if (inConfig.Flags & FShaderFlags::OutputBinary)
@@ -724,7 +836,8 @@ VulkanFragmentShader* VulkanShaderFactory::CreateFragmentShader(VulkanShaderPool
         // Then we have to compile the shader only
         uint8* CompiledSourceCode = nullptr;
         uint64 CompiledSourceCodeSize = 0;
-        CompileSourceCode(inConfig, CompiledSourceCode, &CompiledSourceCodeSize);
+        FShaderReflection Reflection;
+        CompileSourceCode(inConfig, FilePath, CompiledSourceCode, &CompiledSourceCodeSize, Reflection);
 
         FragmentShader = new VulkanFragmentShader(inShaderPool->Device);
         FragmentShader->ShaderKey = inShaderPool->ShaderModuleHandles.size();
@@ -736,6 +849,7 @@ VulkanFragmentShader* VulkanShaderFactory::CreateFragmentShader(VulkanShaderPool
         // Free Resource -> 
         FragmentShader->CompiledShaderBinary = CompiledSourceCode;
         FragmentShader->CompiledShaderBinarySize = CompiledSourceCodeSize;
+        FragmentShader->Reflection = std::move(Reflection);
         FragmentShader->Path = FilePath;
 
         if (inConfig.Flags & FShaderFlags::OutputBinary)
@@ -753,93 +867,49 @@ VulkanFragmentShader* VulkanShaderFactory::CreateFragmentShader(VulkanShaderPool
     return FragmentShader;
 }
 
-void VulkanShaderFactory::CompileSourceCode(const FShaderConfig& inConfig, uint8*& outCode, uint64* outCodeSize) const
+void VulkanShaderFactory::CompileSourceCode(const FShaderConfig& inConfig, const std::string& inSourcePath, uint8*& outCode, uint64* outCodeSize, FShaderReflection& outReflection) const
 {
-    glslang::InitializeProcess();
+    uint64 SpirVKey = 0;
+    Compiler.Compile(inConfig, inSourcePath, outCode, outCodeSize, SpirVKey);
 
-    EShLanguage ShaderStage = ConvertShaderType(inConfig.Type);
-    glslang::EShSource ShaderSourceLanguage = glslang::EShSourceHlsl;
+    LoadReflection(SpirVKey, outCode, *outCodeSize, outReflection);
+}
 
-    if (inConfig.Flags & FShaderFlags::GLSL)
+void VulkanShaderFactory::LoadReflection(uint64 inSpirVKey, const uint8* inCode, uint64 inCodeSize, FShaderReflection& outReflection) const
+{
+    uint64 ReflectionKey = 0;
+    if (inSpirVKey != 0)
     {
-        ShaderSourceLanguage = glslang::EShSourceGlsl;
-    }
-
-    glslang::TShader RawShader(ShaderStage);
-
-    const char* RawInput = inConfig.SourceCode.c_str();
-    const char* const* CStrInput = &RawInput;
-    RawShader.setStrings(CStrInput, 1);
-
-    int ClientInputSemanticsVersion = 100;
-    glslang::EShTargetClientVersion VulkanClientVersion = glslang::EShTargetVulkan_1_0;
-    glslang::EShTargetLanguageVersion TargetVersion = glslang::EShTargetSpv_1_0;
-
-    RawShader.setEnvInput(ShaderSourceLanguage, ShaderStage, glslang::EShClientVulkan, ClientInputSemanticsVersion);
-    RawShader.setEnvClient(glslang::EShClientVulkan, VulkanClientVersion);
-    RawShader.setEnvTarget(glslang::EShTargetSpv, TargetVersion);
+        FDerivedDataKeyBuilder KeyBuilder("SpirVReflection", SPIRV_REFLECTION_DERIVED_DATA_VERSION);
+        KeyBuilder.AppendValue(inSpirVKey);
+        ReflectionKey = KeyBuilder.GetKey();
 
-    // Since DefaultTBuiltInResource get reinterpert casted to glslang_resource_t* we can just do some 
-    // pointer casting to get the original values back 
-    EShMessages messages = EShMsgDefault;
-
-    const int DefaultVersion = 100;
-
-    // preprocessing of the glsl shader (includes all files into the actual glsl string)
-    glslang::TShader::ForbidIncluder BasicIncluder = glslang::TShader::ForbidIncluder();
-    std::string preprocessedGLSL;
-    if (!RawShader.preprocess(&BuiltInResources, DefaultVersion, ENoProfile, false, false, messages, &preprocessedGLSL, BasicIncluder)) {
-        VE_ASSERT(false, "Shader Preprocessing Failed \n Log: {0}\n DebugLog: {1}", RawShader.getInfoLog(), RawShader.getInfoDebugLog());
-    }
-
-    //updates shader strings with preprocessed glsl file
-    const char* preprocessedCStr = preprocessedGLSL.c_str();
-    RawShader.setStrings(&preprocessedCStr, 1);
-
-    //parses the shader
-    if (!RawShader.parse(&BuiltInResources, 100, false, messages)) {
-        VE_ASSERT(false, "Shader Parsing Failed \n Log: {0}\n DebugLog: {1}", RawShader.getInfoLog(), RawShader.getInfoDebugLog());
-    }
-
-    glslang::TProgram program;
-    program.addShader(&RawShader);
-
-    //links program with shader
-    if (!program.link(messages)) {
-        VE_ASSERT(false, "Shader Linking \n Log: {0}\n DebugLog: {1}", RawShader.getInfoLog(), RawShader.getInfoDebugLog());
+        FDerivedData CachedReflection;
+        if (DerivedDataCache::Get().Get(ReflectionKey, CachedReflection) && outReflection.Deserialize(CachedReflection.Data.Data, CachedReflection.Data.Size))
+        {
+            return;
+        }
     }
 
-    //converts glslang program to spirv format
-    std::vector<uint32> SpirV;
-    spv::SpvBuildLogger logger;
-    glslang::SpvOptions spvOptions;
-    spvOptions.validate = true;
-    glslang::GlslangToSpv(*program.getIntermediate(ShaderStage), SpirV, &logger, &spvOptions);
+    outReflection = FShaderReflection();
+    VulkanShader::ReflectSpirvCode((const uint32*)inCode, inCodeSize / 4, outReflection);
 
-    if (logger.getAllMessages().size() > 0)
+    if (ReflectionKey != 0)
     {
-        VE_CORE_LOG_WARN("[VulkanShaderFactory]: Spirv Messages: \n {0}", logger.getAllMessages());
+        std::vector<uint8> Blob;
+        outReflection.Serialize(Blob);
+        DerivedDataCache::Get().Put(ReflectionKey, Blob.data(), Blob.size());
     }
-
-    *outCodeSize = SpirV.size() * 4;
-    outCode = new uint8[*outCodeSize];
-    memcpy(outCode, SpirV.data(), *outCodeSize);
-
-    glslang::FinalizeProcess();
 }
 
-EShLanguage VulkanShaderFactory::ConvertShaderType(EShaderType inShaderType) const
+void VulkanShaderFactory::AddIncludeDirectory(const std::string& inDirectoryPath)
 {
-    switch (inShaderType)
-    {
-    case EShaderType::Vertex:
-        return EShLangVertex;
-    case EShaderType::Fragment:
-        return EShLangFragment;
-    }
+    Compiler.AddIncludeDirectory(inDirectoryPath);
+}
 
-    VE_ASSERT(false, VE_TEXT("[VulkanShaderFactory]: Shader type currently not supported or is undefined: {0}"), (int32)inShaderType);
-    return EShLangVertex;
+void VulkanShaderFactory::GetDependentShaders(const std::string& inFilePath, std::vector<std::string>& outShaderPaths) const
+{
+    Compiler.GetDependentShaders(inFilePath, outShaderPaths);
 }
 
 void VulkanShaderFactory::LoadShaderSourceFromFilePath(const FShaderConfig& inConfig, std::string& outSource) const
@@ -5,14 +5,20 @@
 
 #pragma once
 #include <Runtime/Graphics/Shader.h>
+#include <Runtime/Graphics/ShaderCompiler.h>
+#include <Runtime/Graphics/ShaderReflection.h>
 #include "Runtime/Memory/ResourceManager.h"
 #include "VulkanDevice.h"
 
-#include <External/glslang/Include/glslang/Public/ShaderLang.h>
 #include <External/glslang/Include/glslang/SPIRV/spirv.hpp>
 
 struct FVertexInputDescription;
 
+namespace enki
+{
+    class TaskScheduler;
+}
+
 /**
 * A shader pool
 * Contains shader modules and is the only way to allocate/create shader modules specific to vulkan (VkShaderModule)
@@ -68,9 +74,18 @@ public:
     /* -------------        Shader Parsing Helper Functions        ------------------- */
     /* ------------------------------------------------------------------------------- */
 
+    /**
+    * Adds the bindings and push constants of the shader to a layout config, uses the reflection made when the shader was compiled
+    */
     void ParseSpirvCodeIntoPipelineLayoutConfig(FPipelineLayoutConfig& outLayoutConfig) const;
 
-    uint32 ParseSpvExecutionModel(spv::ExecutionModel inModel) const;
+    /**
+    * Walks every word of a spirv binary for its bindings, push constants and vertex inputs
+    * Expensive, the factory stores the result next to the spirv in the derived data cache so this runs once per binary
+    */
+    static void ReflectSpirvCode(const uint32* inSpirvCode, uint64 inNumWords, FShaderReflection& outReflection);
+
+    static uint32 ParseSpvExecutionModel(spv::ExecutionModel inModel);
 
 public:
     inline std::vector<VkVertexInputAttributeDescription>& GetVertexInputAttributes()
@@ -103,6 +118,11 @@ public:
         return CompiledShaderBinarySize;
     }
 
+    inline const FShaderReflection& GetReflection() const
+    {
+        return Reflection;
+    }
+
 protected:
     VulkanDevice* Device;
 
@@ -118,11 +138,14 @@ protected:
     std::vector<VkVertexInputAttributeDescription> InputAttributes;
     std::vector<VkVertexInputBindingDescription> InputBindings;
 
+    FShaderReflection Reflection;
+
 private:
     struct VRIXIC_API FMemberField
     {
         uint32 IdIndex;
         uint32 Offset;
+        uint32 MatrixStride;
 
         std::string Name;
     };
@@ -133,6 +156,10 @@ private:
         uint32 Set;
         uint32 Binding;
 
+        // Shader inputs and outputs
+        uint32 Location;
+        bool bHasLocation;
+
         // Integers / Floats
         uint8 Width;
         uint8 Sign;
@@ -140,6 +167,7 @@ private:
         // Arrays, Vectors, and Matrices
         uint32 TypeIndex;
         uint32 Count;
+        uint32 ArrayStride;
 
         // Variables
         spv::StorageClass SpvStorageClass;
@@ -150,7 +178,18 @@ private:
         // Structures
         std::string Name;
         std::vector<FMemberField> Members;
+        uint32 NumMembers;
     };
+
+    /**
+    * @returns uint32 size in bytes of a spirv type as laid out in a block, uses the strides the shader was decorated with
+    */
+    static uint32 GetSpirvTypeSize(const std::vector<FSpirvIdData>& inIdDatas, uint32 inTypeIndex);
+
+    /**
+    * @returns EPixelFormat the vertex attribute format matching a scalar or vector type, Undefined for anything else
+    */
+    static EPixelFormat GetSpirvVertexInputFormat(const std::vector<FSpirvIdData>& inIdDatas, uint32 inTypeIndex);
 };
 
 /**
@@ -197,6 +236,27 @@ public:
     VulkanVertexShader* CreateVertexShader(VulkanShaderPool* inShaderPool, FShaderConfig& inConfig) const;
     VulkanFragmentShader* CreateFragmentShader(VulkanShaderPool* inShaderPool, FShaderConfig& inConfig) const;
 
+    /**
+    * Compiles shaders into the derived data cache without creating them, shaders created afterwards with
+    * the same configs only have to load their spirv from the cache
+    *
+    * @param inTaskScheduler - optional, when set the shaders are compiled across the worker threads
+    */
+    void PrecompileShaders(const FShaderConfig* inConfigs, uint32 inNumConfigs, enki::TaskScheduler* inTaskScheduler) const;
+
+    /**
+    * Adds a directory #include searches after the folder of the including file, has to be called before shaders are compiled
+    */
+    void AddIncludeDirectory(const std::string& inDirectoryPath);
+
+    /**
+    * Collects the shaders that include a file, directly or through other includes, as of their last compile
+    *
+    * @param inFilePath - an included file, shaders passed in are returned as well
+    * @param outShaderPaths - the paths of the shaders that have to be recompiled when the file changes are appended to this
+    */
+    void GetDependentShaders(const std::string& inFilePath, std::vector<std::string>& outShaderPaths) const;
+
 private:
 
     /* ------------------------------------------------------------------------------- */
@@ -212,12 +272,27 @@ private:
     /* -------------      Shader Compilation Helper Functions      ------------------- */
     /* ------------------------------------------------------------------------------- */
 
-    void CompileSourceCode(const FShaderConfig& inConfig, uint8*& outCode, uint64* outCodeSize) const;
+    /**
+    * Compiles the source code of the config with the shader compiler and loads the reflection of the spirv
+    *
+    * @param inSourcePath - path of the file the source was loaded from, relative includes are resolved against it. Empty for string shaders
+    */
+    void CompileSourceCode(const FShaderConfig& inConfig, const std::string& inSourcePath, uint8*& outCode, uint64* outCodeSize, FShaderReflection& outReflection) const;
+
+    /**
+    * Loads the reflection of a spirv binary from the derived data cache, reflects it and stores the result on a miss
+    *
+    * @param inSpirVKey - derived data key of the spirv, 0 if it is not cached in which case the reflection is not either
+    */
+    void LoadReflection(uint64 inSpirVKey, const uint8* inCode, uint64 inCodeSize, FShaderReflection& outReflection) const;
 
-    EShLanguage ConvertShaderType(EShaderType inShaderType) const;
+    void PrecompileShader(const FShaderConfig& inConfig) const;
 
 private:
+    struct FPrecompileTaskSet;
+
     VulkanDevice* Device;
 
-    static TBuiltInResource BuiltInResources;
+    /** Owns the include directories and the dependencies of every shader compiled through this factory */
+    ShaderCompiler Compiler;
 };
@@ -4,6 +4,7 @@
 */
 
 #include "VulkanTextureView.h"
+#include "VulkanTransientHeap.h"
 #include <Misc/Defines/StringDefines.h>
 #include <Misc/Defines/VulkanProfilerDefines.h>
 #include "VulkanTypeConverter.h"
@@ -142,22 +143,24 @@ FTextureConfig VulkanTextureView::GetTextureConfig() const
 
 void VulkanTextureView::CreateImage(const FTextureConfig& inTextureConfig)
 {
-    VkImageCreateInfo ImageCreateInfo = VulkanUtils::Initializers::ImageCreateInfo();
-    ImageCreateInfo.imageType = VulkanTypeConverter::ConvertTextureTypeToVk(inTextureConfig.Type);
-    ImageCreateInfo.format = ImageFormat; //VulkanTypeConverter::Convert(inTextureConfig.Format);
-    ImageCreateInfo.extent = { inTextureConfig.Extent.Width, inTextureConfig.Extent.Height, inTextureConfig.Extent.Depth };
-    ImageCreateInfo.mipLevels = NumMipLevels;
-    ImageCreateInfo.arrayLayers = NumArrayLayers;
-    ImageCreateInfo.samples = VulkanTypeConverter::ConvertSampleCountToVk(inTextureConfig.NumSamples);
-    ImageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
-    ImageCreateInfo.usage = VulkanTypeConverter::ConvertTextureUsageFlagsToVk(inTextureConfig.BindFlags);
-    ImageCreateInfo.flags = VulkanTypeConverter::ConvertTextureCreationFlagsToVk(inTextureConfig.CreationFlags);
-
+    VkImageCreateInfo ImageCreateInfo = MakeImageCreateInfo(inTextureConfig, ImageFormat);
     VK_CHECK_RESULT(vkCreateImage(*Device->GetDeviceHandle(), &ImageCreateInfo, nullptr, &ImageHandle), "[VulkanTextureView]: Failed to create an image!");
 
     VkMemoryRequirements MemoryRequirements = { };
     vkGetImageMemoryRequirements(*Device->GetDeviceHandle(), ImageHandle, &MemoryRequirements);
 
+    // Placed in memory owned by the heap, ImageMemory stays null so it is not freed with the image
+    if (inTextureConfig.TransientHeap != nullptr)
+    {
+        const VulkanTransientHeap* Heap = (const VulkanTransientHeap*)inTextureConfig.TransientHeap;
+        VE_ASSERT((MemoryRequirements.memoryTypeBits & (1u << Heap->GetMemoryTypeIndex())) != 0, VE_TEXT("[VulkanTextureView]: The image cannot be placed in the memory type of the transient heap..."));
+        VE_ASSERT(inTextureConfig.TransientHeapOffset % MemoryRequirements.alignment == 0, VE_TEXT("[VulkanTextureView]: Transient heap offset {0} is not aligned to {1}"), inTextureConfig.TransientHeapOffset, MemoryRequirements.alignment);
+        VE_ASSERT(inTextureConfig.TransientHeapOffset + MemoryRequirements.size <= Heap->GetSize(), VE_TEXT("[VulkanTextureView]: The image does not fit in the transient heap at offset {0}"), inTextureConfig.TransientHeapOffset);
+
+        VK_CHECK_RESULT(vkBindImageMemory(*Device->GetDeviceHandle(), ImageHandle, Heap->GetMemoryHandle(), inTextureConfig.TransientHeapOffset), "[VulkanTextureView]: Failed to bind transient heap memory for an image!");
+        return;
+    }
+
     uint32 MemoryTypeIndex = Device->GetMemoryTypeIndex(MemoryRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, nullptr);
     VkMemoryAllocateInfo MemoryAlloc = VulkanUtils::Initializers::MemoryAllocateInfo();
     MemoryAlloc.allocationSize = MemoryRequirements.size;
@@ -167,6 +170,36 @@ void VulkanTextureView::CreateImage(const FTextureConfig& inTextureConfig)
     VK_CHECK_RESULT(vkBindImageMemory(*Device->GetDeviceHandle(), ImageHandle, ImageMemory, 0), "[VulkanTextureView]: Failed to bind memory for an image!");
 }
 
+VkImageCreateInfo VulkanTextureView::MakeImageCreateInfo(const FTextureConfig& inTextureConfig, VkFormat inImageFormat)
+{
+    VkImageCreateInfo ImageCreateInfo = VulkanUtils::Initializers::ImageCreateInfo();
+    ImageCreateInfo.imageType = VulkanTypeConverter::ConvertTextureTypeToVk(inTextureConfig.Type);
+    ImageCreateInfo.format = inImageFormat;
+    ImageCreateInfo.extent = { inTextureConfig.Extent.Width, inTextureConfig.Extent.Height, inTextureConfig.Extent.Depth };
+    ImageCreateInfo.mipLevels = inTextureConfig.MipLevels;
+    ImageCreateInfo.arrayLayers = inTextureConfig.NumArrayLayers;
+    ImageCreateInfo.samples = VulkanTypeConverter::ConvertSampleCountToVk(inTextureConfig.NumSamples);
+    ImageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    ImageCreateInfo.usage = VulkanTypeConverter::ConvertTextureUsageFlagsToVk(inTextureConfig.BindFlags);
+    ImageCreateInfo.flags = VulkanTypeConverter::ConvertTextureCreationFlagsToVk(inTextureConfig.CreationFlags);
+
+    return ImageCreateInfo;
+}
+
+VkMemoryRequirements VulkanTextureView::GetMemoryRequirements(VulkanDevice* inDevice, const FTextureConfig& inTextureConfig)
+{
+    VkImageCreateInfo ImageCreateInfo = MakeImageCreateInfo(inTextureConfig, VulkanTypeConverter::Convert(inTextureConfig.Format));
+
+    VkImage TemporaryImage = VK_NULL_HANDLE;
+    VK_CHECK_RESULT(vkCreateImage(*inDevice->GetDeviceHandle(), &ImageCreateInfo, nullptr, &TemporaryImage), "[VulkanTextureView]: Failed to create an image to query its memory requirements!");
+
+    VkMemoryRequirements MemoryRequirements = { };
+    vkGetImageMemoryRequirements(*inDevice->GetDeviceHandle(), TemporaryImage, &MemoryRequirements);
+
+    vkDestroyImage(*inDevice->GetDeviceHandle(), TemporaryImage, nullptr);
+    return MemoryRequirements;
+}
+
 VkImageAspectFlags VulkanTextureView::GetAspectFlags() const
 {
     switch (ImageFormat)
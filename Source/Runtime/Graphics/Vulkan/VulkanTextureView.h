@@ -63,6 +63,11 @@ public:
 
     inline void SetImageLayout(VkImageLayout inLayout) { ImageLayout = inLayout; }
 
+    /**
+    * @returns VkMemoryRequirements the memory an image created from inTextureConfig needs (queried with a temporary image)
+    */
+    static VkMemoryRequirements GetMemoryRequirements(VulkanDevice* inDevice, const FTextureConfig& inTextureConfig);
+
 private:
     /**
     * Only swapchains should use this version
@@ -79,6 +84,11 @@ private:
     */
     void CreateImage(const FTextureConfig& inTextureConfig);
 
+    /**
+    * @returns VkImageCreateInfo the image creation info for the configuration settings passed in
+    */
+    static VkImageCreateInfo MakeImageCreateInfo(const FTextureConfig& inTextureConfig, VkFormat inImageFormat);
+
     /**
     * @returns VkImageAspectFlags aspect flags for this texture (from its Image Format)
     */
@@ -113,6 +123,7 @@ public:
 private:
     friend class VulkanSwapChain;
     friend class VulkanDevice;
+    friend class VulkanCommandBuffer;
 
     VulkanDevice* Device;
 
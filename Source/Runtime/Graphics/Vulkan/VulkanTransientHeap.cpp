@@ -0,0 +1,26 @@
+/**
+* This file is part of the "Vrixic Engine" project (Copyright (c) 2022-2023 by Vrij Patel)
+* See "LICENSE.txt" for license information.
+*/
+
+#include "VulkanTransientHeap.h"
+
+VulkanTransientHeap::VulkanTransientHeap(VulkanDevice* inDevice, const FTransientHeapConfig& inTransientHeapConfig)
+    : Device(inDevice), MemoryHandle(VK_NULL_HANDLE), Size(inTransientHeapConfig.Size), MemoryTypeIndex(0)
+{
+    MemoryTypeIndex = Device->GetMemoryTypeIndex(inTransientHeapConfig.MemoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, nullptr);
+
+    VkMemoryAllocateInfo MemoryAlloc = VulkanUtils::Initializers::MemoryAllocateInfo();
+    MemoryAlloc.allocationSize = Size;
+    MemoryAlloc.memoryTypeIndex = MemoryTypeIndex;
+
+    VK_CHECK_RESULT(vkAllocateMemory(*Device->GetDeviceHandle(), &MemoryAlloc, nullptr, &MemoryHandle), "[VulkanTransientHeap]: Failed to allocate the memory of a transient heap!");
+}
+
+VulkanTransientHeap::~VulkanTransientHeap()
+{
+    if (MemoryHandle != VK_NULL_HANDLE)
+    {
+        vkFreeMemory(*Device->GetDeviceHandle(), MemoryHandle, nullptr);
+    }
+}
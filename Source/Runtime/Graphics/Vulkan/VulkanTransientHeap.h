@@ -0,0 +1,47 @@
+/**
+* This file is part of the "Vrixic Engine" project (Copyright (c) 2022-2023 by Vrij Patel)
+* See "LICENSE.txt" for license information.
+*/
+
+#pragma once
+#include <Runtime/Graphics/TransientHeap.h>
+#include <Runtime/Graphics/Vulkan/VulkanDevice.h>
+
+/**
+* Vulkan definition for the transient heap interface, a single device local VkDeviceMemory allocation
+*/
+class VRIXIC_API VulkanTransientHeap final : public ITransientHeap
+{
+public:
+    /**
+    * Allocates the memory of the heap
+    */
+    VulkanTransientHeap(VulkanDevice* inDevice, const FTransientHeapConfig& inTransientHeapConfig);
+    ~VulkanTransientHeap();
+
+    VulkanTransientHeap(const VulkanTransientHeap& other) = delete;
+    VulkanTransientHeap operator=(const VulkanTransientHeap& other) = delete;
+
+public:
+    virtual uint64 GetSize() const override
+    {
+        return Size;
+    }
+
+    inline VkDeviceMemory GetMemoryHandle() const
+    {
+        return MemoryHandle;
+    }
+
+    inline uint32 GetMemoryTypeIndex() const
+    {
+        return MemoryTypeIndex;
+    }
+
+private:
+    VulkanDevice* Device;
+    VkDeviceMemory MemoryHandle;
+
+    uint64 Size;
+    uint32 MemoryTypeIndex;
+};
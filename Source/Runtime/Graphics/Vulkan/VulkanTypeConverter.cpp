@@ -124,6 +124,15 @@ VkFormat VulkanTypeConverter::Convert(EPixelFormat inFormat)
 
     case EPixelFormat::S8UInt:              return VK_FORMAT_S8_UINT;
 
+        /* Block Compressed Formats */
+    case EPixelFormat::BC1RGBAUNorm:        return VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+    case EPixelFormat::BC1RGBAUNorm_sRGB:   return VK_FORMAT_BC1_RGBA_SRGB_BLOCK;
+    case EPixelFormat::BC3UNorm:            return VK_FORMAT_BC3_UNORM_BLOCK;
+    case EPixelFormat::BC3UNorm_sRGB:       return VK_FORMAT_BC3_SRGB_BLOCK;
+    case EPixelFormat::BC5UNorm:            return VK_FORMAT_BC5_UNORM_BLOCK;
+    case EPixelFormat::BC7UNorm:            return VK_FORMAT_BC7_UNORM_BLOCK;
+    case EPixelFormat::BC7UNorm_sRGB:       return VK_FORMAT_BC7_SRGB_BLOCK;
+
     }
 
     ConversionFailed("EPixelFormat", "VkFormat");
@@ -239,6 +248,15 @@ EPixelFormat VulkanTypeConverter::Convert(VkFormat inFormat)
 
     case VK_FORMAT_S8_UINT:                     return EPixelFormat::S8UInt;
 
+        /* Block Compressed Formats */
+    case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:        return EPixelFormat::BC1RGBAUNorm;
+    case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:         return EPixelFormat::BC1RGBAUNorm_sRGB;
+    case VK_FORMAT_BC3_UNORM_BLOCK:             return EPixelFormat::BC3UNorm;
+    case VK_FORMAT_BC3_SRGB_BLOCK:              return EPixelFormat::BC3UNorm_sRGB;
+    case VK_FORMAT_BC5_UNORM_BLOCK:             return EPixelFormat::BC5UNorm;
+    case VK_FORMAT_BC7_UNORM_BLOCK:             return EPixelFormat::BC7UNorm;
+    case VK_FORMAT_BC7_SRGB_BLOCK:              return EPixelFormat::BC7UNorm_sRGB;
+
     }
 
     ConversionFailed("VkFormat", "EPixelFormat");
@@ -366,6 +384,7 @@ VkImageLayout VulkanTypeConverter::ConvertTextureLayoutToVk(ETextureLayout inLay
     switch (inLayout)
     {
     case ETextureLayout::Undefined:                  return VK_IMAGE_LAYOUT_UNDEFINED;
+    case ETextureLayout::General:                    return VK_IMAGE_LAYOUT_GENERAL;
     case ETextureLayout::ColorAttachment:            return VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
     case ETextureLayout::DepthStencilAttachment:     return VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
     case ETextureLayout::DepthStencilReadOnly:       return VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
@@ -467,7 +486,7 @@ VkDescriptorType VulkanTypeConverter::ConvertBindFlagsToVkDescriptorType(EResour
         {
             return VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
         }
-        else if (inBindFlags & FResourceBindFlags::StorageBuffer)
+        else if (inBindFlags & FResourceBindFlags::StorageImage)
         {
             return VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
         }
@@ -781,7 +800,7 @@ VkImageUsageFlags VulkanTypeConverter::ConvertTextureUsageFlagsToVk(uint32 inFla
         Flags |= VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
     }
 
-    if (inFlags & FResourceBindFlags::StorageBuffer)
+    if (inFlags & FResourceBindFlags::StorageImage)
     {
         Flags |= VK_IMAGE_USAGE_STORAGE_BIT;
     }
@@ -0,0 +1,160 @@
+/**
+* This file is part of the "Vrixic Engine" project (Copyright (c) 2022-2023 by Vrij Patel)
+* See "LICENSE.txt" for license information.
+*/
+
+#pragma once
+#include <Core/Core.h>
+#include <Misc/Defines/GenericDefines.h>
+#include <Runtime/Memory/Core/MemoryUtils.h>
+
+#include <map>
+
+/**
+* Free List Allocater
+*	- Hands out offsets into a buffer it does not own
+*	- Blocks can be freed in any order, neighbouring free blocks are merged back together
+*	- First fit, free blocks are kept sorted by offset
+*
+*	@note not thread safe
+*/
+class VRIXIC_API FreeListAllocater
+{
+public:
+    FreeListAllocater()
+        : Capacity(0), MemoryUsed(0) { }
+
+public:
+    void Init(uint64 inCapacityInBytes)
+    {
+        Capacity = inCapacityInBytes;
+        MemoryUsed = 0;
+
+        FreeBlocks.clear();
+        FreeBlocks.insert(std::make_pair(0ull, inCapacityInBytes));
+    }
+
+    /**
+    * Allocates a block
+    *
+    * @param inSizeInBytes - how many bytes to allocate
+    * @param inAlignment - power of 2 alignment of the returned offset
+    * @param outOffset - offset into the buffer
+    * @return bool - false if no free block is large enough
+    */
+    bool Alloc(uint64 inSizeInBytes, uint64 inAlignment, uint64& outOffset)
+    {
+        for (auto It = FreeBlocks.begin(); It != FreeBlocks.end(); ++It)
+        {
+            const uint64 BlockOffset = It->first;
+            const uint64 BlockEnd = It->first + It->second;
+            const uint64 AlignedOffset = FMemoryUtils::AlignAddress(BlockOffset, inAlignment);
+
+            if (AlignedOffset + inSizeInBytes > BlockEnd)
+            {
+                continue;
+            }
+
+            FreeBlocks.erase(It);
+
+            // Give back what is left on either side of the allocation
+            if (AlignedOffset > BlockOffset)
+            {
+                FreeBlocks.insert(std::make_pair(BlockOffset, AlignedOffset - BlockOffset));
+            }
+
+            if (AlignedOffset + inSizeInBytes < BlockEnd)
+            {
+                FreeBlocks.insert(std::make_pair(AlignedOffset + inSizeInBytes, BlockEnd - (AlignedOffset + inSizeInBytes)));
+            }
+
+            MemoryUsed += inSizeInBytes;
+            outOffset = AlignedOffset;
+
+            return true;
+        }
+
+        return false;
+    }
+
+    /**
+    * Grows a block in place, only possible when a free block directly follows it
+    *
+    * @return bool - false if the block could not be grown, the block is left untouched
+    */
+    bool Grow(uint64 inOffset, uint64 inSizeInBytes, uint64 inNewSizeInBytes)
+    {
+        if (inNewSizeInBytes <= inSizeInBytes)
+        {
+            return true;
+        }
+
+        auto Next = FreeBlocks.find(inOffset + inSizeInBytes);
+        const uint64 GrowSize = inNewSizeInBytes - inSizeInBytes;
+        if (Next == FreeBlocks.end() || Next->second < GrowSize)
+        {
+            return false;
+        }
+
+        const uint64 RemainingSize = Next->second - GrowSize;
+        FreeBlocks.erase(Next);
+
+        if (RemainingSize > 0)
+        {
+            FreeBlocks.insert(std::make_pair(inOffset + inNewSizeInBytes, RemainingSize));
+        }
+
+        MemoryUsed += GrowSize;
+
+        return true;
+    }
+
+    /**
+    * Frees a block, size has to be the size it was allocated with
+    */
+    void Free(uint64 inOffset, uint64 inSizeInBytes)
+    {
+        VE_ASSERT(inOffset + inSizeInBytes <= Capacity, VE_TEXT("[Free List Allocater]: Trying to free a block that is out of range..."));
+
+        MemoryUsed -= inSizeInBytes;
+
+        auto It = FreeBlocks.insert(std::make_pair(inOffset, inSizeInBytes)).first;
+
+        // Merge with the next block
+        auto Next = std::next(It);
+        if (Next != FreeBlocks.end() && It->first + It->second == Next->first)
+        {
+            It->second += Next->second;
+            FreeBlocks.erase(Next);
+        }
+
+        // Merge with the previous block
+        if (It != FreeBlocks.begin())
+        {
+            auto Previous = std::prev(It);
+            if (Previous->first + Previous->second == It->first)
+            {
+                Previous->second += It->second;
+                FreeBlocks.erase(It);
+            }
+        }
+    }
+
+public:
+    uint64 GetCapacity() const
+    {
+        return Capacity;
+    }
+
+    uint64 GetMemoryUsed() const
+    {
+        return MemoryUsed;
+    }
+
+private:
+    uint64 Capacity;
+    uint64 MemoryUsed;
+
+    /** Offset -> Size */
+    std::map<uint64, uint64> FreeBlocks;
+};
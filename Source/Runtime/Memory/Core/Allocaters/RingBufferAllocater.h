@@ -0,0 +1,131 @@
+/**
+* This file is part of the "Vrixic Engine" project (Copyright (c) 2022-2023 by Vrij Patel)
+* See "LICENSE.txt" for license information.
+*/
+
+#pragma once
+#include <Core/Core.h>
+#include <Misc/Defines/GenericDefines.h>
+#include <Runtime/Memory/Core/MemoryUtils.h>
+
+/**
+* Ring Buffer Allocater
+*	- Hands out offsets into a buffer it does not own (ex: a gpu staging buffer)
+*	- Memory is released in the same order it was allocated, by passing back a marker taken after the allocations
+*	- An allocation never straddles the end of the buffer, it wraps around to the start instead
+*
+*	Offsets are tracked as increasing virtual offsets, the physical offset is (Virtual % Capacity).
+*	They go back to 0 on the first allocation after the ring drained
+*/
+class VRIXIC_API RingBufferAllocater
+{
+public:
+    typedef uint64 Marker;
+
+    RingBufferAllocater()
+        : Capacity(0), Head(0), Tail(0) { }
+
+public:
+    /**
+    * @param inCapacityInBytes - size of the buffer being sub-allocated, has to be a multiple of the largest alignment requested
+    */
+    void Init(uint64 inCapacityInBytes)
+    {
+        Capacity = inCapacityInBytes;
+        Head = 0;
+        Tail = 0;
+    }
+
+    /**
+    * Allocates a block from the ring
+    *
+    * @param inSizeInBytes - how many bytes to allocate
+    * @param inAlignment - power of 2 alignment of the returned offset
+    * @param outOffset - offset into the buffer
+    * @return bool - false if the ring does not have enough free space, the caller should wait for memory to be released
+    */
+    bool Alloc(uint64 inSizeInBytes, uint64 inAlignment, uint64& outOffset)
+    {
+        if (inSizeInBytes > Capacity)
+        {
+            return false;
+        }
+
+        // Nothing is in use, start over at the beginning so the whole buffer is one free block
+        //  instead of being split at the old position (every marker taken so far has been released)
+        if (Head == Tail)
+        {
+            Head = 0;
+            Tail = 0;
+        }
+
+        uint64 Start = FMemoryUtils::AlignAddress(Head, inAlignment);
+        uint64 PhysicalStart = Start % Capacity;
+
+        // Not enough room before the end of the buffer, skip the remaining bytes and wrap around
+        if (PhysicalStart + inSizeInBytes > Capacity)
+        {
+            Start += Capacity - PhysicalStart;
+            PhysicalStart = 0;
+        }
+
+        if (Start + inSizeInBytes - Tail > Capacity)
+        {
+            return false;
+        }
+
+        Head = Start + inSizeInBytes;
+        outOffset = PhysicalStart;
+
+        return true;
+    }
+
+    /**
+    * @return Marker - the current position, pass this to Release() once everything allocated before it is no longer used
+    */
+    Marker GetMarker() const
+    {
+        return Head;
+    }
+
+    /**
+    * Releases all the memory allocated before the marker
+    */
+    void Release(Marker inMarker)
+    {
+        VE_ASSERT(inMarker >= Tail && inMarker <= Head, VE_TEXT("[Ring Buffer Allocater]: Markers have to be released in the order they were taken..."));
+
+        Tail = inMarker;
+    }
+
+    /**
+    * Releases all the memory in the ring
+    */
+    void Flush()
+    {
+        Tail = Head;
+    }
+
+public:
+    uint64 GetCapacity() const
+    {
+        return Capacity;
+    }
+
+    /**
+    * @return uint64 - bytes in use, including bytes skipped on wrap around
+    */
+    uint64 GetMemoryUsed() const
+    {
+        return Head - Tail;
+    }
+
+private:
+    uint64 Capacity;
+
+    /** Virtual offset of the next allocation */
+    uint64 Head;
+
+    /** Virtual offset of the oldest allocation still in use */
+    uint64 Tail;
+};
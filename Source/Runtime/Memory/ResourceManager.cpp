@@ -5,9 +5,14 @@
 
 #include "ResourceManager.h"
 #include <Runtime/Memory/Core/MemoryManager.h>
+#include <Runtime/File/FileReader.h>
+#include <Runtime/Core/Math/VrixicMathHelper.h>
 
 #include <External/stb/Includes/stb_image.h>
 
+/** Every decode allocation is prefixed with its block size, also keeps the returned memory 16 byte aligned */
+static const uint64 DECODE_ALLOCATION_HEADER_SIZE = 16;
+
 ResourceManager::ResourceManager() { } 
 
 ResourceManager::~ResourceManager()
@@ -19,7 +24,8 @@ void ResourceManager::Init(void* inConfig)
 {
     TextureMemoryView = { };
     TextureMemoryView.MemorySize = MEBIBYTES_TO_BYTES(450);
-    TextureMemoryView.MemoryHandle = TPointer<uint8>(MemoryManager::Get().MallocAligned<uint8>(TextureMemoryView.MemorySize, 1));
+    TextureMemoryView.MemoryHandle = TPointer<uint8>(MemoryManager::Get().MallocAligned<uint8>(TextureMemoryView.MemorySize, DECODE_ALLOCATION_HEADER_SIZE));
+    TextureArenaAllocater.Init(TextureMemoryView.MemorySize);
 
     VertexMemoryView = { };
     VertexMemoryView.MemorySize = MEBIBYTES_TO_BYTES(150);
@@ -34,11 +40,45 @@ void ResourceManager::Shutdown()
 {
 }
 
-TextureResourceHandle& ResourceManager::LoadTexture(const std::string& inTexturePath)
+TextureResourceHandle ResourceManager::LoadTexture(const std::string& inTexturePath, const FMipGenerationConfig* inMipConfig)
 {
-    if (TexturesMap.find(inTexturePath) != TexturesMap.end())
     {
-        return TexturesMap[inTexturePath];
+        std::lock_guard<std::mutex> LockGuard(TextureMutex);
+
+        auto It = TexturesMap.find(inTexturePath);
+        if (It != TexturesMap.end())
+        {
+            It->second.NumReferences++;
+            return It->second;
+        }
+    }
+
+    // Map the file instead of letting stb stream it through stdio, the compressed image never gets copied 
+    FFileReaderConfig ReaderConfig = { };
+    ReaderConfig.Mode = EFileReadMode::MemoryMapped;
+    ReaderConfig.AccessHint = EFileAccessHint::Sequential;
+
+    FileReader Reader(inTexturePath, ReaderConfig);
+    FFileSpan FileSpan = Reader.GetSpan();
+
+    TextureResourceHandle Handle = LoadTextureFromMemory(inTexturePath, FileSpan.Data, FileSpan.Size, inMipConfig);
+
+    Reader.Close();
+
+    return Handle;
+}
+
+TextureResourceHandle ResourceManager::LoadTextureFromMemory(const std::string& inTexturePath, const uint8* inData, uint64 inDataSize, const FMipGenerationConfig* inMipConfig)
+{
+    {
+        std::lock_guard<std::mutex> LockGuard(TextureMutex);
+
+        auto It = TexturesMap.find(inTexturePath);
+        if (It != TexturesMap.end())
+        {
+            It->second.NumReferences++;
+            return It->second;
+        }
     }
 
     VE_CORE_LOG_INFO(VE_TEXT("[ResourceManager]: Loading Texture {0} "), inTexturePath);
@@ -46,28 +86,191 @@ TextureResourceHandle& ResourceManager::LoadTexture(const std::string& inTexture
     TextureResourceHandle Handle = { };
 
     // Load the texture 
-    uint8* TextureMemory = stbi_load(inTexturePath.c_str(), &Handle.Width, &Handle.Height, &Handle.BitsPerPixel, 4);
+    uint8* TextureMemory = nullptr;
+    if (inData != nullptr && inDataSize != 0)
+    {
+        TextureMemory = stbi_load_from_memory(inData, (int32)inDataSize, &Handle.Width, &Handle.Height, &Handle.BitsPerPixel, 4);
+    }
 
     VE_ASSERT(TextureMemory != nullptr, VE_TEXT("[ResourceManager]: Failed to load texture: {0}"), inTexturePath)
 
-    Handle.SizeInBytes = Handle.Width * Handle.Height * 4;
+    if (TextureMemory == nullptr)
+    {
+        return InvalidTextureResource;
+    }
+
+    const uint64 BaseSizeInBytes = (uint64)Handle.Width * Handle.Height * 4;
+    Handle.SizeInBytes = BaseSizeInBytes;
+
+    // Make room for the mips right after mip 0, usually grows in place as the image was the last thing decoded 
+    if (inMipConfig != nullptr)
+    {
+        Handle.NumMipLevels = FMipGenerator::GetNumMipLevels(Handle.Width, Handle.Height, inMipConfig->MaxMipLevels);
+        Handle.SizeInBytes = FMipGenerator::GetMipChainSize(Handle.Width, Handle.Height, Handle.NumMipLevels);
+
+        uint8* GrownMemory = (uint8*)DecodeRealloc(TextureMemory, BaseSizeInBytes, Handle.SizeInBytes);
+        if (GrownMemory == nullptr)
+        {
+            VE_CORE_LOG_ERROR(VE_TEXT("[ResourceManager]: Out of memory for the mip chain of texture: {0}"), inTexturePath);
+            stbi_image_free(TextureMemory);
+            return InvalidTextureResource;
+        }
 
+        TextureMemory = GrownMemory;
+    }
+
+    // stb fell back to the heap (texture arena is full), move it into the arena 
+    if (!TextureArenaOwns(TextureMemory))
+    {
+        // Handles index into the arena, a texture left on the heap cannot be referenced so the load fails
+        uint8* ArenaMemory = (uint8*)DecodeMalloc(Handle.SizeInBytes);
+        if (!TextureArenaOwns(ArenaMemory))
+        {
+            VE_CORE_LOG_ERROR(VE_TEXT("[ResourceManager]: Texture arena is out of memory, failed to load texture: {0}"), inTexturePath);
+            DecodeFree(ArenaMemory);
+            stbi_image_free(TextureMemory);
+            return InvalidTextureResource;
+        }
+
+        memcpy(ArenaMemory, TextureMemory, BaseSizeInBytes);
+        stbi_image_free(TextureMemory);
+
+        TextureMemory = ArenaMemory;
+    }
+
+    if (Handle.NumMipLevels > 1)
+    {
+        FMipGenerator::Generate(TextureMemory, Handle.Width, Handle.Height, *inMipConfig);
+    }
+
+    std::lock_guard<std::mutex> LockGuard(TextureMutex);
+
+    // Another worker might have decoded the same texture in the mean time 
+    auto It = TexturesMap.find(inTexturePath);
+    if (It != TexturesMap.end())
+    {
+        stbi_image_free(TextureMemory);
+        It->second.NumReferences++;
+        return It->second;
+    }
+
+    // The image was decoded in place, no copy needed 
     Handle.MemoryViewHandle = TextureMemoryView.MemoryHandle;
-    Handle.MemoryIndex = TextureMemoryView.Malloc(Handle.SizeInBytes);
+    Handle.MemoryIndex = TextureMemory - TextureMemoryView.MemoryHandle.Get();
+    Handle.NumReferences = 1;
 
     VE_CORE_LOG_INFO(VE_TEXT("[TextureMemoryView]: Loaded Texture with num bytes: {0} "), Handle.SizeInBytes);
-    //Handle.MemoryHandle = TPointer<uint8>(MemoryManager::Get().MallocAligned<uint8>(Handle.SizeInBytes, 4));
 
-    // Expensive but for now we will have to do it as I still need to implement my very own image decoders 
-    // that will internally use the memory manager 
-    memcpy(Handle.GetMemoryHandle(), TextureMemory, Handle.SizeInBytes);
+    // Then insert it into the TexturesMap
+    return TexturesMap.insert(std::make_pair(inTexturePath, Handle)).first->second;
+}
+
+void ResourceManager::FreeTexture(const std::string& inTexturePath)
+{
+    std::lock_guard<std::mutex> LockGuard(TextureMutex);
 
-    // free stb image memory 
-    stbi_image_free(TextureMemory);
+    auto It = TexturesMap.find(inTexturePath);
+    if (It == TexturesMap.end())
+    {
+        return;
+    }
 
-    // Then insert it into the TexturesMap
-    TexturesMap.insert(std::make_pair(inTexturePath, Handle));
+    if (--It->second.NumReferences > 0)
+    {
+        return;
+    }
+
+    DecodeFree(It->second.GetMemoryHandle());
+    TexturesMap.erase(It);
+}
+
+bool ResourceManager::TextureArenaOwns(const void* inMemory) const
+{
+    if (!TextureMemoryView.MemoryHandle.IsValid())
+    {
+        return false;
+    }
+
+    const uint8* ArenaBegin = TextureMemoryView.MemoryHandle.Get();
+    return (const uint8*)inMemory >= ArenaBegin && (const uint8*)inMemory < ArenaBegin + TextureMemoryView.MemorySize;
+}
+
+void* ResourceManager::DecodeMalloc(size_t inSizeInBytes)
+{
+    ResourceManager& Manager = ResourceManager::Get();
+
+    const uint64 BlockSize = inSizeInBytes + DECODE_ALLOCATION_HEADER_SIZE;
+    uint64 BlockOffset = 0;
+    bool bAllocated = false;
+    {
+        std::lock_guard<std::mutex> LockGuard(Manager.TextureArenaMutex);
+        bAllocated = Manager.TextureArenaAllocater.Alloc(BlockSize, DECODE_ALLOCATION_HEADER_SIZE, BlockOffset);
+    }
+
+    // Arena is not initialized or out of memory 
+    if (!bAllocated)
+    {
+        return malloc(inSizeInBytes);
+    }
+
+    uint8* Block = Manager.TextureMemoryView.MemoryHandle.Get() + BlockOffset;
+    *(uint64*)Block = BlockSize;
+
+    return Block + DECODE_ALLOCATION_HEADER_SIZE;
+}
 
-    return TexturesMap[inTexturePath];
+void* ResourceManager::DecodeRealloc(void* inMemory, size_t inOldSizeInBytes, size_t inNewSizeInBytes)
+{
+    if (inMemory == nullptr)
+    {
+        return DecodeMalloc(inNewSizeInBytes);
+    }
+
+    // Try to grow the block in place first 
+    ResourceManager& Manager = ResourceManager::Get();
+    if (Manager.TextureArenaOwns(inMemory))
+    {
+        uint8* Block = (uint8*)inMemory - DECODE_ALLOCATION_HEADER_SIZE;
+        const uint64 BlockSize = *(uint64*)Block;
+        const uint64 NewBlockSize = inNewSizeInBytes + DECODE_ALLOCATION_HEADER_SIZE;
+
+        std::lock_guard<std::mutex> LockGuard(Manager.TextureArenaMutex);
+        if (Manager.TextureArenaAllocater.Grow(Block - Manager.TextureMemoryView.MemoryHandle.Get(), BlockSize, NewBlockSize))
+        {
+            *(uint64*)Block = MathUtils::Max(BlockSize, NewBlockSize);
+            return inMemory;
+        }
+    }
+
+    void* NewMemory = DecodeMalloc(inNewSizeInBytes);
+    if (NewMemory == nullptr)
+    {
+        return nullptr;
+    }
+
+    memcpy(NewMemory, inMemory, inOldSizeInBytes < inNewSizeInBytes ? inOldSizeInBytes : inNewSizeInBytes);
+    DecodeFree(inMemory);
+
+    return NewMemory;
 }
 
+void ResourceManager::DecodeFree(void* inMemory)
+{
+    if (inMemory == nullptr)
+    {
+        return;
+    }
+
+    ResourceManager& Manager = ResourceManager::Get();
+    if (!Manager.TextureArenaOwns(inMemory))
+    {
+        free(inMemory);
+        return;
+    }
+
+    uint8* Block = (uint8*)inMemory - DECODE_ALLOCATION_HEADER_SIZE;
+    const uint64 BlockSize = *(uint64*)Block;
+
+    std::lock_guard<std::mutex> LockGuard(Manager.TextureArenaMutex);
+    Manager.TextureArenaAllocater.Free(Block - Manager.TextureMemoryView.MemoryHandle.Get(), BlockSize);
+}
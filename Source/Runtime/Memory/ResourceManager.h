@@ -9,7 +9,10 @@
 #include <Misc/Assert.h>
 #include <Misc/Defines/StringDefines.h>
 #include <Runtime/Graphics/Vertex.h>
+#include <Runtime/Graphics/TextureTools/MipGenerator.h>
+#include <Runtime/Memory/Core/Allocaters/FreeListAllocater.h>
 
+#include <mutex>
 #include <string>
 #include <unordered_map>
 
@@ -21,21 +24,27 @@ public:
     int32 Height;
     int32 BitsPerPixel;
 
-    /* Size of the texture in Bytes */
+    /* Size of the texture in Bytes, includes all the mip levels */
     uint64 SizeInBytes;
 
+    /* Mip levels are tightly packed after mip 0 */
+    uint32 NumMipLevels;
+
 public:
-    TextureResourceHandle() : Width(-1), Height(-1), BitsPerPixel(-1), SizeInBytes(0), MemoryIndex(-1) { }
+    TextureResourceHandle() : Width(-1), Height(-1), BitsPerPixel(-1), SizeInBytes(0), NumMipLevels(1), MemoryIndex(-1), NumReferences(0) { }
 
     uint8* GetMemoryHandle() const
     {
-        return MemoryViewHandle.Get() + MemoryIndex;
+        return MemoryViewHandle.IsValid() ? MemoryViewHandle.Get() + MemoryIndex : nullptr;
     }
 
 private:
     /** The texture memory handle */
     TPointer<uint8> MemoryViewHandle;
     uint64 MemoryIndex;
+
+    /** Number of loads that have not yet been freed, only valid on the TexturesMap entry */
+    uint32 NumReferences;
 };
 
 /**
@@ -60,20 +69,60 @@ public:
     * Loads a texture using the path passed in 
     * 
     * @param inTexturePath the path of the texture to load
-    * @returns TextureHandle the handle to the texture allocated to memory 
+    * @param inMipConfig when set, the mip chain is generated after the texture is decoded
+    * @returns TextureHandle the handle to the texture allocated to memory, a copy as the map entry can be erased by FreeTexture() on another thread
+    */
+    TextureResourceHandle LoadTexture(const std::string& inTexturePath, const FMipGenerationConfig* inMipConfig = nullptr);
+
+    /**
+    * Decodes a texture from an encoded image already in memory (ex: a memory mapped file)
+    * @note thread safe, decoding happens outside of the lock so multiple workers can decode at once
+    *
+    * @param inTexturePath the path of the texture, used as the key for the textures map
+    * @param inData the encoded image data 
+    * @param inDataSize size in bytes of the encoded image data
+    * @param inMipConfig when set, the mip chain is generated after the texture is decoded
+    * @returns TextureHandle the handle to the texture allocated to memory, invalid memory handle if decode failed
     */
-    TextureResourceHandle& LoadTexture(const std::string& inTexturePath);
+    TextureResourceHandle LoadTextureFromMemory(const std::string& inTexturePath, const uint8* inData, uint64 inDataSize, const FMipGenerationConfig* inMipConfig = nullptr);
 
-    //void FreeTexture(TextureHandle);
+    /**
+    * Releases one load of a texture, its memory is given back to the texture arena once no load references it
+    * @note call this once the pixels have been copied to the gpu (or to a staging buffer)
+    *
+    * @param inTexturePath the path the texture was loaded with
+    */
+    void FreeTexture(const std::string& inTexturePath);
+
+public:
+    /** stb_image allocation hooks, images get decoded straight into the texture arena */
+    static void* DecodeMalloc(size_t inSizeInBytes);
+    static void* DecodeRealloc(void* inMemory, size_t inOldSizeInBytes, size_t inNewSizeInBytes);
+    static void DecodeFree(void* inMemory);
 
 private:
     ResourceManager();
     ~ResourceManager();
 
+    /**
+    * @returns bool true if the memory was allocated from the texture arena
+    */
+    bool TextureArenaOwns(const void* inMemory) const;
+
 private:
     /** A hash_map that contains all textures */
     std::unordered_map<std::string, TextureResourceHandle> TexturesMap;
 
+    /** Guards the TexturesMap, textures are decoded by multiple loader workers */
+    std::mutex TextureMutex;
+
+    /** Sub-allocates the TextureMemoryView, decoded textures are freed once uploaded */
+    FreeListAllocater TextureArenaAllocater;
+    std::mutex TextureArenaMutex;
+
+    /** Returned when a texture fails to load */
+    TextureResourceHandle InvalidTextureResource;
+
     /**
     * A view into aligned memory.. For specific uses..
     */
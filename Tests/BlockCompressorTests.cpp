@@ -0,0 +1,380 @@
+/**
+* This file is part of the "Vrixic Engine" project (Copyright (c) 2022-2023 by Vrij Patel)
+* See "LICENSE.txt" for license information.
+*/
+
+#include "TestHarness.h"
+#include <Misc/Logging/Log.h>
+#include <Runtime/Graphics/TextureTools/BlockCompressor.h>
+#include <External/enkiTS/Includes/TaskScheduler.h>
+
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+static const char* FORMAT_NAMES[4] = { "BC1", "BC3", "BC5", "BC7" };
+
+/**
+* Decoders written from the BCn spec, independent of the encoder. Each fills the 16 texels of one block, row by row
+*/
+namespace BlockDecoder
+{
+    static void Expand565(uint16 inColor, int32* outColor)
+    {
+        const int32 R = inColor >> 11;
+        const int32 G = (inColor >> 5) & 63;
+        const int32 B = inColor & 31;
+        outColor[0] = (R << 3) | (R >> 2);
+        outColor[1] = (G << 2) | (G >> 4);
+        outColor[2] = (B << 3) | (B >> 2);
+    }
+
+    /** BC3 color blocks always use the four color palette, whatever the endpoint order */
+    static void DecodeBC1(const uint8* inBlock, uint8 outTexels[16][4], bool inForceFourColors)
+    {
+        uint16 Color0, Color1;
+        uint32 Indices;
+        memcpy(&Color0, inBlock, 2);
+        memcpy(&Color1, inBlock + 2, 2);
+        memcpy(&Indices, inBlock + 4, 4);
+
+        int32 Palette[4][4];
+        Expand565(Color0, Palette[0]);
+        Expand565(Color1, Palette[1]);
+        for (uint32 i = 0; i < 4; ++i)
+        {
+            Palette[i][3] = 255;
+        }
+
+        for (uint32 c = 0; c < 3; ++c)
+        {
+            if (Color0 > Color1 || inForceFourColors)
+            {
+                Palette[2][c] = (2 * Palette[0][c] + Palette[1][c]) / 3;
+                Palette[3][c] = (Palette[0][c] + 2 * Palette[1][c]) / 3;
+            }
+            else
+            {
+                Palette[2][c] = (Palette[0][c] + Palette[1][c]) / 2;
+                Palette[3][c] = 0;
+            }
+        }
+
+        if (Color0 <= Color1 && !inForceFourColors)
+        {
+            Palette[3][3] = 0;
+        }
+
+        for (uint32 i = 0; i < 16; ++i)
+        {
+            for (uint32 c = 0; c < 4; ++c)
+            {
+                outTexels[i][c] = (uint8)Palette[(Indices >> (2 * i)) & 3][c];
+            }
+        }
+    }
+
+    static void DecodeBC4(const uint8* inBlock, uint8 outTexels[16][4], uint32 inChannel)
+    {
+        int32 Palette[8] = { inBlock[0], inBlock[1] };
+        if (inBlock[0] > inBlock[1])
+        {
+            for (int32 i = 1; i < 7; ++i)
+            {
+                Palette[i + 1] = ((7 - i) * inBlock[0] + i * inBlock[1]) / 7;
+            }
+        }
+        else
+        {
+            for (int32 i = 1; i < 5; ++i)
+            {
+                Palette[i + 1] = ((5 - i) * inBlock[0] + i * inBlock[1]) / 5;
+            }
+            Palette[6] = 0;
+            Palette[7] = 255;
+        }
+
+        uint64 Indices = 0;
+        memcpy(&Indices, inBlock, 8);
+        Indices >>= 16;
+        for (uint32 i = 0; i < 16; ++i)
+        {
+            outTexels[i][inChannel] = (uint8)Palette[(Indices >> (3 * i)) & 7];
+        }
+    }
+
+    /** Only mode 6, the one the encoder writes; any other mode fails the block */
+    static bool DecodeBC7(const uint8* inBlock, uint8 outTexels[16][4])
+    {
+        uint32 BitPosition = 0;
+        auto ReadBits = [&](uint32 inNumBits)
+        {
+            int32 Value = 0;
+            for (uint32 i = 0; i < inNumBits; ++i, ++BitPosition)
+            {
+                Value |= ((inBlock[BitPosition >> 3] >> (BitPosition & 7)) & 1) << i;
+            }
+            return Value;
+        };
+
+        uint32 Mode = 0;
+        while (Mode < 8 && ReadBits(1) == 0)
+        {
+            Mode++;
+        }
+
+        if (Mode != 6)
+        {
+            return false;
+        }
+
+        int32 Endpoints[2][4];
+        for (uint32 c = 0; c < 4; ++c)
+        {
+            Endpoints[0][c] = ReadBits(7);
+            Endpoints[1][c] = ReadBits(7);
+        }
+
+        const int32 PBit0 = ReadBits(1);
+        const int32 PBit1 = ReadBits(1);
+        for (uint32 c = 0; c < 4; ++c)
+        {
+            Endpoints[0][c] = (Endpoints[0][c] << 1) | PBit0;
+            Endpoints[1][c] = (Endpoints[1][c] << 1) | PBit1;
+        }
+
+        static const int32 WEIGHTS[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+        for (uint32 i = 0; i < 16; ++i)
+        {
+            // The anchor index drops its top bit
+            const int32 Weight = WEIGHTS[ReadBits(i == 0 ? 3 : 4)];
+            for (uint32 c = 0; c < 4; ++c)
+            {
+                outTexels[i][c] = (uint8)(((64 - Weight) * Endpoints[0][c] + Weight * Endpoints[1][c] + 32) >> 6);
+            }
+        }
+
+        return true;
+    }
+}
+
+/**
+* Photo like content: smooth gradients, a sine pattern, hard edged patches and a little noise; alpha has soft and cut out areas
+*/
+static std::vector<uint8> MakeImage(uint32 inWidth, uint32 inHeight, uint32 inSeed)
+{
+    std::mt19937 Random(inSeed);
+    std::vector<uint8> Texels((uint64)inWidth * inHeight * 4);
+    for (uint32 y = 0; y < inHeight; ++y)
+    {
+        for (uint32 x = 0; x < inWidth; ++x)
+        {
+            const float U = x / (float)inWidth;
+            const float V = y / (float)inHeight;
+            uint8* Texel = &Texels[((uint64)y * inWidth + x) * 4];
+            Texel[0] = (uint8)(127.0f + 120.0f * std::sin(U * 20.0f + V * 3.0f));
+            Texel[1] = (uint8)(255.0f * V);
+            Texel[2] = (uint8)((((x / 37) + (y / 53)) % 2 ? 200 : 40) + Random() % 8);
+            Texel[3] = (x / 16) % 3 == 0 ? (uint8)(U * 100.0f) : (uint8)(155.0f + V * 100.0f);
+        }
+    }
+
+    return Texels;
+}
+
+/**
+* Decodes the blocks and compares them to the source
+*
+* @returns double PSNR in dB over the channels the format stores (rgb for BC1, rg for BC5), BC1 alpha is checked separately
+*/
+static double ComputePSNR(const std::vector<uint8>& inTexels, const std::vector<uint8>& inBlocks, uint32 inWidth, uint32 inHeight,
+    EBlockCompressionFormat inFormat, uint32& outNumBadBlocks)
+{
+    const uint32 NumBlocksX = (inWidth + 3) / 4;
+    const uint32 NumBlocksY = (inHeight + 3) / 4;
+    const uint32 BlockSize = FBlockCompressor::GetBlockSize(inFormat);
+    const uint32 NumChannels = inFormat == EBlockCompressionFormat::BC5 ? 2 : (inFormat == EBlockCompressionFormat::BC1 ? 3 : 4);
+
+    outNumBadBlocks = 0;
+    double SquaredError = 0.0;
+    for (uint32 BlockY = 0; BlockY < NumBlocksY; ++BlockY)
+    {
+        for (uint32 BlockX = 0; BlockX < NumBlocksX; ++BlockX)
+        {
+            const uint8* Block = &inBlocks[((uint64)BlockY * NumBlocksX + BlockX) * BlockSize];
+            uint8 Decoded[16][4] = { };
+            bool bIsValid = true;
+            switch (inFormat)
+            {
+            case EBlockCompressionFormat::BC1:
+                BlockDecoder::DecodeBC1(Block, Decoded, false);
+                break;
+            case EBlockCompressionFormat::BC3:
+                BlockDecoder::DecodeBC1(Block + 8, Decoded, true);
+                BlockDecoder::DecodeBC4(Block, Decoded, 3);
+                break;
+            case EBlockCompressionFormat::BC5:
+                BlockDecoder::DecodeBC4(Block, Decoded, 0);
+                BlockDecoder::DecodeBC4(Block + 8, Decoded, 1);
+                break;
+            case EBlockCompressionFormat::BC7:
+                bIsValid = BlockDecoder::DecodeBC7(Block, Decoded);
+                break;
+            }
+
+            for (uint32 i = 0; i < 16; ++i)
+            {
+                const uint32 X = BlockX * 4 + i % 4;
+                const uint32 Y = BlockY * 4 + i / 4;
+                if (X >= inWidth || Y >= inHeight)
+                {
+                    continue;
+                }
+
+                const uint8* Source = &inTexels[((uint64)Y * inWidth + X) * 4];
+
+                // BC1 alpha is one bit: texels under the threshold have to come back transparent (and black), the rest opaque
+                if (inFormat == EBlockCompressionFormat::BC1)
+                {
+                    const bool bIsTransparent = Source[3] < 128;
+                    bIsValid &= Decoded[i][3] == (bIsTransparent ? 0 : 255);
+                    if (bIsTransparent)
+                    {
+                        continue;
+                    }
+                }
+
+                for (uint32 c = 0; c < NumChannels; ++c)
+                {
+                    const double Delta = (double)Source[c] - Decoded[i][c];
+                    SquaredError += Delta * Delta;
+                }
+            }
+
+            outNumBadBlocks += bIsValid ? 0 : 1;
+        }
+    }
+
+    const double MeanSquaredError = SquaredError / ((double)inWidth * inHeight * NumChannels);
+    return MeanSquaredError > 0.0 ? 10.0 * std::log10(255.0 * 255.0 / MeanSquaredError) : 100.0;
+}
+
+/**
+* Every format on an image whose size is not a multiple of 4, the quality has to stay above a floor with and without the endpoint refit
+*/
+static void TestQuality()
+{
+    const uint32 WIDTH = 250;
+    const uint32 HEIGHT = 130;
+
+    // Measured on this image, with some margin: BC1 ~40 dB (opaque texels), BC3 ~40, BC5 ~50, BC7 ~42
+    const double MIN_PSNR[4] = { 37.0, 37.0, 47.0, 40.0 };
+
+    const std::vector<uint8> Texels = MakeImage(WIDTH, HEIGHT, 3);
+    for (uint32 Format = 0; Format < 4; ++Format)
+    {
+        double PSNR[2] = { };
+        for (uint32 bRefineEndpoints = 0; bRefineEndpoints < 2; ++bRefineEndpoints)
+        {
+            FBlockCompressionConfig Config;
+            Config.Format = (EBlockCompressionFormat)Format;
+            Config.bRefineEndpoints = bRefineEndpoints != 0;
+
+            std::vector<uint8> Blocks(FBlockCompressor::GetCompressedSize(WIDTH, HEIGHT, 1, Config.Format));
+            FBlockCompressor::Compress(Texels.data(), WIDTH, HEIGHT, Blocks.data(), Config);
+
+            uint32 NumBadBlocks = 0;
+            PSNR[bRefineEndpoints] = ComputePSNR(Texels, Blocks, WIDTH, HEIGHT, Config.Format, NumBadBlocks);
+
+            std::printf("[BlockCompressorTests]: %s%s: %.2f dB\n", FORMAT_NAMES[Format], bRefineEndpoints ? " refined" : "", PSNR[bRefineEndpoints]);
+            VE_TEST_CHECK(NumBadBlocks == 0, "%s: %u blocks decode to the wrong mode or alpha", FORMAT_NAMES[Format], NumBadBlocks);
+            VE_TEST_CHECK(PSNR[bRefineEndpoints] >= MIN_PSNR[Format], "%s%s: %.2f dB, the floor is %.1f dB", FORMAT_NAMES[Format],
+                bRefineEndpoints ? " refined" : "", PSNR[bRefineEndpoints], MIN_PSNR[Format]);
+        }
+
+        // The refit only keeps endpoints that lower a block's error
+        VE_TEST_CHECK(PSNR[1] >= PSNR[0] - 0.05, "%s: refining the endpoints lowered the PSNR from %.2f to %.2f dB", FORMAT_NAMES[Format], PSNR[0], PSNR[1]);
+    }
+}
+
+/**
+* Flat blocks are the easy case every format has to get (almost) exactly right
+*/
+static void TestFlatBlocks()
+{
+    const uint32 SIZE = 16;
+
+    std::mt19937 Random(7);
+    std::vector<uint8> Texels(SIZE * SIZE * 4);
+    for (uint32 i = 0; i < 16; ++i)
+    {
+        // One random opaque color per 4x4 block
+        const uint8 Color[4] = { (uint8)Random(), (uint8)Random(), (uint8)Random(), 255 };
+        for (uint32 j = 0; j < 16; ++j)
+        {
+            const uint32 X = (i % 4) * 4 + j % 4;
+            const uint32 Y = (i / 4) * 4 + j / 4;
+            memcpy(&Texels[(Y * SIZE + X) * 4], Color, 4);
+        }
+    }
+
+    // 565 endpoints round a flat color by up to 4 in red and blue, BC4 and BC7 mode 6 store it within 1
+    const double MIN_PSNR[4] = { 38.0, 38.0, 48.0, 48.0 };
+    for (uint32 Format = 0; Format < 4; ++Format)
+    {
+        FBlockCompressionConfig Config;
+        Config.Format = (EBlockCompressionFormat)Format;
+
+        std::vector<uint8> Blocks(FBlockCompressor::GetCompressedSize(SIZE, SIZE, 1, Config.Format));
+        FBlockCompressor::Compress(Texels.data(), SIZE, SIZE, Blocks.data(), Config);
+
+        uint32 NumBadBlocks = 0;
+        const double PSNR = ComputePSNR(Texels, Blocks, SIZE, SIZE, Config.Format, NumBadBlocks);
+        VE_TEST_CHECK(NumBadBlocks == 0 && PSNR >= MIN_PSNR[Format], "%s: flat blocks come back at %.2f dB, %u bad blocks", FORMAT_NAMES[Format], PSNR, NumBadBlocks);
+    }
+}
+
+/**
+* Encodes a 1024x1024 image in every format on one thread and across the workers
+*/
+static void TestTimeEncode()
+{
+    const uint32 SIZE = 1024;
+
+    enki::TaskScheduler TaskScheduler;
+    TaskScheduler.Initialize();
+
+    const std::vector<uint8> Texels = MakeImage(SIZE, SIZE, 5);
+    for (uint32 Format = 0; Format < 4; ++Format)
+    {
+        for (uint32 bUseWorkers = 0; bUseWorkers < 2; ++bUseWorkers)
+        {
+            FBlockCompressionConfig Config;
+            Config.Format = (EBlockCompressionFormat)Format;
+            Config.TaskScheduler = bUseWorkers ? &TaskScheduler : nullptr;
+
+            std::vector<uint8> Blocks(FBlockCompressor::GetCompressedSize(SIZE, SIZE, 1, Config.Format));
+
+            const auto Start = std::chrono::high_resolution_clock::now();
+            FBlockCompressor::Compress(Texels.data(), SIZE, SIZE, Blocks.data(), Config);
+            const float TimeMs = TestHarness::GetElapsedMs(Start);
+
+            std::printf("[BlockCompressorTests]: 1024x1024 %s, %s: %.1f ms (%.1f MPix/s)\n", FORMAT_NAMES[Format],
+                bUseWorkers ? "workers" : "one thread", TimeMs, (float)SIZE * SIZE / (TimeMs * 1000.0f));
+        }
+    }
+
+    TaskScheduler.WaitforAllAndShutdown();
+}
+
+int main()
+{
+    Log::Init();
+
+    TestQuality();
+    TestFlatBlocks();
+    TestTimeEncode();
+
+    return TestHarness::Finish("BlockCompressorTests");
+}
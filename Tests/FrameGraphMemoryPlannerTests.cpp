@@ -0,0 +1,158 @@
+/**
+* This file is part of the "Vrixic Engine" project (Copyright (c) 2022-2023 by Vrij Patel)
+* See "LICENSE.txt" for license information.
+*/
+
+#include "TestHarness.h"
+#include <Misc/Logging/Log.h>
+#include <Runtime/Graphics/FrameGraph/FrameGraphMemoryPlanner.h>
+
+#include <random>
+
+static FMemoryRequirements MakeRequirements(uint64 inSize, uint64 inAlignment, uint32 inMemoryTypeBits)
+{
+    FMemoryRequirements Requirements;
+    Requirements.Size = inSize;
+    Requirements.Alignment = inAlignment;
+    Requirements.MemoryTypeBits = inMemoryTypeBits;
+    return Requirements;
+}
+
+/**
+* Checks a plan against the rules any placement has to follow: aligned, inside its heap, in a heap of a memory type it accepts,
+*   and never overlapping a resource alive at the same time
+*/
+static void CheckPlan(const FrameGraphMemoryPlanner& inPlanner, const std::vector<FFrameGraphMemoryRequest>& inRequests)
+{
+    const std::vector<FFrameGraphMemoryHeap>& Heaps = inPlanner.GetHeaps();
+    for (uint32 i = 0; i < inRequests.size(); ++i)
+    {
+        const FFrameGraphMemoryPlacement& Placement = inPlanner.GetPlacement(i);
+        const FMemoryRequirements& Requirements = inRequests[i].Requirements;
+
+        VE_TEST_CHECK(Placement.HeapIndex < Heaps.size(), "request %u is in heap %u of %zu", i, Placement.HeapIndex, Heaps.size());
+        if (Placement.HeapIndex >= Heaps.size())
+        {
+            continue;
+        }
+
+        const FFrameGraphMemoryHeap& Heap = Heaps[Placement.HeapIndex];
+        VE_TEST_CHECK(Placement.Offset % Requirements.Alignment == 0, "request %u at %llu is not %llu aligned", i, Placement.Offset, Requirements.Alignment);
+        VE_TEST_CHECK(Placement.Offset + Requirements.Size <= Heap.Size, "request %u ends at %llu past its heap (%llu)", i, Placement.Offset + Requirements.Size, Heap.Size);
+        VE_TEST_CHECK((Heap.MemoryTypeBits & Requirements.MemoryTypeBits) == Heap.MemoryTypeBits && Heap.MemoryTypeBits != 0,
+            "request %u (types %x) is in a heap of types %x", i, Requirements.MemoryTypeBits, Heap.MemoryTypeBits);
+
+        for (uint32 j = i + 1; j < inRequests.size(); ++j)
+        {
+            const FFrameGraphMemoryPlacement& Other = inPlanner.GetPlacement(j);
+            const bool bAliveTogether = inRequests[i].FirstUse <= inRequests[j].LastUse && inRequests[j].FirstUse <= inRequests[i].LastUse;
+            if (!bAliveTogether || Other.HeapIndex != Placement.HeapIndex)
+            {
+                continue;
+            }
+
+            const bool bOverlap = Placement.Offset < Other.Offset + inRequests[j].Requirements.Size && Other.Offset < Placement.Offset + Requirements.Size;
+            VE_TEST_CHECK(!bOverlap, "requests %u and %u are alive together and overlap in heap %u", i, j, Placement.HeapIndex);
+        }
+    }
+
+    const FFrameGraphMemoryStats& Stats = inPlanner.GetStats();
+    VE_TEST_CHECK(Stats.HeapMemory >= Stats.PeakLiveMemory, "heaps (%llu) are smaller than the peak live memory (%llu)", Stats.HeapMemory, Stats.PeakLiveMemory);
+    VE_TEST_CHECK(Stats.HeapMemory <= Stats.NaiveMemory + inRequests.size() * 65536, "heaps (%llu) use more than one allocation each (%llu)", Stats.HeapMemory, Stats.NaiveMemory);
+}
+
+static void TestDisjointLifetimesShareMemory()
+{
+    FrameGraphMemoryPlanner Planner;
+    std::vector<FFrameGraphMemoryRequest> Requests(3);
+    Requests[0].Requirements = MakeRequirements(1 << 20, 256, 1);
+    Requests[0].FirstUse = 0;
+    Requests[0].LastUse = 1;
+    Requests[1].Requirements = MakeRequirements(1 << 20, 256, 1);
+    Requests[1].FirstUse = 2;
+    Requests[1].LastUse = 3;
+    Requests[2].Requirements = MakeRequirements(1 << 19, 256, 1);
+    Requests[2].FirstUse = 4;
+    Requests[2].LastUse = 4;
+
+    for (const FFrameGraphMemoryRequest& Request : Requests)
+    {
+        Planner.AddRequest(Request.Requirements, Request.FirstUse, Request.LastUse);
+    }
+    Planner.Plan();
+
+    CheckPlan(Planner, Requests);
+    VE_TEST_CHECK(Planner.GetStats().HeapMemory == (1 << 20), "three resources never alive together take %llu bytes instead of one MiB", Planner.GetStats().HeapMemory);
+}
+
+static void TestIncompatibleMemoryTypesGetTheirOwnHeaps()
+{
+    FrameGraphMemoryPlanner Planner;
+    std::vector<FFrameGraphMemoryRequest> Requests(2);
+    Requests[0].Requirements = MakeRequirements(4096, 256, 1);
+    Requests[1].Requirements = MakeRequirements(4096, 256, 2);
+
+    for (const FFrameGraphMemoryRequest& Request : Requests)
+    {
+        Planner.AddRequest(Request.Requirements, Request.FirstUse, Request.LastUse);
+    }
+    Planner.Plan();
+
+    CheckPlan(Planner, Requests);
+    VE_TEST_CHECK(Planner.GetHeaps().size() == 2, "resources with no memory type in common share a heap (%zu heaps)", Planner.GetHeaps().size());
+}
+
+/**
+* Random graphs of a few hundred resources, the same check the planner was written against
+*/
+static void TestRandomGraphs()
+{
+    std::mt19937 Random(41);
+    for (uint32 Graph = 0; Graph < 50; ++Graph)
+    {
+        const uint32 NumNodes = 40;
+        const uint32 NumResources = 300;
+
+        FrameGraphMemoryPlanner Planner;
+        std::vector<FFrameGraphMemoryRequest> Requests(NumResources);
+        for (FFrameGraphMemoryRequest& Request : Requests)
+        {
+            const uint64 Alignment = 256ull << (Random() % 8);
+            const uint64 Size = ((Random() % 64) + 1) * 16384ull;
+            const uint32 MemoryTypeBits = (Random() % 4) == 0 ? 0x3 : ((Random() % 2) == 0 ? 0x1 : 0x2);
+
+            Request.Requirements = MakeRequirements(Size, Alignment, MemoryTypeBits);
+            Request.FirstUse = Random() % NumNodes;
+            Request.LastUse = Request.FirstUse + Random() % (NumNodes - Request.FirstUse);
+
+            Planner.AddRequest(Request.Requirements, Request.FirstUse, Request.LastUse);
+        }
+
+        Planner.Plan();
+        CheckPlan(Planner, Requests);
+
+        // Reapplying the plan, what a precompiled graph does, gives the same stats
+        const std::vector<FFrameGraphMemoryHeap> Heaps = Planner.GetHeaps();
+        std::vector<FFrameGraphMemoryPlacement> Placements;
+        for (uint32 i = 0; i < NumResources; ++i)
+        {
+            Placements.push_back(Planner.GetPlacement(i));
+        }
+
+        const FFrameGraphMemoryStats Stats = Planner.GetStats();
+        Planner.ApplyPlan(Heaps, Placements);
+        VE_TEST_CHECK(Planner.GetStats().HeapMemory == Stats.HeapMemory && Planner.GetStats().PeakLiveMemory == Stats.PeakLiveMemory,
+            "graph %u: applying the plan changed the stats", Graph);
+    }
+}
+
+int main()
+{
+    Log::Init();
+
+    TestDisjointLifetimesShareMemory();
+    TestIncompatibleMemoryTypesGetTheirOwnHeaps();
+    TestRandomGraphs();
+
+    return TestHarness::Finish("FrameGraphMemoryPlannerTests");
+}
@@ -0,0 +1,340 @@
+/**
+* This file is part of the "Vrixic Engine" project (Copyright (c) 2022-2023 by Vrij Patel)
+* See "LICENSE.txt" for license information.
+*/
+
+#include "TestHarness.h"
+#include <Misc/Logging/Log.h>
+#include <Runtime/Core/Math/VrixicMathHelper.h>
+#include <Runtime/Graphics/TextureTools/IBLBaker.h>
+#include <External/enkiTS/Includes/TaskScheduler.h>
+
+#include <cmath>
+#include <functional>
+#include <random>
+#include <vector>
+
+/**
+* Direction through a point of a face, (s, t) in [0, 1], written from the cube map face selection table of the Vulkan spec
+*   independently of the baker (major axis -> sc, tc):
+*   +X: (-rz, -ry), -X: (rz, -ry), +Y: (rx, rz), -Y: (rx, -rz), +Z: (rx, -ry), -Z: (-rx, -ry)
+*/
+static Vector3D FaceToDirection(uint32 inFace, float inS, float inT)
+{
+    const float SC = 2.0f * inS - 1.0f;
+    const float TC = 2.0f * inT - 1.0f;
+
+    Vector3D Direction;
+    switch (inFace)
+    {
+    case 0: Direction = Vector3D(1.0f, -TC, -SC); break;
+    case 1: Direction = Vector3D(-1.0f, -TC, SC); break;
+    case 2: Direction = Vector3D(SC, 1.0f, TC); break;
+    case 3: Direction = Vector3D(SC, -1.0f, -TC); break;
+    case 4: Direction = Vector3D(SC, -TC, 1.0f); break;
+    default: Direction = Vector3D(-SC, -TC, -1.0f); break;
+    }
+
+    const float InvLength = 1.0f / std::sqrt(Direction.X * Direction.X + Direction.Y * Direction.Y + Direction.Z * Direction.Z);
+    return Vector3D(Direction.X * InvLength, Direction.Y * InvLength, Direction.Z * InvLength);
+}
+
+static Vector3D TexelToDirection(uint32 inFace, uint32 inX, uint32 inY, uint32 inSize)
+{
+    return FaceToDirection(inFace, ((float)inX + 0.5f) / (float)inSize, ((float)inY + 0.5f) / (float)inSize);
+}
+
+/**
+* @returns double exact solid angle of a face texel, the integral of the area projected on the unit sphere
+*/
+static double TexelSolidAngle(uint32 inX, uint32 inY, uint32 inSize)
+{
+    auto AreaElement = [](double inU, double inV)
+    {
+        return std::atan2(inU * inV, std::sqrt(inU * inU + inV * inV + 1.0));
+    };
+
+    const double U0 = 2.0 * inX / inSize - 1.0;
+    const double V0 = 2.0 * inY / inSize - 1.0;
+    const double U1 = 2.0 * (inX + 1) / inSize - 1.0;
+    const double V1 = 2.0 * (inY + 1) / inSize - 1.0;
+    return AreaElement(U0, V0) - AreaElement(U0, V1) - AreaElement(U1, V0) + AreaElement(U1, V1);
+}
+
+/**
+* @returns FCubemapImage with the full mip chain, mip 0 filled with the rgb of the environment in each texel direction
+*/
+static FCubemapImage MakeEnvironment(uint32 inSize, const std::function<Vector3D(const Vector3D&)>& inEnvironment)
+{
+    uint32 NumMipLevels = 1;
+    while ((inSize >> NumMipLevels) > 0)
+    {
+        NumMipLevels++;
+    }
+
+    FCubemapImage Cubemap;
+    Cubemap.Allocate(inSize, NumMipLevels);
+
+    for (uint32 Face = 0; Face < 6; ++Face)
+    {
+        float* Texels = Cubemap.GetFace(0, Face);
+        for (uint32 Y = 0; Y < inSize; ++Y)
+        {
+            for (uint32 X = 0; X < inSize; ++X)
+            {
+                const Vector3D Radiance = inEnvironment(TexelToDirection(Face, X, Y, inSize));
+
+                float* Texel = Texels + ((uint64)Y * inSize + X) * 4;
+                Texel[0] = Radiance.X;
+                Texel[1] = Radiance.Y;
+                Texel[2] = Radiance.Z;
+                Texel[3] = 1.0f;
+            }
+        }
+    }
+
+    FIBLBaker::GenerateMips(Cubemap);
+    return Cubemap;
+}
+
+static Vector3D RandomDirection(std::mt19937& inOutRandom)
+{
+    std::uniform_real_distribution<float> Distribution(-1.0f, 1.0f);
+    while (true)
+    {
+        const Vector3D Direction(Distribution(inOutRandom), Distribution(inOutRandom), Distribution(inOutRandom));
+        const float LengthSquared = Direction.X * Direction.X + Direction.Y * Direction.Y + Direction.Z * Direction.Z;
+        if (LengthSquared > 0.01f && LengthSquared <= 1.0f)
+        {
+            const float InvLength = 1.0f / std::sqrt(LengthSquared);
+            return Vector3D(Direction.X * InvLength, Direction.Y * InvLength, Direction.Z * InvLength);
+        }
+    }
+}
+
+/**
+* A sky gradient with a broad sun lobe, the spherical harmonics irradiance has to land within 1% of the irradiance
+*   integrated texel by texel against the clamped cosine. Sharper lobes put more energy past order 2 and miss by more
+*/
+static void TestIrradianceMatchesBruteForce()
+{
+    const uint32 SIZE = 64;
+    const Vector3D SUN_DIRECTION(0.48f, 0.6f, -0.64f);
+
+    FCubemapImage Environment = MakeEnvironment(SIZE, [&](const Vector3D& inDirection)
+    {
+        const float CosSun = inDirection.X * SUN_DIRECTION.X + inDirection.Y * SUN_DIRECTION.Y + inDirection.Z * SUN_DIRECTION.Z;
+        const float Sun = std::exp(2.0f * (CosSun - 1.0f));
+        return Vector3D(0.4f + 0.3f * inDirection.Y + 1.5f * Sun, 0.35f + 0.25f * inDirection.Y + 1.2f * Sun, 0.5f + 0.2f * inDirection.Y + 0.8f * Sun);
+    });
+
+    FIBLBakeConfig Config;
+    const FSHIrradiance Irradiance = FIBLBaker::ProjectIrradiance(Environment, Config);
+
+    std::mt19937 Random(11);
+    float MaxError = 0.0f;
+    for (uint32 i = 0; i < 256; ++i)
+    {
+        const Vector3D Normal = RandomDirection(Random);
+
+        double Reference[3] = { };
+        for (uint32 Face = 0; Face < 6; ++Face)
+        {
+            const float* Texels = Environment.GetFace(0, Face);
+            for (uint32 Y = 0; Y < SIZE; ++Y)
+            {
+                for (uint32 X = 0; X < SIZE; ++X)
+                {
+                    const Vector3D Direction = TexelToDirection(Face, X, Y, SIZE);
+                    const float CosTheta = Direction.X * Normal.X + Direction.Y * Normal.Y + Direction.Z * Normal.Z;
+                    if (CosTheta <= 0.0f)
+                    {
+                        continue;
+                    }
+
+                    const double Weight = CosTheta * TexelSolidAngle(X, Y, SIZE) / PI;
+                    const float* Texel = Texels + ((uint64)Y * SIZE + X) * 4;
+                    Reference[0] += Texel[0] * Weight;
+                    Reference[1] += Texel[1] * Weight;
+                    Reference[2] += Texel[2] * Weight;
+                }
+            }
+        }
+
+        const Vector3D Result = FIBLBaker::EvaluateIrradiance(Irradiance, Normal);
+        const float Results[3] = { Result.X, Result.Y, Result.Z };
+        for (uint32 Channel = 0; Channel < 3; ++Channel)
+        {
+            MaxError = MathUtils::Max(MaxError, (float)(std::fabs(Results[Channel] - Reference[Channel]) / Reference[Channel]));
+        }
+    }
+
+    VE_TEST_CHECK(MaxError <= 0.01f, "irradiance is %.2f%% off the brute force integral", MaxError * 100.0f);
+}
+
+/**
+* A constant environment reflects the same everywhere, the irradiance and every mip of the prefiltered map have to keep it
+*/
+static void TestConstantEnvironmentStaysConstant()
+{
+    const Vector3D CONSTANT(0.25f, 0.5f, 1.0f);
+    const float TOLERANCE = 1e-5f;
+
+    FCubemapImage Environment = MakeEnvironment(32, [&](const Vector3D&) { return CONSTANT; });
+
+    FIBLBakeConfig Config;
+    Config.IrradianceSize = 8;
+    Config.PrefilterSize = 32;
+    Config.NumPrefilterSamples = 16;
+
+    auto MaxError = [&](const float* inTexel)
+    {
+        return MathUtils::Max(std::fabs(inTexel[0] - CONSTANT.X), MathUtils::Max(std::fabs(inTexel[1] - CONSTANT.Y), std::fabs(inTexel[2] - CONSTANT.Z)));
+    };
+
+    FCubemapImage IrradianceMap;
+    FIBLBaker::BakeIrradianceMap(FIBLBaker::ProjectIrradiance(Environment, Config), IrradianceMap, Config);
+
+    float IrradianceError = 0.0f;
+    for (uint64 i = 0; i < IrradianceMap.Texels.size(); i += 4)
+    {
+        IrradianceError = MathUtils::Max(IrradianceError, MaxError(&IrradianceMap.Texels[i]));
+    }
+    VE_TEST_CHECK(IrradianceError <= TOLERANCE, "irradiance of a constant environment is off by %g", IrradianceError);
+
+    FCubemapImage PrefilteredMap;
+    FIBLBaker::BakePrefilteredMap(Environment, PrefilteredMap, Config);
+    VE_TEST_CHECK(PrefilteredMap.NumMipLevels == 6, "%u prefiltered mips for a 32 map", PrefilteredMap.NumMipLevels);
+
+    for (uint32 MipLevel = 0; MipLevel < PrefilteredMap.NumMipLevels; ++MipLevel)
+    {
+        const uint32 MipSize = PrefilteredMap.GetMipSize(MipLevel);
+
+        float MipError = 0.0f;
+        for (uint32 Face = 0; Face < 6; ++Face)
+        {
+            const float* Texels = PrefilteredMap.GetFace(MipLevel, Face);
+            for (uint64 i = 0; i < (uint64)MipSize * MipSize; ++i)
+            {
+                MipError = MathUtils::Max(MipError, MaxError(Texels + i * 4));
+            }
+        }
+        VE_TEST_CHECK(MipError <= TOLERANCE, "prefiltered mip %u of a constant environment is off by %g", MipLevel, MipError);
+    }
+}
+
+/**
+* Every texel of the source holds its own direction (from the Vulkan face table above). The baker maps texels to directions
+*   and directions back to texels, both have to agree with the table:
+*   - the nearly mirror like mip 1 of the prefiltered map has to point where its texels point,
+*   - the irradiance of 1 + direction is 1 + 2/3 of the normal (the clamped cosine convolution of band 1)
+*/
+static void TestFaceMappingRoundTrip()
+{
+    const uint32 SIZE = 64;
+
+    FCubemapImage Environment = MakeEnvironment(SIZE, [](const Vector3D& inDirection) { return inDirection; });
+
+    FIBLBakeConfig Config;
+    Config.PrefilterSize = SIZE;
+    Config.NumPrefilterSamples = 32;
+
+    FCubemapImage PrefilteredMap;
+    FIBLBaker::BakePrefilteredMap(Environment, PrefilteredMap, Config);
+
+    // Mip 0 is the source resampled at the same size
+    float ResampleError = 0.0f;
+    for (uint64 i = 0; i < (uint64)6 * SIZE * SIZE * 4; ++i)
+    {
+        ResampleError = MathUtils::Max(ResampleError, std::fabs(PrefilteredMap.Texels[i] - Environment.Texels[i]));
+    }
+    VE_TEST_CHECK(ResampleError <= 1e-6f, "prefiltered mip 0 is off the source by %g", ResampleError);
+
+    const uint32 MipSize = PrefilteredMap.GetMipSize(1);
+    float MinCosAngle = 1.0f;
+    for (uint32 Face = 0; Face < 6; ++Face)
+    {
+        const float* Texels = PrefilteredMap.GetFace(1, Face);
+        for (uint32 Y = 0; Y < MipSize; ++Y)
+        {
+            for (uint32 X = 0; X < MipSize; ++X)
+            {
+                const float* Texel = Texels + ((uint64)Y * MipSize + X) * 4;
+                const Vector3D Expected = TexelToDirection(Face, X, Y, MipSize);
+
+                const float Length = std::sqrt(Texel[0] * Texel[0] + Texel[1] * Texel[1] + Texel[2] * Texel[2]);
+                const float CosAngle = (Texel[0] * Expected.X + Texel[1] * Expected.Y + Texel[2] * Expected.Z) / MathUtils::Max(Length, 1e-6f);
+                MinCosAngle = MathUtils::Min(MinCosAngle, CosAngle);
+            }
+        }
+    }
+    VE_TEST_CHECK(MinCosAngle >= std::cos(3.0f * DEGTORADS), "prefiltered mip 1 points up to %.2f degrees away from its texels",
+        std::acos(MathUtils::Min(MinCosAngle, 1.0f)) * RADSTODEG);
+
+    FCubemapImage ShiftedEnvironment = MakeEnvironment(SIZE, [](const Vector3D& inDirection)
+    {
+        return Vector3D(1.0f + inDirection.X, 1.0f + inDirection.Y, 1.0f + inDirection.Z);
+    });
+    const FSHIrradiance Irradiance = FIBLBaker::ProjectIrradiance(ShiftedEnvironment, Config);
+
+    std::mt19937 Random(13);
+    float IrradianceError = 0.0f;
+    for (uint32 i = 0; i < 64; ++i)
+    {
+        const Vector3D Normal = RandomDirection(Random);
+        const Vector3D Result = FIBLBaker::EvaluateIrradiance(Irradiance, Normal);
+
+        IrradianceError = MathUtils::Max(IrradianceError, std::fabs(Result.X - (1.0f + 2.0f / 3.0f * Normal.X)));
+        IrradianceError = MathUtils::Max(IrradianceError, std::fabs(Result.Y - (1.0f + 2.0f / 3.0f * Normal.Y)));
+        IrradianceError = MathUtils::Max(IrradianceError, std::fabs(Result.Z - (1.0f + 2.0f / 3.0f * Normal.Z)));
+    }
+    VE_TEST_CHECK(IrradianceError <= 2e-3f, "irradiance of 1 + direction is off by %g", IrradianceError);
+}
+
+/**
+* Bakes the maps of a 256 environment with the default sample count, on one thread and across the workers
+*/
+static void TestTimeBake()
+{
+    enki::TaskScheduler TaskScheduler;
+    TaskScheduler.Initialize();
+
+    FCubemapImage Environment = MakeEnvironment(256, [](const Vector3D& inDirection)
+    {
+        return Vector3D(0.5f + 0.5f * inDirection.X, 0.5f + 0.5f * inDirection.Y, 0.5f + 0.5f * inDirection.Z);
+    });
+
+    for (uint32 bUseWorkers = 0; bUseWorkers < 2; ++bUseWorkers)
+    {
+        FIBLBakeConfig Config;
+        Config.PrefilterSize = 128;
+        Config.TaskScheduler = bUseWorkers ? &TaskScheduler : nullptr;
+
+        auto Start = std::chrono::high_resolution_clock::now();
+        FCubemapImage IrradianceMap;
+        FIBLBaker::BakeIrradianceMap(FIBLBaker::ProjectIrradiance(Environment, Config), IrradianceMap, Config);
+        const float IrradianceMs = TestHarness::GetElapsedMs(Start);
+
+        Start = std::chrono::high_resolution_clock::now();
+        FCubemapImage PrefilteredMap;
+        FIBLBaker::BakePrefilteredMap(Environment, PrefilteredMap, Config);
+        const float PrefilterMs = TestHarness::GetElapsedMs(Start);
+
+        std::printf("[IBLBakerTests]: 256 source, %s: irradiance %.1f ms, 128 prefiltered map (%u samples) %.1f ms\n",
+            bUseWorkers ? "workers" : "one thread", IrradianceMs, Config.NumPrefilterSamples, PrefilterMs);
+    }
+
+    TaskScheduler.WaitforAllAndShutdown();
+}
+
+int main()
+{
+    Log::Init();
+
+    TestIrradianceMatchesBruteForce();
+    TestConstantEnvironmentStaysConstant();
+    TestFaceMappingRoundTrip();
+    TestTimeBake();
+
+    return TestHarness::Finish("IBLBakerTests");
+}
@@ -0,0 +1,236 @@
+/**
+* This file is part of the "Vrixic Engine" project (Copyright (c) 2022-2023 by Vrij Patel)
+* See "LICENSE.txt" for license information.
+*/
+
+#include "TestHarness.h"
+#include <Misc/Logging/Log.h>
+#include <Runtime/Graphics/Culling/LightClusterer.h>
+#include <External/enkiTS/Includes/TaskScheduler.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <random>
+
+static const float ASPECT_RATIO = 16.0f / 9.0f;
+static const float VERTICAL_FOV_IN_DEGS = 60.0f;
+static const float NEAR_Z = 0.1f;
+static const float FAR_Z = 500.0f;
+
+/**
+* A city of random point lights in front of the camera
+*/
+static std::vector<FPointLight> MakeLights(uint32 inNumLights, uint32 inSeed)
+{
+    std::mt19937 Random(inSeed);
+    std::uniform_real_distribution<float> Distribution(-1.0f, 1.0f);
+
+    std::vector<FPointLight> Lights(inNumLights);
+    for (FPointLight& Light : Lights)
+    {
+        Light.Position = Vector3D(Distribution(Random) * 150.0f, Distribution(Random) * 10.0f, 150.0f + Distribution(Random) * 150.0f);
+        Light.Radius = 3.0f + Distribution(Random) * 2.0f;
+        Light.Color = Vector3D(1.0f);
+        Light.Intensity = 1.0f;
+    }
+
+    return Lights;
+}
+
+/**
+* Row vector view matrix of a camera at inPosition turned by inYawInDegs around +y, left handed
+*/
+static FFloat4x4 MakeView(const Vector3D& inPosition, float inYawInDegs)
+{
+    const float Yaw = inYawInDegs * (3.1415926535897932f / 180.0f);
+    const float Cos = std::cos(Yaw);
+    const float Sin = std::sin(Yaw);
+
+    // Inverse of the camera's rotation (its transpose) followed by its inverse translation
+    FFloat4x4 View = FFloat4x4::Identity();
+    View(0, 0) = Cos;
+    View(0, 2) = Sin;
+    View(2, 0) = -Sin;
+    View(2, 2) = Cos;
+    View(3, 0) = -(inPosition.X * Cos - inPosition.Z * Sin);
+    View(3, 1) = -inPosition.Y;
+    View(3, 2) = -(inPosition.X * Sin + inPosition.Z * Cos);
+    return View;
+}
+
+/**
+* @returns bool true if the cluster lists inLightIndex
+*/
+static bool HasLight(const LightClusterer& inClusterer, uint32 inClusterIndex, uint32 inLightIndex)
+{
+    const FLightCluster& Cluster = inClusterer.GetClusters()[inClusterIndex];
+    const std::vector<uint32>& LightIndices = inClusterer.GetLightIndices();
+    return std::find(LightIndices.begin() + Cluster.Offset, LightIndices.begin() + Cluster.Offset + Cluster.Count, inLightIndex)
+        != LightIndices.begin() + Cluster.Offset + Cluster.Count;
+}
+
+/**
+* Brute force reference: points are scattered through every light's sphere, each point is placed in the cluster whose piece of the frustum
+*   holds it straight from the projection, so the light touches that cluster and the cluster has to list it
+*/
+static void TestNoLightMissingFromAClusterItTouches(bool inUseSIMD)
+{
+    const uint32 NUM_SAMPLES_PER_LIGHT = 128;
+    const std::vector<FPointLight> Lights = MakeLights(2048, 5);
+    const FFloat4x4 View = MakeView(Vector3D(10.0f, 2.0f, -20.0f), 15.0f);
+
+    FLightClustererConfig Config;
+    Config.bUseSIMD = inUseSIMD;
+
+    LightClusterer Clusterer;
+    Clusterer.Init(Config);
+    Clusterer.SetProjection(ASPECT_RATIO, VERTICAL_FOV_IN_DEGS, NEAR_Z, FAR_Z);
+    Clusterer.AssignLights(Lights.data(), (uint32)Lights.size(), View);
+
+    const char* Path = Clusterer.IsUsingAVX2() ? "AVX2" : "scalar";
+    const double TanY = std::tan((double)VERTICAL_FOV_IN_DEGS * 0.5 * (3.14159265358979323846 / 180.0));
+    const double TanX = TanY * ASPECT_RATIO;
+    const double LogDepthRange = std::log((double)FAR_Z / NEAR_Z);
+
+    std::mt19937 Random(9);
+    std::uniform_real_distribution<double> Distribution(-1.0, 1.0);
+
+    uint32 NumSamplesInFrustum = 0;
+    uint32 NumMissing = 0;
+    for (uint32 LightIndex = 0; LightIndex < Lights.size(); ++LightIndex)
+    {
+        const FPointLight& Light = Lights[LightIndex];
+        const Vector3D& P = Light.Position;
+        const double ViewX = P.X * View(0, 0) + P.Y * View(1, 0) + P.Z * View(2, 0) + View(3, 0);
+        const double ViewY = P.X * View(0, 1) + P.Y * View(1, 1) + P.Z * View(2, 1) + View(3, 1);
+        const double ViewZ = P.X * View(0, 2) + P.Y * View(1, 2) + P.Z * View(2, 2) + View(3, 2);
+
+        for (uint32 Sample = 0; Sample < NUM_SAMPLES_PER_LIGHT; ++Sample)
+        {
+            // The center, then random points inside the sphere, a hair inside so rounding cannot push them out
+            double Offset[3] = { 0.0, 0.0, 0.0 };
+            while (Sample > 0)
+            {
+                Offset[0] = Distribution(Random);
+                Offset[1] = Distribution(Random);
+                Offset[2] = Distribution(Random);
+                if (Offset[0] * Offset[0] + Offset[1] * Offset[1] + Offset[2] * Offset[2] <= 1.0)
+                {
+                    break;
+                }
+            }
+
+            const double X = ViewX + Offset[0] * Light.Radius * 0.999;
+            const double Y = ViewY + Offset[1] * Light.Radius * 0.999;
+            const double Z = ViewZ + Offset[2] * Light.Radius * 0.999;
+            if (Z <= NEAR_Z || Z >= FAR_Z)
+            {
+                continue;
+            }
+
+            // Position of the point in the grid, row 0 is the top of the screen
+            const double GridX = (X / Z + TanX) / (2.0 * TanX) * Config.NumClustersX;
+            const double GridY = (TanY - Y / Z) / (2.0 * TanY) * Config.NumClustersY;
+            const double GridZ = std::log(Z / NEAR_Z) / LogDepthRange * Config.NumClustersZ;
+            if (GridX < 0.0 || GridX >= Config.NumClustersX || GridY < 0.0 || GridY >= Config.NumClustersY)
+            {
+                continue;
+            }
+
+            // Points right on a boundary between two clusters could land in either
+            auto IsOnBoundary = [](double inGrid) { return std::fabs(inGrid - std::round(inGrid)) < 1e-4; };
+            if (IsOnBoundary(GridX) || IsOnBoundary(GridY) || IsOnBoundary(GridZ))
+            {
+                continue;
+            }
+
+            NumSamplesInFrustum++;
+            const uint32 ClusterIndex = Clusterer.GetClusterIndex((uint32)GridX, (uint32)GridY, (uint32)GridZ);
+            if (!HasLight(Clusterer, ClusterIndex, LightIndex) && NumMissing++ == 0)
+            {
+                VE_TEST_CHECK(false, "%s: light %u touches cluster (%u, %u, %u) but is not in its list", Path, LightIndex,
+                    (uint32)GridX, (uint32)GridY, (uint32)GridZ);
+            }
+        }
+    }
+
+    VE_TEST_CHECK(NumMissing == 0, "%s: %u points of lights are in clusters that do not list the light", Path, NumMissing);
+    VE_TEST_CHECK(NumSamplesInFrustum > Lights.size() * NUM_SAMPLES_PER_LIGHT / 4, "%s: only %u points landed in the frustum", Path, NumSamplesInFrustum);
+
+    // Listing every light everywhere would also pass, a light has to stay in the few clusters around it
+    VE_TEST_CHECK(Clusterer.GetStats().NumLightIndices < Lights.size() * 64, "%s: %u light indices for %zu lights", Path,
+        Clusterer.GetStats().NumLightIndices, Lights.size());
+}
+
+/**
+* Assigns the lights to cluster grids of a few resolutions with the scalar and the AVX2 sphere tests and times both,
+*   they compute the same distances so any cluster with different lights is a bug
+*/
+static void TestSIMDMatchesScalar()
+{
+    const uint32 NUM_ITERATIONS = 8;
+    const uint32 GRID_SIZES[4][3] = { { 8, 4, 16 }, { 16, 9, 24 }, { 32, 18, 32 }, { 64, 36, 48 } };
+    const std::vector<FPointLight> Lights = MakeLights(16384, 7);
+    const FFloat4x4 View = FFloat4x4::Identity();
+
+    enki::TaskScheduler TaskScheduler;
+    TaskScheduler.Initialize();
+
+    for (const uint32* GridSize : GRID_SIZES)
+    {
+        LightClusterer Clusterers[2];
+        for (uint32 c = 0; c < 2; ++c)
+        {
+            FLightClustererConfig Config;
+            Config.NumClustersX = GridSize[0];
+            Config.NumClustersY = GridSize[1];
+            Config.NumClustersZ = GridSize[2];
+            Config.bUseSIMD = c == 1;
+            Config.TaskScheduler = &TaskScheduler;
+            Clusterers[c].Init(Config);
+            Clusterers[c].SetProjection(ASPECT_RATIO, VERTICAL_FOV_IN_DEGS, NEAR_Z, FAR_Z);
+
+            float AssignTimeMs = FLT_MAX;
+            for (uint32 Iteration = 0; Iteration < NUM_ITERATIONS; ++Iteration)
+            {
+                auto Start = std::chrono::high_resolution_clock::now();
+                Clusterers[c].AssignLights(Lights.data(), (uint32)Lights.size(), View);
+                AssignTimeMs = MathUtils::Min(AssignTimeMs, TestHarness::GetElapsedMs(Start));
+            }
+
+            const FLightClustererStats& Stats = Clusterers[c].GetStats();
+            std::printf("[LightClustererTests]: %ux%ux%u %s: %u lights in %.3f ms, %u light indices, at most %u lights in a cluster\n",
+                GridSize[0], GridSize[1], GridSize[2], Clusterers[c].IsUsingAVX2() ? "AVX2" : "scalar", Stats.NumLights, AssignTimeMs,
+                Stats.NumLightIndices, Stats.MaxLightsPerCluster);
+        }
+
+        uint32 NumMismatches = 0;
+        for (uint32 i = 0; i < Clusterers[0].GetNumClusters(); ++i)
+        {
+            const FLightCluster& Scalar = Clusterers[0].GetClusters()[i];
+            const FLightCluster& SIMD = Clusterers[1].GetClusters()[i];
+            if (Scalar.Count != SIMD.Count
+                || !std::equal(Clusterers[0].GetLightIndices().begin() + Scalar.Offset, Clusterers[0].GetLightIndices().begin() + Scalar.Offset + Scalar.Count,
+                    Clusterers[1].GetLightIndices().begin() + SIMD.Offset))
+            {
+                NumMismatches++;
+            }
+        }
+
+        VE_TEST_CHECK(NumMismatches == 0, "%ux%ux%u: %u clusters differ between the scalar and the SIMD light assignment", GridSize[0], GridSize[1], GridSize[2], NumMismatches);
+    }
+
+    TaskScheduler.WaitforAllAndShutdown();
+}
+
+int main()
+{
+    Log::Init();
+
+    TestNoLightMissingFromAClusterItTouches(false);
+    TestNoLightMissingFromAClusterItTouches(true);
+    TestSIMDMatchesScalar();
+
+    return TestHarness::Finish("LightClustererTests");
+}
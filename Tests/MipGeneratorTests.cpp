@@ -0,0 +1,284 @@
+/**
+* This file is part of the "Vrixic Engine" project (Copyright (c) 2022-2023 by Vrij Patel)
+* See "LICENSE.txt" for license information.
+*/
+
+#include "TestHarness.h"
+#include <Misc/Logging/Log.h>
+#include <Runtime/Core/Math/VrixicMathHelper.h>
+#include <Runtime/Graphics/TextureTools/MipGenerator.h>
+#include <External/enkiTS/Includes/TaskScheduler.h>
+
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+/**
+* @returns std::vector<uint8> a mip chain sized for the image with random texels in mip 0
+*/
+static std::vector<uint8> MakeRandomImage(uint32 inWidth, uint32 inHeight, uint32 inSeed)
+{
+    std::vector<uint8> MipChain(FMipGenerator::GetMipChainSize(inWidth, inHeight, FMipGenerator::GetNumMipLevels(inWidth, inHeight)));
+
+    std::mt19937 Random(inSeed);
+    for (uint64 i = 0; i < (uint64)inWidth * inHeight * 4; ++i)
+    {
+        MipChain[i] = (uint8)(Random() & 0xFF);
+    }
+
+    return MipChain;
+}
+
+static float SRGBToLinear(uint8 inValue)
+{
+    const float Value = inValue / 255.0f;
+    return Value <= 0.04045f ? Value / 12.92f : std::pow((Value + 0.055f) / 1.055f, 2.4f);
+}
+
+static float LinearToSRGB(float inValue)
+{
+    return inValue <= 0.0031308f ? inValue * 12.92f : 1.055f * std::pow(inValue, 1.0f / 2.4f) - 0.055f;
+}
+
+/**
+* 2x2 average with rounding, edges clamped for odd sizes, computed one texel at a time; the SIMD box filter has to match it exactly
+*/
+static void TestBoxMatchesScalarReference()
+{
+    const uint32 SIZES[3][2] = { { 256, 256 }, { 257, 131 }, { 1, 37 } };
+    for (const uint32* Size : SIZES)
+    {
+        std::vector<uint8> MipChain = MakeRandomImage(Size[0], Size[1], 3);
+        std::vector<uint8> Reference = MipChain;
+
+        FMipGenerationConfig Config;
+        const uint32 NumMipLevels = FMipGenerator::Generate(MipChain.data(), Size[0], Size[1], Config);
+        VE_TEST_CHECK(NumMipLevels == FMipGenerator::GetNumMipLevels(Size[0], Size[1]), "%ux%u: %u mips generated", Size[0], Size[1], NumMipLevels);
+
+        uint64 SourceOffset = 0;
+        uint32 SourceWidth = Size[0];
+        uint32 SourceHeight = Size[1];
+        uint32 NumMismatches = 0;
+        for (uint32 MipLevel = 1; MipLevel < NumMipLevels; ++MipLevel)
+        {
+            const uint64 Offset = SourceOffset + (uint64)SourceWidth * SourceHeight * 4;
+            const uint32 Width = MathUtils::Max(SourceWidth >> 1, 1u);
+            const uint32 Height = MathUtils::Max(SourceHeight >> 1, 1u);
+
+            for (uint32 y = 0; y < Height; ++y)
+            {
+                for (uint32 x = 0; x < Width; ++x)
+                {
+                    const uint32 X0 = MathUtils::Min(x * 2, SourceWidth - 1);
+                    const uint32 X1 = MathUtils::Min(x * 2 + 1, SourceWidth - 1);
+                    const uint32 Y0 = MathUtils::Min(y * 2, SourceHeight - 1);
+                    const uint32 Y1 = MathUtils::Min(y * 2 + 1, SourceHeight - 1);
+
+                    for (uint32 c = 0; c < 4; ++c)
+                    {
+                        auto Source = [&](uint32 inX, uint32 inY) { return (uint32)Reference[SourceOffset + ((uint64)inY * SourceWidth + inX) * 4 + c]; };
+                        uint8& Texel = Reference[Offset + ((uint64)y * Width + x) * 4 + c];
+                        Texel = (uint8)((Source(X0, Y0) + Source(X1, Y0) + Source(X0, Y1) + Source(X1, Y1) + 2) >> 2);
+                        NumMismatches += Texel != MipChain[Offset + ((uint64)y * Width + x) * 4 + c];
+                    }
+                }
+            }
+
+            SourceOffset = Offset;
+            SourceWidth = Width;
+            SourceHeight = Height;
+        }
+
+        VE_TEST_CHECK(NumMismatches == 0, "%ux%u: %u channels differ from the scalar box filter", Size[0], Size[1], NumMismatches);
+    }
+}
+
+/**
+* An sRGB image made of flat 2x2 blocks has to come back unchanged, and averaging happens in linear space
+*/
+static void TestSRGBRoundTrip()
+{
+    const uint32 Width = 32;
+    const uint32 Height = 32;
+
+    std::vector<uint8> MipChain(FMipGenerator::GetMipChainSize(Width, Height, 2));
+    for (uint32 y = 0; y < Height; ++y)
+    {
+        for (uint32 x = 0; x < Width; ++x)
+        {
+            // Every 8-bit value once, in the 2x2 block (x / 2, y / 2)
+            const uint8 Value = (uint8)((y / 2) * (Width / 2) + (x / 2));
+            uint8* Texel = &MipChain[((uint64)y * Width + x) * 4];
+            Texel[0] = Texel[1] = Texel[2] = Value;
+            Texel[3] = 255 - Value;
+        }
+    }
+
+    FMipGenerationConfig Config;
+    Config.bIsSRGB = true;
+    Config.MaxMipLevels = 2;
+    FMipGenerator::Generate(MipChain.data(), Width, Height, Config);
+
+    const uint8* Mip1 = MipChain.data() + (uint64)Width * Height * 4;
+    uint32 NumMismatches = 0;
+    for (uint32 i = 0; i < 256; ++i)
+    {
+        NumMismatches += Mip1[i * 4] != i || Mip1[i * 4 + 1] != i || Mip1[i * 4 + 2] != i || Mip1[i * 4 + 3] != 255 - i;
+    }
+    VE_TEST_CHECK(NumMismatches == 0, "%u of the 256 flat sRGB blocks changed value", NumMismatches);
+
+    // Black and white average to 0.5 in linear space, not to 128 in sRGB
+    uint8 Checker[4 * 4 * 4 + 2 * 2 * 4] = { };
+    for (uint32 i = 0; i < 16; ++i)
+    {
+        const uint8 Value = ((i % 4) + (i / 4)) % 2 == 0 ? 0 : 255;
+        Checker[i * 4] = Checker[i * 4 + 1] = Checker[i * 4 + 2] = Value;
+        Checker[i * 4 + 3] = 255;
+    }
+
+    FMipGenerator::Generate(Checker, 4, 4, Config);
+
+    const uint8 Expected = (uint8)(LinearToSRGB(0.5f * (SRGBToLinear(0) + SRGBToLinear(255))) * 255.0f + 0.5f);
+    VE_TEST_CHECK(std::abs((int32)Checker[64] - (int32)Expected) <= 1, "a black and white checker averages to %u, %u in linear space", Checker[64], Expected);
+}
+
+/**
+* The kaiser weights sum to 1, a constant image stays constant at every mip with and without sRGB
+*/
+static void TestKaiserKeepsConstantImage()
+{
+    const uint32 Width = 96;
+    const uint32 Height = 40;
+    const uint8 Color[4] = { 13, 128, 250, 77 };
+
+    for (uint32 bIsSRGB = 0; bIsSRGB < 2; ++bIsSRGB)
+    {
+        const uint32 NumMipLevels = FMipGenerator::GetNumMipLevels(Width, Height);
+        std::vector<uint8> MipChain(FMipGenerator::GetMipChainSize(Width, Height, NumMipLevels));
+        for (uint64 i = 0; i < (uint64)Width * Height; ++i)
+        {
+            memcpy(&MipChain[i * 4], Color, 4);
+        }
+
+        FMipGenerationConfig Config;
+        Config.Filter = EMipFilter::Kaiser;
+        Config.bIsSRGB = bIsSRGB != 0;
+        FMipGenerator::Generate(MipChain.data(), Width, Height, Config);
+
+        uint32 NumChanged = 0;
+        for (uint64 i = 0; i < MipChain.size(); ++i)
+        {
+            NumChanged += MipChain[i] != Color[i % 4];
+        }
+        VE_TEST_CHECK(NumChanged == 0, "kaiser%s: %u channels of a constant image changed", bIsSRGB ? " sRGB" : "", NumChanged);
+    }
+}
+
+/**
+* A masked texture (noisy alpha around the cutoff) keeps the fraction of texels passing the alpha test at every mip
+*/
+static void TestAlphaCoveragePreserved()
+{
+    const uint32 Width = 256;
+    const uint32 Height = 256;
+    const float ALPHA_CUTOFF = 0.5f;
+
+    std::mt19937 Random(11);
+    for (uint32 Filter = 0; Filter < 2; ++Filter)
+    {
+        const uint32 NumMipLevels = FMipGenerator::GetNumMipLevels(Width, Height);
+        std::vector<uint8> MipChain(FMipGenerator::GetMipChainSize(Width, Height, NumMipLevels));
+
+        // Foliage like: soft edged leaves with noise, a bit less than half the texels pass the alpha test
+        for (uint32 y = 0; y < Height; ++y)
+        {
+            for (uint32 x = 0; x < Width; ++x)
+            {
+                const float Leaves = std::sin(x * 0.11f) * std::cos(y * 0.07f) * 70.0f + std::sin((x + y) * 0.031f) * 40.0f;
+                uint8* Texel = &MipChain[((uint64)y * Width + x) * 4];
+                Texel[0] = Texel[1] = Texel[2] = 200;
+                Texel[3] = (uint8)MathUtils::Min(MathUtils::Max(115.0f + Leaves + (float)(Random() % 41) - 20.0f, 0.0f), 255.0f);
+            }
+        }
+
+        FMipGenerationConfig Config;
+        Config.Filter = Filter == 0 ? EMipFilter::Box : EMipFilter::Kaiser;
+        Config.bPreserveAlphaCoverage = true;
+        Config.AlphaCutoff = ALPHA_CUTOFF;
+        FMipGenerator::Generate(MipChain.data(), Width, Height, Config);
+
+        auto ComputeCoverage = [&](uint64 inOffset, uint64 inNumTexels)
+        {
+            uint64 NumCovered = 0;
+            for (uint64 i = 0; i < inNumTexels; ++i)
+            {
+                NumCovered += MipChain[inOffset + i * 4 + 3] > ALPHA_CUTOFF * 255.0f;
+            }
+            return (float)NumCovered / (float)inNumTexels;
+        };
+
+        const float TargetCoverage = ComputeCoverage(0, (uint64)Width * Height);
+
+        uint64 Offset = 0;
+        for (uint32 MipLevel = 0; MipLevel < NumMipLevels; ++MipLevel)
+        {
+            const uint64 NumTexels = (uint64)MathUtils::Max(Width >> MipLevel, 1u) * MathUtils::Max(Height >> MipLevel, 1u);
+
+            // One texel is 1 / NumTexels of coverage, the small mips can only get as close as that
+            const float Tolerance = MathUtils::Max(0.02f, 1.0f / NumTexels);
+            const float Coverage = ComputeCoverage(Offset, NumTexels);
+            if (NumTexels >= 16)
+            {
+                VE_TEST_CHECK(std::fabs(Coverage - TargetCoverage) <= Tolerance, "%s mip %u: alpha coverage %.3f, mip 0 has %.3f",
+                    Filter == 0 ? "box" : "kaiser", MipLevel, Coverage, TargetCoverage);
+            }
+
+            Offset += NumTexels * 4;
+        }
+    }
+}
+
+/**
+* Full chains of a 4096x4096 texture with both filters, on one thread and across the workers
+*/
+static void TestTime4K()
+{
+    const uint32 SIZE = 4096;
+
+    enki::TaskScheduler TaskScheduler;
+    TaskScheduler.Initialize();
+
+    std::vector<uint8> MipChain = MakeRandomImage(SIZE, SIZE, 5);
+    for (uint32 Filter = 0; Filter < 2; ++Filter)
+    {
+        for (uint32 bUseWorkers = 0; bUseWorkers < 2; ++bUseWorkers)
+        {
+            FMipGenerationConfig Config;
+            Config.Filter = Filter == 0 ? EMipFilter::Box : EMipFilter::Kaiser;
+            Config.TaskScheduler = bUseWorkers ? &TaskScheduler : nullptr;
+
+            const auto Start = std::chrono::high_resolution_clock::now();
+            FMipGenerator::Generate(MipChain.data(), SIZE, SIZE, Config);
+            const float TimeMs = TestHarness::GetElapsedMs(Start);
+
+            std::printf("[MipGeneratorTests]: 4096x4096 %s, %s: %.1f ms (%.1f MPix/s of mip 0)\n", Filter == 0 ? "box" : "kaiser",
+                bUseWorkers ? "workers" : "one thread", TimeMs, (float)SIZE * SIZE / (TimeMs * 1000.0f));
+        }
+    }
+
+    TaskScheduler.WaitforAllAndShutdown();
+}
+
+int main()
+{
+    Log::Init();
+
+    TestBoxMatchesScalarReference();
+    TestSRGBRoundTrip();
+    TestKaiserKeepsConstantImage();
+    TestAlphaCoveragePreserved();
+    TestTime4K();
+
+    return TestHarness::Finish("MipGeneratorTests");
+}
@@ -0,0 +1,373 @@
+/**
+* This file is part of the "Vrixic Engine" project (Copyright (c) 2022-2023 by Vrij Patel)
+* See "LICENSE.txt" for license information.
+*/
+
+#include "TestHarness.h"
+#include <Misc/Logging/Log.h>
+#include <Runtime/Graphics/Culling/OcclusionCuller.h>
+#include <External/enkiTS/Includes/TaskScheduler.h>
+
+#include <cfloat>
+#include <random>
+
+static const float ASPECT_RATIO = 16.0f / 9.0f;
+static const float VERTICAL_FOV_IN_DEGS = 60.0f;
+static const float NEAR_Z = 0.01f;
+static const float FAR_Z = 1000.0f;
+
+/**
+* Vulkan left handed perspective projection, row vectors, same as ProjectionMatrix4D::MakeProjectionVulkanLH(). w is the view space z
+*/
+static FFloat4x4 MakeProjection()
+{
+    const float YScale = 1.0f / std::tan(VERTICAL_FOV_IN_DEGS * 0.5f * (3.1415926535897932f / 180.0f));
+
+    FFloat4x4 Projection = { };
+    Projection(0, 0) = YScale / ASPECT_RATIO;
+    Projection(1, 1) = YScale;
+    Projection(2, 2) = FAR_Z / (FAR_Z - NEAR_Z);
+    Projection(2, 3) = 1.0f;
+    Projection(3, 2) = -NEAR_Z * FAR_Z / (FAR_Z - NEAR_Z);
+    return Projection;
+}
+
+/**
+* @returns FFloat4x4 translation followed by inMatrix
+*/
+static FFloat4x4 Translate(const Vector3D& inTranslation, const FFloat4x4& inMatrix)
+{
+    FFloat4x4 Result = inMatrix;
+    for (uint32 Column = 0; Column < 4; ++Column)
+    {
+        Result(3, Column) = inTranslation.X * inMatrix(0, Column) + inTranslation.Y * inMatrix(1, Column) + inTranslation.Z * inMatrix(2, Column) + inMatrix(3, Column);
+    }
+    return Result;
+}
+
+/**
+* A room of random walls (quads facing the camera) and boxes behind, in front of and between them, view space is world space
+*/
+struct FTestScene
+{
+public:
+    static constexpr uint32 NUM_WALL_INDICES = 6;
+
+    Vector3D WallPositions[4] = { Vector3D(-4.0f, -3.0f, 0.0f), Vector3D(4.0f, -3.0f, 0.0f), Vector3D(4.0f, 3.0f, 0.0f), Vector3D(-4.0f, 3.0f, 0.0f) };
+    uint32 WallIndices[NUM_WALL_INDICES] = { 0, 1, 2, 0, 2, 3 };
+
+    FFloat4x4 ViewProjection;
+    std::vector<Vector3D> WallTranslations;
+    std::vector<FFloat4x4> WallMatrices;
+    std::vector<Vector3D> BoxCenters;
+
+    /** Half the size of every box */
+    float BoxExtent = 0.5f;
+
+public:
+    FTestScene(uint32 inNumWalls, uint32 inNumBoxes, uint32 inSeed)
+        : ViewProjection(MakeProjection())
+    {
+        std::mt19937 Random(inSeed);
+        std::uniform_real_distribution<float> Distribution(-1.0f, 1.0f);
+
+        for (uint32 i = 0; i < inNumWalls; ++i)
+        {
+            WallTranslations.push_back(Vector3D(Distribution(Random) * 40.0f, Distribution(Random) * 20.0f, 30.0f + Distribution(Random) * 25.0f));
+            WallMatrices.push_back(Translate(WallTranslations.back(), ViewProjection));
+        }
+
+        for (uint32 i = 0; i < inNumBoxes; ++i)
+        {
+            BoxCenters.push_back(Vector3D(Distribution(Random) * 50.0f, Distribution(Random) * 25.0f, 35.0f + Distribution(Random) * 34.0f));
+        }
+    }
+
+    void Rasterize(OcclusionCuller& outCuller) const
+    {
+        outCuller.BeginFrame();
+        for (const FFloat4x4& WallMatrix : WallMatrices)
+        {
+            outCuller.AddOccluder(WallPositions, WallIndices, NUM_WALL_INDICES, WallMatrix);
+        }
+        outCuller.Rasterize();
+    }
+
+    bool IsVisible(const OcclusionCuller& inCuller, uint32 inBoxIndex) const
+    {
+        const Vector3D& Center = BoxCenters[inBoxIndex];
+        return inCuller.IsVisible(Center - Vector3D(BoxExtent), Center + Vector3D(BoxExtent), ViewProjection);
+    }
+};
+
+/**
+* Brute force reference: a ray through every pixel center is intersected with every wall triangle and every box,
+*   computes the exact view space depth the rasterizer approximates
+*/
+class GroundTruthVisibility
+{
+public:
+    GroundTruthVisibility(const FTestScene& inScene, uint32 inWidth, uint32 inHeight)
+        : Width(inWidth), Height(inHeight), OccluderDepth((uint64)inWidth * inHeight, FLT_MAX)
+    {
+        for (uint32 y = 0; y < Height; ++y)
+        {
+            for (uint32 x = 0; x < Width; ++x)
+            {
+                const Vector3D Direction = GetRayDirection(x, y);
+                float& NearestZ = OccluderDepth[(uint64)y * Width + x];
+
+                for (const Vector3D& Translation : inScene.WallTranslations)
+                {
+                    for (uint32 i = 0; i < FTestScene::NUM_WALL_INDICES; i += 3)
+                    {
+                        const float Z = IntersectTriangle(Direction, inScene.WallPositions[inScene.WallIndices[i]] + Translation,
+                            inScene.WallPositions[inScene.WallIndices[i + 1]] + Translation, inScene.WallPositions[inScene.WallIndices[i + 2]] + Translation);
+                        NearestZ = Z < NearestZ ? Z : NearestZ;
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+    * @returns float view space z of the nearest wall seen through the pixel center, FLT_MAX if none
+    */
+    inline float GetOccluderDepth(uint32 inX, uint32 inY) const
+    {
+        return OccluderDepth[(uint64)inY * Width + inX];
+    }
+
+    /**
+    * @returns bool true if a ray through any pixel center reaches the box before it reaches a wall
+    */
+    bool IsBoxVisible(const Vector3D& inBoundsMin, const Vector3D& inBoundsMax, uint32& outPixelX, uint32& outPixelY) const
+    {
+        for (uint32 y = 0; y < Height; ++y)
+        {
+            for (uint32 x = 0; x < Width; ++x)
+            {
+                // Only visible by a clear margin, a box touching a wall is not counted against the culler
+                const float BoxZ = IntersectBox(GetRayDirection(x, y), inBoundsMin, inBoundsMax);
+                if (BoxZ < GetOccluderDepth(x, y) * 0.999f)
+                {
+                    outPixelX = x;
+                    outPixelY = y;
+                    return true;
+                }
+            }
+        }
+
+        return false;
+    }
+
+private:
+    /**
+    * @returns Vector3D direction from the camera through the pixel center, scaled to z = 1 so distances along it are view space z
+    */
+    Vector3D GetRayDirection(uint32 inX, uint32 inY) const
+    {
+        const FFloat4x4 Projection = MakeProjection();
+        const float ClipX = ((float)inX + 0.5f) / (float)Width * 2.0f - 1.0f;
+        const float ClipY = ((float)inY + 0.5f) / (float)Height * 2.0f - 1.0f;
+        return Vector3D(ClipX / Projection(0, 0), ClipY / Projection(1, 1), 1.0f);
+    }
+
+    /**
+    * Moller-Trumbore, both windings, a hair wider than the triangle so pixel centers on a shared edge hit one of its triangles
+    *
+    * @returns float view space z of the hit, FLT_MAX if the ray misses
+    */
+    static float IntersectTriangle(const Vector3D& inDirection, const Vector3D& inV0, const Vector3D& inV1, const Vector3D& inV2)
+    {
+        const Vector3D Edge1 = inV1 - inV0;
+        const Vector3D Edge2 = inV2 - inV0;
+        const Vector3D P = Vector3D::CrossProduct(inDirection, Edge2);
+        const float Determinant = Vector3D::DotProduct(Edge1, P);
+        if (std::fabs(Determinant) < 1e-12f)
+        {
+            return FLT_MAX;
+        }
+
+        const float InvDeterminant = 1.0f / Determinant;
+        const Vector3D T = -inV0;
+        const float U = Vector3D::DotProduct(T, P) * InvDeterminant;
+        const Vector3D Q = Vector3D::CrossProduct(T, Edge1);
+        const float V = Vector3D::DotProduct(inDirection, Q) * InvDeterminant;
+        if (U < -1e-5f || V < -1e-5f || U + V > 1.0f + 1e-5f)
+        {
+            return FLT_MAX;
+        }
+
+        const float Z = Vector3D::DotProduct(Edge2, Q) * InvDeterminant;
+        return Z >= NEAR_Z ? Z : FLT_MAX;
+    }
+
+    /**
+    * Slab test
+    *
+    * @returns float view space z where the ray enters the box, FLT_MAX if it misses
+    */
+    static float IntersectBox(const Vector3D& inDirection, const Vector3D& inBoundsMin, const Vector3D& inBoundsMax)
+    {
+        const float Direction[3] = { inDirection.X, inDirection.Y, inDirection.Z };
+        const float Min[3] = { inBoundsMin.X, inBoundsMin.Y, inBoundsMin.Z };
+        const float Max[3] = { inBoundsMax.X, inBoundsMax.Y, inBoundsMax.Z };
+
+        float Enter = NEAR_Z;
+        float Exit = FLT_MAX;
+        for (uint32 Axis = 0; Axis < 3; ++Axis)
+        {
+            const float T0 = Min[Axis] / Direction[Axis];
+            const float T1 = Max[Axis] / Direction[Axis];
+            Enter = MathUtils::Max(Enter, MathUtils::Min(T0, T1));
+            Exit = MathUtils::Min(Exit, MathUtils::Max(T0, T1));
+        }
+
+        return Enter <= Exit ? Enter : FLT_MAX;
+    }
+
+private:
+    uint32 Width;
+    uint32 Height;
+
+    /** View space z of the nearest wall per pixel */
+    std::vector<float> OccluderDepth;
+};
+
+/**
+* Both cullers have to be conservative: no box it hides may be visible through any pixel center in the brute force reference,
+*   and its depth at a pixel is never nearer than the nearest wall there
+*/
+static void TestConservativeAgainstGroundTruth()
+{
+    const FTestScene Scene(64, 1024, 13);
+
+    OcclusionCuller Cullers[2];
+    for (uint32 c = 0; c < 2; ++c)
+    {
+        FOcclusionCullerConfig Config;
+        Config.bUseSIMD = c == 1;
+        Cullers[c].Init(Config);
+        Scene.Rasterize(Cullers[c]);
+    }
+
+    const GroundTruthVisibility GroundTruth(Scene, Cullers[0].GetWidth(), Cullers[0].GetHeight());
+
+    std::vector<bool> TrulyVisible(Scene.BoxCenters.size());
+    std::vector<uint32> VisiblePixels(Scene.BoxCenters.size() * 2);
+    uint32 NumTrulyHidden = 0;
+    for (uint32 i = 0; i < Scene.BoxCenters.size(); ++i)
+    {
+        TrulyVisible[i] = GroundTruth.IsBoxVisible(Scene.BoxCenters[i] - Vector3D(Scene.BoxExtent), Scene.BoxCenters[i] + Vector3D(Scene.BoxExtent),
+            VisiblePixels[i * 2], VisiblePixels[i * 2 + 1]);
+        NumTrulyHidden += !TrulyVisible[i];
+    }
+
+    for (const OcclusionCuller& Culler : Cullers)
+    {
+        const char* Path = Culler.IsUsingAVX2() ? "AVX2" : "scalar";
+
+        uint32 NumDepthErrors = 0;
+        for (uint32 y = 0; y < Culler.GetHeight(); ++y)
+        {
+            for (uint32 x = 0; x < Culler.GetWidth(); ++x)
+            {
+                const float ExactDepth = GroundTruth.GetOccluderDepth(x, y) == FLT_MAX ? 0.0f : 1.0f / GroundTruth.GetOccluderDepth(x, y);
+                if (Culler.GetDepth(x, y) > ExactDepth * 1.001f && NumDepthErrors++ == 0)
+                {
+                    VE_TEST_CHECK(false, "%s: depth %f at pixel (%u, %u) is nearer than the nearest wall (%f)", Path, Culler.GetDepth(x, y), x, y, ExactDepth);
+                }
+            }
+        }
+        VE_TEST_CHECK(NumDepthErrors == 0, "%s: %u pixels are nearer than the nearest wall", Path, NumDepthErrors);
+
+        uint32 NumCulled = 0;
+        for (uint32 i = 0; i < Scene.BoxCenters.size(); ++i)
+        {
+            const bool bIsCulled = !Scene.IsVisible(Culler, i);
+            NumCulled += bIsCulled;
+            VE_TEST_CHECK(!bIsCulled || !TrulyVisible[i], "%s: box %u is culled but visible at pixel (%u, %u)", Path, i, VisiblePixels[i * 2], VisiblePixels[i * 2 + 1]);
+        }
+
+        // Conservative by doing nothing would also pass, most truly hidden boxes have to be culled
+        VE_TEST_CHECK(NumCulled * 4 >= NumTrulyHidden * 3, "%s: only %u of the %u hidden boxes are culled", Path, NumCulled, NumTrulyHidden);
+        std::printf("[OcclusionCullerTests]: %s: %u of %u boxes culled, %u hidden in the reference\n", Path, NumCulled, (uint32)Scene.BoxCenters.size(), NumTrulyHidden);
+    }
+}
+
+/**
+* Rasterizes with the scalar and the AVX2 culler and times both, they compute the same values so any difference in depth or visibility is a bug
+*/
+static void TestSIMDMatchesScalar()
+{
+    const uint32 NUM_ITERATIONS = 16;
+    const FTestScene Scene(256, 16384, 7);
+
+    enki::TaskScheduler TaskScheduler;
+    TaskScheduler.Initialize();
+
+    OcclusionCuller Cullers[2];
+    std::vector<bool> Visibilities[2];
+    for (uint32 c = 0; c < 2; ++c)
+    {
+        FOcclusionCullerConfig Config;
+        Config.bUseSIMD = c == 1;
+        Config.TaskScheduler = &TaskScheduler;
+        Cullers[c].Init(Config);
+
+        float RasterizeTimeMs = FLT_MAX;
+        float TestTimeMs = FLT_MAX;
+        uint32 NumVisible = 0;
+        for (uint32 Iteration = 0; Iteration < NUM_ITERATIONS; ++Iteration)
+        {
+            auto Start = std::chrono::high_resolution_clock::now();
+            Scene.Rasterize(Cullers[c]);
+            RasterizeTimeMs = MathUtils::Min(RasterizeTimeMs, TestHarness::GetElapsedMs(Start));
+
+            Start = std::chrono::high_resolution_clock::now();
+            Visibilities[c].assign(Scene.BoxCenters.size(), false);
+            NumVisible = 0;
+            for (uint32 i = 0; i < Scene.BoxCenters.size(); ++i)
+            {
+                Visibilities[c][i] = Scene.IsVisible(Cullers[c], i);
+                NumVisible += Visibilities[c][i];
+            }
+            TestTimeMs = MathUtils::Min(TestTimeMs, TestHarness::GetElapsedMs(Start));
+        }
+
+        std::printf("[OcclusionCullerTests]: %s: %u triangles in %.3f ms (%.2f Mtri/s), %u boxes tested in %.3f ms, %u visible\n",
+            Cullers[c].IsUsingAVX2() ? "AVX2" : "scalar", Cullers[c].GetStats().NumBinnedTriangles, RasterizeTimeMs,
+            Cullers[c].GetStats().NumBinnedTriangles / (RasterizeTimeMs * 1000.0f), (uint32)Scene.BoxCenters.size(), TestTimeMs, NumVisible);
+    }
+
+    uint32 NumDepthMismatches = 0;
+    for (uint32 y = 0; y < Cullers[0].GetHeight(); ++y)
+    {
+        for (uint32 x = 0; x < Cullers[0].GetWidth(); ++x)
+        {
+            NumDepthMismatches += Cullers[0].GetDepth(x, y) != Cullers[1].GetDepth(x, y);
+        }
+    }
+
+    uint32 NumVisibilityMismatches = 0;
+    for (uint32 i = 0; i < Scene.BoxCenters.size(); ++i)
+    {
+        NumVisibilityMismatches += Visibilities[0][i] != Visibilities[1][i];
+    }
+
+    VE_TEST_CHECK(NumDepthMismatches == 0, "%u pixels differ between the scalar and the SIMD rasterizer", NumDepthMismatches);
+    VE_TEST_CHECK(NumVisibilityMismatches == 0, "%u boxes differ between the scalar and the SIMD tests", NumVisibilityMismatches);
+
+    TaskScheduler.WaitforAllAndShutdown();
+}
+
+int main()
+{
+    Log::Init();
+
+    TestConservativeAgainstGroundTruth();
+    TestSIMDMatchesScalar();
+
+    return TestHarness::Finish("OcclusionCullerTests");
+}
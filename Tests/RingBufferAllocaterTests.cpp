@@ -0,0 +1,71 @@
+/**
+* This file is part of the "Vrixic Engine" project (Copyright (c) 2022-2023 by Vrij Patel)
+* See "LICENSE.txt" for license information.
+*/
+
+#include "TestHarness.h"
+#include <Misc/Logging/Log.h>
+#include <Runtime/Memory/Core/Allocaters/RingBufferAllocater.h>
+
+static void TestLargeAllocationAfterFullDrain()
+{
+    RingBufferAllocater Ring;
+    Ring.Init(1024);
+
+    uint64 Offset = 0;
+    VE_TEST_CHECK(Ring.Alloc(600, 16, Offset) && Offset == 0, "first allocation at %llu", Offset);
+    Ring.Release(Ring.GetMarker());
+    VE_TEST_CHECK(Ring.GetMemoryUsed() == 0, "%llu bytes still used after releasing everything", Ring.GetMemoryUsed());
+
+    // The free space is split 424 / 600 at the old position unless the ring starts over
+    VE_TEST_CHECK(Ring.Alloc(800, 16, Offset), "an 800 byte allocation fails in an empty 1024 byte ring");
+    VE_TEST_CHECK(Offset == 0, "allocation after the drain is at %llu", Offset);
+
+    Ring.Flush();
+    VE_TEST_CHECK(Ring.Alloc(1024, 16, Offset) && Offset == 0, "a whole ring allocation fails after a flush");
+}
+
+static void TestWrapAroundAndRelease()
+{
+    RingBufferAllocater Ring;
+    Ring.Init(1024);
+
+    uint64 Offsets[3] = { };
+    VE_TEST_CHECK(Ring.Alloc(400, 16, Offsets[0]), "allocation 0 failed");
+    const RingBufferAllocater::Marker FirstMarker = Ring.GetMarker();
+    VE_TEST_CHECK(Ring.Alloc(400, 16, Offsets[1]), "allocation 1 failed");
+    const RingBufferAllocater::Marker SecondMarker = Ring.GetMarker();
+
+    // 224 bytes are left at the end, not enough for 300 and the start is still in use
+    VE_TEST_CHECK(!Ring.Alloc(300, 16, Offsets[2]), "allocation overlapping live memory succeeded");
+
+    Ring.Release(FirstMarker);
+    VE_TEST_CHECK(Ring.Alloc(300, 16, Offsets[2]) && Offsets[2] == 0, "allocation did not wrap to the start (at %llu)", Offsets[2]);
+    VE_TEST_CHECK(Offsets[1] == 400, "allocation 1 at %llu", Offsets[1]);
+
+    Ring.Release(SecondMarker);
+    // The wrapped allocation and the 224 bytes skipped at the end of the ring
+    VE_TEST_CHECK(Ring.GetMemoryUsed() == 524, "%llu bytes used, only the wrapped allocation is alive", Ring.GetMemoryUsed());
+}
+
+static void TestAlignmentAndOversizedRequests()
+{
+    RingBufferAllocater Ring;
+    Ring.Init(4096);
+
+    uint64 Offset = 0;
+    VE_TEST_CHECK(Ring.Alloc(3, 1, Offset), "3 byte allocation failed");
+    VE_TEST_CHECK(Ring.Alloc(64, 256, Offset) && Offset == 256, "256 aligned allocation at %llu", Offset);
+    VE_TEST_CHECK(!Ring.Alloc(4097, 16, Offset), "an allocation bigger than the ring succeeded");
+}
+
+int main()
+{
+    Log::Init();
+
+    TestLargeAllocationAfterFullDrain();
+    TestWrapAroundAndRelease();
+    TestAlignmentAndOversizedRequests();
+
+    return TestHarness::Finish("RingBufferAllocaterTests");
+}
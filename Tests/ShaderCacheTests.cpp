@@ -0,0 +1,139 @@
+/**
+* This file is part of the "Vrixic Engine" project (Copyright (c) 2022-2023 by Vrij Patel)
+* See "LICENSE.txt" for license information.
+*/
+
+#include "TestHarness.h"
+#include <Misc/Logging/Log.h>
+#include <Runtime/File/DerivedDataCache.h>
+#include <Runtime/Graphics/ShaderCompiler.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+/** First word of every spirv binary */
+static constexpr uint32 SPIRV_MAGIC_NUMBER = 0x07230203;
+
+struct FShaderFile
+{
+    std::string Path;
+    FShaderConfig Config;
+};
+
+/**
+* Every glsl vertex and fragment shader under Assets/Shaders, sorted so both passes compile them in the same order
+*/
+static std::vector<FShaderFile> GatherShaders(const std::string& inShaderFolder)
+{
+    std::vector<std::string> Paths;
+    for (const std::filesystem::directory_entry& Entry : std::filesystem::recursive_directory_iterator(inShaderFolder))
+    {
+        const std::string Extension = Entry.path().extension().string();
+        if (Entry.is_regular_file() && (Extension == ".vert" || Extension == ".frag"))
+        {
+            Paths.push_back(Entry.path().generic_string());
+        }
+    }
+    std::sort(Paths.begin(), Paths.end());
+
+    std::vector<FShaderFile> Shaders;
+    for (const std::string& Path : Paths)
+    {
+        FShaderFile Shader;
+        Shader.Path = Path;
+        Shader.Config.Type = Path.compare(Path.size() - 5, 5, ".vert") == 0 ? EShaderType::Vertex : EShaderType::Fragment;
+        Shader.Config.SourceType = EShaderSourceType::String;
+        Shader.Config.Flags = FShaderFlags::GLSL;
+
+        VE_TEST_CHECK(ShaderCompiler::LoadSourceFile(Path, Shader.Config.SourceCode), "could not read %s", Path.c_str());
+        Shaders.push_back(Shader);
+    }
+
+    return Shaders;
+}
+
+/**
+* Compiles every shader with a new compiler, the way a launch of the engine does
+*
+* @param outBinaries - the spirv of each shader
+* @returns uint32 how many of the shaders came out of the derived data cache
+*/
+static uint32 CompileShaders(const std::vector<FShaderFile>& inShaders, const std::string& inShaderFolder, std::vector<std::vector<uint8>>& outBinaries)
+{
+    ShaderCompiler Compiler;
+    Compiler.AddIncludeDirectory(inShaderFolder);
+
+    uint32 NumCacheHits = 0;
+    outBinaries.resize(inShaders.size());
+    for (uint64 i = 0; i < inShaders.size(); ++i)
+    {
+        uint8* Code = nullptr;
+        uint64 CodeSize = 0;
+        uint64 SpirVKey = 0;
+        NumCacheHits += Compiler.Compile(inShaders[i].Config, inShaders[i].Path, Code, &CodeSize, SpirVKey) ? 1 : 0;
+
+        VE_TEST_CHECK(SpirVKey != 0, "%s was not cached", inShaders[i].Path.c_str());
+        VE_TEST_CHECK(CodeSize >= 4 && CodeSize % 4 == 0 && *(const uint32*)Code == SPIRV_MAGIC_NUMBER,
+            "%s did not compile to spirv", inShaders[i].Path.c_str());
+
+        outBinaries[i].assign(Code, Code + CodeSize);
+        delete[] Code;
+    }
+
+    return NumCacheHits;
+}
+
+/**
+* Compiles Assets/Shaders into an empty derived data cache and again after reopening it. The first pass is a
+*   first launch, the second one every launch after it and has to load every shader out of the cache unchanged
+*/
+static void TestColdAndWarmCache()
+{
+    const std::string ShaderFolder = VE_ASSETS_DIR "Shaders/";
+    const std::filesystem::path CacheFolder = std::filesystem::temp_directory_path() / "VrixicShaderCacheTests";
+    std::filesystem::remove_all(CacheFolder);
+
+    const std::vector<FShaderFile> Shaders = GatherShaders(ShaderFolder);
+    VE_TEST_CHECK(Shaders.size() > 0, "no shaders found in %s", ShaderFolder.c_str());
+
+    FDerivedDataCacheConfig CacheConfig;
+    CacheConfig.CacheFolder = CacheFolder.generic_string();
+
+    DerivedDataCache::Get().Init(&CacheConfig);
+    auto Start = std::chrono::high_resolution_clock::now();
+    std::vector<std::vector<uint8>> ColdBinaries;
+    const uint32 NumColdHits = CompileShaders(Shaders, ShaderFolder, ColdBinaries);
+    const float ColdMs = TestHarness::GetElapsedMs(Start);
+    DerivedDataCache::Get().Shutdown();
+
+    DerivedDataCache::Get().Init(&CacheConfig);
+    Start = std::chrono::high_resolution_clock::now();
+    std::vector<std::vector<uint8>> WarmBinaries;
+    const uint32 NumWarmHits = CompileShaders(Shaders, ShaderFolder, WarmBinaries);
+    const float WarmMs = TestHarness::GetElapsedMs(Start);
+    const uint64 CacheSize = DerivedDataCache::Get().GetSizeInBytes();
+    DerivedDataCache::Get().Shutdown();
+
+    VE_TEST_CHECK(NumColdHits == 0, "%u shaders hit an empty cache", NumColdHits);
+    VE_TEST_CHECK(NumWarmHits == Shaders.size(), "only %u of %zu shaders hit the warm cache", NumWarmHits, Shaders.size());
+    for (uint64 i = 0; i < Shaders.size(); ++i)
+    {
+        VE_TEST_CHECK(ColdBinaries[i] == WarmBinaries[i], "cached spirv of %s differs from the compiled one", Shaders[i].Path.c_str());
+    }
+
+    std::printf("[ShaderCacheTests]: %zu shaders, cold cache %.1f ms, warm cache %.1f ms, %llu KiB cached\n",
+        Shaders.size(), ColdMs, WarmMs, (unsigned long long)(CacheSize >> 10));
+
+    std::filesystem::remove_all(CacheFolder);
+}
+
+int main()
+{
+    Log::Init();
+
+    TestColdAndWarmCache();
+
+    return TestHarness::Finish("ShaderCacheTests");
+}
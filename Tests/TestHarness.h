@@ -0,0 +1,62 @@
+/**
+* This file is part of the "Vrixic Engine" project (Copyright (c) 2022-2023 by Vrij Patel)
+* See "LICENSE.txt" for license information.
+*/
+
+#pragma once
+#include <Misc/Defines/GenericDefines.h>
+
+#include <chrono>
+#include <cstdio>
+
+/**
+* Minimal test harness shared by the portable test targets, a test executable runs its checks and
+*   returns the number of failed ones so ctest reports it
+*/
+namespace TestHarness
+{
+    inline uint32& GetNumFailures()
+    {
+        static uint32 NumFailures = 0;
+        return NumFailures;
+    }
+
+    inline uint32& GetNumChecks()
+    {
+        static uint32 NumChecks = 0;
+        return NumChecks;
+    }
+
+    /**
+    * @returns float milliseconds since inStart
+    */
+    inline float GetElapsedMs(std::chrono::high_resolution_clock::time_point inStart)
+    {
+        return std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - inStart).count();
+    }
+
+    /**
+    * Prints the summary, the return value of main()
+    */
+    inline int Finish(const char* inTestName)
+    {
+        std::printf("[%s]: %u of %u checks failed\n", inTestName, GetNumFailures(), GetNumChecks());
+        return GetNumFailures() == 0 ? 0 : 1;
+    }
+}
+
+/**
+* Records a failure (with the printf style message) if the expression is false, the test keeps running
+*/
+#define VE_TEST_CHECK(expr, ...)                                                            \
+    do                                                                                      \
+    {                                                                                       \
+        TestHarness::GetNumChecks()++;                                                      \
+        if (!(expr))                                                                        \
+        {                                                                                   \
+            TestHarness::GetNumFailures()++;                                                \
+            std::printf("%s(%d): check failed: %s: ", __FILE__, __LINE__, #expr);           \
+            std::printf(__VA_ARGS__);                                                       \
+            std::printf("\n");                                                              \
+        }                                                                                   \
+    } while (0)